@@ -3,7 +3,8 @@ Gabedit.o: Gabedit.c ../../Config.h Global.h \
  TextEdit.h ../Utils/UtilsInterface.h ../Utils/Utils.h \
  ../Utils/AtomsProp.h ../Geometry/GeomGlobal.h \
  ../Geometry/../Common/GabeditType.h SplashScreen.h Install.h \
- ../Files/ListeFiles.h Windows.h StockIcons.h
+ ../Files/ListeFiles.h Windows.h StockIcons.h \
+ ../Display/BatchOrbitals.h
 Help.o: Help.c ../../Config.h Global.h ../Files/GabeditFileChooser.h \
  ../Common/GabeditType.h ../Utils/UtilsInterface.h ../Utils/Constants.h
 Install.o: Install.c ../../Config.h Global.h \
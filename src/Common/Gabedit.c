@@ -39,6 +39,7 @@ DEALINGS IN THE SOFTWARE.
 #include "../Files/ListeFiles.h"
 #include "Windows.h"
 #include "StockIcons.h"
+#include "../Display/BatchOrbitals.h"
 
 GtkWidget *hseparator;
 
@@ -67,6 +68,9 @@ int main(int argc, char *argv[])
    bind_textdomain_codeset (GETTEXT_PACKAGE, "UTF-8");
    textdomain (GETTEXT_PACKAGE);
 
+  /* images of orbitals without window : gabedit --batch-orbitals fileName ... */
+  if(is_batch_orbitals_command(argc, argv)) return run_batch_orbitals(argc, argv);
+
    /*
    if (!g_thread_supported ()){ g_thread_init (NULL); }
    gdk_threads_init ();
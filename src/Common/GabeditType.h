@@ -163,6 +163,7 @@ typedef enum
   GABEDIT_TYPEFILE_XML,
   GABEDIT_TYPEFILE_IGVPT2,
   GABEDIT_TYPEFILE_WFX,
+  GABEDIT_TYPEFILE_GRIDBINARY,
   GABEDIT_TYPEFILE_UNKNOWN,
 } GabEditTypeFile;
 
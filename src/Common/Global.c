@@ -110,3 +110,4 @@ DEALINGS IN THE SOFTWARE.
   gdouble colorMapColors[3][3];
   gdouble alpha_opacity;
   gdouble multipole_rank;
+  gdouble treecode_theta;
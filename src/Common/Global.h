@@ -216,6 +216,7 @@ extern   gint colorMapType;
 extern   gdouble colorMapColors[3][3];
 extern   gdouble alpha_opacity;
 extern   gdouble multipole_rank;
+extern   gdouble treecode_theta;
 
 #endif /* __GABEDIT_GLOBAL_H__ */
 
@@ -3766,6 +3766,91 @@ void set_opacity_dlg()
 
 	gtk_widget_show_all (Win);
 }
+/********************************************************************************/
+static void apply_set_treecode_theta(GtkWidget *Win,gpointer data)
+{
+	GtkWidget* thetaSpinButton = NULL;
+
+	if(!GTK_IS_WIDGET(Win)) return;
+
+	thetaSpinButton = g_object_get_data (G_OBJECT (Win), "ThetaSpinButton");
+	set_treecode_theta(gtk_spin_button_get_value (GTK_SPIN_BUTTON(thetaSpinButton)));
+}
+/********************************************************************************/
+static void apply_set_treecode_theta_close(GtkWidget *Win,gpointer data)
+{
+	apply_set_treecode_theta(Win,data);
+	delete_child(Win);
+}
+/********************************************************************************/
+void set_treecode_theta_dlg()
+{
+	GtkWidget *Win;
+	GtkWidget *frame;
+	GtkWidget *vboxframe;
+	GtkWidget *hbox;
+	GtkWidget *table;
+	GtkWidget *vboxall;
+	GtkWidget *thetaSpinButton;
+	GtkWidget *label;
+	GtkWidget *button;
+
+	Win = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+	gtk_window_set_title(GTK_WINDOW(Win),_("MEP from charges : accuracy"));
+	gtk_window_set_position(GTK_WINDOW(Win),GTK_WIN_POS_CENTER);
+	gtk_container_set_border_width (GTK_CONTAINER (Win), 5);
+	gtk_window_set_modal (GTK_WINDOW (Win), TRUE);
+
+	add_glarea_child(Win,"Treecode ");
+
+	vboxall = create_vbox(Win);
+	frame = gtk_frame_new (NULL);
+	gtk_container_set_border_width (GTK_CONTAINER (frame), 5);
+	gtk_container_add (GTK_CONTAINER (vboxall), frame);
+	gtk_widget_show (frame);
+
+	vboxframe = create_vbox(frame);
+	table = gtk_table_new(5,3,FALSE);
+	gtk_container_add(GTK_CONTAINER(vboxframe),table);
+
+	thetaSpinButton = add_spin_button( table, _("Opening angle of the treecode : "), 1);
+	gtk_spin_button_set_range(GTK_SPIN_BUTTON(thetaSpinButton), 0, 1);
+	gtk_spin_button_set_increments(GTK_SPIN_BUTTON(thetaSpinButton), 0.05, 0.1);
+	gtk_spin_button_set_digits(GTK_SPIN_BUTTON(thetaSpinButton), 2);
+	gtk_spin_button_set_value(GTK_SPIN_BUTTON(thetaSpinButton),get_treecode_theta());
+	g_object_set_data (G_OBJECT (Win), "ThetaSpinButton",thetaSpinButton);
+
+	label = gtk_label_new(_("0 : direct sum over the charges. Larger values are faster and less accurate."));
+	gtk_table_attach(GTK_TABLE(table),label, 0,5,2,3,
+                  (GtkAttachOptions)(GTK_FILL|GTK_SHRINK) ,
+                  (GtkAttachOptions)(GTK_FILL|GTK_SHRINK),
+                  1,1);
+
+	hbox = create_hbox_false(vboxall);
+	gtk_widget_realize(Win);
+
+	button = create_button(Win,_("OK"));
+	gtk_box_pack_end (GTK_BOX( hbox), button, FALSE, TRUE, 3);
+	gtk_widget_set_can_default(button, TRUE);
+	gtk_widget_grab_default(button);
+	gtk_widget_show (button);
+	g_signal_connect_swapped(G_OBJECT(button), "clicked",(GCallback)apply_set_treecode_theta_close,G_OBJECT(Win));
+
+	button = create_button(Win,_("Apply"));
+	gtk_box_pack_end (GTK_BOX( hbox), button, FALSE, TRUE, 3);
+	gtk_widget_set_can_default(button, TRUE);
+	gtk_widget_show (button);
+	g_signal_connect_swapped(G_OBJECT(button), "clicked",(GCallback)apply_set_treecode_theta,G_OBJECT(Win));
+
+	button = create_button(Win,_("Cancel"));
+	gtk_widget_set_can_default(button, TRUE);
+	gtk_box_pack_end (GTK_BOX( hbox), button, FALSE, TRUE, 3);
+	g_signal_connect_swapped(G_OBJECT(button), "clicked",(GCallback)delete_child, G_OBJECT(Win));
+	g_signal_connect_swapped(G_OBJECT(button), "clicked",(GCallback)gtk_widget_destroy,G_OBJECT(Win));
+	gtk_widget_show (button);
+
+	gtk_widget_show_all (Win);
+}
 /*********************************************************************************************************************/
 static void applyColorMapOptions(GtkWidget *dialogWindow, gpointer data)
 {
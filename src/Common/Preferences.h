@@ -27,6 +27,7 @@ void  modify_gaussian_command();
 void  modify_molpro_command();
 void  create_font_color_in_box(GtkWidget *Win,GtkWidget *Box);
 void set_font_other (gchar *fontname);
+void set_treecode_theta_dlg();
 #ifdef G_OS_WIN32
 void  create_gamess_directory(GtkWidget *Wins,GtkWidget *vbox,gboolean expand);
 void  create_pscpplink_directory(GtkWidget *Wins,GtkWidget *vbox,gboolean expand);
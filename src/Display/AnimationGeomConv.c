@@ -41,6 +41,7 @@ DEALINGS IN THE SOFTWARE.
 #include "../Display/BondsOrb.h"
 #include "../Display/RingsOrb.h"
 #include "../Utils/GabeditXYPlot.h"
+#include "../Utils/LogIndex.h"
 #include "../../pixmaps/Open.xpm"
 
 #ifndef M_PI
@@ -1427,105 +1428,74 @@ static gboolean read_molden_gabedit_file_geomi(gchar* fileName, gint geometryNum
 	return TRUE;
 }
 /********************************************************************************/
-static gboolean read_dalton_file_geomi(gchar* FileName, gint num, Geometry* geometry)
+/* move *pos to the next "Next geometry" or "Final geometry" line (patterns 1 and 2 of the index) */
+static gboolean find_dalton_geometry_in_log_index(LogIndex* index, gsize* pos)
 {
-	gchar* t;
-	gboolean OK;
-	gchar* AtomCoord[5];
-	FILE* file;
+	gsize posNext = *pos;
+	gsize posFinal = *pos;
+	gboolean okNext = find_pattern_in_log_index(index, 1, &posNext);
+	gboolean okFinal = find_pattern_in_log_index(index, 2, &posFinal);
+
+	if (!okNext && !okFinal) return FALSE;
+	if (okNext && (!okFinal || posNext < posFinal)) *pos = posNext;
+	else *pos = posFinal;
+	return TRUE;
+}
+/********************************************************************************/
+/* geometry number num (the last one if num is out of range) */
+static gboolean read_dalton_geometry_from_log_index(LogIndex* index, gint num, Geometry* geometry)
+{
+	gchar t[BSIZE];
+	gchar AtomCoord[5][BSIZE];
+	gchar dum[BSIZE];
 	guint i;
-	gint j = 0;
+	gint j;
 	gint l;
-	guint numgeom;
-	Atom* listOfAtoms = NULL;
-	gchar dum[100];
 	gint kk;
+	gint numgeom;
+	gsize pos = 0;
+	gsize posGeom = 0;
+	Atom* listOfAtoms = NULL;
 
-
-	if ((!FileName) || (strcmp(FileName, "") == 0))
+	for (numgeom = 0;num <= 0 || numgeom < num;numgeom++)
 	{
-		Message(_("Sorry\n No file selected"), _("Error"), TRUE);
-		return FALSE;
+		if (!find_dalton_geometry_in_log_index(index, &pos)) break;
+		posGeom = pos;
+		get_line_from_log_index(index, &pos, t, BSIZE);
 	}
-
-	file = FOpen(FileName, "rb");
-	if (file == NULL)
+	if (numgeom == 0)
 	{
-		Message(_("Sorry\nI can not open this file"), _("Error"), TRUE);
+		Message(_("Sorry\nI can not read geometry in this file"), _("Error"), TRUE);
 		return FALSE;
 	}
-	t = g_malloc(BSIZE);
-	for (i = 0;i < 5;i++) AtomCoord[i] = g_malloc(BSIZE * sizeof(char));
+	pos = posGeom;
+	for (i = 0;i < 3;i++) get_line_from_log_index(index, &pos, t, BSIZE);
 
-	numgeom = 1;
-	do
+	j = -1;
+	while (get_line_from_log_index(index, &pos, t, BSIZE))
 	{
-		OK = FALSE;
-		while (!feof(file))
-		{
-			{ char* e = fgets(t, BSIZE, file); }
-			/* if (strstr(t,"Next geometry"))*/
-			if (strstr(t, "Next geometry") || strstr(t, "Final geometry"))
-			{
-				{ char* e = fgets(t, BSIZE, file); }
-				{ char* e = fgets(t, BSIZE, file); }
-				numgeom++;
-				OK = TRUE;
-				break;
-			}
-		}
-		if (!OK && (numgeom == 1))
-		{
-			Message(_("Sorry\nI can not read geometry in this file"), _("Error"), TRUE);
-			fclose(file);
-			g_free(t);
-			for (i = 0;i < 5;i++) g_free(AtomCoord[i]);
-			return FALSE;
-		}
-		if (!OK)break;
+		if (!strcmp(t, "\n")) break;
+		j++;
+		listOfAtoms = g_realloc(listOfAtoms, (j + 1) * sizeof(Atom));
 
-		j = -1;
-		while (!feof(file))
-		{
-			{ char* e = fgets(t, BSIZE, file); }
-			if (!strcmp(t, "\n"))
-			{
-				break;
-			}
-			j++;
-			if (listOfAtoms == NULL) listOfAtoms = g_malloc(sizeof(Atom));
-			else listOfAtoms = g_realloc(listOfAtoms, (j + 1) * sizeof(Atom));
-
-			kk = sscanf(t, "%s %s %s %s %s", AtomCoord[0], AtomCoord[1], AtomCoord[2], AtomCoord[3], dum);
-			if (kk == 5) sscanf(t, "%s %s %s %s %s", AtomCoord[0], dum, AtomCoord[1], AtomCoord[2], AtomCoord[3]);
-
-			for (i = 0;i < (gint)strlen(AtomCoord[0]);i++) if (isdigit(AtomCoord[0][i])) AtomCoord[0][i] = ' ';
-			delete_all_spaces(AtomCoord[0]);
-			AtomCoord[0][0] = toupper(AtomCoord[0][0]);
-			l = strlen(AtomCoord[0]);
-			if (l == 2) AtomCoord[0][1] = tolower(AtomCoord[0][1]);
-
-
-			sprintf(listOfAtoms[j].symbol, "%s", AtomCoord[0]);
-			sprintf(listOfAtoms[j].mmType, "%s", AtomCoord[0]);
-			sprintf(listOfAtoms[j].pdbType, "%s", AtomCoord[0]);
-			for (i = 0;i < 3;i++) listOfAtoms[j].C[i] = atof((AtomCoord[i + 1]));
-			listOfAtoms[j].partialCharge = 0.0;
-			listOfAtoms[j].nuclearCharge = get_atomic_number_from_symbol(listOfAtoms[j].symbol);
-			listOfAtoms[j].variable = 0;
-		}
-		if (num > 0 && (gint)numgeom - 1 == num) break;
+		kk = sscanf(t, "%s %s %s %s %s", AtomCoord[0], AtomCoord[1], AtomCoord[2], AtomCoord[3], dum);
+		if (kk == 5) sscanf(t, "%s %s %s %s %s", AtomCoord[0], dum, AtomCoord[1], AtomCoord[2], AtomCoord[3]);
 
-	} while (!feof(file));
+		for (i = 0;i < strlen(AtomCoord[0]);i++) if (isdigit(AtomCoord[0][i])) AtomCoord[0][i] = ' ';
+		delete_all_spaces(AtomCoord[0]);
+		AtomCoord[0][0] = toupper(AtomCoord[0][0]);
+		l = strlen(AtomCoord[0]);
+		if (l == 2) AtomCoord[0][1] = tolower(AtomCoord[0][1]);
 
-	fclose(file);
-	g_free(t);
-	for (i = 0;i < 5;i++) g_free(AtomCoord[i]);
-	if (j + 1 == 0 && listOfAtoms)
-	{
-		g_free(listOfAtoms);
+		sprintf(listOfAtoms[j].symbol, "%s", AtomCoord[0]);
+		sprintf(listOfAtoms[j].mmType, "%s", AtomCoord[0]);
+		sprintf(listOfAtoms[j].pdbType, "%s", AtomCoord[0]);
+		for (i = 0;i < 3;i++) listOfAtoms[j].C[i] = atof((AtomCoord[i + 1]));
+		listOfAtoms[j].partialCharge = 0.0;
+		listOfAtoms[j].nuclearCharge = get_atomic_number_from_symbol(listOfAtoms[j].symbol);
+		listOfAtoms[j].variable = 0;
 	}
-	else
+	if (j + 1 > 0)
 	{
 		geometry->numberOfAtoms = j + 1;
 		geometry->listOfAtoms = listOfAtoms;
@@ -1533,103 +1503,46 @@ static gboolean read_dalton_file_geomi(gchar* FileName, gint num, Geometry* geom
 	return TRUE;
 }
 /********************************************************************************/
-static gboolean read_gamess_file_geomi(gchar* FileName, gint num, Geometry* geometry)
+/* geometry number num (the last one if num is out of range) from the lines of the pattern iPattern of the index */
+static gboolean read_gamess_geometry_from_log_index(LogIndex* index, gint iPattern, gint num, Geometry* geometry)
 {
-	gchar* t;
-	gboolean OK;
-	gchar* AtomCoord[5];
-	FILE* file;
+	gchar t[BSIZE];
+	gchar AtomCoord[5][BSIZE];
+	gchar dum[BSIZE];
 	guint i;
-	gint j = 0;
-	gint l;
-	guint numgeom;
+	gint j;
+	gsize pos;
 	Atom* listOfAtoms = NULL;
-	gchar dum[100];
-
+	gint n = index->nPatternLines[iPattern];
 
-	if ((!FileName) || (strcmp(FileName, "") == 0))
+	if (n < 1)
 	{
-		Message(_("Sorry\n No file selected"), _("Error"), TRUE);
+		Message(_("Sorry\nI can not read geometry in this file"), _("Error"), TRUE);
 		return FALSE;
 	}
+	if (num <= 0 || num > n) num = n;
+	pos = index->patternLines[iPattern][num - 1];
+	for (i = 0;i < 3;i++) get_line_from_log_index(index, &pos, t, BSIZE);
 
-	file = FOpen(FileName, "rb");
-	if (file == NULL)
-	{
-		Message(_("Sorry\nI can not open this file"), _("Error"), TRUE);
-		return FALSE;
-	}
-	t = g_malloc(BSIZE * sizeof(gchar));
-	for (i = 0;i < 5;i++) AtomCoord[i] = g_malloc(BSIZE * sizeof(char));
-	numgeom = 1;
-	do
+	j = -1;
+	while (get_line_from_log_index(index, &pos, t, BSIZE))
 	{
-		OK = FALSE;
-		while (!feof(file))
-		{
-			{ char* e = fgets(t, BSIZE, file); }
-			if (strstr(t, "COORDINATES OF ALL ATOMS ARE (ANGS)"))
-			{
-				{ char* e = fgets(t, BSIZE, file); }
-				{ char* e = fgets(t, BSIZE, file); }
-				numgeom++;
-				OK = TRUE;
-				break;
-			}
-		}
-		if (!OK && (numgeom == 1))
-		{
-			Message(_("Sorry\nI can not read geometry in this file"), _("Error"), TRUE);
-			fclose(file);
-			g_free(t);
-			for (i = 0;i < 5;i++) g_free(AtomCoord[i]);
-			return FALSE;
-		}
-		if (!OK)break;
-
-		j = -1;
-		while (!feof(file))
-		{
-			{ char* e = fgets(t, BSIZE, file); }
-			if (this_is_a_backspace(t))
-			{
-				break;
-			}
-			j++;
-			if (listOfAtoms == NULL) listOfAtoms = g_malloc(sizeof(Atom));
-			else listOfAtoms = g_realloc(listOfAtoms, (j + 1) * sizeof(Atom));
-
-			/* printf("t=%s\n",t);*/
-			sscanf(t, "%s %s %s %s %s", AtomCoord[0], dum, AtomCoord[1], AtomCoord[2], AtomCoord[3]);
-
-			for (i = 0;i < (gint)strlen(AtomCoord[0]);i++) if (isdigit(AtomCoord[0][i])) AtomCoord[0][i] = ' ';
-			delete_all_spaces(AtomCoord[0]);
-			AtomCoord[0][0] = toupper(AtomCoord[0][0]);
-			l = strlen(AtomCoord[0]);
-			if (l == 2) AtomCoord[0][1] = tolower(AtomCoord[0][1]);
-
-
-			sprintf(AtomCoord[0], "%s", get_symbol_using_z(atoi(dum)));
-			sprintf(listOfAtoms[j].symbol, "%s", AtomCoord[0]);
-			sprintf(listOfAtoms[j].mmType, "%s", AtomCoord[0]);
-			sprintf(listOfAtoms[j].pdbType, "%s", AtomCoord[0]);
-			for (i = 0;i < 3;i++) listOfAtoms[j].C[i] = atof((AtomCoord[i + 1])) * ANG_TO_BOHR;
-			listOfAtoms[j].partialCharge = 0.0;
-			listOfAtoms[j].nuclearCharge = get_atomic_number_from_symbol(listOfAtoms[j].symbol);
-			listOfAtoms[j].variable = 0;
-		}
-		if (num > 0 && (gint)numgeom - 1 == num) break;
+		if (this_is_a_backspace(t)) break;
+		j++;
+		listOfAtoms = g_realloc(listOfAtoms, (j + 1) * sizeof(Atom));
 
-	} while (!feof(file));
+		sscanf(t, "%s %s %s %s %s", AtomCoord[0], dum, AtomCoord[1], AtomCoord[2], AtomCoord[3]);
 
-	fclose(file);
-	g_free(t);
-	for (i = 0;i < 5;i++) g_free(AtomCoord[i]);
-	if (j + 1 == 0 && listOfAtoms)
-	{
-		g_free(listOfAtoms);
+		sprintf(AtomCoord[0], "%s", get_symbol_using_z(atoi(dum)));
+		sprintf(listOfAtoms[j].symbol, "%s", AtomCoord[0]);
+		sprintf(listOfAtoms[j].mmType, "%s", AtomCoord[0]);
+		sprintf(listOfAtoms[j].pdbType, "%s", AtomCoord[0]);
+		for (i = 0;i < 3;i++) listOfAtoms[j].C[i] = atof((AtomCoord[i + 1])) * ANG_TO_BOHR;
+		listOfAtoms[j].partialCharge = 0.0;
+		listOfAtoms[j].nuclearCharge = get_atomic_number_from_symbol(listOfAtoms[j].symbol);
+		listOfAtoms[j].variable = 0;
 	}
-	else
+	if (j + 1 > 0)
 	{
 		geometry->numberOfAtoms = j + 1;
 		geometry->listOfAtoms = listOfAtoms;
@@ -1639,23 +1552,26 @@ static gboolean read_gamess_file_geomi(gchar* FileName, gint num, Geometry* geom
 /********************************************************************************/
 static gboolean read_gamess_output(gchar* fileName)
 {
-	gchar* pdest;
 	gint  k = 0;
 	gchar* maxGrad = NULL;
 	gchar* rmsGrad = NULL;
 	gchar* temp = NULL;
 	gchar* tmp = NULL;
 	gchar* t = NULL;
-	FILE* file;
+	LogIndex* index = NULL;
+	gsize pos = 0;
+	gint h;
+	gint i;
 	gboolean OK;
+	static const gchar* patterns[] = {"1NSERCH=", "POINT NSERCH=", "COORDINATES OF ALL ATOMS ARE (ANGS)", "ENERGY=", "MAXIMUM GRADIENT =", NULL};
 
 	temp = get_name_file(fileName);
 	set_status_label_info(_("File name"), temp);
 	g_free(temp);
 	set_status_label_info(_("File type"), "Gamess");
 
-	file = FOpen(fileName, "rb");
-	if (!file)
+	index = new_log_index(fileName, patterns, FALSE);
+	if (!index)
 	{
 		t = g_strdup_printf(_(" Error : I can not open file %s\n"), fileName);
 		Message(t, _("Error"), TRUE);
@@ -1669,92 +1585,72 @@ static gboolean read_gamess_output(gchar* fileName)
 	tmp = g_malloc(50 * sizeof(gchar));
 
 	OK = TRUE;
-	while (!feof(file))
+	for (h = 0;h < index->nLines;h++)
 	{
-		if (!fgets(t, BSIZE, file)) break;
-		/* pdest = strstr( t,"NSERCH=   ");*/
-		pdest = strstr(t, "1NSERCH=");
-		if (pdest == NULL) pdest = strstr(t, "POINT NSERCH=");
-		if (pdest != NULL)
+		if (index->lines[h] < pos) continue;
+		if (!log_index_line_has_pattern(index, h, 0) && !log_index_line_has_pattern(index, h, 1)) continue;
+		pos = index->lines[h];
+		get_line_from_log_index(index, &pos, t, BSIZE);
+
+		OK = find_pattern_in_log_index(index, 2, &pos);
+		for (i = 0;i < 3 && OK;i++) OK = get_line_from_log_index(index, &pos, t, BSIZE);
+		if (!OK) break;
+
+		OK = FALSE;
+		while (find_pattern_in_log_index(index, 3, &pos))
 		{
-			OK = TRUE;
-			while (!feof(file) && OK)
+			get_line_from_log_index(index, &pos, t, BSIZE);
+			if (strstr(t, "NSERCH"))
 			{
-				if (!fgets(t, BSIZE, file)) { OK = FALSE; break; }
-				if (strstr(t, "COORDINATES OF ALL ATOMS ARE (ANGS)"))
-				{
-					if (!fgets(t, BSIZE, file)) { OK = FALSE; break; }
-					if (!fgets(t, BSIZE, file)) { OK = FALSE; break; }
-					OK = TRUE;
-					break;
-				}
+				sscanf(strstr(t, "ENERGY=") + 7, "%s", tmp); /* energy */
+				OK = TRUE;
+				break;
 			}
-			if (!OK) break;
+		}
+		if (!OK) break;
 
-			OK = TRUE;
-			while (!feof(file) && OK)
-			{
-				if (!fgets(t, BSIZE, file)) { OK = FALSE; break; }
-				if (strstr(t, "NSERCH") && strstr(t, "ENERGY="))
-				{
-					gchar* t1 = strstr(t, "ENERGY=");
-					if (t1) sscanf(t1 + 7, "%s", tmp); /* energy */
-					else { OK = FALSE; break; }
-					OK = TRUE;
-					break;
-				}
-			}
-			if (!OK) break;
-			OK = TRUE;
-			while (!feof(file) && OK)
+		OK = FALSE;
+		while (find_pattern_in_log_index(index, 4, &pos))
+		{
+			get_line_from_log_index(index, &pos, t, BSIZE);
+			if (strstr(t, "RMS GRADIENT ="))
 			{
-				if (!fgets(t, BSIZE, file)) { OK = FALSE; break; }
-				if (strstr(t, "MAXIMUM GRADIENT =") && strstr(t, "RMS GRADIENT ="))
-				{
-					gchar* t1 = strstr(t, "MAXIMUM GRADIENT =");
-					if (t1) sscanf(t1 + 19, "%s", maxGrad); /* maxGrad */
-					else { OK = FALSE; break; }
-					t1 = strstr(t, "RMS GRADIENT =");
-					if (t1) sscanf(t1 + 15, "%s", rmsGrad); /* rmsGrad */
-					else { OK = FALSE; break; }
-					OK = TRUE;
-					break;
-				}
+				sscanf(strstr(t, "MAXIMUM GRADIENT =") + 19, "%s", maxGrad); /* maxGrad */
+				sscanf(strstr(t, "RMS GRADIENT =") + 15, "%s", rmsGrad); /* rmsGrad */
+				OK = TRUE;
+				break;
 			}
-			if (!OK) break;
 		}
-		if (pdest != NULL)
+		if (!OK) break;
+
+		geometryConvergence.numberOfGeometries++;
+		if (geometryConvergence.numberOfGeometries == 1)
 		{
-			geometryConvergence.numberOfGeometries++;
-			if (geometryConvergence.numberOfGeometries == 1)
-			{
-				geometryConvergence.typeOfFile = GABEDIT_TYPEFILE_GAMESS;
-				geometryConvergence.fileName = g_strdup(fileName);
-				geometryConvergence.numGeometry = g_malloc(sizeof(gint));
-				geometryConvergence.numGeometry[0] = 1;
-				geometryConvergence.energy = g_malloc(sizeof(gdouble));
-				geometryConvergence.energy[0] = atof(tmp);
-				geometryConvergence.maxStep = g_malloc(sizeof(gdouble));
-				geometryConvergence.maxStep[0] = atof(maxGrad);
-				geometryConvergence.rmsStep = g_malloc(sizeof(gdouble));
-				geometryConvergence.rmsStep[0] = atof(rmsGrad);
-			}
-			else
-			{
-				geometryConvergence.numGeometry =
-					g_realloc(geometryConvergence.numGeometry, geometryConvergence.numberOfGeometries * sizeof(gint));
-				k = geometryConvergence.numberOfGeometries - 1;
-				geometryConvergence.numGeometry[k] = k + 1;
-				geometryConvergence.energy =
-					g_realloc(geometryConvergence.energy, geometryConvergence.numberOfGeometries * sizeof(gdouble));
-				geometryConvergence.energy[k] = atof(tmp);
+			geometryConvergence.typeOfFile = GABEDIT_TYPEFILE_GAMESS;
+			geometryConvergence.fileName = g_strdup(fileName);
+			geometryConvergence.numGeometry = g_malloc(sizeof(gint));
+			geometryConvergence.numGeometry[0] = 1;
+			geometryConvergence.energy = g_malloc(sizeof(gdouble));
+			geometryConvergence.energy[0] = atof(tmp);
+			geometryConvergence.maxStep = g_malloc(sizeof(gdouble));
+			geometryConvergence.maxStep[0] = atof(maxGrad);
+			geometryConvergence.rmsStep = g_malloc(sizeof(gdouble));
+			geometryConvergence.rmsStep[0] = atof(rmsGrad);
+		}
+		else
+		{
+			geometryConvergence.numGeometry =
+				g_realloc(geometryConvergence.numGeometry, geometryConvergence.numberOfGeometries * sizeof(gint));
+			k = geometryConvergence.numberOfGeometries - 1;
+			geometryConvergence.numGeometry[k] = k + 1;
+			geometryConvergence.energy =
+				g_realloc(geometryConvergence.energy, geometryConvergence.numberOfGeometries * sizeof(gdouble));
+			geometryConvergence.energy[k] = atof(tmp);
 
-				geometryConvergence.maxStep = g_realloc(geometryConvergence.maxStep, geometryConvergence.numberOfGeometries * sizeof(gdouble));
-				geometryConvergence.maxStep[k] = atof(maxGrad);
-				geometryConvergence.rmsStep = g_realloc(geometryConvergence.rmsStep, geometryConvergence.numberOfGeometries * sizeof(gdouble));
-				geometryConvergence.rmsStep[k] = atof(rmsGrad);
-			}
-			OK = TRUE;
+			geometryConvergence.maxStep = g_realloc(geometryConvergence.maxStep, geometryConvergence.numberOfGeometries * sizeof(gdouble));
+			geometryConvergence.maxStep[k] = atof(maxGrad);
+			geometryConvergence.rmsStep = g_realloc(geometryConvergence.rmsStep, geometryConvergence.numberOfGeometries * sizeof(gdouble));
+			geometryConvergence.rmsStep[k] = atof(rmsGrad);
 		}
 	}
 	if (!OK)
@@ -1765,7 +1661,6 @@ static gboolean read_gamess_output(gchar* fileName)
 		OK = FALSE;
 	}
 
-	fclose(file);
 	g_free(t);
 	g_free(temp);
 	g_free(maxGrad);
@@ -1774,11 +1669,10 @@ static gboolean read_gamess_output(gchar* fileName)
 
 	if (geometryConvergence.numberOfGeometries > 0)
 	{
-		gint i;
 		geometryConvergence.geometries = g_malloc(geometryConvergence.numberOfGeometries * sizeof(Geometry));
 		for (i = 0;i < geometryConvergence.numberOfGeometries;i++)
 		{
-			if (!read_gamess_file_geomi(fileName, geometryConvergence.numGeometry[i], &geometryConvergence.geometries[i])) break;
+			if (!read_gamess_geometry_from_log_index(index, 2, geometryConvergence.numGeometry[i], &geometryConvergence.geometries[i])) break;
 		}
 		if (i != geometryConvergence.numberOfGeometries)
 		{
@@ -1786,104 +1680,60 @@ static gboolean read_gamess_output(gchar* fileName)
 			OK = FALSE;
 		}
 	}
+	free_log_index(index);
 	rafreshList();
 	return OK;
 }
 /********************************************************************************/
-static gboolean read_gamess_irc_file_geomi(gchar* FileName, gint num, Geometry* geometry)
+/* geometry number num (the last one if num is out of range) from the lines of the pattern iPattern of the index */
+static gboolean read_gamess_irc_geometry_from_log_index(LogIndex* index, gint iPattern, gint num, Geometry* geometry)
 {
-	gchar* t;
-	gboolean OK;
-	gchar* AtomCoord[5];
-	FILE* file;
+	gchar t[BSIZE];
+	gchar AtomCoord[5][BSIZE];
+	gchar dum[BSIZE];
 	guint i;
-	gint j = 0;
+	gint j;
 	gint l;
-	guint numgeom;
+	gsize pos;
 	Atom* listOfAtoms = NULL;
-	gchar dum[100];
-
+	gint n = index->nPatternLines[iPattern];
 
-	if ((!FileName) || (strcmp(FileName, "") == 0))
-	{
-		Message(_("Sorry\n No file selected"), _("Error"), TRUE);
-		return FALSE;
-	}
-
-	file = FOpen(FileName, "rb");
-	if (file == NULL)
+	if (n < 1)
 	{
-		Message(_("Sorry\nI can not open this file"), _("Error"), TRUE);
+		Message(_("Sorry\nI can not read geometry in this file"), _("Error"), TRUE);
 		return FALSE;
 	}
-	t = g_malloc(BSIZE);
-	for (i = 0;i < 5;i++) AtomCoord[i] = g_malloc(BSIZE * sizeof(char));
+	if (num <= 0 || num > n) num = n;
+	pos = index->patternLines[iPattern][num - 1];
+	get_line_from_log_index(index, &pos, t, BSIZE);
 
-	numgeom = 1;
-	do
+	j = -1;
+	while (get_line_from_log_index(index, &pos, t, BSIZE))
 	{
-		OK = FALSE;
-		while (!feof(file))
-		{
-			{ char* e = fgets(t, BSIZE, file); }
-			if (strstr(t, "CARTESIAN COORDINATES (BOHR)"))
-			{
-				numgeom++;
-				OK = TRUE;
-				break;
-			}
-		}
-		if (!OK && (numgeom == 1))
-		{
-			Message(_("Sorry\nI can not read geometry in this file"), _("Error"), TRUE);
-			fclose(file);
-			g_free(t);
-			for (i = 0;i < 5;i++) g_free(AtomCoord[i]);
-			return FALSE;
-		}
-		if (!OK)break;
+		gdouble rdum = 0;
+		if (!strcmp(t, "\n")) break;
+		if (!strcmp(t, "GRADIENT")) break;
+		if (2 != sscanf(t, "%s %lf", AtomCoord[0], &rdum)) break;
+		j++;
+		listOfAtoms = g_realloc(listOfAtoms, (j + 1) * sizeof(Atom));
 
-		j = -1;
-		while (!feof(file))
-		{
-			gdouble rdum = 0;
-			if (!fgets(t, BSIZE, file))break;
-			if (!strcmp(t, "\n")) break;
-			if (!strcmp(t, "GRADIENT")) break;
-			if (2 != sscanf(t, "%s %lf", AtomCoord[0], &rdum)) break;
-			j++;
-			if (listOfAtoms == NULL) listOfAtoms = g_malloc(sizeof(Atom));
-			else listOfAtoms = g_realloc(listOfAtoms, (j + 1) * sizeof(Atom));
-
-			sscanf(t, "%s %s %s %s %s", AtomCoord[0], dum, AtomCoord[1], AtomCoord[2], AtomCoord[3]);
-
-			for (i = 0;i < (gint)strlen(AtomCoord[0]);i++) if (isdigit(AtomCoord[0][i])) AtomCoord[0][i] = ' ';
-			delete_all_spaces(AtomCoord[0]);
-			AtomCoord[0][0] = toupper(AtomCoord[0][0]);
-			l = strlen(AtomCoord[0]);
-			if (l == 2) AtomCoord[0][1] = tolower(AtomCoord[0][1]);
-
-
-			sprintf(listOfAtoms[j].symbol, "%s", AtomCoord[0]);
-			sprintf(listOfAtoms[j].mmType, "%s", AtomCoord[0]);
-			sprintf(listOfAtoms[j].pdbType, "%s", AtomCoord[0]);
-			for (i = 0;i < 3;i++) listOfAtoms[j].C[i] = atof((AtomCoord[i + 1]));
-			listOfAtoms[j].partialCharge = 0.0;
-			listOfAtoms[j].nuclearCharge = get_atomic_number_from_symbol(listOfAtoms[j].symbol);
-			listOfAtoms[j].variable = 0;
-		}
-		if (num > 0 && (gint)numgeom - 1 == num) break;
+		sscanf(t, "%s %s %s %s %s", AtomCoord[0], dum, AtomCoord[1], AtomCoord[2], AtomCoord[3]);
 
-	} while (!feof(file));
+		for (i = 0;i < strlen(AtomCoord[0]);i++) if (isdigit(AtomCoord[0][i])) AtomCoord[0][i] = ' ';
+		delete_all_spaces(AtomCoord[0]);
+		AtomCoord[0][0] = toupper(AtomCoord[0][0]);
+		l = strlen(AtomCoord[0]);
+		if (l == 2) AtomCoord[0][1] = tolower(AtomCoord[0][1]);
 
-	fclose(file);
-	g_free(t);
-	for (i = 0;i < 5;i++) g_free(AtomCoord[i]);
-	if (j + 1 == 0 && listOfAtoms)
-	{
-		g_free(listOfAtoms);
+		sprintf(listOfAtoms[j].symbol, "%s", AtomCoord[0]);
+		sprintf(listOfAtoms[j].mmType, "%s", AtomCoord[0]);
+		sprintf(listOfAtoms[j].pdbType, "%s", AtomCoord[0]);
+		for (i = 0;i < 3;i++) listOfAtoms[j].C[i] = atof((AtomCoord[i + 1]));
+		listOfAtoms[j].partialCharge = 0.0;
+		listOfAtoms[j].nuclearCharge = get_atomic_number_from_symbol(listOfAtoms[j].symbol);
+		listOfAtoms[j].variable = 0;
 	}
-	else
+	if (j + 1 > 0)
 	{
 		geometry->numberOfAtoms = j + 1;
 		geometry->listOfAtoms = listOfAtoms;
@@ -1897,16 +1747,19 @@ static gboolean read_gamess_irc(gchar* fileName)
 	gchar* temp = NULL;
 	gchar* tmp = NULL;
 	gchar* t = NULL;
-	FILE* file;
+	LogIndex* index = NULL;
+	gsize pos = 0;
+	gint h;
 	gboolean OK;
+	static const gchar* patterns[] = {"POINT=", "CARTESIAN COORDINATES (BOHR)", NULL};
 
 	temp = get_name_file(fileName);
 	set_status_label_info(_("File name"), temp);
 	g_free(temp);
 	set_status_label_info(_("File type"), "Gamess");
 
-	file = FOpen(fileName, "rb");
-	if (!file)
+	index = new_log_index(fileName, patterns, FALSE);
+	if (!index)
 	{
 		t = g_strdup_printf(_(" Error : I can not open file %s\n"), fileName);
 		Message(t, _("Error"), TRUE);
@@ -1918,49 +1771,40 @@ static gboolean read_gamess_irc(gchar* fileName)
 	tmp = g_malloc(50 * sizeof(gchar));
 
 	OK = TRUE;
-	while (!feof(file))
-	{
-		if (!fgets(t, BSIZE, file)) break;
-		if (strstr(t, "POINT=") && strstr(t, "E="))
+	for (h = 0;h < index->nPatternLines[0];h++)
+	{
+		if (index->patternLines[0][h] < pos) continue;
+		pos = index->patternLines[0][h];
+		get_line_from_log_index(index, &pos, t, BSIZE);
+		if (!strstr(t, "E=")) continue;
+		sscanf(strstr(t, "E=") + 2, "%s", tmp); /* energy */
+		OK = find_pattern_in_log_index(index, 1, &pos);
+		if (!OK) break;
+		get_line_from_log_index(index, &pos, t, BSIZE);
+		geometryConvergence.numberOfGeometries++;
+		if (geometryConvergence.numberOfGeometries == 1)
 		{
-			sscanf(strstr(t, "E=") + 2, "%s", tmp); /* energy */
-			OK = TRUE;
-			while (!feof(file) && OK)
-			{
-				if (!fgets(t, BSIZE, file)) { OK = FALSE; break; }
-				if (strstr(t, "CARTESIAN COORDINATES (BOHR)"))
-				{
-					OK = TRUE;
-					break;
-				}
-			}
-			if (!OK) break;
-			geometryConvergence.numberOfGeometries++;
-			if (geometryConvergence.numberOfGeometries == 1)
-			{
-				geometryConvergence.typeOfFile = GABEDIT_TYPEFILE_GAMESS;
-				geometryConvergence.fileName = g_strdup(fileName);
-				geometryConvergence.numGeometry = g_malloc(sizeof(gint));
-				geometryConvergence.numGeometry[0] = 1;
-				geometryConvergence.energy = g_malloc(sizeof(gdouble));
-				geometryConvergence.energy[0] = atof(tmp);
-				geometryConvergence.maxStep = NULL;
-				geometryConvergence.rmsStep = NULL;
-			}
-			else
-			{
-				geometryConvergence.numGeometry =
-					g_realloc(geometryConvergence.numGeometry, geometryConvergence.numberOfGeometries * sizeof(gint));
-				k = geometryConvergence.numberOfGeometries - 1;
-				geometryConvergence.numGeometry[k] = k + 1;
-				geometryConvergence.energy =
-					g_realloc(geometryConvergence.energy, geometryConvergence.numberOfGeometries * sizeof(gdouble));
-				geometryConvergence.energy[k] = atof(tmp);
+			geometryConvergence.typeOfFile = GABEDIT_TYPEFILE_GAMESS;
+			geometryConvergence.fileName = g_strdup(fileName);
+			geometryConvergence.numGeometry = g_malloc(sizeof(gint));
+			geometryConvergence.numGeometry[0] = 1;
+			geometryConvergence.energy = g_malloc(sizeof(gdouble));
+			geometryConvergence.energy[0] = atof(tmp);
+			geometryConvergence.maxStep = NULL;
+			geometryConvergence.rmsStep = NULL;
+		}
+		else
+		{
+			geometryConvergence.numGeometry =
+				g_realloc(geometryConvergence.numGeometry, geometryConvergence.numberOfGeometries * sizeof(gint));
+			k = geometryConvergence.numberOfGeometries - 1;
+			geometryConvergence.numGeometry[k] = k + 1;
+			geometryConvergence.energy =
+				g_realloc(geometryConvergence.energy, geometryConvergence.numberOfGeometries * sizeof(gdouble));
+			geometryConvergence.energy[k] = atof(tmp);
 
-				geometryConvergence.maxStep = NULL;
-				geometryConvergence.rmsStep = NULL;
-			}
-			OK = TRUE;
+			geometryConvergence.maxStep = NULL;
+			geometryConvergence.rmsStep = NULL;
 		}
 	}
 	if (!OK)
@@ -1971,7 +1815,6 @@ static gboolean read_gamess_irc(gchar* fileName)
 		OK = FALSE;
 	}
 
-	fclose(file);
 	g_free(t);
 	g_free(temp);
 	g_free(tmp);
@@ -1980,404 +1823,229 @@ static gboolean read_gamess_irc(gchar* fileName)
 		gint i;
 		geometryConvergence.geometries = g_malloc(geometryConvergence.numberOfGeometries * sizeof(Geometry));
 		for (i = 0;i < geometryConvergence.numberOfGeometries;i++)
-			if (!read_gamess_irc_file_geomi(fileName, geometryConvergence.numGeometry[i], &geometryConvergence.geometries[i])) break;
+			if (!read_gamess_irc_geometry_from_log_index(index, 1, geometryConvergence.numGeometry[i], &geometryConvergence.geometries[i])) break;
 		if (i != geometryConvergence.numberOfGeometries)
 		{
 			freeGeometryConvergence();
 			OK = FALSE;
 		}
 	}
+	free_log_index(index);
 	rafreshList();
 	return OK;
 }
 /*****************************************************************************************************/
-static gboolean read_gaussian_file_geomi_str(gchar* FileName, gint num, gchar* str, Geometry* geometry)
+/* geometry number num (the last one if num is out of range) from the lines of the pattern iPattern of the index */
+static gboolean read_gaussian_geometry_from_log_index(LogIndex* index, gint iPattern, gint num, Geometry* geometry)
 {
-	gchar* t;
-	gboolean OK;
-	gchar* AtomCoord[5];
-	FILE* file;
+	gchar t[BSIZE];
+	gchar AtomCoord[5][BSIZE];
 	guint idummy;
 	guint i;
-	gint j = 0;
+	gint j;
 	gint l;
-	guint numgeom;
-	gchar* pdest;
-	gint result;
-	guint itype = 0;
-	Atom* listOfAtoms = NULL;
-
-
-	file = FOpen(FileName, "rb");
-
-	t = g_malloc(BSIZE);
-	for (i = 0;i < 5;i++) AtomCoord[i] = g_malloc(BSIZE * sizeof(char));
-
-	numgeom = 1;
-	do
-	{
-		OK = FALSE;
-		while (!feof(file))
-		{
-			{ char* e = fgets(t, BSIZE, file); }
-			if (strstr(t, str))
-			{
-				{ char* e = fgets(t, BSIZE, file); }
-				{ char* e = fgets(t, BSIZE, file); }
-				{ char* e = fgets(t, BSIZE, file); }
-
-				if (strstr(t, "Type")) itype = 1;
-				else itype = 0;
-				{ char* e = fgets(t, BSIZE, file); }
-				numgeom++;
-				OK = TRUE;
-				break;
-			}
-		}
-		if (!OK && (numgeom == 1))
-		{
-			fclose(file);
-			g_free(t);
-			for (i = 0;i < 5;i++) g_free(AtomCoord[i]);
-			return FALSE;
-		}
-		if (!OK)break;
-
-		j = -1;
-		while (!feof(file))
-		{
-			{ char* e = fgets(t, BSIZE, file); }
-			if (strstr(t, "----------------------------------") > 0)
-			{
-				break;
-			}
-			j++;
-			if (listOfAtoms == NULL) listOfAtoms = g_malloc(sizeof(Atom));
-			else listOfAtoms = g_realloc(listOfAtoms, (j + 1) * sizeof(Atom));
-
-			if (itype == 0) sscanf(t, "%d %s %s %s %s", &idummy, AtomCoord[0], AtomCoord[1], AtomCoord[2], AtomCoord[3]);
-			else sscanf(t, "%d %s %d %s %s %s", &idummy, AtomCoord[0], &idummy, AtomCoord[1], AtomCoord[2], AtomCoord[3]);
-
-			AtomCoord[0][0] = toupper(AtomCoord[0][0]);
-			l = strlen(AtomCoord[0]);
-			if (l == 2) AtomCoord[0][1] = tolower(AtomCoord[0][1]);
-
-			sprintf(listOfAtoms[j].symbol, "%s", symb_atom_get((guint)atoi(AtomCoord[0])));
-			sprintf(listOfAtoms[j].mmType, "%s", listOfAtoms[j].symbol);
-			sprintf(listOfAtoms[j].pdbType, "%s", listOfAtoms[j].symbol);
-			for (i = 0;i < 3;i++) listOfAtoms[j].C[i] = atof(ang_to_bohr(AtomCoord[i + 1]));
-			listOfAtoms[j].partialCharge = 0.0;
-			listOfAtoms[j].nuclearCharge = get_atomic_number_from_symbol(listOfAtoms[j].symbol);
-			listOfAtoms[j].variable = 0;
-		}
-		if (num > 0 && (gint)numgeom - 1 == num) break;
-	} while (!feof(file));
-
-	fclose(file);
-	g_free(t);
-	for (i = 0;i < 5;i++) g_free(AtomCoord[i]);
-
-	if (j + 1 == 0 && listOfAtoms)
-	{
-		g_free(listOfAtoms);
-		listOfAtoms = NULL;
-	}
-	else
-	{
-		geometry->numberOfAtoms = j + 1;
-		geometry->listOfAtoms = listOfAtoms;
-	}
-	return TRUE;
-}
-/********************************************************************************/
-static gboolean read_gaussian_file_geomi(gchar* FileName, gint num, Geometry* geometry)
-{
-	FILE* file;
-	if ((!FileName) || (strcmp(FileName, "") == 0))
-	{
-		Message(_("Sorry\n No file selected"), _("Error"), TRUE);
-		return FALSE;
-	}
-	file = FOpen(FileName, "rb");
-	if (file == NULL)
+	gsize pos;
+	guint itype = 0;
+	Atom* listOfAtoms = NULL;
+	gint n = index->nPatternLines[iPattern];
+
+	if (n < 1) return FALSE;
+	if (num <= 0 || num > n) num = n;
+	pos = index->patternLines[iPattern][num - 1];
+	for (i = 0;i < 4;i++) get_line_from_log_index(index, &pos, t, BSIZE);
+	if (strstr(t, "Type")) itype = 1;
+	get_line_from_log_index(index, &pos, t, BSIZE);
+
+	j = -1;
+	while (get_line_from_log_index(index, &pos, t, BSIZE))
 	{
-		Message(_("Sorry\nI can not open this file"), _("Error"), TRUE);
-		return FALSE;
-	}
-	fclose(file);
+		if (strstr(t, "----------------------------------")) break;
+		j++;
+		listOfAtoms = g_realloc(listOfAtoms, (j + 1) * sizeof(Atom));
 
+		if (itype == 0) sscanf(t, "%d %s %s %s %s", &idummy, AtomCoord[0], AtomCoord[1], AtomCoord[2], AtomCoord[3]);
+		else sscanf(t, "%d %s %d %s %s %s", &idummy, AtomCoord[0], &idummy, AtomCoord[1], AtomCoord[2], AtomCoord[3]);
+
+		AtomCoord[0][0] = toupper(AtomCoord[0][0]);
+		l = strlen(AtomCoord[0]);
+		if (l == 2) AtomCoord[0][1] = tolower(AtomCoord[0][1]);
 
-	if (read_gaussian_file_geomi_str(FileName, num, "Standard orientation:", geometry)) return TRUE;
-	if (read_gaussian_file_geomi_str(FileName, num, "Input orientation:", geometry)) return TRUE;
-	/* for calculation with nosym option */
-	if (!read_gaussian_file_geomi_str(FileName, num, "Z-Matrix orientation:", geometry))
+		sprintf(listOfAtoms[j].symbol, "%s", symb_atom_get((guint)atoi(AtomCoord[0])));
+		sprintf(listOfAtoms[j].mmType, "%s", listOfAtoms[j].symbol);
+		sprintf(listOfAtoms[j].pdbType, "%s", listOfAtoms[j].symbol);
+		for (i = 0;i < 3;i++) listOfAtoms[j].C[i] = atof(ang_to_bohr(AtomCoord[i + 1]));
+		listOfAtoms[j].partialCharge = 0.0;
+		listOfAtoms[j].nuclearCharge = get_atomic_number_from_symbol(listOfAtoms[j].symbol);
+		listOfAtoms[j].variable = 0;
+	}
+	if (j + 1 > 0)
 	{
-		Message(_("Sorry\nI can not read geometry in this file"), _("Error"), TRUE);
-		return FALSE;
+		geometry->numberOfAtoms = j + 1;
+		geometry->listOfAtoms = listOfAtoms;
 	}
 	return TRUE;
-
 }
 /********************************************************************************/
-static gboolean read_molpro_file_geomi(gchar* FileName, gint num, Geometry* geometry)
+/* geometry number num (the last one if num is out of range), patterns 0 and 2 of the index are "Optimization point" and " ATOMIC COORDINATES" */
+static gboolean read_molpro_geometry_from_log_index(LogIndex* index, gint num, Geometry* geometry)
 {
-	gchar* t;
-	gboolean OK;
-	gchar* AtomCoord[5];
-	FILE* file;
+	gchar t[BSIZE];
+	gchar AtomCoord[5][BSIZE];
 	guint idummy;
 	guint i;
-	gint j = 0;
+	gint j;
 	gint l;
-	guint numgeom;
+	gint numgeom;
+	gsize pos = 0;
+	gsize posAtoms = 0;
 	Atom* listOfAtoms = NULL;
 
-
-	if ((!FileName) || (strcmp(FileName, "") == 0))
+	/* the atoms of a geometry do not contain the tags, the next search can begin at its first atom */
+	for (numgeom = 0;num <= 0 || numgeom < num;numgeom++)
 	{
-		Message(_("Sorry\n No file selected"), _("Error"), TRUE);
-		return FALSE;
+		gboolean OK = FALSE;
+		if (!find_pattern_in_log_index(index, 0, &pos)) break;
+		get_line_from_log_index(index, &pos, t, BSIZE);
+		while (find_pattern_in_log_index(index, 2, &pos))
+		{
+			get_line_from_log_index(index, &pos, t, BSIZE);
+			if (strcmp(t, " ATOMIC COORDINATES\n")) continue;
+			get_line_from_log_index(index, &pos, t, BSIZE);
+			get_line_from_log_index(index, &pos, t, BSIZE);
+			if (strstr(t, "Q_EFF")) continue;
+			get_line_from_log_index(index, &pos, t, BSIZE);
+			OK = TRUE;
+			break;
+		}
+		if (!OK) break;
+		posAtoms = pos;
 	}
-
-	file = FOpen(FileName, "rb");
-	if (file == NULL)
+	if (numgeom == 0)
 	{
-		Message(_("Sorry\nI can not open this file"), _("Error"), TRUE);
+		Message(_("Sorry\nI can not read geometry in this file"), _("Error"), TRUE);
 		return FALSE;
 	}
-	t = g_malloc(BSIZE);
-	for (i = 0;i < 5;i++) AtomCoord[i] = g_malloc(BSIZE * sizeof(char));
 
-	numgeom = 1;
-	do
+	pos = posAtoms;
+	j = -1;
+	while (get_line_from_log_index(index, &pos, t, BSIZE))
 	{
-		OK = FALSE;
-		while (!feof(file))
-		{
-			{ char* e = fgets(t, BSIZE, file); }
-			if (strstr(t, "Optimization point"))
-			{
-				OK = TRUE;
-				break;
-			}
-		}
-		if (!OK) break;
-		OK = FALSE;
-		while (!feof(file))
-		{
-			{ char* e = fgets(t, BSIZE, file); }
-			if (!strcmp(t, " ATOMIC COORDINATES\n"))
-			{
-				{ char* e = fgets(t, BSIZE, file); }
-				{ char* e = fgets(t, BSIZE, file); }
-				if (strstr(t, "Q_EFF"))continue;
-				{ char* e = fgets(t, BSIZE, file); }
-				numgeom++;
-				OK = TRUE;
-				break;
-			}
-		}
-		if (!OK && (numgeom == 1))
-		{
-			Message(_("Sorry\nI can not read geometry in this file"), _("Error"), TRUE);
-			fclose(file);
-			g_free(t);
-			for (i = 0;i < 5;i++) g_free(AtomCoord[i]);
-			return FALSE;
-		}
-		if (!OK)break;
+		if (!strcmp(t, "\n")) break;
+		j++;
+		listOfAtoms = g_realloc(listOfAtoms, (j + 1) * sizeof(Atom));
 
-		j = -1;
-		while (!feof(file))
-		{
-			{ char* e = fgets(t, BSIZE, file); }
-			if (!strcmp(t, "\n"))
-			{
-				break;
-			}
-			j++;
-			if (listOfAtoms == NULL) listOfAtoms = g_malloc(sizeof(Atom));
-			else listOfAtoms = g_realloc(listOfAtoms, (j + 1) * sizeof(Atom));
-
-			sscanf(t, "%d %s %s %s %s %s", &idummy, AtomCoord[0], AtomCoord[1], AtomCoord[1], AtomCoord[2], AtomCoord[3]);
-
-			for (i = 0;i < (gint)strlen(AtomCoord[0]);i++) if (isdigit(AtomCoord[0][i])) AtomCoord[0][i] = ' ';
-			delete_all_spaces(AtomCoord[0]);
-
-			AtomCoord[0][0] = toupper(AtomCoord[0][0]);
-			l = strlen(AtomCoord[0]);
-			if (l == 2) AtomCoord[0][1] = tolower(AtomCoord[0][1]);
-
-			sprintf(listOfAtoms[j].symbol, "%s", AtomCoord[0]);
-			sprintf(listOfAtoms[j].mmType, "%s", listOfAtoms[j].symbol);
-			sprintf(listOfAtoms[j].pdbType, "%s", listOfAtoms[j].symbol);
-			for (i = 0;i < 3;i++) listOfAtoms[j].C[i] = atof((AtomCoord[i + 1]));
-			listOfAtoms[j].partialCharge = 0.0;
-			listOfAtoms[j].nuclearCharge = get_atomic_number_from_symbol(listOfAtoms[j].symbol);
-			listOfAtoms[j].variable = 0;
-		}
+		sscanf(t, "%d %s %s %s %s %s", &idummy, AtomCoord[0], AtomCoord[1], AtomCoord[1], AtomCoord[2], AtomCoord[3]);
 
-		if (num > 0 && (gint)numgeom - 1 == num) break;
+		for (i = 0;i < strlen(AtomCoord[0]);i++) if (isdigit(AtomCoord[0][i])) AtomCoord[0][i] = ' ';
+		delete_all_spaces(AtomCoord[0]);
 
-	} while (!feof(file));
+		AtomCoord[0][0] = toupper(AtomCoord[0][0]);
+		l = strlen(AtomCoord[0]);
+		if (l == 2) AtomCoord[0][1] = tolower(AtomCoord[0][1]);
 
-	fclose(file);
-	g_free(t);
-	for (i = 0;i < 5;i++) g_free(AtomCoord[i]);
-	if (j + 1 == 0 && listOfAtoms)
-	{
-		g_free(listOfAtoms);
-		OK = FALSE;
-	}
-	else
-	{
-		geometry->numberOfAtoms = j + 1;
-		geometry->listOfAtoms = listOfAtoms;
-		OK = TRUE;
+		sprintf(listOfAtoms[j].symbol, "%s", AtomCoord[0]);
+		sprintf(listOfAtoms[j].mmType, "%s", listOfAtoms[j].symbol);
+		sprintf(listOfAtoms[j].pdbType, "%s", listOfAtoms[j].symbol);
+		for (i = 0;i < 3;i++) listOfAtoms[j].C[i] = atof((AtomCoord[i + 1]));
+		listOfAtoms[j].partialCharge = 0.0;
+		listOfAtoms[j].nuclearCharge = get_atomic_number_from_symbol(listOfAtoms[j].symbol);
+		listOfAtoms[j].variable = 0;
 	}
-	return OK;
+	if (j + 1 <= 0) return FALSE;
+	geometry->numberOfAtoms = j + 1;
+	geometry->listOfAtoms = listOfAtoms;
+	return TRUE;
 }
 /********************************************************************************/
-static gboolean read_mpqc_file_geomi(gchar* fileName, gint numGeometry, Geometry* geometry)
+/* geometry number numGeometry, the pattern iPattern of the index is "<Molecule>" */
+static gboolean read_mpqc_geometry_from_log_index(LogIndex* index, gint iPattern, gint numGeometry, Geometry* geometry)
 {
-	gchar* t;
-	gboolean OK;
-	gchar* AtomCoord[5];
-	FILE* file;
+	gchar t[BSIZE];
+	gchar AtomCoord[5][BSIZE];
 	guint idummy;
 	guint i;
-	gint j = 0;
+	gint j;
 	gint l;
-	guint numGeom;
+	gint numGeom = 0;
+	gsize pos = 0;
 	gdouble tmpReal;
+	gboolean unitOfOutAng = FALSE;
+	gboolean OK = FALSE;
 	Atom* listOfAtoms = NULL;
 
-
-	file = FOpen(fileName, "rb");
-
-	if (file == NULL)
-	{
-		Message(_("Sorry\nI can not open this file"), _("Error"), TRUE);
-		return FALSE;
-	}
-
-	t = g_malloc(BSIZE);
-	for (i = 0;i < 5;i++) AtomCoord[i] = g_malloc(BSIZE * sizeof(char));
-
-	numGeom = 0;
-	do
+	while (find_pattern_in_log_index(index, iPattern, &pos))
 	{
-		gboolean unitOfOutAng = FALSE;
-		OK = FALSE;
-		while (!feof(file))
+		gboolean OkUnit = FALSE;
+		get_line_from_log_index(index, &pos, t, BSIZE);
+		unitOfOutAng = FALSE;
+		while (get_line_from_log_index(index, &pos, t, BSIZE))
 		{
-			if (!fgets(t, BSIZE, file)) break;
-			if (strstr(t, "<Molecule>"))
+			if (strstr(t, "unit"))
 			{
-				gboolean OkUnit = FALSE;
-				do {
-					if (!fgets(t, BSIZE, file))break;
-					if (strstr(t, "unit"))
-					{
-						OkUnit = TRUE;
-						if (strstr(t, "angstrom"))unitOfOutAng = TRUE;
-						break;
-					};
-
-				} while (!feof(file));
-				if (!OkUnit) break;
-				numGeom++;
-				if ((gint)numGeom == numGeometry)
-				{
-					OK = TRUE;
-					break;
-				}
-				if (numGeometry < 0)
-				{
-					OK = TRUE;
-					break;
-				}
+				OkUnit = TRUE;
+				if (strstr(t, "angstrom"))unitOfOutAng = TRUE;
+				break;
 			}
 		}
-		if (!OK && (numGeom == 0))
+		if (!OkUnit) break;
+		numGeom++;
+		if (numGeom == numGeometry)
 		{
-			g_free(t);
-			t = g_strdup_printf(_("Sorry\nI can read Geometry from %s  file "), fileName);
-			Message(t, _("Error"), TRUE);
-			g_free(t);
-			for (i = 0;i < 5;i++) g_free(AtomCoord[i]);
-			return FALSE;
+			OK = TRUE;
+			break;
 		}
-		if (!OK) break;
+	}
+	if (OK)
+	{
 		OK = FALSE;
-		while (!feof(file))
+		while (get_line_from_log_index(index, &pos, t, BSIZE))
 		{
-			if (!fgets(t, BSIZE, file))break;
 			if (!(strstr(t, "atoms") && strstr(t, "geometry"))) continue;
 			OK = TRUE;
 			break;
 		}
-		if (!OK)
-		{
-			g_free(t);
-			t = g_strdup_printf(_("Sorry\nI can read Geometry from %s  file "), fileName);
-			Message(t, _("Error"), TRUE);
-			g_free(t);
-			for (i = 0;i < 5;i++) g_free(AtomCoord[i]);
-			return FALSE;
-		}
-
-		j = -1;
-		while (!feof(file))
-		{
-			if (!fgets(t, BSIZE, file))break;
-			if (strstr(t, "}"))break;
-			j++;
-
-			if (listOfAtoms == NULL) listOfAtoms = g_malloc(sizeof(Atom));
-			else listOfAtoms = g_realloc(listOfAtoms, (j + 1) * sizeof(Atom));
-
-			for (i = 0;i < strlen(t);i++) if (t[i] == '[' || t[i] == ']') t[i] = ' ';
-			sscanf(t, "%d %s %s %s %s", &idummy, AtomCoord[0], AtomCoord[1], AtomCoord[2], AtomCoord[3]);
-			for (i = 1;i <= 3;i++)
-			{
-				tmpReal = atof(AtomCoord[i]);
-				sprintf(AtomCoord[i], "%lf", tmpReal);
-			}
+	}
+	if (!OK)
+	{
+		Message(_("Sorry\nI can not read geometry in this file"), _("Error"), TRUE);
+		return FALSE;
+	}
 
-			AtomCoord[0][0] = toupper(AtomCoord[0][0]);
+	j = -1;
+	while (get_line_from_log_index(index, &pos, t, BSIZE))
+	{
+		if (strstr(t, "}"))break;
+		j++;
+		listOfAtoms = g_realloc(listOfAtoms, (j + 1) * sizeof(Atom));
 
-			l = strlen(AtomCoord[0]);
+		for (i = 0;i < strlen(t);i++) if (t[i] == '[' || t[i] == ']') t[i] = ' ';
+		sscanf(t, "%d %s %s %s %s", &idummy, AtomCoord[0], AtomCoord[1], AtomCoord[2], AtomCoord[3]);
+		for (i = 1;i <= 3;i++)
+		{
+			tmpReal = atof(AtomCoord[i]);
+			sprintf(AtomCoord[i], "%lf", tmpReal);
+		}
 
-			if (l == 2) AtomCoord[0][1] = tolower(AtomCoord[0][1]);
+		AtomCoord[0][0] = toupper(AtomCoord[0][0]);
 
-			sprintf(listOfAtoms[j].symbol, "%s", AtomCoord[0]);
-			sprintf(listOfAtoms[j].mmType, "%s", listOfAtoms[j].symbol);
-			sprintf(listOfAtoms[j].pdbType, "%s", listOfAtoms[j].symbol);
-			for (i = 0;i < 3;i++)
-				if (unitOfOutAng)
-					listOfAtoms[j].C[i] = atof(ang_to_bohr(AtomCoord[i + 1]));
-				else
-					listOfAtoms[j].C[i] = atof(AtomCoord[i + 1]);
-			listOfAtoms[j].partialCharge = 0.0;
-			listOfAtoms[j].nuclearCharge = get_atomic_number_from_symbol(listOfAtoms[j].symbol);
-			listOfAtoms[j].variable = 0;
+		l = strlen(AtomCoord[0]);
 
-		}
+		if (l == 2) AtomCoord[0][1] = tolower(AtomCoord[0][1]);
 
-		if (numGeometry < 0) continue;
-		if (OK) break;
-	} while (!feof(file));
+		sprintf(listOfAtoms[j].symbol, "%s", AtomCoord[0]);
+		sprintf(listOfAtoms[j].mmType, "%s", listOfAtoms[j].symbol);
+		sprintf(listOfAtoms[j].pdbType, "%s", listOfAtoms[j].symbol);
+		for (i = 0;i < 3;i++)
+			if (unitOfOutAng)
+				listOfAtoms[j].C[i] = atof(ang_to_bohr(AtomCoord[i + 1]));
+			else
+				listOfAtoms[j].C[i] = atof(AtomCoord[i + 1]);
+		listOfAtoms[j].partialCharge = 0.0;
+		listOfAtoms[j].nuclearCharge = get_atomic_number_from_symbol(listOfAtoms[j].symbol);
+		listOfAtoms[j].variable = 0;
 
-	fclose(file);
-	g_free(t);
-	for (i = 0;i < 5;i++) g_free(AtomCoord[i]);
-	if (j + 1 == 0 && listOfAtoms)
-	{
-		g_free(listOfAtoms);
-		listOfAtoms = NULL;
 	}
-	else
+	if (j + 1 > 0)
 	{
 		geometry->numberOfAtoms = j + 1;
 		geometry->listOfAtoms = listOfAtoms;
@@ -2385,7 +2053,8 @@ static gboolean read_mpqc_file_geomi(gchar* fileName, gint numGeometry, Geometry
 	return TRUE;
 }
 /********************************************************************************/
-static gboolean read_mopac_aux_file_geomi(gchar* FileName, gint numgeometry, Geometry* geometry)
+/* the patterns 0, 1 and 2 of the index are "ATOM_X_UPDATED:ANGSTROMS", "ATOM_X_OPT:ANGSTROMS" and "ATOM_CORE[" */
+static gboolean read_mopac_aux_file_geomi(gchar* FileName, LogIndex* index, gint numgeometry, Geometry* geometry)
 {
 	gchar* t;
 	/* gboolean OK;*/
@@ -2396,12 +2065,13 @@ static gboolean read_mopac_aux_file_geomi(gchar* FileName, gint numgeometry, Geo
 	gint l;
 	guint numgeom = 0;
 	Atom* listOfAtoms = NULL;
-	gchar* pdest = NULL;
 	gint nElements = 0;
 	gchar** elements = NULL;
 	long int geomposok = 0;
 	gchar** nuclearCharges = NULL;
 	gint nNuclearCharges = 0;
+	gint iPattern = (numgeometry < 0) ? 1 : 0;
+	gint n = index->nPatternLines[iPattern];
 
 	if ((!FileName) || (strcmp(FileName, "") == 0))
 	{
@@ -2422,31 +2092,21 @@ static gboolean read_mopac_aux_file_geomi(gchar* FileName, gint numgeometry, Geo
 		fclose(file);
 		return FALSE;
 	}
-	geomposok = ftell(file);
-	nuclearCharges = get_one_block_from_aux_mopac_file(file, "ATOM_CORE[", &nNuclearCharges);
-	if (!nuclearCharges) fseek(file, geomposok, SEEK_SET);
+	if (index->nPatternLines[2] > 0)
+	{
+		fseek(file, (long int)index->patternLines[2][0], SEEK_SET);
+		nuclearCharges = get_one_block_from_aux_mopac_file(file, "ATOM_CORE[", &nNuclearCharges);
+	}
 
 	t = g_malloc(BSIZE * sizeof(gchar));
 	for (i = 0;i < 5;i++) AtomCoord[i] = g_malloc(BSIZE * sizeof(gchar));
-	fseek(file, 0, SEEK_SET);
-	while (!feof(file))
+	/* the last geometry if numgeometry is out of range */
+	numgeom = (numgeometry > 0 && numgeometry <= n) ? numgeometry : n;
+	if (numgeom > 0)
 	{
-		if (!fgets(t, BSIZE, file))break;
-		if (numgeometry < 0) pdest = strstr(t, "ATOM_X_OPT:ANGSTROMS");
-		else pdest = strstr(t, "ATOM_X_UPDATED:ANGSTROMS");
-		if (pdest)
-		{
-			numgeom++;
-			geomposok = ftell(file);
-			if (numgeom == numgeometry)
-			{
-				/* OK = TRUE;*/
-				break;
-			}
-			/*
-			if(numgeometry<0) { OK = TRUE; }
-			*/
-		}
+		fseek(file, (long int)index->patternLines[iPattern][numgeom - 1], SEEK_SET);
+		if (fgets(t, BSIZE, file)) geomposok = ftell(file);
+		else numgeom = 0;
 	}
 	if (numgeom == 0)
 	{
@@ -2517,106 +2177,63 @@ static gboolean read_mopac_aux_file_geomi(gchar* FileName, gint numgeometry, Geo
 	return TRUE;
 }
 /********************************************************************************/
-static gboolean read_qchem_file_geomi(gchar* FileName, gint num, Geometry* geometry)
+/* geometry number num (the last one if num is out of range), the pattern iPattern of the index is the header of the coordinates */
+static gboolean read_qchem_geometry_from_log_index(LogIndex* index, gint iPattern, gint num, Geometry* geometry)
 {
-	gchar* t;
-	gboolean OK;
-	gchar* AtomCoord[5];
-	FILE* file;
+	gchar t[BSIZE];
+	gchar AtomCoord[5][BSIZE];
 	guint idummy;
 	guint i;
-	gint j = 0;
+	gint j;
 	gint l;
-	guint numgeom;
+	gint h;
+	gint numgeom = 0;
+	gsize pos = 0;
+	gsize posAtoms = 0;
 	Atom* listOfAtoms = NULL;
-	gchar* pdest = NULL;
-
 
-	if ((!FileName) || (strcmp(FileName, "") == 0))
+	/* a header is a geometry only if it is followed by a line of dashes */
+	for (h = 0;h < index->nPatternLines[iPattern];h++)
 	{
-		Message(_("Sorry\n No file selected"), _("Error"), TRUE);
-		return FALSE;
+		pos = index->patternLines[iPattern][h];
+		get_line_from_log_index(index, &pos, t, BSIZE);
+		if (!get_line_from_log_index(index, &pos, t, BSIZE)) break;
+		if (!strstr(t, "----------------------------------------")) continue;
+		posAtoms = pos;
+		numgeom++;
+		if (num > 0 && numgeom == num) break;
 	}
-
-	file = FOpen(FileName, "rb");
-	if (file == NULL)
+	if (numgeom == 0)
 	{
-		Message(_("Sorry\nI can not open this file"), _("Error"), TRUE);
+		Message(_("Sorry\nI can not read geometry in this file"), _("Error"), TRUE);
 		return FALSE;
 	}
-	t = g_malloc(BSIZE);
-	for (i = 0;i < 5;i++) AtomCoord[i] = g_malloc(BSIZE * sizeof(gchar));
 
-	numgeom = 1;
-	do
+	pos = posAtoms;
+	j = -1;
+	while (get_line_from_log_index(index, &pos, t, BSIZE))
 	{
-		OK = FALSE;
-		while (!feof(file))
-		{
-			if (!fgets(t, BSIZE, file))break;
-			pdest = strstr(t, "Atom         X            Y            Z");
-			if (pdest)
-			{
-				if (!fgets(t, BSIZE, file))break;
-				pdest = strstr(t, "----------------------------------------");
-			}
-			if (pdest)
-			{
-				numgeom++;
-				OK = TRUE;
-				break;
-			}
-		}
-		if (!OK && (numgeom == 1))
-		{
-			Message(_("Sorry\nI can not read geometry in this file"), _("Error"), TRUE);
-			fclose(file);
-			g_free(t);
-			for (i = 0;i < 5;i++) g_free(AtomCoord[i]);
-			return FALSE;
-		}
-		if (!OK)break;
-
-		j = -1;
-		while (!feof(file))
-		{
-			{ char* e = fgets(t, BSIZE, file); }
-			if (strstr(t, "----------------------------------------"))
-			{
-				break;
-			}
-			j++;
-			if (listOfAtoms == NULL) listOfAtoms = g_malloc(sizeof(Atom));
-			else listOfAtoms = g_realloc(listOfAtoms, (j + 1) * sizeof(Atom));
-
-			sscanf(t, "%d %s %s %s %s", &idummy, AtomCoord[0], AtomCoord[1], AtomCoord[2], AtomCoord[3]);
-			AtomCoord[0][0] = toupper(AtomCoord[0][0]);
-			l = strlen(AtomCoord[0]);
-			if (isdigit(AtomCoord[0][1]))l = 1;
-			if (l == 2) AtomCoord[0][1] = tolower(AtomCoord[0][1]);
-			if (l == 1)sprintf(t, "%c", AtomCoord[0][0]);
-			else sprintf(t, "%c%c", AtomCoord[0][0], AtomCoord[0][1]);
-
-			sprintf(listOfAtoms[j].symbol, "%s", t);
-			sprintf(listOfAtoms[j].mmType, "%s", listOfAtoms[j].symbol);
-			sprintf(listOfAtoms[j].pdbType, "%s", listOfAtoms[j].symbol);
-			for (i = 0;i < 3;i++) listOfAtoms[j].C[i] = atof((AtomCoord[i + 1])) * ANG_TO_BOHR;
-			listOfAtoms[j].partialCharge = 0.0;
-			listOfAtoms[j].nuclearCharge = get_atomic_number_from_symbol(listOfAtoms[j].symbol);
-			listOfAtoms[j].variable = 0;
-		}
-		if (num > 0 && (gint)numgeom - 1 == num) break;
-
-	} while (!feof(file));
+		if (strstr(t, "----------------------------------------")) break;
+		j++;
+		listOfAtoms = g_realloc(listOfAtoms, (j + 1) * sizeof(Atom));
 
-	fclose(file);
-	g_free(t);
-	for (i = 0;i < 5;i++) g_free(AtomCoord[i]);
-	if (j + 1 == 0 && listOfAtoms)
-	{
-		g_free(listOfAtoms);
+		sscanf(t, "%d %s %s %s %s", &idummy, AtomCoord[0], AtomCoord[1], AtomCoord[2], AtomCoord[3]);
+		AtomCoord[0][0] = toupper(AtomCoord[0][0]);
+		l = strlen(AtomCoord[0]);
+		if (isdigit(AtomCoord[0][1]))l = 1;
+		if (l == 2) AtomCoord[0][1] = tolower(AtomCoord[0][1]);
+		if (l == 1)sprintf(t, "%c", AtomCoord[0][0]);
+		else sprintf(t, "%c%c", AtomCoord[0][0], AtomCoord[0][1]);
+
+		sprintf(listOfAtoms[j].symbol, "%s", t);
+		sprintf(listOfAtoms[j].mmType, "%s", listOfAtoms[j].symbol);
+		sprintf(listOfAtoms[j].pdbType, "%s", listOfAtoms[j].symbol);
+		for (i = 0;i < 3;i++) listOfAtoms[j].C[i] = atof((AtomCoord[i + 1])) * ANG_TO_BOHR;
+		listOfAtoms[j].partialCharge = 0.0;
+		listOfAtoms[j].nuclearCharge = get_atomic_number_from_symbol(listOfAtoms[j].symbol);
+		listOfAtoms[j].variable = 0;
 	}
-	else
+	if (j + 1 > 0)
 	{
 		geometry->numberOfAtoms = j + 1;
 		geometry->listOfAtoms = listOfAtoms;
@@ -3210,21 +2827,23 @@ static gint read_gabedit_geoms_file(gchar* fileName)
 /********************************************************************************/
 static gboolean read_dalton_output(gchar* fileName)
 {
-	gchar* pdest;
 	gint  k = 0;
 	gchar* temp = NULL;
 	gchar* tmp = NULL;
 	gchar* t = NULL;
-	FILE* file;
+	LogIndex* index = NULL;
+	gsize pos = 0;
+	gint h;
 	gboolean OK;
+	static const gchar* patterns[] = {"Optimization Control Center", "Next geometry", "Final geometry", "Energy at this geometry is", "Norm of step", NULL};
 
 	temp = get_name_file(fileName);
 	set_status_label_info(_("File name"), temp);
 	g_free(temp);
 	set_status_label_info(_("File type"), "Dalton");
 
-	file = FOpen(fileName, "rb");
-	if (!file)
+	index = new_log_index(fileName, patterns, FALSE);
+	if (!index)
 	{
 		t = g_strdup_printf(_(" Error : I can not open file %s\n"), fileName);
 		Message(t, _("Error"), TRUE);
@@ -3236,83 +2855,53 @@ static gboolean read_dalton_output(gchar* fileName)
 	tmp = g_malloc(50 * sizeof(char));
 
 	OK = TRUE;
-	while (!feof(file))
+	for (h = 0;h < index->nPatternLines[0];h++)
 	{
-		if (!fgets(t, BSIZE, file)) break;
-		pdest = strstr(t, "Optimization Control Center");
-		if (pdest != NULL)
-		{
-			OK = TRUE;
-			while (!feof(file) && OK)
-			{
-				if (!fgets(t, BSIZE, file)) { OK = FALSE; break; }
-				if (strstr(t, "Next geometry") || strstr(t, "Final geometry"))
-				{
-					if (!fgets(t, BSIZE, file)) { OK = FALSE; break; }
-					if (!fgets(t, BSIZE, file)) { OK = FALSE; break; }
-					OK = TRUE;
-					break;
-				}
-			}
-			if (!OK) break;
+		gint i;
+		if (index->patternLines[0][h] < pos) continue;
+		pos = index->patternLines[0][h];
+		get_line_from_log_index(index, &pos, t, BSIZE);
 
-			OK = TRUE;
-			while (!feof(file) && OK)
-			{
-				if (!fgets(t, BSIZE, file)) { OK = FALSE; break; }
-				if (strstr(t, "Energy at this geometry is"))
-				{
-					gchar* t1 = strstr(t, ":");
-					if (t1) sscanf(t1 + 1, "%s", tmp); /* energy */
-					else { OK = FALSE; break; }
-					OK = TRUE;
-					break;
-				}
-			}
-			if (!OK) break;
-			OK = TRUE;
-			while (!feof(file) && OK)
-			{
-				if (!fgets(t, BSIZE, file)) { OK = FALSE; break; }
-				if (strstr(t, "Norm of step"))
-				{
-					gchar* t1 = strstr(t, ":");
-					if (t1) sscanf(t1 + 1, "%s", temp); /* rmsStep */
-					else { OK = FALSE; break; }
-					OK = TRUE;
-					break;
-				}
-			}
-			if (!OK) break;
+		OK = find_dalton_geometry_in_log_index(index, &pos);
+		for (i = 0;i < 3 && OK;i++) OK = get_line_from_log_index(index, &pos, t, BSIZE);
+		if (!OK) break;
+
+		OK = find_pattern_in_log_index(index, 3, &pos);
+		if (!OK) break;
+		get_line_from_log_index(index, &pos, t, BSIZE);
+		if (!strstr(t, ":")) { OK = FALSE; break; }
+		sscanf(strstr(t, ":") + 1, "%s", tmp); /* energy */
+
+		OK = find_pattern_in_log_index(index, 4, &pos);
+		if (!OK) break;
+		get_line_from_log_index(index, &pos, t, BSIZE);
+		if (!strstr(t, ":")) { OK = FALSE; break; }
+		sscanf(strstr(t, ":") + 1, "%s", temp); /* rmsStep */
+
+		geometryConvergence.numberOfGeometries++;
+		if (geometryConvergence.numberOfGeometries == 1)
+		{
+			geometryConvergence.typeOfFile = GABEDIT_TYPEFILE_DALTON;
+			geometryConvergence.fileName = g_strdup(fileName);
+			geometryConvergence.numGeometry = g_malloc(sizeof(gint));
+			geometryConvergence.numGeometry[0] = 1;
+			geometryConvergence.energy = g_malloc(sizeof(gdouble));
+			geometryConvergence.energy[0] = atof(tmp);
+			geometryConvergence.rmsStep = g_malloc(sizeof(gdouble));
+			geometryConvergence.rmsStep[0] = atof(temp);
 		}
-		if (pdest != NULL)
+		else
 		{
-			geometryConvergence.numberOfGeometries++;
-			if (geometryConvergence.numberOfGeometries == 1)
-			{
-				geometryConvergence.typeOfFile = GABEDIT_TYPEFILE_DALTON;
-				geometryConvergence.fileName = g_strdup(fileName);
-				geometryConvergence.numGeometry = g_malloc(sizeof(gint));
-				geometryConvergence.numGeometry[0] = 1;
-				geometryConvergence.energy = g_malloc(sizeof(gdouble));
-				geometryConvergence.energy[0] = atof(tmp);
-				geometryConvergence.rmsStep = g_malloc(sizeof(gdouble));
-				geometryConvergence.rmsStep[0] = atof(temp);
-			}
-			else
-			{
-				geometryConvergence.numGeometry =
-					g_realloc(geometryConvergence.numGeometry, geometryConvergence.numberOfGeometries * sizeof(gint));
-				k = geometryConvergence.numberOfGeometries - 1;
-				geometryConvergence.numGeometry[k] = k + 1;
-				geometryConvergence.energy =
-					g_realloc(geometryConvergence.energy, geometryConvergence.numberOfGeometries * sizeof(gdouble));
-				geometryConvergence.energy[k] = atof(tmp);
+			geometryConvergence.numGeometry =
+				g_realloc(geometryConvergence.numGeometry, geometryConvergence.numberOfGeometries * sizeof(gint));
+			k = geometryConvergence.numberOfGeometries - 1;
+			geometryConvergence.numGeometry[k] = k + 1;
+			geometryConvergence.energy =
+				g_realloc(geometryConvergence.energy, geometryConvergence.numberOfGeometries * sizeof(gdouble));
+			geometryConvergence.energy[k] = atof(tmp);
 
-				geometryConvergence.rmsStep = g_realloc(geometryConvergence.rmsStep, geometryConvergence.numberOfGeometries * sizeof(gdouble));
-				geometryConvergence.rmsStep[k] = atof(temp);
-			}
-			OK = TRUE;
+			geometryConvergence.rmsStep = g_realloc(geometryConvergence.rmsStep, geometryConvergence.numberOfGeometries * sizeof(gdouble));
+			geometryConvergence.rmsStep[k] = atof(temp);
 		}
 	}
 	if (!OK)
@@ -3323,7 +2912,6 @@ static gboolean read_dalton_output(gchar* fileName)
 		OK = FALSE;
 	}
 
-	fclose(file);
 	g_free(t);
 	g_free(temp);
 	g_free(tmp);
@@ -3332,13 +2920,14 @@ static gboolean read_dalton_output(gchar* fileName)
 		gint i;
 		geometryConvergence.geometries = g_malloc(geometryConvergence.numberOfGeometries * sizeof(Geometry));
 		for (i = 0;i < geometryConvergence.numberOfGeometries;i++)
-			if (!read_dalton_file_geomi(fileName, geometryConvergence.numGeometry[i], &geometryConvergence.geometries[i])) break;
+			if (!read_dalton_geometry_from_log_index(index, geometryConvergence.numGeometry[i], &geometryConvergence.geometries[i])) break;
 		if (i != geometryConvergence.numberOfGeometries)
 		{
 			freeGeometryConvergence();
 			OK = FALSE;
 		}
 	}
+	free_log_index(index);
 	rafreshList();
 	return OK;
 }
@@ -3349,18 +2938,22 @@ static gboolean read_gaussian_output(gchar* fileName)
 	gint  k = 0;
 	gchar* temp = NULL;
 	gchar* t = NULL;
-	FILE* file;
+	LogIndex* index = NULL;
+	gsize pos = 0;
+	gint h;
+	gint iOrientation;
 	gint nE = 0;
 	gint nSF = 0;
 	gboolean OK;
+	static const gchar* patterns[] = {"SCF DONE", "ENERGY=", "CONVERGED?", "Standard orientation:", "Input orientation:", "Z-Matrix orientation:", NULL};
 
 	temp = get_name_file(fileName);
 	set_status_label_info(_("File name"), temp);
 	g_free(temp);
 	set_status_label_info(_("File type"), "Gaussian output");
 
-	file = FOpen(fileName, "rb");
-	if (!file)
+	index = new_log_index(fileName, patterns, TRUE);
+	if (!index)
 	{
 		t = g_strdup_printf(_(" Error : I can not open file %s\n"), fileName);
 		Message(t, _("Error"), TRUE);
@@ -3371,9 +2964,11 @@ static gboolean read_gaussian_output(gchar* fileName)
 	temp = g_malloc(50 * sizeof(char));
 
 	OK = TRUE;
-	while (!feof(file))
+	for (h = 0;h < index->nLines;h++)
 	{
-		if (!fgets(t, BSIZE, file)) break;
+		if (index->lines[h] < pos) continue;
+		pos = index->lines[h];
+		get_line_from_log_index(index, &pos, t, BSIZE);
 		uppercase(t);
 		pdest = strstr(t, "SCF DONE");
 		if (pdest != NULL) pdest = strstr(t, "=");
@@ -3428,13 +3023,13 @@ static gboolean read_gaussian_output(gchar* fileName)
 				break;
 			}
 			k = geometryConvergence.numberOfGeometries - 1;
-			{ char* e = fgets(t, BSIZE, file); }
+			get_line_from_log_index(index, &pos, t, BSIZE);
 			sscanf(t, "%s %s %lf", temp, temp, &geometryConvergence.maxForce[k]);
-			{ char* e = fgets(t, BSIZE, file); }
+			get_line_from_log_index(index, &pos, t, BSIZE);
 			sscanf(t, "%s %s %lf", temp, temp, &geometryConvergence.rmsForce[k]);
-			{ char* e = fgets(t, BSIZE, file); }
+			get_line_from_log_index(index, &pos, t, BSIZE);
 			sscanf(t, "%s %s %lf", temp, temp, &geometryConvergence.maxStep[k]);
-			{ char* e = fgets(t, BSIZE, file); }
+			get_line_from_log_index(index, &pos, t, BSIZE);
 			sscanf(t, "%s %s %lf", temp, temp, &geometryConvergence.rmsStep[k]);
 		}
 	}
@@ -3469,44 +3064,54 @@ static gboolean read_gaussian_output(gchar* fileName)
 		}
 
 	}
-	fclose(file);
 	g_free(t);
 	g_free(temp);
+	/* the standard orientations if any, else the input ones, else the z-matrix ones (nosym option) */
+	for (iOrientation = 3;iOrientation < 6;iOrientation++) if (index->nPatternLines[iOrientation] > 0) break;
+	if (geometryConvergence.numberOfGeometries > 0 && iOrientation == 6)
+	{
+		Message(_("Sorry\nI can not read geometry in this file"), _("Error"), TRUE);
+		freeGeometryConvergence();
+		OK = FALSE;
+	}
 	if (geometryConvergence.numberOfGeometries > 0)
 	{
 		gint i;
 		geometryConvergence.geometries = g_malloc(geometryConvergence.numberOfGeometries * sizeof(Geometry));
 		for (i = 0;i < geometryConvergence.numberOfGeometries;i++)
-			if (!read_gaussian_file_geomi(fileName, geometryConvergence.numGeometry[i], &geometryConvergence.geometries[i])) break;
+			if (!read_gaussian_geometry_from_log_index(index, iOrientation, geometryConvergence.numGeometry[i], &geometryConvergence.geometries[i])) break;
 		if (i != geometryConvergence.numberOfGeometries)
 		{
 			freeGeometryConvergence();
 			OK = FALSE;
 		}
 	}
+	free_log_index(index);
 	rafreshList();
 	return OK;
 }
 /********************************************************************************/
 static gboolean read_molpro_log(gchar* fileName)
 {
-	gchar* pdest;
 	gint  k = 0;
 	gchar* temp = NULL;
 	gchar* tmp = NULL;
 	gchar* t = NULL;
-	FILE* file;
+	LogIndex* index = NULL;
+	gsize pos = 0;
+	gint h;
 	gint nE = 0;
 	gint nSF = 0;
 	gboolean OK;
+	static const gchar* patterns[] = {"Optimization point", "Convergence:", " ATOMIC COORDINATES", NULL};
 
 	temp = get_name_file(fileName);
 	set_status_label_info(_("File name"), temp);
 	g_free(temp);
 	set_status_label_info(_("File type"), "Molpro log");
 
-	file = FOpen(fileName, "rb");
-	if (!file)
+	index = new_log_index(fileName, patterns, FALSE);
+	if (!index)
 	{
 		t = g_strdup_printf(_(" Error : I can not open file %s\n"), fileName);
 		Message(t, _("Error"), TRUE);
@@ -3518,69 +3123,54 @@ static gboolean read_molpro_log(gchar* fileName)
 	tmp = g_malloc(50 * sizeof(char));
 
 	OK = TRUE;
-	while (!feof(file))
+	for (h = 0;h < index->nPatternLines[0];h++)
 	{
-		if (!fgets(t, BSIZE, file)) break;
-		pdest = strstr(t, "Optimization point");
-		if (pdest != NULL)
+		if (index->patternLines[0][h] < pos) continue;
+		pos = index->patternLines[0][h];
+		get_line_from_log_index(index, &pos, t, BSIZE);
+		OK = FALSE;
+		while (get_line_from_log_index(index, &pos, t, BSIZE))
 		{
-			OK = TRUE;
-			while (!feof(file) && OK)
+			if (strstr(t, "(") && strstr(t, ")"))
 			{
-				if (!fgets(t, BSIZE, file))
-				{
-					OK = FALSE;
-					break;
-				}
-				if (strstr(t, "(") && strstr(t, ")"))
-				{
-					OK = TRUE;
-					break;
-				}
+				OK = TRUE;
+				break;
 			}
-			if (!OK) break;
 		}
-		if (pdest != NULL)
+		if (!OK) break;
+
+		sscanf(t, "%s %s %s %s %s", temp, temp, temp, temp, tmp);
+		geometryConvergence.numberOfGeometries++;
+		nE++;
+		if (geometryConvergence.numberOfGeometries == 1)
 		{
-			sscanf(t, "%s %s %s %s %s", temp, temp, temp, temp, tmp);
-			geometryConvergence.numberOfGeometries++;
-			nE++;
-			if (geometryConvergence.numberOfGeometries == 1)
-			{
-				geometryConvergence.typeOfFile = GABEDIT_TYPEFILE_MOLPRO_LOG;
-				geometryConvergence.fileName = g_strdup(fileName);
-				geometryConvergence.numGeometry = g_malloc(sizeof(gint));
-				geometryConvergence.numGeometry[0] = 1;
-				geometryConvergence.energy = g_malloc(sizeof(gdouble));
-				geometryConvergence.energy[0] = atof(tmp);
-				geometryConvergence.rmsStep = g_malloc(sizeof(gdouble));
-			}
-			else
-			{
-				geometryConvergence.numGeometry =
-					g_realloc(geometryConvergence.numGeometry, geometryConvergence.numberOfGeometries * sizeof(gint));
-				k = geometryConvergence.numberOfGeometries - 1;
-				geometryConvergence.numGeometry[k] = k + 1;
-				geometryConvergence.energy =
-					g_realloc(geometryConvergence.energy, geometryConvergence.numberOfGeometries * sizeof(gdouble));
-				geometryConvergence.energy[k] = atof(tmp);
+			geometryConvergence.typeOfFile = GABEDIT_TYPEFILE_MOLPRO_LOG;
+			geometryConvergence.fileName = g_strdup(fileName);
+			geometryConvergence.numGeometry = g_malloc(sizeof(gint));
+			geometryConvergence.numGeometry[0] = 1;
+			geometryConvergence.energy = g_malloc(sizeof(gdouble));
+			geometryConvergence.energy[0] = atof(tmp);
+			geometryConvergence.rmsStep = g_malloc(sizeof(gdouble));
+		}
+		else
+		{
+			geometryConvergence.numGeometry =
+				g_realloc(geometryConvergence.numGeometry, geometryConvergence.numberOfGeometries * sizeof(gint));
+			k = geometryConvergence.numberOfGeometries - 1;
+			geometryConvergence.numGeometry[k] = k + 1;
+			geometryConvergence.energy =
+				g_realloc(geometryConvergence.energy, geometryConvergence.numberOfGeometries * sizeof(gdouble));
+			geometryConvergence.energy[k] = atof(tmp);
 
-				geometryConvergence.rmsStep = g_realloc(geometryConvergence.rmsStep, geometryConvergence.numberOfGeometries * sizeof(gdouble));
-			}
-			OK = TRUE;
-			do
-			{
-				if (!fgets(t, BSIZE, file)) { OK = FALSE; break; }
-			} while (strstr(t, "Convergence:") == NULL && !feof(file));
-			if (!OK) break;
-			if (strstr(t, "Convergence:") != NULL)
-			{
-				nSF++;
-				k = geometryConvergence.numberOfGeometries - 1;
-				sscanf(t, "%s %s %s %s %s ", temp, temp, temp, temp, tmp);
-				geometryConvergence.rmsStep[k] = atof(tmp);
-			}
+			geometryConvergence.rmsStep = g_realloc(geometryConvergence.rmsStep, geometryConvergence.numberOfGeometries * sizeof(gdouble));
 		}
+		OK = find_pattern_in_log_index(index, 1, &pos);
+		if (!OK) break;
+		get_line_from_log_index(index, &pos, t, BSIZE);
+		nSF++;
+		k = geometryConvergence.numberOfGeometries - 1;
+		sscanf(t, "%s %s %s %s %s ", temp, temp, temp, temp, tmp);
+		geometryConvergence.rmsStep[k] = atof(tmp);
 	}
 	if (!OK)
 	{
@@ -3611,7 +3201,6 @@ static gboolean read_molpro_log(gchar* fileName)
 
 	}
 
-	fclose(file);
 	g_free(t);
 	g_free(temp);
 	g_free(tmp);
@@ -3620,13 +3209,14 @@ static gboolean read_molpro_log(gchar* fileName)
 		gint i;
 		geometryConvergence.geometries = g_malloc(geometryConvergence.numberOfGeometries * sizeof(Geometry));
 		for (i = 0;i < geometryConvergence.numberOfGeometries;i++)
-			if (!read_molpro_file_geomi(fileName, geometryConvergence.numGeometry[i], &geometryConvergence.geometries[i])) break;
+			if (!read_molpro_geometry_from_log_index(index, geometryConvergence.numGeometry[i], &geometryConvergence.geometries[i])) break;
 		if (i != geometryConvergence.numberOfGeometries)
 		{
 			freeGeometryConvergence();
 			OK = FALSE;
 		}
 	}
+	free_log_index(index);
 	rafreshList();
 	return OK;
 }
@@ -3637,20 +3227,22 @@ static gboolean read_mpqc_output(gchar* fileName)
 	gint  k = 0;
 	gchar* temp = NULL;
 	gchar* t = NULL;
-	FILE* file;
+	LogIndex* index = NULL;
+	gint h;
 	gint nE = 0;
 	gint nSF = 0;
 	gboolean OK;
 	gboolean newGeom;
 	gboolean mp2;
+	static const gchar* patterns[] = {"changing atomic coordinates:", "MP2", "total scf energy", "Max Displacement", "<Molecule>", NULL};
 
 	temp = get_name_file(fileName);
 	set_status_label_info(_("File name"), temp);
 	g_free(temp);
 	set_status_label_info(_("File type"), "MPQC output");
 
-	file = FOpen(fileName, "rb");
-	if (!file)
+	index = new_log_index(fileName, patterns, FALSE);
+	if (!index)
 	{
 		t = g_strdup_printf(_(" Error : I can not open file %s\n"), fileName);
 		Message(t, _("Error"), TRUE);
@@ -3663,9 +3255,11 @@ static gboolean read_mpqc_output(gchar* fileName)
 	OK = TRUE;
 	mp2 = FALSE;
 	newGeom = FALSE;
-	while (!feof(file))
+	/* only the lines containing a pattern change the state of the scan */
+	for (h = 0;h < index->nLines;h++)
 	{
-		if (!fgets(t, BSIZE, file)) break;
+		gsize pos = index->lines[h];
+		get_line_from_log_index(index, &pos, t, BSIZE);
 		if (strstr(t, "changing atomic coordinates:"))
 		{
 			newGeom = TRUE;
@@ -3760,7 +3354,6 @@ static gboolean read_mpqc_output(gchar* fileName)
 
 	}
 
-	fclose(file);
 	g_free(t);
 	g_free(temp);
 	if (geometryConvergence.numberOfGeometries > 0)
@@ -3768,13 +3361,14 @@ static gboolean read_mpqc_output(gchar* fileName)
 		gint i;
 		geometryConvergence.geometries = g_malloc(geometryConvergence.numberOfGeometries * sizeof(Geometry));
 		for (i = 0;i < geometryConvergence.numberOfGeometries;i++)
-			if (!read_mpqc_file_geomi(fileName, geometryConvergence.numGeometry[i], &geometryConvergence.geometries[i])) break;
+			if (!read_mpqc_geometry_from_log_index(index, 4, geometryConvergence.numGeometry[i], &geometryConvergence.geometries[i])) break;
 		if (i != geometryConvergence.numberOfGeometries)
 		{
 			freeGeometryConvergence();
 			OK = FALSE;
 		}
 	}
+	free_log_index(index);
 	rafreshList();
 	return OK;
 }
@@ -3786,7 +3380,9 @@ static gboolean read_mopac_aux(gchar* fileName)
 	gchar* tmp = NULL;
 	gchar* t = NULL;
 	FILE* file;
+	LogIndex* index = NULL;
 	gboolean OK;
+	static const gchar* patterns[] = {"ATOM_X_UPDATED:ANGSTROMS", "ATOM_X_OPT:ANGSTROMS", "ATOM_CORE[", NULL};
 
 	temp = get_name_file(fileName);
 	set_status_label_info(_("File name"), temp);
@@ -3907,18 +3503,21 @@ static gboolean read_mopac_aux(gchar* fileName)
 	g_free(t);
 	g_free(temp);
 	g_free(tmp);
+	if (geometryConvergence.numberOfGeometries > 0) index = new_log_index(fileName, patterns, FALSE);
+	if (geometryConvergence.numberOfGeometries > 0 && !index) freeGeometryConvergence();
 	if (geometryConvergence.numberOfGeometries > 0)
 	{
 		gint i;
 		geometryConvergence.geometries = g_malloc(geometryConvergence.numberOfGeometries * sizeof(Geometry));
 		for (i = 0;i < geometryConvergence.numberOfGeometries;i++)
-			if (!read_mopac_aux_file_geomi(fileName, geometryConvergence.numGeometry[i], &geometryConvergence.geometries[i])) break;
+			if (!read_mopac_aux_file_geomi(fileName, index, geometryConvergence.numGeometry[i], &geometryConvergence.geometries[i])) break;
 		if (i != geometryConvergence.numberOfGeometries)
 		{
 			freeGeometryConvergence();
 			OK = FALSE;
 		}
 	}
+	free_log_index(index);
 	rafreshList();
 	return OK;
 }
@@ -3929,19 +3528,21 @@ static gboolean read_qchem_output(gchar* fileName)
 	gchar* temp = NULL;
 	gchar* tmp = NULL;
 	gchar* t = NULL;
-	FILE* file;
+	LogIndex* index = NULL;
+	gsize pos = 0;
+	gint h;
 	gboolean OK;
-	gchar* pdest;
 	gint nE = 0;
 	gint nSF = 0;
+	static const gchar* patterns[] = {"Optimization Cycle:", "Energy is", "Cnvgd?", "Atom         X            Y            Z", NULL};
 
 	temp = get_name_file(fileName);
 	set_status_label_info(_("File name"), temp);
 	g_free(temp);
 	set_status_label_info(_("File type"), "Q-Chem out");
 
-	file = FOpen(fileName, "rb");
-	if (!file)
+	index = new_log_index(fileName, patterns, FALSE);
+	if (!index)
 	{
 		t = g_strdup_printf(_(" Error : I can not open file %s\n"), fileName);
 		Message(t, _("Error"), TRUE);
@@ -3953,72 +3554,52 @@ static gboolean read_qchem_output(gchar* fileName)
 	tmp = g_malloc(50 * sizeof(char));
 
 	OK = TRUE;
-	while (!feof(file))
+	for (h = 0;h < index->nLines;h++)
 	{
-		if (!fgets(t, BSIZE, file)) break;
-		pdest = strstr(t, "Optimization Cycle:");
-		if (pdest != NULL)
+		if (index->lines[h] < pos) continue;
+		if (!log_index_line_has_pattern(index, h, 0) && !log_index_line_has_pattern(index, h, 1)) continue;
+		pos = index->lines[h];
+		if (!log_index_line_has_pattern(index, h, 1))
 		{
-			OK = TRUE;
-			while (!feof(file) && OK)
-			{
-				if (!fgets(t, BSIZE, file))
-				{
-					OK = FALSE;
-					break;
-				}
-				if (strstr(t, "Energy is"))
-				{
-					OK = TRUE;
-					break;
-				}
-			}
+			get_line_from_log_index(index, &pos, t, BSIZE);
+			OK = find_pattern_in_log_index(index, 1, &pos);
 			if (!OK) break;
 		}
-		pdest = strstr(t, "Energy is");
-		if (pdest != NULL)
+		get_line_from_log_index(index, &pos, t, BSIZE);
+		sscanf(t, "%s %s %s", temp, temp, tmp);
+		geometryConvergence.numberOfGeometries++;
+		nE++;
+		if (geometryConvergence.numberOfGeometries == 1)
 		{
-			sscanf(t, "%s %s %s", temp, temp, tmp);
-			geometryConvergence.numberOfGeometries++;
-			nE++;
-			if (geometryConvergence.numberOfGeometries == 1)
-			{
-				geometryConvergence.typeOfFile = GABEDIT_TYPEFILE_QCHEM;
-				geometryConvergence.fileName = g_strdup(fileName);
-				geometryConvergence.numGeometry = g_malloc(sizeof(gint));
-				geometryConvergence.numGeometry[0] = 1;
-				geometryConvergence.energy = g_malloc(sizeof(gdouble));
-				geometryConvergence.energy[0] = atof(tmp);
-				geometryConvergence.maxForce = g_malloc(sizeof(gdouble));
-			}
-			else
-			{
-				geometryConvergence.numGeometry =
-					g_realloc(geometryConvergence.numGeometry, geometryConvergence.numberOfGeometries * sizeof(gint));
-				k = geometryConvergence.numberOfGeometries - 1;
-				geometryConvergence.numGeometry[k] = k + 1;
-				geometryConvergence.energy =
-					g_realloc(geometryConvergence.energy, geometryConvergence.numberOfGeometries * sizeof(gdouble));
-				geometryConvergence.energy[k] = atof(tmp);
+			geometryConvergence.typeOfFile = GABEDIT_TYPEFILE_QCHEM;
+			geometryConvergence.fileName = g_strdup(fileName);
+			geometryConvergence.numGeometry = g_malloc(sizeof(gint));
+			geometryConvergence.numGeometry[0] = 1;
+			geometryConvergence.energy = g_malloc(sizeof(gdouble));
+			geometryConvergence.energy[0] = atof(tmp);
+			geometryConvergence.maxForce = g_malloc(sizeof(gdouble));
+		}
+		else
+		{
+			geometryConvergence.numGeometry =
+				g_realloc(geometryConvergence.numGeometry, geometryConvergence.numberOfGeometries * sizeof(gint));
+			k = geometryConvergence.numberOfGeometries - 1;
+			geometryConvergence.numGeometry[k] = k + 1;
+			geometryConvergence.energy =
+				g_realloc(geometryConvergence.energy, geometryConvergence.numberOfGeometries * sizeof(gdouble));
+			geometryConvergence.energy[k] = atof(tmp);
 
-				geometryConvergence.maxForce = g_realloc(geometryConvergence.maxForce, geometryConvergence.numberOfGeometries * sizeof(gdouble));
-				geometryConvergence.maxForce[k] = -1;
-			}
-			OK = TRUE;
-			do
-			{
-				if (!fgets(t, BSIZE, file)) { OK = FALSE; break; }
-			} while (strstr(t, "Cnvgd?") == NULL && !feof(file));
-			if (!OK) break;
-			if (strstr(t, "Cnvgd?") != NULL)
-			{
-				if (!fgets(t, BSIZE, file)) { OK = FALSE; break; }
-				nSF++;
-				k = geometryConvergence.numberOfGeometries - 1;
-				sscanf(t, "%s %s", temp, tmp);
-				geometryConvergence.maxForce[k] = atof(tmp);
-			}
+			geometryConvergence.maxForce = g_realloc(geometryConvergence.maxForce, geometryConvergence.numberOfGeometries * sizeof(gdouble));
+			geometryConvergence.maxForce[k] = -1;
 		}
+		OK = find_pattern_in_log_index(index, 2, &pos);
+		if (OK) get_line_from_log_index(index, &pos, t, BSIZE);
+		if (OK) OK = get_line_from_log_index(index, &pos, t, BSIZE);
+		if (!OK) break;
+		nSF++;
+		k = geometryConvergence.numberOfGeometries - 1;
+		sscanf(t, "%s %s", temp, tmp);
+		geometryConvergence.maxForce[k] = atof(tmp);
 	}
 	if (!OK)
 	{
@@ -4049,7 +3630,6 @@ static gboolean read_qchem_output(gchar* fileName)
 
 	}
 
-	fclose(file);
 	g_free(t);
 	g_free(temp);
 	g_free(tmp);
@@ -4058,13 +3638,14 @@ static gboolean read_qchem_output(gchar* fileName)
 		gint i;
 		geometryConvergence.geometries = g_malloc(geometryConvergence.numberOfGeometries * sizeof(Geometry));
 		for (i = 0;i < geometryConvergence.numberOfGeometries;i++)
-			if (!read_qchem_file_geomi(fileName, geometryConvergence.numGeometry[i], &geometryConvergence.geometries[i])) break;
+			if (!read_qchem_geometry_from_log_index(index, 3, geometryConvergence.numGeometry[i], &geometryConvergence.geometries[i])) break;
 		if (i != geometryConvergence.numberOfGeometries)
 		{
 			freeGeometryConvergence();
 			OK = FALSE;
 		}
 	}
+	free_log_index(index);
 	rafreshList();
 	return OK;
 }
@@ -4968,6 +4549,8 @@ static void filmSelected(GtkWidget* widget)
 /********************************************************************************/
 static void showMessageEnd()
 {
+	/* the last images are written by the export threads */
+	gchar* exportError = wait_images_export();
 	gchar* format = get_format_image_from_option();
 	gchar* message = messageAnimatedImage(format);
 	gchar* t = g_strdup_printf(
@@ -4975,8 +4558,13 @@ static void showMessageEnd()
 		, format, get_last_directory(), message);
 	GtkWidget* winDlg = Message(t, _("Info"), TRUE);
 	g_free(message);
-	gtk_window_set_modal(GTK_WINDOW(winDlg), TRUE);
+	if(winDlg) gtk_window_set_modal(GTK_WINDOW(winDlg), TRUE);
 	g_free(t);
+	if (exportError)
+	{
+		Message(exportError, _("Error"), TRUE);
+		g_free(exportError);
+	}
 }
 /********************************************************************************/
 static void unActivateFilm()
@@ -5220,7 +4808,7 @@ static gboolean createImagesFile()
 		createFilm = FALSE;
 		numFileFilm = 0;
 		m = Message(message, _("Error"), TRUE);
-		gtk_window_set_modal(GTK_WINDOW(m), TRUE);
+		if(m) gtk_window_set_modal(GTK_WINDOW(m), TRUE);
 	}
 	g_free(t);
 	return TRUE;
@@ -5430,7 +5018,7 @@ static void help_supported_format()
 		)
 	);
 	win = Message(temp, " Info ", FALSE);
-	gtk_window_set_modal(GTK_WINDOW(win), TRUE);
+	if(win) gtk_window_set_modal(GTK_WINDOW(win), TRUE);
 }
 /********************************************************************************/
 static void set_entry_inputGaussDir(GtkWidget* dirSelector, gint response_id)
@@ -5657,7 +5245,7 @@ static void help_animated_file()
 		)
 	);
 	win = Message(temp, _("Info"), FALSE);
-	gtk_window_set_modal(GTK_WINDOW(win), TRUE);
+	if(win) gtk_window_set_modal(GTK_WINDOW(win), TRUE);
 	g_free(temp);
 }
 /*********************************************************************************************************************/
@@ -39,6 +39,7 @@ DEALINGS IN THE SOFTWARE.
 #include "../Display/Images.h"
 #include "../Display/UtilsOrb.h"
 #include "../Display/BondsOrb.h"
+#include "../Display/GridStore.h"
 
 /* extern AnimationGrids.h */
 AnimationGrids animationGrids;
@@ -61,6 +62,26 @@ static gchar formatFilm[100] = "BMP";
 
 static gint rowSelected = -1;
 
+/* The grids are streamed from the files : a prefetch thread decodes the next frames
+ * in a small cache, the frame displayed is given to the global grid (no copy).
+ */
+#define NFRAMESCACHE 4
+typedef struct _GridFrame
+{
+	gint index;
+	Grid* grid;
+	GeomGrid geometry;
+}GridFrame;
+
+static GridFrame framesCache[NFRAMESCACHE];
+static GMutex framesMutex;
+static GCond framesCond;
+static GThread* prefetchThread = NULL;
+static gboolean prefetchRunning = FALSE;
+static gint prefetchBusy = -1; /* frame decoded by the thread */
+static gint prefetchFirst = -1; /* the thread decodes prefetchFirst, prefetchFirst+prefetchStep,... */
+static gint prefetchStep = 1;
+
 
 /********************************************************************************/
 static void animate();
@@ -106,14 +127,64 @@ static void set_directory(GtkWidget* win, gpointer data)
 /********************************************************************************/
 void initAnimationGrids()
 {
+	gint i;
 	animationGrids.typeOfFile = GABEDIT_TYPEFILE_UNKNOWN;
 	animationGrids.numberOfFiles = 0;
 	animationGrids.geometries = NULL;
 	animationGrids.fileNames = NULL;
-	animationGrids.grids = NULL;
 	rowSelected = -1;
 	animationGrids.velocity = 0.0;
 	animationGrids.isovalue = 0.1;
+	for (i = 0;i < NFRAMESCACHE;i++)
+	{
+		framesCache[i].index = -1;
+		framesCache[i].grid = NULL;
+		framesCache[i].geometry.numberOfAtoms = 0;
+		framesCache[i].geometry.listOfAtoms = NULL;
+	}
+}
+/********************************************************************************/
+/* frame not yet displayed : no cache of the GUI refers to its grid.
+ * Safe in the prefetch thread, unlike free_grid which reads the global grid and the isosurface caches. */
+static void free_decoded_grid_frame(GridFrame* frame)
+{
+	if (frame->grid)
+	{
+		gint i, j;
+		for (i = 0;i < frame->grid->N[0];i++)
+		{
+			for (j = 0;j < frame->grid->N[1];j++) g_free(frame->grid->point[i][j]);
+			g_free(frame->grid->point[i]);
+		}
+		g_free(frame->grid->point);
+		g_free(frame->grid);
+	}
+	if (frame->geometry.listOfAtoms) g_free(frame->geometry.listOfAtoms);
+	frame->index = -1;
+	frame->grid = NULL;
+	frame->geometry.numberOfAtoms = 0;
+	frame->geometry.listOfAtoms = NULL;
+}
+/********************************************************************************/
+/* GUI thread only */
+static void free_grid_frame(GridFrame* frame)
+{
+	if (frame->grid) free_grid(frame->grid);
+	frame->grid = NULL;
+	free_decoded_grid_frame(frame);
+}
+/********************************************************************************/
+static void stop_prefetch_grid_frames()
+{
+	gint i;
+	g_mutex_lock(&framesMutex);
+	prefetchFirst = -1;
+	g_mutex_unlock(&framesMutex);
+	if (prefetchThread) g_thread_join(prefetchThread);
+	prefetchThread = NULL;
+	prefetchRunning = FALSE;
+	prefetchBusy = -1;
+	for (i = 0;i < NFRAMESCACHE;i++) free_grid_frame(&framesCache[i]);
 }
 /********************************************************************************/
 void freeAnimationGrids()
@@ -126,6 +197,7 @@ void freeAnimationGrids()
 		initAnimationGrids();
 		return;
 	}
+	stop_prefetch_grid_frames();
 	if (animationGrids.geometries)
 	{
 		gint i;
@@ -136,13 +208,6 @@ void freeAnimationGrids()
 		}
 		g_free(geometries);
 	}
-	if (animationGrids.grids)
-	{
-		gint i;
-		for (i = 0;i < animationGrids.numberOfFiles;i++)
-			if (animationGrids.grids[i]) free_grid(animationGrids.grids[i]);
-		g_free(animationGrids.grids);
-	}
 	if (animationGrids.fileNames)
 	{
 		gint i;
@@ -169,21 +234,19 @@ static void delete_one_grid()
 		return;
 	}
 
+	/* the indices of the cached frames change */
+	stop_prefetch_grid_frames();
 	if (animationGrids.geometries)
 		if (animationGrids.geometries[k].listOfAtoms) g_free(animationGrids.geometries[k].listOfAtoms);
-	if (animationGrids.grids) if (animationGrids.grids[k]) free_grid(animationGrids.grids[k]);
 	if (animationGrids.fileNames) if (animationGrids.fileNames[k]) g_free(animationGrids.fileNames[k]);
 	for (j = k;j < animationGrids.numberOfFiles - 1;j++)
 	{
 		if (animationGrids.fileNames) animationGrids.fileNames[j] = animationGrids.fileNames[j + 1];
 		if (animationGrids.geometries) animationGrids.geometries[j] = animationGrids.geometries[j + 1];
-		if (animationGrids.grids) animationGrids.grids[j] = animationGrids.grids[j + 1];
 	}
 	animationGrids.numberOfFiles--;
 	if (animationGrids.geometries)
 		animationGrids.geometries = g_realloc(animationGrids.geometries, animationGrids.numberOfFiles * sizeof(GeomGrid));
-	if (animationGrids.grids)
-		animationGrids.grids = g_realloc(animationGrids.grids, animationGrids.numberOfFiles * sizeof(GeomGrid));
 	if (animationGrids.fileNames)
 		animationGrids.fileNames = g_realloc(animationGrids.fileNames, animationGrids.numberOfFiles * sizeof(gchar*));
 	rafreshList();
@@ -191,170 +254,267 @@ static void delete_one_grid()
 	return;
 }
 /********************************************************************************/
-static gboolean set_geometry(gint k)
+static gboolean read_grid_limits_from_cube(FILE* file, gint N[], gdouble X[], gdouble Y[], gdouble Z[])
 {
-	AtomGrid* listOfAtoms = NULL;
+	gchar t[BSIZE];
+	gint i;
+	for (i = 0;i < 3;i++)
+	{
+		if (!fgets(t, BSIZE, file)) return FALSE;
+		if (sscanf(t, "%d %lf %lf %lf", &N[i], &X[i], &Y[i], &Z[i]) != 4) return FALSE;
+	}
+	return TRUE;
+}
+/********************************************************************************/
+/* same format as read_gauss_molpro_cube_orbitals_file, without any global variable */
+static gboolean decode_gabedit_cube_frame(const gchar* fileName, GridFrame* frame)
+{
+	FILE* file = FOpen(fileName, "rb");
+	gchar t[BSIZE];
 	gint nAtoms = 0;
+	gdouble XYZ0[3];
+	gint N[3];
+	gdouble X[3];
+	gdouble Y[3];
+	gdouble Z[3];
 	gint j;
+	GridStore* store = NULL;
 
-	if (k < 0 || k >= animationGrids.numberOfFiles) return FALSE;
-	if (!GeomOrb) return FALSE;
-	if (nCenters < 1) return FALSE;
-
-	nAtoms = nCenters;
-	listOfAtoms = g_malloc(nAtoms * sizeof(AtomGrid));
+	if (!file) return FALSE;
+	if (!fgets(t, BSIZE, file) || !fgets(t, BSIZE, file) || !fgets(t, BSIZE, file)
+	|| sscanf(t, "%d %lf %lf %lf", &nAtoms, &XYZ0[0], &XYZ0[1], &XYZ0[2]) != 4
+	|| !read_grid_limits_from_cube(file, N, X, Y, Z))
+	{
+		fclose(file);
+		return FALSE;
+	}
+	nAtoms = abs(nAtoms);
+	if (nAtoms > 0) frame->geometry.listOfAtoms = g_malloc(nAtoms * sizeof(AtomGrid));
 	for (j = 0;j < nAtoms;j++)
 	{
-		sprintf(listOfAtoms[j].symbol, "%s", GeomOrb[j].Symb);
-		listOfAtoms[j].C[0] = GeomOrb[j].C[0];
-		listOfAtoms[j].C[1] = GeomOrb[j].C[1];
-		listOfAtoms[j].C[2] = GeomOrb[j].C[2];
-		sprintf(listOfAtoms[j].mmType, "%s", listOfAtoms[j].symbol);
-		sprintf(listOfAtoms[j].pdbType, "%s", listOfAtoms[j].symbol);
-		listOfAtoms[j].partialCharge = GeomOrb[j].partialCharge;
-		listOfAtoms[j].variable = GeomOrb[j].variable;
-		listOfAtoms[j].nuclearCharge = GeomOrb[j].nuclearCharge;
+		AtomGrid* atom = &frame->geometry.listOfAtoms[j];
+		gint z;
+		gdouble dum;
+		gchar* symbol;
+		if (!fgets(t, BSIZE, file) || sscanf(t, "%d %lf %lf %lf %lf", &z, &dum, &atom->C[0], &atom->C[1], &atom->C[2]) != 5)
+		{
+			fclose(file);
+			return FALSE;
+		}
+		symbol = symb_atom_get(z);
+		snprintf(atom->symbol, sizeof(atom->symbol), "%s", symbol);
+		snprintf(atom->mmType, sizeof(atom->mmType), "%s", symbol);
+		snprintf(atom->pdbType, sizeof(atom->pdbType), "%s", symbol);
+		g_free(symbol);
+		atom->partialCharge = 0.0;
+		atom->variable = TRUE;
+		atom->nuclearCharge = z;
+		frame->geometry.numberOfAtoms = j + 1;
 	}
-	return TRUE;
+	store = read_grid_store_from_text_file(fileName, ftell(file), N, 1, GRIDSTORE_FIELDS_BY_ROW, FALSE, XYZ0, X, Y, Z, FALSE);
+	fclose(file);
+	if (!store) return FALSE;
+	frame->grid = get_grid_from_grid_store(store, 0);
+	free_grid_store(store);
+	return frame->grid != NULL;
+}
+/********************************************************************************/
+/* same format as read_dx_grid_file, without any global variable */
+static gboolean decode_dx_frame(const gchar* fileName, GridFrame* frame)
+{
+	FILE* file = FOpen(fileName, "rb");
+	gchar t[BSIZE];
+	gchar dum[BSIZE];
+	gdouble XYZ0[3];
+	gint N[3];
+	gdouble X[3];
+	gdouble Y[3];
+	gdouble Z[3];
+	gchar* p = NULL;
+	GridStore* store = NULL;
+
+	if (!file) return FALSE;
+	while (fgets(t, BSIZE, file)) if ((p = strstr(t, "gridpositions counts"))) break;
+	if (!p || sscanf(p + strlen("gridpositions counts"), "%d %d %d", &N[0], &N[1], &N[2]) != 3
+	|| !fgets(t, BSIZE, file) || sscanf(t, "%s %lf %lf %lf", dum, &XYZ0[0], &XYZ0[1], &XYZ0[2]) != 4
+	|| !fgets(t, BSIZE, file) || sscanf(t, "%s %lf %lf %lf", dum, &X[0], &X[1], &X[2]) != 4
+	|| !fgets(t, BSIZE, file) || sscanf(t, "%s %lf %lf %lf", dum, &Y[0], &Y[1], &Y[2]) != 4
+	|| !fgets(t, BSIZE, file) || sscanf(t, "%s %lf %lf %lf", dum, &Z[0], &Z[1], &Z[2]) != 4)
+	{
+		fclose(file);
+		return FALSE;
+	}
+	p = NULL;
+	while (fgets(t, BSIZE, file)) if ((p = strstr(t, "class array"))) break;
+	if (p) store = read_grid_store_from_text_file(fileName, ftell(file), N, 1, GRIDSTORE_FIELDS_BY_ROW, FALSE, XYZ0, X, Y, Z, FALSE);
+	fclose(file);
+	if (!store) return FALSE;
+	frame->grid = get_grid_from_grid_store(store, 0);
+	free_grid_store(store);
+	return frame->grid != NULL;
+}
+/********************************************************************************/
+/* thread safe : only the file name and the type are used */
+static gboolean decode_grid_frame(gint k, GridFrame* frame)
+{
+	gboolean ok = FALSE;
+	frame->index = k;
+	frame->grid = NULL;
+	frame->geometry.numberOfAtoms = 0;
+	frame->geometry.listOfAtoms = NULL;
+	if (animationGrids.typeOfFile == GABEDIT_TYPEFILE_CUBEDX) ok = decode_dx_frame(animationGrids.fileNames[k], frame);
+	else ok = decode_gabedit_cube_frame(animationGrids.fileNames[k], frame);
+	if (!ok) free_decoded_grid_frame(frame);
+	frame->index = k;
+	return ok;
+}
+/********************************************************************************/
+static gboolean is_prefetched_frame(gint k)
+{
+	gint i;
+	if (prefetchFirst < 0) return FALSE;
+	for (i = 0;i < NFRAMESCACHE - 1;i++)
+		if (prefetchFirst + i * prefetchStep == k) return TRUE;
+	return FALSE;
+}
+/********************************************************************************/
+static gint get_frame_from_cache(gint k)
+{
+	gint i;
+	for (i = 0;i < NFRAMESCACHE;i++) if (framesCache[i].index == k) return i;
+	return -1;
+}
+/********************************************************************************/
+/* returns the next frame to decode, -1 if all the prefetched frames are in the cache, mutex locked */
+static gint get_frame_to_prefetch()
+{
+	gint i;
+	if (prefetchFirst < 0) return -1;
+	for (i = 0;i < NFRAMESCACHE - 1;i++)
+	{
+		gint k = prefetchFirst + i * prefetchStep;
+		if (k < 0 || k >= animationGrids.numberOfFiles) break;
+		if (get_frame_from_cache(k) < 0) return k;
+	}
+	return -1;
+}
+/********************************************************************************/
+static gpointer prefetch_grid_frames_thread(gpointer data)
+{
+	g_mutex_lock(&framesMutex);
+	while (TRUE)
+	{
+		GridFrame frame;
+		gint i;
+		gint k = get_frame_to_prefetch();
+		if (k < 0) break;
+		prefetchBusy = k;
+		g_mutex_unlock(&framesMutex);
+
+		decode_grid_frame(k, &frame);
+
+		g_mutex_lock(&framesMutex);
+		prefetchBusy = -1;
+		/* a free slot, or a frame which is not needed anymore */
+		for (i = 0;i < NFRAMESCACHE;i++) if (framesCache[i].index < 0) break;
+		if (i == NFRAMESCACHE)
+			for (i = 0;i < NFRAMESCACHE;i++) if (!is_prefetched_frame(framesCache[i].index)) break;
+		if (i < NFRAMESCACHE && is_prefetched_frame(k))
+		{
+			free_decoded_grid_frame(&framesCache[i]);
+			framesCache[i] = frame;
+		}
+		else free_decoded_grid_frame(&frame);
+		g_cond_broadcast(&framesCond);
+	}
+	prefetchRunning = FALSE;
+	g_cond_broadcast(&framesCond);
+	g_mutex_unlock(&framesMutex);
+	return NULL;
+}
+/********************************************************************************/
+static void prefetch_grid_frames(gint k, gint step)
+{
+	g_mutex_lock(&framesMutex);
+	prefetchFirst = k + step;
+	prefetchStep = step;
+	if (prefetchRunning || get_frame_to_prefetch() < 0)
+	{
+		g_mutex_unlock(&framesMutex);
+		return;
+	}
+	g_mutex_unlock(&framesMutex);
+	if (prefetchThread) g_thread_join(prefetchThread);
+	prefetchRunning = TRUE;
+	prefetchThread = g_thread_new("PrefetchGrids", prefetch_grid_frames_thread, NULL);
+}
+/********************************************************************************/
+/* the caller owns the grid and the geometry of the frame */
+static gboolean get_grid_frame(gint k, GridFrame* frame)
+{
+	gint i;
+	g_mutex_lock(&framesMutex);
+	while (prefetchBusy == k) g_cond_wait(&framesCond, &framesMutex);
+	i = get_frame_from_cache(k);
+	if (i >= 0)
+	{
+		*frame = framesCache[i];
+		framesCache[i].index = -1;
+		framesCache[i].grid = NULL;
+		framesCache[i].geometry.numberOfAtoms = 0;
+		framesCache[i].geometry.listOfAtoms = NULL;
+		g_mutex_unlock(&framesMutex);
+		return frame->grid != NULL;
+	}
+	g_mutex_unlock(&framesMutex);
+	return decode_grid_frame(k, frame);
+}
+/********************************************************************************/
+/* the files are only listed, the grids are decoded when displayed */
+static void set_list_of_grid_files(GSList* lists, GabEditTypeFile type)
+{
+	GSList* cur = NULL;
+	gint k = 0;
+
+	stopAnimation(NULL, NULL);
+	freeAnimationGrids();
+	for (cur = lists;cur != NULL;cur = cur->next) animationGrids.numberOfFiles++;
+	if (animationGrids.numberOfFiles < 1) return;
+	animationGrids.geometries = g_malloc(animationGrids.numberOfFiles * sizeof(GeomGrid));
+	animationGrids.fileNames = g_malloc(animationGrids.numberOfFiles * sizeof(gchar*));
+	for (cur = lists;cur != NULL;cur = cur->next)
+	{
+		animationGrids.fileNames[k] = g_strdup((gchar*)(cur->data));
+		animationGrids.geometries[k].numberOfAtoms = 0;
+		animationGrids.geometries[k].listOfAtoms = NULL;
+		k++;
+	}
+	animationGrids.typeOfFile = type;
 }
 /*************************************************************************************************************/
 static void read_gabedit_files(GabeditFileChooser* SelecFile, gint response_id)
 {
-	gchar* fileName;
 	GSList* lists = NULL;
-	GSList* cur = NULL;
 
 	if (response_id != GTK_RESPONSE_OK) return;
 
 	lists = gtk_file_chooser_get_filenames(GTK_FILE_CHOOSER(SelecFile));
-
-	stopAnimation(NULL, NULL);
-
-	freeAnimationGrids();
-	cur = lists;
-	animationGrids.numberOfFiles = 0;
-	while (cur != NULL)
-	{
-		animationGrids.numberOfFiles++;
-		cur = cur->next;
-	}
-	if (animationGrids.numberOfFiles > 0)
-	{
-		gint k = 0;
-		animationGrids.geometries = g_malloc(animationGrids.numberOfFiles * sizeof(GeomGrid));
-		animationGrids.fileNames = g_malloc(animationGrids.numberOfFiles * sizeof(gchar*));
-		animationGrids.grids = g_malloc(animationGrids.numberOfFiles * sizeof(Grid*));
-		for (k = 0;k < animationGrids.numberOfFiles;k++)
-		{
-			animationGrids.fileNames[k] = NULL;
-			animationGrids.grids[k] = NULL;
-			animationGrids.geometries[k].numberOfAtoms = 0;
-			animationGrids.geometries[k].listOfAtoms = NULL;
-		}
-		k = 0;
-		cur = lists;
-		while (cur != NULL)
-		{
-			fileName = (gchar*)(cur->data);
-
-			if (read_gauss_molpro_cube_orbitals_file(fileName, 0, 0, GABEDIT_TYPEFILE_CUBEGABEDIT, FALSE))
-			{
-				set_geometry(k);
-				animationGrids.fileNames[k] = g_strdup(fileName);
-				animationGrids.grids[k] = copyGrid(grid);
-				k++;
-			}
-			cur = cur->next;
-		}
-		if (k <= 0)
-		{
-			freeAnimationGrids();
-		}
-		else
-			if (k != animationGrids.numberOfFiles)
-			{
-				animationGrids.numberOfFiles = k;
-				animationGrids.geometries = g_realloc(animationGrids.geometries, animationGrids.numberOfFiles * sizeof(GeomGrid));
-				animationGrids.fileNames = g_realloc(animationGrids.fileNames, animationGrids.numberOfFiles * sizeof(gchar*));
-				animationGrids.grids = g_realloc(animationGrids.grids, animationGrids.numberOfFiles * sizeof(Grid*));
-			}
-		if (k > 0)
-		{
-			animationGrids.typeOfFile = GABEDIT_TYPEFILE_CUBEDX;
-		}
-	}
+	set_list_of_grid_files(lists, GABEDIT_TYPEFILE_CUBEGABEDIT);
+	g_slist_free_full(lists, g_free);
 	rafreshList();
-
 }
 /*************************************************************************************************************/
 static void read_dx_files(GabeditFileChooser* SelecFile, gint response_id)
 {
-	gchar* fileName;
 	GSList* lists = NULL;
-	GSList* cur = NULL;
 
 	if (response_id != GTK_RESPONSE_OK) return;
 
 	gtk_widget_hide(GTK_WIDGET(SelecFile));
 	lists = gtk_file_chooser_get_filenames(GTK_FILE_CHOOSER(SelecFile));
-
-	stopAnimation(NULL, NULL);
-
-	freeAnimationGrids();
-	cur = lists;
-	animationGrids.numberOfFiles = 0;
-	while (cur != NULL)
-	{
-		animationGrids.numberOfFiles++;
-		cur = cur->next;
-	}
-	if (animationGrids.numberOfFiles > 0)
-	{
-		gint k = 0;
-		animationGrids.geometries = g_malloc(animationGrids.numberOfFiles * sizeof(GeomGrid));
-		animationGrids.fileNames = g_malloc(animationGrids.numberOfFiles * sizeof(gchar*));
-		animationGrids.grids = g_malloc(animationGrids.numberOfFiles * sizeof(Grid*));
-		for (k = 0;k < animationGrids.numberOfFiles;k++)
-		{
-			animationGrids.fileNames[k] = NULL;
-			animationGrids.grids[k] = NULL;
-			animationGrids.geometries[k].numberOfAtoms = 0;
-			animationGrids.geometries[k].listOfAtoms = NULL;
-		}
-		k = 0;
-		cur = lists;
-		while (cur != NULL)
-		{
-			fileName = (gchar*)(cur->data);
-
-			if (read_dx_grid_file(fileName, FALSE))
-			{
-				animationGrids.fileNames[k] = g_strdup(fileName);
-				set_geometry(k);
-				animationGrids.grids[k] = copyGrid(grid);
-				k++;
-			}
-			cur = cur->next;
-		}
-		if (k <= 0)
-		{
-			freeAnimationGrids();
-		}
-		else
-			if (k != animationGrids.numberOfFiles)
-			{
-				animationGrids.numberOfFiles = k;
-				animationGrids.geometries = g_realloc(animationGrids.geometries, animationGrids.numberOfFiles * sizeof(GeomGrid));
-				animationGrids.fileNames = g_realloc(animationGrids.fileNames, animationGrids.numberOfFiles * sizeof(gchar*));
-				animationGrids.grids = g_realloc(animationGrids.grids, animationGrids.numberOfFiles * sizeof(Grid*));
-			}
-		if (k > 0)
-		{
-			animationGrids.typeOfFile = GABEDIT_TYPEFILE_CUBEDX;
-		}
-	}
+	set_list_of_grid_files(lists, GABEDIT_TYPEFILE_CUBEDX);
+	g_slist_free_full(lists, g_free);
 	rafreshList();
-
 }
 /*************************************************************************/
 static void read_files(GabeditFileChooser* selecFile, gint response_id)
@@ -415,14 +575,24 @@ static void read_files_dlg()
 	gtk_window_set_modal(GTK_WINDOW(filesel), TRUE);
 }
 /********************************************************************************/
-static gboolean set_grid(gint k)
+static gboolean is_new_geometry(GeomGrid* geometry)
 {
-	AtomGrid* listOfAtoms = NULL;
-	gint nAtoms = 0;
 	gint j;
-
-	if (k < 0 || k >= animationGrids.numberOfFiles) return FALSE;
-	if (!animationGrids.grids[k]) return FALSE;
+	gint c;
+	if (geometry->numberOfAtoms != nCenters || !GeomOrb) return TRUE;
+	for (j = 0;j < nCenters;j++)
+	{
+		if (!GeomOrb[j].Symb || strcmp(GeomOrb[j].Symb, geometry->listOfAtoms[j].symbol)) return TRUE;
+		for (c = 0;c < 3;c++) if (fabs(GeomOrb[j].C[c] - geometry->listOfAtoms[j].C[c]) > 1e-10) return TRUE;
+	}
+	return FALSE;
+}
+/********************************************************************************/
+static void set_geometry(GeomGrid* geometry)
+{
+	AtomGrid* listOfAtoms = geometry->listOfAtoms;
+	gint nAtoms = geometry->numberOfAtoms;
+	gint j;
 
 	if (GeomOrb)
 	{
@@ -431,12 +601,6 @@ static gboolean set_grid(gint k)
 		g_free(GeomOrb);
 		GeomOrb = NULL;
 	}
-	free_grid_all();
-	/* free_iso_all();*/
-
-	nAtoms = animationGrids.geometries[k].numberOfAtoms;
-	listOfAtoms = animationGrids.geometries[k].listOfAtoms;
-
 	if (nAtoms > 0) GeomOrb = g_malloc(nAtoms * sizeof(TypeGeomOrb));
 	for (j = 0;j < nAtoms;j++)
 	{
@@ -455,12 +619,38 @@ static gboolean set_grid(gint k)
 	init_dipole();
 	buildBondsOrb();
 	RebuildGeomD = TRUE;
+}
+/********************************************************************************/
+static gboolean set_grid(gint k)
+{
+	GridFrame frame;
 
-	grid = copyGrid(animationGrids.grids[k]);
+	if (k < 0 || k >= animationGrids.numberOfFiles) return FALSE;
+	if (!get_grid_frame(k, &frame))
+	{
+		free_grid_frame(&frame);
+		return FALSE;
+	}
+
+	/* dx files have no atom : the current geometry is kept */
+	if (frame.geometry.numberOfAtoms > 0 && is_new_geometry(&frame.geometry)) set_geometry(&frame.geometry);
+	if (animationGrids.geometries && !animationGrids.geometries[k].listOfAtoms)
+	{
+		animationGrids.geometries[k] = frame.geometry;
+		frame.geometry.listOfAtoms = NULL;
+	}
+	free_grid_all();
+	/* free_iso_all();*/
+
+	/* the decoded grid is displayed, not copied */
+	grid = frame.grid;
+	frame.grid = NULL;
+	free_grid_frame(&frame);
 
 	Define_Iso(animationGrids.isovalue);
 
 	glarea_rafresh(GLArea);
+	prefetch_grid_frames(k, prefetchStep);
 
 	return TRUE;
 }
@@ -676,6 +866,8 @@ static void filmSelected(GtkWidget* widget)
 /********************************************************************************/
 static void showMessageEnd()
 {
+	/* the last images are written by the export threads */
+	gchar* exportError = wait_images_export();
 	gchar* format = get_format_image_from_option();
 	gchar* message = messageAnimatedImage(format);
 	gchar* t = g_strdup_printf(
@@ -683,8 +875,13 @@ static void showMessageEnd()
 		, format, get_last_directory(), message);
 	GtkWidget* winDlg = Message(t, _("Info"), TRUE);
 	g_free(message);
-	gtk_window_set_modal(GTK_WINDOW(winDlg), TRUE);
+	if(winDlg) gtk_window_set_modal(GTK_WINDOW(winDlg), TRUE);
 	g_free(t);
+	if (exportError)
+	{
+		Message(exportError, _("Error"), TRUE);
+		g_free(exportError);
+	}
 }
 /********************************************************************************/
 static void unActivateFilm()
@@ -940,7 +1137,7 @@ static gboolean createImagesFile()
 		createFilm = FALSE;
 		numFileFilm = 0;
 		m = Message(message, _("Error"), TRUE);
-		gtk_window_set_modal(GTK_WINDOW(m), TRUE);
+		if(m) gtk_window_set_modal(GTK_WINDOW(m), TRUE);
 	}
 	g_free(t);
 	return TRUE;
@@ -1003,6 +1200,7 @@ static void animate()
 		gtk_tree_selection_select_path(gtk_tree_view_get_selection(GTK_TREE_VIEW(treeView)), path);
 		gtk_tree_view_scroll_to_cell(GTK_TREE_VIEW(treeView), path, NULL, FALSE, 0.5, 0.5);
 		gtk_tree_path_free(path);
+		prefetchStep = step;
 		set_grid(rowSelected);
 
 		createImagesFile();
@@ -1036,7 +1234,7 @@ static void help_supported_format()
 		)
 	);
 	win = Message(temp, " Info ", FALSE);
-	gtk_window_set_modal(GTK_WINDOW(win), TRUE);
+	if(win) gtk_window_set_modal(GTK_WINDOW(win), TRUE);
 }
 /********************************************************************************/
 static void help_animated_file()
@@ -1064,7 +1262,7 @@ static void help_animated_file()
 		)
 	);
 	win = Message(temp, _("Info"), FALSE);
-	gtk_window_set_modal(GTK_WINDOW(win), TRUE);
+	if(win) gtk_window_set_modal(GTK_WINDOW(win), TRUE);
 	g_free(temp);
 }
 /*********************************************************************************************************************/
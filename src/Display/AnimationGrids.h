@@ -41,7 +41,6 @@ typedef struct _AnimationGrids
 	GabEditTypeFile typeOfFile;
 	gint numberOfFiles;
 	GeomGrid* geometries;
-	Grid** grids;
 	gchar** fileNames;
 }AnimationGrids;
 void initAnimationGrids();
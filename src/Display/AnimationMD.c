@@ -3567,13 +3567,20 @@ static void filmSelected(GtkWidget* widget)
 /********************************************************************************/
 static void showMessageEnd()
 {
+	/* the last images are written by the export threads */
+	gchar* exportError = wait_images_export();
 	gchar* format = get_format_image_from_option();
 	gchar* message = messageAnimatedImage(format);
 	gchar* t = g_strdup_printf(_("\nA seriess of gab*.%s files was created in \"%s\" directeory.\n\n\n%s"), format, get_last_directory(), message);
 	GtkWidget* winDlg = Message(t, _("Info"), TRUE);
 	g_free(message);
-	gtk_window_set_modal(GTK_WINDOW(winDlg), TRUE);
+	if(winDlg) gtk_window_set_modal(GTK_WINDOW(winDlg), TRUE);
 	g_free(t);
+	if (exportError)
+	{
+		Message(exportError, _("Error"), TRUE);
+		g_free(exportError);
+	}
 }
 /********************************************************************************/
 static void unActivateFilm()
@@ -3817,7 +3824,7 @@ static gboolean createImagesFile()
 		createFilm = FALSE;
 		numFileFilm = 0;
 		m = Message(message, _("Error"), TRUE);
-		gtk_window_set_modal(GTK_WINDOW(m), TRUE);
+		if(m) gtk_window_set_modal(GTK_WINDOW(m), TRUE);
 	}
 	g_free(t);
 	return TRUE;
@@ -4017,7 +4024,7 @@ static void help_supported_format()
 		)
 	);
 	win = Message(temp, _("Info"), FALSE);
-	gtk_window_set_modal(GTK_WINDOW(win), TRUE);
+	if(win) gtk_window_set_modal(GTK_WINDOW(win), TRUE);
 }
 /***************************************************************************/
 static void help_animated_file()
@@ -4045,7 +4052,7 @@ static void help_animated_file()
 		)
 	);
 	win = Message(temp, _("Info"), FALSE);
-	gtk_window_set_modal(GTK_WINDOW(win), TRUE);
+	if(win) gtk_window_set_modal(GTK_WINDOW(win), TRUE);
 	g_free(temp);
 }
 /*********************************************************************************************************************/
@@ -195,13 +195,20 @@ static void filmSelected(GtkWidget *widget)
 /********************************************************************************/
 static void showMessageEnd()
 {
+	/* the last images are written by the export threads */
+	gchar* exportError = wait_images_export();
 	gchar* format =get_format_image_from_option();
 	gchar* message = messageAnimatedImage(format);
 	gchar* t = g_strdup_printf(_("\nA seriess of gab*.%s files was created in \"%s\" directeory.\n\n\n%s") , format, get_last_directory(),message);
 	GtkWidget* winDlg = Message(t,_("Info"),TRUE);
 	g_free(message);
-	gtk_window_set_modal (GTK_WINDOW (winDlg), TRUE);
+	if(winDlg) gtk_window_set_modal (GTK_WINDOW (winDlg), TRUE);
 	g_free(t);
+	if (exportError)
+	{
+		Message(exportError, _("Error"), TRUE);
+		g_free(exportError);
+	}
 }
 /********************************************************************************/
 static void unActivateFilm()
@@ -438,7 +445,7 @@ static gboolean createImagesFile()
 		createFilm = FALSE;
 		numFileFilm = 0;
     		m = Message(message,_("Error"),TRUE);
-		gtk_window_set_modal (GTK_WINDOW (m), TRUE);
+		if(m) gtk_window_set_modal (GTK_WINDOW (m), TRUE);
 	}
 	g_free(t);
 	return TRUE;
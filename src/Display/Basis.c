@@ -25,6 +25,7 @@ DEALINGS IN THE SOFTWARE.
 #include "../Utils/Constants.h"
 #include "../Utils/Zlm.h"
 #include "../Utils/GTF.h"
+#include "../Utils/FChkFile.h"
 
 /********************************************************************************/
 void save_basis_gabedit_format(FILE* file)
@@ -1097,7 +1098,8 @@ static void getlTable(gint L, gint* nCoefs, gdouble** coefs, gint** l[3])
 /********************************************************************************/
 gboolean readBasisFromGaussianFChk(gchar *fileName)
 {
- 	FILE *file;
+ 	FChkFile *file;
+	gchar* blockNames[] = {"Shell types ", "Number of primitives per shell ", "Shell to atom map ", "Primitive exponents ", "Contraction coefficients ", "P(S=P) Contraction coefficients ", "Coordinates of each shell "};
 	gint n;
 	gint nS;
 	gint c;
@@ -1122,58 +1124,56 @@ gboolean readBasisFromGaussianFChk(gchar *fileName)
 	gboolean sp = FALSE;
 	gint llMax = 0;
 
-	file = FOpen(fileName, "rb");
+	file = new_fchk_gaussian_file(fileName);
 	if(file ==NULL)
 	{
   		Message(_("Sorry\nI can not open this file"),_("Error"),TRUE);
   		return FALSE;
 	}
 
-	nBasis = get_one_int_from_fchk_gaussian_file(file,"Number of basis functions  ");
+	nBasis = get_one_int_from_fchk(file,"Number of basis functions  ");
 	if(nBasis<1)
 	{
   		Message(_("Sorry\nI can not read the number of basis functions"),_("Error"),TRUE);
-		fclose(file);
+		free_fchk_gaussian_file(file);
   		return FALSE;
 	}
 
-	nShells = get_one_int_from_fchk_gaussian_file(file,"Number of contracted shells ");
+	nShells = get_one_int_from_fchk(file,"Number of contracted shells ");
 	if(nShells<1)
 	{
   		Message(_("Sorry\nI can not the number of contracted shells"),_("Error"),TRUE);
-		fclose(file);
+		free_fchk_gaussian_file(file);
   		return FALSE;
 	}
-	nPrimitives = get_one_int_from_fchk_gaussian_file(file,"Number of primitive shells ");
+	nPrimitives = get_one_int_from_fchk(file,"Number of primitive shells ");
 	if(nPrimitives<1)
 	{
   		Message(_("Sorry\nI can not the number of primitive shells"),_("Error"),TRUE);
-		fclose(file);
+		free_fchk_gaussian_file(file);
   		return FALSE;
 	}
-	rewind(file);
-	lMax = get_one_int_from_fchk_gaussian_file(file,"Highest angular momentum ");
+	lMax = get_one_int_from_fchk(file,"Highest angular momentum ");
 	if(lMax<0)
 	{
   		Message(_("Sorry\nI can not the value of the highest angular momentum"),_("Error"),TRUE);
-		fclose(file);
+		free_fchk_gaussian_file(file);
   		return FALSE;
 	}
-	rewind(file);
-	contMax = get_one_int_from_fchk_gaussian_file(file,"Largest degree of contraction ");
+	contMax = get_one_int_from_fchk(file,"Largest degree of contraction ");
 	if(contMax<1)
 	{
   		Message(_("Sorry\nI can not the value of the largest degree of contraction"),_("Error"),TRUE);
-		fclose(file);
+		free_fchk_gaussian_file(file);
   		return FALSE;
 	}
-	rewind(file);
-	shellTypes = get_array_int_from_fchk_gaussian_file(file, "Shell types ", &n);
+	load_arrays_from_fchk(file, 7, blockNames);
+	shellTypes = get_array_int_from_fchk(file, "Shell types ", &n);
 	if(!shellTypes || n!=nShells)
 	{
   		Message(_("Sorry\nI can not read the shell types"),_("Error"),TRUE);
 		if(shellTypes) g_free(shellTypes);
-		fclose(file);
+		free_fchk_gaussian_file(file);
   		return FALSE;
 	}
 	for(nS = 0;nS<nShells;nS++) if( shellTypes[nS]==-1) { sp = TRUE; break;}
@@ -1189,61 +1189,61 @@ gboolean readBasisFromGaussianFChk(gchar *fileName)
 	{
   		Message(_("Sorry\nThe number of basis function in fch file is not equal to that computed by Gabedit!"),_("Error"),TRUE);
 		if(shellTypes) g_free(shellTypes);
-		fclose(file);
+		free_fchk_gaussian_file(file);
 		return FALSE;
 	}
-	nPrimitivesByShell = get_array_int_from_fchk_gaussian_file(file, "Number of primitives per shell ", &n);
+	nPrimitivesByShell = get_array_int_from_fchk(file, "Number of primitives per shell ", &n);
 	if(!nPrimitivesByShell || n!=nShells)
 	{
   		Message(_("Sorry\nI can not read the number of primitives per shell"),_("Error"),TRUE);
 		if(nPrimitivesByShell) g_free(nPrimitivesByShell);
-		fclose(file);
+		free_fchk_gaussian_file(file);
   		return FALSE;
 	}
-	numAtoms = get_array_int_from_fchk_gaussian_file(file, "Shell to atom map ", &n);
+	numAtoms = get_array_int_from_fchk(file, "Shell to atom map ", &n);
 	if(!numAtoms || n!=nShells)
 	{
   		Message(_("Sorry\nI can not read the atoms number for shell"),_("Error"),TRUE);
 		if(numAtoms) g_free(numAtoms);
-		fclose(file);
+		free_fchk_gaussian_file(file);
   		return FALSE;
 	}
-	primitiveExponents = get_array_real_from_fchk_gaussian_file(file, "Primitive exponents ", &n);
+	primitiveExponents = get_array_real_from_fchk(file, "Primitive exponents ", &n);
 	if(!primitiveExponents || n != nPrimitives)
 	{
   		Message(_("Sorry\nI can not read the primitive exponents "),_("Error"),TRUE);
 		if(primitiveExponents) g_free(primitiveExponents);
-		fclose(file);
+		free_fchk_gaussian_file(file);
   		return FALSE;
 	}
-	contractionsCoefs = get_array_real_from_fchk_gaussian_file(file, "Contraction coefficients ", &n);
+	contractionsCoefs = get_array_real_from_fchk(file, "Contraction coefficients ", &n);
 	if(!contractionsCoefs || n != nPrimitives)
 	{
   		Message(_("Sorry\nI can not read the contraction coefficients "),_("Error"),TRUE);
 		if(contractionsCoefs) g_free(contractionsCoefs);
-		fclose(file);
+		free_fchk_gaussian_file(file);
   		return FALSE;
 	}
 	if(sp)
 	{
-		contractionsCoefsSP = get_array_real_from_fchk_gaussian_file(file, "P(S=P) Contraction coefficients ", &n);
+		contractionsCoefsSP = get_array_real_from_fchk(file, "P(S=P) Contraction coefficients ", &n);
 		if(!contractionsCoefsSP || n != nPrimitives)
 		{
   			Message(_("Sorry\nI can not read the P(S=P) contraction coefficients "),_("Error"),TRUE);
 			if(contractionsCoefsSP) g_free(contractionsCoefsSP);
-			fclose(file);
+			free_fchk_gaussian_file(file);
   			return FALSE;
 		}
 	}
-	coordinatesForShells = get_array_real_from_fchk_gaussian_file(file, "Coordinates of each shell ", &n);
+	coordinatesForShells = get_array_real_from_fchk(file, "Coordinates of each shell ", &n);
 	if(!contractionsCoefs || n != nShells*3)
 	{
   		Message(_("Sorry\nI can not read the coordinates of each shell "),_("Error"),TRUE);
 		if(coordinatesForShells) g_free(coordinatesForShells);
-		fclose(file);
+		free_fchk_gaussian_file(file);
   		return FALSE;
 	}
-	fclose(file);
+	free_fchk_gaussian_file(file);
 	/* printf("close file\n");*/
 
 	llMax = (lMax+1)*(lMax+2)/2;
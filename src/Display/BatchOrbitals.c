@@ -0,0 +1,393 @@
+/* BatchOrbitals.c */
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#include "../../Config.h"
+#ifdef ENABLE_EGL
+#include <epoxy/gl.h>
+#include <epoxy/egl.h>
+#endif
+#include "GlobalOrb.h"
+#include <stdlib.h>
+#include <locale.h>
+#ifndef G_OS_WIN32
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+#include "../Utils/Utils.h"
+#include "../Utils/UtilsInterface.h"
+#include "UtilsOrb.h"
+#include "Grid.h"
+#include "GLArea.h"
+#include "Orbitals.h"
+#include "LabelsGL.h"
+#include "Images.h"
+#include "BatchOrbitals.h"
+
+/* Headless rendering of orbital images, without any window.
+ * The scene is drawn in a framebuffer object of an off-screen (surfaceless) EGL context.
+ * The drawing state is global, so --jobs=n runs n worker processes (gabedit ... --worker=k/n),
+ * worker k renders the orbitals k, k+n, k+2n... of the list.
+ */
+
+typedef struct _BatchOrbitalsOptions
+{
+	gchar* fileName;
+	gchar* orbitals;
+	gchar* outputDir;
+	gdouble isovalue;
+	gint width;
+	gint height;
+	gint points;
+	gint nJobs;
+	gint worker;
+	gboolean beta;
+}BatchOrbitalsOptions;
+
+/********************************************************************************/
+gboolean is_batch_orbitals_command(gint argc, gchar** argv)
+{
+	gint i;
+	for(i=1;i<argc;i++)
+		if(!strcmp(argv[i],"--batch-orbitals")) return TRUE;
+	return FALSE;
+}
+/********************************************************************************/
+static void print_batch_orbitals_usage()
+{
+	g_printerr("Usage : gabedit --batch-orbitals fileName [options]\n");
+	g_printerr("   --orbitals=list   orbitals to render, ex : homo-2:lumo+2,10,12 (numbers start at 1, default homo,lumo)\n");
+	g_printerr("   --beta            beta orbitals (default alpha)\n");
+	g_printerr("   --isovalue=v      isovalue (default 0.05)\n");
+	g_printerr("   --size=WxH        image size (default 800x600)\n");
+	g_printerr("   --points=n        number of grid points by direction (default 60)\n");
+	g_printerr("   --jobs=n          number of worker processes (default : number of processors)\n");
+	g_printerr("   --output=dir      directory of the png files (default : current directory)\n");
+}
+/********************************************************************************/
+static gboolean get_batch_orbitals_options(gint argc, gchar** argv, BatchOrbitalsOptions* opt)
+{
+	gint i;
+	opt->fileName = NULL;
+	opt->orbitals = NULL;
+	opt->outputDir = NULL;
+	opt->isovalue = 0.05;
+	opt->width = 800;
+	opt->height = 600;
+	opt->points = 60;
+	opt->nJobs = (gint)g_get_num_processors();
+	opt->worker = -1;
+	opt->beta = FALSE;
+	for(i=1;i<argc;i++)
+	{
+		if(!strcmp(argv[i],"--batch-orbitals")) continue;
+		else if(g_str_has_prefix(argv[i],"--orbitals=")) opt->orbitals = argv[i]+strlen("--orbitals=");
+		else if(g_str_has_prefix(argv[i],"--output=")) opt->outputDir = argv[i]+strlen("--output=");
+		else if(g_str_has_prefix(argv[i],"--isovalue=")) opt->isovalue = atof(argv[i]+strlen("--isovalue="));
+		else if(g_str_has_prefix(argv[i],"--points=")) opt->points = atoi(argv[i]+strlen("--points="));
+		else if(g_str_has_prefix(argv[i],"--jobs=")) opt->nJobs = atoi(argv[i]+strlen("--jobs="));
+		else if(g_str_has_prefix(argv[i],"--size=")) 
+		{
+			if(sscanf(argv[i]+strlen("--size="),"%dx%d",&opt->width,&opt->height)!=2) return FALSE;
+		}
+		else if(g_str_has_prefix(argv[i],"--worker=")) 
+		{
+			gint n = 0;
+			if(sscanf(argv[i]+strlen("--worker="),"%d/%d",&opt->worker,&n)!=2) return FALSE;
+			opt->nJobs = n;
+		}
+		else if(!strcmp(argv[i],"--beta")) opt->beta = TRUE;
+		else if(argv[i][0]!='-' && !opt->fileName) opt->fileName = argv[i];
+		else return FALSE;
+	}
+	if(!opt->fileName) return FALSE;
+	if(opt->width<16 || opt->height<16 || opt->points<2) return FALSE;
+	if(opt->nJobs<1) opt->nJobs = 1;
+	return TRUE;
+}
+/********************************************************************************/
+/* homo, homo-k, lumo, lumo+k or a number starting at 1. returns a 0-based number */
+static gint get_orbital_number(const gchar* str, gint nOcc, gboolean* ok)
+{
+	gchar* t = g_ascii_strdown(str,-1);
+	gint n = -1;
+	g_strstrip(t);
+	*ok = TRUE;
+	if(g_str_has_prefix(t,"homo")) n = nOcc-1 + atoi(t+4);
+	else if(g_str_has_prefix(t,"lumo")) n = nOcc + atoi(t+4);
+	else if(t[0]>='0' && t[0]<='9') n = atoi(t)-1;
+	else *ok = FALSE;
+	g_free(t);
+	return n;
+}
+/********************************************************************************/
+static gint* get_list_of_orbitals(const gchar* list, gint nOcc, gint nOrbs, gint* n)
+{
+	gchar** tokens = g_strsplit(list?list:"homo,lumo",",",-1);
+	gint* nums = NULL;
+	gint i;
+	*n = 0;
+	for(i=0;tokens[i];i++)
+	{
+		gchar** range = g_strsplit(tokens[i],":",2);
+		gboolean ok1 = TRUE;
+		gboolean ok2 = TRUE;
+		gint k;
+		gint n1 = get_orbital_number(range[0], nOcc, &ok1);
+		gint n2 = range[1] ? get_orbital_number(range[1], nOcc, &ok2) : n1;
+		g_strfreev(range);
+		if(!ok1 || !ok2)
+		{
+			g_printerr("Error : I cannot read the orbital \"%s\"\n",tokens[i]);
+			continue;
+		}
+		for(k=MIN(n1,n2);k<=MAX(n1,n2);k++)
+		{
+			if(k<0 || k>=nOrbs) continue;
+			nums = g_realloc(nums, (*n+1)*sizeof(gint));
+			nums[(*n)++] = k;
+		}
+	}
+	g_strfreev(tokens);
+	return nums;
+}
+/********************************************************************************/
+#ifdef ENABLE_EGL
+static EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+static EGLContext eglContext = EGL_NO_CONTEXT;
+static GLuint fboBatch = 0;
+static GLuint rbBatch[2] = {0,0};
+/********************************************************************************/
+static void destroy_offscreen_context()
+{
+	if(fboBatch) glDeleteFramebuffers(1,&fboBatch);
+	if(rbBatch[0]) glDeleteRenderbuffers(2,rbBatch);
+	fboBatch = 0;
+	rbBatch[0] = rbBatch[1] = 0;
+	if(eglDisplay == EGL_NO_DISPLAY) return;
+	eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	if(eglContext != EGL_NO_CONTEXT) eglDestroyContext(eglDisplay, eglContext);
+	eglTerminate(eglDisplay);
+	eglContext = EGL_NO_CONTEXT;
+	eglDisplay = EGL_NO_DISPLAY;
+}
+/********************************************************************************/
+static gboolean create_offscreen_context(gint width, gint height)
+{
+	static const EGLint configAttribs[] = {
+		EGL_SURFACE_TYPE, 0,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+		EGL_DEPTH_SIZE, 24,
+		EGL_NONE };
+	EGLConfig config;
+	EGLint nConfigs = 0;
+	EGLint major, minor;
+
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+	if(epoxy_has_egl_extension(EGL_NO_DISPLAY,"EGL_MESA_platform_surfaceless"))
+		eglDisplay = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+#endif
+	if(eglDisplay == EGL_NO_DISPLAY) eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	if(eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) 
+	{
+		g_printerr("Error : I cannot open an EGL display\n");
+		eglDisplay = EGL_NO_DISPLAY;
+		return FALSE;
+	}
+	if(!eglBindAPI(EGL_OPENGL_API) || !eglChooseConfig(eglDisplay, configAttribs, &config, 1, &nConfigs) || nConfigs<1)
+	{
+		g_printerr("Error : no EGL configuration for OpenGL\n");
+		destroy_offscreen_context();
+		return FALSE;
+	}
+	/* compatibility profile : the scene is drawn with display lists */
+	eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, NULL);
+	if(eglContext == EGL_NO_CONTEXT || !eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext))
+	{
+		g_printerr("Error : I cannot create an off-screen OpenGL context\n");
+		destroy_offscreen_context();
+		return FALSE;
+	}
+	glGenRenderbuffers(2, rbBatch);
+	glBindRenderbuffer(GL_RENDERBUFFER, rbBatch[0]);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, rbBatch[1]);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+	glGenFramebuffers(1, &fboBatch);
+	glBindFramebuffer(GL_FRAMEBUFFER, fboBatch);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rbBatch[0]);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rbBatch[1]);
+	if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		g_printerr("Error : incomplete framebuffer object\n");
+		destroy_offscreen_context();
+		return FALSE;
+	}
+	glDrawBuffer(GL_COLOR_ATTACHMENT0);
+	return TRUE;
+}
+/********************************************************************************/
+static gchar* get_batch_orbital_title(gint typeOrb, gint ii)
+{
+	gint nOcc = (typeOrb==1)?NAlphaOcc:NBetaOcc;
+	gdouble* ener = (typeOrb==1)?EnerAlphaOrbitals:EnerBetaOrbitals;
+	gint nh = ii+1-nOcc;
+	gchar* hLabel = NULL;
+	gchar* title = NULL;
+	if(nh==0) hLabel = g_strdup_printf("Homo");
+	else if(nh<0) hLabel = g_strdup_printf("Homo%d",nh);
+	else if(nh==1) hLabel = g_strdup_printf("Lumo");
+	else hLabel = g_strdup_printf("Lumo+%d",nh-1);
+	title = g_strdup_printf(" %s n=%d E=%0.6e ",hLabel,ii+1,ener?ener[ii]:0.0);
+	g_free(hLabel);
+	return title;
+}
+/********************************************************************************/
+static gint run_batch_orbitals_worker(gint argc, gchar** argv, BatchOrbitalsOptions* opt)
+{
+	gint* nums = NULL;
+	gint nNums = 0;
+	gint i;
+	gint nErrors = 0;
+	gint typeOrb = opt->beta?2:1;
+	gchar* dirName = g_strdup(opt->outputDir?opt->outputDir:".");
+
+	/* gtk is used for the pixbufs only, no window is created */
+	gtk_init_check(&argc, &argv);
+	setlocale(LC_NUMERIC,"C");
+	initialise_global_variables();
+	read_ressource_file();
+	initialise_global_orbitals_variables();
+
+	/* display lists are freed when a file is read : the context must exist before */
+	if(!create_offscreen_context(opt->width, opt->height)) return 1;
+	draw_scene_gl(opt->width, opt->height, TRUE);
+
+	if(!read_orbitals(opt->fileName) || NAOrb<1 || NOrb<1)
+	{
+		g_printerr("Error : I cannot read orbitals from %s\n",opt->fileName);
+		destroy_offscreen_context();
+		return 1;
+	}
+	nums = get_list_of_orbitals(opt->orbitals, (typeOrb==1)?NAlphaOcc:NBetaOcc, NOrb, &nNums);
+	g_mkdir_with_parents(dirName, 0755);
+
+	NumPoints[0] = NumPoints[1] = NumPoints[2] = opt->points;
+	TypeSelOrb = typeOrb;
+	TypeGrid = GABEDIT_TYPEGRID_ORBITAL;
+	for(i=0;i<nNums;i++)
+	{
+		gchar* fileName = NULL;
+		gchar* title = NULL;
+		if(opt->worker>=0 && i%opt->nJobs != opt->worker) continue;
+		fileName = g_strdup_printf("%s%s%s_%d.png",dirName,G_DIR_SEPARATOR_S, (typeOrb==1)?"gabOrbAlpha":"gabOrbBeta", nums[i]);
+		title = get_batch_orbital_title(typeOrb, nums[i]);
+		free_surfaces_all();
+		NumSelOrb = nums[i];
+		Define_Grid();
+		if(!grid) 
+		{
+			g_printerr("Error : I cannot compute the grid of the orbital %d\n",nums[i]+1);
+			nErrors++;
+		}
+		else
+		{
+			Define_Iso(fabs(opt->isovalue));
+			set_label_title(title,0,0);
+			draw_scene_gl(opt->width, opt->height, FALSE);
+			gabedit_save_image_gl(NULL, fileName, "png",NULL);
+			printf("%s\n",fileName);
+		}
+		g_free(fileName);
+		g_free(title);
+	}
+	if(nums) g_free(nums);
+	g_free(dirName);
+	free_data_all();
+	destroy_offscreen_context();
+	return (nErrors>0)?1:0;
+}
+#endif /* ENABLE_EGL */
+/********************************************************************************/
+#ifndef G_OS_WIN32
+/* one process by job, each one with its part of the processors for the OpenMP loops */
+static gint run_batch_orbitals_workers(gint argc, gchar** argv, gint nJobs)
+{
+	GPid* pids = g_malloc(nJobs*sizeof(GPid));
+	gchar** envp = g_get_environ();
+	gchar** workerArgv = g_malloc((argc+2)*sizeof(gchar*));
+	gchar* nThreads = g_strdup_printf("%d", MAX(1,(gint)g_get_num_processors()/nJobs));
+	gint nErrors = 0;
+	gint i;
+	gint k;
+
+	envp = g_environ_setenv(envp, "OMP_NUM_THREADS", nThreads, TRUE);
+	for(i=0;i<argc;i++) workerArgv[i] = argv[i];
+	workerArgv[argc+1] = NULL;
+	for(k=0;k<nJobs;k++)
+	{
+		GError* error = NULL;
+		workerArgv[argc] = g_strdup_printf("--worker=%d/%d",k,nJobs);
+		pids[k] = 0;
+		if(!g_spawn_async(NULL, workerArgv, envp, G_SPAWN_DO_NOT_REAP_CHILD|G_SPAWN_SEARCH_PATH, NULL, NULL, &pids[k], &error))
+		{
+			if(error)
+			{
+				g_printerr("%s\n",error->message);
+				g_error_free(error);
+			}
+			pids[k] = 0;
+			nErrors++;
+		}
+		g_free(workerArgv[argc]);
+	}
+	for(k=0;k<nJobs;k++)
+	{
+		gint status;
+		if(pids[k]<=0) continue;
+		if(waitpid((pid_t)pids[k], &status, 0)<0 || !WIFEXITED(status) || WEXITSTATUS(status)!=0) nErrors++;
+		g_spawn_close_pid(pids[k]);
+	}
+	g_free(nThreads);
+	g_free(workerArgv);
+	g_strfreev(envp);
+	g_free(pids);
+	return (nErrors>0)?1:0;
+}
+#endif
+/********************************************************************************/
+gint run_batch_orbitals(gint argc, gchar** argv)
+{
+	BatchOrbitalsOptions opt;
+	if(!get_batch_orbitals_options(argc, argv, &opt))
+	{
+		print_batch_orbitals_usage();
+		return 1;
+	}
+#ifndef ENABLE_EGL
+	g_printerr("Error : this version of Gabedit was compiled without the off-screen rendering (ENABLE_EGL)\n");
+	return 1;
+#else
+#ifndef G_OS_WIN32
+	if(opt.worker<0 && opt.nJobs>1) return run_batch_orbitals_workers(argc, argv, opt.nJobs);
+#endif
+	if(opt.worker<0) opt.nJobs = 1;
+	return run_batch_orbitals_worker(argc, argv, &opt);
+#endif
+}
@@ -0,0 +1,27 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#ifndef __GABEDIT_BATCHORBITALS_H__
+#define __GABEDIT_BATCHORBITALS_H__
+
+/* gabedit --batch-orbitals file [--orbitals=homo-2:lumo+2,10] [--isovalue=0.05] [--size=800x600] [--points=60] [--jobs=4] [--output=dir] [--beta] */
+gboolean is_batch_orbitals_command(gint argc, gchar** argv);
+gint run_batch_orbitals(gint argc, gchar** argv);
+
+#endif /* __GABEDIT_BATCHORBITALS_H__ */
+
@@ -305,7 +305,7 @@ static void apply_capture_orbitals(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : one entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -315,7 +315,7 @@ static void apply_capture_orbitals(GtkWidget *Win,gpointer data)
 		if(NumPointstmp[i] <=2)
 		{
 			GtkWidget* message = Message(_("Error : The number of points should be > 2. "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		
@@ -326,7 +326,7 @@ static void apply_capture_orbitals(GtkWidget *Win,gpointer data)
 		if( limitstmp.MinMax[0][i]> limitstmp.MinMax[1][i])
 		{
 			GtkWidget* message = Message(_("Error :  The minimal value should be smaller than the maximal value "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 	}
@@ -351,7 +351,7 @@ static void apply_capture_orbitals(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : one entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -366,7 +366,7 @@ static void apply_capture_orbitals(GtkWidget *Win,gpointer data)
 		if(fabs(norm)<1e-8)
 		{
 			GtkWidget* message = Message(_("Error : the norm is equal to 0 "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		for(j=0;j<3;j++)
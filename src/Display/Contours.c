@@ -18,6 +18,9 @@ DEALINGS IN THE SOFTWARE.
 ************************************************************************************************************/
 
 #include "../../Config.h"
+#ifdef ENABLE_OMP
+#include <omp.h>
+#endif
 #include <gtk/gtk.h>
 #include <stdlib.h>
 #include <math.h>
@@ -34,220 +37,294 @@ static void reset_limits_values(GtkWidget *Win,gpointer data);
 static gboolean linear = TRUE;
 
 /**************************************************************/
-PointsContour** contour_point_alloc(gint N[],gint i0, gint i1)
+/* first index of the sorted values >= x */
+static gint contours_lower_bound(gdouble* sortedValues, gint nValues, gdouble x)
 {
-	PointsContour** points;
-	gint i;
-	gint j;
-  	
-	points = g_malloc(N[i0]*sizeof(PointsContour*));
-	for(i=0;i< N[i0] ;i++)
+	gint lo = 0;
+	gint hi = nValues;
+	while(lo<hi)
 	{
-		points[i] = g_malloc(N[i1]*sizeof(PointsContour));
-		for( j = 0; j<N[i1];j++)
-		{
-			points[i][j].N = 0;
-			points[i][j].point = NULL;
-		}
+		gint mid = (lo+hi)/2;
+		if(sortedValues[mid]<x) lo = mid+1;
+		else hi = mid;
 	}
-		
-	return points;
+	return lo;
 }
 /**************************************************************/
-void contour_point_free(Contours contours)
+static void contours_link(gint* neighbours, gint a, gint b)
 {
-	gint i;
-	gint j;
-  	
-	if(!contours.pointscontour) return;
-	for(i=0;i<contours.N[0];i++)
-	{
+	if(neighbours[2*a]<0) neighbours[2*a] = b;
+	else neighbours[2*a+1] = b;
+	if(neighbours[2*b]<0) neighbours[2*b] = a;
+	else neighbours[2*b+1] = a;
+}
+/**************************************************************/
+static void contours_add_line(ContoursPlane* contoursPlane, gint* nAlloc, gint level, gint start, gint* neighbours, gboolean* done, Point5* points)
+{
+	ContourLine* line;
+	gint previous = -1;
+	gint current = start;
+	gint n = 0;
 
-		if(contours.pointscontour[i])
-		{
-			for( j = 0; j<contours.N[1];j++)
-			{
-				/* printf("N = %d \n",contours.pointscontour[i][j].N);*/
-				if(contours.pointscontour[i][j].N>0 && contours.pointscontour[i][j].point) 
-					g_free(contours.pointscontour[i][j].point);
-			}
-			g_free(contours.pointscontour[i]);
-		}
+	if(contoursPlane->nLines>=*nAlloc)
+	{
+		*nAlloc = 2*(*nAlloc)+16;
+		contoursPlane->lines = g_realloc(contoursPlane->lines, (*nAlloc)*sizeof(ContourLine));
+	}
+	line = &contoursPlane->lines[contoursPlane->nLines++];
+	line->level = level;
+	line->closed = FALSE;
+	line->N = 0;
+	do
+	{
+		gint next = (neighbours[2*current]!=previous)?neighbours[2*current]:neighbours[2*current+1];
+		done[current] = TRUE;
+		n++;
+		previous = current;
+		current = next;
+	}while(current>=0 && !done[current]);
+	line->closed = (current==start && n>2);
+	line->point = g_malloc(n*sizeof(Point5));
+	previous = -1;
+	current = start;
+	while(line->N<n)
+	{
+		gint next = (neighbours[2*current]!=previous)?neighbours[2*current]:neighbours[2*current+1];
+		line->point[line->N++] = points[current];
+		previous = current;
+		current = next;
 	}
-	g_free(contours.pointscontour);
-		
 }
 /**************************************************************/
-void set_contour_point(PointsContour** pointscontour,Grid* plansgrid,gdouble value,gint i0,gint i1,gint numplan)
+/* marching squares on the plane numplan for all the values in one pass.
+ * A crossing is computed once per edge and value, on the edges with min(f) <= value < max(f),
+ * the crossings of each cell are linked to segments (saddles resolved by the value at the cell centre),
+ * then the segments are chained to polylines. */
+static void set_contours_plane(ContoursPlane* contoursPlane, Grid* plansgrid, gint nValues, gdouble* sortedValues, gint* order, gint i0, gint i1, gint numplan)
 {
-	gint i;
-	gint j;
-	gint k;
-	gint c;
-	Point5 t[4];
-	gdouble u1;
-	gdouble u2;
-	gdouble v1;
-	gdouble v2;
-	gint ip = numplan;
-	gint ix=0,iy=0,iz=0;
-	gint ix1=0,iy1=0,iz1=0;
-	gint ix2=0,iy2=0,iz2=0;
-	gint ix3=0,iy3=0,iz3=0;
-	gint ix4=0,iy4=0,iz4=0;
-
-	for( i = 0; i<plansgrid->N[i0]-1;i++)
+	gint n0 = plansgrid->N[i0];
+	gint n1 = plansgrid->N[i1];
+	gint nH = (n0-1)*n1;
+	gint nEdges = nH + n0*(n1-1);
+	gint i2 = 3-i0-i1;
+	Point5** P;
+	gdouble* f;
+	gint* lo;
+	gint* first;
+	gint* neighbours;
+	gint* levelOfPoint;
+	gint* firstOfLevel;
+	gint* pointsOfLevel;
+	gboolean* done;
+	Point5* points;
+	gint nPoints;
+	gint nAlloc = 0;
+	gint i, j, e, p, l;
+
+	contoursPlane->nLines = 0;
+	contoursPlane->lines = NULL;
+	if(n0<2 || n1<2 || nValues<1) return;
+
+	P = g_malloc(n0*n1*sizeof(Point5*));
+	f = g_malloc(n0*n1*sizeof(gdouble));
+	for(i=0;i<n0;i++)
+	for(j=0;j<n1;j++)
 	{
-		for( j = 0; j<plansgrid->N[i1]-1;j++)
+		gint ind[3];
+		ind[i0] = i;
+		ind[i1] = j;
+		ind[i2] = numplan;
+		P[i*n1+j] = &plansgrid->point[ind[0]][ind[1]][ind[2]];
+		f[i*n1+j] = P[i*n1+j]->C[3];
+	}
+	/* levels crossing each edge : sorted values lo[e] ... first[e+1]-first[e]+lo[e]-1 */
+	lo = g_malloc(nEdges*sizeof(gint));
+	first = g_malloc((nEdges+1)*sizeof(gint));
+	first[0] = 0;
+	for(e=0;e<nEdges;e++)
+	{
+		gint a, b;
+		gdouble fa, fb;
+		if(e<nH) { a = e; b = e+n1; }
+		else { i = (e-nH)/(n1-1); j = (e-nH)%(n1-1); a = i*n1+j; b = a+1; }
+		fa = f[a];
+		fb = f[b];
+		if(fa>fb) { gdouble t = fa; fa = fb; fb = t; }
+		lo[e] = contours_lower_bound(sortedValues, nValues, fa);
+		first[e+1] = first[e] + contours_lower_bound(sortedValues, nValues, fb) - lo[e];
+	}
+	nPoints = first[nEdges];
+	points = g_malloc((nPoints+1)*sizeof(Point5));
+	levelOfPoint = g_malloc((nPoints+1)*sizeof(gint));
+	neighbours = g_malloc((2*nPoints+1)*sizeof(gint));
+	for(p=0;p<2*nPoints;p++) neighbours[p] = -1;
+	for(e=0;e<nEdges;e++)
+	{
+		gint a, b, c;
+		if(e<nH) { a = e; b = e+n1; }
+		else { i = (e-nH)/(n1-1); j = (e-nH)%(n1-1); a = i*n1+j; b = a+1; }
+		for(p=first[e];p<first[e+1];p++)
 		{
-			switch(i0)
-			{
-			case 0: 
-				ix = i;
-				ix1 = ix2 = ix + 1;
-				ix4 = ix3 = ix;
-				switch(i1)
-				{
-				case 1 : iy = j; iz = ip; 
-					 iy1 = iy4 =  iy; iy2 = iy3 = iy+1 ;
-					 iz1 = iz2 = iz3 = iz4 = iz;
-					 break;
-				case 2 : iy = ip;iz = j;
-					 iy1 = iy2 = iy3 = iy4 = iy;
-					 iz1 = iz4 = iz; iz2 = iz3 =  iz+1 ; 
-					 break;
-				}
-				break;
-			case 1: iy = i;
-				iy1 = iy2 =  iy + 1;
-				iy3 = iy4 = iy ;
-				switch(i1)
-				{
-				case 0 : ix = j; iz = ip;
-					 iz1 = iz2 = iz3 = iz4 = iz;
-					 ix1 = ix4 =  ix; ix2 = ix3 = ix+1 ;
-					 break;
-				case 2 : ix = ip;iz = j;
-					 ix1 = ix2 = ix3 = ix4 = ix;
-					 iz1 = iz4 =  iz; iz2 = iz3 = iz+1 ;
-					 break;
-				}
-				break;
-			case 2: iz = i;
-				iz1 = iz2 =  iz + 1;
-				iz3 = iz4 = iz ;
-				switch(i1)
-				{
-				case 0 : ix = j; iy = ip;
-					 iy1 = iy2 = iy3 = iy4 = iy;
-					 ix1 = ix4 =  ix; ix2 = ix3 = ix+1 ;
-					 break;
-				case 1 : ix = ip;iy = j;
-					 ix1 = ix2 = ix3 = ix4 = ix;
-					 iy1 = iy4 =  iy; iy2 = iy3 = iy+1 ;
-					 break;
-				}
-				break;
-			}
-        
-			v1 = plansgrid->point[ix][iy][iz].C[3]-value,
-			v2 = plansgrid->point[ix1][iy1][iz1].C[3]-value;
-
-			k = -1;
-			if( v1*v2 <0 )
-			{
-				k++;
-				for(c=0;c<3;c++)
-				{
-					u1 = plansgrid->point[ix][iy][iz].C[c];
-					u2 = plansgrid->point[ix1][iy1][iz1].C[c];
-					if(v1==0)
-					 	t[k].C[c] = u1;
-					else
-						t[k].C[c] = u1 - v1 *(u2-u1)/(v2-v1);
-				}
-				t[k].C[3] =value;
-			}
-			v1 = v2;
-			v2 = plansgrid->point[ix2][iy2][iz2].C[3]-value;
-			if( v1*v2 <0 )
+			gint ls = lo[e]+p-first[e];
+			gdouble value = sortedValues[ls];
+			gdouble t = (value-f[a])/(f[b]-f[a]);
+			for(c=0;c<3;c++) points[p].C[c] = P[a]->C[c] + t*(P[b]->C[c]-P[a]->C[c]);
+			points[p].C[3] = value;
+			points[p].C[4] = 0;
+			levelOfPoint[p] = order[ls];
+		}
+	}
+	/* segments : corners c0=(i,j) c1=(i+1,j) c2=(i+1,j+1) c3=(i,j+1), edges e0=c0c1 e1=c1c2 e2=c3c2 e3=c0c3 */
+	for(i=0;i<n0-1;i++)
+	for(j=0;j<n1-1;j++)
+	{
+		gint edges[4];
+		gdouble fc[4];
+		gint k, lmin, lmax;
+
+		edges[0] = i*n1+j;
+		edges[1] = nH + (i+1)*(n1-1)+j;
+		edges[2] = i*n1+j+1;
+		edges[3] = nH + i*(n1-1)+j;
+		/* the levels crossing the cell are the union of those of its edges */
+		lmin = nValues;
+		lmax = 0;
+		for(k=0;k<4;k++)
+		{
+			e = edges[k];
+			if(first[e+1]==first[e]) continue;
+			if(lo[e]<lmin) lmin = lo[e];
+			if(lo[e]+first[e+1]-first[e]>lmax) lmax = lo[e]+first[e+1]-first[e];
+		}
+		if(lmin>=lmax) continue;
+		fc[0] = f[i*n1+j];
+		fc[1] = f[(i+1)*n1+j];
+		fc[2] = f[(i+1)*n1+j+1];
+		fc[3] = f[i*n1+j+1];
+		for(l=lmin;l<lmax;l++)
+		{
+			gint ids[4];
+			for(k=0;k<4;k++)
 			{
-				k++;
-				for(c=0;c<3;c++)
-				{
-					u1 = plansgrid->point[ix1][iy1][iz1].C[c];
-					u2 = plansgrid->point[ix2][iy2][iz2].C[c];
-					if(v1==0)
-					 	t[k].C[c] = u1;
-					else
-						t[k].C[c] = u1 - v1 *(u2-u1)/(v2-v1);
-				}
-				t[k].C[3] =value;
+				e = edges[k];
+				if(l>=lo[e] && l<lo[e]+first[e+1]-first[e]) ids[k] = first[e]+l-lo[e];
+				else ids[k] = -1;
 			}
-			v1 = v2;
-			v2 = plansgrid->point[ix3][iy3][iz3].C[3]-value;
-			if( v1*v2 <0 )
+			if(ids[0]>=0 && ids[1]>=0 && ids[2]>=0 && ids[3]>=0)
 			{
-				k++;
-				for(c=0;c<3;c++)
+				gdouble centre = (fc[0]+fc[1]+fc[2]+fc[3])/4;
+				if((centre>sortedValues[l]) == (fc[0]>sortedValues[l]))
 				{
-					u1 = plansgrid->point[ix2][iy2][iz2].C[c];
-					u2 = plansgrid->point[ix3][iy3][iz3].C[c];
-					if(v1==0)
-					 	t[k].C[c] = u1;
-					else
-						t[k].C[c] = u1 - v1 *(u2-u1)/(v2-v1);
+					contours_link(neighbours, ids[0], ids[1]);
+					contours_link(neighbours, ids[2], ids[3]);
 				}
-				t[k].C[3] =value;
-			}
-			v1 = v2;
-			v2 = plansgrid->point[ix4][iy4][iz4].C[3]-value;
-			if( v1*v2 <0 )
-			{
-				k++;
-				for(c=0;c<3;c++)
+				else
 				{
-					u1 = plansgrid->point[ix3][iy3][iz3].C[c];
-					u2 = plansgrid->point[ix4][iy4][iz4].C[c];
-					if(v1==0)
-					 	t[k].C[c] = u1;
-					else
-						t[k].C[c] = u1 - v1 *(u2-u1)/(v2-v1);
+					contours_link(neighbours, ids[3], ids[0]);
+					contours_link(neighbours, ids[1], ids[2]);
 				}
-				t[k].C[3] =value;
 			}
-			pointscontour[i][j].N = k+1;
-			pointscontour[i][j].point = NULL;
-			if(pointscontour[i][j].N>0)
+			else
 			{
-				pointscontour[i][j].point = g_malloc(pointscontour[i][j].N*sizeof(Point5));
-				for(k=0;k<pointscontour[i][j].N;k++)
+				gint a = -1;
+				for(k=0;k<4;k++)
 				{
-					for(c=0;c<4;c++)
-				   		pointscontour[i][j].point[k].C[c] = t[k].C[c];
+					if(ids[k]<0) continue;
+					if(a<0) a = ids[k];
+					else contours_link(neighbours, a, ids[k]);
 				}
 			}
 		}
 	}
+	/* polylines, by level : the open lines from their ends then the closed ones */
+	firstOfLevel = g_malloc0((nValues+1)*sizeof(gint));
+	pointsOfLevel = g_malloc((nPoints+1)*sizeof(gint));
+	for(p=0;p<nPoints;p++) firstOfLevel[levelOfPoint[p]+1]++;
+	for(l=0;l<nValues;l++) firstOfLevel[l+1] += firstOfLevel[l];
+	for(p=0;p<nPoints;p++) pointsOfLevel[firstOfLevel[levelOfPoint[p]]++] = p;
+	for(l=nValues;l>0;l--) firstOfLevel[l] = firstOfLevel[l-1];
+	firstOfLevel[0] = 0;
+	done = g_malloc0((nPoints+1)*sizeof(gboolean));
+	for(l=0;l<nValues;l++)
+	{
+		gint k;
+		for(k=firstOfLevel[l];k<firstOfLevel[l+1];k++)
+		{
+			p = pointsOfLevel[k];
+			if(!done[p] && neighbours[2*p+1]<0)
+				contours_add_line(contoursPlane, &nAlloc, l, p, neighbours, done, points);
+		}
+		for(k=firstOfLevel[l];k<firstOfLevel[l+1];k++)
+		{
+			p = pointsOfLevel[k];
+			if(!done[p]) contours_add_line(contoursPlane, &nAlloc, l, p, neighbours, done, points);
+		}
+	}
+	g_free(P);
+	g_free(f);
+	g_free(lo);
+	g_free(first);
+	g_free(points);
+	g_free(levelOfPoint);
+	g_free(neighbours);
+	g_free(firstOfLevel);
+	g_free(pointsOfLevel);
+	g_free(done);
+}
+/**************************************************************/
+static gint cmp_contours_values(gconstpointer a, gconstpointer b, gpointer data)
+{
+	const gdouble* values = data;
+	gdouble va = values[*(const gint*)a];
+	gdouble vb = values[*(const gint*)b];
+	if(va<vb) return -1;
+	if(va>vb) return 1;
+	return (*(const gint*)a) - (*(const gint*)b);
+}
+/**************************************************************/
+ContoursPlane* get_contours_planes(Grid* plansgrid, gint nValues, gdouble* values, gint nPlanes, gint* planes)
+{
+	ContoursPlane* contoursPlanes;
+	gdouble* sortedValues;
+	gint* order;
+	gint k;
 
+	if(!plansgrid || nPlanes<1) return NULL;
+	contoursPlanes = g_malloc(nPlanes*sizeof(ContoursPlane));
+	order = g_malloc((nValues+1)*sizeof(gint));
+	sortedValues = g_malloc((nValues+1)*sizeof(gdouble));
+	for(k=0;k<nValues;k++) order[k] = k;
+	g_qsort_with_data(order, nValues, sizeof(gint), cmp_contours_values, values);
+	for(k=0;k<nValues;k++) sortedValues[k] = values[order[k]];
+
+#ifdef ENABLE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for(k=0;k<nPlanes;k++)
+		set_contours_plane(&contoursPlanes[k], plansgrid, nValues, sortedValues, order, planes[3*k], planes[3*k+1], planes[3*k+2]);
+
+	g_free(order);
+	g_free(sortedValues);
+	return contoursPlanes;
 }
 /**************************************************************/
-Contours get_contours(Grid* plansgrid,gdouble value,gint i0,gint i1,gint numplan)
+void contours_planes_free(ContoursPlane* contoursPlanes, gint nPlanes)
 {
-	Contours contours;
-	PointsContour** pointscontour = contour_point_alloc(plansgrid->N,i0,i1);
-	set_contour_point(pointscontour,plansgrid,value,i0,i1,numplan);
-	contours.N[0] = plansgrid->N[i0];
-	contours.N[1] = plansgrid->N[i1];
-	contours.pointscontour = pointscontour;
-	return contours;
+	gint k, n;
+	if(!contoursPlanes) return;
+	for(k=0;k<nPlanes;k++)
+	{
+		for(n=0;n<contoursPlanes[k].nLines;n++)
+			if(contoursPlanes[k].lines[n].point) g_free(contoursPlanes[k].lines[n].point);
+		if(contoursPlanes[k].lines) g_free(contoursPlanes[k].lines);
+	}
+	g_free(contoursPlanes);
 }
 /********************************************************************************/
-void create_contours_surface_one_plane(gint type, gdouble value)
+static gint* add_contours_surface_planes(gint* planes, gint* nPlanes, gint type)
 {
 	gint i0 = 0;
 	gint i1 = 1;
-	gdouble gap = 0;
 	gint numplane = 0;
 
 	switch(type)
@@ -256,20 +333,34 @@ void create_contours_surface_one_plane(gint type, gdouble value)
 		case 1 : i0 = 0;i1 = 2;break; /* plane XZ */
 		case 2 : i0 = 0;i1 = 1;break; /* plane XY */
 	}
+	planes = g_realloc(planes, 3*(*nPlanes+grid->N[type])*sizeof(gint));
 	for(numplane=0;numplane<grid->N[type];numplane++)
 	{
-		gdouble* values = g_malloc(sizeof(gdouble));
-		*values = value;
-		set_contours_values(1, values, i0, i1, numplane, gap);
-		glarea_rafresh(GLArea);
+		planes[3*(*nPlanes)] = i0;
+		planes[3*(*nPlanes)+1] = i1;
+		planes[3*(*nPlanes)+2] = numplane;
+		(*nPlanes)++;
 	}
+	return planes;
 }
 /********************************************************************************/
+/* all the planes are sent at once, their contours are computed in parallel at the next redraw */
 void create_contours_surface(gboolean first, gboolean second, gboolean third, gdouble value)
 {
-	if(first) create_contours_surface_one_plane(0, value);
-	if(second) create_contours_surface_one_plane(1, value);
-	if(third) create_contours_surface_one_plane(2, value);
+	gint* planes = NULL;
+	gint nPlanes = 0;
+	gdouble* values = NULL;
+	gdouble gap = 0;
+
+	if(!grid) return;
+	if(first) planes = add_contours_surface_planes(planes, &nPlanes, 0);
+	if(second) planes = add_contours_surface_planes(planes, &nPlanes, 1);
+	if(third) planes = add_contours_surface_planes(planes, &nPlanes, 2);
+	if(nPlanes<1) return;
+	values = g_malloc(sizeof(gdouble));
+	*values = value;
+	set_contours_values_planes(1, values, nPlanes, planes, gap);
+	glarea_rafresh(GLArea);
 }
 /********************************************************************************/
 static void apply_contours_isosurface(GtkWidget *Win,gpointer data)
@@ -285,7 +376,7 @@ static void apply_contours_isosurface(GtkWidget *Win,gpointer data)
 	else
 	{
 		GtkWidget* message =Message(_("Error : one entry is not a float "),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
 	if(fabs(isovalue)>fabs(limits.MinMax[1][3]) && fabs(isovalue)>fabs(limits.MinMax[0][3]))
@@ -293,7 +384,7 @@ static void apply_contours_isosurface(GtkWidget *Win,gpointer data)
 		gchar buffer[1024];
 		sprintf(buffer,_("Error : The isovalue  value should between %lf and %lf"),fabs(limits.MinMax[1][3]),fabs(limits.MinMax[0][3]));
 		GtkWidget* message = Message(buffer,_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
 
@@ -309,7 +400,6 @@ static void getiso(GtkWidget *button,gpointer data)
 	gdouble isovalue = 0.1;
 	gdouble percent = 100;
 	gboolean square = TRUE;
-	gdouble precision =1e-6;
 	
 	temp = g_strdup(gtk_entry_get_text(GTK_ENTRY(EntryPercent))); 
 	delete_first_spaces(temp);
@@ -318,7 +408,7 @@ static void getiso(GtkWidget *button,gpointer data)
 	else
 	{
 		GtkWidget* message =Message(_("Error : one entry is not a float "),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		if(temp) g_free(temp);
 		return;
 	}
@@ -334,7 +424,7 @@ static void getiso(GtkWidget *button,gpointer data)
 		|| TypeGrid == GABEDIT_TYPEGRID_FEDRADICAL
 	) square = FALSE;
 
-	if(!compute_isovalue_percent_from_grid(grid, square, percent, precision, &isovalue)) return;
+	if(!compute_isovalue_percent_from_grid(grid, square, percent, &isovalue)) return;
 	temp = g_strdup_printf("%f",isovalue);
 	gtk_entry_set_text(GTK_ENTRY(Entry),temp); 
 	if(temp) g_free(temp);
@@ -516,7 +606,7 @@ void apply_contours(GtkWidget *Win,gpointer data)
 	if( max<=min)
 	{
 		GtkWidget* message = Message(_("Error :  The minimal value should be smaller than the maximal value "),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
         if(!get_a_float(Entries[4],&gap,_("Error : The projection value should be float."))) return;
@@ -923,7 +1013,7 @@ void apply_contours_plane(GtkWidget *Win,gpointer data)
 	if( maxv<=minv)
 	{
 		GtkWidget* message = Message(_("Error :  The minimal value should be smaller than the maximal value "),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
 
@@ -19,18 +19,21 @@ DEALINGS IN THE SOFTWARE.
 #ifndef __GABEDIT_CONTOURS_H__
 #define __GABEDIT_CONTOURS_H__
 
-typedef struct _PointsContour
+typedef struct _ContourLine
 {
+	gint level; /* number of the contour value */
 	gint N;
+	gboolean closed; /* the last point is joined to the first one */
 	Point5* point;
-}PointsContour;
-typedef struct _Contours
+}ContourLine;
+typedef struct _ContoursPlane
 {
-      gint N[2];
-      PointsContour** pointscontour;
-}Contours;
-void contour_point_free(Contours contours);
-Contours get_contours(Grid* plansgrid,gdouble value,gint i0,gint i1,gint numplan);
+	gint nLines;
+	ContourLine* lines; /* sorted by level */
+}ContoursPlane;
+/* planes : nPlanes triples (i0, i1, numplan), the planes are computed in parallel */
+ContoursPlane* get_contours_planes(Grid* plansgrid, gint nValues, gdouble* values, gint nPlanes, gint* planes);
+void contours_planes_free(ContoursPlane* contoursPlanes, gint nPlanes);
 void create_contours(gchar* title,gint type);
 void create_contours_plane(gchar* title);
 void create_contours_isosurface();
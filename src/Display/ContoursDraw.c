@@ -226,68 +226,47 @@ void PlanDraw(Grid* plansgrid,gint i0,gint i1,gint numplan,gdouble Gap[])
 	glPolygonMode(GL_FRONT_AND_BACK,GL_LINE);
 }
 /*********************************************************************************************************/
-static void ContoursDraw(Contours contours,gdouble Gap[], gdouble value)
+static void ContoursDraw(ContoursPlane* contoursPlane,gdouble Gap[], gint Ncontours, gdouble* values, ColorMap* colorMap, gdouble Color[])
 {
-	gint i;
-	gint j;
-	gint k = 0;
-	gint n=0;
-	gint N[2] = {contours.N[0],contours.N[1]};
-	PointsContour** pointscontour= contours.pointscontour;
+	gint k;
+	gint n;
 	gdouble x, y, z;
 
 	glLineWidth(0.5);
-	/*for(i=1;i<N[0]-2;i++)*/
-	for(i=0;i<N[0]-1;i++)
+	for(k=0;k<contoursPlane->nLines;k++)
 	{
-		/*for(j=1;j<N[1]-2;j++)*/
-		for(j=0;j<N[1]-1;j++)
-		{
-	/*			Debug("N(%d,%d) = %d\n",i,j,pointscontour[i][j].N);*/
-				for(n=0;n<pointscontour[i][j].N-1;n++)
-				{
-					k++;
-					if(dottedNegtaiveContours && value<0) 
-					{
-						glEnable (GL_LINE_STIPPLE);
-						/*glLineStipple (1, 0x0101);*/   /*  dotted   */
-						/*glLineStipple (1, 0x00FF);*/   /*  dashed   */
-						/*glLineStipple (1, 0x1C47);*/   /*  dash/dot/dash   */
-						/* glLineStipple (2, 0xAAAA);  */
-						glLineStipple (3, 0x5555);
-					}
-					glBegin(GL_LINES);
-					/*
-					glVertex4fv(pointscontour[i][j].point[n].C);
-					glVertex4fv(pointscontour[i][j].point[n+1].C);
-					*/
-					x = pointscontour[i][j].point[n].C[0] + Gap[0];
-					y = pointscontour[i][j].point[n].C[1] + Gap[1];
-					z = pointscontour[i][j].point[n].C[2] + Gap[2];
-					glVertex3f(x,y,z);
-					x = pointscontour[i][j].point[n+1].C[0] + Gap[0];
-					y = pointscontour[i][j].point[n+1].C[1] + Gap[1];
-					z = pointscontour[i][j].point[n+1].C[2] + Gap[2];
-					glVertex3f(x,y,z);
-					glEnd();
-					if(dottedNegtaiveContours && value<0) glDisable (GL_LINE_STIPPLE);
-				}
+		ContourLine* line = &contoursPlane->lines[k];
+		gdouble value = values[line->level];
 
+		if(Ncontours>1) set_Color_From_colorMap(colorMap, Color, value);
+		glColor4dv(Color);
+		if(dottedNegtaiveContours && value<0) 
+		{
+			glEnable (GL_LINE_STIPPLE);
+			/*glLineStipple (1, 0x0101);*/   /*  dotted   */
+			/*glLineStipple (1, 0x00FF);*/   /*  dashed   */
+			/*glLineStipple (1, 0x1C47);*/   /*  dash/dot/dash   */
+			/* glLineStipple (2, 0xAAAA);  */
+			glLineStipple (3, 0x5555);
+		}
+		if(line->closed) glBegin(GL_LINE_LOOP);
+		else glBegin(GL_LINE_STRIP);
+		for(n=0;n<line->N;n++)
+		{
+			x = line->point[n].C[0] + Gap[0];
+			y = line->point[n].C[1] + Gap[1];
+			z = line->point[n].C[2] + Gap[2];
+			glVertex3f(x,y,z);
 		}
+		glEnd();
+		if(dottedNegtaiveContours && value<0) glDisable (GL_LINE_STIPPLE);
 	}
 	glLineWidth(1);
-	/*
-	Debug("N0 = %d\n",N[0]);
-	Debug("N1 = %d\n",N[1]);
-	Debug("Nlignes = %d\n",k);
-	*/
 }
 /*********************************************************************************************************/
-GLuint ContoursPlanGenOneList(Grid* plansgrid,gint Ncontours,gdouble*values,gint i0,gint i1,gint numplan,gdouble gap)
+static GLuint ContoursPlanGenOneList(Grid* plansgrid,ContoursPlane* contoursPlane,gint Ncontours,gdouble*values,gint i0,gint i1,gint numplan,gdouble gap)
 {
 	GLuint contourslist;
-	Contours contours;
-	gint i;
 	gdouble *Gap;
 	ColorMap* colorMap = get_colorMap_contours();
 
@@ -328,19 +307,7 @@ GLuint ContoursPlanGenOneList(Grid* plansgrid,gint Ncontours,gdouble*values,gint
 		/* glDisable(GL_COLOR_MATERIAL);*/
 		glDisable(GL_BLEND);
 		glEnable(GL_LINE_SMOOTH); 
-		for(i=0;i<Ncontours;i++)
-		{
-			if(Ncontours>1) set_Color_From_colorMap(colorMap, Color, values[i]);
-			/* printf("i = %d vale = %f\n",i,values[i]);*/
-
-			glColor4dv(Color);
-			contours = get_contours(plansgrid,values[i],i0,i1,numplan);
-			/* printf("End get_contours\n");*/
-			ContoursDraw(contours,Gap,values[i]);
-			/* printf("End ContoursDraw\n");*/
-			contour_point_free(contours);				
-			/* printf("End contour_point_free\n");*/
-		}
+		if(contoursPlane) ContoursDraw(contoursPlane,Gap,Ncontours,values,colorMap,Color);
 		glEnable ( GL_LIGHTING ) ;
 	}
 	if(TypeBlend == GABEDIT_BLEND_YES)
@@ -389,7 +356,9 @@ void showColorMapContours()
 /********************************************************************************/
 void hideColorMapContours()
 {
-	GtkWidget* handleBoxColorMapContours = g_object_get_data(G_OBJECT(PrincipalWindow), "HandleboxColorMapContours");
+	GtkWidget* handleBoxColorMapContours = NULL;
+	if(!PrincipalWindow) return;
+	handleBoxColorMapContours = g_object_get_data(G_OBJECT(PrincipalWindow), "HandleboxColorMapContours");
 	color_map_hide(handleBoxColorMapContours);
 }
 /********************************************************************************/
@@ -399,12 +368,28 @@ GLuint ContoursGenLists(GLuint contourslist,Grid* plansgrid,gint Ncontours,gdoub
 			glDeleteLists(contourslist,1);
 	if(Ncontours>0)
 	{
-		contourslist = ContoursPlanGenOneList(plansgrid,Ncontours,values,i0,i1,numplan,gap);
+		gint plane[3] = {i0, i1, numplan};
+		ContoursPlane* contoursPlane = get_contours_planes(plansgrid,Ncontours,values,1,plane);
+		contourslist = ContoursPlanGenOneList(plansgrid,contoursPlane,Ncontours,values,i0,i1,numplan,gap);
+		contours_planes_free(contoursPlane,1);
 	}
 
 	return contourslist;
 }
 /********************************************************************************/
+/* one list by plane from contours computed by get_contours_planes */
+void ContoursGenListsPlanes(GLuint* contoursLists,Grid* plansgrid,ContoursPlane* contoursPlanes,gint Ncontours,gdouble* values,gint nPlanes,gint* planes,gdouble gap)
+{
+	gint k;
+	for(k=0;k<nPlanes;k++)
+	{
+		if (glIsList(contoursLists[k]) == GL_TRUE) glDeleteLists(contoursLists[k],1);
+		contoursLists[k] = 0;
+		if(Ncontours>0 && contoursPlanes)
+			contoursLists[k] = ContoursPlanGenOneList(plansgrid,&contoursPlanes[k],Ncontours,values,planes[3*k],planes[3*k+1],planes[3*k+2],gap);
+	}
+}
+/********************************************************************************/
 void ContoursShowLists(GLuint list)
 {
 	if (glIsList(list) == GL_TRUE) 
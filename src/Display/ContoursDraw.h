@@ -18,11 +18,13 @@ DEALINGS IN THE SOFTWARE.
 
 #ifndef __GABEDIT_CONTOURSDRAW_H__
 #define __GABEDIT_CONTOURSDRAW_H__
+#include "../Display/Contours.h"
 
 void set_dotted_negative_contours(gboolean dotted);
 gboolean get_dotted_negative_contours();
 gdouble* GetGapVector(Grid* plansgrid,gint i0,gint i1,gint numplan,gdouble gap);
 GLuint ContoursGenLists(GLuint contourslist,Grid* plansgrid,gint Ncontours,gdouble* values,gint i0,gint i1,gint numplan,gdouble gap);
+void ContoursGenListsPlanes(GLuint* contoursLists,Grid* plansgrid,ContoursPlane* contoursPlanes,gint Ncontours,gdouble* values,gint nPlanes,gint* planes,gdouble gap);
 void ContoursShowLists(GLuint list);
 void showColorMapContours();
 void hideColorMapContours();
@@ -152,31 +152,28 @@ static void addPlanPovRay(FILE* file, Grid* plansgrid,gint i0,gint i1,gint numpl
 
 }
 /********************************************************************************/
-static void AddContoursPovRay(FILE* file,Contours contours,gdouble Gap[], gdouble Color[])
+static void AddContoursPovRay(FILE* file,ContoursPlane* contoursPlane,gdouble Gap[], gint Ncontours, gdouble* values, ColorMap* colorMap, gdouble Color[])
 {
-	gint i;
-	gint j;
+	gint k;
 	gint l;
 	gint n=0;
-	gint N[2] = {contours.N[0],contours.N[1]};
-	PointsContour** pointscontour= contours.pointscontour;
 	gdouble C1[3];
 	gdouble C2[3];
 	gchar* temp;
 
-	for(i=1;i<N[0]-2;i++)
+	for(k=0;k<contoursPlane->nLines;k++)
 	{
-		for(j=1;j<N[1]-2;j++)
-		{
-				for(n=0;n<pointscontour[i][j].N-1;n++)
-				{
-					for(l=0;l<3;l++) C1[l] = pointscontour[i][j].point[n].C[l] + Gap[l];
-					for(l=0;l<3;l++) C2[l] = pointscontour[i][j].point[n+1].C[l] + Gap[l];
-					temp = get_pov_cylingre(C1,C2,Color, 1.0);
-					fprintf(file,"%s",temp);
-					g_free(temp);
-				}
+		ContourLine* line = &contoursPlane->lines[k];
+		gint nSegments = line->closed ? line->N : line->N-1;
 
+		if(Ncontours>1) set_Color_From_colorMap(colorMap, Color, values[line->level]);
+		for(n=0;n<nSegments;n++)
+		{
+			for(l=0;l<3;l++) C1[l] = line->point[n].C[l] + Gap[l];
+			for(l=0;l<3;l++) C2[l] = line->point[(n+1)%line->N].C[l] + Gap[l];
+			temp = get_pov_cylingre(C1,C2,Color, 1.0);
+			fprintf(file,"%s",temp);
+			g_free(temp);
 		}
 	}
 }
@@ -189,15 +186,13 @@ static ColorMap* get_colorMap_contours()
 	return colorMap;
 }
 /*********************************************************************************************************/
-static gint addOneContoursPovRay(FILE* file, Grid* plansgrid,gint Ncontours,gdouble*values,gint i0,gint i1,gint numplan,gdouble gap)
+static gint addOneContoursPovRay(FILE* file, Grid* plansgrid,ContoursPlane* contoursPlane,gint Ncontours,gdouble*values,gint i0,gint i1,gint numplan,gdouble gap)
 {
-	Contours contours;
-	gint i;
 	gdouble *Gap;
 	V4d Color = {0.7,0.7,0.7};
 	ColorMap* colorMap = get_colorMap_contours();
 
-	if(!plansgrid) return 1;
+	if(!plansgrid || !contoursPlane) return 1;
 	Gap = GetGapVector(plansgrid,i0,i1,numplan,gap);
 
 
@@ -211,13 +206,7 @@ static gint addOneContoursPovRay(FILE* file, Grid* plansgrid,gint Ncontours,gdou
 		Color[2] = 0.8;
 	}
 
-	for(i=0;i<Ncontours;i++)
-	{
-		if(Ncontours>1) set_Color_From_colorMap(colorMap, Color, values[i]);
-		contours = get_contours(plansgrid,values[i],i0,i1,numplan);
-		AddContoursPovRay(file,contours,Gap,Color);
-		contour_point_free(contours);
-	}
+	AddContoursPovRay(file,contoursPlane,Gap,Ncontours,values,colorMap,Color);
 	g_free(Gap);
 	return 0;
 
@@ -225,18 +214,33 @@ static gint addOneContoursPovRay(FILE* file, Grid* plansgrid,gint Ncontours,gdou
 /********************************************************************************/
 gint addContoursPovRay(Grid* plansgrid,gint Ncontours,gdouble* values,gint i0,gint i1,gint numplan,gdouble gap)
 {
-	gchar* fileName = g_strdup_printf("%s%stmp%spovrayContours.pov",gabedit_directory(),G_DIR_SEPARATOR_S,G_DIR_SEPARATOR_S);
-	FILE* file = fopen(fileName,"a");
+	gint plane[3] = {i0, i1, numplan};
+	ContoursPlane* contoursPlane = NULL;
+	gint res;
+
+	if(Ncontours<1) return 1;
+	contoursPlane = get_contours_planes(plansgrid,Ncontours,values,1,plane);
+	res = addContoursPlanesPovRay(plansgrid,contoursPlane,Ncontours,values,1,plane,gap);
+	contours_planes_free(contoursPlane,1);
+	return res;
+}
+/********************************************************************************/
+/* contoursPlanes : computed by get_contours_planes for the nPlanes planes */
+gint addContoursPlanesPovRay(Grid* plansgrid,ContoursPlane* contoursPlanes,gint Ncontours,gdouble* values,gint nPlanes,gint* planes,gdouble gap)
+{
+	gchar* fileName = NULL;
+	FILE* file = NULL;
+	gint k;
+
+	if(Ncontours<1 || !contoursPlanes) return 1;
+	fileName = g_strdup_printf("%s%stmp%spovrayContours.pov",gabedit_directory(),G_DIR_SEPARATOR_S,G_DIR_SEPARATOR_S);
+	file = fopen(fileName,"a");
 	g_free(fileName);
 	if(!file) return 1;
-	if(Ncontours>0)
-	{
-		addOneContoursPovRay(file, plansgrid,Ncontours,values,i0,i1,numplan,gap);
-		fclose(file);
-		return 0;
-	}
-	else return 1;
-	return 1;
+	for(k=0;k<nPlanes;k++)
+		addOneContoursPovRay(file, plansgrid,&contoursPlanes[k],Ncontours,values,planes[3*k],planes[3*k+1],planes[3*k+2],gap);
+	fclose(file);
+	return 0;
 }
 /********************************************************************************/
 void deleteContoursPovRayFile()
@@ -1,8 +1,10 @@
 
 #ifndef __GABEDIT_CONTOURSPOV_H__
 #define __GABEDIT_CONTOURSPOV_H__
+#include "../Display/Contours.h"
 
 gint addContoursPovRay(Grid* plansgrid,gint Ncontours,gdouble* values,gint i0,gint i1,gint numplan,gdouble gap);
+gint addContoursPlanesPovRay(Grid* plansgrid,ContoursPlane* contoursPlanes,gint Ncontours,gdouble* values,gint nPlanes,gint* planes,gdouble gap);
 void deleteContoursPovRayFile();
 
 #endif /* __GABEDIT_CONTOURSPOV_H__ */
@@ -7,7 +7,8 @@ GeomOrbXYZ.o: GeomOrbXYZ.c ../../Config.h GlobalOrb.h \
  ../Geometry/../Common/GabeditType.h ../Geometry/OpenBabel.h \
  ../Utils/Utils.h ../Utils/UtilsGL.h ../Utils/Vector3d.h \
  ../Utils/Transformation.h GLArea.h StatusOrb.h AtomicOrbitals.h \
- BondsOrb.h
+ BondsOrb.h \
+ ../Utils/FChkFile.h
 BondsOrb.o: BondsOrb.c ../../Config.h GlobalOrb.h \
  ../Files/GabeditFileChooser.h ../../gl2ps/gl2ps.h Grid.h \
  ../MultiGrid/PoissonMG.h ../MultiGrid/GridMG.h ../MultiGrid/DomainMG.h \
@@ -43,20 +44,27 @@ UtilsOrb.o: UtilsOrb.c ../../Config.h ../Display/GlobalOrb.h \
  ../Utils/UtilsInterface.h ../Utils/Constants.h ../Common/Windows.h \
  ../Display/Vibration.h ../Display/ContoursPov.h \
  ../Display/PlanesMappedPov.h ../Display/GridCube.h ../Display/GridCP.h \
- ../Display/ColorMap.h ../Display/LabelsGL.h
+ ../Display/ColorMap.h ../Display/LabelsGL.h \
+ ../Display/GridAO.h \
+ ../Utils/EigenSolver.h \
+ ../Display/Contours.h
 Basis.o: Basis.c ../../Config.h GlobalOrb.h ../Files/GabeditFileChooser.h \
  ../../gl2ps/gl2ps.h Grid.h ../MultiGrid/PoissonMG.h \
  ../MultiGrid/GridMG.h ../MultiGrid/DomainMG.h ../MultiGrid/TypesMG.h \
  IsoSurface.h ../Common/GabeditType.h UtilsOrb.h ../Utils/Utils.h \
  ../Utils/UtilsInterface.h ../Utils/Constants.h ../Utils/Zlm.h \
- ../Utils/../Common/GabeditType.h ../Utils/GTF.h ../Utils/TTables.h
+ ../Utils/../Common/GabeditType.h ../Utils/GTF.h ../Utils/TTables.h \
+ ../Utils/FChkFile.h
 Grid.o: Grid.c ../../Config.h ../Utils/Constants.h GlobalOrb.h \
  ../Files/GabeditFileChooser.h ../../gl2ps/gl2ps.h Grid.h \
  ../MultiGrid/PoissonMG.h ../MultiGrid/GridMG.h ../MultiGrid/DomainMG.h \
  ../MultiGrid/TypesMG.h IsoSurface.h ../Common/GabeditType.h StatusOrb.h \
  UtilsOrb.h ColorMap.h ../Utils/UtilsInterface.h ../Utils/Utils.h \
  ../Utils/Zlm.h ../Utils/../Common/GabeditType.h ../Utils/MathFunctions.h \
- ../Utils/Zlm.h ../Utils/GTF.h ../Utils/TTables.h ../Utils/QL.h
+ ../Utils/Zlm.h ../Utils/GTF.h ../Utils/TTables.h ../Utils/QL.h \
+ GridAO.h \
+ MEPTreeCode.h \
+ GridPercentile.h
 IsoSurface.o: IsoSurface.c ../../Config.h GlobalOrb.h \
  ../Files/GabeditFileChooser.h ../../gl2ps/gl2ps.h Grid.h \
  ../MultiGrid/PoissonMG.h ../MultiGrid/GridMG.h ../MultiGrid/DomainMG.h \
@@ -80,7 +88,8 @@ GLArea.o: GLArea.c ../../Config.h GlobalOrb.h \
  ContoursDraw.h PlanesMappedDraw.h ContoursPov.h PlanesMappedPov.h \
  SurfacesPov.h Orbitals.h StatusOrb.h GridPlans.h Dipole.h AxisGL.h \
  PrincipalAxisGL.h VibrationDraw.h Images.h PovrayGL.h MenuToolBarGL.h \
- LabelsGL.h RingsOrb.h RingsPov.h
+ LabelsGL.h RingsOrb.h RingsPov.h \
+ Contours.h
 OrbitalsGamess.o: OrbitalsGamess.c ../../Config.h GlobalOrb.h \
  ../Files/GabeditFileChooser.h ../../gl2ps/gl2ps.h Grid.h \
  ../MultiGrid/PoissonMG.h ../MultiGrid/GridMG.h ../MultiGrid/DomainMG.h \
@@ -152,7 +161,8 @@ Orbitals.o: Orbitals.c ../../Config.h GlobalOrb.h \
  ../Utils/GabeditTextEdit.h ../Utils/Constants.h ../Spectrum/DOS.h \
  GeomDraw.h GLArea.h UtilsOrb.h Basis.h GeomOrbXYZ.h AtomicOrbitals.h \
  StatusOrb.h Orbitals.h OrbitalsGamess.h OrbitalsMolpro.h OrbitalsQChem.h \
- OrbitalsNWChem.h OrbitalsMopac.h OrbitalsOrca.h OrbitalsNBO.h wfx.h
+ OrbitalsNWChem.h OrbitalsMopac.h OrbitalsOrca.h OrbitalsNBO.h wfx.h \
+ ../Utils/FChkFile.h
 StatusOrb.o: StatusOrb.c ../../Config.h GlobalOrb.h \
  ../Files/GabeditFileChooser.h ../../gl2ps/gl2ps.h Grid.h \
  ../MultiGrid/PoissonMG.h ../MultiGrid/GridMG.h ../MultiGrid/DomainMG.h \
@@ -214,7 +224,23 @@ GridCube.o: GridCube.c ../../Config.h ../Display/GlobalOrb.h \
  ../Display/UtilsOrb.h ../Utils/Utils.h ../Utils/UtilsInterface.h \
  ../Utils/AtomsProp.h ../Utils/Constants.h ../Display/GLArea.h \
  ../Display/AtomicOrbitals.h ../Display/Orbitals.h ../Display/ColorMap.h \
- ../Display/GeomOrbXYZ.h ../Display/BondsOrb.h
+ ../Display/GeomOrbXYZ.h ../Display/BondsOrb.h \
+ ../Display/GridStore.h \
+ ../Display/GridPercentile.h
+GridAO.o: GridAO.c ../../Config.h GlobalOrb.h \
+ ../Files/GabeditFileChooser.h ../../gl2ps/gl2ps.h Grid.h \
+ ../MultiGrid/PoissonMG.h ../MultiGrid/GridMG.h ../MultiGrid/DomainMG.h \
+ ../MultiGrid/TypesMG.h IsoSurface.h ../Common/GabeditType.h StatusOrb.h \
+ GridAO.h
+BatchOrbitals.o: BatchOrbitals.c ../../Config.h GlobalOrb.h \
+ ../Files/GabeditFileChooser.h ../../gl2ps/gl2ps.h ../Utils/Utils.h \
+ ../Utils/UtilsInterface.h UtilsOrb.h Grid.h GLArea.h Orbitals.h \
+ LabelsGL.h Images.h BatchOrbitals.h
+GridStore.o: GridStore.c ../../Config.h GlobalOrb.h \
+ ../Files/GabeditFileChooser.h ../../gl2ps/gl2ps.h Grid.h \
+ ../MultiGrid/PoissonMG.h ../MultiGrid/GridMG.h ../MultiGrid/DomainMG.h \
+ ../MultiGrid/TypesMG.h IsoSurface.h ../Common/GabeditType.h StatusOrb.h \
+ ../Utils/Utils.h GridStore.h
 GridAdfOrbitals.o: GridAdfOrbitals.c ../../Config.h GlobalOrb.h \
  ../Files/GabeditFileChooser.h ../../gl2ps/gl2ps.h Grid.h \
  ../MultiGrid/PoissonMG.h ../MultiGrid/GridMG.h ../MultiGrid/DomainMG.h \
@@ -276,7 +302,8 @@ Vibration.o: Vibration.c ../../Config.h GlobalOrb.h \
  ../Display/PovrayGL.h ../Display/BondsOrb.h ../Display/UtilsOrb.h \
  ../Display/PrincipalAxisGL.h ../Display/VibrationLocal.h \
  ../Display/../Display/Vibration.h ../Utils/GabeditTextEdit.h \
- ../Common/Windows.h
+ ../Common/Windows.h \
+ ../Utils/FChkFile.h
 VibrationDraw.o: VibrationDraw.c ../../Config.h ../Display/GlobalOrb.h \
  ../Display/../Files/GabeditFileChooser.h ../Display/../../gl2ps/gl2ps.h \
  ../Display/Grid.h ../Display/../MultiGrid/PoissonMG.h \
@@ -372,7 +399,8 @@ AnimationGeomConv.o: AnimationGeomConv.c ../../Config.h GlobalOrb.h \
  ../Files/FolderChooser.h ../Files/GabeditFolderChooser.h \
  ../Common/Help.h ../Common/StockIcons.h ../Display/PovrayGL.h \
  ../Display/Images.h ../Display/UtilsOrb.h ../Display/BondsOrb.h \
- ../Display/RingsOrb.h ../Utils/GabeditXYPlot.h ../../pixmaps/Open.xpm
+ ../Display/RingsOrb.h ../Utils/GabeditXYPlot.h ../../pixmaps/Open.xpm \
+ ../Utils/LogIndex.h
 AnimationMD.o: AnimationMD.c ../../Config.h ../Common/Global.h \
  ../Common/../Files/GabeditFileChooser.h \
  ../Common/../Common/GabeditType.h GlobalOrb.h \
@@ -475,7 +503,8 @@ MenuToolBarGL.o: MenuToolBarGL.c ../../Config.h GlobalOrb.h \
  ../Display/IntegralOrbitals.h ../Display/ReactivityIndices.h \
  ../Display/BondsOrb.h ../Display/TriangleDraw.h \
  ../Display/../Utils/Vector3d.h ../Display/../Utils/Transformation.h \
- ../Display/NCI.h ../Common/StockIcons.h
+ ../Display/NCI.h ../Common/StockIcons.h \
+ ../Common/Preferences.h
 LabelsGL.o: LabelsGL.c ../../Config.h ../Common/Global.h \
  ../Common/../Files/GabeditFileChooser.h \
  ../Common/../Common/GabeditType.h GlobalOrb.h \
@@ -494,7 +523,8 @@ RingsOrb.o: RingsOrb.c ../../Config.h GlobalOrb.h \
  ../Utils/Vector3d.h ../Utils/Transformation.h ../Utils/Utils.h \
  ../Utils/UtilsGL.h ../Utils/Vector3d.h ../Utils/Transformation.h \
  ../Utils/UtilsInterface.h ../Utils/Constants.h ../Utils/HydrogenBond.h \
- ../Display/RingsPov.h ../Display/UtilsOrb.h
+ ../Display/RingsPov.h ../Display/UtilsOrb.h \
+ ../Display/RingsPerception.h
 ExportGL.o: ExportGL.c ../../Config.h GlobalOrb.h \
  ../Files/GabeditFileChooser.h ../../gl2ps/gl2ps.h Grid.h \
  ../MultiGrid/PoissonMG.h ../MultiGrid/GridMG.h ../MultiGrid/DomainMG.h \
@@ -521,7 +551,8 @@ CaptureOrbitals.o: CaptureOrbitals.c ../../Config.h \
  ../Utils/Utils.h ../Utils/UtilsInterface.h ../Utils/Constants.h \
  ../Files/FileChooser.h ../Common/Windows.h ../Display/Vibration.h \
  ../Display/ContoursPov.h ../Display/PlanesMappedPov.h \
- ../Display/LabelsGL.h ../Display/Images.h
+ ../Display/LabelsGL.h ../Display/Images.h \
+ ../Display/Contours.h
 IntegralOrbitals.o: IntegralOrbitals.c ../../Config.h \
  ../Display/GlobalOrb.h ../Display/../Files/GabeditFileChooser.h \
  ../Display/../../gl2ps/gl2ps.h ../Display/Grid.h \
@@ -538,7 +569,9 @@ IntegralOrbitals.o: IntegralOrbitals.c ../../Config.h \
  ../Utils/GabeditTextEdit.h ../Files/FileChooser.h ../Common/Windows.h \
  ../Display/Vibration.h ../Display/ContoursPov.h \
  ../Display/PlanesMappedPov.h ../Display/LabelsGL.h \
- ../Display/StatusOrb.h
+ ../Display/StatusOrb.h \
+ ../Display/PopulationAnalysis.h \
+ ../Display/Contours.h
 GridCP.o: GridCP.c ../../Config.h ../Display/GlobalOrb.h \
  ../Display/../Files/GabeditFileChooser.h ../Display/../../gl2ps/gl2ps.h \
  ../Display/Grid.h ../Display/../MultiGrid/PoissonMG.h \
@@ -562,13 +595,35 @@ AnimationGrids.o: AnimationGrids.c ../../Config.h GlobalOrb.h \
  ../Geometry/../Common/GabeditType.h ../Files/FolderChooser.h \
  ../Files/GabeditFolderChooser.h ../Common/Help.h ../Common/StockIcons.h \
  ../Display/PovrayGL.h ../Display/Images.h ../Display/UtilsOrb.h \
- ../Display/BondsOrb.h
+ ../Display/BondsOrb.h \
+ GridStore.h
 NCI.o: NCI.c ../../Config.h ../Utils/Constants.h GlobalOrb.h \
  ../Files/GabeditFileChooser.h ../../gl2ps/gl2ps.h Grid.h \
  ../MultiGrid/PoissonMG.h ../MultiGrid/GridMG.h ../MultiGrid/DomainMG.h \
  ../MultiGrid/TypesMG.h IsoSurface.h ../Common/GabeditType.h StatusOrb.h \
  UtilsOrb.h ColorMap.h ../Utils/GabeditXYPlot.h ../Utils/UtilsInterface.h \
  ../Utils/Utils.h ../Display/Grid.h ../Display/Orbitals.h
+MEPTreeCode.o: MEPTreeCode.c ../../Config.h GlobalOrb.h \
+ ../Files/GabeditFileChooser.h ../../gl2ps/gl2ps.h Grid.h \
+ ../MultiGrid/PoissonMG.h ../MultiGrid/GridMG.h ../MultiGrid/DomainMG.h \
+ ../MultiGrid/TypesMG.h IsoSurface.h ../Common/GabeditType.h StatusOrb.h \
+ ../Display/MEPTreeCode.h
+GridPercentile.o: GridPercentile.c ../../Config.h GlobalOrb.h \
+ ../Files/GabeditFileChooser.h ../../gl2ps/gl2ps.h Grid.h \
+ ../MultiGrid/PoissonMG.h ../MultiGrid/GridMG.h ../MultiGrid/DomainMG.h \
+ ../MultiGrid/TypesMG.h IsoSurface.h ../Common/GabeditType.h StatusOrb.h \
+ ../Display/GridPercentile.h
+PopulationAnalysis.o: PopulationAnalysis.c ../../Config.h GlobalOrb.h \
+ ../Files/GabeditFileChooser.h ../../gl2ps/gl2ps.h Grid.h \
+ ../MultiGrid/PoissonMG.h ../MultiGrid/GridMG.h ../MultiGrid/DomainMG.h \
+ ../MultiGrid/TypesMG.h IsoSurface.h ../Common/GabeditType.h StatusOrb.h \
+ UtilsOrb.h ../Utils/Constants.h ../Utils/GTF.h \
+ ../Display/PopulationAnalysis.h
+RingsPerception.o: RingsPerception.c ../../Config.h GlobalOrb.h \
+ ../Files/GabeditFileChooser.h ../../gl2ps/gl2ps.h Grid.h \
+ ../MultiGrid/PoissonMG.h ../MultiGrid/GridMG.h ../MultiGrid/DomainMG.h \
+ ../MultiGrid/TypesMG.h IsoSurface.h ../Common/GabeditType.h \
+ ../Display/RingsPerception.h
 ReactivityIndices.o: ReactivityIndices.c ../../Config.h \
  ../Display/GlobalOrb.h ../Display/../Files/GabeditFileChooser.h \
  ../Display/../../gl2ps/gl2ps.h ../Display/Grid.h \
@@ -585,7 +640,8 @@ ReactivityIndices.o: ReactivityIndices.c ../../Config.h \
  ../Utils/GabeditTextEdit.h ../Files/FileChooser.h ../Common/Windows.h \
  ../Display/Vibration.h ../Display/ContoursPov.h \
  ../Display/PlanesMappedPov.h ../Display/LabelsGL.h \
- ../Display/StatusOrb.h
+ ../Display/StatusOrb.h \
+ ../Display/Contours.h
 wfx.o: wfx.c ../../Config.h GlobalOrb.h ../Files/GabeditFileChooser.h \
  ../../gl2ps/gl2ps.h Grid.h ../MultiGrid/PoissonMG.h \
  ../MultiGrid/GridMG.h ../MultiGrid/DomainMG.h ../MultiGrid/TypesMG.h \
@@ -230,7 +230,7 @@ void compute_total_dipole()
 	if(!grid)
 	{
 		GtkWidget* message =Message(_("Sorry, Grid not defined "),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
 	z = compute_nuclear_dipole(DN);
@@ -395,7 +395,7 @@ void compute_charge_transfer_dipole()
 	if(!grid)
 	{
 		GtkWidget* message =Message(_("Sorry, Grid not defined "),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
 	if(!get_charge_transfer_centers(grid, CN, CP, &QCTm, &QCTp,&H)) return;
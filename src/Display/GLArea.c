@@ -38,6 +38,7 @@ DEALINGS IN THE SOFTWARE.
 #include "GeomOrbXYZ.h"
 #include "Basis.h"
 #include "TriangleDraw.h"
+#include "Contours.h"
 #include "ContoursDraw.h"
 #include "PlanesMappedDraw.h"
 #include "ContoursPov.h"
@@ -90,6 +91,8 @@ static gint numberOfContours = 0;
 static gdouble* values = NULL;
 static gint optcol = 0;
 static gint nPlanesContours = 0;
+static gint nNewPlanesContours = 0;
+static gint* newPlanesContours = NULL; /* triples (i0, i1, numplan) of the planes added by set_contours_values_planes */
 static gint nPlanesMapped = 0;
 static gboolean newPlaneMapped = FALSE;
 static gint newPlaneGridForContours = FALSE;
@@ -571,6 +574,9 @@ void add_void_contours()
 /*********************************************************************************************/
 void set_contours_values(gint N,gdouble* cvalues,gint ii0,gint ii1,gint inumPlane,gdouble igap)
 {
+	if(newPlanesContours) g_free(newPlanesContours);
+	newPlanesContours = NULL;
+	nNewPlanesContours = 0;
 	if(values) g_free(values);
 	values = cvalues;
 	numberOfContours = N;
@@ -588,6 +594,32 @@ void set_contours_values(gint N,gdouble* cvalues,gint ii0,gint ii1,gint inumPlan
 	/* Debug("End set_contours_values\n");*/
 	reDrawContoursPlane = TRUE;
 }
+/*********************************************************************************************/
+/* planes : nPlanes triples (i0, i1, numplan) of the grid, freed here. The contours of all the planes are computed together at the next redraw */
+void set_contours_values_planes(gint N,gdouble* cvalues,gint nPlanes,gint* planes,gdouble igap)
+{
+	gint k;
+	set_contours_values(0,NULL,0,1,0,0.0);
+	if(nPlanes<1 || !planes || !cvalues)
+	{
+		if(planes) g_free(planes);
+		if(cvalues) g_free(cvalues);
+		return;
+	}
+	values = cvalues;
+	numberOfContours = N;
+	i0Contours = planes[3*(nPlanes-1)];
+	i1Contours = planes[3*(nPlanes-1)+1];
+	numPlaneContours = planes[3*(nPlanes-1)+2];
+	gapContours = igap;
+	newPlanesContours = planes;
+	nNewPlanesContours = nPlanes;
+	newContours = TRUE;
+	contoursLists = g_realloc(contoursLists,(nPlanesContours+nPlanes)*sizeof(GLuint));
+	for(k=0;k<nPlanes;k++) contoursLists[nPlanesContours+k] = 0;
+	nPlanesContours += nPlanes;
+	reDrawContoursPlane = TRUE;
+}
 /********************************************************/
 void set_contours_values_from_plane(gdouble minv,gdouble maxv,gint N,gdouble igap, gboolean linear)
 {
@@ -955,6 +987,16 @@ static void redrawContours()
 			}
 			
 		}
+		else if(nNewPlanesContours>0)
+		{
+			ContoursPlane* contoursPlanes = get_contours_planes(grid,numberOfContours,values,nNewPlanesContours,newPlanesContours);
+			ContoursGenListsPlanes(&contoursLists[nPlanesContours-nNewPlanesContours],grid,contoursPlanes,numberOfContours,values,nNewPlanesContours,newPlanesContours,gapContours);
+			addContoursPlanesPovRay(grid,contoursPlanes,numberOfContours,values,nNewPlanesContours,newPlanesContours,gapContours);
+			contours_planes_free(contoursPlanes,nNewPlanesContours);
+			g_free(newPlanesContours);
+			newPlanesContours = NULL;
+			nNewPlanesContours = 0;
+		}
 		else
 		{
 	   		contoursLists[nPlanesContours-1]= ContoursGenLists(contoursLists[nPlanesContours-1],grid,numberOfContours,values,i0Contours,i1Contours,numPlaneContours,gapContours);
@@ -1050,8 +1092,11 @@ static void createImagesFiles()
 		if(createBMPFiles)
 		{
 			gchar* message;
+			gchar* exportError = NULL;
 			gchar* t = g_strdup_printf("The %s%sgab%d.bmp file was created",get_last_directory(),G_DIR_SEPARATOR_S,numBMPFile);
 			message = new_bmp(get_last_directory(), ++numBMPFile);
+			/* the file is written by the export pool : it must be on disk before we say so */
+			if(message == NULL) message = exportError = wait_images_export();
 			if(message == NULL) setTextInProgress(t);
 			else
 			{
@@ -1059,16 +1104,19 @@ static void createImagesFiles()
 				createBMPFiles = FALSE;
 				numBMPFile = 0;
     				m = Message(message,"Error",TRUE);
-				gtk_window_set_modal (GTK_WINDOW (m), TRUE);
+				if(m) gtk_window_set_modal (GTK_WINDOW (m), TRUE);
 			}
+			if(exportError) g_free(exportError);
 			g_free(t);
 
 		}
 		if(createPPMFiles)
 		{
 			gchar* message;
+			gchar* exportError = NULL;
 			gchar* t = g_strdup_printf("The %s%sgab%d.ppm file was created",get_last_directory(),G_DIR_SEPARATOR_S,numPPMFile);
 			message = new_ppm(get_last_directory(), ++numPPMFile);
+			if(message == NULL) message = exportError = wait_images_export();
 			if(message == NULL)
 				setTextInProgress(t);
 			else
@@ -1077,8 +1125,9 @@ static void createImagesFiles()
 				createPPMFiles = FALSE;
 				numPPMFile = 0;
     				m = Message(message,"Error",TRUE);
-				gtk_window_set_modal (GTK_WINDOW (m), TRUE);
+				if(m) gtk_window_set_modal (GTK_WINDOW (m), TRUE);
 			}
+			if(exportError) g_free(exportError);
 			g_free(t);
 
 		}
@@ -1094,7 +1143,7 @@ static void createImagesFiles()
 				createPOVFiles = FALSE;
 				numPOVFile = 0;
     				m = Message(message,"Error",TRUE);
-				gtk_window_set_modal (GTK_WINDOW (m), TRUE);
+				if(m) gtk_window_set_modal (GTK_WINDOW (m), TRUE);
 			}
 			g_free(t);
 
@@ -1102,43 +1151,35 @@ static void createImagesFiles()
 		if(!createBMPFiles && !createPPMFiles && !createPOVFiles) setTextInProgress(" ");
 }
 /*****************************************************************************/
-gint redrawGL2PS(void)
+static void draw_scene(gdouble glwidth, gdouble glheight)
 {
-	if (!GLArea || !GTK_IS_WIDGET(GLArea)) return TRUE;
-	if (!gtk_widget_get_realized(GTK_WIDGET(GLArea))) return TRUE;
-	if (!make_glarea_context_current(GLArea)) return FALSE;
-
 	GLdouble m[4][4];
-	gdouble glwidth = gtk_widget_get_allocated_width(GLArea);
-	gdouble glheight = gtk_widget_get_allocated_height(GLArea);
 
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
 	addFog();
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	set_background_color();
 
-
-	mYPerspective(45,(GLdouble)glwidth / (GLdouble)glheight, 1, 100);
-    glMatrixMode(GL_MODELVIEW);
+	mYPerspective(45,(GLdouble)glwidth/(GLdouble)glheight,1,100);
+	glMatrixMode(GL_MODELVIEW);
 	glLoadIdentity();
-	if(optcol == -1) drawChecker();
+	if(optcol==-1) drawChecker();
 
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
 	if(perspective)
 		mYPerspective(Zoom,(GLdouble)glwidth/(GLdouble)glheight,zNear,zFar);
 	else
 	{
-	  	gdouble fw = (GLdouble)glwidth / (GLdouble)glheight;
+	  	gdouble fw = (GLdouble)glwidth/(GLdouble)glheight;
 	  	gdouble fh = 1.0;
 		glOrtho(-fw,fw,-fh,fh,-1,1);
 	}
 
-    glMatrixMode(GL_MODELVIEW);
+	glMatrixMode(GL_MODELVIEW);
 	glLoadIdentity();
-	if(perspective)
-		glTranslatef(Trans[0],Trans[1],Trans[2]);
+	if(perspective) glTranslatef(Trans[0],Trans[1],Trans[2]);
 	else
 	{
 		 glTranslatef(Trans[0]/10,Trans[1]/10,0);
@@ -1160,6 +1201,27 @@ gint redrawGL2PS(void)
 	if(get_show_axes()) showLabelAxes(ft2_context);
 	if(get_show_axes()) showLabelPrincipalAxes(ft2_context);
 	showLabelTitle(glwidth, glheight, ft2_context);
+}
+/*****************************************************************************/
+/* draw in the current GL context, used for the off-screen rendering ; init = TRUE for a new context */
+void draw_scene_gl(gint width, gint height, gboolean init)
+{
+	if(init) InitGL();
+	glViewport(0,0, (GLsizei)width, (GLsizei)height);
+	draw_scene(width, height);
+	glFinish();
+}
+/*****************************************************************************/
+gint redrawGL2PS(void)
+{
+	if (!GLArea || !GTK_IS_WIDGET(GLArea)) return TRUE;
+	if (!gtk_widget_get_realized(GTK_WIDGET(GLArea))) return TRUE;
+	if (!make_glarea_context_current(GLArea)) return FALSE;
+
+	gdouble glwidth = gtk_widget_get_allocated_width(GLArea);
+	gdouble glheight = gtk_widget_get_allocated_height(GLArea);
+
+	draw_scene(glwidth, glheight);
 
 	/* Swap backbuffer to front */
 	glFlush();
@@ -1178,56 +1240,10 @@ static gint redraw(GtkWidget *widget, gpointer data)
 
 	if (!make_glarea_context_current(GLArea)) return FALSE;
 
-	GLdouble m[4][4];
 	gdouble glwidth = gtk_widget_get_allocated_width(GLArea);
 	gdouble glheight = gtk_widget_get_allocated_height(GLArea);
 
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-	addFog();
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	set_background_color();
-
-	mYPerspective(45,(GLdouble)glwidth/(GLdouble)glheight,1,100);
-    glMatrixMode(GL_MODELVIEW);
-	glLoadIdentity();
-	if(optcol==-1) drawChecker();
-
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-	if(perspective)
-		mYPerspective(Zoom,(GLdouble)glwidth/(GLdouble)glheight,zNear,zFar);
-	else
-	{
-	  	gdouble fw = (GLdouble)glwidth/(GLdouble)glheight;
-	  	gdouble fh = 1.0;
-		glOrtho(-fw,fw,-fh,fh,-1,1);
-	}
-
-    glMatrixMode(GL_MODELVIEW);
-	glLoadIdentity();
-	if(perspective) glTranslatef(Trans[0],Trans[1],Trans[2]);
-	else
-	{
-		 glTranslatef(Trans[0]/10,Trans[1]/10,0);
-		 glScalef(1/Zoom*2,1/Zoom*2,1/Zoom*2);
-	}
-	SetLight();
-
-	build_rotmatrix(m,Quat);
-	glMultMatrixd(&m[0][0]);
-
-	redrawGeometry();
-	redrawSurfaces();
-	redrawBox();
-	redrawContours();
-	redrawPlanesMapped();
-	if(get_show_symbols() || get_show_numbers() || get_show_charges()) showLabelSymbolsNumbersCharges(ft2_context);
-	if(get_show_dipole()) showLabelDipole(ft2_context);
-	if(get_show_distances()) showLabelDistances(ft2_context);
-	if(get_show_axes()) showLabelAxes(ft2_context);
-	if(get_show_axes()) showLabelPrincipalAxes(ft2_context);
-	showLabelTitle(glwidth, glheight, ft2_context);
+	draw_scene(glwidth, glheight);
 
 	glFlush ();
 	
@@ -55,6 +55,7 @@ void add_maps(gint ii0, gint ii1, gint inumplan, gdouble igap, gboolean newGrid)
 void set_contours_values_from_plane(gdouble minv,gdouble maxv,gint N,gdouble gap, gboolean linear);
 void add_void_contours();
 void set_contours_values(gint N,gdouble* cvalues,gint ii0,gint ii1,gint inumplan,gdouble gap);
+void set_contours_values_planes(gint N,gdouble* cvalues,gint nPlanes,gint* planes,gdouble gap);
 void add_objects_for_new_grid();
 void add_surface();
 void set_background_optcolor(gint i);
@@ -71,6 +72,7 @@ void free_objects_all();
 void rafresh_window_orb();
 void rotationAboutAnAxis(GtkWidget *widget, gdouble phi, gint axe);
 gint redrawGL2PS();
+void draw_scene_gl(gint width, gint height, gboolean init);
 
 #endif /* __GABEDIT_GLAREA_H__ */
 
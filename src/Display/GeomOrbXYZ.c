@@ -29,6 +29,7 @@ DEALINGS IN THE SOFTWARE.
 #include "../Geometry/GeomGlobal.h"
 #include "../Geometry/OpenBabel.h"
 #include "../Utils/Utils.h"
+#include "../Utils/FChkFile.h"
 #include "../Utils/UtilsGL.h"
 #include "GLArea.h"
 #include "StatusOrb.h"
@@ -2504,7 +2505,7 @@ gboolean gl_read_gaussn_file_geomi(gchar *FileName,gint num)
 /********************************************************************************/
 gboolean gl_read_fchk_gaussn_file_geom(gchar *fileName)
 {
- 	FILE *file;
+ 	FChkFile *file;
 	gint i,j;
 	gint n;
 	gchar* tmp = NULL;
@@ -2514,29 +2515,32 @@ gboolean gl_read_fchk_gaussn_file_geom(gchar *fileName)
 	gint* z = NULL;
 	gdouble* zn = NULL;
 
-	file = FOpen(fileName, "rb");
+	file = new_fchk_gaussian_file(fileName);
 	if(file ==NULL)
 	{
   		Message(_("Sorry\nI can not open this file"),_("Error"),TRUE);
   		return FALSE;
 	}
 
-	j = get_one_int_from_fchk_gaussian_file(file,"Number of atoms ");
+	j = get_one_int_from_fchk(file,"Number of atoms ");
 	if(j<1)
 	{
   		Message(_("Sorry\nI can not the number of atoms from this file"),_("Error"),TRUE);
+		free_fchk_gaussian_file(file);
   		return FALSE;
 	}
-	z = get_array_int_from_fchk_gaussian_file(file, "Atomic numbers ", &n);
+	z = get_array_int_from_fchk(file, "Atomic numbers ", &n);
 	if(n!=j)
 	{
   		Message(_("Sorry\nI can not read the atomic numbers from this file"),_("Error"),TRUE);
+		free_fchk_gaussian_file(file);
   		return FALSE;
 	}
-	coords = get_array_real_from_fchk_gaussian_file(file, "Current cartesian coordinates  ", &n);
+	coords = get_array_real_from_fchk(file, "Current cartesian coordinates  ", &n);
 	if(n!=3*j)
 	{
   		Message(_("Sorry\nI can not read the current cartesian coordinates from this file"),_("Error"),TRUE);
+		free_fchk_gaussian_file(file);
   		return FALSE;
 	}
 	free_data_all();
@@ -2545,7 +2549,6 @@ gboolean gl_read_fchk_gaussn_file_geom(gchar *fileName)
 	g_free(tmp);
 	set_status_label_info(_("File type"),"Gaussian fchk");
 	set_status_label_info(_("Geometry"),_("Reading"));
-	rewind(file);
 	nCenters = j;
 
     	GeomOrb=g_malloc(nCenters*sizeof(TypeGeomOrb));
@@ -2562,8 +2565,7 @@ gboolean gl_read_fchk_gaussn_file_geom(gchar *fileName)
 	if(coords) g_free(coords);
 	z = NULL;
 	coords = NULL;
-	rewind(file);
-	charges = get_array_real_from_fchk_gaussian_file(file, "NPA Charges ", &n);
+	charges = get_array_real_from_fchk(file, "NPA Charges ", &n);
 	if(n==nCenters && charges)
 	{
 		for(j=0;j<nCenters;j++)
@@ -2572,8 +2574,7 @@ gboolean gl_read_fchk_gaussn_file_geom(gchar *fileName)
 	}
 	else
 	{
-		rewind(file);
-		charges = get_array_real_from_fchk_gaussian_file(file, "ESP Charges  ", &n);
+		charges = get_array_real_from_fchk(file, "ESP Charges  ", &n);
 		if(n==nCenters && charges) 
 		{
 			for(j=0;j<nCenters;j++)
@@ -2581,8 +2582,7 @@ gboolean gl_read_fchk_gaussn_file_geom(gchar *fileName)
 		}
 		else
 		{
-			rewind(file);
-			charges = get_array_real_from_fchk_gaussian_file(file, "Mulliken Charges  ", &n);
+			charges = get_array_real_from_fchk(file, "Mulliken Charges  ", &n);
 			if(n==nCenters && charges) 
 			{
 				for(j=0;j<nCenters;j++)
@@ -2591,8 +2591,7 @@ gboolean gl_read_fchk_gaussn_file_geom(gchar *fileName)
 			if(charges) g_free(charges);
 		}
 	}
-	rewind(file);
-	zn = get_array_real_from_fchk_gaussian_file(file, "Nuclear charges ", &n);
+	zn = get_array_real_from_fchk(file, "Nuclear charges ", &n);
 	if(zn && n== j)
 	{
 		for(j=0;j<nCenters;j++)
@@ -2602,9 +2601,10 @@ gboolean gl_read_fchk_gaussn_file_geom(gchar *fileName)
 	if(n!=j)
 	{
   		Message(_("Sorry\nI can not read the atomic numbers from this file"),_("Error"),TRUE);
+		free_fchk_gaussian_file(file);
   		return FALSE;
 	}
-	dipole = get_array_real_from_fchk_gaussian_file(file, "Dipole Moment  ", &n);
+	dipole = get_array_real_from_fchk(file, "Dipole Moment  ", &n);
 	init_dipole();
 	if(n==3)
 	{
@@ -2613,7 +2613,7 @@ gboolean gl_read_fchk_gaussn_file_geom(gchar *fileName)
 
 	}
 	if(dipole) g_free(dipole);
- 	fclose(file);
+ 	free_fchk_gaussian_file(file);
  	if(nCenters == 0 ) g_free(GeomOrb);
  	else DefineType();
 	buildBondsOrb();
@@ -93,3 +93,4 @@ gboolean createPOVFiles;
 gint numPOVFile;
 gdouble solventRadius;
 gdouble alphaFED;
+gdouble gridAOMaxMemory;
@@ -124,5 +124,6 @@ extern gboolean createPOVFiles;
 extern gint numPOVFile;
 extern gdouble solventRadius;
 extern gdouble alphaFED;
+extern gdouble gridAOMaxMemory; /* MB, cache of the basis functions on the grid, 0 : no cache */
 #endif /* __GABEDIT_GLOBALORB_H__ */
 
@@ -35,6 +35,9 @@ DEALINGS IN THE SOFTWARE.
 #include "../Utils/MathFunctions.h"
 #include "../Utils/GTF.h"
 #include "../Utils/QL.h"
+#include "GridAO.h"
+#include "MEPTreeCode.h"
+#include "GridPercentile.h"
 
 /* the extern variable of Grid.h */
 GridLimits limits;
@@ -403,6 +406,8 @@ Grid* free_grid(Grid* localGrid)
 	gint i,j;
 	gboolean id = (localGrid==grid);
 	if(!localGrid) return NULL;
+	reset_iso_surface_index(localGrid);
+	reset_grid_percentile(localGrid);
 	for(i=0;i< localGrid->N[0] ;i++)
 	{
 		for(j=0;j< localGrid->N[1] ;j++)
@@ -412,7 +417,7 @@ Grid* free_grid(Grid* localGrid)
 	g_free(localGrid->point);
 	g_free(localGrid);
 	localGrid=NULL;
-	if(id)
+	if(id && PrincipalWindow)
 	{
 		GtkWidget* handleBoxColorMapGrid = g_object_get_data(G_OBJECT(PrincipalWindow), "HandleboxColorMapGrid ");
 		color_map_hide(handleBoxColorMapGrid);
@@ -676,6 +681,47 @@ Grid* define_grid_point(gint N[],GridLimits limits,Func3d func)
 	return grid;
 }
 /**************************************************************/
+/* density (spin=FALSE) or spin density (spin=TRUE) from the basis functions cached on the grid.
+ * Same orbitals and weights as get_value_electronic_density and get_value_spin_density.
+ */
+static Grid* define_grid_density_using_grid_ao(gint N[],GridLimits limits, gboolean spin)
+{
+	Grid* grid = NULL;
+	gint* typeOrbs = NULL;
+	gint* numOrbs = NULL;
+	gdouble* weights = NULL;
+	gint nOrbs = 0;
+	gint k;
+
+	if(NAlphaOrb+NBetaOrb<1) return NULL;
+	typeOrbs = g_malloc((NAlphaOrb+NBetaOrb)*sizeof(gint));
+	numOrbs = g_malloc((NAlphaOrb+NBetaOrb)*sizeof(gint));
+	weights = g_malloc((NAlphaOrb+NBetaOrb)*sizeof(gdouble));
+	for(k=0;k<NAlphaOrb;k++)
+	{
+		if(OccAlphaOrbitals[k]<=1e-8) continue;
+		if(spin && k>=NAlphaOcc) continue;
+		typeOrbs[nOrbs] = 1;
+		numOrbs[nOrbs] = k;
+		weights[nOrbs] = OccAlphaOrbitals[k];
+		nOrbs++;
+	}
+	for(k=0;k<NBetaOrb;k++)
+	{
+		if(OccBetaOrbitals[k]<=1e-8) continue;
+		if(spin && k>=NBetaOcc) continue;
+		typeOrbs[nOrbs] = 2;
+		numOrbs[nOrbs] = k;
+		weights[nOrbs] = (spin)?-OccBetaOrbitals[k]:OccBetaOrbitals[k];
+		nOrbs++;
+	}
+	if(nOrbs>0) grid = define_grid_orbitals_density_using_grid_ao(N, limits, nOrbs, typeOrbs, numOrbs, weights);
+	g_free(typeOrbs);
+	g_free(numOrbs);
+	g_free(weights);
+	return grid;
+}
+/**************************************************************/
 Grid* define_grid(gint N[],GridLimits limits)
 {
 	Grid *grid = NULL;
@@ -685,10 +731,12 @@ Grid* define_grid(gint N[],GridLimits limits)
 	switch(TypeGrid)
 	{
 		case GABEDIT_TYPEGRID_ORBITAL :
-			grid = define_grid_point(N,limits,get_value_orbital);
+			grid = define_grid_orbital_using_grid_ao(N,limits,TypeSelOrb,NumSelOrb);
+			if(!grid && !CancelCalcul) grid = define_grid_point(N,limits,get_value_orbital);
 			break;
 		case GABEDIT_TYPEGRID_EDENSITY :
-			grid = define_grid_point(N,limits,get_value_electronic_density);
+			grid = define_grid_density_using_grid_ao(N,limits,FALSE);
+			if(!grid && !CancelCalcul) grid = define_grid_point(N,limits,get_value_electronic_density);
 			break;
 		case GABEDIT_TYPEGRID_DDENSITY :
 			grid = define_grid_point(N,limits,get_value_electronic_density_bonds);
@@ -697,7 +745,8 @@ Grid* define_grid(gint N[],GridLimits limits)
 			grid = define_grid_point(N,limits,get_value_electronic_density_atomic);
 			break;
 		case GABEDIT_TYPEGRID_SDENSITY :
-			grid = define_grid_point(N,limits,get_value_spin_density);
+			grid = define_grid_density_using_grid_ao(N,limits,TRUE);
+			if(!grid && !CancelCalcul) grid = define_grid_point(N,limits,get_value_spin_density);
 			break;
 		case GABEDIT_TYPEGRID_ELFBECKE :
 			grid = define_grid_point(N,limits,get_value_elf_becke);
@@ -761,7 +810,8 @@ Grid* define_grid_electronic_density(gint N[],GridLimits limits)
 	g_free(t);
 	CancelCalcul = FALSE;
 	TypeGrid = GABEDIT_TYPEGRID_EDENSITY;
-	grid = define_grid_point(N,limits,get_value_electronic_density);
+	grid = define_grid_density_using_grid_ao(N,limits,FALSE);
+	if(!grid && !CancelCalcul) grid = define_grid_point(N,limits,get_value_electronic_density);
 	TypeGrid = TypeGridOld;
 	if(grid) set_status_label_info(_("Grid"),_("Ok"));
 	else set_status_label_info(_("Grid"),_("Nothing"));
@@ -834,7 +884,8 @@ Grid* define_grid_orb(gint N[],GridLimits limits, gint typeOrb, gint i)
 	TypeGrid = GABEDIT_TYPEGRID_ORBITAL;
 	TypeSelOrb = typeOrb;
 	NumSelOrb = i;
-	grid = define_grid_point(N,limits,get_value_orbital);
+	grid = define_grid_orbital_using_grid_ao(N,limits,typeOrb,i);
+	if(!grid && !CancelCalcul) grid = define_grid_point(N,limits,get_value_orbital);
 	TypeGrid = TypeGridOld;
 	TypeSelOrb = TypeSelOrbOld;
 	NumSelOrb = NumSelOrbOld;
@@ -2320,86 +2371,56 @@ static void define_xyz_grid(Grid*grid)
 	}
 }
 /*********************************************************************************/
+static MEPTreeCode* new_mep_treecode_from_geometry(gboolean nuclear)
+{
+	gdouble* xyz = g_malloc((3*nCenters+1)*sizeof(gdouble));
+	gdouble* q = g_malloc((nCenters+1)*sizeof(gdouble));
+	MEPTreeCode* tree = NULL;
+	gint n;
+
+	for(n=0;n<nCenters;n++)
+	{
+		xyz[3*n] = GeomOrb[n].C[0];
+		xyz[3*n+1] = GeomOrb[n].C[1];
+		xyz[3*n+2] = GeomOrb[n].C[2];
+		q[n] = (nuclear)?GeomOrb[n].nuclearCharge:GeomOrb[n].partialCharge;
+	}
+	tree = newMEPTreeCode(nCenters, xyz, q, get_treecode_theta());
+	g_free(xyz);
+	g_free(q);
+	return tree;
+}
+/*********************************************************************************/
+static Grid* add_mep_of_charges_to_grid(Grid* esp, gboolean nuclear)
+{
+	MEPTreeCode* tree = new_mep_treecode_from_geometry(nuclear);
+	gboolean ok = addMEPTreeCodeToGrid(tree, esp);
+
+	freeMEPTreeCode(tree);
+	if(!ok) return free_grid(esp);
+	reset_limits_for_grid(esp);
+	return esp;
+}
+/*********************************************************************************/
 Grid* compute_mep_grid_using_partial_charges_cube_grid(Grid* grid)
 {
 	gint i;
 	gint j;
 	gint k;
-	gdouble x;
-	gdouble y;
-	gdouble z;
-	gdouble r;
-	/* gdouble temp;*/
-	gdouble PRECISION = 1e-13;
 	Grid* esp = NULL;
-	gdouble invR = 1.0;
-	gdouble v;
-	gint n;
-	gboolean beg = TRUE;
-	gdouble scale;
 
 	if(!grid) return NULL;
 	esp = grid_point_alloc(grid->N,grid->limits);
-
-	progress_orb(0,GABEDIT_PROGORB_COMPMEPGRID,TRUE);
-	scale = (gdouble)1.01/grid->N[0];
 	for(i=0;i<grid->N[0];i++)
+	for(j=0;j<grid->N[1];j++)
+	for(k=0;k<grid->N[2];k++)
 	{
-		for(j=0;j<grid->N[1];j++)
-		{
-			for(k=0;k<grid->N[2];k++)
-			{
-				x = grid->point[i][j][k].C[0];
-				y = grid->point[i][j][k].C[1];
-				z = grid->point[i][j][k].C[2];
-
-				esp->point[i][j][k].C[0] = x;
-				esp->point[i][j][k].C[1] = y;
-				esp->point[i][j][k].C[2] = z;
-
-				r = sqrt(x*x +  y*y + z*z+PRECISION);
-				invR = 1.0 /r;
-				/* temp = esp->point[i][j][k].C[3];*/
-				x *= invR;
-				y *= invR;
-				z *= invR;
-				v = 0;
-				for(n=0;n<nCenters;n++)
-				{
-					x = esp->point[i][j][k].C[0]-GeomOrb[n].C[0];
-					y = esp->point[i][j][k].C[1]-GeomOrb[n].C[1];
-					z = esp->point[i][j][k].C[2]-GeomOrb[n].C[2];
-					r = sqrt(x*x +  y*y + z*z+PRECISION);
-					invR = 1.0 /r;
-					v+= invR*GeomOrb[n].partialCharge;
-				}
-				esp->point[i][j][k].C[3]=v;
-				if(beg)
-				{
-					beg = FALSE;
-        				esp->limits.MinMax[0][3] =  v;
-        				esp->limits.MinMax[1][3] =  v;
-				}
-                		else
-				{
-        				if(esp->limits.MinMax[0][3]>v) esp->limits.MinMax[0][3] =  v;
-        				if(esp->limits.MinMax[1][3]<v) esp->limits.MinMax[1][3] =  v;
-				}
-			}
-		}
-		if(CancelCalcul) 
-		{
-			progress_orb(0,GABEDIT_PROGORB_COMPMEPGRID,TRUE);
-			break;
-		}
-		progress_orb(scale,GABEDIT_PROGORB_COMPMEPGRID,FALSE);
-	}
-	if(CancelCalcul)
-	{
-		esp = free_grid(esp);
+		esp->point[i][j][k].C[0] = grid->point[i][j][k].C[0];
+		esp->point[i][j][k].C[1] = grid->point[i][j][k].C[1];
+		esp->point[i][j][k].C[2] = grid->point[i][j][k].C[2];
+		esp->point[i][j][k].C[3] = 0;
 	}
-	return esp;
-
+	return add_mep_of_charges_to_grid(esp, FALSE);
 }
 /*********************************************************************************/
 Grid* compute_mep_grid_using_partial_charges(gint N[], GridLimits limits)
@@ -2407,77 +2428,15 @@ Grid* compute_mep_grid_using_partial_charges(gint N[], GridLimits limits)
 	gint i;
 	gint j;
 	gint k;
-	gdouble x;
-	gdouble y;
-	gdouble z;
-	gdouble r;
-	/* gdouble temp;*/
-	gdouble PRECISION = 1e-13;
 	Grid* esp = NULL;
-	gdouble invR = 1.0;
-	gdouble v;
-	gint n;
-	gboolean beg = TRUE;
-	gdouble scale;
 
 	esp = grid_point_alloc(N,limits);
 	define_xyz_grid(esp);
-
-	progress_orb(0,GABEDIT_PROGORB_COMPMEPGRID,TRUE);
-	scale = (gdouble)1.01/N[0];
 	for(i=0;i<N[0];i++)
-	{
-		for(j=0;j<N[1];j++)
-		{
-			for(k=0;k<N[2];k++)
-			{
-				x = esp->point[i][j][k].C[0];
-				y = esp->point[i][j][k].C[1];
-				z = esp->point[i][j][k].C[2];
-
-				r = sqrt(x*x +  y*y + z*z+PRECISION);
-				invR = 1.0 /r;
-				/* temp = esp->point[i][j][k].C[3];*/
-				x *= invR;
-				y *= invR;
-				z *= invR;
-				v = 0;
-				for(n=0;n<nCenters;n++)
-				{
-					x = esp->point[i][j][k].C[0]-GeomOrb[n].C[0];
-					y = esp->point[i][j][k].C[1]-GeomOrb[n].C[1];
-					z = esp->point[i][j][k].C[2]-GeomOrb[n].C[2];
-					r = sqrt(x*x +  y*y + z*z+PRECISION);
-					invR = 1.0 /r;
-					v+= invR*GeomOrb[n].partialCharge;
-				}
-				esp->point[i][j][k].C[3]=v;
-				if(beg)
-				{
-					beg = FALSE;
-        				esp->limits.MinMax[0][3] =  v;
-        				esp->limits.MinMax[1][3] =  v;
-				}
-                		else
-				{
-        				if(esp->limits.MinMax[0][3]>v) esp->limits.MinMax[0][3] =  v;
-        				if(esp->limits.MinMax[1][3]<v) esp->limits.MinMax[1][3] =  v;
-				}
-			}
-		}
-		if(CancelCalcul) 
-		{
-			progress_orb(0,GABEDIT_PROGORB_COMPMEPGRID,TRUE);
-			break;
-		}
-		progress_orb(scale,GABEDIT_PROGORB_COMPMEPGRID,FALSE);
-	}
-	if(CancelCalcul)
-	{
-		esp = free_grid(esp);
-	}
-	return esp;
-
+	for(j=0;j<N[1];j++)
+	for(k=0;k<N[2];k++)
+		esp->point[i][j][k].C[3] = 0;
+	return add_mep_of_charges_to_grid(esp, FALSE);
 }
 /*********************************************************/
 static void getCOff(Grid* grid, gdouble* pxOff, gdouble* pyOff, gdouble* pzOff)
@@ -2538,8 +2497,6 @@ Grid* compute_mep_grid_using_multipol_from_density_grid(Grid* grid, gint lmax)
 	gdouble invR = 1.0;
 	gdouble v;
 	Zlm** slm = NULL;
-	gint n;
-	gboolean beg = TRUE;
 	gdouble scale;
 	gdouble xOff=0, yOff=0, zOff=0;
 
@@ -2579,8 +2536,12 @@ Grid* compute_mep_grid_using_multipol_from_density_grid(Grid* grid, gint lmax)
 
 	progress_orb(0,GABEDIT_PROGORB_COMPMEPGRID,TRUE);
 	scale = (gdouble)1.01/grid->N[0];
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(i,j,k,l,m,x,y,z,r,invR,temp,v)
+#endif
 	for(i=0;i<grid->N[0];i++)
 	{
+		if(!CancelCalcul)
 		for(j=0;j<grid->N[1];j++)
 		{
 			for(k=0;k<grid->N[2];k++)
@@ -2599,7 +2560,6 @@ Grid* compute_mep_grid_using_multipol_from_density_grid(Grid* grid, gint lmax)
 
 				r = sqrt(x*x +  y*y + z*z+PRECISION);
 				invR = 1.0 /r;
-				temp = grid->point[i][j][k].C[3];
 				x *= invR;
 				y *= invR;
 				z *= invR;
@@ -2613,36 +2573,21 @@ Grid* compute_mep_grid_using_multipol_from_density_grid(Grid* grid, gint lmax)
 						v += temp*getValueZlm(&slm[l][m+l],x,y,z)*Q[l][m+l];
 					}
 				}
-				for(n=0;n<nCenters;n++)
-				{
-					x = grid->point[i][j][k].C[0]-GeomOrb[n].C[0];
-					y = grid->point[i][j][k].C[1]-GeomOrb[n].C[1];
-					z = grid->point[i][j][k].C[2]-GeomOrb[n].C[2];
-					r = sqrt(x*x +  y*y + z*z+PRECISION);
-					invR = 1.0 /r;
-					v+= invR*GeomOrb[n].nuclearCharge;
-				}
 				esp->point[i][j][k].C[3]=v;
-				if(beg)
-				{
-					beg = FALSE;
-        				esp->limits.MinMax[0][3] =  v;
-        				esp->limits.MinMax[1][3] =  v;
-				}
-                		else
-				{
-        				if(esp->limits.MinMax[0][3]>v) esp->limits.MinMax[0][3] =  v;
-        				if(esp->limits.MinMax[1][3]<v) esp->limits.MinMax[1][3] =  v;
-				}
 			}
 		}
-		if(CancelCalcul) 
-		{
-			progress_orb(0,GABEDIT_PROGORB_COMPMEPGRID,TRUE);
-			break;
-		}
+#ifdef ENABLE_OMP
+#ifndef G_OS_WIN32
+#pragma omp critical
 		progress_orb(scale,GABEDIT_PROGORB_COMPMEPGRID,FALSE);
+#endif
+#else
+		progress_orb(scale,GABEDIT_PROGORB_COMPMEPGRID,FALSE);
+#endif
 	}
+	progress_orb(0,GABEDIT_PROGORB_COMPMEPGRID,TRUE);
+	/* nuclear charges */
+	if(!CancelCalcul) esp = add_mep_of_charges_to_grid(esp, TRUE);
 	if(Q)
 	{
 		for(l=0;l<=lmax;l++)
@@ -2693,7 +2638,6 @@ Grid* solve_poisson_equation_from_density_grid(Grid* grid, PoissonSolverMethod p
 	gint Nx, Ny, Nz;
 	LaplacianOrderMG laplacianOrder= GABEDIT_LAPLACIAN_2;
 	/* LaplacianOrderMG laplacianOrder= GABEDIT_LAPLACIAN_4;*/
-	gdouble PRECISION = 1e-13;
 
 	if(!test_grid_all_positive(grid))
 	{
@@ -2763,25 +2707,10 @@ Grid* solve_poisson_equation_from_density_grid(Grid* grid, PoissonSolverMethod p
 	for(i=0;i<esp->N[0];i++)
 		for(j=0;j<esp->N[1];j++)
 			for(k=0;k<esp->N[2];k++)
-			{
-				gdouble v = 0;
-				gint n;
-				gdouble x,y,z,r,invR;
-				for(n=0;n<nCenters;n++)
-				{
-					x = esp->point[i][j][k].C[0]-GeomOrb[n].C[0];
-					y = esp->point[i][j][k].C[1]-GeomOrb[n].C[1];
-					z = esp->point[i][j][k].C[2]-GeomOrb[n].C[2];
-					r = sqrt(x*x +  y*y + z*z+PRECISION);
-					invR = 1.0 /r;
-					v+= invR*GeomOrb[n].nuclearCharge;
-				}
-				esp->point[i][j][k].C[3] = v-getValGridMG(ps->potential, i, j, k);
-			}
+				esp->point[i][j][k].C[3] = -getValGridMG(ps->potential, i, j, k);
 	destroyPoissonMG(ps); /* destroy of source and potential Grid */
-	reset_limits_for_grid(esp);
-
-	return esp;
+	/* nuclear charges */
+	return add_mep_of_charges_to_grid(esp, TRUE);
 }
 /*********************************************************************************/
 Grid* solve_poisson_equation_from_orbitals(gint N[],GridLimits limits, PoissonSolverMethod psMethod)
@@ -2804,7 +2733,6 @@ Grid* compute_mep_grid_exact(gint N[],GridLimits limits)
 {
 	gint i;
 	Grid* esp = NULL;
-	gboolean beg = TRUE;
 	gdouble scale;
 	gdouble V0[3];
 	gdouble V1[3];
@@ -2853,11 +2781,6 @@ Grid* compute_mep_grid_exact(gint N[],GridLimits limits)
 		gdouble x;
 		gdouble y;
 		gdouble z;
-		gdouble r;
-		gdouble PRECISION = 1e-13;
-		gdouble invR = 1.0;
-		gdouble v;
-		gint n;
 		gdouble* XkXl = g_malloc(NAOrb*(NAOrb+1)/2*sizeof(gdouble));
 		if(!CancelCalcul)
 		for(j=0;j<esp->N[1];j++)
@@ -2871,19 +2794,7 @@ Grid* compute_mep_grid_exact(gint N[],GridLimits limits)
 				esp->point[i][j][k].C[0] = x;
 				esp->point[i][j][k].C[1] = y;
 				esp->point[i][j][k].C[2] = z;
-				v = 0;
-				v = get_value_electrostatic_potential( x, y, z, XkXl);
-
-				for(n=0;n<nCenters;n++)
-				{
-					x = esp->point[i][j][k].C[0]-GeomOrb[n].C[0];
-					y = esp->point[i][j][k].C[1]-GeomOrb[n].C[1];
-					z = esp->point[i][j][k].C[2]-GeomOrb[n].C[2];
-					r = sqrt(x*x +  y*y + z*z+PRECISION);
-					invR = 1.0 /r;
-					v+= invR*GeomOrb[n].nuclearCharge;
-				}
-				esp->point[i][j][k].C[3]=v;
+				esp->point[i][j][k].C[3] = get_value_electrostatic_potential( x, y, z, XkXl);
 			}
 		}
 #ifndef G_OS_WIN32
@@ -2895,37 +2806,12 @@ Grid* compute_mep_grid_exact(gint N[],GridLimits limits)
 #endif
 	}
 	if(CancelCalcul) 
-		progress_orb(0,GABEDIT_PROGORB_COMPMEPGRID,TRUE);
-	if(!CancelCalcul)
-	for(i=0;i<esp->N[0];i++)
 	{
-		gint j;
-		gint k;
-		gdouble v;
-		for(j=0;j<esp->N[1];j++)
-		{
-			for(k=0;k<esp->N[2];k++)
-			{
-				v = esp->point[i][j][k].C[3];
-				if(beg)
-				{
-					beg = FALSE;
-        				esp->limits.MinMax[0][3] =  v;
-        				esp->limits.MinMax[1][3] =  v;
-				}
-                		else
-				{
-        				if(esp->limits.MinMax[0][3]>v) esp->limits.MinMax[0][3] =  v;
-        				if(esp->limits.MinMax[1][3]<v) esp->limits.MinMax[1][3] =  v;
-				}
-			}
-		}
-	}
-	if(CancelCalcul)
-	{
-		esp = free_grid(esp);
+		progress_orb(0,GABEDIT_PROGORB_COMPMEPGRID,TRUE);
+		return free_grid(esp);
 	}
-	return esp;
+	/* nuclear charges */
+	return add_mep_of_charges_to_grid(esp, TRUE);
 
 }
 /*********************************************************************************/
@@ -2953,7 +2839,6 @@ gboolean compute_coulomb_integrale_iijj_poisson(gint N[],GridLimits limits, gint
 	gdouble xx,yy,zz;
 	gdouble integ = 0;
 	gdouble dv = 0;
-	gdouble PRECISION = 1e-10;
 
 	*pInteg = -1;
 	*pNorm = -1;
@@ -3000,6 +2885,15 @@ gboolean compute_coulomb_integrale_iijj_poisson(gint N[],GridLimits limits, gint
 
 	set_status_label_info(_("Grid"),_("Computing of Coulomb int."));
 	potential = solve_poisson_equation_from_density_grid(gridi, GABEDIT_MG);
+	/* potential of the nuclei minus the potential of phi_i^2 */
+	if(potential && !CancelCalcul)
+	{
+		for(k=0;k<potential->N[0];k++)
+		for(l=0;l<potential->N[1];l++)
+		for(m=0;m<potential->N[2];m++)
+			potential->point[k][l][m].C[3] = -potential->point[k][l][m].C[3];
+		potential = add_mep_of_charges_to_grid(potential, TRUE);
+	}
 	if(CancelCalcul || !potential) 
 	{
 		free_grid(gridi);
@@ -3014,21 +2908,7 @@ gboolean compute_coulomb_integrale_iijj_poisson(gint N[],GridLimits limits, gint
 	{
 		for(l=0;l<gridi->N[1];l++)
 		for(m=0;m<gridi->N[2];m++)
-		{
-			gdouble v = 0;
-			gint n;
-			gdouble x,y,z,r,invR;
-			for(n=0;n<nCenters;n++)
-			{
-				x = potential->point[k][l][m].C[0]-GeomOrb[n].C[0];
-				y = potential->point[k][l][m].C[1]-GeomOrb[n].C[1];
-				z = potential->point[k][l][m].C[2]-GeomOrb[n].C[2];
-				r = sqrt(x*x +  y*y + z*z+PRECISION);
-				invR = 1.0 /r;
-				v+= invR*GeomOrb[n].nuclearCharge;
-			}
-			integ += -(potential->point[k][l][m].C[3]-v)*gridj->point[k][l][m].C[3];
-		}
+			integ += potential->point[k][l][m].C[3]*gridj->point[k][l][m].C[3];
 		if(CancelCalcul) 
 		{
 			progress_orb(0,GABEDIT_PROGORB_COMPINTEG,TRUE);
@@ -3431,46 +3311,32 @@ gboolean compute_integrale_from_grid_foranisovalue(Grid* grid, gboolean square,
 	return TRUE;
 }
 /**************************************************************/
-gboolean compute_isovalue_percent_from_grid(Grid* grid, gboolean square, gdouble percent, gdouble precision, gdouble* pIsovalue)
+gboolean compute_isovalue_percent_from_grid(Grid* grid, gboolean square, gdouble percent, gdouble* pIsovalue)
 {
+	GridPercentile* gp = NULL;
 	gdouble integAll = 0;
-	gdouble integ = 0;
-	gdouble isoMin = 0;
-	gdouble isoMax = 0;
-	gdouble iso = 0;
-	gchar tmp[BSIZE];
+	gdouble dv = 0;
+	gdouble xx,yy,zz;
 
 	if(!grid) return FALSE;
 	if(CancelCalcul) return FALSE;
 	if(percent>100) percent = 100;
 	if(percent<0) percent = 0;
-	if(precision<1e-10) precision = 1e-3;
-
-	if(!compute_integrale_from_grid(grid, square, &integAll)) return FALSE;
-	/* printf("integAll = %f\n",integAll);*/
-	if(integAll<1e-10) return FALSE;
 
 	if(square) set_status_label_info(_("Grid"),_("Comp. integ f^2(x,y,z) dv from grid"));
 	else set_status_label_info(_("Grid"),_("Comp. integ f(,xy,z) dv from grid"));
+	gp = get_grid_percentile(grid, square);
+	if(!gp) return FALSE;
 
-        isoMax = fabs(limits.MinMax[1][3]);
-	/*
-	printf("isoMin = %f\n",isoMin);
-	printf("isoMax = %f\n",isoMax);
-	*/
-	while(fabs(isoMax-isoMin)>precision)
-	{
-		iso = (isoMax+isoMin)/2;
-		sprintf(tmp,_("Computing integrale for isovalue = %f, (IsoMax-IsoMin) = %f, precision = %f"),iso, fabs(isoMax-isoMin),precision);
-		set_status_label_info(_("Grid"),tmp);
-		if(!compute_integrale_from_grid_foranisovalue(grid, square, iso, &integ)) return FALSE;
-		/* printf("iso = %f %%=%f\n",iso,integ/integAll*100);*/
-		if(integ/integAll*100<percent) isoMax = iso;
-		else isoMin = iso;
-	}	
-	if(CancelCalcul) return FALSE;
-
-	*pIsovalue = iso;
+	xx = grid->point[1][0][0].C[0]-grid->point[0][0][0].C[0];
+	yy = grid->point[0][1][0].C[1]-grid->point[0][0][0].C[1];
+	zz = grid->point[0][0][1].C[2]-grid->point[0][0][0].C[2];
+	dv = fabs(xx*yy*zz);
+	integAll = getGridPercentileTotal(gp)*dv;
+	/* printf("integAll = %f\n",integAll);*/
+	if(integAll<1e-10) return FALSE;
+	/* the isovalue is a value of the grid */
+	*pIsovalue = getGridPercentileIsovalue(gp, percent);
 	return TRUE;
 }
 /*********************************************************************************************************************************/
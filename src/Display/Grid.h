@@ -81,7 +81,7 @@ gboolean compute_spatial_overlapiijj_numeric(gint N[],GridLimits limits, gint ty
 		gdouble* pInteg, gdouble* pNormi, gdouble* pNormj, gdouble* pOverlap);
 gboolean compute_spatial_overlapij_numeric(gint N[],GridLimits limits, gint typeOrbi, gint i, gint typeOrbj, gint j,
 		gdouble* pInteg, gdouble* pNormi, gdouble* pNormj, gdouble* pOverlap);
-gboolean compute_isovalue_percent_from_grid(Grid* grid, gboolean square, gdouble percent, gdouble precision, gdouble* pIsovalue);
+gboolean compute_isovalue_percent_from_grid(Grid* grid, gboolean square, gdouble percent, gdouble* pIsovalue);
 Grid* copyGrid(Grid* grid);
 Grid* compute_mep_grid_exact(gint N[],GridLimits limits);
 Grid* compute_mep_grid_using_orbitals(gint N[],GridLimits limits);
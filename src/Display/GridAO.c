@@ -0,0 +1,453 @@
+/* GridAO.c */
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#include "../../Config.h"
+#ifdef ENABLE_OMP
+#include <omp.h>
+#endif
+#include "GlobalOrb.h"
+#include "StatusOrb.h"
+#include "GridAO.h"
+
+/* values of one basis function in the box begin..end (inclusive) of the grid, NULL if the box is empty */
+typedef struct _GridAOBlock
+{
+	gint begin[3];
+	gint end[3];
+	gdouble* values;
+}GridAOBlock;
+
+typedef struct _GridAO
+{
+	guint64 key;
+	gint N[3];
+	gint nAO;
+	gsize size;
+	GridAOBlock* blocks;
+}GridAO;
+
+/* one cache for the current basis, geometry and grid */
+static GridAO* gridAO = NULL;
+/************************************************************************/
+static void hash_bytes(guint64* h, gconstpointer data, gsize n)
+{
+	const guchar* p = (const guchar*)data;
+	gsize i;
+	for(i=0;i<n;i++)
+	{
+		*h ^= p[i];
+		*h *= G_GUINT64_CONSTANT(1099511628211);
+	}
+}
+/************************************************************************/
+static guint64 get_grid_ao_key(gint N[],GridLimits limits)
+{
+	guint64 h = G_GUINT64_CONSTANT(14695981039346656037);
+	gint i,j,n;
+
+	hash_bytes(&h, N, 3*sizeof(gint));
+	for(j=0;j<2;j++) hash_bytes(&h, limits.MinMax[j], 3*sizeof(gdouble));
+	hash_bytes(&h, firstDirection, 3*sizeof(gdouble));
+	hash_bytes(&h, secondDirection, 3*sizeof(gdouble));
+	hash_bytes(&h, thirdDirection, 3*sizeof(gdouble));
+	hash_bytes(&h, &NAOrb, sizeof(gint));
+	if(AOrb)
+	for(i=0;i<NAOrb;i++)
+	{
+		hash_bytes(&h, &AOrb[i].numberOfFunctions, sizeof(gint));
+		for(n=0;n<AOrb[i].numberOfFunctions;n++)
+		{
+			hash_bytes(&h, &AOrb[i].Gtf[n].Ex, sizeof(gdouble));
+			hash_bytes(&h, &AOrb[i].Gtf[n].Coef, sizeof(gdouble));
+			hash_bytes(&h, AOrb[i].Gtf[n].l, 3*sizeof(gint));
+			hash_bytes(&h, AOrb[i].Gtf[n].C, 3*sizeof(gdouble));
+		}
+	}
+	else if(SAOrb)
+	for(i=0;i<NAOrb;i++)
+	{
+		hash_bytes(&h, &SAOrb[i].N, sizeof(gint));
+		for(n=0;n<SAOrb[i].N;n++)
+		{
+			hash_bytes(&h, &SAOrb[i].Stf[n].Ex, sizeof(gdouble));
+			hash_bytes(&h, &SAOrb[i].Stf[n].Coef, sizeof(gdouble));
+			hash_bytes(&h, SAOrb[i].Stf[n].l, 3*sizeof(gint));
+			hash_bytes(&h, &SAOrb[i].Stf[n].pqn, sizeof(gint));
+			hash_bytes(&h, SAOrb[i].Stf[n].C, 3*sizeof(gdouble));
+		}
+	}
+	return h;
+}
+/************************************************************************/
+/* same points as define_grid_point : x = firstPoint + i*V0 + j*V1 + k*V2 */
+static void get_grid_vectors(gint N[],GridLimits limits, gdouble firstPoint[], gdouble V0[], gdouble V1[], gdouble V2[])
+{
+	gint i;
+	for(i=0;i<3;i++)
+	{
+		V0[i] = firstDirection[i] *(limits.MinMax[1][0]-limits.MinMax[0][0])/(N[0]-1);
+		V1[i] = secondDirection[i]*(limits.MinMax[1][1]-limits.MinMax[0][1])/(N[1]-1);
+		V2[i] = thirdDirection[i] *(limits.MinMax[1][2]-limits.MinMax[0][2])/(N[2]-1);
+		firstPoint[i] = limits.MinMax[0][i];
+	}
+}
+/************************************************************************/
+static gboolean get_inverse_grid_vectors(gdouble V0[], gdouble V1[], gdouble V2[], gdouble invM[3][3])
+{
+	/* M = (V0 V1 V2) in columns */
+	gdouble det = V0[0]*(V1[1]*V2[2]-V1[2]*V2[1])
+		    - V1[0]*(V0[1]*V2[2]-V0[2]*V2[1])
+		    + V2[0]*(V0[1]*V1[2]-V0[2]*V1[1]);
+	if(fabs(det)<1e-14) return FALSE;
+	invM[0][0] = (V1[1]*V2[2]-V2[1]*V1[2])/det;
+	invM[0][1] = (V2[0]*V1[2]-V1[0]*V2[2])/det;
+	invM[0][2] = (V1[0]*V2[1]-V2[0]*V1[1])/det;
+	invM[1][0] = (V2[1]*V0[2]-V0[1]*V2[2])/det;
+	invM[1][1] = (V0[0]*V2[2]-V2[0]*V0[2])/det;
+	invM[1][2] = (V2[0]*V0[1]-V0[0]*V2[1])/det;
+	invM[2][0] = (V0[1]*V1[2]-V1[1]*V0[2])/det;
+	invM[2][1] = (V1[0]*V0[2]-V0[0]*V1[2])/det;
+	invM[2][2] = (V0[0]*V1[1]-V1[0]*V0[1])/det;
+	return TRUE;
+}
+/************************************************************************/
+/* the primitives are cut at Ex*r^2 > 40 (GTF) or Ex*r > 40 (STF), see get_value_GTF and get_value_STF */
+static gboolean get_box_of_ao(gint i, gint N[], gdouble firstPoint[], gdouble invM[3][3], gint begin[], gint end[])
+{
+	gint n,a,c;
+	gint nPrim = AOrb ? AOrb[i].numberOfFunctions : SAOrb[i].N;
+	gdouble rowNorm[3];
+	gboolean first = TRUE;
+
+	for(a=0;a<3;a++) rowNorm[a] = sqrt(invM[a][0]*invM[a][0]+invM[a][1]*invM[a][1]+invM[a][2]*invM[a][2]);
+	for(n=0;n<nPrim;n++)
+	{
+		gdouble* C = AOrb ? AOrb[i].Gtf[n].C : SAOrb[i].Stf[n].C;
+		gdouble Ex = AOrb ? AOrb[i].Gtf[n].Ex : SAOrb[i].Stf[n].Ex;
+		gdouble r;
+		if(Ex<=0) r = 1e10;
+		else r = AOrb ? sqrt(40.0/Ex) : 40.0/Ex;
+		for(a=0;a<3;a++)
+		{
+			gdouble u = 0;
+			gint lo, hi;
+			for(c=0;c<3;c++) u += invM[a][c]*(C[c]-firstPoint[c]);
+			lo = (gint)MAX(floor(u-r*rowNorm[a]),-1.0);
+			hi = (gint)MIN(ceil(u+r*rowNorm[a]),(gdouble)N[a]);
+			if(first || lo<begin[a]) begin[a] = lo;
+			if(first || hi>end[a]) end[a] = hi;
+		}
+		first = FALSE;
+	}
+	for(a=0;a<3;a++)
+	{
+		if(begin[a]<0) begin[a] = 0;
+		if(end[a]>N[a]-1) end[a] = N[a]-1;
+		if(first || begin[a]>end[a]) return FALSE;
+	}
+	return TRUE;
+}
+/************************************************************************/
+/************************************************************************/
+void free_grid_ao()
+{
+	gint i;
+	if(!gridAO) return;
+	for(i=0;i<gridAO->nAO;i++) if(gridAO->blocks[i].values) g_free(gridAO->blocks[i].values);
+	g_free(gridAO->blocks);
+	g_free(gridAO);
+	gridAO = NULL;
+}
+/************************************************************************/
+static GridAO* new_grid_ao(gint N[],GridLimits limits, guint64 key)
+{
+	GridAO* ao = NULL;
+	gdouble firstPoint[3];
+	gdouble V0[3], V1[3], V2[3];
+	gdouble invM[3][3];
+	gdouble scale;
+	gsize size = 0;
+	gint i;
+
+	get_grid_vectors(N, limits, firstPoint, V0, V1, V2);
+	if(!get_inverse_grid_vectors(V0, V1, V2, invM)) return NULL;
+
+	ao = g_malloc(sizeof(GridAO));
+	ao->key = key;
+	for(i=0;i<3;i++) ao->N[i] = N[i];
+	ao->nAO = NAOrb;
+	ao->blocks = g_malloc0(NAOrb*sizeof(GridAOBlock));
+	for(i=0;i<NAOrb;i++)
+	{
+		GridAOBlock* block = &ao->blocks[i];
+		if(!get_box_of_ao(i, N, firstPoint, invM, block->begin, block->end))
+		{
+			block->begin[0] = 0;
+			block->end[0] = -1;
+			continue;
+		}
+		size += (gsize)(block->end[0]-block->begin[0]+1)*(block->end[1]-block->begin[1]+1)*(block->end[2]-block->begin[2]+1);
+	}
+	ao->size = size;
+	if(size*sizeof(gdouble) > gridAOMaxMemory*1024.0*1024.0)
+	{
+		g_free(ao->blocks);
+		g_free(ao);
+		return NULL;
+	}
+	for(i=0;i<NAOrb;i++)
+	{
+		GridAOBlock* block = &ao->blocks[i];
+		gsize n = (gsize)(block->end[0]-block->begin[0]+1)*(block->end[1]-block->begin[1]+1)*(block->end[2]-block->begin[2]+1);
+		if(block->end[0]<block->begin[0]) continue;
+		block->values = g_try_malloc(n*sizeof(gdouble));
+		if(!block->values) break;
+	}
+	gridAO = ao;
+	if(i<NAOrb)
+	{
+		free_grid_ao();
+		return NULL;
+	}
+
+	progress_orb(0,GABEDIT_PROGORB_COMPGRID,TRUE);
+	scale = (gdouble)1.01/NAOrb;
+#ifdef ENABLE_OMP
+#ifdef G_OS_WIN32
+	setTextInProgress(_("Computing of basis functions on the grid, please wait..."));
+#endif
+#pragma omp parallel for private(i) schedule(dynamic)
+#endif
+	for(i=0;i<NAOrb;i++)
+	{
+		GridAOBlock* block = &ao->blocks[i];
+		if(!CancelCalcul && block->values)
+		{
+			gint ii,jj,kk;
+			gdouble* v = block->values;
+			for(ii=block->begin[0];ii<=block->end[0];ii++)
+			for(jj=block->begin[1];jj<=block->end[1];jj++)
+			for(kk=block->begin[2];kk<=block->end[2];kk++)
+			{
+				gdouble x = firstPoint[0] + ii*V0[0] + jj*V1[0] + kk*V2[0];
+				gdouble y = firstPoint[1] + ii*V0[1] + jj*V1[1] + kk*V2[1];
+				gdouble z = firstPoint[2] + ii*V0[2] + jj*V1[2] + kk*V2[2];
+				*v++ = get_value_CBTF(x,y,z,i);
+			}
+		}
+#ifdef ENABLE_OMP
+#ifndef G_OS_WIN32
+#pragma omp critical
+		progress_orb(scale,GABEDIT_PROGORB_COMPGRID,FALSE);
+#endif
+#else
+		progress_orb(scale,GABEDIT_PROGORB_COMPGRID,FALSE);
+#endif
+	}
+	progress_orb(0,GABEDIT_PROGORB_COMPGRID,TRUE);
+	if(CancelCalcul) free_grid_ao();
+	return gridAO;
+}
+/************************************************************************/
+static GridAO* get_grid_ao(gint N[],GridLimits limits)
+{
+	guint64 key;
+	gint i;
+
+	if((!AOrb && !SAOrb) || NAOrb<1 || gridAOMaxMemory<=0) return NULL;
+	for(i=0;i<3;i++) if(N[i]<2) return NULL;
+	key = get_grid_ao_key(N, limits);
+	if(gridAO && gridAO->key == key && gridAO->nAO == NAOrb) return gridAO;
+	free_grid_ao();
+	return new_grid_ao(N, limits, key);
+}
+/************************************************************************/
+/* coefficients of the orbitals, NULL if one of them does not exist */
+static gdouble** get_orbitals_coefs(gint nOrbs, gint* typeOrbs, gint* numOrbs)
+{
+	gdouble** coefs = NULL;
+	gint k;
+
+	if(nOrbs<1) return NULL;
+	for(k=0;k<nOrbs;k++)
+	{
+		if(typeOrbs[k]==1 && (numOrbs[k]<0 || numOrbs[k]>=NAlphaOrb)) return NULL;
+		if(typeOrbs[k]!=1 && (numOrbs[k]<0 || numOrbs[k]>=NBetaOrb)) return NULL;
+	}
+	coefs = g_malloc(nOrbs*sizeof(gdouble*));
+	for(k=0;k<nOrbs;k++) coefs[k] = (typeOrbs[k]==1)?CoefAlphaOrbitals[numOrbs[k]]:CoefBetaOrbitals[numOrbs[k]];
+	return coefs;
+}
+/************************************************************************/
+/* adds the orbitals k on the plane i to values[k][offset+j*N[2]+k] */
+static void add_orbitals_of_plane(GridAO* ao, gint N[], gint i, gint nOrbs, gdouble** coefs, gdouble** values, gsize offset)
+{
+	gint mu;
+	for(mu=0;mu<ao->nAO;mu++)
+	{
+		GridAOBlock* block = &ao->blocks[mu];
+		gint n1, n2, j, k, l;
+		gdouble* src;
+		if(!block->values || i<block->begin[0] || i>block->end[0]) continue;
+		n1 = block->end[1]-block->begin[1]+1;
+		n2 = block->end[2]-block->begin[2]+1;
+		src = block->values + (gsize)(i-block->begin[0])*n1*n2;
+		for(k=0;k<nOrbs;k++)
+		{
+			gdouble c = coefs[k][mu];
+			if(fabs(c)<=1e-10) continue;
+			for(j=0;j<n1;j++)
+			{
+				gdouble* dst = values[k] + offset + ((gsize)block->begin[1]+j)*N[2]+block->begin[2];
+				gdouble* s = src + (gsize)j*n2;
+				for(l=0;l<n2;l++) dst[l] += c*s[l];
+			}
+		}
+	}
+}
+/************************************************************************/
+/* values[k][(i*N[1]+j)*N[2]+k] : one product of the coefficients by the cached basis functions for all the orbitals */
+static gboolean compute_orbitals_using_grid_ao(gint N[],GridLimits limits, gint nOrbs, gint* typeOrbs, gint* numOrbs, gdouble** values)
+{
+	GridAO* ao = NULL;
+	gdouble** coefs = NULL;
+	gsize nPoints = (gsize)N[0]*N[1]*N[2];
+	gint i,k;
+
+	coefs = get_orbitals_coefs(nOrbs, typeOrbs, numOrbs);
+	if(!coefs) return FALSE;
+	ao = get_grid_ao(N, limits);
+	if(!ao)
+	{
+		g_free(coefs);
+		return FALSE;
+	}
+	for(k=0;k<nOrbs;k++) memset(values[k], 0, nPoints*sizeof(gdouble));
+
+	/* each thread owns a set of planes i, no reduction needed */
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(i)
+#endif
+	for(i=0;i<N[0];i++)
+		add_orbitals_of_plane(ao, N, i, nOrbs, coefs, values, (gsize)i*N[1]*N[2]);
+	g_free(coefs);
+	return TRUE;
+}
+/************************************************************************/
+static Grid* get_grid_from_values(gint N[],GridLimits limits, gdouble* values)
+{
+	Grid* grid = grid_point_alloc(N,limits);
+	gdouble firstPoint[3];
+	gdouble V0[3], V1[3], V2[3];
+	gint i,j,k;
+	gdouble v;
+
+	get_grid_vectors(N, limits, firstPoint, V0, V1, V2);
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(i,j,k)
+#endif
+	for(i=0;i<N[0];i++)
+	for(j=0;j<N[1];j++)
+	for(k=0;k<N[2];k++)
+	{
+		Point5* p = &grid->point[i][j][k];
+		p->C[0] = firstPoint[0] + i*V0[0] + j*V1[0] +  k*V2[0];
+		p->C[1] = firstPoint[1] + i*V0[1] + j*V1[1] +  k*V2[1];
+		p->C[2] = firstPoint[2] + i*V0[2] + j*V1[2] +  k*V2[2];
+		p->C[3] = values[((gsize)i*N[1]+j)*N[2]+k];
+	}
+	v = values[0];
+	grid->limits.MinMax[0][3] = v;
+	grid->limits.MinMax[1][3] = v;
+	for(i=0;i<N[0];i++)
+	for(j=0;j<N[1];j++)
+	for(k=0;k<N[2];k++)
+	{
+		v = grid->point[i][j][k].C[3];
+		if(grid->limits.MinMax[0][3]>v) grid->limits.MinMax[0][3] = v;
+		if(grid->limits.MinMax[1][3]<v) grid->limits.MinMax[1][3] = v;
+	}
+	return grid;
+}
+/************************************************************************/
+Grid* define_grid_orbital_using_grid_ao(gint N[],GridLimits limits, gint typeOrb, gint numOrb)
+{
+	Grid* grid = NULL;
+	gdouble* values = g_try_malloc((gsize)N[0]*N[1]*N[2]*sizeof(gdouble));
+
+	if(!values) return NULL;
+	if(compute_orbitals_using_grid_ao(N, limits, 1, &typeOrb, &numOrb, &values))
+		grid = get_grid_from_values(N, limits, values);
+	g_free(values);
+	return grid;
+}
+/************************************************************************/
+/* sum_k weights[k]*phi_k^2, negative weights give density differences.
+ * The density is accumulated plane by plane : only nBatch orbitals of one plane are kept by thread. */
+Grid* define_grid_orbitals_density_using_grid_ao(gint N[],GridLimits limits, gint nOrbs, gint* typeOrbs, gint* numOrbs, gdouble* weights)
+{
+	Grid* grid = NULL;
+	GridAO* ao = NULL;
+	gsize nPlane = (gsize)N[1]*N[2];
+	gint nBatch = MIN(nOrbs,16);
+	gdouble** coefs = NULL;
+	gdouble* density = NULL;
+	gint i;
+
+	coefs = get_orbitals_coefs(nOrbs, typeOrbs, numOrbs);
+	if(!coefs) return NULL;
+	ao = get_grid_ao(N, limits);
+	if(ao) density = g_try_malloc0(N[0]*nPlane*sizeof(gdouble));
+	if(!density)
+	{
+		g_free(coefs);
+		return NULL;
+	}
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(i)
+#endif
+	for(i=0;i<N[0];i++)
+	{
+		gdouble* buffer = g_malloc(nBatch*nPlane*sizeof(gdouble));
+		gdouble** values = g_malloc(nBatch*sizeof(gdouble*));
+		gdouble* rho = density + (gsize)i*nPlane;
+		gint k, kb;
+
+		for(k=0;k<nBatch;k++) values[k] = buffer + k*nPlane;
+		for(kb=0;kb<nOrbs;kb+=nBatch)
+		{
+			gint nb = MIN(nBatch,nOrbs-kb);
+			gsize p;
+			memset(buffer, 0, nb*nPlane*sizeof(gdouble));
+			add_orbitals_of_plane(ao, N, i, nb, coefs+kb, values, 0);
+			for(k=0;k<nb;k++)
+			{
+				gdouble w = weights[kb+k];
+				gdouble* v = values[k];
+				for(p=0;p<nPlane;p++) rho[p] += w*v[p]*v[p];
+			}
+		}
+		g_free(values);
+		g_free(buffer);
+	}
+	grid = get_grid_from_values(N, limits, density);
+	g_free(density);
+	g_free(coefs);
+	return grid;
+}
@@ -0,0 +1,29 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#ifndef __GABEDIT_GRIDAO_H__
+#define __GABEDIT_GRIDAO_H__
+
+/* values of the basis functions on a grid, each function stored only in the box where it is not negligible */
+Grid* define_grid_orbital_using_grid_ao(gint N[],GridLimits limits, gint typeOrb, gint numOrb);
+/* sum_k weights[k]*phi_k^2 : density, or spin density with negative beta weights */
+Grid* define_grid_orbitals_density_using_grid_ao(gint N[],GridLimits limits, gint nOrbs, gint* typeOrbs, gint* numOrbs, gdouble* weights);
+void free_grid_ao();
+
+#endif /* __GABEDIT_GRIDAO_H__ */
+
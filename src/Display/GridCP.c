@@ -848,8 +848,177 @@ static GList* assentTrajectory(GridCP* gridCP, gint current[3], gboolean ongrid)
 	return listOfVisitedPoints;
 }
 
+/**************************************************************************/
+static gint getSurroundingEqualPoints(GridCP* gridCP, gint current[3], gint* list)
+{
+	gint ic,jc,kc;
+	gint I[3];
+	gint J[3];
+	gint K[3];
+	gint c;
+	gint n = 0;
+	gint* N = gridCP->grid->N;
+	Point5 ***points = gridCP->grid->point;
+	gdouble rho0;
 
+	I[0] = current[0]-1; I[1] = current[0]; I[2] = current[0]+1;
+	J[0] = current[1]-1; J[1] = current[1]; J[2] = current[1]+1;
+	K[0] = current[2]-1; K[1] = current[2]; K[2] = current[2]+1;
+	for(c=0;c<3;c+=2)
+	{
+		if(I[c]<0 || I[c]>N[0]-1) I[c] = current[0];
+		if(J[c]<0 || J[c]>N[1]-1) J[c] = current[1];
+		if(K[c]<0 || K[c]>N[2]-1) K[c] = current[2];
+	}
+	rho0 = points[I[1]][J[1]][K[1]].C[3];
+	for(ic=0;ic<3;ic++)
+	for(jc=0;jc<3;jc++)
+	for(kc=0;kc<3;kc++)
+	{
+		if(ic==1 && jc==1 && kc==1) continue;
+		if(fabs(points[I[ic]][J[jc]][K[kc]].C[3]-rho0)<TOL) 
+			list[n++] = (I[ic]*N[1]+J[jc])*N[2]+K[kc];
+	}
+	return n;
+}
+/**************************************************************************/
+/* On grid, the ascent step depends only on the point.
+ * Each point is linked to its steepest neighbour in parallel, the links are collapsed to the attractors by pointer jumping,
+ * then the scan of assignGridCP is replayed to number the volumes in the same order without storing the trajectories.
+ */
+static void assignGridCPOnGrid(GridCP* gridCP, gchar* str)
+{
+	gint*** vP = gridCP->volumeNumberOfPoints;
+	Point5 ***points = gridCP->grid->point;
+	gint* N = gridCP->grid->N;
+	gint nPoints = N[0]*N[1]*N[2];
+	gint* up = NULL;
+	gint* top = NULL;
+	gint* tmp = NULL;
+	gboolean* dirty = NULL;
+	gint equals[26];
+	gint numberOfCriticalPoints = 0;
+	gboolean changed = TRUE;
+	gdouble scal = 1.1/(N[0]-1);
+	gint i;
+	gint p;
 
+	up = g_malloc(nPoints*sizeof(gint));
+	top = g_malloc(nPoints*sizeof(gint));
+	tmp = g_malloc(nPoints*sizeof(gint));
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(i)
+#endif
+	for(i=0;i<N[0];i++)
+	{
+		gint j,k;
+		gint current[3];
+		gint next[3];
+#ifdef ENABLE_OMP
+#ifndef G_OS_WIN32
+#pragma omp critical
+		progress_orb_txt(scal,str,FALSE);
+#endif
+#else
+		progress_orb_txt(scal,str,FALSE);
+#endif
+		if(!CancelCalcul)
+		for(j=0;j<N[1];j++)
+		for(k=0;k<N[2];k++)
+		{
+			gint ijk = (i*N[1]+j)*N[2]+k;
+			current[0] = i;
+			current[1] = j;
+			current[2] = k;
+			nextPointOnGrid(gridCP, current, next);
+			up[ijk] = (next[0]*N[1]+next[1])*N[2]+next[2];
+			top[ijk] = up[ijk];
+		}
+	}
+	/* the density increases strictly along a link, so this ends after log2(longest trajectory) passes */
+	while(changed && !CancelCalcul)
+	{
+		gint* t;
+		changed = FALSE;
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(p) reduction(||:changed)
+#endif
+		for(p=0;p<nPoints;p++)
+		{
+			tmp[p] = top[top[p]];
+			if(tmp[p] != top[p]) changed = TRUE;
+		}
+		t = top; top = tmp; tmp = t;
+	}
+	g_free(tmp);
+	if(CancelCalcul)
+	{
+		g_free(up);
+		g_free(top);
+		return;
+	}
+	/* assentTrajectory gives to the points equal to an attractor the volume of the last trajectory reaching it.
+	 * The trajectories ending in a volume touched by these points are written entirely, as before.
+	 */
+	dirty = g_malloc0(nPoints*sizeof(gboolean));
+	for(p=0;p<nPoints;p++)
+	{
+		gint current[3];
+		gint n,l;
+		if(up[p] != p) continue;
+		current[0] = p/(N[1]*N[2]);
+		current[1] = (p/N[2])%N[1];
+		current[2] = p%N[2];
+		if(points[current[0]][current[1]][current[2]].C[3]<TOL) continue;
+		n = getSurroundingEqualPoints(gridCP, current, equals);
+		for(l=0;l<n;l++) dirty[top[equals[l]]] = TRUE;
+		if(n>0) dirty[p] = TRUE;
+	}
+	for(i=0;i<N[0];i++)
+	{
+		gint j,k;
+		if(CancelCalcul) break;
+		for(j=0;j<N[1];j++)
+		for(k=0;k<N[2];k++)
+		{
+			gint a;
+			gint current[3];
+			gint icp;
+			gboolean newCP;
+			gint q;
+			gint n,l;
+			if(vP[i][j][k] != 0) continue;
+			if(points[i][j][k].C[3]<TOL) continue;
+
+			p = (i*N[1]+j)*N[2]+k;
+			a = top[p];
+			current[0] = a/(N[1]*N[2]);
+			current[1] = (a/N[2])%N[1];
+			current[2] = a%N[2];
+			icp = abs(vP[current[0]][current[1]][current[2]]);
+			newCP = (icp==0);
+			if(newCP) icp = ++numberOfCriticalPoints;
+			for(q=p;q!=a;q=up[q])
+			{
+				gint* v = &vP[q/(N[1]*N[2])][(q/N[2])%N[1]][q%N[2]];
+				if(*v != 0 && !dirty[a]) break;
+				*v = icp;
+			}
+			n = getSurroundingEqualPoints(gridCP, current, equals);
+			for(l=0;l<n;l++) vP[equals[l]/(N[1]*N[2])][(equals[l]/N[2])%N[1]][equals[l]%N[2]] = icp;
+			if(newCP)
+			{
+				CriticalPoint* data = newCriticalPoint(current[0], current[1], current[2],icp);
+				gridCP->criticalPoints = myg_list_prepend(gridCP->criticalPoints,data);
+				vP[current[0]][current[1]][current[2]] = -icp;
+			}
+			else vP[current[0]][current[1]][current[2]] = icp;
+		}
+	}
+	g_free(up);
+	g_free(top);
+	g_free(dirty);
+}
 
 /**************************************************************************/
 static void assignGridCP(GridCP* gridCP, gboolean ongrid)
@@ -882,6 +1051,13 @@ static void assignGridCP(GridCP* gridCP, gboolean ongrid)
 		if(points[i][j][k].C[3]<TOL) gridCP->known[i][j][k] = 2;
 		*/
 
+	if(ongrid)
+	{
+		assignGridCPOnGrid(gridCP, str);
+		progress_orb_txt(0," ",TRUE);
+		resetKnown(gridCP);
+		return;
+	}
 
 	scal = 1.1/(grid->N[0]-1);
 #ifdef ENABLE_OMP
@@ -32,6 +32,9 @@ DEALINGS IN THE SOFTWARE.
 #include "../Display/ColorMap.h"
 #include "../Display/GeomOrbXYZ.h"
 #include "../Display/BondsOrb.h"
+#include "../Display/GridStore.h"
+#include "../Display/GridPercentile.h"
+#include <sys/stat.h>
 
 typedef enum
 {
@@ -50,10 +53,17 @@ typedef enum
   GABEDIT_CUBE_MOLPRO_LAPLAP
 } GabEditTypeCube;
 
-typedef gboolean  (*FuncGetVal)(FILE*,gint,gint,gint,gdouble []);
-
-Grid* get_grid_from_gauss_molpro_cube_file(gint typefile,FILE* file,gint num,gint n,gint N[],
+Grid* get_grid_from_gauss_molpro_cube_file(gint typefile,FILE* file,gchar* fileName,gint num,gint n,gint N[],
 		gdouble XYZ0[3],gdouble X[3],gdouble Y[3],gdouble Z[3]);
+gboolean read_gabedit_binary_grid_file(gchar* filename, gint numField, gboolean showisowin);
+
+/* all the fields of the last cube file with several orbitals (or blocks) : another orbital is selected without reading the file */
+static GridStore* cubeStore = NULL;
+static gchar* cubeStoreFileName = NULL;
+static GridStoreLayout cubeStoreLayout = GRIDSTORE_FIELDS_BY_POINT;
+static time_t cubeStoreTime = 0;
+static glong cubeStoreOffset = 0;
+static gint cubeStoreField = 0;
 
 /**************************************************************************/
 static void applyRestrictionCube()
@@ -142,6 +152,8 @@ static void applySquareCube()
 	gdouble scal;
 
 	TypeGrid = GABEDIT_TYPEGRID_EDENSITY;
+	reset_iso_surface_index(grid);
+	reset_grid_percentile(grid);
 	progress_orb(0,GABEDIT_PROGORB_SCALEGRID,TRUE);
 	scal = (gdouble)1.01/grid->N[0];
 	for(i=0;i<grid->N[0];i++)
@@ -201,6 +213,8 @@ void scale_cube_file(gdouble factor)
 	gdouble v;
 	gdouble scal;
 
+	reset_iso_surface_index(grid);
+	reset_grid_percentile(grid);
 	progress_orb(0,GABEDIT_PROGORB_SCALEGRID,TRUE);
 	scal = (gdouble)1.01/grid->N[0];
 	for(i=0;i<grid->N[0];i++)
@@ -254,7 +268,7 @@ static void applyScale(GtkWidget *Win,gpointer data)
 	else
 	{
 		GtkWidget* message =Message(_("Error : your value is not a float "),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		if(temp) g_free(temp);
 		return;
 	}
@@ -492,7 +506,7 @@ void subtract_cube_file(gchar* filename)
 		/* printf("%s\n",t);*/
 	}
 
-	tmpGrid = get_grid_from_gauss_molpro_cube_file(0,file,1,1,N,XYZ0,X,Y,Z);
+	tmpGrid = get_grid_from_gauss_molpro_cube_file(0,file,filename,1,1,N,XYZ0,X,Y,Z);
 	if(!tmpGrid)
 	{
 		sprintf(t,_("Sorry, I can not read cube from %s file"),filename);
@@ -500,6 +514,8 @@ void subtract_cube_file(gchar* filename)
 		return;
 	}
 
+	reset_iso_surface_index(grid);
+	reset_grid_percentile(grid);
 	progress_orb(0,GABEDIT_PROGORB_SUBSGRID,TRUE);
 	scal = (gdouble)1.01/grid->N[0];
 	for(i=0;i<grid->N[0];i++)
@@ -752,7 +768,7 @@ void read_mapping_cube_file(gchar* filename)
 		/* printf("%s\n",t);*/
 	}
 
-	tmpGrid = get_grid_from_gauss_molpro_cube_file(0,file,1,1,N,XYZ0,X,Y,Z);
+	tmpGrid = get_grid_from_gauss_molpro_cube_file(0,file,filename,1,1,N,XYZ0,X,Y,Z);
 	fclose(file);
 	if(!tmpGrid)
 	{
@@ -878,188 +894,70 @@ gint get_orbitals_number_from_molpro_cube_file(FILE* file,gint N[])
 	progress_orb(0,GABEDIT_PROGORB_SCANFILEGRID,TRUE);
 	return norbs;
 }
-/****************************************************************************************************************/
-gboolean get_values_from_gauss_molpro_cube_density_file(FILE* file,gint numblock,gint nblocks,gint N2,gdouble V[])
+/********************************************************************************/
+static void free_cube_store()
 {
-	gint len = BSIZE;
-	gchar t[BSIZE];
-	gint k = 0;
-	gint i;
-	gint n = nblocks*N2;
-	gdouble* tmpV = g_malloc((nblocks*N2+6)*sizeof(gdouble));
-	gint nval = 6;
-
-	/*Debug("Begin read den n = %d\n",n);*/
-	while(!feof(file))
-	{
-		if(!fgets(t,len,file))  /* Nx, X0,X1,X2 */   
-		{
-			Message(_("I can not read cube from this file\n"),_("Error"),TRUE);
-			g_free(tmpV);
-			return FALSE;
-		}
-		/* Debug("t = %s",t);*/
-		nval =sscanf(t,"%lf %lf %lf %lf %lf %lf",
-			&tmpV[k], &tmpV[k+1], &tmpV[k+2],
-			&tmpV[k+3], &tmpV[k+4], &tmpV[k+5]
-			);
-
-		if(k+5>=n-1)
-			break;
-		k += nval;
-		/* Debug("k=%d\n",k);*/
-	}
-	/* Debug("End read den\n");*/
-	k=(numblock-1)*N2;
-	for(i=0;i<N2;i++)
-	{
-		V[i] = tmpV[i+k];
-	}
-	g_free(tmpV);
-	return TRUE;
+	if(cubeStore) free_grid_store(cubeStore);
+	if(cubeStoreFileName) g_free(cubeStoreFileName);
+	cubeStore = NULL;
+	cubeStoreFileName = NULL;
 }
 /********************************************************************************/
-gboolean get_values_from_gauss_molpro_cube_orbitals_file(FILE* file,gint numorb,gint norbs,gint N2,gdouble V[])
+static time_t get_modification_time(gchar* fileName)
 {
-	gint len = BSIZE;
-	gchar t[BSIZE];
-	gint k = 0;
-	gint i;
-	gint n = norbs*N2;
-	gdouble* tmpV = g_malloc((norbs*N2+6)*sizeof(gdouble));
-
-	/* Debug("Begin read orb n = %d\n",n);*/
-	while(!feof(file))
-	{
-		if(!fgets(t,len,file))  /* Nx, X0,X1,X2 */   
-		{
-			Message(_("I can not read cube from this file\n"),_("Error"),TRUE);
-			g_free(tmpV);
-			return FALSE;
-		}
-		/* Debug("t = %s",t);*/
-		if(sscanf(t,"%lf %lf %lf %lf %lf %lf",
-			&tmpV[k], &tmpV[k+1], &tmpV[k+2],
-			&tmpV[k+3], &tmpV[k+4], &tmpV[k+5]
-			)!=6)
-		{
-			if(k+5>=n-1)
-	                        break;
-			/* Debug("Error t =%s ",t);*/
-			Message(_("I can not read cube from this file\n"),_("Error"),TRUE);
-			g_free(tmpV);
-			return FALSE;
-		}
-		if(k+5>=n-1)
-			break;
-		k += 6;
-		/* Debug("k=%d\n",k);*/
-	}
-	/* Debug("End read orb\n");*/
-	k=numorb-1;
-	for(i=0;i<N2;i++)
-	{
-		V[i] = tmpV[i+k];
-		k+=norbs-1;
-	}
-	g_free(tmpV);
-	return TRUE;
+	struct stat buf;
+	if(stat(fileName, &buf)!=0) return 0;
+	return buf.st_mtime;
+}
+/********************************************************************************/
+static GridStore* get_cube_store(gchar* fileName, glong offset, gint N[], gint n, GridStoreLayout layout)
+{
+	if(!cubeStore || !cubeStoreFileName || strcmp(cubeStoreFileName, fileName)) return NULL;
+	if(cubeStoreLayout != layout || cubeStoreOffset != offset || cubeStore->nFields != n) return NULL;
+	if(cubeStore->N[0] != N[0] || cubeStore->N[1] != N[1] || cubeStore->N[2] != N[2]) return NULL;
+	if(cubeStoreTime != get_modification_time(fileName)) return NULL;
+	return cubeStore;
 }
 /********************************************************************************/
 /* 
- * typefile = 0 =>  cube orbitals file 
- * typefile = 1 =>  cube density file 
+ * typefile = 0 =>  cube orbitals file : all the orbitals of a point, then the next point
+ * typefile = 1 =>  cube density file : n blocks of N[2] values for each row 
 */
-Grid* get_grid_from_gauss_molpro_cube_file(gint typefile,FILE* file,gint num,gint n,gint N[],
+Grid* get_grid_from_gauss_molpro_cube_file(gint typefile,FILE* file,gchar* fileName,gint num,gint n,gint N[],
 		gdouble XYZ0[3],gdouble X[3],gdouble Y[3],gdouble Z[3])
 {
-	Grid* grid;
-	gint i;
-	gint j;
-	gint k;
-	gdouble x;
-	gdouble y;
-	gdouble z;
-	gdouble v;
-    	gboolean beg = TRUE;
-	gdouble scal;
-	GridLimits limits;
-	gdouble* V;
-	FuncGetVal Func;
-
-	if(typefile==0)
-		Func = get_values_from_gauss_molpro_cube_orbitals_file;
-	else
-		Func = get_values_from_gauss_molpro_cube_density_file;
-
-  	for(i=0;i<3;i++)
-   		limits.MinMax[0][i] = XYZ0[i];
-
-	limits.MinMax[1][0] = XYZ0[0] + (N[0]-1)*X[0] + (N[1]-1)*X[1] +  (N[2]-1)*X[2];
-	limits.MinMax[1][1] = XYZ0[1] + (N[0]-1)*Y[0] + (N[1]-1)*Y[1] +  (N[2]-1)*Y[2];
-	limits.MinMax[1][2] = XYZ0[2] + (N[0]-1)*Z[0] + (N[1]-1)*Z[1] +  (N[2]-1)*Z[2];
-
-	grid = grid_point_alloc(N,limits);
-
-	progress_orb(0,GABEDIT_PROGORB_READGRID,TRUE);
-	scal = (gdouble)1.01/grid->N[0];
- 
-	V = g_malloc((N[2]+6)*sizeof(gdouble));
-	for(i=0;i<grid->N[0];i++)
-	{
-		for(j=0;j<grid->N[1];j++)
+	GridStoreLayout layout = (typefile==0)?GRIDSTORE_FIELDS_BY_POINT:GRIDSTORE_FIELDS_BY_ROW;
+	glong offset = ftell(file);
+	GridStore* store = NULL;
+	Grid* newGrid = NULL;
+
+	if(n<1) n = 1;
+	if(num<1) num = 1;
+	if(num>n) num = n;
+	if(n>1) store = get_cube_store(fileName, offset, N, n, layout);
+	if(!store)
+	{
+		if(n>1) free_cube_store();
+		/* single precision for several fields, the cube files have 5 or 6 significant digits */
+		store = read_grid_store_from_text_file(fileName, offset, N, n, layout, n>1, XYZ0, X, Y, Z, TRUE);
+		if(!store)
 		{
-			if(!Func(file,num,n,N[2],V))
-			{
-				/* Debug("Error Free Grid\n");*/
-				grid = free_grid(grid);
-				/* Debug("ENd Free Grid\n");*/
-				return NULL;
-			}
-			/* Debug("\n");*/
-			for(k=0;k<grid->N[2];k++)
-			{
-				x = XYZ0[0] + i*X[0] + j*X[1] +  k*X[2]; 
-				y = XYZ0[1] + i*Y[0] + j*Y[1] +  k*Y[2]; 
-				z = XYZ0[2] + i*Z[0] + j*Z[1] +  k*Z[2]; 
-
-				v = V[k];
-				/* Debug("%lf %lf %lf %lf \n",x,y,z,v);*/
-				grid->point[i][j][k].C[0] = x;
-				grid->point[i][j][k].C[1] = y;
-				grid->point[i][j][k].C[2] = z;
-				grid->point[i][j][k].C[3] = v;
-				if(beg)
-				{
-					beg = FALSE;
-        				grid->limits.MinMax[0][3] =  v;
-        				grid->limits.MinMax[1][3] =  v;
-				}
-                		else
-				{
-        				if(grid->limits.MinMax[0][3]>v)
-        					grid->limits.MinMax[0][3] =  v;
-        				if(grid->limits.MinMax[1][3]<v)
-        					grid->limits.MinMax[1][3] =  v;
-				}
-			}
+			if(!CancelCalcul) Message(_("I can not read cube from this file\n"),_("Error"),TRUE);
+			return NULL;
 		}
-		if(CancelCalcul) 
+		if(n>1)
 		{
-			progress_orb(0,GABEDIT_PROGORB_READGRID,TRUE);
-			break;
+			cubeStore = store;
+			cubeStoreFileName = g_strdup(fileName);
+			cubeStoreLayout = layout;
+			cubeStoreOffset = offset;
+			cubeStoreTime = get_modification_time(fileName);
 		}
-
-		progress_orb(scal,GABEDIT_PROGORB_READGRID,FALSE);
 	}
-
-	if(CancelCalcul)
-	{
-		grid = free_grid(grid);
-	}
-	g_free(V);
-	progress_orb(0,GABEDIT_PROGORB_READGRID,TRUE);
-	return grid;
+	newGrid = get_grid_from_grid_store(store, num-1);
+	if(store == cubeStore) cubeStoreField = num-1;
+	else free_grid_store(store);
+	return newGrid;
 }
 /**************************************************************/
 gboolean read_geometry_from_gauss_cube_file(FILE* file,gint Natoms)
@@ -1399,8 +1297,8 @@ gboolean read_gauss_molpro_cube_orbitals_file(gchar* filename,gint numorb,gint N
 	if(numorb>norbs)
 		numorb = norbs;
 	set_status_label_info("Grid","Reading...");
-	if(typefile==0) grid = get_grid_from_gauss_molpro_cube_file(0,file,numorb,norbs,N,XYZ0,X,Y,Z);
-	else grid = get_grid_from_gauss_molpro_cube_file(1,file,numorb,norbs,N,XYZ0,X,Y,Z);
+	if(typefile==0) grid = get_grid_from_gauss_molpro_cube_file(0,file,filename,numorb,norbs,N,XYZ0,X,Y,Z);
+	else grid = get_grid_from_gauss_molpro_cube_file(1,file,filename,numorb,norbs,N,XYZ0,X,Y,Z);
 	if(grid)
 	{
         	limits = grid->limits;
@@ -1442,7 +1340,8 @@ static void apply_read_orb(GtkWidget *button,gpointer data)
 		return;
 	}
   	delete_child(Win);
-	read_gauss_molpro_cube_orbitals_file(FileName,numorb,*Norbs,*TypeFile,TRUE);
+	if(*TypeFile==2) read_gabedit_binary_grid_file(FileName,numorb,TRUE);
+	else read_gauss_molpro_cube_orbitals_file(FileName,numorb,*Norbs,*TypeFile,TRUE);
 	g_free(FileName);
 	g_free(Norbs);
 	g_free(TypeFile);
@@ -1451,6 +1350,7 @@ static void apply_read_orb(GtkWidget *button,gpointer data)
 /* 
  * typefile = 0 => Gaussian
  * typefile = 1 => Molpro
+ * typefile = 2 => Gabedit binary grid
 */
 static void create_window_list_orbitals_numbers(GtkWidget *w,gint norbs,gchar* filename,gint typefile)
 {
@@ -1657,7 +1557,7 @@ void read_gauss_molpro_cube_file(GabEditTypeCube typefile,gchar* filename)
 		if(norbs<=1)
 		{
 			set_status_label_info("Grid","Reading...");
-			grid = get_grid_from_gauss_molpro_cube_file(0,file,norbs,norbs,N,XYZ0,X,Y,Z);
+			grid = get_grid_from_gauss_molpro_cube_file(0,file,filename,norbs,norbs,N,XYZ0,X,Y,Z);
 		}
 		else
 		{
@@ -1669,7 +1569,9 @@ void read_gauss_molpro_cube_file(GabEditTypeCube typefile,gchar* filename)
 	else 
 	if(type==0 && typefile ==GABEDIT_CUBE_MOLPRO_ORBN)
 	{
+		glong position = ftell(file);
 		norbs = get_orbitals_number_from_molpro_cube_file(file,N);
+		fseek(file, position, SEEK_SET);
 		if(norbs==0)
 		{
 			grid = NULL;
@@ -1683,7 +1585,7 @@ void read_gauss_molpro_cube_file(GabEditTypeCube typefile,gchar* filename)
 		{
 			Message(_("One orbital detected in this file\n"),_("Warning"),TRUE);
 			set_status_label_info("Grid","Reading...");
-			grid = get_grid_from_gauss_molpro_cube_file(0,file,norbs,norbs,N,XYZ0,X,Y,Z);
+			grid = get_grid_from_gauss_molpro_cube_file(0,file,filename,norbs,norbs,N,XYZ0,X,Y,Z);
 		}
 		else
 		{
@@ -1705,40 +1607,40 @@ void read_gauss_molpro_cube_file(GabEditTypeCube typefile,gchar* filename)
 				grid = NULL;
 				break;
 			case GABEDIT_CUBE_GAUSS_DEN:
-				grid = get_grid_from_gauss_molpro_cube_file(1,file,1,1,N,XYZ0,X,Y,Z);
+				grid = get_grid_from_gauss_molpro_cube_file(1,file,filename,1,1,N,XYZ0,X,Y,Z);
 			      	break;
 			case GABEDIT_CUBE_GAUSS_GRAD:
-				grid = get_grid_from_gauss_molpro_cube_file(1,file,1,4,N,XYZ0,X,Y,Z);
+				grid = get_grid_from_gauss_molpro_cube_file(1,file,filename,1,4,N,XYZ0,X,Y,Z);
 			      	break;
 			case GABEDIT_CUBE_GAUSS_LAP:
-				grid = get_grid_from_gauss_molpro_cube_file(1,file,1,1,N,XYZ0,X,Y,Z);
+				grid = get_grid_from_gauss_molpro_cube_file(1,file,filename,1,1,N,XYZ0,X,Y,Z);
 			      	break;
 			case GABEDIT_CUBE_GAUSS_NGRAD:
-				grid = get_grid_from_gauss_molpro_cube_file(1,file,1,1,N,XYZ0,X,Y,Z);
+				grid = get_grid_from_gauss_molpro_cube_file(1,file,filename,1,1,N,XYZ0,X,Y,Z);
 			      	break;
 			case GABEDIT_CUBE_GAUSS_POT:
-				grid = get_grid_from_gauss_molpro_cube_file(1,file,1,1,N,XYZ0,X,Y,Z);
+				grid = get_grid_from_gauss_molpro_cube_file(1,file,filename,1,1,N,XYZ0,X,Y,Z);
 			      	break;
 			case GABEDIT_CUBE_MOLPRO_ORB1:
-				grid = get_grid_from_gauss_molpro_cube_file(0,file,1,1,N,XYZ0,X,Y,Z);
+				grid = get_grid_from_gauss_molpro_cube_file(0,file,filename,1,1,N,XYZ0,X,Y,Z);
 			      	break;
 			case GABEDIT_CUBE_GABEDIT:
-				grid = get_grid_from_gauss_molpro_cube_file(0,file,1,1,N,XYZ0,X,Y,Z);
+				grid = get_grid_from_gauss_molpro_cube_file(0,file,filename,1,1,N,XYZ0,X,Y,Z);
 			      	break;
 			case GABEDIT_CUBE_MOLPRO_ORBN:
 				grid = NULL;
 				break;
 			case GABEDIT_CUBE_MOLPRO_DEN:
-				grid = get_grid_from_gauss_molpro_cube_file(1,file,1,1,N,XYZ0,X,Y,Z);
+				grid = get_grid_from_gauss_molpro_cube_file(1,file,filename,1,1,N,XYZ0,X,Y,Z);
 			      	break;
 			case GABEDIT_CUBE_MOLPRO_DEN_GRAD:
-				grid = get_grid_from_gauss_molpro_cube_file(1,file,1,4,N,XYZ0,X,Y,Z);
+				grid = get_grid_from_gauss_molpro_cube_file(1,file,filename,1,4,N,XYZ0,X,Y,Z);
 			      	break;
 			case GABEDIT_CUBE_MOLPRO_LAPDEN:
-				grid = get_grid_from_gauss_molpro_cube_file(1,file,1,5,N,XYZ0,X,Y,Z);
+				grid = get_grid_from_gauss_molpro_cube_file(1,file,filename,1,5,N,XYZ0,X,Y,Z);
 			      	break;
 			case GABEDIT_CUBE_MOLPRO_LAPLAP:
-				grid = get_grid_from_gauss_molpro_cube_file(1,file,5,5,N,XYZ0,X,Y,Z);
+				grid = get_grid_from_gauss_molpro_cube_file(1,file,filename,5,5,N,XYZ0,X,Y,Z);
 			      	break;
 		}
 
@@ -2008,6 +1910,153 @@ void save_cube_gabedit_file(GabeditFileChooser *SelecFile, gint response_id)
 	save_grid_gabedit_cube_file(FileName);
 }
 /********************************************************************************/
+static gboolean grid_is_a_field_of_store(Grid* localGrid, GridStore* store, gint numField)
+{
+	gint i,j,k;
+	gsize p = 0;
+	for(i=0;i<3;i++) if(localGrid->N[i] != store->N[i]) return FALSE;
+	for(i=0;i<localGrid->N[0];i++)
+	for(j=0;j<localGrid->N[1];j++)
+	for(k=0;k<localGrid->N[2];k++)
+		if(localGrid->point[i][j][k].C[3] != get_value_from_grid_store(store, numField, p++)) return FALSE;
+	return TRUE;
+}
+/********************************************************************************/
+/* all the orbitals of the cube file if the grid is one of them, the grid otherwise */
+void save_grid_gabedit_binary_file(gchar* filename)
+{
+	GridStore* store = NULL;
+	gdouble* atoms = NULL;
+	gboolean ok;
+	gint j;
+
+	if(!grid) return;
+	set_status_label_info(_("Grid"),_("Writing..."));
+	if(cubeStore && grid_is_a_field_of_store(grid, cubeStore, cubeStoreField)) store = cubeStore;
+	else store = get_grid_store_from_grid(grid);
+	if(nCenters>0) atoms = g_malloc(4*nCenters*sizeof(gdouble));
+	for(j=0; j<(gint)nCenters; j++)
+	{
+		atoms[4*j] = GeomOrb[j].Prop.atomicNumber;
+		atoms[4*j+1] = GeomOrb[j].C[0];
+		atoms[4*j+2] = GeomOrb[j].C[1];
+		atoms[4*j+3] = GeomOrb[j].C[2];
+	}
+	ok = save_grid_store_binary_file(store, filename, store->single, TRUE, nCenters, atoms);
+	if(store != cubeStore) free_grid_store(store);
+	if(atoms) g_free(atoms);
+	set_status_label_info(_("Grid"),_("Ok"));
+	if(!ok) Message(_("Sorry, I can not write the grid in this file\n"),_("Error"),TRUE);
+}
+/********************************************************************************/
+void save_gabedit_binary_grid_file(GabeditFileChooser *SelecFile, gint response_id)
+{
+ 	gchar *FileName;
+	if(!grid)
+	{
+		Message(_("Sorry, you have not a default grid"),_("Error"),TRUE);
+		return;
+	}
+
+	if(response_id != GTK_RESPONSE_OK) return;
+ 	FileName = gabedit_file_chooser_get_current_file(SelecFile);
+	gtk_widget_hide(GTK_WIDGET(SelecFile));
+	while( gtk_events_pending() ) gtk_main_iteration();
+	save_grid_gabedit_binary_file(FileName);
+}
+/********************************************************************************/
+static void set_geometry_from_atoms(gint nAtoms, gdouble* atoms)
+{
+	gint j;
+	nCenters = nAtoms;
+	if(nCenters<1) return;
+	GeomOrb=g_malloc(nCenters*sizeof(TypeGeomOrb));
+	for(j=0;j<nCenters;j++)
+	{
+		GeomOrb[j].Symb=symb_atom_get((guint)atoms[4*j]);
+		GeomOrb[j].C[0] = atoms[4*j+1];
+		GeomOrb[j].C[1] = atoms[4*j+2];
+		GeomOrb[j].C[2] = atoms[4*j+3];
+		GeomOrb[j].Prop = prop_atom_get(GeomOrb[j].Symb);
+		GeomOrb[j].partialCharge = 0.0;
+		GeomOrb[j].variable = TRUE;
+		GeomOrb[j].nuclearCharge = get_atomic_number_from_symbol(GeomOrb[j].Symb);
+	}
+	buildBondsOrb();
+	RebuildGeomD = TRUE;
+	if(this_is_a_new_geometry()) free_objects_all();
+	glarea_rafresh(GLArea);
+	init_atomic_orbitals();
+	set_status_label_info(_("Geometry"),_("Ok"));
+}
+/********************************************************************************/
+/* numField = 1,2... ; numField = 0 : list of the fields if the file contains several fields */
+gboolean read_gabedit_binary_grid_file(gchar* filename, gint numField, gboolean showisowin)
+{
+	gint nFields = get_number_of_fields_from_grid_binary_file(filename);
+	gint nAtoms = 0;
+	gdouble* atoms = NULL;
+	GridStore* store = NULL;
+	gchar* tmp;
+
+	CancelCalcul = FALSE;
+	if(nFields<1)
+	{
+		Message(_("I can not read grid from this file\n"),_("Error"),TRUE);
+		return FALSE;
+	}
+	free_data_all();
+	tmp = get_name_file(filename);
+	set_status_label_info(_("File Name"),tmp);
+	g_free(tmp);
+	set_status_label_info(_("File type"),"Gabedit binary grid");
+
+	atoms = get_atoms_from_grid_binary_file(filename, &nAtoms);
+	set_geometry_from_atoms(nAtoms, atoms);
+	if(atoms) g_free(atoms);
+
+	if(nFields>1 && numField<1)
+	{
+  		create_window_list_orbitals_numbers(NULL,nFields,filename,2);
+		return TRUE;
+	}
+	if(numField<1) numField = 1;
+	if(numField>nFields) numField = nFields;
+	set_status_label_info("Grid","Reading...");
+	store = read_grid_store_from_binary_file(filename, numField-1);
+	if(store)
+	{
+		grid = get_grid_from_grid_store(store, 0);
+		free_grid_store(store);
+	}
+	if(grid)
+	{
+        	limits = grid->limits;
+		if(showisowin) create_iso_orbitals();
+		set_status_label_info("Grid","Ok");
+	}
+	else
+	{
+		Message(_("I can not read grid from this file\n"),_("Error"),TRUE);
+		set_status_label_info("Grid","Nothing");
+	}
+	return (grid!=NULL);
+}
+/********************************************************************************/
+void load_gabedit_binary_grid_file(GabeditFileChooser *SelecFile, gint response_id)
+{
+ 	gchar *FileName;
+
+	if(response_id != GTK_RESPONSE_OK) return;
+ 	FileName = gabedit_file_chooser_get_current_file(SelecFile);
+	gtk_widget_hide(GTK_WIDGET(SelecFile));
+	while( gtk_events_pending() ) gtk_main_iteration();
+
+	TypeGrid = GABEDIT_TYPEGRID_ORBITAL;
+	add_objects_for_new_grid();
+	read_gabedit_binary_grid_file(FileName,0,TRUE);
+}
+/********************************************************************************/
 void mapping_with_mep(gint N[],GridLimits limits, PoissonSolverMethod psMethod)
 {
 	Grid* mep = NULL;
@@ -2076,19 +2125,10 @@ void mapping_with_fed(gint n)
 	free_grid(mep);
 }
 /********************************************************************************/
-static Grid* get_grid_from_dx_file(FILE* file, gint N[], gdouble XYZ0[3],gdouble X[3],gdouble Y[3],gdouble Z[3])
+static Grid* get_grid_from_dx_file(FILE* file, gchar* fileName, gint N[], gdouble XYZ0[3],gdouble X[3],gdouble Y[3],gdouble Z[3])
 {
-	Grid* grid;
-	gint i;
-	gint j;
-	gint k;
-	gdouble x;
-	gdouble y;
-	gdouble z;
-	gdouble v;
-    	gboolean beg = TRUE;
-	gdouble scal;
-	GridLimits limits;
+	Grid* newGrid;
+	GridStore* store;
 	gboolean Ok = FALSE;
 	gchar t[BSIZE];
 	gint len = BSIZE;
@@ -2104,67 +2144,12 @@ static Grid* get_grid_from_dx_file(FILE* file, gint N[], gdouble XYZ0[3],gdouble
 	}
 	if(!Ok) return NULL;
 
-  	for(i=0;i<3;i++)
-   		limits.MinMax[0][i] = XYZ0[i];
-
-	limits.MinMax[1][0] = XYZ0[0] + (N[0]-1)*X[0] + (N[1]-1)*X[1] +  (N[2]-1)*X[2];
-	limits.MinMax[1][1] = XYZ0[1] + (N[0]-1)*Y[0] + (N[1]-1)*Y[1] +  (N[2]-1)*Y[2];
-	limits.MinMax[1][2] = XYZ0[2] + (N[0]-1)*Z[0] + (N[1]-1)*Z[1] +  (N[2]-1)*Z[2];
-
-	grid = grid_point_alloc(N,limits);
-
-	progress_orb(0,GABEDIT_PROGORB_READGRID,TRUE);
-	scal = (gdouble)1.01/grid->N[0];
- 
-	for(i=0;i<grid->N[0];i++)
-	{
-		for(j=0;j<grid->N[1];j++)
-		{
-			for(k=0;k<grid->N[2];k++)
-			{
-				while(!feof(file))
-				{
-				   if(fgets(t,len,file)) 
-					   if(1==sscanf(t,"%lf", &v))break;
-				}
-				x = XYZ0[0] + i*X[0] + j*X[1] +  k*X[2]; 
-				y = XYZ0[1] + i*Y[0] + j*Y[1] +  k*Y[2]; 
-				z = XYZ0[2] + i*Z[0] + j*Z[1] +  k*Z[2]; 
-
-				grid->point[i][j][k].C[0] = x;
-				grid->point[i][j][k].C[1] = y;
-				grid->point[i][j][k].C[2] = z;
-				grid->point[i][j][k].C[3] = v;
-				if(beg)
-				{
-					beg = FALSE;
-        				grid->limits.MinMax[0][3] =  v;
-        				grid->limits.MinMax[1][3] =  v;
-				}
-                		else
-				{
-        				if(grid->limits.MinMax[0][3]>v)
-        					grid->limits.MinMax[0][3] =  v;
-        				if(grid->limits.MinMax[1][3]<v)
-        					grid->limits.MinMax[1][3] =  v;
-				}
-			}
-		}
-		if(CancelCalcul) 
-		{
-			progress_orb(0,GABEDIT_PROGORB_READGRID,TRUE);
-			break;
-		}
-
-		progress_orb(scal,GABEDIT_PROGORB_READGRID,FALSE);
-	}
-
-	if(CancelCalcul)
-	{
-		grid = free_grid(grid);
-	}
-	progress_orb(0,GABEDIT_PROGORB_READGRID,TRUE);
-	return grid;
+	/* the values are in the same order as in a cube file with one block */
+	store = read_grid_store_from_text_file(fileName, ftell(file), N, 1, GRIDSTORE_FIELDS_BY_ROW, FALSE, XYZ0, X, Y, Z, TRUE);
+	if(!store) return NULL;
+	newGrid = get_grid_from_grid_store(store, 0);
+	free_grid_store(store);
+	return newGrid;
 }
 /**************************************************************/
 gboolean read_dx_grid_file(gchar* filename, gboolean showisowin)
@@ -2263,7 +2248,7 @@ gboolean read_dx_grid_file(gchar* filename, gboolean showisowin)
 		return FALSE;
 	}
 
-	grid = get_grid_from_dx_file(file,N,XYZ0,X,Y,Z);
+	grid = get_grid_from_dx_file(file,filename,N,XYZ0,X,Y,Z);
 	if(grid)
 	{
         	limits = grid->limits;
@@ -39,6 +39,10 @@ void create_scale_dlg();
 void subtract_cube(GabeditFileChooser *SelecFile, gint response_id);
 void mapping_cube(GabeditFileChooser *SelecFile, gint response_id);
 void save_cube_gabedit_file(GabeditFileChooser *SelecFile, gint response_id);
+void save_grid_gabedit_binary_file(gchar* filename);
+void save_gabedit_binary_grid_file(GabeditFileChooser *SelecFile, gint response_id);
+gboolean read_gabedit_binary_grid_file(gchar* filename, gint numField, gboolean showisowin);
+void load_gabedit_binary_grid_file(GabeditFileChooser *SelecFile, gint response_id);
 void mapping_with_mep(gint N[],GridLimits limits, PoissonSolverMethod psMethod);
 void mapping_with_mep_from_multipol(gint lmax);
 void mapping_with_mep_from_charges();
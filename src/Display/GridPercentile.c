@@ -0,0 +1,296 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+/* Isovalue enclosing a given percentage of integ f dv (or integ f^2 dv) :
+ * the positive keys of the grid (f or |f|) are distributed in logarithmic bins, NSUB bins by octave
+ * over NOCTAVES octaves below the largest key, bin 0 collects all the smaller keys.
+ * The keys are stored bin by bin, with the integrated weight of each bin.
+ * A query finds the bin where the cumulated weight (from the largest keys) reaches the percentage,
+ * sorts this bin only (once) and walks it : the isovalue returned is a value of the grid.
+ */
+
+#include "../../Config.h"
+#ifdef ENABLE_OMP
+#include <omp.h>
+#endif
+#include "GlobalOrb.h"
+#include "StatusOrb.h"
+#include "../Display/GridPercentile.h"
+
+#define NSUB 64
+#define NOCTAVES 48
+
+struct _GridPercentile
+{
+	gboolean square;
+	gint eMax;
+	gint nBins;
+	gint nKeys;
+	gdouble* keys;
+	gint* first;
+	gdouble* weight;
+	gdouble* above;
+	gboolean* sorted;
+	gdouble total;
+};
+
+/************************************************************************/
+static gdouble getKey(gboolean square, gdouble v)
+{
+	if(square) return fabs(v);
+	return v;
+}
+/************************************************************************/
+static gdouble getWeight(gboolean square, gdouble key)
+{
+	if(square) return key*key;
+	return key;
+}
+/************************************************************************/
+static gint getBin(GridPercentile* gp, gdouble key)
+{
+	gint e;
+	gint s;
+	gdouble m;
+	if(key<=0) return -1;
+	m = frexp(key, &e);
+	if(e<=gp->eMax-NOCTAVES) return 0;
+	s = (gint)((2*m-1)*NSUB);
+	if(s>=NSUB) s = NSUB-1;
+	return 1+(e-1-gp->eMax+NOCTAVES)*NSUB+s;
+}
+/************************************************************************/
+void freeGridPercentile(GridPercentile* gp)
+{
+	if(!gp) return;
+	if(gp->keys) g_free(gp->keys);
+	if(gp->first) g_free(gp->first);
+	if(gp->weight) g_free(gp->weight);
+	if(gp->above) g_free(gp->above);
+	if(gp->sorted) g_free(gp->sorted);
+	g_free(gp);
+}
+/************************************************************************/
+GridPercentile* newGridPercentile(Grid* grid, gboolean square)
+{
+	GridPercentile* gp = NULL;
+	gint N0, N1, N2, nPoints;
+	gint* bins = NULL;
+	gint* pos = NULL;
+	gdouble total = 0;
+	gdouble maxKey = 0;
+	gint i;
+	gint b;
+	gint p;
+
+	if(!grid) return NULL;
+	if(CancelCalcul) return NULL;
+	N0 = grid->N[0];
+	N1 = grid->N[1];
+	N2 = grid->N[2];
+	nPoints = N0*N1*N2;
+
+	/* total integral and largest key */
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(i) reduction(+:total)
+#endif
+	for(i=0;i<N0;i++)
+	{
+		gint j,k;
+		gdouble m = 0;
+		for(j=0;j<N1;j++)
+		for(k=0;k<N2;k++)
+		{
+			gdouble v = grid->point[i][j][k].C[3];
+			gdouble key = getKey(square, v);
+			if(square) total += v*v;
+			else total += v;
+			if(key>m) m = key;
+		}
+#ifdef ENABLE_OMP
+#pragma omp critical
+#endif
+		if(m>maxKey) maxKey = m;
+	}
+	if(CancelCalcul) return NULL;
+
+	gp = g_malloc(sizeof(GridPercentile));
+	gp->square = square;
+	gp->total = total;
+	gp->eMax = 0;
+	if(maxKey>0) frexp(maxKey, &gp->eMax);
+	gp->nBins = 1+NOCTAVES*NSUB;
+	gp->first = g_malloc((gp->nBins+1)*sizeof(gint));
+	gp->weight = g_malloc(gp->nBins*sizeof(gdouble));
+	gp->above = g_malloc(gp->nBins*sizeof(gdouble));
+	gp->sorted = g_malloc(gp->nBins*sizeof(gboolean));
+	for(b=0;b<=gp->nBins;b++) gp->first[b] = 0;
+
+	/* bin of each point */
+	bins = g_malloc(nPoints*sizeof(gint));
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(i)
+#endif
+	for(i=0;i<N0;i++)
+	{
+		gint j,k;
+		for(j=0;j<N1;j++)
+		for(k=0;k<N2;k++)
+			bins[(i*N1+j)*N2+k] = getBin(gp, getKey(square, grid->point[i][j][k].C[3]));
+	}
+	if(CancelCalcul)
+	{
+		g_free(bins);
+		freeGridPercentile(gp);
+		return NULL;
+	}
+
+	for(p=0;p<nPoints;p++) if(bins[p]>=0) gp->first[bins[p]+1]++;
+	for(b=0;b<gp->nBins;b++) gp->first[b+1] += gp->first[b];
+	gp->nKeys = gp->first[gp->nBins];
+	gp->keys = g_malloc(MAX(gp->nKeys,1)*sizeof(gdouble));
+
+	/* keys stored bin by bin */
+	pos = g_malloc(gp->nBins*sizeof(gint));
+	for(b=0;b<gp->nBins;b++) pos[b] = gp->first[b];
+	for(i=0;i<N0;i++)
+	{
+		gint j,k;
+		for(j=0;j<N1;j++)
+		for(k=0;k<N2;k++)
+		{
+			b = bins[(i*N1+j)*N2+k];
+			if(b>=0) gp->keys[pos[b]++] = getKey(square, grid->point[i][j][k].C[3]);
+		}
+	}
+	g_free(pos);
+	g_free(bins);
+
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(b)
+#endif
+	for(b=0;b<gp->nBins;b++)
+	{
+		gint n;
+		gdouble w = 0;
+		for(n=gp->first[b];n<gp->first[b+1];n++) w += getWeight(square, gp->keys[n]);
+		gp->weight[b] = w;
+		gp->sorted[b] = gp->first[b+1]-gp->first[b]<2;
+	}
+	gp->above[gp->nBins-1] = 0;
+	for(b=gp->nBins-2;b>=0;b--) gp->above[b] = gp->above[b+1]+gp->weight[b+1];
+	return gp;
+}
+/************************************************************************/
+gdouble getGridPercentileTotal(GridPercentile* gp)
+{
+	if(!gp) return 0;
+	return gp->total;
+}
+/************************************************************************/
+static gint cmp_keys_decreasing(gconstpointer a, gconstpointer b)
+{
+	gdouble ka = *(gdouble*)a;
+	gdouble kb = *(gdouble*)b;
+	if(ka>kb) return -1;
+	if(ka<kb) return 1;
+	return 0;
+}
+/************************************************************************/
+gdouble getGridPercentileIsovalue(GridPercentile* gp, gdouble percent)
+{
+	gint b;
+	gint n;
+	gdouble integ;
+
+	if(!gp || gp->nKeys<1 || gp->total==0) return 0;
+	if(percent>100) percent = 100;
+	if(percent<0) percent = 0;
+
+	for(b=gp->nBins-1;b>=0;b--)
+		if(gp->first[b+1]>gp->first[b] && (gp->above[b]+gp->weight[b])/gp->total*100>=percent) break;
+	/* the percentage is never reached (negative values), the smallest positive key */
+	if(b<0)
+	{
+		for(b=0;b<gp->nBins && gp->first[b+1]==gp->first[b];b++);
+	}
+	if(!gp->sorted[b])
+	{
+		qsort(gp->keys+gp->first[b], gp->first[b+1]-gp->first[b], sizeof(gdouble), cmp_keys_decreasing);
+		gp->sorted[b] = TRUE;
+	}
+	integ = gp->above[b];
+	for(n=gp->first[b];n<gp->first[b+1]-1;n++)
+	{
+		integ += getWeight(gp->square, gp->keys[n]);
+		if(integ/gp->total*100>=percent) break;
+	}
+	return gp->keys[n];
+}
+/************************************************************************/
+/* the histogram of the last grid is kept for the next queries (isovalue dialogs, capture, animation) */
+typedef struct _GridPercentileCache
+{
+	Grid* grid;
+	Point5*** point;
+	gint N[3];
+	gboolean square;
+	gdouble minMax[2];
+	GridPercentile* gp;
+}GridPercentileCache;
+
+static GridPercentileCache gpCache = {NULL, NULL, {0,0,0}, FALSE, {0,0}, NULL};
+/************************************************************************/
+void reset_grid_percentile(Grid* grid)
+{
+	if(grid && grid != gpCache.grid) return;
+	freeGridPercentile(gpCache.gp);
+	gpCache.gp = NULL;
+	gpCache.grid = NULL;
+	gpCache.point = NULL;
+}
+/************************************************************************/
+static gboolean is_valid_grid_percentile(Grid* grid, gboolean square)
+{
+	gint c;
+	if(!gpCache.gp || gpCache.grid != grid || gpCache.point != grid->point) return FALSE;
+	if(gpCache.square != square) return FALSE;
+	for(c=0;c<3;c++) if(gpCache.N[c] != grid->N[c]) return FALSE;
+	/* values changed in place (scale, square, subtract...) update the limits */
+	if(gpCache.minMax[0] != grid->limits.MinMax[0][3]) return FALSE;
+	if(gpCache.minMax[1] != grid->limits.MinMax[1][3]) return FALSE;
+	return TRUE;
+}
+/************************************************************************/
+GridPercentile* get_grid_percentile(Grid* grid, gboolean square)
+{
+	GridPercentile* gp;
+	gint c;
+	if(!grid) return NULL;
+	if(is_valid_grid_percentile(grid, square)) return gpCache.gp;
+	gp = newGridPercentile(grid, square);
+	if(!gp) return NULL;
+	reset_grid_percentile(NULL);
+	gpCache.gp = gp;
+	gpCache.grid = grid;
+	gpCache.point = grid->point;
+	gpCache.square = square;
+	for(c=0;c<3;c++) gpCache.N[c] = grid->N[c];
+	gpCache.minMax[0] = grid->limits.MinMax[0][3];
+	gpCache.minMax[1] = grid->limits.MinMax[1][3];
+	return gp;
+}
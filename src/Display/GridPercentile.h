@@ -0,0 +1,37 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#ifndef __GABEDIT_GRIDPERCENTILE_H__
+#define __GABEDIT_GRIDPERCENTILE_H__
+
+typedef struct _GridPercentile GridPercentile;
+
+/* square = TRUE : percentiles of integ f^2 dv over |f|>=isovalue, FALSE : of integ f dv over f>=isovalue.
+ * The structure is a snapshot of the grid, it must be rebuilt if the values of the grid change. */
+GridPercentile* newGridPercentile(Grid* grid, gboolean square);
+void freeGridPercentile(GridPercentile* gp);
+/* largest isovalue such that the integral over the points above it is at least percent % of the integral over all space */
+gdouble getGridPercentileIsovalue(GridPercentile* gp, gdouble percent);
+/* integral of f (or f^2) over all the grid, without the volume element */
+gdouble getGridPercentileTotal(GridPercentile* gp);
+/* histogram of grid kept until the grid changes or reset_grid_percentile(grid) is called, do not free it */
+GridPercentile* get_grid_percentile(Grid* grid, gboolean square);
+void reset_grid_percentile(Grid* grid);
+
+#endif /* __GABEDIT_GRIDPERCENTILE_H__ */
+
@@ -0,0 +1,595 @@
+/* GridStore.c */
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+/* Grids with several fields (all the orbitals of a cube file,...) :
+ *  the text files (cube, DX) are mapped in memory and decoded in one pass by chunks in parallel,
+ *  the values are kept by field, so another field can be selected without reading again the file.
+ * Gabedit binary grid file : header, atoms, min/max of each field, index of the chunks, chunks.
+ *  Each chunk contains GRIDBINARYCHUNK values of one field, shuffled by byte and compressed by zlib,
+ *  so one field can be read without decoding the others.
+ */
+#include "../../Config.h"
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <gio/gio.h>
+#ifdef ENABLE_OMP
+#include <omp.h>
+#endif
+#include "GlobalOrb.h"
+#include "StatusOrb.h"
+#include "../Utils/Utils.h"
+#include "GridStore.h"
+
+/* size in bytes of the chunks of a text file decoded in parallel */
+#define GRIDTEXTCHUNK (1<<22)
+/* number of values by chunk in a binary file */
+#define GRIDBINARYCHUNK (1<<18)
+#define GRIDBINARYMAGIC "GABGRID1"
+
+typedef struct _GridBinaryHeader
+{
+	gchar magic[8];
+	gint32 endian;
+	gint32 version;
+	gint32 nFields;
+	gint32 N[3];
+	gint32 valueSize;
+	gint32 compressed;
+	gint32 chunkSize;
+	gint32 nAtoms;
+	gdouble origin[3];
+	gdouble X[3];
+	gdouble Y[3];
+	gdouble Z[3];
+}GridBinaryHeader;
+
+/**************************************************************/
+GridStore* new_grid_store(gint N[], gint nFields, gboolean single, gdouble origin[], gdouble X[], gdouble Y[], gdouble Z[])
+{
+	GridStore* store;
+	gint i;
+	if(nFields<1 || N[0]<1 || N[1]<1 || N[2]<1) return NULL;
+	store = g_malloc(sizeof(GridStore));
+	for(i=0;i<3;i++)
+	{
+		store->N[i] = N[i];
+		store->origin[i] = origin[i];
+		store->X[i] = X[i];
+		store->Y[i] = Y[i];
+		store->Z[i] = Z[i];
+	}
+	store->nFields = nFields;
+	store->nPoints = (gsize)N[0]*N[1]*N[2];
+	store->single = single;
+	store->values = g_try_malloc(store->nPoints*nFields*(single?sizeof(gfloat):sizeof(gdouble)));
+	if(!store->values)
+	{
+		g_free(store);
+		return NULL;
+	}
+	store->minValues = g_malloc0(nFields*sizeof(gdouble));
+	store->maxValues = g_malloc0(nFields*sizeof(gdouble));
+	return store;
+}
+/**************************************************************/
+void free_grid_store(GridStore* store)
+{
+	if(!store) return;
+	if(store->values) g_free(store->values);
+	if(store->minValues) g_free(store->minValues);
+	if(store->maxValues) g_free(store->maxValues);
+	g_free(store);
+}
+/**************************************************************/
+gdouble get_value_from_grid_store(GridStore* store, gint numField, gsize p)
+{
+	gsize n = numField*store->nPoints+p;
+	if(store->single) return ((gfloat*)store->values)[n];
+	return ((gdouble*)store->values)[n];
+}
+/**************************************************************/
+static void setValueInGridStore(GridStore* store, gint numField, gsize p, gdouble v)
+{
+	gsize n = numField*store->nPoints+p;
+	if(store->single) ((gfloat*)store->values)[n] = (gfloat)v;
+	else ((gdouble*)store->values)[n] = v;
+}
+/**************************************************************/
+static void computeMinMaxOfGridStore(GridStore* store)
+{
+	gint f;
+#ifdef ENABLE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for(f=0;f<store->nFields;f++)
+	{
+		gsize p;
+		gdouble vmin = get_value_from_grid_store(store, f, 0);
+		gdouble vmax = vmin;
+		for(p=1;p<store->nPoints;p++)
+		{
+			gdouble v = get_value_from_grid_store(store, f, p);
+			if(v<vmin) vmin = v;
+			if(v>vmax) vmax = v;
+		}
+		store->minValues[f] = vmin;
+		store->maxValues[f] = vmax;
+	}
+}
+/**************************************************************/
+/* value number t of the file => field and point */
+static void decodeTextChunk(GridStore* store, GridStoreLayout layout, const gchar* p, const gchar* e, gsize tBegin, gsize tEnd)
+{
+	gsize t;
+	gsize N2 = store->N[2];
+	gsize rowLength = N2*store->nFields;
+	for(t=tBegin;t<tEnd;t++)
+	{
+		gdouble v;
+		while(p<e && isspace((guchar)*p)) p++;
+		if(p>=e) break;
+		v = fast_strtod_range(&p, e);
+		if(layout==GRIDSTORE_FIELDS_BY_POINT) setValueInGridStore(store, t%store->nFields, t/store->nFields, v);
+		else
+		{
+			gsize r = t%rowLength;
+			setValueInGridStore(store, r/N2, t/rowLength*N2+r%N2, v);
+		}
+	}
+}
+/**************************************************************/
+GridStore* read_grid_store_from_text_file(const gchar* fileName, glong offset, gint N[], gint nFields, GridStoreLayout layout, gboolean single,
+		gdouble origin[], gdouble X[], gdouble Y[], gdouble Z[], gboolean showProgress)
+{
+	GMappedFile* map = NULL;
+	const gchar* data;
+	gsize length;
+	GridStore* store = NULL;
+	gsize nValues;
+	gint nChunks;
+	gint nBatch = 1;
+	gsize* bounds = NULL;
+	gsize* counts = NULL;
+	gint k, b;
+	gdouble scal;
+
+	if(!fileName || offset<0) return NULL;
+	map = g_mapped_file_new(fileName, FALSE, NULL);
+	if(!map) return NULL;
+	data = g_mapped_file_get_contents(map);
+	length = g_mapped_file_get_length(map);
+	if(!data || (gsize)offset>=length)
+	{
+		g_mapped_file_unref(map);
+		return NULL;
+	}
+	store = new_grid_store(N, nFields, single, origin, X, Y, Z);
+	if(!store)
+	{
+		g_mapped_file_unref(map);
+		return NULL;
+	}
+	nValues = store->nPoints*nFields;
+
+	/* the chunks begin at a new line, the number of values of each chunk gives the index of its first value */
+	nChunks = (length-offset)/GRIDTEXTCHUNK+1;
+	bounds = g_malloc((nChunks+1)*sizeof(gsize));
+	counts = g_malloc((nChunks+1)*sizeof(gsize));
+	bounds[0] = offset;
+	bounds[nChunks] = length;
+	for(k=1;k<nChunks;k++)
+	{
+		const gchar* eol;
+		gsize pos = offset+(length-offset)/nChunks*k;
+		if(pos<bounds[k-1]) pos = bounds[k-1];
+		eol = memchr(data+pos,'\n',length-pos);
+		bounds[k] = eol?(gsize)(eol-data+1):length;
+	}
+#ifdef ENABLE_OMP
+	nBatch = 2*omp_get_max_threads();
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for(k=0;k<nChunks;k++) counts[k+1] = count_tokens_range(data+bounds[k], data+bounds[k+1]);
+	counts[0] = 0;
+	for(k=0;k<nChunks;k++) counts[k+1] += counts[k];
+	if(counts[nChunks]<nValues)
+	{
+		free_grid_store(store);
+		store = NULL;
+	}
+
+	if(showProgress) progress_orb(0,GABEDIT_PROGORB_READGRID,TRUE);
+	scal = (gdouble)1.01*nBatch/nChunks;
+	for(b=0;store && b<nChunks;b+=nBatch)
+	{
+		gint kEnd = MIN(nChunks, b+nBatch);
+#ifdef ENABLE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for(k=b;k<kEnd;k++)
+		if(counts[k]<nValues)
+			decodeTextChunk(store, layout, data+bounds[k], data+bounds[k+1], counts[k], MIN(counts[k+1],nValues));
+		if(showProgress) progress_orb(scal,GABEDIT_PROGORB_READGRID,FALSE);
+		if(showProgress && CancelCalcul)
+		{
+			free_grid_store(store);
+			store = NULL;
+		}
+	}
+	if(showProgress) progress_orb(0,GABEDIT_PROGORB_READGRID,TRUE);
+	g_free(bounds);
+	g_free(counts);
+	g_mapped_file_unref(map);
+	if(store) computeMinMaxOfGridStore(store);
+	return store;
+}
+/**************************************************************/
+Grid* get_grid_from_grid_store(GridStore* store, gint numField)
+{
+	Grid* grid;
+	GridLimits limits;
+	gint i;
+	gdouble* XYZ0;
+	gdouble* X;
+	gdouble* Y;
+	gdouble* Z;
+	gint* N;
+
+	if(!store || numField<0 || numField>=store->nFields) return NULL;
+	XYZ0 = store->origin;
+	X = store->X;
+	Y = store->Y;
+	Z = store->Z;
+	N = store->N;
+  	for(i=0;i<3;i++) limits.MinMax[0][i] = XYZ0[i];
+	limits.MinMax[1][0] = XYZ0[0] + (N[0]-1)*X[0] + (N[1]-1)*X[1] +  (N[2]-1)*X[2];
+	limits.MinMax[1][1] = XYZ0[1] + (N[0]-1)*Y[0] + (N[1]-1)*Y[1] +  (N[2]-1)*Y[2];
+	limits.MinMax[1][2] = XYZ0[2] + (N[0]-1)*Z[0] + (N[1]-1)*Z[1] +  (N[2]-1)*Z[2];
+	limits.MinMax[0][3] = store->minValues[numField];
+	limits.MinMax[1][3] = store->maxValues[numField];
+
+	grid = grid_point_alloc(N,limits);
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(i)
+#endif
+	for(i=0;i<N[0];i++)
+	{
+		gint j,k;
+		gsize p = (gsize)i*N[1]*N[2];
+		for(j=0;j<N[1];j++)
+		for(k=0;k<N[2];k++)
+		{
+			grid->point[i][j][k].C[0] = XYZ0[0] + i*X[0] + j*X[1] +  k*X[2];
+			grid->point[i][j][k].C[1] = XYZ0[1] + i*Y[0] + j*Y[1] +  k*Y[2];
+			grid->point[i][j][k].C[2] = XYZ0[2] + i*Z[0] + j*Z[1] +  k*Z[2];
+			grid->point[i][j][k].C[3] = get_value_from_grid_store(store, numField, p++);
+		}
+	}
+	return grid;
+}
+/**************************************************************/
+GridStore* get_grid_store_from_grid(Grid* grid)
+{
+	GridStore* store;
+	gdouble origin[3];
+	gdouble X[3] = {0,0,0};
+	gdouble Y[3] = {0,0,0};
+	gdouble Z[3] = {0,0,0};
+	gdouble* A[3];
+	gint i,j,k;
+	gsize p = 0;
+
+	if(!grid) return NULL;
+	A[0] = X;
+	A[1] = Y;
+	A[2] = Z;
+	for(i=0;i<3;i++)
+	{
+		origin[i] = grid->point[0][0][0].C[i];
+		if(grid->N[0]>1) A[i][0] = grid->point[1][0][0].C[i]-origin[i];
+		if(grid->N[1]>1) A[i][1] = grid->point[0][1][0].C[i]-origin[i];
+		if(grid->N[2]>1) A[i][2] = grid->point[0][0][1].C[i]-origin[i];
+	}
+	store = new_grid_store(grid->N, 1, FALSE, origin, X, Y, Z);
+	if(!store) return NULL;
+	for(i=0;i<grid->N[0];i++)
+	for(j=0;j<grid->N[1];j++)
+	for(k=0;k<grid->N[2];k++)
+		setValueInGridStore(store, 0, p++, grid->point[i][j][k].C[3]);
+	computeMinMaxOfGridStore(store);
+	return store;
+}
+/**************************************************************/
+/* the bytes of same rank are grouped : the exponents are compressed much better */
+static void shuffleBytes(const guchar* in, guchar* out, gsize n, gint size, gboolean inverse)
+{
+	gsize i;
+	gint b;
+	for(i=0;i<n;i++)
+	for(b=0;b<size;b++)
+		if(inverse) out[i*size+b] = in[b*n+i];
+		else out[b*n+i] = in[i*size+b];
+}
+/**************************************************************/
+static guchar* convertBuffer(GConverter* converter, const guchar* in, gsize inSize, gsize capacity, gsize* outSize)
+{
+	guchar* out = g_malloc(capacity);
+	gsize nRead = 0;
+	gsize nWritten = 0;
+	GError* error = NULL;
+
+	while(TRUE)
+	{
+		gsize r = 0, w = 0;
+		GConverterResult res = g_converter_convert(converter, in+nRead, inSize-nRead, out+nWritten, capacity-nWritten,
+				G_CONVERTER_INPUT_AT_END, &r, &w, &error);
+		if(res==G_CONVERTER_ERROR)
+		{
+			if(g_error_matches(error, G_IO_ERROR, G_IO_ERROR_NO_SPACE))
+			{
+				g_clear_error(&error);
+				capacity *= 2;
+				out = g_realloc(out, capacity);
+				continue;
+			}
+			g_clear_error(&error);
+			g_free(out);
+			return NULL;
+		}
+		nRead += r;
+		nWritten += w;
+		if(res==G_CONVERTER_FINISHED) break;
+	}
+	*outSize = nWritten;
+	return out;
+}
+/**************************************************************/
+static guchar* packChunk(GridStore* store, gint numField, gsize p0, gsize n, gint valueSize, gboolean compress, gsize* size)
+{
+	guchar* raw = g_malloc(n*valueSize);
+	guchar* shuffled;
+	guchar* packed;
+	GConverter* converter;
+	gsize i;
+
+	for(i=0;i<n;i++)
+	{
+		gdouble v = get_value_from_grid_store(store, numField, p0+i);
+		if(valueSize==sizeof(gfloat)) ((gfloat*)raw)[i] = (gfloat)v;
+		else ((gdouble*)raw)[i] = v;
+	}
+	*size = n*valueSize;
+	if(!compress) return raw;
+	shuffled = g_malloc(n*valueSize);
+	shuffleBytes(raw, shuffled, n, valueSize, FALSE);
+	g_free(raw);
+	converter = G_CONVERTER(g_zlib_compressor_new(G_ZLIB_COMPRESSOR_FORMAT_ZLIB, 1));
+	packed = convertBuffer(converter, shuffled, n*valueSize, n*valueSize/2+64, size);
+	g_object_unref(converter);
+	g_free(shuffled);
+	return packed;
+}
+/**************************************************************/
+gboolean save_grid_store_binary_file(GridStore* store, const gchar* fileName, gboolean single, gboolean compress, gint nAtoms, gdouble* atoms)
+{
+	FILE* file;
+	GridBinaryHeader header;
+	gint nChunks;
+	gint64* index;
+	gint64 position;
+	guchar** chunks;
+	gsize* sizes;
+	gint f, c, i;
+	gboolean ok = TRUE;
+
+	if(!store || !fileName) return FALSE;
+	file = FOpen(fileName, "wb");
+	if(!file) return FALSE;
+
+	memset(&header, 0, sizeof(GridBinaryHeader));
+	memcpy(header.magic, GRIDBINARYMAGIC, 8);
+	header.endian = 1;
+	header.version = 1;
+	header.nFields = store->nFields;
+	for(i=0;i<3;i++)
+	{
+		header.N[i] = store->N[i];
+		header.origin[i] = store->origin[i];
+		header.X[i] = store->X[i];
+		header.Y[i] = store->Y[i];
+		header.Z[i] = store->Z[i];
+	}
+	header.valueSize = single?sizeof(gfloat):sizeof(gdouble);
+	header.compressed = compress;
+	header.chunkSize = GRIDBINARYCHUNK;
+	header.nAtoms = (atoms)?nAtoms:0;
+	nChunks = (store->nPoints+GRIDBINARYCHUNK-1)/GRIDBINARYCHUNK;
+
+	index = g_malloc0(2*store->nFields*nChunks*sizeof(gint64));
+	chunks = g_malloc0(nChunks*sizeof(guchar*));
+	sizes = g_malloc0(nChunks*sizeof(gsize));
+
+	fwrite(&header, sizeof(GridBinaryHeader), 1, file);
+	if(header.nAtoms>0) fwrite(atoms, sizeof(gdouble), 4*header.nAtoms, file);
+	for(f=0;f<store->nFields;f++)
+	{
+		fwrite(&store->minValues[f], sizeof(gdouble), 1, file);
+		fwrite(&store->maxValues[f], sizeof(gdouble), 1, file);
+	}
+	/* the index is written at the end */
+	fwrite(index, sizeof(gint64), 2*store->nFields*nChunks, file);
+	position = sizeof(GridBinaryHeader)+(4*header.nAtoms+2*store->nFields)*sizeof(gdouble)+2*store->nFields*nChunks*sizeof(gint64);
+
+	for(f=0;ok && f<store->nFields;f++)
+	{
+#ifdef ENABLE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for(c=0;c<nChunks;c++)
+		{
+			gsize p0 = (gsize)c*GRIDBINARYCHUNK;
+			gsize n = MIN(store->nPoints-p0, GRIDBINARYCHUNK);
+			chunks[c] = packChunk(store, f, p0, n, header.valueSize, compress, &sizes[c]);
+		}
+		for(c=0;c<nChunks;c++)
+		{
+			if(!chunks[c] || fwrite(chunks[c], 1, sizes[c], file)!=sizes[c]) ok = FALSE;
+			index[2*(f*nChunks+c)] = position;
+			index[2*(f*nChunks+c)+1] = sizes[c];
+			position += sizes[c];
+			if(chunks[c]) g_free(chunks[c]);
+			chunks[c] = NULL;
+		}
+	}
+	if(ok)
+	{
+		fseek(file, sizeof(GridBinaryHeader)+(4*header.nAtoms+2*store->nFields)*sizeof(gdouble), SEEK_SET);
+		if(fwrite(index, sizeof(gint64), 2*store->nFields*nChunks, file)!=(gsize)(2*store->nFields*nChunks)) ok = FALSE;
+	}
+	fclose(file);
+	g_free(index);
+	g_free(chunks);
+	g_free(sizes);
+	return ok;
+}
+/**************************************************************/
+static GMappedFile* mapGridBinaryFile(const gchar* fileName, GridBinaryHeader* header)
+{
+	GMappedFile* map;
+	const gchar* data;
+	gsize length;
+	if(!fileName) return NULL;
+	map = g_mapped_file_new(fileName, FALSE, NULL);
+	if(!map) return NULL;
+	data = g_mapped_file_get_contents(map);
+	length = g_mapped_file_get_length(map);
+	if(!data || length<sizeof(GridBinaryHeader))
+	{
+		g_mapped_file_unref(map);
+		return NULL;
+	}
+	memcpy(header, data, sizeof(GridBinaryHeader));
+	if(memcmp(header->magic, GRIDBINARYMAGIC, 8) || header->endian!=1 || header->version!=1 || header->nFields<1
+	|| (header->valueSize!=sizeof(gfloat) && header->valueSize!=sizeof(gdouble)) || header->chunkSize<1 || header->nAtoms<0)
+	{
+		g_mapped_file_unref(map);
+		return NULL;
+	}
+	return map;
+}
+/**************************************************************/
+gint get_number_of_fields_from_grid_binary_file(const gchar* fileName)
+{
+	GridBinaryHeader header;
+	GMappedFile* map = mapGridBinaryFile(fileName, &header);
+	if(!map) return 0;
+	g_mapped_file_unref(map);
+	return header.nFields;
+}
+/**************************************************************/
+gdouble* get_atoms_from_grid_binary_file(const gchar* fileName, gint* nAtoms)
+{
+	GridBinaryHeader header;
+	GMappedFile* map = mapGridBinaryFile(fileName, &header);
+	gdouble* atoms = NULL;
+	*nAtoms = 0;
+	if(!map) return NULL;
+	if(header.nAtoms>0 && g_mapped_file_get_length(map)>=sizeof(GridBinaryHeader)+4*header.nAtoms*sizeof(gdouble))
+	{
+		*nAtoms = header.nAtoms;
+		atoms = g_malloc(4*header.nAtoms*sizeof(gdouble));
+		memcpy(atoms, g_mapped_file_get_contents(map)+sizeof(GridBinaryHeader), 4*header.nAtoms*sizeof(gdouble));
+	}
+	g_mapped_file_unref(map);
+	return atoms;
+}
+/**************************************************************/
+GridStore* read_grid_store_from_binary_file(const gchar* fileName, gint numField)
+{
+	GridBinaryHeader header;
+	GMappedFile* map = mapGridBinaryFile(fileName, &header);
+	const gchar* data;
+	gsize length;
+	GridStore* store;
+	gint64* index;
+	gsize nPoints;
+	gint nChunks;
+	gsize begin;
+	gint c;
+	gboolean ok = TRUE;
+
+	if(!map) return NULL;
+	data = g_mapped_file_get_contents(map);
+	length = g_mapped_file_get_length(map);
+	nPoints = (gsize)header.N[0]*header.N[1]*header.N[2];
+	nChunks = (nPoints+header.chunkSize-1)/header.chunkSize;
+	begin = sizeof(GridBinaryHeader)+(4*header.nAtoms+2*header.nFields)*sizeof(gdouble);
+	if(numField<0 || numField>=header.nFields || begin+2*header.nFields*nChunks*sizeof(gint64)>length)
+	{
+		g_mapped_file_unref(map);
+		return NULL;
+	}
+	store = new_grid_store(header.N, 1, header.valueSize==sizeof(gfloat), header.origin, header.X, header.Y, header.Z);
+	if(!store)
+	{
+		g_mapped_file_unref(map);
+		return NULL;
+	}
+	memcpy(&store->minValues[0], data+begin-2*(header.nFields-numField)*sizeof(gdouble), sizeof(gdouble));
+	memcpy(&store->maxValues[0], data+begin-2*(header.nFields-numField)*sizeof(gdouble)+sizeof(gdouble), sizeof(gdouble));
+	index = g_malloc(2*nChunks*sizeof(gint64));
+	memcpy(index, data+begin+2*numField*nChunks*sizeof(gint64), 2*nChunks*sizeof(gint64));
+
+#ifdef ENABLE_OMP
+#pragma omp parallel for schedule(dynamic) reduction(&&:ok)
+#endif
+	for(c=0;c<nChunks;c++)
+	{
+		gsize p0 = (gsize)c*header.chunkSize;
+		gsize n = MIN(nPoints-p0, (gsize)header.chunkSize);
+		gsize rawSize = n*header.valueSize;
+		gint64 offset = index[2*c];
+		gint64 size = index[2*c+1];
+		guchar* dest = (guchar*)store->values+p0*header.valueSize;
+		if(offset<0 || size<0 || (gsize)(offset+size)>length) { ok = FALSE; continue; }
+		if(!header.compressed)
+		{
+			if((gsize)size!=rawSize) { ok = FALSE; continue; }
+			memcpy(dest, data+offset, rawSize);
+		}
+		else
+		{
+			GConverter* converter = G_CONVERTER(g_zlib_decompressor_new(G_ZLIB_COMPRESSOR_FORMAT_ZLIB));
+			gsize outSize = 0;
+			guchar* shuffled = convertBuffer(converter, (const guchar*)data+offset, size, rawSize, &outSize);
+			g_object_unref(converter);
+			if(!shuffled || outSize!=rawSize) ok = FALSE;
+			else shuffleBytes(shuffled, dest, n, header.valueSize, TRUE);
+			if(shuffled) g_free(shuffled);
+		}
+	}
+	g_free(index);
+	g_mapped_file_unref(map);
+	if(!ok)
+	{
+		free_grid_store(store);
+		return NULL;
+	}
+	return store;
+}
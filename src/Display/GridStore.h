@@ -0,0 +1,62 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#ifndef __GABEDIT_GRIDSTORE_H__
+#define __GABEDIT_GRIDSTORE_H__
+
+/* order of the values in a text file with several fields (orbitals, density and its gradient, ...) */
+typedef enum
+{
+	GRIDSTORE_FIELDS_BY_POINT = 0, /* Gaussian orbitals cube : all the fields of a point, then the next point */
+	GRIDSTORE_FIELDS_BY_ROW /* Molpro cube, DX : for each row (i,j), the N[2] values of the first field, then the second field,... */
+} GridStoreLayout;
+
+typedef struct _GridStore
+{
+	gint N[3];
+	gint nFields;
+	gsize nPoints;
+	gdouble origin[3];
+	/* same convention as the cube files : x = origin[0] + i*X[0] + j*X[1] + k*X[2] */
+	gdouble X[3];
+	gdouble Y[3];
+	gdouble Z[3];
+	gboolean single;
+	gpointer values; /* gfloat or gdouble, values[numField*nPoints + (i*N[1]+j)*N[2]+k] */
+	gdouble* minValues;
+	gdouble* maxValues;
+}GridStore;
+
+GridStore* new_grid_store(gint N[], gint nFields, gboolean single, gdouble origin[], gdouble X[], gdouble Y[], gdouble Z[]);
+void free_grid_store(GridStore* store);
+gdouble get_value_from_grid_store(GridStore* store, gint numField, gsize p);
+/* decode all the fields in one pass, offset = position of the first value in the file.
+ * showProgress = FALSE : no progress bar and no cancel, the function can be called outside the main thread */
+GridStore* read_grid_store_from_text_file(const gchar* fileName, glong offset, gint N[], gint nFields, GridStoreLayout layout, gboolean single,
+		gdouble origin[], gdouble X[], gdouble Y[], gdouble Z[], gboolean showProgress);
+Grid* get_grid_from_grid_store(GridStore* store, gint numField);
+GridStore* get_grid_store_from_grid(Grid* grid);
+/* chunked binary format, atoms : nAtoms*4 values (atomic number, x, y, z) */
+gboolean save_grid_store_binary_file(GridStore* store, const gchar* fileName, gboolean single, gboolean compress, gint nAtoms, gdouble* atoms);
+gint get_number_of_fields_from_grid_binary_file(const gchar* fileName);
+gdouble* get_atoms_from_grid_binary_file(const gchar* fileName, gint* nAtoms);
+/* read only the field numField (0..nFields-1) */
+GridStore* read_grid_store_from_binary_file(const gchar* fileName, gint numField);
+
+#endif /* __GABEDIT_GRIDSTORE_H__ */
+
@@ -26,40 +26,52 @@ DEALINGS IN THE SOFTWARE.
 #include <unistd.h>
 
 /**************************************************************************/
-static void snapshot_pixbuf_free (guchar   *pixels, gpointer  data)
+/* RGBA pixels of the viewport, the first row is the bottom of the image */
+static void read_pixels_gl(guchar* data, gint width, gint height)
 {
-	g_free (pixels);
+	gboolean fboRead = FALSE;
+#ifdef GL_FRAMEBUFFER_BINDING
+	{
+		/* off-screen rendering (batch mode) : read the bound framebuffer object */
+		GLint fbo = 0;
+		glGetIntegerv(GL_FRAMEBUFFER_BINDING, &fbo);
+		if(fbo!=0)
+		{
+  			glReadBuffer(GL_COLOR_ATTACHMENT0);
+			fboRead = TRUE;
+		}
+	}
+#endif
+	glPixelStorei(GL_PACK_ROW_LENGTH,width);
+	glPixelStorei(GL_PACK_ALIGNMENT,1);
+	if(!fboRead)
+	{
+#ifdef G_OS_WIN32 
+  	glReadBuffer(GL_BACK);
+#else
+  	glReadBuffer(GL_FRONT);
+#endif
+	}
+  	glReadPixels(0,0,width,height,GL_RGBA,GL_UNSIGNED_BYTE,data);
 }
 /**************************************************************************/
+static void get_viewport_size(gint* width, gint* height)
+{
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+  	*width  = viewport[2];
+  	*height = viewport[3];
+}
 /**************************************************************************/
-static GdkPixbuf  *get_pixbuf_gl(guchar* colorTrans)
+/* the pixbuf owns its pixels, data is not used after the call */
+static GdkPixbuf  *get_pixbuf_from_pixels(guchar* data, gint width, gint height, guchar* colorTrans)
 {       
-      	gint stride;
 	GdkPixbuf  *pixbuf = NULL;
 	GdkPixbuf  *tmp = NULL;
 	GdkPixbuf  *tmp2 = NULL;
-	guchar *data;
-  	gint height;
-  	gint width;
-	GLint viewport[4];
-
-	glGetIntegerv(GL_VIEWPORT, viewport);
-  	width  = viewport[2];
-  	height = viewport[3];
-
-	stride = width*4;
-
-	data = g_malloc0 (sizeof (guchar) * stride * height);
-#ifdef G_OS_WIN32 
-  	glReadBuffer(GL_BACK);
-  	glReadPixels(0,0,width,height,GL_RGBA,GL_UNSIGNED_BYTE,data);
-#else
-  	glReadBuffer(GL_FRONT);
-  	glReadPixels(0,0,width,height,GL_RGBA,GL_UNSIGNED_BYTE,data);
-#endif
 
 	tmp = gdk_pixbuf_new_from_data (data, GDK_COLORSPACE_RGB, TRUE, 
-                                      8, width, height, stride, snapshot_pixbuf_free,
+                                      8, width, height, width*4, NULL,
                                       NULL);
 	if(tmp)
 	{
@@ -73,7 +85,7 @@ static GdkPixbuf  *get_pixbuf_gl(guchar* colorTrans)
 		g_object_unref (tmp2);
 	}
 
-	if(colorTrans)
+	if(pixbuf && colorTrans)
 	{
 		tmp = gdk_pixbuf_add_alpha(pixbuf, TRUE, colorTrans[0], colorTrans[1], colorTrans[2]);
 		if(tmp!=pixbuf)
@@ -82,10 +94,36 @@ static GdkPixbuf  *get_pixbuf_gl(guchar* colorTrans)
 			pixbuf = tmp;
 		}
 	}
-	
+	return pixbuf;
+}
+/**************************************************************************/
+static GdkPixbuf  *get_pixbuf_gl(guchar* colorTrans)
+{       
+	GdkPixbuf  *pixbuf = NULL;
+	guchar *data;
+  	gint height;
+  	gint width;
+
+	get_viewport_size(&width, &height);
+	data = g_malloc0 (sizeof (guchar) * width*4 * height);
+	read_pixels_gl(data, width, height);
+	pixbuf = get_pixbuf_from_pixels(data, width, height, colorTrans);
+	g_free(data);
 	return pixbuf;
 }
 /*************************************************************************/
+static void save_pixbuf(GdkPixbuf* pixbuf, gchar* fileName, gchar* type, GError** error)
+{
+	if(type && strstr(type,"j") && strstr(type,"g") )
+	gdk_pixbuf_save(pixbuf, fileName, type, error, "quality", "100", NULL);
+	else if(type && strstr(type,"png"))
+	gdk_pixbuf_save(pixbuf, fileName, type, error, "compression", "9", NULL);
+	else if(type && (strstr(type,"tif") || strstr(type,"tiff")))
+	gdk_pixbuf_save(pixbuf, fileName, "tiff", error, "compression", "1", NULL);
+	else
+	gdk_pixbuf_save(pixbuf, fileName, type, error, NULL);
+}
+/**************************************************************************/
 void gabedit_save_image_gl(GtkWidget* widget, gchar *fileName, gchar* type, guchar* colorTrans)
 {       
 	GError *error = NULL;
@@ -103,17 +141,7 @@ void gabedit_save_image_gl(GtkWidget* widget, gchar *fileName, gchar* type, guch
 				gtk_clipboard_set_image(clipboard, pixbuf);
 			}
 		}
-		else 
-		{
-			if(type && strstr(type,"j") && strstr(type,"g") )
-			gdk_pixbuf_save(pixbuf, fileName, type, &error, "quality", "100", NULL);
-			else if(type && strstr(type,"png"))
-			gdk_pixbuf_save(pixbuf, fileName, type, &error, "compression", "9", NULL);
-			else if(type && (strstr(type,"tif") || strstr(type,"tiff")))
-			gdk_pixbuf_save(pixbuf, fileName, "tiff", &error, "compression", "1", NULL);
-			else
-			gdk_pixbuf_save(pixbuf, fileName, type, &error, NULL);
-		}
+		else save_pixbuf(pixbuf, fileName, type, &error);
 	 	g_object_unref (pixbuf);
 	}
 }
@@ -203,78 +231,56 @@ void copy_to_clipboard_without_background()
 	if(numCol>-1) gabedit_save_image_gl(GLArea, NULL, NULL,color);
 	else gabedit_save_image_gl(GLArea, NULL, NULL,NULL);
 } 
-/**************************************************************************
-*       Save the Frame Buffer in a ppm format file
-**************************************************************************/
-static gchar* save_ppm(gchar* fileName)
+/**************************************************************************/
+/* pixels : RGBA, the first row is the bottom of the image. returns NULL or the error message (to free) */
+static gchar* write_ppm(gchar* fileName, guchar* pixels, gint width, gint height)
 {       
 	FILE *file;
-	int i;
-	int j;
-	int k;
-	int width;
-	int height;
-	GLubyte *rgbbuf;
-	static gchar message[1024];
+	gint i;
+	gint j;
+	guchar* row;
 
- 	if ((!fileName) || (strcmp(fileName,"") == 0))
-	{
-		sprintf(message,_("Sorry\n No selected file"));
-	       	return message;
-	}
+ 	if ((!fileName) || (strcmp(fileName,"") == 0)) return g_strdup(_("Sorry\n No selected file"));
 
 	file = FOpen(fileName,"wb");
 
-	if (!file)
-	{
-		sprintf(message,_("Sorry: can't open %s file\n"), fileName);
-		return message;
-	}
-  
-	width =  gabedit_widget_allocated_width(GTK_WIDGET(GLArea));
-	height = gabedit_widget_allocated_height(GTK_WIDGET(GLArea));
-
-	glPixelStorei(GL_PACK_ROW_LENGTH,width);
-	glPixelStorei(GL_PACK_ALIGNMENT,1);
-
-	rgbbuf = (GLubyte *) malloc(3*width*height*sizeof(GLubyte));
-  	if (!rgbbuf)
-	{
-		sprintf(message,_("Sorry: couldn't allocate memory\n"));
-	    	fclose(file);
-		return message;
-  	}
-
-#ifdef G_OS_WIN32 
-  	glReadPixels(0,0,width,height,GL_RGB,GL_UNSIGNED_BYTE,rgbbuf);
-#else
-  	glReadBuffer(GL_FRONT);
-  	glReadPixels(0,0,width,height,GL_RGB,GL_UNSIGNED_BYTE,rgbbuf);
-#endif
-
+	if (!file) return g_strdup_printf(_("Sorry: can't open %s file\n"), fileName);
         fprintf(file,"P6\n");
         fprintf(file,"#Image rendered with gabedit\n");
         fprintf(file,"%d\n%d\n255\n", width,height);
 
-	for(i=height-1; i>= 0; i--){
-	   for(j=0; j< width; j++){
-		/* int ierr;*/
-		k = 3*(j + i*width);
-		/*
-		ierr = fwrite( &rgbbuf[k] ,sizeof(*rgbbuf), 1, file);
-		ierr = fwrite( &rgbbuf[k+1] ,sizeof(*rgbbuf), 1, file);
-		ierr = fwrite( &rgbbuf[k+2] ,sizeof(*rgbbuf), 1, file);
-		*/
-		fwrite( &rgbbuf[k] ,sizeof(*rgbbuf), 1, file);
-		fwrite( &rgbbuf[k+1] ,sizeof(*rgbbuf), 1, file);
-		fwrite( &rgbbuf[k+2] ,sizeof(*rgbbuf), 1, file);
-	   }
+	row = g_malloc(3*width*sizeof(guchar));
+	for(i=height-1; i>= 0; i--)
+	{
+		for(j=0; j< width; j++)
+		{
+			row[3*j]   = pixels[4*(j + i*width)];
+			row[3*j+1] = pixels[4*(j + i*width)+1];
+			row[3*j+2] = pixels[4*(j + i*width)+2];
+		}
+		fwrite(row, sizeof(guchar), 3*width, file);
 	}
-
+	g_free(row);
 	fclose(file);
-	free(rgbbuf);
 	return NULL;
 } 
+/**************************************************************************
+*       Save the Frame Buffer in a ppm format file
+**************************************************************************/
+static gchar* save_ppm(gchar* fileName)
+{       
+	gint width;
+	gint height;
+	guchar *pixels;
+	gchar* message;
+
+	get_viewport_size(&width, &height);
+	pixels = g_malloc(4*width*height*sizeof(guchar));
+	read_pixels_gl(pixels, width, height);
+	message = write_ppm(fileName, pixels, width, height);
+	g_free(pixels);
+	return message;
+} 
 /**************************************************************************/
 void save_ppm_file(GabeditFileChooser *SelecFile, gint response_id)
 {       
@@ -298,6 +304,7 @@ void save_ppm_file(GabeditFileChooser *SelecFile, gint response_id)
 	if(message != NULL)
 	{
 		Message(message,_("Error"),TRUE);
+		g_free(message);
 	}
 } 
 /**************************************************************************
@@ -311,56 +318,24 @@ static void WLSBL(int val,char* arr)
     arr[3] = (char) ((val>>24)&0xff);
 }
 /**************************************************************************/
-static gchar* save_bmp(gchar* fileName)
+/* pixels : RGBA, the first row is the bottom of the image. returns NULL or the error message (to free) */
+static gchar* write_bmp(gchar* fileName, guchar* pixels, gint width, gint height)
 {       
-	/* int ierr;*/
 	FILE *file;
-	int i;
-	int j;
-	int width;
-	int height;
-  	GLubyte *rgbbuf;
-  	GLubyte rgbtmp[3];
-  	int pad;
-	static gchar message[1024];
+	gint i;
+	gint j;
+	guchar* row;
+	gint pad;
 	char bmp_header[]=
 	{ 'B','M', 0,0,0,0, 0,0, 0,0, 54,0,0,0,
   	40,0,0,0, 0,0,0,0, 0,0,0,0, 1,0, 24,0, 0,0,0,0, 0,0,0,0,
   	0,0,0,0, 0,0,0,0, 0,0,0,0, 0,0,0,0 };
 
- 	if ((!fileName) || (strcmp(fileName,"") == 0))
-	{
-		sprintf(message,_("Sorry\n No selected file"));
-	       	return message;
-	}
+ 	if ((!fileName) || (strcmp(fileName,"") == 0)) return g_strdup(_("Sorry\n No selected file"));
 
 	file = FOpen(fileName,"wb");
 
-	if (!file)
-	{
-		sprintf(message,_("Sorry: can't open %s file\n"), fileName);
-		return message;
-	}
-  
-	width =  gabedit_widget_allocated_width(GTK_WIDGET(GLArea));
-	height = gabedit_widget_allocated_height(GTK_WIDGET(GLArea));
-
-	glPixelStorei(GL_PACK_ROW_LENGTH,width);
-	glPixelStorei(GL_PACK_ALIGNMENT,1);
-
-  	rgbbuf = (GLubyte *)malloc(3*width*height*sizeof(GLubyte));
-  	if (!rgbbuf)
-	{
-		sprintf(message,_("Sorry: couldn't allocate memory\n"));
-	    	fclose(file);
-		return message;
-  	}
-#ifdef G_OS_WIN32 
-  	glReadPixels(0,0,width,height,GL_RGB,GL_UNSIGNED_BYTE,rgbbuf);
-#else
-  	glReadBuffer(GL_FRONT);
-  	glReadPixels(0,0,width,height,GL_RGB,GL_UNSIGNED_BYTE,rgbbuf);
-#endif
+	if (!file) return g_strdup_printf(_("Sorry: can't open %s file\n"), fileName);
 
 /* The number of bytes on a screenline should be wholly devisible by 4 */
 
@@ -372,30 +347,40 @@ static gchar* save_bmp(gchar* fileName)
   	WLSBL((int) height,bmp_header+22);
   	WLSBL((int) 3*width*height,bmp_header+34);
 
-  	/* ierr = fwrite(bmp_header,1,54,file);*/
   	fwrite(bmp_header,1,54,file);
 
+	row = g_malloc0((3*width+pad)*sizeof(guchar));
   	for (i=0;i<height;i++)
 	{
     		for (j=0;j<width;j++)
 		{
-			rgbtmp[0] = rgbbuf[(j+width*i)*3+2];
-			rgbtmp[1] = rgbbuf[(j+width*i)*3+1];
-			rgbtmp[2] = rgbbuf[(j+width*i)*3+0];
-			/* ierr = fwrite(rgbtmp,3,1,file);*/
-			fwrite(rgbtmp,3,1,file);
+			row[3*j]   = pixels[(j+width*i)*4+2];
+			row[3*j+1] = pixels[(j+width*i)*4+1];
+			row[3*j+2] = pixels[(j+width*i)*4+0];
     		}
-    	rgbtmp[0] = (char) 0;
-    	for (j=0;j<pad;j++) 
-		/* ierr = fwrite(rgbtmp,1,1,file);*/
-		fwrite(rgbtmp,1,1,file);
+		fwrite(row, 1, 3*width+pad, file);
   	}
+	g_free(row);
 
   	fclose(file);
-  	free(rgbbuf);
 	return NULL;
 }
 /**************************************************************************/
+static gchar* save_bmp(gchar* fileName)
+{       
+	gint width;
+	gint height;
+	guchar *pixels;
+	gchar* message;
+
+	get_viewport_size(&width, &height);
+	pixels = g_malloc(4*width*height*sizeof(guchar));
+	read_pixels_gl(pixels, width, height);
+	message = write_bmp(fileName, pixels, width, height);
+	g_free(pixels);
+	return message;
+}
+/**************************************************************************/
 void save_bmp_file(GabeditFileChooser *SelecFile, gint response_id)
 {       
  	gchar *fileName;
@@ -418,6 +403,7 @@ void save_bmp_file(GabeditFileChooser *SelecFile, gint response_id)
 	if(message != NULL)
 	{
 		Message(message,_("Error"),TRUE);
+		g_free(message);
 	}
 }
 /**************************************************************************
@@ -577,45 +563,178 @@ void save_ps_file(GabeditFileChooser *SelecFile, gint response_id)
         fclose(file);
         free(rgbbuf);
 }
+/**************************************************************************
+*  Frames of the animations : the pixels are read in buffers of a pool,
+*  the images are encoded and written by a pool of threads.
+*  The rendering waits only when all the buffers are used.
+**************************************************************************/
+typedef struct _ImageExportJob
+{
+	guchar* pixels;
+	gint width;
+	gint height;
+	gchar* fileName;
+	gchar* type;
+	gboolean transparent;
+	guchar colorTrans[3];
+}ImageExportJob;
+
+static GThreadPool* exportPool = NULL;
+static GMutex exportMutex;
+static GCond exportCond;
+static GSList* exportFreeBuffers = NULL;
+static gsize exportBufferSize = 0;
+static gint exportNBuffers = 0;
+static gint exportMaxBuffers = 0;
+static gint exportNJobs = 0;
+static gchar* exportError = NULL;
 /**************************************************************************/
-gchar* new_bmp(gchar* dirname, int i)
+static void export_image_thread(gpointer data, gpointer user_data)
 {
-	gchar* fileName = g_strdup_printf("%s%sgab%d.bmp",dirname,G_DIR_SEPARATOR_S,i);
-	gchar* message;
-	if(i==1)
+	ImageExportJob* job = (ImageExportJob*)data;
+	gchar* message = NULL;
+	GError* error = NULL;
+
+	if(!strcmp(job->type,"bmp")) message = write_bmp(job->fileName, job->pixels, job->width, job->height);
+	else if(!strcmp(job->type,"ppm")) message = write_ppm(job->fileName, job->pixels, job->width, job->height);
+	else
 	{
-		gint j;
-		for(j=0;j<100;j++)
+		GdkPixbuf* pixbuf = get_pixbuf_from_pixels(job->pixels, job->width, job->height, job->transparent?job->colorTrans:NULL);
+		if(pixbuf)
 		{
-			gchar* filestoDelete = g_strdup_printf("%s%sgab%d.bmp",dirname,G_DIR_SEPARATOR_S,j);
-			unlink(filestoDelete);
-			g_free(filestoDelete);
-
+			save_pixbuf(pixbuf, job->fileName, job->type, &error);
+			g_object_unref (pixbuf);
 		}
 	}
 
-	message = save_bmp(fileName);
-	g_free(fileName);
+	g_mutex_lock(&exportMutex);
+	if(!exportError && message) { exportError = message; message = NULL; }
+	if(!exportError && error) exportError = g_strdup(error->message);
+	exportFreeBuffers = g_slist_prepend(exportFreeBuffers, job->pixels);
+	exportNJobs--;
+	g_cond_broadcast(&exportCond);
+	g_mutex_unlock(&exportMutex);
+
+	if(message) g_free(message);
+	if(error) g_error_free(error);
+	g_free(job->fileName);
+	g_free(job->type);
+	g_free(job);
+}
+/**************************************************************************/
+/* wait for the end of all the exported images. returns the first error (to free) or NULL */
+gchar* wait_images_export()
+{
+	gchar* message = NULL;
+	if(!exportPool) return NULL;
+	g_mutex_lock(&exportMutex);
+	while(exportNJobs>0) g_cond_wait(&exportCond, &exportMutex);
+	message = exportError;
+	exportError = NULL;
+	g_mutex_unlock(&exportMutex);
 	return message;
 }
 /**************************************************************************/
-gchar* new_ppm(gchar* dirname, int i)
+/* mutex locked */
+static guchar* get_export_buffer(gsize size)
 {
-	gchar* fileName = g_strdup_printf("%s%sgab%d.ppm",dirname,G_DIR_SEPARATOR_S,i);
-	gchar* message;
-	if(i==1)
+	guchar* buffer = NULL;
+	if(size != exportBufferSize)
 	{
-		gint j;
-		for(j=0;j<100;j++)
-		{
-			gchar* filestoDelete = g_strdup_printf("%s%sgab%d.ppm",dirname,G_DIR_SEPARATOR_S,j);
-			unlink(filestoDelete);
-			g_free(filestoDelete);
+		/* new size of the window : the buffers of the old size are released when free */
+		while(exportNJobs>0) g_cond_wait(&exportCond, &exportMutex);
+		g_slist_free_full(exportFreeBuffers, g_free);
+		exportFreeBuffers = NULL;
+		exportNBuffers = 0;
+		exportBufferSize = size;
+	}
+	while(!exportFreeBuffers && exportNBuffers>=exportMaxBuffers) g_cond_wait(&exportCond, &exportMutex);
+	if(exportFreeBuffers)
+	{
+		buffer = exportFreeBuffers->data;
+		exportFreeBuffers = g_slist_delete_link(exportFreeBuffers, exportFreeBuffers);
+	}
+	else
+	{
+		buffer = g_malloc(size);
+		exportNBuffers++;
+	}
+	return buffer;
+}
+/**************************************************************************/
+static gchar* export_image_gl(gchar* fileName, gchar* type, guchar* colorTrans)
+{
+	static gchar message[1024];
+	ImageExportJob* job;
+	gchar* error = NULL;
 
-		}
+	if(!exportPool)
+	{
+		gint nThreads = (gint)g_get_num_processors()-1;
+		if(nThreads<1) nThreads = 1;
+		exportMaxBuffers = 2*nThreads+1;
+		exportPool = g_thread_pool_new(export_image_thread, NULL, nThreads, FALSE, NULL);
+		if(!exportPool) return NULL;
+	}
+	g_mutex_lock(&exportMutex);
+	if(exportError)
+	{
+		/* a previous frame was not written : stop the film */
+		error = exportError;
+		exportError = NULL;
+	}
+	g_mutex_unlock(&exportMutex);
+	if(error)
+	{
+		snprintf(message, sizeof(message), "%s", error);
+		g_free(error);
+		return message;
 	}
 
-	message = save_ppm(fileName);
+	job = g_malloc(sizeof(ImageExportJob));
+	get_viewport_size(&job->width, &job->height);
+	g_mutex_lock(&exportMutex);
+	job->pixels = get_export_buffer(4*job->width*job->height*sizeof(guchar));
+	exportNJobs++;
+	g_mutex_unlock(&exportMutex);
+	read_pixels_gl(job->pixels, job->width, job->height);
+	job->fileName = g_strdup(fileName);
+	job->type = g_strdup(type);
+	job->transparent = (colorTrans!=NULL);
+	if(colorTrans) memcpy(job->colorTrans, colorTrans, 3*sizeof(guchar));
+	g_thread_pool_push(exportPool, job, NULL);
+	return NULL;
+}
+/**************************************************************************/
+static void delete_old_images(gchar* dirname, gchar* ext)
+{
+	gint j;
+	gchar* message = wait_images_export();
+	if(message) g_free(message);
+	for(j=0;j<100;j++)
+	{
+		gchar* filestoDelete = g_strdup_printf("%s%sgab%d.%s",dirname,G_DIR_SEPARATOR_S,j,ext);
+		unlink(filestoDelete);
+		g_free(filestoDelete);
+	}
+}
+/**************************************************************************/
+gchar* new_bmp(gchar* dirname, int i)
+{
+	gchar* fileName = g_strdup_printf("%s%sgab%d.bmp",dirname,G_DIR_SEPARATOR_S,i);
+	gchar* message;
+	if(i==1) delete_old_images(dirname, "bmp");
+	message = export_image_gl(fileName, "bmp", NULL);
+	g_free(fileName);
+	return message;
+}
+/**************************************************************************/
+gchar* new_ppm(gchar* dirname, int i)
+{
+	gchar* fileName = g_strdup_printf("%s%sgab%d.ppm",dirname,G_DIR_SEPARATOR_S,i);
+	gchar* message;
+	if(i==1) delete_old_images(dirname, "ppm");
+	message = export_image_gl(fileName, "ppm", NULL);
 	g_free(fileName);
 	return message;
 }
@@ -623,41 +742,21 @@ gchar* new_ppm(gchar* dirname, int i)
 gchar* new_jpeg(gchar* dirname, int i)
 {
 	gchar* fileName = g_strdup_printf("%s%sgab%d.jpg",dirname,G_DIR_SEPARATOR_S,i);
-	if(i==1)
-	{
-		gint j;
-		for(j=0;j<100;j++)
-		{
-			gchar* filestoDelete = g_strdup_printf("%s%sgab%d.jpg",dirname,G_DIR_SEPARATOR_S,j);
-			unlink(filestoDelete);
-			g_free(filestoDelete);
-
-		}
-	}
-
-	gabedit_save_image_gl(GLArea, fileName, "jpeg",NULL);
+	gchar* message;
+	if(i==1) delete_old_images(dirname, "jpg");
+	message = export_image_gl(fileName, "jpeg", NULL);
 	g_free(fileName);
-	return NULL;
+	return message;
 }
 /**************************************************************************/
 gchar* new_png(gchar* dirname, int i)
 {
 	gchar* fileName = g_strdup_printf("%s%sgab%d.png",dirname,G_DIR_SEPARATOR_S,i);
-	if(i==1)
-	{
-		gint j;
-		for(j=0;j<100;j++)
-		{
-			gchar* filestoDelete = g_strdup_printf("%s%sgab%d.png",dirname,G_DIR_SEPARATOR_S,j);
-			unlink(filestoDelete);
-			g_free(filestoDelete);
-
-		}
-	}
-
-	gabedit_save_image_gl(GLArea, fileName, "png",NULL);
+	gchar* message;
+	if(i==1) delete_old_images(dirname, "png");
+	message = export_image_gl(fileName, "png", NULL);
 	g_free(fileName);
-	return NULL;
+	return message;
 }
 /**************************************************************************/
 gchar* new_png_without_background(gchar* dirname, int i)
@@ -665,21 +764,10 @@ gchar* new_png_without_background(gchar* dirname, int i)
 	gchar* fileName = g_strdup_printf("%s%sgab%d.png",dirname,G_DIR_SEPARATOR_S,i);
 	guchar color[3];
 	gint numCol = get_background_color(color);
+	gchar* message;
 
-	if(i==1)
-	{
-		gint j;
-		for(j=0;j<100;j++)
-		{
-			gchar* filestoDelete = g_strdup_printf("%s%sgab%d.png",dirname,G_DIR_SEPARATOR_S,j);
-			unlink(filestoDelete);
-			g_free(filestoDelete);
-
-		}
-	}
-
-	if(numCol>=0) gabedit_save_image_gl(GLArea, fileName, "png",color);
-	else gabedit_save_image_gl(GLArea, fileName, "png",NULL);
+	if(i==1) delete_old_images(dirname, "png");
+	message = export_image_gl(fileName, "png", (numCol>=0)?color:NULL);
 	g_free(fileName);
-	return NULL;
+	return message;
 }
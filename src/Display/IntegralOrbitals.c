@@ -45,6 +45,7 @@ DEALINGS IN THE SOFTWARE.
 #include "../Display/PlanesMappedPov.h"
 #include "../Display/LabelsGL.h"
 #include "../Display/StatusOrb.h"
+#include "../Display/PopulationAnalysis.h"
 
 
 #define WIDTHSCR 0.3
@@ -667,7 +668,7 @@ static void apply_coulomb_orbitals(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : an entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -677,7 +678,7 @@ static void apply_coulomb_orbitals(GtkWidget *Win,gpointer data)
 		if(NumPointstmp[i] <=2)
 		{
 			GtkWidget* message = Message(_("Error : The number of points should be > 2. "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		
@@ -688,7 +689,7 @@ static void apply_coulomb_orbitals(GtkWidget *Win,gpointer data)
 		if( limitstmp.MinMax[0][i]> limitstmp.MinMax[1][i])
 		{
 			GtkWidget* message = Message(_("Error :  The minimal value should be smaller than the maximal value "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 	}
@@ -713,7 +714,7 @@ static void apply_coulomb_orbitals(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : an entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -728,7 +729,7 @@ static void apply_coulomb_orbitals(GtkWidget *Win,gpointer data)
 		if(fabs(norm)<1e-8)
 		{
 			GtkWidget* message = Message(_("Error : the norm is equal to 0 "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		for(j=0;j<3;j++)
@@ -754,7 +755,7 @@ static void apply_coulomb_orbitals(GtkWidget *Win,gpointer data)
 	if(nAlpha+nBeta<1)
 	{
 		GtkWidget* message = Message(_("Error : You should select at last one orbital"),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
 	else if(nAlpha+nBeta==1)
@@ -1385,19 +1386,19 @@ void compute_overlap_matrix(gint typeOrb)
 	if(NAOrb<1)
 	{
 		GtkWidget* message = Message(_("Error : You should read orbitals"),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
 	if(!AOrb && !SAOrb)
 	{
 		GtkWidget* message = Message(_("Sorry, Please load the MO beforee\n"),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
 	if(!AOrb && SAOrb)
 	{
 		GtkWidget* message = Message(_("Sorry, That does not work with Slater basis set\n"),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
 	destroy_win_list();
@@ -1595,7 +1596,7 @@ static void apply_transition_matrix(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : an entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -1605,7 +1606,7 @@ static void apply_transition_matrix(GtkWidget *Win,gpointer data)
 		if(NumPointstmp[i] <=2)
 		{
 			GtkWidget* message = Message(_("Error : The number of points should be > 2. "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		
@@ -1616,7 +1617,7 @@ static void apply_transition_matrix(GtkWidget *Win,gpointer data)
 		if( limitstmp.MinMax[0][i]> limitstmp.MinMax[1][i])
 		{
 			GtkWidget* message = Message(_("Error :  The minimal value should be smaller than the maximal value "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 	}
@@ -1641,7 +1642,7 @@ static void apply_transition_matrix(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : an entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -1656,7 +1657,7 @@ static void apply_transition_matrix(GtkWidget *Win,gpointer data)
 		if(fabs(norm)<1e-8)
 		{
 			GtkWidget* message = Message(_("Error : the norm is equal to 0 "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		for(j=0;j<3;j++)
@@ -1682,7 +1683,7 @@ static void apply_transition_matrix(GtkWidget *Win,gpointer data)
 	if(nAlpha+nBeta<1)
 	{
 		GtkWidget* message = Message(_("Error : You should select at last one orbital"),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
 	else if(nAlpha+nBeta==1)
@@ -2059,7 +2060,7 @@ static void apply_spatial_overlapiijj(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : an entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -2069,7 +2070,7 @@ static void apply_spatial_overlapiijj(GtkWidget *Win,gpointer data)
 		if(NumPointstmp[i] <=2)
 		{
 			GtkWidget* message = Message(_("Error : The number of points should be > 2. "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		
@@ -2080,7 +2081,7 @@ static void apply_spatial_overlapiijj(GtkWidget *Win,gpointer data)
 		if( limitstmp.MinMax[0][i]> limitstmp.MinMax[1][i])
 		{
 			GtkWidget* message = Message(_("Error :  The minimal value should be smaller than the maximal value "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 	}
@@ -2105,7 +2106,7 @@ static void apply_spatial_overlapiijj(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : an entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -2120,7 +2121,7 @@ static void apply_spatial_overlapiijj(GtkWidget *Win,gpointer data)
 		if(fabs(norm)<1e-8)
 		{
 			GtkWidget* message = Message(_("Error : the norm is equal to 0 "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		for(j=0;j<3;j++)
@@ -2146,7 +2147,7 @@ static void apply_spatial_overlapiijj(GtkWidget *Win,gpointer data)
 	if(nAlpha+nBeta<1)
 	{
 		GtkWidget* message = Message(_("Error : You should select at last one orbital"),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
 	else if(nAlpha+nBeta==1)
@@ -2503,7 +2504,7 @@ static void apply_spatial_overlapij(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : an entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -2513,7 +2514,7 @@ static void apply_spatial_overlapij(GtkWidget *Win,gpointer data)
 		if(NumPointstmp[i] <=2)
 		{
 			GtkWidget* message = Message(_("Error : The number of points should be > 2. "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		
@@ -2524,7 +2525,7 @@ static void apply_spatial_overlapij(GtkWidget *Win,gpointer data)
 		if( limitstmp.MinMax[0][i]> limitstmp.MinMax[1][i])
 		{
 			GtkWidget* message = Message(_("Error :  The minimal value should be smaller than the maximal value "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 	}
@@ -2549,7 +2550,7 @@ static void apply_spatial_overlapij(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : an entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -2564,7 +2565,7 @@ static void apply_spatial_overlapij(GtkWidget *Win,gpointer data)
 		if(fabs(norm)<1e-8)
 		{
 			GtkWidget* message = Message(_("Error : the norm is equal to 0 "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		for(j=0;j<3;j++)
@@ -2589,7 +2590,7 @@ static void apply_spatial_overlapij(GtkWidget *Win,gpointer data)
 	if(nAlpha+nBeta<1)
 	{
 		GtkWidget* message = Message(_("Error : You should select at last one orbital"),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
 	else if(nAlpha+nBeta==1)
@@ -2882,67 +2883,15 @@ static GtkWidget* showCalculatedChargesDlg(gchar *message,gchar *title,gdouble*
 	return dlgWin;
 }
 /********************************************************************************/
-void compute_mulliken_charges()
+static void show_calculated_charges(gchar* title, gdouble* charges)
 {
-	gint i,k,l;
 	gchar* result = NULL;
-	gdouble* charges = NULL;
 	gchar* tmp = NULL;
-	gdouble o;
-	gint nAll = 0;
-	gint delta = 0;
-	gint pos = 0;
-	gdouble scal;
-	gchar str[BSIZE];
-	gint kk=0;
-
-	if(nCenters<1) return;
-	if(!AOrb && (!SAOrb || !SOverlaps)) return;
-
-	destroy_win_list();
-	sprintf(str,_("Computing of mulliken charges... Please wait"));
-	setTextInProgress(str);
-
-	scal = 0.01;
-	delta = (gint)(NAOrb*(NAOrb+1)/2*scal);
-	if(delta<1) delta = 1;
-	pos = delta;
-
-	charges = g_malloc(nCenters*sizeof(gdouble));
-	for(i=0;i<nCenters;i++) charges[i] = GeomOrb[i].nuclearCharge;
-	progress_orb_txt(0,str,TRUE);
-	kk = 0;
-	for(k=0;k<NAOrb;k++)
-	{
-		gint ic = (AOrb)?AOrb[k].NumCenter:SAOrb[k].NumCenter;
-		for(l=0;l<=k;l++)
-		{
-			gint jc = (AOrb)?AOrb[l].NumCenter:SAOrb[l].NumCenter;
-			gint fact = 1;
-			if(CancelCalcul) break;
-			if(AOrb) o = overlapCGTF(&AOrb[k],&AOrb[l])*fact;
-			else o = SOverlaps[kk++]*fact;
-		/* printf("k=%d o = %lf\n",k,o);*/
-			for(i=0;i<NAlphaOcc;i++) charges[ic] -= OccAlphaOrbitals[i]*CoefAlphaOrbitals[i][k]*CoefAlphaOrbitals[i][l]*o;
-			for(i=0;i<NBetaOcc;i++)  charges[ic] -= OccBetaOrbitals[i]*CoefBetaOrbitals[i][k]*CoefBetaOrbitals[i][l]*o;
-			if(k!=l)
-			{
-			for(i=0;i<NAlphaOcc;i++) charges[jc] -= OccAlphaOrbitals[i]*CoefAlphaOrbitals[i][k]*CoefAlphaOrbitals[i][l]*o;
-			for(i=0;i<NBetaOcc;i++)  charges[jc] -= OccBetaOrbitals[i]*CoefBetaOrbitals[i][k]*CoefBetaOrbitals[i][l]*o;
-			}
-			nAll++;
-			if(nAll>=pos)
-			{
-				pos += delta;
-				progress_orb_txt(scal,str,FALSE);
-			}
-		}
-	}
-	progress_orb_txt(0," ",TRUE);
+	gint i;
 
 	result = g_malloc(nCenters*100*sizeof(gchar));
 	tmp = g_malloc(BSIZE*sizeof(gchar));
-	sprintf(result," Mulliken charges\n");
+	sprintf(result," %s\n",title);
 
 	setTextInProgress(_("Preparation of text to show... Please wait"));
 	for(i=0;i<nCenters;i++)
@@ -2956,12 +2905,49 @@ void compute_mulliken_charges()
 	progress_orb_txt(0," ",TRUE);
 	if(result && !CancelCalcul)
 	{
-		GtkWidget* message = showCalculatedChargesDlg(result,"Mulliken charges",charges);
+		GtkWidget* message = showCalculatedChargesDlg(result,title,charges);
   		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		gtk_window_set_transient_for(GTK_WINDOW(message),GTK_WINDOW(PrincipalWindow));
 	}
+	else g_free(charges);
 	g_free(result);
 }
+/********************************************************************************/
+void compute_mulliken_charges()
+{
+	PopulationAnalysis* pa = NULL;
+	gdouble* charges = NULL;
+
+	if(nCenters<1) return;
+	if(!AOrb && (!SAOrb || !SOverlaps)) return;
+
+	destroy_win_list();
+	setTextInProgress(_("Computing of mulliken charges... Please wait"));
+	pa = newPopulationAnalysis();
+	if(pa) charges = getMullikenCharges(pa);
+	freePopulationAnalysis(pa);
+	progress_orb_txt(0," ",TRUE);
+	if(!charges) return;
+	show_calculated_charges("Mulliken charges",charges);
+}
+/********************************************************************************/
+void compute_lowdin_charges()
+{
+	PopulationAnalysis* pa = NULL;
+	gdouble* charges = NULL;
+
+	if(nCenters<1) return;
+	if(!AOrb && (!SAOrb || !SOverlaps)) return;
+
+	destroy_win_list();
+	setTextInProgress(_("Computing of Lowdin charges... Please wait"));
+	pa = newPopulationAnalysis();
+	if(pa) charges = getLowdinCharges(pa);
+	freePopulationAnalysis(pa);
+	progress_orb_txt(0," ",TRUE);
+	if(!charges) return;
+	show_calculated_charges("Lowdin charges",charges);
+}
 /************************************************************************************************************/
 static void setBondOrdersToCalculated(GtkWidget *win)
 {
@@ -3077,154 +3063,12 @@ static GtkWidget* showCalculatedBondOrdersDlg(gchar *message,gchar *title,gdoubl
 	return dlgWin;
 }
 /********************************************************************************/
-void compute_bondOrders()
+static void show_calculated_bondOrders(gchar* title, gdouble* bondOrders)
 {
-	gint i,j,k,l,m;
 	gchar* result = NULL;
-	gdouble* bondOrders = NULL;
 	gchar* tmp = NULL;
-	gdouble o;
-	gint nAll = 0;
-	gint delta = 0;
-	gint pos = 0;
-	gdouble scal;
-	gchar str[BSIZE];
-	gdouble** S = NULL;
-	gdouble** Pa = NULL;
-	gdouble** Pb = NULL;
-	gdouble** PS = NULL;
 	gint n2 = nCenters*(nCenters+1)/2;
-	gint kk;
-
-	if(nCenters<1) return;
-	if(!AOrb && (!SAOrb || !SOverlaps)) return;
-
-	destroy_win_list();
-	sprintf(str,_("Computing of bond order matrix... Please wait"));
-	setTextInProgress(str);
-
-	scal = 0.01;
-	delta = (gint)(NAOrb*(NAOrb+1)/2*scal);
-	if(delta<1) delta = 1;
-	pos = delta;
-
-	bondOrders = g_malloc(n2*sizeof(gdouble));
-	for(i=0;i<n2;i++) bondOrders[i] = 0;
-
-	S = g_malloc(NAOrb*sizeof(gdouble*));
-	for(i=0;i<NAOrb;i++) S[i] = g_malloc(NAOrb*sizeof(gdouble));
-	for(i=0;i<NAOrb;i++) 
-	for(j=0;j<NAOrb;j++) S[i][j] = 0;
-
-	Pa = g_malloc(NAOrb*sizeof(gdouble*));
-	for(i=0;i<NAOrb;i++) Pa[i] = g_malloc(NAOrb*sizeof(gdouble));
-	for(i=0;i<NAOrb;i++) 
-	for(j=0;j<NAOrb;j++) Pa[i][j] = 0;
-
-	Pb = g_malloc(NAOrb*sizeof(gdouble*));
-	for(i=0;i<NAOrb;i++) Pb[i] = g_malloc(NAOrb*sizeof(gdouble));
-	for(i=0;i<NAOrb;i++) 
-	for(j=0;j<NAOrb;j++) Pb[i][j] = 0;
-
-	PS = g_malloc(NAOrb*sizeof(gdouble*));
-	for(i=0;i<NAOrb;i++) PS[i] = g_malloc(NAOrb*sizeof(gdouble));
-	for(i=0;i<NAOrb;i++) 
-	for(j=0;j<NAOrb;j++) PS[i][j] = 0;
-
-	progress_orb_txt(0,str,TRUE);
-	kk = 0;
-	for(k=0;k<NAOrb;k++)
-	{
-		for(l=0;l<=k;l++)
-		{
-			double s = 0;
-			if(CancelCalcul) break;
-			if(AOrb) o = overlapCGTF(&AOrb[k],&AOrb[l]);
-			else o = SOverlaps[kk++];
-			S[k][l] = o;
-			if(k!=l) S[l][k] = S[k][l];
-
-			s = 0;
-			for(i=0;i<NAOrb;i++) 
-				s += OccAlphaOrbitals[i]*CoefAlphaOrbitals[i][k]*CoefAlphaOrbitals[i][l];
-			Pa[k][l] += s;
-			if(k!=l) Pa[l][k] += s;
-			s = 0;
-			for(i=0;i<NAOrb;i++) 
-				s += OccBetaOrbitals[i]*CoefBetaOrbitals[i][k]*CoefBetaOrbitals[i][l];
-			Pb[k][l] += s;
-			if(k!=l) Pb[l][k] += s;
-			nAll++;
-			if(nAll>=pos)
-			{
-				pos += delta;
-				progress_orb_txt(scal,str,FALSE);
-			}
-		}
-	}
-	for(k=0;k<NAOrb;k++)
-		for(l=0;l<NAOrb;l++)
-		{
-			PS[k][l] = 0;
-			for(m=0;m<NAOrb;m++) PS[k][l] += Pa[k][m]*S[m][l];
-		}
-
-	/*
-	printf("Density matrix alpha\n");
-	for(k=0;k<NAOrb;k++) {for(l=0;l<=k;l++) printf("%f ",PS[k][l]); printf("\n");}
-	*/
-
-	double s1 = 0;
-	for(k=0;k<NAOrb;k++)
-	{
-		gint i = (AOrb)?AOrb[k].NumCenter:SAOrb[k].NumCenter;
-		for(l=0;l<NAOrb;l++)
-		{
-			gint j = (AOrb)?AOrb[l].NumCenter:SAOrb[l].NumCenter;
-			gint ii =  i*nCenters + j - i*(i+1)/2;
-			if(i>j) ii = j*nCenters + i - j*(j+1)/2;
-			bondOrders[ii] += PS[k][l]*PS[l][k];
-		}
-		/* printf(" k %d  %f\n",i,  PS[k][k]);*/
-		s1 += PS[k][k];
-	}
-	/* printf(" s1 = %f\n",s1);*/
-	for(k=0;k<NAOrb;k++)
-	for(l=0;l<NAOrb;l++)
-	{
-		PS[k][l] = 0;
-		for(m=0;m<NAOrb;m++) PS[k][l] += Pb[k][m]*S[m][l];
-	}
-
-	/*
-	printf("Density matrix beta\n");
-	for(k=0;k<NAOrb;k++) {for(l=0;l<=k;l++) printf("%f ",2*PS[k][l]); printf("\n");}
-	*/
-
-	double s2 = 0;
-	for(k=0;k<NAOrb;k++)
-	{
-		gint i = (AOrb)?AOrb[k].NumCenter:SAOrb[k].NumCenter;
-		for(l=0;l<NAOrb;l++)
-		{
-			gint j = (AOrb)?AOrb[l].NumCenter:SAOrb[l].NumCenter;
-			gint ii =  i*nCenters + j - i*(i+1)/2;
-			if(i>j) ii = j*nCenters + i - j*(j+1)/2;
-			bondOrders[ii] += PS[k][l]*PS[l][k];
-		}
-		/* printf(" k %d  %f\n",i,  PS[k][k]);*/
-		s2 += PS[k][k];
-	}
-	/* printf(" s2 = %f\n",s2);*/
-	progress_orb_txt(0," ",TRUE);
-	for(i=0;i<NAOrb;i++) g_free(S[i]);
-	g_free(S);
-	for(i=0;i<NAOrb;i++) g_free(Pa[i]);
-	g_free(Pa);
-	for(i=0;i<NAOrb;i++) g_free(Pb[i]);
-	g_free(Pb);
-	for(i=0;i<NAOrb;i++) g_free(PS[i]);
-	g_free(PS);
+	gint i,j;
 
 	result = g_malloc(n2*100*sizeof(gchar));
 	tmp = g_malloc(BSIZE*sizeof(gchar));
@@ -3235,7 +3079,6 @@ void compute_bondOrders()
 	for(j=i+1;j<nCenters;j++)
 	{
 		gint ii =  i*nCenters + j - i*(i+1)/2;
-		if(i>j) ii = j*nCenters + i - j*(j+1)/2;
 		if(CancelCalcul) break;
 		sprintf(tmp,"Bond %d-%d : %lf\n",i+1,j+1,bondOrders[ii]);
 		strcat(result,tmp);
@@ -3245,13 +3088,50 @@ void compute_bondOrders()
 	progress_orb_txt(0," ",TRUE);
 	if(result && !CancelCalcul)
 	{
-		GtkWidget* message = showCalculatedBondOrdersDlg(result,"Bond orders ",bondOrders);
+		GtkWidget* message = showCalculatedBondOrdersDlg(result,title,bondOrders);
   		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		gtk_window_set_transient_for(GTK_WINDOW(message),GTK_WINDOW(PrincipalWindow));
 	}
+	else g_free(bondOrders);
 	g_free(result);
 }
 /********************************************************************************/
+void compute_bondOrders()
+{
+	PopulationAnalysis* pa = NULL;
+	gdouble* bondOrders = NULL;
+
+	if(nCenters<1) return;
+	if(!AOrb && (!SAOrb || !SOverlaps)) return;
+
+	destroy_win_list();
+	setTextInProgress(_("Computing of bond order matrix... Please wait"));
+	pa = newPopulationAnalysis();
+	if(pa) bondOrders = getMayerBondOrders(pa);
+	freePopulationAnalysis(pa);
+	progress_orb_txt(0," ",TRUE);
+	if(!bondOrders) return;
+	show_calculated_bondOrders("Bond orders ",bondOrders);
+}
+/********************************************************************************/
+void compute_wiberg_bondOrders()
+{
+	PopulationAnalysis* pa = NULL;
+	gdouble* bondOrders = NULL;
+
+	if(nCenters<1) return;
+	if(!AOrb && (!SAOrb || !SOverlaps)) return;
+
+	destroy_win_list();
+	setTextInProgress(_("Computing of Wiberg bond order matrix... Please wait"));
+	pa = newPopulationAnalysis();
+	if(pa) bondOrders = getWibergBondOrders(pa);
+	freePopulationAnalysis(pa);
+	progress_orb_txt(0," ",TRUE);
+	if(!bondOrders) return;
+	show_calculated_bondOrders("Wiberg bond orders ",bondOrders);
+}
+/********************************************************************************/
 static void messageErrorTrans(gchar* fileName)
 {
         gchar buffer[BSIZE];
@@ -3417,7 +3297,7 @@ static void apply_lambda_diagnostic(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : an entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -3427,7 +3307,7 @@ static void apply_lambda_diagnostic(GtkWidget *Win,gpointer data)
 		if(NumPointstmp[i] <=2)
 		{
 			GtkWidget* message = Message(_("Error : The number of points should be > 2. "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		
@@ -3438,7 +3318,7 @@ static void apply_lambda_diagnostic(GtkWidget *Win,gpointer data)
 		if( limitstmp.MinMax[0][i]> limitstmp.MinMax[1][i])
 		{
 			GtkWidget* message = Message(_("Error :  The minimal value should be smaller than the maximal value "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 	}
@@ -3463,7 +3343,7 @@ static void apply_lambda_diagnostic(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : an entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -3478,7 +3358,7 @@ static void apply_lambda_diagnostic(GtkWidget *Win,gpointer data)
 		if(fabs(norm)<1e-8)
 		{
 			GtkWidget* message = Message(_("Error : the norm is equal to 0 "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		for(j=0;j<3;j++)
@@ -3504,7 +3384,7 @@ static void apply_lambda_diagnostic(GtkWidget *Win,gpointer data)
 	if(!fd) 
 	{
 		GtkWidget* message = Message(_("I cannot open the data file "),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
 
@@ -3632,7 +3512,7 @@ static void help_trans_prop()
 		)
 		 );
 	win = Message(temp,_(" Info "),FALSE);
-	gtk_window_set_modal (GTK_WINDOW (win), TRUE);
+	if(win) gtk_window_set_modal (GTK_WINDOW (win), TRUE);
 }
 /********************************************************************************/
 void lambda_diagnostic_dlg()
@@ -25,7 +25,9 @@ void transition_matrix_orbitals_dlg();
 void spatial_overlapiijj_orbitals_dlg();
 void spatial_overlapij_orbitals_dlg();
 void compute_mulliken_charges();
+void compute_lowdin_charges();
 void compute_bondOrders();
+void compute_wiberg_bondOrders();
 void lambda_diagnostic_dlg();
 
 #endif /* __GABEDIT_COULOMBORBITALS_H__ */
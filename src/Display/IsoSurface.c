@@ -24,6 +24,25 @@ DEALINGS IN THE SOFTWARE.
 #include "../Utils/Utils.h"
 
 #define PRECISION 1e-10
+/* edge length, in cubes, of the blocks of the min/max index */
+#define ISOBLOCK 8
+
+/* min/max of the values of each block of ISOBLOCK^3 cubes : the cubes of a block
+ * are computed only if the isolevel is in [min,max]. 
+ * The index of the last grid is kept for the next isolevels (isovalue animation, +/- surfaces).
+ */
+typedef struct _IsoBlocksIndex
+{
+	Grid* grid;
+	Point5*** point;
+	gint N[3];
+	gdouble minMax[2];
+	gint nBlocks[3];
+	gdouble* bmin;
+	gdouble* bmax;
+}IsoBlocksIndex;
+
+static IsoBlocksIndex isoIndex = {NULL, NULL, {0,0,0}, {0,0}, {0,0,0}, NULL, NULL};
 /******************************************************************************************************************************/
 gdouble Norme(Vertex *Vect)
 {
@@ -106,43 +125,48 @@ IsoSurface* iso_alloc(gint N[])
 	iso->N[0] = N[0];
 	iso->N[1] = N[1];
 	iso->N[2] = N[2];
+	/* rows without triangles share the same empty row, see get_iso_row */
+	iso->emptyRow = g_malloc0(iso->N[2]*sizeof(Cube));
 	iso->cube = g_malloc( iso->N[0]*sizeof(Cube**));
 	for(i=0;i< iso->N[0] ;i++)
 	{
 		iso->cube[i] = g_malloc(iso->N[1]*sizeof(Cube*));
 		for(j=0;j< iso->N[1] ;j++)
-			iso->cube[i][j] = g_malloc(iso->N[2]*sizeof(Cube));
+			iso->cube[i][j] = iso->emptyRow;
 	}
 		
 	return iso;
 }
 /**************************************************************/
+static Cube* get_iso_row(IsoSurface* iso, gint i, gint j)
+{
+	if(iso->cube[i][j] == iso->emptyRow) iso->cube[i][j] = g_malloc0(iso->N[2]*sizeof(Cube));
+	return iso->cube[i][j];
+}
+/**************************************************************/
 IsoSurface* iso_free(IsoSurface* iso)
 {
 	gint i,j,k;
 	if(!iso)
 		return NULL;
 
-	for(i=1;i<iso->N[0]-2;i++)
+	for(i=0;i< iso->N[0] ;i++)
 	{
-		for(j=1;j<iso->N[1]-2;j++)
+		for(j=0;j< iso->N[1] ;j++)
 		{
-			for(k=1;k<iso->N[2]-2;k++)
+			if(iso->cube[i][j] == iso->emptyRow) continue;
+			for(k=0;k<iso->N[2];k++)
 			{
 				Cube cube = iso->cube[i][j][k];
 				if(cube.vertex) g_free(cube.vertex);
 				if(cube.triangles) g_free(cube.triangles);
 			}
-		}
-	}
-
-	for(i=0;i< iso->N[0] ;i++)
-	{
-		for(j=0;j< iso->N[1] ;j++)
 			g_free(iso->cube[i][j]);
+		}
 		g_free(iso->cube[i]);
 	}
 	g_free(iso->cube);
+	g_free(iso->emptyRow);
 	g_free(iso);
 	iso=NULL;
 	return iso;
@@ -328,35 +352,125 @@ void print_cube(Cube cube)
 	}
 }
 /**************************************************************/
+void reset_iso_surface_index(Grid* grid)
+{
+	if(grid && grid != isoIndex.grid) return;
+	if(isoIndex.bmin) g_free(isoIndex.bmin);
+	if(isoIndex.bmax) g_free(isoIndex.bmax);
+	isoIndex.bmin = NULL;
+	isoIndex.bmax = NULL;
+	isoIndex.grid = NULL;
+	isoIndex.point = NULL;
+}
+/**************************************************************/
+static gboolean is_valid_iso_surface_index(Grid* grid)
+{
+	gint c;
+	if(!isoIndex.bmin || isoIndex.grid != grid || isoIndex.point != grid->point) return FALSE;
+	for(c=0;c<3;c++) if(isoIndex.N[c] != grid->N[c]) return FALSE;
+	/* values changed in place (scale, square, subtract...) update the limits */
+	if(isoIndex.minMax[0] != grid->limits.MinMax[0][3]) return FALSE;
+	if(isoIndex.minMax[1] != grid->limits.MinMax[1][3]) return FALSE;
+	return TRUE;
+}
+/**************************************************************/
+/* cubes i of the block b : 1+b*ISOBLOCK <= i < min(1+(b+1)*ISOBLOCK, N-2) */
+static void get_block_range(gint b, gint N, gint* first, gint* last)
+{
+	*first = 1+b*ISOBLOCK;
+	*last = *first+ISOBLOCK;
+	if(*last>N-2) *last = N-2;
+}
+/**************************************************************/
+static void build_iso_surface_index(Grid* grid)
+{
+	gint c;
+	gint nb;
+	gint bi,bj,bk;
+
+	reset_iso_surface_index(NULL);
+	for(c=0;c<3;c++) 
+	{
+		isoIndex.N[c] = grid->N[c];
+		isoIndex.nBlocks[c] = (grid->N[c]>3)?(grid->N[c]-3+ISOBLOCK-1)/ISOBLOCK:0;
+	}
+	nb = isoIndex.nBlocks[0]*isoIndex.nBlocks[1]*isoIndex.nBlocks[2];
+	if(nb<1) return;
+	isoIndex.bmin = g_malloc(nb*sizeof(gdouble));
+	isoIndex.bmax = g_malloc(nb*sizeof(gdouble));
+	isoIndex.grid = grid;
+	isoIndex.point = grid->point;
+	isoIndex.minMax[0] = grid->limits.MinMax[0][3];
+	isoIndex.minMax[1] = grid->limits.MinMax[1][3];
+
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(bi,bj,bk)
+#endif
+	for(bi=0;bi<isoIndex.nBlocks[0];bi++)
+	for(bj=0;bj<isoIndex.nBlocks[1];bj++)
+	for(bk=0;bk<isoIndex.nBlocks[2];bk++)
+	{
+		gint i,j,k;
+		gint i0,i1,j0,j1,k0,k1;
+		gint b = (bi*isoIndex.nBlocks[1]+bj)*isoIndex.nBlocks[2]+bk;
+		gdouble vmin = grid->point[1+bi*ISOBLOCK][1+bj*ISOBLOCK][1+bk*ISOBLOCK].C[3];
+		gdouble vmax = vmin;
+		get_block_range(bi, grid->N[0], &i0, &i1);
+		get_block_range(bj, grid->N[1], &j0, &j1);
+		get_block_range(bk, grid->N[2], &k0, &k1);
+		/* corners of the cubes : one more point in each direction */
+		for(i=i0;i<=i1;i++)
+		for(j=j0;j<=j1;j++)
+		for(k=k0;k<=k1;k++)
+		{
+			gdouble v = grid->point[i][j][k].C[3];
+			if(v<vmin) vmin = v;
+			if(v>vmax) vmax = v;
+		}
+		isoIndex.bmin[b] = vmin;
+		isoIndex.bmax[b] = vmax;
+	}
+}
+/**************************************************************/
 IsoSurface* define_iso_surface(Grid* grid, gdouble isolevel, gboolean mapping)
 {
 	IsoSurface* iso;
 	gint i;
 	gint j;
 	gint k;
-	gint n=0;
+	gint bi,bj,bk;
 	gdouble scal;
 
 	iso = iso_alloc(grid->N);
+	iso->grid = grid;
 
 	progress_orb(0,GABEDIT_PROGORB_COMPISOSURFACE,TRUE);
-	scal = (gdouble)1.01/(grid->N[0]);
+	if(!is_valid_iso_surface_index(grid)) build_iso_surface_index(grid);
+	if(!isoIndex.bmin) return iso;
+	scal = (gdouble)1.01/isoIndex.nBlocks[0];
 
-	for(i=1;i<iso->N[0]-2;i++)
+	/* a cube has triangles only if some of its corners are < isolevel and some others >= isolevel */
+	for(bi=0;bi<isoIndex.nBlocks[0];bi++)
 	{
 		progress_orb(scal,GABEDIT_PROGORB_COMPISOSURFACE,FALSE);
-		for(j=1;j<iso->N[1]-2;j++)
+		for(bj=0;bj<isoIndex.nBlocks[1];bj++)
+		for(bk=0;bk<isoIndex.nBlocks[2];bk++)
 		{
-			for(k=1;k<iso->N[2]-2;k++)
+			gint i0,i1,j0,j1,k0,k1;
+			gint b = (bi*isoIndex.nBlocks[1]+bj)*isoIndex.nBlocks[2]+bk;
+			if(isoIndex.bmax[b]<isolevel || isoIndex.bmin[b]>=isolevel) continue;
+			get_block_range(bi, grid->N[0], &i0, &i1);
+			get_block_range(bj, grid->N[1], &j0, &j1);
+			get_block_range(bk, grid->N[2], &k0, &k1);
+			for(i=i0;i<i1;i++)
+			for(j=j0;j<j1;j++)
 			{
-				iso->cube[i][j][k] = get_cube(i,j,k,isolevel,grid, mapping);
-				n+=iso->cube[i][j][k].Ntriangles;
+				Cube* row = get_iso_row(iso, i, j);
+				for(k=k0;k<k1;k++) row[k] = get_cube(i,j,k,isolevel,grid, mapping);
 			}
 		}
 	}
-	iso->grid = grid;
 
 	return iso;
 }
 /**************************************************************/
-
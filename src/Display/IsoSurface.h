@@ -41,10 +41,12 @@ typedef struct _IsoSurface
 {
 	gint N[3];
 	Cube ***cube;
+	Cube *emptyRow;
 	Grid *grid;
 }IsoSurface;
 IsoSurface* define_iso_surface(Grid* grid,gdouble isolevel, gboolean mapping);
 IsoSurface* iso_free(IsoSurface* iso);
+void reset_iso_surface_index(Grid* grid);
 
 #endif /* __GABEDIT_ISOSURFACE_H__ */
 
@@ -0,0 +1,370 @@
+/* MEPTreeCode.c */
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+/* Electrostatic potential of point charges on a grid by a treecode :
+ * the sources are sorted in an octree, each cell carries its charge, dipole and second moments about its centre.
+ * The grid is cut in blocks of TBLOCK^3 points, for each block the tree is walked once :
+ * a cell seen from the block under an angle (rCell+rBlock)/distance < theta is used by its multipole expansion,
+ * the other cells are opened, the leaves are summed directly.
+ */
+
+#include "../../Config.h"
+#ifdef ENABLE_OMP
+#include <omp.h>
+#endif
+#include "GlobalOrb.h"
+#include "StatusOrb.h"
+#include "../Display/MEPTreeCode.h"
+
+#define LEAFSIZE 8
+#define TBLOCK 4
+#define PRECISION 1e-13
+
+typedef struct _MEPTreeCell
+{
+	gdouble center[3];
+	gdouble radius;
+	gdouble q;
+	gdouble d[3];
+	gdouble m[6]; /* xx, yy, zz, xy, xz, yz */
+	gint first;
+	gint n;
+	gint child;
+	gint nChildren;
+}MEPTreeCell;
+
+struct _MEPTreeCode
+{
+	gint nSources;
+	gdouble* x;
+	gdouble* y;
+	gdouble* z;
+	gdouble* q;
+	gint nCells;
+	gint maxCells;
+	MEPTreeCell* cells;
+	gdouble theta;
+};
+
+/**************************************************************************/
+static void setMEPTreeCell(MEPTreeCode* tree, MEPTreeCell* cell)
+{
+	gint i, c;
+	gdouble xmin[3], xmax[3];
+	gdouble r2 = 0;
+
+	for(c=0;c<3;c++) cell->d[c] = 0;
+	for(c=0;c<6;c++) cell->m[c] = 0;
+	cell->q = 0;
+	xmin[0] = xmax[0] = tree->x[cell->first];
+	xmin[1] = xmax[1] = tree->y[cell->first];
+	xmin[2] = xmax[2] = tree->z[cell->first];
+	for(i=cell->first;i<cell->first+cell->n;i++)
+	{
+		gdouble r[3] = {tree->x[i], tree->y[i], tree->z[i]};
+		for(c=0;c<3;c++)
+		{
+			if(r[c]<xmin[c]) xmin[c] = r[c];
+			if(r[c]>xmax[c]) xmax[c] = r[c];
+		}
+	}
+	for(c=0;c<3;c++) cell->center[c] = (xmin[c]+xmax[c])/2;
+	for(i=cell->first;i<cell->first+cell->n;i++)
+	{
+		gdouble dx = tree->x[i]-cell->center[0];
+		gdouble dy = tree->y[i]-cell->center[1];
+		gdouble dz = tree->z[i]-cell->center[2];
+		gdouble qi = tree->q[i];
+		gdouble d2 = dx*dx+dy*dy+dz*dz;
+		if(d2>r2) r2 = d2;
+		cell->q += qi;
+		cell->d[0] += qi*dx;
+		cell->d[1] += qi*dy;
+		cell->d[2] += qi*dz;
+		cell->m[0] += qi*dx*dx;
+		cell->m[1] += qi*dy*dy;
+		cell->m[2] += qi*dz*dz;
+		cell->m[3] += qi*dx*dy;
+		cell->m[4] += qi*dx*dz;
+		cell->m[5] += qi*dy*dz;
+	}
+	cell->radius = sqrt(r2);
+	cell->child = -1;
+	cell->nChildren = 0;
+}
+/**************************************************************************/
+static void swapMEPSources(MEPTreeCode* tree, gint i, gint j)
+{
+	gdouble t;
+	t = tree->x[i]; tree->x[i] = tree->x[j]; tree->x[j] = t;
+	t = tree->y[i]; tree->y[i] = tree->y[j]; tree->y[j] = t;
+	t = tree->z[i]; tree->z[i] = tree->z[j]; tree->z[j] = t;
+	t = tree->q[i]; tree->q[i] = tree->q[j]; tree->q[j] = t;
+}
+/**************************************************************************/
+static gint getOctant(MEPTreeCode* tree, gint i, gdouble center[])
+{
+	return (tree->x[i]>center[0]) + 2*(tree->y[i]>center[1]) + 4*(tree->z[i]>center[2]);
+}
+/**************************************************************************/
+/* the sources of the cell are sorted by octant about its centre, the non empty octants become its children */
+static void splitMEPTreeCell(MEPTreeCode* tree, gint icell)
+{
+	MEPTreeCell cell = tree->cells[icell];
+	gint count[8] = {0,0,0,0,0,0,0,0};
+	gint begin[8];
+	gint next[8];
+	gint o, i, nc;
+
+	if(cell.n<=LEAFSIZE || cell.radius<1e-8) return;
+	for(i=cell.first;i<cell.first+cell.n;i++) count[getOctant(tree, i, cell.center)]++;
+	begin[0] = cell.first;
+	for(o=1;o<8;o++) begin[o] = begin[o-1]+count[o-1];
+	for(o=0;o<8;o++) next[o] = begin[o];
+	for(o=0;o<8;o++)
+	while(next[o]<begin[o]+count[o])
+	{
+		gint oi = getOctant(tree, next[o], cell.center);
+		if(oi==o) next[o]++;
+		else swapMEPSources(tree, next[o], next[oi]++);
+	}
+	for(o=0,nc=0;o<8;o++) if(count[o]>0) nc++;
+	if(tree->nCells+nc>tree->maxCells)
+	{
+		tree->maxCells = 2*(tree->nCells+nc);
+		tree->cells = g_realloc(tree->cells, tree->maxCells*sizeof(MEPTreeCell));
+	}
+	tree->cells[icell].child = tree->nCells;
+	tree->cells[icell].nChildren = nc;
+	for(o=0;o<8;o++)
+	{
+		if(count[o]<1) continue;
+		tree->cells[tree->nCells].first = begin[o];
+		tree->cells[tree->nCells].n = count[o];
+		setMEPTreeCell(tree, &tree->cells[tree->nCells]);
+		tree->nCells++;
+	}
+	for(i=0;i<nc;i++) splitMEPTreeCell(tree, tree->cells[icell].child+i);
+}
+/**************************************************************************/
+MEPTreeCode* newMEPTreeCode(gint nSources, gdouble* xyz, gdouble* q, gdouble theta)
+{
+	MEPTreeCode* tree = g_malloc(sizeof(MEPTreeCode));
+	gint i;
+
+	tree->nSources = nSources;
+	tree->theta = theta;
+	tree->x = g_malloc((nSources+1)*sizeof(gdouble));
+	tree->y = g_malloc((nSources+1)*sizeof(gdouble));
+	tree->z = g_malloc((nSources+1)*sizeof(gdouble));
+	tree->q = g_malloc((nSources+1)*sizeof(gdouble));
+	for(i=0;i<nSources;i++)
+	{
+		tree->x[i] = xyz[3*i];
+		tree->y[i] = xyz[3*i+1];
+		tree->z[i] = xyz[3*i+2];
+		tree->q[i] = q[i];
+	}
+	tree->nCells = 0;
+	tree->maxCells = 2*(nSources/LEAFSIZE+1);
+	tree->cells = g_malloc(tree->maxCells*sizeof(MEPTreeCell));
+	if(nSources>0)
+	{
+		tree->cells[0].first = 0;
+		tree->cells[0].n = nSources;
+		setMEPTreeCell(tree, &tree->cells[0]);
+		tree->nCells = 1;
+		splitMEPTreeCell(tree, 0);
+	}
+	return tree;
+}
+/**************************************************************************/
+void freeMEPTreeCode(MEPTreeCode* tree)
+{
+	if(!tree) return;
+	g_free(tree->x);
+	g_free(tree->y);
+	g_free(tree->z);
+	g_free(tree->q);
+	g_free(tree->cells);
+	g_free(tree);
+}
+/**************************************************************************/
+/* cells used by their expansion (far) and leaves summed directly (near) for targets in the sphere (center, radius) */
+static void getMEPInteractions(MEPTreeCode* tree, gdouble center[], gdouble radius, gint* stack, gint* far, gint* nFar, gint* near, gint* nNear)
+{
+	gint n = 0;
+	*nFar = 0;
+	*nNear = 0;
+	if(tree->nCells<1) return;
+	stack[n++] = 0;
+	while(n>0)
+	{
+		MEPTreeCell* cell = &tree->cells[stack[--n]];
+		gdouble dx = cell->center[0]-center[0];
+		gdouble dy = cell->center[1]-center[1];
+		gdouble dz = cell->center[2]-center[2];
+		gdouble r = sqrt(dx*dx+dy*dy+dz*dz);
+		gdouble s = cell->radius+radius;
+		if(s<tree->theta*r) far[(*nFar)++] = cell-tree->cells;
+		else if(cell->nChildren==0) near[(*nNear)++] = cell-tree->cells;
+		else
+		{
+			gint i;
+			for(i=cell->nChildren-1;i>=0;i--) stack[n++] = cell->child+i;
+		}
+	}
+}
+/**************************************************************************/
+static gdouble getMEPValue(MEPTreeCode* tree, gint* far, gint nFar, gint* near, gint nNear, gdouble x, gdouble y, gdouble z)
+{
+	gdouble v = 0;
+	gint l, i;
+
+	for(l=0;l<nFar;l++)
+	{
+		MEPTreeCell* cell = &tree->cells[far[l]];
+		gdouble* m = cell->m;
+		gdouble dx = x-cell->center[0];
+		gdouble dy = y-cell->center[1];
+		gdouble dz = z-cell->center[2];
+		gdouble r2 = dx*dx+dy*dy+dz*dz;
+		gdouble invR = 1.0/sqrt(r2);
+		gdouble invR2 = invR*invR;
+		gdouble mRR = m[0]*dx*dx+m[1]*dy*dy+m[2]*dz*dz+2*(m[3]*dx*dy+m[4]*dx*dz+m[5]*dy*dz);
+
+		v += invR*(cell->q
+			+ (cell->d[0]*dx+cell->d[1]*dy+cell->d[2]*dz)*invR2
+			+ (3*mRR*invR2-(m[0]+m[1]+m[2]))*invR2/2);
+	}
+	for(l=0;l<nNear;l++)
+	{
+		MEPTreeCell* cell = &tree->cells[near[l]];
+		for(i=cell->first;i<cell->first+cell->n;i++)
+		{
+			gdouble dx = x-tree->x[i];
+			gdouble dy = y-tree->y[i];
+			gdouble dz = z-tree->z[i];
+			v += tree->q[i]/sqrt(dx*dx+dy*dy+dz*dz+PRECISION);
+		}
+	}
+	return v;
+}
+/**************************************************************************/
+gdouble getMEPDirectValue(MEPTreeCode* tree, gdouble x, gdouble y, gdouble z)
+{
+	gdouble v = 0;
+	gint i;
+	for(i=0;i<tree->nSources;i++)
+	{
+		gdouble dx = x-tree->x[i];
+		gdouble dy = y-tree->y[i];
+		gdouble dz = z-tree->z[i];
+		v += tree->q[i]/sqrt(dx*dx+dy*dy+dz*dz+PRECISION);
+	}
+	return v;
+}
+/**************************************************************************/
+gdouble getMEPTreeCodeValue(MEPTreeCode* tree, gdouble x, gdouble y, gdouble z)
+{
+	gint* lists = g_malloc(3*(tree->nCells+1)*sizeof(gint));
+	gint nFar, nNear;
+	gdouble center[3] = {x, y, z};
+	gdouble v;
+
+	getMEPInteractions(tree, center, 0.0, lists, lists+tree->nCells+1, &nFar, lists+2*(tree->nCells+1), &nNear);
+	v = getMEPValue(tree, lists+tree->nCells+1, nFar, lists+2*(tree->nCells+1), nNear, x, y, z);
+	g_free(lists);
+	return v;
+}
+/**************************************************************************/
+gboolean addMEPTreeCodeToGrid(MEPTreeCode* tree, Grid* grid)
+{
+	gint nb[3];
+	gint nBlocks;
+	gint b;
+	gdouble scale;
+
+	if(!tree || !grid) return FALSE;
+	if(tree->nSources<1) return TRUE;
+	for(b=0;b<3;b++) nb[b] = (grid->N[b]+TBLOCK-1)/TBLOCK;
+	nBlocks = nb[0]*nb[1];
+	scale = (gdouble)1.01/nBlocks;
+
+	progress_orb(0,GABEDIT_PROGORB_COMPMEPGRID,TRUE);
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(b) schedule(dynamic)
+#endif
+	for(b=0;b<nBlocks;b++)
+	{
+		gint* stack = g_malloc(3*(tree->nCells+1)*sizeof(gint));
+		gint* far = stack+tree->nCells+1;
+		gint* near = stack+2*(tree->nCells+1);
+		gint i0 = (b/nb[1])*TBLOCK;
+		gint j0 = (b%nb[1])*TBLOCK;
+		gint i1 = MIN(i0+TBLOCK, grid->N[0]);
+		gint j1 = MIN(j0+TBLOCK, grid->N[1]);
+		gint k0, k1;
+		gint i, j, k, c;
+		gint nFar, nNear;
+
+		if(!CancelCalcul)
+		for(k0=0;k0<grid->N[2];k0+=TBLOCK)
+		{
+			gdouble xmin[3], xmax[3];
+			gdouble center[3];
+			gdouble r2 = 0;
+			Point5* p;
+			k1 = MIN(k0+TBLOCK, grid->N[2]);
+			/* the grid is linear in i,j,k : the corners of the block bound its points */
+			for(c=0;c<3;c++) xmin[c] = xmax[c] = grid->point[i0][j0][k0].C[c];
+			for(i=i0;i<i1;i+=MAX(1,i1-i0-1))
+			for(j=j0;j<j1;j+=MAX(1,j1-j0-1))
+			for(k=k0;k<k1;k+=MAX(1,k1-k0-1))
+			for(c=0;c<3;c++)
+			{
+				if(grid->point[i][j][k].C[c]<xmin[c]) xmin[c] = grid->point[i][j][k].C[c];
+				if(grid->point[i][j][k].C[c]>xmax[c]) xmax[c] = grid->point[i][j][k].C[c];
+			}
+			for(c=0;c<3;c++)
+			{
+				center[c] = (xmin[c]+xmax[c])/2;
+				r2 += (xmax[c]-xmin[c])*(xmax[c]-xmin[c])/4;
+			}
+			getMEPInteractions(tree, center, sqrt(r2), stack, far, &nFar, near, &nNear);
+			for(i=i0;i<i1;i++)
+			for(j=j0;j<j1;j++)
+			for(k=k0;k<k1;k++)
+			{
+				p = &grid->point[i][j][k];
+				p->C[3] += getMEPValue(tree, far, nFar, near, nNear, p->C[0], p->C[1], p->C[2]);
+			}
+		}
+		g_free(stack);
+#ifdef ENABLE_OMP
+#ifndef G_OS_WIN32
+#pragma omp critical
+		progress_orb(scale,GABEDIT_PROGORB_COMPMEPGRID,FALSE);
+#endif
+#else
+		progress_orb(scale,GABEDIT_PROGORB_COMPMEPGRID,FALSE);
+#endif
+	}
+	progress_orb(0,GABEDIT_PROGORB_COMPMEPGRID,TRUE);
+	return !CancelCalcul;
+}
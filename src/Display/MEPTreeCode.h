@@ -0,0 +1,34 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#ifndef __GABEDIT_MEPTREECODE_H__
+#define __GABEDIT_MEPTREECODE_H__
+
+typedef struct _MEPTreeCode MEPTreeCode;
+
+/* xyz[3*i+c] : coordinates of the source i, q[i] its charge.
+ * theta : opening angle of the multipole acceptance criterion, 0 for the direct sum. */
+MEPTreeCode* newMEPTreeCode(gint nSources, gdouble* xyz, gdouble* q, gdouble theta);
+void freeMEPTreeCode(MEPTreeCode* tree);
+gdouble getMEPTreeCodeValue(MEPTreeCode* tree, gdouble x, gdouble y, gdouble z);
+gdouble getMEPDirectValue(MEPTreeCode* tree, gdouble x, gdouble y, gdouble z);
+/* add the potential of the sources to C[3] of every point of the grid, return FALSE if cancelled */
+gboolean addMEPTreeCodeToGrid(MEPTreeCode* tree, Grid* grid);
+
+#endif /* __GABEDIT_MEPTREECODE_H__ */
+
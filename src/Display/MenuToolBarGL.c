@@ -65,6 +65,7 @@ DEALINGS IN THE SOFTWARE.
 #include "../Display/TriangleDraw.h"
 #include "../Display/NCI.h"
 #include "../Common/StockIcons.h"
+#include "../Common/Preferences.h"
 
 enum 
 {
@@ -281,6 +282,10 @@ static void activate_action (GtkAction *action)
 			TypeGrid = GABEDIT_TYPEGRID_ORBITAL;
 			 capture_orbitals_dlg();
 	}
+	else if(!strcmp(name , "OrbitalsSetGridAOMemory"))
+	{
+		set_grid_ao_memory_dialog ();
+	}
 	else if(!strcmp(name , "OrbitalsReactivityIndicesFMO"))
 	{
 			TypeGrid = GABEDIT_TYPEGRID_ORBITAL;
@@ -326,11 +331,21 @@ static void activate_action (GtkAction *action)
 			TypeGrid = GABEDIT_TYPEGRID_ORBITAL;
 			compute_mulliken_charges();
 	}
+	else if(!strcmp(name , "LowdinCharges"))
+	{
+			TypeGrid = GABEDIT_TYPEGRID_ORBITAL;
+			compute_lowdin_charges();
+	}
 	else if(!strcmp(name , "BondOrder"))
 	{
 			TypeGrid = GABEDIT_TYPEGRID_ORBITAL;
 			compute_bondOrders();
 	}
+	else if(!strcmp(name , "WibergBondOrder"))
+	{
+			TypeGrid = GABEDIT_TYPEGRID_ORBITAL;
+			compute_wiberg_bondOrders();
+	}
 	else if(!strcmp(name , "CubeLoadGaussianOrbitals" ))
  		file_chooser_open(load_cube_gauss_orbitals_file,_("Load Gaussian orbitals cube file"),GABEDIT_TYPEFILE_CUBEGAUSS,GABEDIT_TYPEWIN_ORB);
 	else if(!strcmp(name , "CubeLoadGaussianDensity"))
@@ -374,6 +389,13 @@ static void activate_action (GtkAction *action)
 		if(!grid) Message(_("Sorry, you have not a default grid"),_("Error"),TRUE);
 		else file_chooser_save(save_cube_gabedit_file,"Save density",GABEDIT_TYPEFILE_CUBEGABEDIT,GABEDIT_TYPEWIN_ORB);
 	}
+	else if(!strcmp(name , "CubeLoadGabeditBinaryRead"))
+ 		file_chooser_open(load_gabedit_binary_grid_file,_("Load Gabedit binary grid file"),GABEDIT_TYPEFILE_GRIDBINARY,GABEDIT_TYPEWIN_ORB);
+	else if(!strcmp(name , "CubeLoadGabeditBinarySave"))
+	{
+		if(!grid) Message(_("Sorry, you have not a default grid"),_("Error"),TRUE);
+		else file_chooser_save(save_gabedit_binary_grid_file,_("Save grid in a binary file"),GABEDIT_TYPEFILE_GRIDBINARY,GABEDIT_TYPEWIN_ORB);
+	}
 	else if(!strcmp(name , "CubeSubtract"))
 	{
 		if(!grid) Message(_("Sorry, you have not a default grid"),_("Error"),TRUE);
@@ -543,6 +565,7 @@ static void activate_action (GtkAction *action)
 		CancelCalcul = FALSE;
 		create_grid(_("Calculation of MEP from partial charges of atoms"));
 	}
+	else if(!strcmp(name , "MEPTreecode")) set_treecode_theta_dlg();
 	else if(!strcmp(name , "MEPGridMultipol"))
 	{
 		CancelCalcul = FALSE;
@@ -1030,6 +1053,7 @@ static GtkActionEntry gtkActionEntries[] =
 	{"OrbitalsSelection", GABEDIT_STOCK_SELECT_ALL, N_("_Selection"), 
 		NULL, "Select an orbital", G_CALLBACK (activate_action) },
 	{"OrbitalsCapture", GABEDIT_STOCK_SELECT_ALL, N_("_Slideshow"), NULL, "Slideshow", G_CALLBACK (activate_action) },
+	{"OrbitalsSetGridAOMemory", NULL, N_("Set _memory for the basis functions on the grid"), NULL, "Set memory for the basis functions on the grid", G_CALLBACK (activate_action) },
 	{"OrbitalsReactivityIndicesFMO", NULL, N_("_Reactivity Indices (FMO)"), NULL, "ReactivityFMO", G_CALLBACK (activate_action) },
 	{"OrbitalsReactivityIndicesFD", NULL, N_("_Reactivity Indices (FD)"), NULL, "ReactivityFD", G_CALLBACK (activate_action) },
 	{"OrbitalsCoulomb", NULL, N_("_Coulomb integral"), NULL, "Coulomb", G_CALLBACK (activate_action) },
@@ -1039,7 +1063,9 @@ static GtkActionEntry gtkActionEntries[] =
 	{"OrbitalsLambdaDiagnostic", NULL, N_("_Lambda diagnostic "), NULL, "TM", G_CALLBACK (activate_action) },
 	{"OrbitalsOverlap", NULL, N_("Compute _overlap matrix"), NULL, "Overlap", G_CALLBACK (activate_action) },
 	{"MullikenCharges", NULL, N_("Compute _Mulliken charges"), NULL, "Mulliken", G_CALLBACK (activate_action) },
+	{"LowdinCharges", NULL, N_("Compute _Lowdin charges"), NULL, "Lowdin", G_CALLBACK (activate_action) },
 	{"BondOrder", NULL, N_("Compute _Bond orders"), NULL, "Bond orders", G_CALLBACK (activate_action) },
+	{"WibergBondOrder", NULL, N_("Compute _Wiberg bond orders"), NULL, "Wiberg bond orders", G_CALLBACK (activate_action) },
 	{"Cube",     NULL, N_("_Cube&Grid")},
 
 	{"CubeLoadGaussian",  GABEDIT_STOCK_GAUSSIAN, N_("Load _Gaussian cube")},
@@ -1081,6 +1107,8 @@ static GtkActionEntry gtkActionEntries[] =
 	{"CubeLoadDXRead",NULL, N_("Load _DX cube file"), NULL, "Read a DX grid file", G_CALLBACK (activate_action) },
 	{"CubeLoadGabeditRead", GABEDIT_STOCK_GABEDIT, N_("Load G_abedit cube file"), NULL, "Read a Gabedit cube file", G_CALLBACK (activate_action) },
 	{"CubeLoadGabeditSave", GABEDIT_STOCK_SAVE, N_("_Save"), NULL, "Save in a Gabedit cube file", G_CALLBACK (activate_action) },
+	{"CubeLoadGabeditBinaryRead", NULL, N_("Load Gabedit _binary grid file"), NULL, "Read a Gabedit binary grid file", G_CALLBACK (activate_action) },
+	{"CubeLoadGabeditBinarySave", NULL, N_("Save in a b_inary grid file"), NULL, "Save in a Gabedit binary grid file", G_CALLBACK (activate_action) },
 	{"CubeComputeLaplacian", NULL, N_("Compute _laplacian"), NULL, "Compute laplacian", G_CALLBACK (activate_action) },
 	{"CubeComputeNormGradient", NULL, N_("Compute the norm of the _gradient"), NULL, "Compute the norm of the _gradient", G_CALLBACK (activate_action) },
 	{"CubeSignLambda2Density", NULL, N_("Multiply by the sign of the _middle eigenvalue of hessian"), NULL, "Compute sign _lambda2 * grid", G_CALLBACK (activate_action) },
@@ -1150,6 +1178,7 @@ static GtkActionEntry gtkActionEntries[] =
 	{"MEPGridCG", NULL, N_("MEP by solving Poisson Equation using _Congugate Gradient method"), NULL, "MEP by solving Poisson Equation using Congugate Gradient method", G_CALLBACK (activate_action) },
 	{"MEPGridMultipol", NULL, N_("MEP using Multipole"), NULL, "MEP using Multipole", G_CALLBACK (activate_action) },
 	{"MEPFromCharges", NULL, N_("MEP using partial _charges"), NULL, "MEP using partial charges", G_CALLBACK (activate_action) },
+	{"MEPTreecode", NULL, N_("_Accuracy of the MEP from charges"), NULL, "Set the opening angle of the treecode used for the MEP from charges", G_CALLBACK (activate_action) },
 
 	{"Contours",     NULL, N_("Co_ntours")},
 	{"ContoursFirst", NULL, N_("plane perpendicular to the _first direction"), 
@@ -1793,6 +1822,7 @@ static const gchar *uiMenuInfo =
 "      <menuitem name=\"OrbitalsSelection\" action=\"OrbitalsSelection\" />\n"
 "      <separator name=\"sepMenuGabeditOrbCap\" />\n"
 "      <menuitem name=\"OrbitalsCapture\" action=\"OrbitalsCapture\" />\n"
+"      <menuitem name=\"OrbitalsSetGridAOMemory\" action=\"OrbitalsSetGridAOMemory\" />\n"
 "      <separator name=\"sepMenuGabeditOrbRI\" />\n"
 "      <separator name=\"sepMenuGabeditOrbCoul\" />\n"
 "      <menuitem name=\"OrbitalsCoulomb\" action=\"OrbitalsCoulomb\" />\n"
@@ -1801,7 +1831,9 @@ static const gchar *uiMenuInfo =
 "      <menuitem name=\"OrbitalsSpatialOverlapIJ\" action=\"OrbitalsSpatialOverlapIJ\" />\n"
 "      <menuitem name=\"OrbitalsLambdaDiagnostic\" action=\"OrbitalsLambdaDiagnostic\" />\n"
 "      <menuitem name=\"MullikenCharges\" action=\"MullikenCharges\" />\n"
+"      <menuitem name=\"LowdinCharges\" action=\"LowdinCharges\" />\n"
 "      <menuitem name=\"BondOrder\" action=\"BondOrder\" />\n"
+"      <menuitem name=\"WibergBondOrder\" action=\"WibergBondOrder\" />\n"
 /*
 "      <menuitem name=\"OrbitalsOverlap\" action=\"OrbitalsOverlap\" />\n"
 */
@@ -1847,6 +1879,9 @@ static const gchar *uiMenuInfo =
 "      <menuitem name=\"CubeLoadGabeditRead\" action=\"CubeLoadGabeditRead\" />\n"
 "      <separator name=\"sepMenuCubeLoadGabeditSave\" />\n"
 "      <menuitem name=\"CubeLoadGabeditSave\" action=\"CubeLoadGabeditSave\" />\n"
+"      <separator name=\"sepMenuCubeLoadGabeditBinary\" />\n"
+"      <menuitem name=\"CubeLoadGabeditBinaryRead\" action=\"CubeLoadGabeditBinaryRead\" />\n"
+"      <menuitem name=\"CubeLoadGabeditBinarySave\" action=\"CubeLoadGabeditBinarySave\" />\n"
 "      <separator name=\"sepMenuCubeComputeLaplacian\" />\n"
 "      <menuitem name=\"CubeComputeLaplacian\" action=\"CubeComputeLaplacian\" />\n"
 "      <separator name=\"sepMenuCubeComputeNormGradient\" />\n"
@@ -1949,6 +1984,8 @@ static const gchar *uiMenuInfo =
 "        <menuitem name=\"MEPGridMultipol\" action=\"MEPGridMultipol\" />\n"
 "      </menu>\n"
 "        <menuitem name=\"MEPFromCharges\" action=\"MEPFromCharges\" />\n"
+"        <separator name=\"sepMenuMEPTreecode\" />\n"
+"        <menuitem name=\"MEPTreecode\" action=\"MEPTreecode\" />\n"
 "    </menu>\n"
 
 "    <separator name=\"sepMenuContours\" />\n"
@@ -2297,7 +2334,9 @@ static void set_sensitive_orbitals()
 	GtkWidget *orbSpatialOverlapij = gtk_ui_manager_get_widget (manager, "/MenuGL/Orbitals/OrbitalsSpatialOverlapIJ");
 	GtkWidget *orbLambdaDiagnostic = gtk_ui_manager_get_widget (manager, "/MenuGL/Orbitals/OrbitalsLambdaDiagnostic");
 	GtkWidget *mullikenCharges = gtk_ui_manager_get_widget (manager, "/MenuGL/Orbitals/MullikenCharges");
+	GtkWidget *lowdinCharges = gtk_ui_manager_get_widget (manager, "/MenuGL/Orbitals/LowdinCharges");
 	GtkWidget *bondorder = gtk_ui_manager_get_widget (manager, "/MenuGL/Orbitals/BondOrder");
+	GtkWidget *wibergBondorder = gtk_ui_manager_get_widget (manager, "/MenuGL/Orbitals/WibergBondOrder");
 	/* GtkWidget *orbOverlap = gtk_ui_manager_get_widget (manager, "/MenuGL/Orbitals/OrbitalsOverlap");*/
 	gboolean sensitive = TRUE;
   	if(NAOrb<1) sensitive = FALSE;
@@ -2309,7 +2348,9 @@ static void set_sensitive_orbitals()
 	if(GTK_IS_WIDGET(orbReactivityFMO)) gtk_widget_set_sensitive(orbReactivityFMO, sensitive);
 	if(GTK_IS_WIDGET(orbTransition)) gtk_widget_set_sensitive(orbTransition, sensitive);
 	if(GTK_IS_WIDGET(mullikenCharges)) gtk_widget_set_sensitive(mullikenCharges, sensitive);
+	if(GTK_IS_WIDGET(lowdinCharges)) gtk_widget_set_sensitive(lowdinCharges, sensitive);
 	if(GTK_IS_WIDGET(bondorder)) gtk_widget_set_sensitive(bondorder, sensitive);
+	if(GTK_IS_WIDGET(wibergBondorder)) gtk_widget_set_sensitive(wibergBondorder, sensitive);
 	/* if(GTK_IS_WIDGET(orbOverlap)) gtk_widget_set_sensitive(orbOverlap, sensitive);*/
 	if(GTK_IS_WIDGET(orbSpatialOverlapiijj)) gtk_widget_set_sensitive(orbSpatialOverlapiijj, sensitive);
 	if(GTK_IS_WIDGET(orbSpatialOverlapij)) gtk_widget_set_sensitive(orbSpatialOverlapij, sensitive);
@@ -2319,6 +2360,7 @@ static void set_sensitive_orbitals()
 static void set_sensitive_cube()
 {
 	GtkWidget *cubeSave = gtk_ui_manager_get_widget (manager, "/MenuGL/Cube/CubeLoadGabeditSave");
+	GtkWidget *cubeSaveBinary = gtk_ui_manager_get_widget (manager, "/MenuGL/Cube/CubeLoadGabeditBinarySave");
 	GtkWidget *cubeSubtract = gtk_ui_manager_get_widget (manager, "/MenuGL/Cube/CubeSubtract");
 	GtkWidget *cubeScale = gtk_ui_manager_get_widget (manager, "/MenuGL/Cube/CubeScale");
 	GtkWidget *cubeSquare = gtk_ui_manager_get_widget (manager, "/MenuGL/Cube/CubeSquare");
@@ -2335,6 +2377,7 @@ static void set_sensitive_cube()
 	gboolean sensitive = TRUE;
   	if(!grid) sensitive = FALSE;
 	if(GTK_IS_WIDGET(cubeSave)) gtk_widget_set_sensitive(cubeSave, sensitive);
+	if(GTK_IS_WIDGET(cubeSaveBinary)) gtk_widget_set_sensitive(cubeSaveBinary, sensitive);
 	if(GTK_IS_WIDGET(cubeSubtract)) gtk_widget_set_sensitive(cubeSubtract, sensitive);
 	if(GTK_IS_WIDGET(cubeScale)) gtk_widget_set_sensitive(cubeScale, sensitive);
 	if(GTK_IS_WIDGET(cubeSquare)) gtk_widget_set_sensitive(cubeSquare, sensitive);
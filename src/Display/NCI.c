@@ -37,30 +37,168 @@ DEALINGS IN THE SOFTWARE.
 #define M_PI 3.141592653589793238462643383279502884
 #endif
 
+/* points of a (j,k) tile swept together, the stencils of a tile stay in cache */
+#define NCIBLOCK 16
+typedef struct _NCIStencil
+{
+	gint nBoundary;
+	gdouble* fcx;
+	gdouble* fcy;
+	gdouble* fcz;
+	gdouble* lfcx;
+	gdouble* lfcy;
+	gdouble* lfcz;
+}NCIStencil;
 /*********************************************************************************************************************************/
-static gint compute_nci2D_from_density_grid(Grid* grid, gdouble densityCutOff, gdouble RDGCutOff, gint nBoundary, gdouble**pX, gdouble**pY)
+static void initNCIStencil(NCIStencil* st, Grid* grid, gint nBoundary)
 {
-	gint i;
-	gint j;
-	gint k;
-	gint kn;
+	gint i, j, k;
 	gdouble xh, yh, zh;
 	gdouble a, b, c;
-	/* gint N[3] = {0,0,0};*/
-	gdouble* fcx =  NULL;
-	gdouble* fcy =  NULL;
-	gdouble* fcz =  NULL;
-	gdouble cc = 0;
-
-	gdouble* lfcx =  NULL;
-	gdouble* lfcy =  NULL;
-	gdouble* lfcz =  NULL;
 	gdouble lcc;
-	GridLimits limits;
+
+	i = 1; j = 0; k = 0;
+	a = grid->point[i][j][k].C[0]-grid->point[0][0][0].C[0];
+	b = grid->point[i][j][k].C[1]-grid->point[0][0][0].C[1];
+	c = grid->point[i][j][k].C[2]-grid->point[0][0][0].C[2];
+	xh = sqrt(a*a+b*b+c*c);
+
+	i = 0; j = 1; k = 0;
+	a = grid->point[i][j][k].C[0]-grid->point[0][0][0].C[0];
+	b = grid->point[i][j][k].C[1]-grid->point[0][0][0].C[1];
+	c = grid->point[i][j][k].C[2]-grid->point[0][0][0].C[2];
+	yh = sqrt(a*a+b*b+c*c);
+
+	i = 0; j = 0; k = 1;
+	a = grid->point[i][j][k].C[0]-grid->point[0][0][0].C[0];
+	b = grid->point[i][j][k].C[1]-grid->point[0][0][0].C[1];
+	c = grid->point[i][j][k].C[2]-grid->point[0][0][0].C[2];
+	zh = sqrt(a*a+b*b+c*c);
+
+	st->nBoundary = nBoundary;
+	st->fcx =  g_malloc((nBoundary)*sizeof(gdouble));
+	st->fcy =  g_malloc((nBoundary)*sizeof(gdouble));
+	st->fcz =  g_malloc((nBoundary)*sizeof(gdouble));
+	getCoefsGradient(nBoundary, xh, yh, zh,  st->fcx,  st->fcy, st->fcz);
+
+	st->lfcx =  g_malloc((nBoundary+1)*sizeof(gdouble));
+	st->lfcy =  g_malloc((nBoundary+1)*sizeof(gdouble));
+	st->lfcz =  g_malloc((nBoundary+1)*sizeof(gdouble));
+	getCoefsLaplacian(nBoundary, xh, yh, zh,  st->lfcx,  st->lfcy, st->lfcz, &lcc);
+}
+/*********************************************************************************************************************************/
+static void freeNCIStencil(NCIStencil* st)
+{
+	g_free(st->fcx);
+	g_free(st->fcy);
+	g_free(st->fcz);
+	g_free(st->lfcx);
+	g_free(st->lfcy);
+	g_free(st->lfcz);
+}
+/*********************************************************************************************************************************/
+static gdouble getNCIGradient2(Grid* grid, gint i, gint j, gint k, NCIStencil* st)
+{
+	gint n, kn;
+	gint nBoundary = st->nBoundary;
+	gdouble gx = 0, gy = 0, gz = 0;
+
+	for(n=-nBoundary, kn=0 ; kn<nBoundary ; n++, kn++)
+	{
+		gx += st->fcx[kn] * (grid->point[i+n][j][k].C[3]-grid->point[i-n][j][k].C[3]);
+		gy += st->fcy[kn] * (grid->point[i][j+n][k].C[3]-grid->point[i][j-n][k].C[3]);
+		gz += st->fcz[kn] * (grid->point[i][j][k+n].C[3]-grid->point[i][j][k-n].C[3]) ;
+	}
+	return gx*gx+gy*gy+gz*gz;
+}
+/*********************************************************************************************************************************/
+/* middle eigenvalue of a symmetric 3x3 matrix, closed form (trigonometric solution of the characteristic polynomial) */
+static gdouble getMiddleEigenValue(gdouble xx, gdouble yy, gdouble zz, gdouble xy, gdouble xz, gdouble yz)
+{
+	gdouble p1 = xy*xy+xz*xz+yz*yz;
+	gdouble q = (xx+yy+zz)/3;
+	gdouble p, r, phi;
+	gdouble bxx, byy, bzz;
+	gdouble eMax, eMin;
+
+	if(p1<=0)
+	{
+		if(xx>yy) { p = xx; xx = yy; yy = p;}
+		if(yy>zz) { p = yy; yy = zz; zz = p;}
+		if(xx>yy) { p = xx; xx = yy; yy = p;}
+		return yy;
+	}
+	p = sqrt(((xx-q)*(xx-q)+(yy-q)*(yy-q)+(zz-q)*(zz-q)+2*p1)/6);
+	bxx = (xx-q)/p;
+	byy = (yy-q)/p;
+	bzz = (zz-q)/p;
+	xy /= p;
+	xz /= p;
+	yz /= p;
+	r = (bxx*(byy*bzz-yz*yz)-xy*(xy*bzz-yz*xz)+xz*(xy*yz-byy*xz))/2;
+	if(r<=-1) phi = M_PI/3;
+	else if(r>=1) phi = 0;
+	else phi = acos(r)/3;
+	eMax = q+2*p*cos(phi);
+	eMin = q+2*p*cos(phi+2*M_PI/3);
+	return 3*q-eMax-eMin;
+}
+/*********************************************************************************************************************************/
+/* same hessian as getLambda2 in Grid.c, without the iterative diagonalization, and thread safe */
+static gdouble getNCILambda2(Grid* grid, gint i, gint j, gint k, NCIStencil* st)
+{
+	gint n,kn, nn, knn;
+	gint nBoundary = st->nBoundary;
+	gdouble* fcx = st->fcx;
+	gdouble* fcy = st->fcy;
+	gdouble* fcz = st->fcz;
+	gdouble xx,yy,zz,xy,xz,yz;
+	gdouble gyp, gym, gzp, gzm, gzjp, gzjm;
+
+	xx = st->lfcx[0]*grid->point[i][j][k].C[3];
+	yy = st->lfcy[0]*grid->point[i][j][k].C[3];
+	zz = st->lfcz[0]*grid->point[i][j][k].C[3];
+	for(n=1;n<=nBoundary;n++)
+	{
+		xx += st->lfcx[n] *(grid->point[i-n][j][k].C[3]+grid->point[i+n][j][k].C[3]);
+		yy += st->lfcy[n] *(grid->point[i][j-n][k].C[3]+grid->point[i][j+n][k].C[3]);
+		zz += st->lfcz[n] *(grid->point[i][j][k-n].C[3]+grid->point[i][j][k+n].C[3]);
+	}
+	xy = 0;
+	xz = 0;
+	yz = 0;
+	for(n=-nBoundary, kn=0 ; kn<nBoundary ; n++, kn++)
+	{
+		Point5** pp = grid->point[i+n];
+		Point5** pm = grid->point[i-n];
+		Point5** pi = grid->point[i];
+		gyp = gym = gzp = gzm = gzjp = gzjm = 0;
+		for(nn=-nBoundary, knn=0 ; knn<nBoundary ; nn++, knn++)
+		{
+			gyp += fcy[knn] * (pp[j+nn][k].C[3]-pp[j-nn][k].C[3]);
+			gym += fcy[knn] * (pm[j+nn][k].C[3]-pm[j-nn][k].C[3]);
+			gzp += fcz[knn] * (pp[j][k+nn].C[3]-pp[j][k-nn].C[3]);
+			gzm += fcz[knn] * (pm[j][k+nn].C[3]-pm[j][k-nn].C[3]);
+			gzjp += fcz[knn] * (pi[j+n][k+nn].C[3]-pi[j+n][k-nn].C[3]);
+			gzjm += fcz[knn] * (pi[j-n][k+nn].C[3]-pi[j-n][k-nn].C[3]);
+		}
+		xy += fcx[kn] * gyp;
+		xy += -fcx[kn] * gym;
+		xz += fcx[kn] * gzp;
+		xz += -fcx[kn] * gzm;
+		yz += fcy[kn] * gzjp;
+		yz += -fcy[kn] * gzjm;
+	}
+	return getMiddleEigenValue(xx, yy, zz, xy, xz, yz);
+}
+/*********************************************************************************************************************************/
+static gint compute_nci2D_from_density_grid(Grid* grid, gdouble densityCutOff, gdouble RDGCutOff, gint nBoundary, gdouble**pX, gdouble**pY)
+{
+	gint i;
+	gint p;
+	gint nAll;
+	NCIStencil st;
 	gdouble scale = 0;
-	gint n;
-	gboolean beg = TRUE;
-	gdouble gx, gy, gz;
 	gdouble oneOver3 = 1.0/3.0;
 	gdouble fourOver3 = 4.0/3.0;
 	gdouble fact = 0.5/pow(3*M_PI*M_PI,oneOver3);
@@ -68,15 +206,6 @@ static gint compute_nci2D_from_density_grid(Grid* grid, gdouble densityCutOff, g
 	gdouble *X;
 	gdouble *Y;
 	gint nPoints = 0;
-	gdouble s;
-	gdouble tensor[6];/* inf matrix */
-	gdouble xx;
-	gdouble yy;
-	gdouble zz;
-	gdouble xy;
-	gdouble xz;
-	gdouble yz;
-	gdouble lambda2;
 
 	*pX = NULL;
 	*pY = NULL;
@@ -91,97 +220,76 @@ static gint compute_nci2D_from_density_grid(Grid* grid, gdouble densityCutOff, g
 	if(grid->N[1]<=2*nBoundary) return nPoints;
 	if(grid->N[2]<=2*nBoundary) return nPoints;
 
-	/* for(n=0;n<3;n++) N[n] = grid->N[n];*/
-
-
-	i = 1; j = 0; k = 0;
-	a = grid->point[i][j][k].C[0]-grid->point[0][0][0].C[0];
-	b = grid->point[i][j][k].C[1]-grid->point[0][0][0].C[1];
-	c = grid->point[i][j][k].C[2]-grid->point[0][0][0].C[2];
-	xh = sqrt(a*a+b*b+c*c);
-
-	i = 0; j = 1; k = 0;
-	a = grid->point[i][j][k].C[0]-grid->point[0][0][0].C[0];
-	b = grid->point[i][j][k].C[1]-grid->point[0][0][0].C[1];
-	c = grid->point[i][j][k].C[2]-grid->point[0][0][0].C[2];
-	yh = sqrt(a*a+b*b+c*c);
-
-	i = 0; j = 0; k = 1;
-	a = grid->point[i][j][k].C[0]-grid->point[0][0][0].C[0];
-	b = grid->point[i][j][k].C[1]-grid->point[0][0][0].C[1];
-	c = grid->point[i][j][k].C[2]-grid->point[0][0][0].C[2];
-	zh = sqrt(a*a+b*b+c*c);
-
-	fcx =  g_malloc((nBoundary)*sizeof(gdouble));
-	fcy =  g_malloc((nBoundary)*sizeof(gdouble));
-	fcz =  g_malloc((nBoundary)*sizeof(gdouble));
-	getCoefsGradient(nBoundary, xh, yh, zh,  fcx,  fcy, fcz);
-
-	lfcx =  g_malloc((nBoundary+1)*sizeof(gdouble));
-	lfcy =  g_malloc((nBoundary+1)*sizeof(gdouble));
-	lfcz =  g_malloc((nBoundary+1)*sizeof(gdouble));
-	getCoefsLaplacian(nBoundary, xh, yh, zh,  lfcx,  lfcy, lfcz, &lcc);
-
+	initNCIStencil(&st, grid, nBoundary);
 
 	progress_orb(0,GABEDIT_PROGORB_COMPNCIGRID,TRUE);
-	X = g_malloc(grid->N[0]*grid->N[1]*grid->N[2]*sizeof(gdouble));
-	Y = g_malloc(grid->N[0]*grid->N[1]*grid->N[2]*sizeof(gdouble));
+	nAll = grid->N[0]*grid->N[1]*grid->N[2];
+	X = g_malloc(nAll*sizeof(gdouble));
+	Y = g_malloc(nAll*sizeof(gdouble));
+	/* Y<0 : rejected point. The points are kept at their place in the grid and packed after the sweep */
+	for(p=0;p<nAll;p++) Y[p] = -1;
 
 	scale = (gdouble)1.01/grid->N[0];
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(i) schedule(dynamic)
+#endif
 	for(i=nBoundary;i<grid->N[0]-nBoundary;i++)
 	{
-		for(j=nBoundary;j<grid->N[1]-nBoundary;j++)
+		gint j, k, j0, k0;
+		gdouble rho, s, lambda2;
+		if(!CancelCalcul)
+		for(j0=nBoundary;j0<grid->N[1]-nBoundary;j0+=NCIBLOCK)
+		for(k0=nBoundary;k0<grid->N[2]-nBoundary;k0+=NCIBLOCK)
+		for(j=j0;j<j0+NCIBLOCK && j<grid->N[1]-nBoundary;j++)
+		for(k=k0;k<k0+NCIBLOCK && k<grid->N[2]-nBoundary;k++)
 		{
-			for(k=nBoundary;k<grid->N[2]-nBoundary;k++)
+			gint p = (i*grid->N[1]+j)*grid->N[2]+k;
+			rho = grid->point[i][j][k].C[3];
+			if(densityCutOff>0 && rho>densityCutOff) continue;
+			if(rho<PRECISION) continue;
+			s = fact*sqrt(getNCIGradient2(grid, i, j, k, &st))/pow(rho,fourOver3);
+			if(RDGCutOff>0 && s>RDGCutOff) continue;
+			lambda2 = getNCILambda2(grid, i, j, k, &st);
+			if(fabs(lambda2)>PRECISION)
 			{
-				if(densityCutOff>0 && grid->point[i][j][k].C[3]>densityCutOff) continue;
-				if(grid->point[i][j][k].C[3]<PRECISION) continue;
-				gx = gy = gz = 0.0;
-				for(n=-nBoundary, kn=0 ; kn<nBoundary ; n++, kn++)
-				{
-					gx += fcx[kn] * (grid->point[i+n][j][k].C[3]-grid->point[i-n][j][k].C[3]);
-					gy += fcy[kn] * (grid->point[i][j+n][k].C[3]-grid->point[i][j-n][k].C[3]);
-					gz += fcz[kn] * (grid->point[i][j][k+n].C[3]-grid->point[i][j][k-n].C[3]) ;
-				}
-				s = fact*sqrt(gx*gx+gy*gy+gz*gz)/pow(grid->point[i][j][k].C[3],fourOver3);
-				if(RDGCutOff>0 && s>RDGCutOff) continue;
-				lambda2 = getLambda2(grid,i, j, k, fcx, fcy, fcz, lfcx, lfcy, lfcz, nBoundary);
-				if(fabs(lambda2)>PRECISION)
-				{
-					X[nPoints] = grid->point[i][j][k].C[3];
-					Y[nPoints] = s;
-					if(lambda2<0)  X[nPoints] = -  X[nPoints];
-					nPoints++;
-				}
+				X[p] = (lambda2<0)?-rho:rho;
+				Y[p] = s;
 			}
 		}
-		if(CancelCalcul) 
-		{
-			progress_orb(0,GABEDIT_PROGORB_COMPNCIGRID,TRUE);
-			break;
-		}
+#ifdef ENABLE_OMP
+#ifndef G_OS_WIN32
+#pragma omp critical
+		progress_orb(scale,GABEDIT_PROGORB_COMPNCIGRID,FALSE);
+#endif
+#else
 		progress_orb(scale,GABEDIT_PROGORB_COMPNCIGRID,FALSE);
+#endif
+	}
+	if(!CancelCalcul)
+	for(p=0;p<nAll;p++)
+	{
+		if(Y[p]<0) continue;
+		X[nPoints] = X[p];
+		Y[nPoints] = Y[p];
+		nPoints++;
 	}
 	printf("nPoints = %d\n",nPoints);
 	progress_orb(0,GABEDIT_PROGORB_COMPNCIGRID,TRUE);
 
-	if(CancelCalcul)
+	if(CancelCalcul || nPoints==0)
 	{
 		g_free(X);
 		g_free(Y);
+		X = NULL;
+		Y = NULL;
 		nPoints = 0;
 	}
-	if(nPoints>0)
+	else
 	{
 		X = g_realloc(X,nPoints*sizeof(gdouble));
 		Y = g_realloc(Y,nPoints*sizeof(gdouble));
 	}
-	g_free(fcx);
-	g_free(fcy);
-	g_free(fcz);
-	g_free(lfcx);
-	g_free(lfcy);
-	g_free(lfcz);
+	freeNCIStencil(&st);
 	*pX = X;
 	*pY = Y;
 	return nPoints;
@@ -192,31 +300,17 @@ static Grid* compute_nci_from_density_grid(Grid* grid, gdouble densityCutOffMin,
 	gint i;
 	gint j;
 	gint k;
-	gint kn;
 	Grid* nciGrid =  NULL;
-	gdouble xh, yh, zh;
-	gdouble a, b, c;
 	gint N[3] = {0,0,0};
-	gdouble* fcx =  NULL;
-	gdouble* fcy =  NULL;
-	gdouble* fcz =  NULL;
-	gdouble cc = 0;
+	NCIStencil st;
 	GridLimits limits;
 	gdouble scale = 0;
 	gint n;
 	gboolean beg = TRUE;
-	gdouble gx, gy, gz;
 	gdouble oneOver3 = 1.0/3.0;
 	gdouble fourOver3 = 4.0/3.0;
 	gdouble fact = 0.5/pow(3*M_PI*M_PI,oneOver3);
 	gdouble PRECISION = 1.0e-14;
-	gdouble lambda2;
-	gdouble* lfcx =  NULL;
-	gdouble* lfcy =  NULL;
-	gdouble* lfcz =  NULL;
-	gdouble rho;
-	gdouble lcc;
-	gdouble s;
 
 	if(!test_grid_all_positive(grid))
 	{
@@ -231,34 +325,7 @@ static Grid* compute_nci_from_density_grid(Grid* grid, gdouble densityCutOffMin,
 
 	for(n=0;n<3;n++) N[n] = grid->N[n];
 
-
-	i = 1; j = 0; k = 0;
-	a = grid->point[i][j][k].C[0]-grid->point[0][0][0].C[0];
-	b = grid->point[i][j][k].C[1]-grid->point[0][0][0].C[1];
-	c = grid->point[i][j][k].C[2]-grid->point[0][0][0].C[2];
-	xh = sqrt(a*a+b*b+c*c);
-
-	i = 0; j = 1; k = 0;
-	a = grid->point[i][j][k].C[0]-grid->point[0][0][0].C[0];
-	b = grid->point[i][j][k].C[1]-grid->point[0][0][0].C[1];
-	c = grid->point[i][j][k].C[2]-grid->point[0][0][0].C[2];
-	yh = sqrt(a*a+b*b+c*c);
-
-	i = 0; j = 0; k = 1;
-	a = grid->point[i][j][k].C[0]-grid->point[0][0][0].C[0];
-	b = grid->point[i][j][k].C[1]-grid->point[0][0][0].C[1];
-	c = grid->point[i][j][k].C[2]-grid->point[0][0][0].C[2];
-	zh = sqrt(a*a+b*b+c*c);
-
-	fcx =  g_malloc((nBoundary)*sizeof(gdouble));
-	fcy =  g_malloc((nBoundary)*sizeof(gdouble));
-	fcz =  g_malloc((nBoundary)*sizeof(gdouble));
-	getCoefsGradient(nBoundary, xh, yh, zh,  fcx,  fcy, fcz);
-
-	lfcx =  g_malloc((nBoundary+1)*sizeof(gdouble));
-	lfcy =  g_malloc((nBoundary+1)*sizeof(gdouble));
-	lfcz =  g_malloc((nBoundary+1)*sizeof(gdouble));
-	getCoefsLaplacian(nBoundary, xh, yh, zh,  lfcx,  lfcy, lfcz, &lcc);
+	initNCIStencil(&st, grid, nBoundary);
 
 	limits.MinMax[0][0] = grid->limits.MinMax[0][0];
 	limits.MinMax[1][0] = grid->limits.MinMax[1][0];
@@ -290,51 +357,59 @@ static Grid* compute_nci_from_density_grid(Grid* grid, gdouble densityCutOffMin,
 	}
  
 	/* printf("densityCutOffMax = %f\n",densityCutOffMax);*/
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(i) schedule(dynamic)
+#endif
 	for(i=nBoundary;i<grid->N[0]-nBoundary;i++)
 	{
-		for(j=nBoundary;j<grid->N[1]-nBoundary;j++)
+		gint j, k, j0, k0;
+		gdouble rho, s;
+		if(!CancelCalcul)
+		for(j0=nBoundary;j0<grid->N[1]-nBoundary;j0+=NCIBLOCK)
+		for(k0=nBoundary;k0<grid->N[2]-nBoundary;k0+=NCIBLOCK)
+		for(j=j0;j<j0+NCIBLOCK && j<grid->N[1]-nBoundary;j++)
+		for(k=k0;k<k0+NCIBLOCK && k<grid->N[2]-nBoundary;k++)
 		{
-			for(k=nBoundary;k<grid->N[2]-nBoundary;k++)
-			{
-				rho = grid->point[i][j][k].C[3];
-				if(rho<PRECISION) continue;
-				gx = gy = gz = 0.0;
-				for(n=-nBoundary, kn=0 ; kn<nBoundary ; n++, kn++)
-				{
-					gx += fcx[kn] * (grid->point[i+n][j][k].C[3]-grid->point[i-n][j][k].C[3]);
-					gy += fcy[kn] * (grid->point[i][j+n][k].C[3]-grid->point[i][j-n][k].C[3]);
-					gz += fcz[kn] * (grid->point[i][j][k+n].C[3]-grid->point[i][j][k-n].C[3]) ;
-				}
-				s = fact*sqrt(gx*gx+gy*gy+gz*gz)/pow(rho,fourOver3);
-				if(s<=RDGCutOff)
-				{
-					lambda2 = getLambda2(grid,i, j, k, fcx, fcy, fcz, lfcx, lfcy, lfcz, nBoundary);
-					if(lambda2<0) rho = -rho;
-					if(rho >= densityCutOffMin && rho <= densityCutOffMax ) 
-						nciGrid->point[i][j][k].C[3] = s;
-				}
-				if(beg)
-				{
-					beg = FALSE;
-        				nciGrid->limits.MinMax[0][3] =  nciGrid->point[i][j][k].C[3];
-        				nciGrid->limits.MinMax[1][3] =  nciGrid->point[i][j][k].C[3];
-				}
-                		else
-				{
-        				if(nciGrid->limits.MinMax[0][3]>nciGrid->point[i][j][k].C[3])
-        					nciGrid->limits.MinMax[0][3] =  nciGrid->point[i][j][k].C[3];
-        				if(nciGrid->limits.MinMax[1][3]<nciGrid->point[i][j][k].C[3])
-        					nciGrid->limits.MinMax[1][3] =  nciGrid->point[i][j][k].C[3];
-				}
-			}
+			rho = grid->point[i][j][k].C[3];
+			if(rho<PRECISION) continue;
+			/* the sign of lambda2 can only flip rho */
+			if((rho<densityCutOffMin || rho>densityCutOffMax) && (-rho<densityCutOffMin || -rho>densityCutOffMax)) continue;
+			s = fact*sqrt(getNCIGradient2(grid, i, j, k, &st))/pow(rho,fourOver3);
+			if(s>RDGCutOff) continue;
+			if(getNCILambda2(grid, i, j, k, &st)<0) rho = -rho;
+			if(rho >= densityCutOffMin && rho <= densityCutOffMax ) 
+				nciGrid->point[i][j][k].C[3] = s;
+		}
+#ifdef ENABLE_OMP
+#ifndef G_OS_WIN32
+#pragma omp critical
+		progress_orb(scale,GABEDIT_PROGORB_COMPNCIGRID,FALSE);
+#endif
+#else
+		progress_orb(scale,GABEDIT_PROGORB_COMPNCIGRID,FALSE);
+#endif
+	}
+	if(!CancelCalcul)
+	for(i=nBoundary;i<grid->N[0]-nBoundary;i++)
+	for(j=nBoundary;j<grid->N[1]-nBoundary;j++)
+	for(k=nBoundary;k<grid->N[2]-nBoundary;k++)
+	{
+		if(grid->point[i][j][k].C[3]<PRECISION) continue;
+		if(beg)
+		{
+			beg = FALSE;
+			nciGrid->limits.MinMax[0][3] =  nciGrid->point[i][j][k].C[3];
+			nciGrid->limits.MinMax[1][3] =  nciGrid->point[i][j][k].C[3];
 		}
-		if(CancelCalcul) 
+		else
 		{
-			progress_orb(0,GABEDIT_PROGORB_COMPNCIGRID,TRUE);
-			break;
+			if(nciGrid->limits.MinMax[0][3]>nciGrid->point[i][j][k].C[3])
+				nciGrid->limits.MinMax[0][3] =  nciGrid->point[i][j][k].C[3];
+			if(nciGrid->limits.MinMax[1][3]<nciGrid->point[i][j][k].C[3])
+				nciGrid->limits.MinMax[1][3] =  nciGrid->point[i][j][k].C[3];
 		}
-		progress_orb(scale,GABEDIT_PROGORB_COMPNCIGRID,FALSE);
 	}
+	progress_orb(0,GABEDIT_PROGORB_COMPNCIGRID,TRUE);
 
 	if(CancelCalcul)
 	{
@@ -344,12 +419,7 @@ static Grid* compute_nci_from_density_grid(Grid* grid, gdouble densityCutOffMin,
 	{
 		reset_boundary(nciGrid, nBoundary);
 	}
-	g_free(fcx);
-	g_free(fcy);
-	g_free(fcz);
-	g_free(lfcx);
-	g_free(lfcy);
-	g_free(lfcz);
+	freeNCIStencil(&st);
 	return nciGrid;
 }
 /*********************************************************************************/
@@ -626,5 +696,5 @@ void help_nci()
 		)
 		 );
 	win = Message(temp,_("Info"),FALSE);
-	gtk_window_set_modal (GTK_WINDOW (win), TRUE);
+	if(win) gtk_window_set_modal (GTK_WINDOW (win), TRUE);
 }
@@ -44,6 +44,7 @@ DEALINGS IN THE SOFTWARE.
 #include "OrbitalsOrca.h"
 #include "OrbitalsNBO.h"
 #include "wfx.h"
+#include "../Utils/FChkFile.h"
 
 #define WIDTHSCR 0.56
 
@@ -230,7 +231,7 @@ static void applyiso(GtkWidget *Win,gpointer data)
 	else
 	{
 		GtkWidget* message =Message(_("Error : one entry is not a float "),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
 	if(fabs(isovalue)>fabs(limits.MinMax[1][3]) && fabs(isovalue)>fabs(limits.MinMax[0][3]))
@@ -238,14 +239,14 @@ static void applyiso(GtkWidget *Win,gpointer data)
 		gchar buffer[BSIZE];
 		sprintf(buffer,_("Error : The isovalue  value should between %lf and %lf"),fabs(limits.MinMax[1][3]),fabs(limits.MinMax[0][3]));
 		GtkWidget* message = Message(buffer,_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
 	/*
 	if(isovalue<limits.MinMax[0][3])
 	{
 		GtkWidget* message = Message("Error :  The minimal value should be smaller than the minimal value ",_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		return;
 	}
 	*/
@@ -300,7 +301,7 @@ void applygrid(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : one entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -310,7 +311,7 @@ void applygrid(GtkWidget *Win,gpointer data)
 		if(NumPointstmp[i] <=2)
 		{
 			GtkWidget* message = Message(_("Error : The number of points should be > 2. "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		
@@ -321,7 +322,7 @@ void applygrid(GtkWidget *Win,gpointer data)
 		if( limitstmp.MinMax[0][i]> limitstmp.MinMax[1][i])
 		{
 			GtkWidget* message = Message(_("Error :  The minimal value should be smaller than the maximal value "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 	}
@@ -346,7 +347,7 @@ void applygrid(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : one entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -361,7 +362,7 @@ void applygrid(GtkWidget *Win,gpointer data)
 		if(fabs(norm)<1e-8)
 		{
 			GtkWidget* message = Message(_("Error : the norm is equal to 0 "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		for(j=0;j<3;j++)
@@ -892,7 +893,6 @@ static void getiso(GtkWidget *button,gpointer data)
 	gdouble isovalue = 0.1;
 	gdouble percent = 100;
 	gboolean square = TRUE;
-	gdouble precision =1e-6;
 	
 	temp = g_strdup(gtk_entry_get_text(GTK_ENTRY(EntryPercent))); 
 	delete_first_spaces(temp);
@@ -901,7 +901,7 @@ static void getiso(GtkWidget *button,gpointer data)
 	else
 	{
 		GtkWidget* message =Message(_("Error : one entry is not a float "),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		if(temp) g_free(temp);
 		return;
 	}
@@ -918,7 +918,7 @@ static void getiso(GtkWidget *button,gpointer data)
 		|| TypeGrid == GABEDIT_TYPEGRID_EDENSITY
 	) square = FALSE;
 
-	if(!compute_isovalue_percent_from_grid(grid, square, percent, precision, &isovalue)) return;
+	if(!compute_isovalue_percent_from_grid(grid, square, percent, &isovalue)) return;
 	temp = g_strdup_printf("%f",isovalue);
 	gtk_entry_set_text(GTK_ENTRY(Entry),temp); 
 	if(temp) g_free(temp);
@@ -1128,6 +1128,8 @@ void create_list_orbitals()
 	  Message(_("Sorry, Please load a file beforee\n"),_("Error"),TRUE);
 	  return;
   }
+  /* batch mode */
+  if(!PrincipalWindow) return;
 
   if(winList) destroyWinsList(winList);
 
@@ -1997,8 +1999,8 @@ void read_gauss_orbitals(gchar* FileName)
 /********************************************************************************/
 gboolean read_orbitals_from_fchk_gaussian_file(gchar* fileName)
 {
-	FILE* file;
-	file = FOpen(fileName, "rb");
+	FChkFile* file = new_fchk_gaussian_file(fileName);
+	gchar* blockNames[] = {"Alpha Orbital Energies ", "Alpha MO coefficients ", "Beta Orbital Energies ", "Beta MO coefficients "};
 	gdouble* coefsAlpha = NULL;
 	gdouble* coefsBeta = NULL;
 	gdouble* energiesAlpha = NULL;
@@ -2014,44 +2016,44 @@ gboolean read_orbitals_from_fchk_gaussian_file(gchar* fileName)
   		Message(_("Sorry\nI can not open this file"),_("Error"),TRUE);
   		return FALSE;
 	}
-	nAOcc = get_one_int_from_fchk_gaussian_file(file,"Number of alpha electrons ");
-	nBOcc = get_one_int_from_fchk_gaussian_file(file,"Number of beta electrons ");
+	nAOcc = get_one_int_from_fchk(file,"Number of alpha electrons ");
+	nBOcc = get_one_int_from_fchk(file,"Number of beta electrons ");
 /* printf("nBOcc=%d\n",nBOcc);*/
-	nBasis = get_one_int_from_fchk_gaussian_file(file,"Number of basis functions  ");
+	nBasis = get_one_int_from_fchk(file,"Number of basis functions  ");
 	if(nBasis<1)
 	{
   		Message(_("Sorry\nI can not read the number of basis functions"),_("Error"),TRUE);
-		fclose(file);
+		free_fchk_gaussian_file(file);
   		return FALSE;
 	}
-	energiesAlpha = get_array_real_from_fchk_gaussian_file(file, "Alpha Orbital Energies ", &nA);
+	load_arrays_from_fchk(file, 4, blockNames);
+	energiesAlpha = get_array_real_from_fchk(file, "Alpha Orbital Energies ", &nA);
 	if(energiesAlpha)
 	{
-		coefsAlpha = get_array_real_from_fchk_gaussian_file(file, "Alpha MO coefficients ", &n);
+		coefsAlpha = get_array_real_from_fchk(file, "Alpha MO coefficients ", &n);
 		if(!coefsAlpha || n!=nBasis*nA)
 		{
   			Message(_("Sorry\nI can not read the alpha MO coefficients"),_("Error"),TRUE);
 			if(energiesAlpha) g_free(energiesAlpha);
 			if(coefsAlpha) g_free(coefsAlpha);
-			fclose(file);
+			free_fchk_gaussian_file(file);
   			return FALSE;
 		}
 	}
-	rewind(file);
-	energiesBeta = get_array_real_from_fchk_gaussian_file(file, "Beta Orbital Energies ", &nB);
+	energiesBeta = get_array_real_from_fchk(file, "Beta Orbital Energies ", &nB);
 	if(energiesBeta)
 	{
-		coefsBeta = get_array_real_from_fchk_gaussian_file(file, "Beta MO coefficients ", &n);
+		coefsBeta = get_array_real_from_fchk(file, "Beta MO coefficients ", &n);
 		if(!coefsBeta || n!=nBasis*nB)
 		{
   			Message(_("Sorry\nI can not read the alpha MO coefficients"),_("Error"),TRUE);
 			if(energiesBeta) g_free(energiesBeta);
 			if(coefsBeta) g_free(coefsBeta);
-			fclose(file);
+			free_fchk_gaussian_file(file);
   			return FALSE;
 		}
 	}
-	fclose(file);
+	free_fchk_gaussian_file(file);
 	NAlphaOcc = 0;
 	NAlphaOrb = 0;
 	NBetaOcc = 0;
@@ -399,7 +399,9 @@ void showColorMapPlanesMapped()
 /********************************************************************************/
 void hideColorMapPlanesMapped()
 {
-	GtkWidget* handleBoxColorMapPlanesMapped = g_object_get_data(G_OBJECT(PrincipalWindow), "HandleboxColorMapPlanesMapped");
+	GtkWidget* handleBoxColorMapPlanesMapped = NULL;
+	if(!PrincipalWindow) return;
+	handleBoxColorMapPlanesMapped = g_object_get_data(G_OBJECT(PrincipalWindow), "HandleboxColorMapPlanesMapped");
 	color_map_hide(handleBoxColorMapPlanesMapped);
 }
 /********************************************************************************/
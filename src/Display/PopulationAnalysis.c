@@ -0,0 +1,469 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+/* Population analysis from the matrices of the loaded orbitals :
+ * the overlap matrix S is computed once (each pair of basis functions once, rows in parallel),
+ * the alpha and beta density matrices P = C^t occ C by blocked products over the occupied orbitals
+ * (the beta matrices are not recomputed if the beta orbitals are the alpha ones).
+ * Mulliken : q_A = Z_A - sum_{k in A} (PS)_kk
+ * Lowdin   : q_A = Z_A - sum_{k in A} (S^1/2 P S^1/2)_kk, S^1/2 = S S^-1/2 (CalculSm12)
+ * Mayer    : B_AB = sum_{k in A, l in B} (PaS)_kl (PaS)_lk + (PbS)_kl (PbS)_lk, both orders for A != B
+ * Wiberg   : the same with the squares of S^1/2 Pa S^1/2 and S^1/2 Pb S^1/2
+ */
+
+#include "../../Config.h"
+#include <string.h>
+#ifdef ENABLE_OMP
+#include <omp.h>
+#endif
+#include "GlobalOrb.h"
+#include "StatusOrb.h"
+#include "UtilsOrb.h"
+#include "../Utils/Constants.h"
+#include "../Utils/GTF.h"
+#include "../Display/PopulationAnalysis.h"
+
+#define BLOCKSIZE 64
+
+struct _PopulationAnalysis
+{
+	gint nAO;
+	gint nAtoms;
+	gint* firstOfAtom;
+	gint* aoOfAtom;
+	gdouble* S;
+	gdouble* Pa;
+	gdouble* Pb;
+	gdouble* Sh;
+	gboolean restricted;
+};
+
+/************************************************************************/
+/* C = A B, A : n*m, B : m*p, row major, by blocks, the blocks of rows of C in parallel */
+static void matrixProduct(gint n, gint m, gint p, gdouble* A, gdouble* B, gdouble* C)
+{
+	gint ib;
+	gint i;
+
+	for(i=0;i<n*p;i++) C[i] = 0;
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(ib) schedule(dynamic)
+#endif
+	for(ib=0;ib<n;ib+=BLOCKSIZE)
+	{
+		gint iEnd = MIN(ib+BLOCKSIZE,n);
+		gint kb, jb;
+		for(kb=0;kb<m;kb+=BLOCKSIZE)
+		{
+			gint kEnd = MIN(kb+BLOCKSIZE,m);
+			for(jb=0;jb<p;jb+=BLOCKSIZE)
+			{
+				gint jEnd = MIN(jb+BLOCKSIZE,p);
+				gint ii, k, j;
+				for(ii=ib;ii<iEnd;ii++)
+				{
+					gdouble* c = C+ii*p;
+					for(k=kb;k<kEnd;k++)
+					{
+						gdouble a = A[ii*m+k];
+						gdouble* b = B+k*p;
+						if(a==0) continue;
+						for(j=jb;j<jEnd;j++) c[j] += a*b[j];
+					}
+				}
+			}
+		}
+	}
+}
+/************************************************************************/
+static gint getCenterOfAO(gint k)
+{
+	if(AOrb) return AOrb[k].NumCenter;
+	return SAOrb[k].NumCenter;
+}
+/************************************************************************/
+static gboolean computeOverlapMatrix(PopulationAnalysis* pa)
+{
+	gint n = pa->nAO;
+	gdouble* S = pa->S;
+	gint k;
+	gchar str[BSIZE];
+
+	if(!AOrb)
+	{
+		for(k=0;k<n;k++)
+		{
+			gint l;
+			for(l=0;l<=k;l++) S[k*n+l] = S[l*n+k] = SOverlaps[k*(k+1)/2+l];
+		}
+		return TRUE;
+	}
+	sprintf(str,_("Computing of overlap matrix... Please wait"));
+	progress_orb_txt(0,str,TRUE);
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(k) schedule(dynamic)
+#endif
+	for(k=0;k<n;k++)
+	{
+		gint l;
+		if(CancelCalcul) continue;
+		for(l=0;l<=k;l++) S[k*n+l] = S[l*n+k] = overlapCGTF(&AOrb[k],&AOrb[l]);
+#ifdef ENABLE_OMP
+#ifndef G_OS_WIN32
+#pragma omp critical
+		progress_orb_txt((k+1.0)/(n*(n+1.0)/2),str,FALSE);
+#endif
+#else
+		progress_orb_txt((k+1.0)/(n*(n+1.0)/2),str,FALSE);
+#endif
+	}
+	progress_orb_txt(0," ",TRUE);
+	return !CancelCalcul;
+}
+/************************************************************************/
+/* P = sum_i occ_i C_i C_i^t over the occupied orbitals, lower blocks only then symmetrised */
+static void computeDensityMatrix(gint n, gdouble** Coef, gdouble* Occ, gdouble* P)
+{
+	gint nOcc = 0;
+	gdouble* X = NULL;
+	gdouble* WX = NULL;
+	gint i, k, o;
+	gint ib;
+
+	for(i=0;i<n*n;i++) P[i] = 0;
+	if(!Coef || !Occ) return;
+	for(i=0;i<NOrb;i++) if(Occ[i]!=0) nOcc++;
+	if(nOcc<1) return;
+	/* X[k*nOcc+o] = C_o(k), WX[k*nOcc+o] = occ_o C_o(k) : rows of P as dot products of contiguous rows */
+	X = g_malloc(n*nOcc*sizeof(gdouble));
+	WX = g_malloc(n*nOcc*sizeof(gdouble));
+	o = 0;
+	for(i=0;i<NOrb;i++)
+	{
+		if(Occ[i]==0) continue;
+		for(k=0;k<n;k++)
+		{
+			X[k*nOcc+o] = Coef[i][k];
+			WX[k*nOcc+o] = Occ[i]*Coef[i][k];
+		}
+		o++;
+	}
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(ib) schedule(dynamic)
+#endif
+	for(ib=0;ib<n;ib+=BLOCKSIZE)
+	{
+		gint iEnd = MIN(ib+BLOCKSIZE,n);
+		gint jb;
+		for(jb=0;jb<=ib;jb+=BLOCKSIZE)
+		{
+			gint jEnd = MIN(jb+BLOCKSIZE,n);
+			gint ob;
+			for(ob=0;ob<nOcc;ob+=BLOCKSIZE)
+			{
+				gint oEnd = MIN(ob+BLOCKSIZE,nOcc);
+				gint ii, j, oo;
+				for(ii=ib;ii<iEnd;ii++)
+				{
+					gdouble* x = WX+ii*nOcc;
+					for(j=jb;j<MIN(jEnd,ii+1);j++)
+					{
+						gdouble* y = X+j*nOcc;
+						gdouble s = 0;
+						for(oo=ob;oo<oEnd;oo++) s += x[oo]*y[oo];
+						P[ii*n+j] += s;
+					}
+				}
+			}
+		}
+	}
+	for(k=0;k<n;k++)
+	{
+		gint l;
+		for(l=0;l<k;l++) P[l*n+k] = P[k*n+l];
+	}
+	g_free(X);
+	g_free(WX);
+}
+/************************************************************************/
+/* same orbitals and occupations for alpha and beta : Pb = Pa */
+static gboolean isRestricted()
+{
+	gint i;
+	if(!CoefBetaOrbitals || !OccBetaOrbitals) return FALSE;
+	for(i=0;i<NOrb;i++)
+	{
+		if(OccAlphaOrbitals[i]!=OccBetaOrbitals[i]) return FALSE;
+		if(OccAlphaOrbitals[i]==0) continue;
+		if(CoefAlphaOrbitals[i]!=CoefBetaOrbitals[i] && memcmp(CoefAlphaOrbitals[i],CoefBetaOrbitals[i],NAOrb*sizeof(gdouble))) return FALSE;
+	}
+	return TRUE;
+}
+/************************************************************************/
+void freePopulationAnalysis(PopulationAnalysis* pa)
+{
+	if(!pa) return;
+	if(pa->firstOfAtom) g_free(pa->firstOfAtom);
+	if(pa->aoOfAtom) g_free(pa->aoOfAtom);
+	if(pa->S) g_free(pa->S);
+	if(pa->Pa) g_free(pa->Pa);
+	if(pa->Pb) g_free(pa->Pb);
+	if(pa->Sh) g_free(pa->Sh);
+	g_free(pa);
+}
+/************************************************************************/
+PopulationAnalysis* newPopulationAnalysis()
+{
+	PopulationAnalysis* pa = NULL;
+	gint n = NAOrb;
+	gint k, a;
+
+	if(nCenters<1 || NAOrb<1) return NULL;
+	if(!AOrb && (!SAOrb || !SOverlaps)) return NULL;
+	if(CancelCalcul) return NULL;
+
+	pa = g_malloc(sizeof(PopulationAnalysis));
+	pa->nAO = n;
+	pa->nAtoms = nCenters;
+	pa->Sh = NULL;
+
+	/* basis functions of each atom */
+	pa->firstOfAtom = g_malloc((nCenters+1)*sizeof(gint));
+	pa->aoOfAtom = g_malloc(n*sizeof(gint));
+	for(a=0;a<=nCenters;a++) pa->firstOfAtom[a] = 0;
+	for(k=0;k<n;k++) pa->firstOfAtom[getCenterOfAO(k)+1]++;
+	for(a=0;a<nCenters;a++) pa->firstOfAtom[a+1] += pa->firstOfAtom[a];
+	{
+		gint* pos = g_malloc(nCenters*sizeof(gint));
+		for(a=0;a<nCenters;a++) pos[a] = pa->firstOfAtom[a];
+		for(k=0;k<n;k++) pa->aoOfAtom[pos[getCenterOfAO(k)]++] = k;
+		g_free(pos);
+	}
+
+	pa->S = g_malloc(n*n*sizeof(gdouble));
+	pa->Pa = g_malloc(n*n*sizeof(gdouble));
+	pa->Pb = g_malloc(n*n*sizeof(gdouble));
+	if(!computeOverlapMatrix(pa))
+	{
+		freePopulationAnalysis(pa);
+		return NULL;
+	}
+	setTextInProgress(_("Computing of density matrix... Please wait"));
+	computeDensityMatrix(n, CoefAlphaOrbitals, OccAlphaOrbitals, pa->Pa);
+	pa->restricted = isRestricted();
+	if(pa->restricted) memcpy(pa->Pb, pa->Pa, n*n*sizeof(gdouble));
+	else computeDensityMatrix(n, CoefBetaOrbitals, OccBetaOrbitals, pa->Pb);
+	return pa;
+}
+/************************************************************************/
+/* S^1/2 = S S^-1/2 */
+static gboolean computeSqrtOverlap(PopulationAnalysis* pa)
+{
+	gint n = pa->nAO;
+	gdouble* Sp = NULL;
+	gdouble* Sm = NULL;
+	gdouble** Sm12 = NULL;
+	gint k, l;
+
+	if(pa->Sh) return TRUE;
+	setTextInProgress(_("Computing of S^1/2... Please wait"));
+	Sp = g_malloc(n*(n+1)/2*sizeof(gdouble));
+	for(k=0;k<n;k++)
+	for(l=0;l<=k;l++) Sp[k*(k+1)/2+l] = pa->S[k*n+l];
+	Sm12 = CalculSm12(Sp, n, n);
+	g_free(Sp);
+	if(!Sm12) return FALSE;
+	Sm = g_malloc(n*n*sizeof(gdouble));
+	for(k=0;k<n;k++)
+	for(l=0;l<n;l++) Sm[k*n+l] = Sm12[k][l];
+	FreeTable2(Sm12, n);
+	pa->Sh = g_malloc(n*n*sizeof(gdouble));
+	matrixProduct(n, n, n, pa->S, Sm, pa->Sh);
+	g_free(Sm);
+	return TRUE;
+}
+/************************************************************************/
+/* charges from the diagonal of a matrix of the total density in the basis */
+static gdouble* getChargesFromDiagonal(PopulationAnalysis* pa, gdouble* d)
+{
+	gdouble* charges = g_malloc(pa->nAtoms*sizeof(gdouble));
+	gint a;
+	for(a=0;a<pa->nAtoms;a++)
+	{
+		gint n;
+		charges[a] = GeomOrb[a].nuclearCharge;
+		for(n=pa->firstOfAtom[a];n<pa->firstOfAtom[a+1];n++) charges[a] -= d[pa->aoOfAtom[n]];
+	}
+	return charges;
+}
+/************************************************************************/
+gdouble* getMullikenCharges(PopulationAnalysis* pa)
+{
+	gint n;
+	gdouble* d;
+	gdouble* charges;
+	gint k;
+
+	if(!pa) return NULL;
+	n = pa->nAO;
+	d = g_malloc(n*sizeof(gdouble));
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(k)
+#endif
+	for(k=0;k<n;k++)
+	{
+		gint l;
+		gdouble s = 0;
+		for(l=0;l<n;l++) s += (pa->Pa[k*n+l]+pa->Pb[k*n+l])*pa->S[k*n+l];
+		d[k] = s;
+	}
+	charges = getChargesFromDiagonal(pa, d);
+	g_free(d);
+	return charges;
+}
+/************************************************************************/
+/* X = S^1/2 P S^1/2 */
+static void getLowdinDensity(PopulationAnalysis* pa, gdouble* P, gdouble* X)
+{
+	gint n = pa->nAO;
+	gdouble* T = g_malloc(n*n*sizeof(gdouble));
+	matrixProduct(n, n, n, P, pa->Sh, T);
+	matrixProduct(n, n, n, pa->Sh, T, X);
+	g_free(T);
+}
+/************************************************************************/
+gdouble* getLowdinCharges(PopulationAnalysis* pa)
+{
+	gint n;
+	gdouble* P;
+	gdouble* T;
+	gdouble* d;
+	gdouble* charges;
+	gint k;
+
+	if(!pa) return NULL;
+	if(!computeSqrtOverlap(pa)) return NULL;
+	n = pa->nAO;
+	P = g_malloc(n*n*sizeof(gdouble));
+	T = g_malloc(n*n*sizeof(gdouble));
+	d = g_malloc(n*sizeof(gdouble));
+	for(k=0;k<n*n;k++) P[k] = pa->Pa[k]+pa->Pb[k];
+	matrixProduct(n, n, n, P, pa->Sh, T);
+	/* diagonal of S^1/2 (P S^1/2) only */
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(k)
+#endif
+	for(k=0;k<n;k++)
+	{
+		gint l;
+		gdouble s = 0;
+		for(l=0;l<n;l++) s += pa->Sh[k*n+l]*T[l*n+k];
+		d[k] = s;
+	}
+	charges = getChargesFromDiagonal(pa, d);
+	g_free(P);
+	g_free(T);
+	g_free(d);
+	return charges;
+}
+/************************************************************************/
+/* B_AB = sum_{k in A, l in B} Xa_kl Ya_lk + Xb_kl Yb_lk, summed with B_BA for A != B, packed */
+static gdouble* getBondOrdersFromProducts(PopulationAnalysis* pa, gdouble* Xa, gdouble* Ya, gdouble* Xb, gdouble* Yb)
+{
+	gint nA = pa->nAtoms;
+	gint n = pa->nAO;
+	gdouble* M = g_malloc(nA*nA*sizeof(gdouble));
+	gdouble* bondOrders = g_malloc(nA*(nA+1)/2*sizeof(gdouble));
+	gint i;
+
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(i) schedule(dynamic)
+#endif
+	for(i=0;i<nA;i++)
+	{
+		gint j;
+		for(j=0;j<nA;j++)
+		{
+			gint nk, nl;
+			gdouble s = 0;
+			for(nk=pa->firstOfAtom[i];nk<pa->firstOfAtom[i+1];nk++)
+			for(nl=pa->firstOfAtom[j];nl<pa->firstOfAtom[j+1];nl++)
+			{
+				gint k = pa->aoOfAtom[nk];
+				gint l = pa->aoOfAtom[nl];
+				s += Xa[k*n+l]*Ya[l*n+k]+Xb[k*n+l]*Yb[l*n+k];
+			}
+			M[i*nA+j] = s;
+		}
+	}
+	for(i=0;i<nA;i++)
+	{
+		gint j;
+		bondOrders[i*nA+i-i*(i+1)/2] = M[i*nA+i];
+		for(j=i+1;j<nA;j++) bondOrders[i*nA+j-i*(i+1)/2] = M[i*nA+j]+M[j*nA+i];
+	}
+	g_free(M);
+	return bondOrders;
+}
+/************************************************************************/
+gdouble* getMayerBondOrders(PopulationAnalysis* pa)
+{
+	gint n;
+	gdouble* PaS;
+	gdouble* PbS;
+	gdouble* bondOrders;
+
+	if(!pa) return NULL;
+	n = pa->nAO;
+	PaS = g_malloc(n*n*sizeof(gdouble));
+	matrixProduct(n, n, n, pa->Pa, pa->S, PaS);
+	if(pa->restricted) PbS = PaS;
+	else
+	{
+		PbS = g_malloc(n*n*sizeof(gdouble));
+		matrixProduct(n, n, n, pa->Pb, pa->S, PbS);
+	}
+	bondOrders = getBondOrdersFromProducts(pa, PaS, PaS, PbS, PbS);
+	if(PbS!=PaS) g_free(PbS);
+	g_free(PaS);
+	return bondOrders;
+}
+/************************************************************************/
+gdouble* getWibergBondOrders(PopulationAnalysis* pa)
+{
+	gint n;
+	gdouble* Xa;
+	gdouble* Xb;
+	gdouble* bondOrders;
+
+	if(!pa) return NULL;
+	if(!computeSqrtOverlap(pa)) return NULL;
+	n = pa->nAO;
+	Xa = g_malloc(n*n*sizeof(gdouble));
+	getLowdinDensity(pa, pa->Pa, Xa);
+	if(pa->restricted) Xb = Xa;
+	else
+	{
+		Xb = g_malloc(n*n*sizeof(gdouble));
+		getLowdinDensity(pa, pa->Pb, Xb);
+	}
+	/* Xa, Xb symmetric : Xa_kl Xa_lk = Xa_kl^2 */
+	bondOrders = getBondOrdersFromProducts(pa, Xa, Xa, Xb, Xb);
+	if(Xb!=Xa) g_free(Xb);
+	g_free(Xa);
+	return bondOrders;
+}
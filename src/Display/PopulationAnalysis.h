@@ -0,0 +1,36 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#ifndef __GABEDIT_POPULATIONANALYSIS_H__
+#define __GABEDIT_POPULATIONANALYSIS_H__
+
+typedef struct _PopulationAnalysis PopulationAnalysis;
+
+/* overlap and alpha/beta density matrices of the loaded orbitals (AOrb or SAOrb/SOverlaps),
+ * NULL if no orbitals or if cancelled */
+PopulationAnalysis* newPopulationAnalysis();
+void freePopulationAnalysis(PopulationAnalysis* pa);
+/* charges : nCenters values, bond orders : packed nCenters*(nCenters+1)/2 (i<=j : i*nCenters+j-i*(i+1)/2).
+ * The returned arrays must be freed with g_free, NULL if cancelled */
+gdouble* getMullikenCharges(PopulationAnalysis* pa);
+gdouble* getLowdinCharges(PopulationAnalysis* pa);
+gdouble* getMayerBondOrders(PopulationAnalysis* pa);
+gdouble* getWibergBondOrders(PopulationAnalysis* pa);
+
+#endif /* __GABEDIT_POPULATIONANALYSIS_H__ */
+
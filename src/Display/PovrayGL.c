@@ -1527,7 +1527,7 @@ static void save_povray_file(GabeditFileChooser *w , gint response_id)
 	if(message)
 	{
     		m = Message(message,"Error",TRUE);
-		gtk_window_set_modal (GTK_WINDOW (m), TRUE);
+		if(m) gtk_window_set_modal (GTK_WINDOW (m), TRUE);
 	}
 }
 /**************************************************************************/
@@ -1701,7 +1701,7 @@ static void exportPOVRay(GtkWidget* Win, gboolean runPovray)
 		if(message)
 		{
     			GtkWidget *m = Message(message,"Error",TRUE);
-			gtk_window_set_modal (GTK_WINDOW (m), TRUE);
+			if(m) gtk_window_set_modal (GTK_WINDOW (m), TRUE);
 		}
 		else
 		{
@@ -1730,7 +1730,7 @@ static void exportPOVRay(GtkWidget* Win, gboolean runPovray)
 						" -\"%s\" a batch file for run povray\n",
 						fileNamePOV,fileNameCMD);
 					GtkWidget* winDlg = Message(t,"Info",TRUE);
-					gtk_window_set_modal (GTK_WINDOW (winDlg), TRUE);
+					if(winDlg) gtk_window_set_modal (GTK_WINDOW (winDlg), TRUE);
 					g_free(t);
 				}
 			}
@@ -1738,7 +1738,7 @@ static void exportPOVRay(GtkWidget* Win, gboolean runPovray)
 			{
 				gchar* t = g_strdup_printf("\nSorry, I cannot create the %s file\n",fileNameCMD);
 				GtkWidget* winDlg = Message(t,"Info",TRUE);
-				gtk_window_set_modal (GTK_WINDOW (winDlg), TRUE);
+				if(winDlg) gtk_window_set_modal (GTK_WINDOW (winDlg), TRUE);
 				g_free(t);
 			}
 		}
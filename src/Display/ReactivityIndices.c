@@ -73,7 +73,7 @@ static ChargeRI* readChargesTXT(G_CONST_RETURN  gchar* fileName, gdouble* pEnerg
 		gchar buffer[BSIZE];
 		sprintf(buffer,_("Sorry, I can not open '%s' file\n"),fileName);
   		GtkWidget* message = Message(buffer,_("Error"),FALSE);
-  		gtk_window_set_modal (GTK_WINDOW (message), FALSE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), FALSE);
   		return NULL;
  	}
 	if(!fgets(buffer,BSIZE,file))
@@ -81,7 +81,7 @@ static ChargeRI* readChargesTXT(G_CONST_RETURN  gchar* fileName, gdouble* pEnerg
 		sprintf(buffer,_("Sorry, I cannot read number of atoms & energy from '%s' file\n"),fileName);
   		Message(buffer,_("Error"),FALSE);
   		GtkWidget* message = Message(buffer,_("Error"),FALSE);
-  		gtk_window_set_modal (GTK_WINDOW (message), FALSE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), FALSE);
 		fclose(file);
   		return NULL;
 	}
@@ -89,7 +89,7 @@ static ChargeRI* readChargesTXT(G_CONST_RETURN  gchar* fileName, gdouble* pEnerg
 	{
 		sprintf(buffer,_("Sorry, I cannot read number of atoms & energy from '%s' file\n"),fileName);
   		GtkWidget* message = Message(buffer,_("Error"),FALSE);
-  		gtk_window_set_modal (GTK_WINDOW (message), FALSE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), FALSE);
 		fclose(file);
   		return NULL;
 	}
@@ -107,7 +107,7 @@ static ChargeRI* readChargesTXT(G_CONST_RETURN  gchar* fileName, gdouble* pEnerg
 		printf("%d %d\n",k,nAtoms);
 		sprintf(buffer,_("Sorry, I cannot read charges from '%s' file\n"),fileName);
   		GtkWidget* message = Message(buffer,_("Error"),FALSE);
-  		gtk_window_set_modal (GTK_WINDOW (message), FALSE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), FALSE);
 		if(charges) g_free(charges);
   		return NULL;
 	}
@@ -135,7 +135,7 @@ static ChargeRI* readChargesGaussian(G_CONST_RETURN  gchar* fileName, gdouble* p
 		gchar buffer[BSIZE];
 		sprintf(buffer,_("Sorry, I can not open '%s' file\n"),fileName);
   		GtkWidget* message = Message(buffer,_("Error"),FALSE);
-  		gtk_window_set_modal (GTK_WINDOW (message), FALSE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), FALSE);
   		return NULL;
  	}
 	nAtoms = 0;
@@ -168,7 +168,7 @@ static ChargeRI* readChargesGaussian(G_CONST_RETURN  gchar* fileName, gdouble* p
 		sprintf(buffer,_("Sorry, I cannot read number of atoms & energy from '%s' file\n"),fileName);
   		Message(buffer,_("Error"),FALSE);
   		GtkWidget* message = Message(buffer,_("Error"),FALSE);
-  		gtk_window_set_modal (GTK_WINDOW (message), FALSE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), FALSE);
 		fclose(file);
   		return NULL;
 	}
@@ -192,7 +192,7 @@ static ChargeRI* readChargesGaussian(G_CONST_RETURN  gchar* fileName, gdouble* p
 		{
 			sprintf(buffer,_("Sorry, I cannot read NPA charges from '%s' file\n"),fileName);
   			GtkWidget* message = Message(buffer,_("Error"),FALSE);
-  			gtk_window_set_modal (GTK_WINDOW (message), FALSE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), FALSE);
 			if(charges) g_free(charges);
   			return NULL;
 		}
@@ -215,7 +215,7 @@ static ChargeRI* readChargesGaussian(G_CONST_RETURN  gchar* fileName, gdouble* p
 		{
 			sprintf(buffer,_("Sorry, I cannot read Hirshfeld charges from '%s' file\n"),fileName);
   			GtkWidget* message = Message(buffer,_("Error"),FALSE);
-  			gtk_window_set_modal (GTK_WINDOW (message), FALSE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), FALSE);
 			if(charges) g_free(charges);
   			return NULL;
 		}
@@ -238,7 +238,7 @@ static ChargeRI* readChargesGaussian(G_CONST_RETURN  gchar* fileName, gdouble* p
 		{
 			sprintf(buffer,_("Sorry, I cannot read Mulliken charges from '%s' file\n"),fileName);
   			GtkWidget* message = Message(buffer,_("Error"),FALSE);
-  			gtk_window_set_modal (GTK_WINDOW (message), FALSE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), FALSE);
 			if(charges) g_free(charges);
   			return NULL;
 		}
@@ -248,7 +248,7 @@ static ChargeRI* readChargesGaussian(G_CONST_RETURN  gchar* fileName, gdouble* p
 		{
 			sprintf(buffer,_("Sorry, I cannot find any charges in '%s' file\n"),fileName);
   			GtkWidget* message = Message(buffer,_("Error"),FALSE);
-  			gtk_window_set_modal (GTK_WINDOW (message), FALSE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), FALSE);
 			if(charges) g_free(charges);
   			return NULL;
 		}
@@ -270,7 +270,7 @@ static ChargeRI* readCharges(G_CONST_RETURN  gchar* fileName, gdouble* pEnergy,
 		gchar buffer[BSIZE];
 		sprintf(buffer,_("Sorry, This kind of file is not yet supported by Gabedit\n"));
   		GtkWidget* message = Message(buffer,_("Error"),FALSE);
-  		gtk_window_set_modal (GTK_WINDOW (message), FALSE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), FALSE);
 		*pnAtoms = 0;
 		*pEnergy = 0;
   		return NULL;
@@ -708,7 +708,7 @@ static void apply_reactivity_indices_FD(GtkWidget *Win,gpointer data)
 		gchar buffer[BSIZE];
                 sprintf(buffer,_("Error : number of atoms must be tha same for N, N+1 and N-1 electrons systems\nPlease check your files"));
   		GtkWidget* message = Message(buffer,_("Error"),FALSE);
-  		gtk_window_set_modal (GTK_WINDOW (message), FALSE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), FALSE);
                 return;
 		
 	}
@@ -776,7 +776,7 @@ static void apply_reactivity_indices_FMO(GtkWidget *Win,gpointer data)
 	if(nAlpha+nBeta!=2)
 	{
 		GtkWidget* message = Message(_("Error : You should select 2 orbitals"),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), FALSE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), FALSE);
 		return;
 	}
 	else
@@ -1170,7 +1170,7 @@ static void help_reactivity_indices_FD()
 		)
 	);
 	win = Message(temp,_(" Info "),FALSE);
-	gtk_window_set_modal (GTK_WINDOW (win), TRUE);
+	if(win) gtk_window_set_modal (GTK_WINDOW (win), TRUE);
 }
 /********************************************************************************/
 void reactivity_indices_fd_dlg()
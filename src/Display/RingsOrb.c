@@ -30,6 +30,7 @@ DEALINGS IN THE SOFTWARE.
 #include "../Utils/HydrogenBond.h"
 #include "../Display/RingsPov.h"
 #include "../Display/UtilsOrb.h"
+#include "../Display/RingsPerception.h"
 
 /************************************************************************/
 typedef struct 
@@ -365,41 +366,30 @@ gint** getRings(gint ringSize, gint* nRings)
 	return ringsAtoms;
 }
 /********************************************************************************/
-static gint nRings=0;
-static GList** rings=NULL;
 static gint ringSizeMax = 6;
 static gint ringSizeMin = 3;
 static gint* ringsSize = NULL;
 /************************************************************************/
-static gint cmp_fonction(gconstpointer a, gconstpointer b)
+static RingsPerception* newRingsPerceptionFromBonds()
 {
-		if( GPOINTER_TO_INT(a)== GPOINTER_TO_INT(b)) return 0;
-		if( GPOINTER_TO_INT(a)> GPOINTER_TO_INT(b)) return 1;
-		return -1;
-}
-/************************************************************************/
-static gboolean compare2List(GList* L1, GList* L2)
-{
-	GList*ll1 = g_list_copy(L1);
-	GList*ll2 = g_list_copy(L2);
-	GList*l1 = NULL;
-	GList*l2 = NULL;
-	gboolean Ok;
-	ll1 = g_list_sort(ll1, (GCompareFunc)cmp_fonction);
-	ll2 = g_list_sort(ll2, (GCompareFunc)cmp_fonction);
-	Ok = TRUE;
-	for(l1=ll1, l2=ll2; l1 != NULL && l2 != NULL ; l1 = l1->next, l2 = l2->next)
+	GList* list;
+	gint nBonds = 0;
+	gint* bondAtoms = NULL;
+	RingsPerception* rp = NULL;
+
+	for(list=BondsOrb;list!=NULL;list=list->next) nBonds++;
+	if(nBonds>0) bondAtoms = g_malloc(2*nBonds*sizeof(gint));
+	nBonds = 0;
+	for(list=BondsOrb;list!=NULL;list=list->next)
 	{
-		if(GPOINTER_TO_INT(l1->data) != GPOINTER_TO_INT(l2->data))
-		{
-			Ok = FALSE;
-			break;
-		}
+		BondType* data=(BondType*)list->data;
+		bondAtoms[2*nBonds] = data->n1;
+		bondAtoms[2*nBonds+1] = data->n2;
+		nBonds++;
 	}
-	g_list_free(ll1);
-	g_list_free(ll2);
-	if(l1 != NULL || l2 != NULL) Ok = FALSE;
-	return Ok;
+	rp = newRingsPerception(nCenters, nBonds, bondAtoms);
+	if(bondAtoms) g_free(bondAtoms);
+	return rp;
 }
 /************************************************************************/
 static gboolean isCoplanar(GList* ring, gdouble epsilon) /* epsilon on degre */
@@ -438,245 +428,92 @@ static gboolean isCoplanar(GList* ring, gdouble epsilon) /* epsilon on degre */
 	return TRUE;
 }
 /************************************************************************/
-static GList** deleteNotCorrectRingsSize(gint* nR, GList** rings)
+static void printRings(gint nRings, GList** rings)
 {
-	gint n;
-	gint n1;
 	gint i;
-	gint nRings = *nR;
-	for(n=0;n<nRings;n++)
-	{
-		if(ringsSize[n]<ringSizeMin) 
-		{
-			g_list_free(rings[n]);
-			rings[n] = NULL;
-		}
-	}
-	i = 0;
-	for(n=0;n<nRings;n++)
+	for(i=0;i<nRings;i++)
 	{
-		if(ringsSize[n]>=ringSizeMin) { i++; continue;}
-		for(n1=n+1;n1<nRings;n1++)
-			if(rings[n1] != NULL)
-			{
-				GList* t= rings[n1];
-				gint k = ringsSize[n1];
-				rings[n1] = rings[n];
-				rings[n] = t;
-
-				ringsSize[n1] = ringsSize[n];
-				ringsSize[n] = k;
-				i++;
-				break;
-			}
+		GList* glist = rings[i];
+		GList* l = NULL;
+		if(ringsSize[i]<ringSizeMin) continue;
+		printf("Ring number %d : ",i+1);
+		for(l=glist; l != NULL; l = l->next)
+			printf("%d ",1+GPOINTER_TO_INT(l->data));
+		printf("\n");
 	}
-	nRings = i;
-	if(i>0) rings = g_realloc(rings, nRings*sizeof(GList*));
-	else if(rings) {g_free(rings); rings = NULL; nRings = 0;}
-	*nR = nRings;
-	return rings;
 }
 /************************************************************************/
-static GList** deleteNotRings(gint* nR, GList** rings, gboolean deleteNotPlaner)
+/* chordless rings with ringMinSize <= size <= ringMaxSize, sorted by size, each ring starting from its smallest atom.
+ * ringsSize is set to the sizes of the returned rings */
+static GList** findAllRings(gint* nR, gint ringMinSize, gint ringMaxSize, gboolean deleteNotPlaner)
 {
+	RingsPerception* rp = NULL;
+	RingsList* rl = NULL;
+	GList** rings = NULL;
+	gint nRings = 0;
 	gint n;
-	gint n1;
 	gint i;
-	gint nRings = *nR;
-	if(nRings<1) return rings;
-	if(!rings) return rings;
+
+	*nR = 0;
 	if(ringsSize) g_free(ringsSize);
-	ringsSize = g_malloc(nRings*sizeof(gint));
-	for(n=0;n<nRings;n++)
+	ringsSize = NULL;
+	if(nCenters<1) return NULL;
+	ringSizeMax = ringMaxSize;
+	ringSizeMin = ringMinSize;
+	rp = newRingsPerceptionFromBonds();
+	rl = getChordlessRings(rp, ringSizeMin, ringSizeMax);
+	freeRingsPerception(rp);
+	if(rl->nRings>0)
 	{
-		GList* glist = rings[n];
-		GList* l = NULL;
-		GList* l2 = NULL;
-		gint begin;
-		gint end;
-
-		ringsSize[n] = 0;
-		if(!glist) continue;
-		begin = GPOINTER_TO_INT(glist->data);
-		end = begin;
-		for(l=glist; l != NULL; l = l->next)
-		{
-			ringsSize[n]++;
-			end = GPOINTER_TO_INT(l->data);
-			for(l2=l->next; l2 != NULL; l2 = l2->next)
-			{
-				i= GPOINTER_TO_INT(l2->data);
-				if(i==end) 
-				{
-					ringsSize[n] = -1;
-					break;
-				}
-			}
-			if(ringsSize[n]<0) break;
-		}
-		if(!isConnected(begin, end)) ringsSize[n] = -1; /* this is not a ring */
+		rings = g_malloc(rl->nRings*sizeof(GList*));
+		ringsSize = g_malloc(rl->nRings*sizeof(gint));
 	}
-	rings = deleteNotCorrectRingsSize(&nRings, rings);
-	
-	for(n=0;n<nRings;n++)
+	for(n=0;n<rl->nRings;n++)
 	{
-		for(n1=n+1;n1<nRings;n1++)
+		GList* ring = NULL;
+		for(i=rl->ringsSize[n]-1;i>=0;i--) ring = g_list_prepend(ring, GINT_TO_POINTER(rl->rings[n][i]));
+		if(deleteNotPlaner && !isCoplanar(ring, epsilonCoplaner))
 		{
-			if(ringsSize[n] != ringsSize[n1]) continue;
-			if(compare2List(rings[n], rings[n1]))
-			{
-				ringsSize[n] = -1; /* mark for deleting */
-				break;
-			}
+			g_list_free(ring);
+			continue;
 		}
+		rings[nRings] = ring;
+		ringsSize[nRings] = rl->ringsSize[n];
+		nRings++;
 	}
-	rings = deleteNotCorrectRingsSize(&nRings, rings);
-
-	if(deleteNotPlaner)
-	{
-		for(n=0;n<nRings;n++)
-			if(!isCoplanar(rings[n], epsilonCoplaner))
-				ringsSize[n] = -1; /* mark for deleting */
-		rings = deleteNotCorrectRingsSize(&nRings, rings);
-	}
-
-	for(n=0;n<nRings;n++)
+	freeRingsList(rl);
+	if(nRings<1)
 	{
-		GList* l = NULL;
-		GList* l0 = NULL;
-		GList* l1 = NULL;
-		gint i1;
-		gint i2;
-		for(l=rings[n]; l != NULL; l = l->next)
-		{
-			i1= GPOINTER_TO_INT(l->data);
-			l0 = l->next;
-			if(l0 != NULL) l0 = l0->next;
-			for(l1=l0; l1 != NULL; l1 = l1->next)
-			{
-				i2 = GPOINTER_TO_INT(l1->data);
-				if(isConnected(i1,i2)) 
-				{
-					if(l1->next != NULL ) ringsSize[n] = -1;
-					else if( l!= rings[n]) ringsSize[n] = -1;
-				}
-			}
-		}
+		if(rings) g_free(rings);
+		if(ringsSize) g_free(ringsSize);
+		rings = NULL;
+		ringsSize = NULL;
 	}
-	rings = deleteNotCorrectRingsSize(&nRings, rings);
-
 	*nR = nRings;
 	return rings;
-
-
-}
-/************************************************************************/
-gboolean findRings(gint currentAtom, gint rootAtom, gint ringIndex, gint depth, gboolean initialize)
-{
-
-	gint i;
-	gint numberOfConnections;
-	gboolean endSearch =TRUE;
-	gboolean e =TRUE;
-	GList* first;
-	GList* l;
-	if (initialize)
-	{
-		initStack();
-		if(rings) g_free(rings);
-		nRings = 1;
-		rings = g_malloc(sizeof(GList*));
-		rings[0] = NULL;
-	}
-	inStack[currentAtom] = TRUE;
-	for(l=rings[ringIndex]; l != NULL; l = l->next)
-			if(GPOINTER_TO_INT(l->data)== currentAtom) return TRUE;
-
-	rings[ringIndex] = g_list_append(rings[ringIndex],GINT_TO_POINTER(currentAtom));
-	if ( !initialize &&  ( depth>=ringSizeMax-1 ) ) return TRUE; /* max ring */
-	if ( !initialize &&  ( currentAtom == rootAtom ) ) return TRUE; /* end of cycle */
-	if( connected[ currentAtom ][ 0 ]==0) return TRUE; /* end of tree */
-
-	numberOfConnections = connected[ currentAtom ][ 0 ];
-	first = g_list_copy(rings[ringIndex]);
-	for (i = 1; i <= numberOfConnections; i++ )
-	{
-		gint newAtom = connected[currentAtom][i];
-		if(inStack[newAtom]) continue;
-		rings = g_realloc(rings,(nRings+1)*sizeof(GList*));
-		rings[nRings] = g_list_copy(first);
-		nRings++;
-		e = findRings( newAtom, rootAtom, nRings-1, depth+1, FALSE);
-		if(!e) endSearch = FALSE;
-	}
-	inStack[currentAtom] = FALSE;
-	for (i = 1; i <= numberOfConnections; i++ )
-	{
-		gint newAtom = connected[currentAtom][i];
-		inStack[newAtom] = FALSE;
-	}
-	
-	return endSearch;
-}
-/************************************************************************/
-static void printRings(gint nRings, GList** rings)
-{
-	gint i;
-	for(i=0;i<nRings;i++)
-	{
-		GList* glist = rings[i];
-		GList* l = NULL;
-		if(ringsSize[i]<ringSizeMin) continue;
-		printf("Ring number %d : ",i+1);
-		for(l=glist; l != NULL; l = l->next)
-			printf("%d ",1+GPOINTER_TO_INT(l->data));
-		printf("\n");
-	}
 }
 /************************************************************************/
 void findAllRingsForOneAtom(gint numAtom)
 {
-	if(nCenters<1) return;
-	buildConnectionsForRings();
-	findRings(numAtom, numAtom, 0, 0, TRUE);
-	rings = deleteNotRings(&nRings, rings, FALSE);
-	printRings(nRings, rings);
-}
-/************************************************************************/
-static GList** findAllRings(gint* nR, gint ringMinSize, gint ringMaxSize, gboolean deleteNotPlaner)
-{
-	gint numAtom;
-	gint nRingsAll = 0;
-	GList** ringsAll = NULL;
-	gint n0 = 0;
-	gint i;
+	gint nRings = 0;
+	GList** rings = NULL;
+	gint n;
+	gint i = 0;
 
-	*nR = 0;
-	if(nCenters<1) return NULL;
-	ringSizeMax = ringMaxSize;
-	ringSizeMin = ringMinSize;
-	buildConnectionsForRings();
-	for(numAtom=0;numAtom<nCenters;numAtom++)
+	rings = findAllRings(&nRings, ringSizeMin, ringSizeMax, FALSE);
+	for(n=0;n<nRings;n++)
 	{
-		findRings(numAtom, numAtom, 0, 0, TRUE);
-		rings = deleteNotRings(&nRings, rings, deleteNotPlaner);
-		/* printRings(nRings, rings);*/
-		if(nRings<1) continue;
-		nRingsAll += nRings;
-		if(ringsAll)
-			ringsAll = g_realloc(ringsAll, nRingsAll*sizeof(GList*));
-		else
-			ringsAll = g_malloc(nRingsAll*sizeof(GList*));
-		n0 = nRingsAll - nRings;
-		for(i=0;i<nRings;i++)
+		if(g_list_find(rings[n], GINT_TO_POINTER(numAtom)))
 		{
-			ringsAll[n0+i] = rings[i];
+			rings[i] = rings[n];
+			ringsSize[i] = ringsSize[n];
+			i++;
 		}
+		else g_list_free(rings[n]);
 	}
-	ringsAll = deleteNotRings(&nRingsAll, ringsAll, deleteNotPlaner);
-	/* printRings(nRingsAll, ringsAll);*/
-	*nR = nRingsAll;
-	return ringsAll;
+	printRings(i, rings);
+	for(n=0;n<i;n++) g_list_free(rings[n]);
+	if(rings) g_free(rings);
 }
 /********************************************************************************/
 static void messagesNumberOfRings(gint nRings, GList** rings)
@@ -684,12 +521,13 @@ static void messagesNumberOfRings(gint nRings, GList** rings)
 	gint i;
 	gint* nR;
 	gint n = ringSizeMax-ringSizeMin+1;
-	gchar buffer[BSIZE];
+	GString* buffer;
 	gchar buffer1[BSIZE];
 	if(n<1) return ;
 	nR = g_malloc(n*sizeof(gint));
 	for(i=0;i<n;i++)nR[i] = 0;
 	for(i=0;i<nRings;i++) nR[ringsSize[i]-ringSizeMin]++;
+	buffer = g_string_new(NULL);
 	for(i=0;i<n;i++)
 	{
 		if(i+ringSizeMin==3) sprintf(buffer1,"triangles");
@@ -700,12 +538,24 @@ static void messagesNumberOfRings(gint nRings, GList** rings)
 		else if(i+ringSizeMin==8) sprintf(buffer1,"octagons");
 		else sprintf(buffer1,"rings of size = %d\n",i+ringSizeMin);
 		if(i==0)
-		sprintf(buffer,"I found %d %s\n",nR[i], buffer1);
+		g_string_append_printf(buffer,"I found %d %s\n",nR[i], buffer1);
 		else
-		sprintf(buffer + strlen(buffer),"%s is %d\n", buffer1, nR[i]);
+		g_string_append_printf(buffer,"%s is %d\n", buffer1, nR[i]);
 	}
 	g_free(nR);
-	Message(buffer,"Info",TRUE);
+	/* bounded by ringSizeMax like the enumeration, the chordless rings of a fused system are exponential in number */
+	if(nCenters>0)
+	{
+		RingsPerception* rp = newRingsPerceptionFromBonds();
+		RingsList* sssr = getSSSR(rp, ringSizeMax);
+		RingsList* relevant = getRelevantRings(rp, ringSizeMax);
+		g_string_append_printf(buffer,"Smallest set of smallest rings of size <= %d : %d rings, number of relevant rings : %d\n", ringSizeMax, sssr->nRings, relevant->nRings);
+		freeRingsList(sssr);
+		freeRingsList(relevant);
+		freeRingsPerception(rp);
+	}
+	Message(buffer->str,"Info",TRUE);
+	g_string_free(buffer, TRUE);
 
 }
 /********************************************************************************/
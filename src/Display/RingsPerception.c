@@ -0,0 +1,579 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+/* Ring perception on a compressed adjacency list.
+ * Chordless rings : each ring is built once, from its smallest atom r, by extending paths r,v1,...,vk
+ * through atoms greater than r. An atom may be added only if it is bonded to no path atom other than the last one,
+ * a ring is closed when the new atom is bonded to r and is kept if v1 is smaller than the new atom.
+ * No duplicate can then be produced and the ring is directly in its canonical form.
+ * SSSR : Horton candidates (a BFS tree path from v to x, the bond x-y, the BFS tree path from y back to v)
+ * are generated by increasing size and kept if their bond vectors are independent over GF(2).
+ * Relevant rings : the chordless rings not in the span of the SSSR rings of smaller size.
+ */
+
+#include "../../Config.h"
+#include "GlobalOrb.h"
+#include <stdlib.h>
+#include <string.h>
+#include "../Display/RingsPerception.h"
+
+struct _RingsPerception
+{
+	gint nAtoms;
+	gint nBonds;
+	gint* first;      /* nAtoms+1, the neighbours of i are neighbours[first[i]...first[i+1]-1] */
+	gint* neighbours; /* sorted in each row */
+	gint* bondOf;     /* number of the bond of each neighbour entry */
+	gint nComponents;
+};
+
+typedef struct _ChordlessSearch
+{
+	RingsPerception* rp;
+	gint ringSizeMin;
+	gint ringSizeMax;
+	gint* path;
+	gint* nPathNeighbours; /* number of atoms v1...vk of the path bonded to each atom */
+	gboolean* inPath;
+	gboolean* rootNeighbour;
+	RingsList* rl;
+	gint nAlloc;
+}ChordlessSearch;
+
+typedef struct _CycleSpace
+{
+	gint nWords;
+	gint rank;
+	guint64** rows;
+	gint* pivots;
+}CycleSpace;
+
+/**************************************************************************/
+static gint cmpInt(const void* a, const void* b)
+{
+	gint i = *(const gint*)a;
+	gint j = *(const gint*)b;
+	if(i<j) return -1;
+	if(i>j) return 1;
+	return 0;
+}
+/**************************************************************************/
+RingsPerception* newRingsPerception(gint nAtoms, gint nBonds, gint* bondAtoms)
+{
+	RingsPerception* rp = g_malloc(sizeof(RingsPerception));
+	gint* count = g_malloc0((nAtoms+1)*sizeof(gint));
+	gint* stack = NULL;
+	gint* component = NULL;
+	gint i, j, k, b, n;
+
+	rp->nAtoms = nAtoms;
+	for(b=0;b<nBonds;b++)
+	{
+		i = bondAtoms[2*b];
+		j = bondAtoms[2*b+1];
+		if(i==j || i<0 || j<0 || i>=nAtoms || j>=nAtoms) continue;
+		count[i]++;
+		count[j]++;
+	}
+	rp->first = g_malloc((nAtoms+1)*sizeof(gint));
+	rp->first[0] = 0;
+	for(i=0;i<nAtoms;i++) rp->first[i+1] = rp->first[i]+count[i];
+	rp->neighbours = g_malloc((rp->first[nAtoms]+1)*sizeof(gint));
+	rp->bondOf = g_malloc((rp->first[nAtoms]+1)*sizeof(gint));
+	for(i=0;i<nAtoms;i++) count[i] = rp->first[i];
+	for(b=0;b<nBonds;b++)
+	{
+		i = bondAtoms[2*b];
+		j = bondAtoms[2*b+1];
+		if(i==j || i<0 || j<0 || i>=nAtoms || j>=nAtoms) continue;
+		rp->neighbours[count[i]++] = j;
+		rp->neighbours[count[j]++] = i;
+	}
+	/* sort the rows, remove the duplicated bonds, and number the bonds from the i<j entries */
+	n = 0;
+	for(i=0;i<nAtoms;i++)
+	{
+		gint begin = rp->first[i];
+		gint end = rp->first[i+1];
+		qsort(rp->neighbours+begin, end-begin, sizeof(gint), cmpInt);
+		rp->first[i] = n;
+		for(k=begin;k<end;k++)
+		{
+			if(k>begin && rp->neighbours[k]==rp->neighbours[k-1]) continue;
+			rp->neighbours[n++] = rp->neighbours[k];
+		}
+	}
+	rp->first[nAtoms] = n;
+	rp->nBonds = 0;
+	for(i=0;i<nAtoms;i++)
+	for(k=rp->first[i];k<rp->first[i+1];k++)
+	{
+		j = rp->neighbours[k];
+		if(j>i) rp->bondOf[k] = rp->nBonds++;
+		else
+		{
+			gint l;
+			for(l=rp->first[j];l<rp->first[j+1];l++)
+				if(rp->neighbours[l]==i) { rp->bondOf[k] = rp->bondOf[l]; break; }
+		}
+	}
+
+	rp->nComponents = 0;
+	if(nAtoms>0)
+	{
+		stack = g_malloc(nAtoms*sizeof(gint));
+		component = g_malloc(nAtoms*sizeof(gint));
+	}
+	for(i=0;i<nAtoms;i++) component[i] = -1;
+	for(i=0;i<nAtoms;i++)
+	{
+		gint top = 0;
+		if(component[i]>=0) continue;
+		component[i] = rp->nComponents;
+		stack[top++] = i;
+		while(top>0)
+		{
+			gint a = stack[--top];
+			for(k=rp->first[a];k<rp->first[a+1];k++)
+			{
+				j = rp->neighbours[k];
+				if(component[j]>=0) continue;
+				component[j] = rp->nComponents;
+				stack[top++] = j;
+			}
+		}
+		rp->nComponents++;
+	}
+	if(stack) g_free(stack);
+	if(component) g_free(component);
+	g_free(count);
+	return rp;
+}
+/**************************************************************************/
+void freeRingsPerception(RingsPerception* rp)
+{
+	if(!rp) return;
+	g_free(rp->first);
+	g_free(rp->neighbours);
+	g_free(rp->bondOf);
+	g_free(rp);
+}
+/**************************************************************************/
+gint getRingsPerceptionCyclomaticNumber(RingsPerception* rp)
+{
+	if(!rp) return 0;
+	return rp->nBonds - rp->nAtoms + rp->nComponents;
+}
+/**************************************************************************/
+static gint getBondNumber(RingsPerception* rp, gint i, gint j)
+{
+	gint k;
+	for(k=rp->first[i];k<rp->first[i+1];k++)
+		if(rp->neighbours[k]==j) return rp->bondOf[k];
+	return -1;
+}
+/**************************************************************************/
+void freeRingsList(RingsList* rl)
+{
+	gint n;
+	if(!rl) return;
+	for(n=0;n<rl->nRings;n++) if(rl->rings[n]) g_free(rl->rings[n]);
+	if(rl->rings) g_free(rl->rings);
+	if(rl->ringsSize) g_free(rl->ringsSize);
+	g_free(rl);
+}
+/**************************************************************************/
+static RingsList* newRingsList()
+{
+	RingsList* rl = g_malloc(sizeof(RingsList));
+	rl->nRings = 0;
+	rl->ringsSize = NULL;
+	rl->rings = NULL;
+	return rl;
+}
+/**************************************************************************/
+static void addRingToList(RingsList* rl, gint* nAlloc, gint ringSize, gint* ring)
+{
+	if(rl->nRings>=*nAlloc)
+	{
+		*nAlloc = 2*(*nAlloc)+16;
+		rl->rings = g_realloc(rl->rings, (*nAlloc)*sizeof(gint*));
+		rl->ringsSize = g_realloc(rl->ringsSize, (*nAlloc)*sizeof(gint));
+	}
+	rl->rings[rl->nRings] = g_malloc(ringSize*sizeof(gint));
+	memcpy(rl->rings[rl->nRings], ring, ringSize*sizeof(gint));
+	rl->ringsSize[rl->nRings] = ringSize;
+	rl->nRings++;
+}
+/**************************************************************************/
+static gint cmpRings(gint size1, gint* ring1, gint size2, gint* ring2)
+{
+	gint i;
+	if(size1 != size2) return (size1<size2)?-1:1;
+	for(i=0;i<size1;i++)
+		if(ring1[i] != ring2[i]) return (ring1[i]<ring2[i])?-1:1;
+	return 0;
+}
+/**************************************************************************/
+static RingsList* sortedRingsList = NULL;
+static gint cmpRingsIndex(const void* a, const void* b)
+{
+	gint i = *(const gint*)a;
+	gint j = *(const gint*)b;
+	RingsList* rl = sortedRingsList;
+	return cmpRings(rl->ringsSize[i], rl->rings[i], rl->ringsSize[j], rl->rings[j]);
+}
+/**************************************************************************/
+/* sort by canonical key and remove the duplicated rings */
+static void sortRingsList(RingsList* rl)
+{
+	gint* index;
+	gint** rings;
+	gint* ringsSize;
+	gint n, m;
+
+	if(rl->nRings<1) return;
+	index = g_malloc(rl->nRings*sizeof(gint));
+	for(n=0;n<rl->nRings;n++) index[n] = n;
+	sortedRingsList = rl;
+	qsort(index, rl->nRings, sizeof(gint), cmpRingsIndex);
+	sortedRingsList = NULL;
+	rings = g_malloc(rl->nRings*sizeof(gint*));
+	ringsSize = g_malloc(rl->nRings*sizeof(gint));
+	m = 0;
+	for(n=0;n<rl->nRings;n++)
+	{
+		gint k = index[n];
+		if(m>0 && !cmpRings(ringsSize[m-1], rings[m-1], rl->ringsSize[k], rl->rings[k]))
+		{
+			g_free(rl->rings[k]);
+			continue;
+		}
+		rings[m] = rl->rings[k];
+		ringsSize[m] = rl->ringsSize[k];
+		m++;
+	}
+	g_free(rl->rings);
+	g_free(rl->ringsSize);
+	g_free(index);
+	rl->rings = rings;
+	rl->ringsSize = ringsSize;
+	rl->nRings = m;
+}
+/**************************************************************************/
+void canonicalRing(gint ringSize, gint* ring)
+{
+	gint* t;
+	gint i, iMin = 0;
+	gint next, previous;
+
+	if(ringSize<3) return;
+	for(i=1;i<ringSize;i++) if(ring[i]<ring[iMin]) iMin = i;
+	next = ring[(iMin+1)%ringSize];
+	previous = ring[(iMin+ringSize-1)%ringSize];
+	t = g_malloc(ringSize*sizeof(gint));
+	if(next<previous) for(i=0;i<ringSize;i++) t[i] = ring[(iMin+i)%ringSize];
+	else for(i=0;i<ringSize;i++) t[i] = ring[(iMin-i+ringSize)%ringSize];
+	memcpy(ring, t, ringSize*sizeof(gint));
+	g_free(t);
+}
+/**************************************************************************/
+static void pushChordlessPath(ChordlessSearch* cs, gint k, gint atom, gint inc)
+{
+	RingsPerception* rp = cs->rp;
+	gint l;
+	cs->path[k] = atom;
+	cs->inPath[atom] = (inc>0);
+	for(l=rp->first[atom];l<rp->first[atom+1];l++) cs->nPathNeighbours[rp->neighbours[l]] += inc;
+}
+/**************************************************************************/
+static void extendChordlessPath(ChordlessSearch* cs, gint k)
+{
+	RingsPerception* rp = cs->rp;
+	gint root = cs->path[0];
+	gint current = cs->path[k];
+	gint l;
+
+	for(l=rp->first[current];l<rp->first[current+1];l++)
+	{
+		gint atom = rp->neighbours[l];
+		if(atom<=root || cs->inPath[atom]) continue;
+		if(cs->nPathNeighbours[atom] != 1) continue; /* chord with an inner atom of the path */
+		if(cs->rootNeighbour[atom])
+		{
+			if(k+2>=cs->ringSizeMin && k+2<=cs->ringSizeMax && cs->path[1]<atom)
+			{
+				cs->path[k+1] = atom;
+				addRingToList(cs->rl, &cs->nAlloc, k+2, cs->path);
+			}
+			continue;
+		}
+		if(k+2>=cs->ringSizeMax) continue;
+		pushChordlessPath(cs, k+1, atom, 1);
+		extendChordlessPath(cs, k+1);
+		pushChordlessPath(cs, k+1, atom, -1);
+	}
+}
+/**************************************************************************/
+RingsList* getChordlessRings(RingsPerception* rp, gint ringSizeMin, gint ringSizeMax)
+{
+	ChordlessSearch cs;
+	gint root, l;
+	gint nAtoms;
+
+	if(!rp) return NULL;
+	nAtoms = rp->nAtoms;
+	cs.rl = newRingsList();
+	if(ringSizeMin<3) ringSizeMin = 3;
+	if(ringSizeMax>nAtoms) ringSizeMax = nAtoms;
+	if(ringSizeMax<ringSizeMin) return cs.rl;
+	cs.rp = rp;
+	cs.ringSizeMin = ringSizeMin;
+	cs.ringSizeMax = ringSizeMax;
+	cs.nAlloc = 0;
+	cs.path = g_malloc(ringSizeMax*sizeof(gint));
+	cs.nPathNeighbours = g_malloc0(nAtoms*sizeof(gint));
+	cs.inPath = g_malloc0(nAtoms*sizeof(gboolean));
+	cs.rootNeighbour = g_malloc0(nAtoms*sizeof(gboolean));
+	for(root=0;root<nAtoms;root++)
+	{
+		if(rp->first[root+1]-rp->first[root]<2) continue;
+		cs.path[0] = root;
+		for(l=rp->first[root];l<rp->first[root+1];l++) cs.rootNeighbour[rp->neighbours[l]] = TRUE;
+		for(l=rp->first[root];l<rp->first[root+1];l++)
+		{
+			gint atom = rp->neighbours[l];
+			if(atom<root) continue;
+			pushChordlessPath(&cs, 1, atom, 1);
+			extendChordlessPath(&cs, 1);
+			pushChordlessPath(&cs, 1, atom, -1);
+		}
+		for(l=rp->first[root];l<rp->first[root+1];l++) cs.rootNeighbour[rp->neighbours[l]] = FALSE;
+	}
+	g_free(cs.path);
+	g_free(cs.nPathNeighbours);
+	g_free(cs.inPath);
+	g_free(cs.rootNeighbour);
+	sortRingsList(cs.rl);
+	return cs.rl;
+}
+/**************************************************************************/
+static CycleSpace* newCycleSpace(gint nBonds, gint nMax)
+{
+	CycleSpace* space = g_malloc(sizeof(CycleSpace));
+	space->nWords = (nBonds+63)/64;
+	if(space->nWords<1) space->nWords = 1;
+	space->rank = 0;
+	space->rows = g_malloc((nMax+1)*sizeof(guint64*));
+	space->pivots = g_malloc((nMax+1)*sizeof(gint));
+	return space;
+}
+/**************************************************************************/
+static void freeCycleSpace(CycleSpace* space)
+{
+	gint i;
+	for(i=0;i<space->rank;i++) g_free(space->rows[i]);
+	g_free(space->rows);
+	g_free(space->pivots);
+	g_free(space);
+}
+/**************************************************************************/
+static void setRingVector(RingsPerception* rp, gint ringSize, gint* ring, guint64* v, gint nWords)
+{
+	gint i;
+	memset(v, 0, nWords*sizeof(guint64));
+	for(i=0;i<ringSize;i++)
+	{
+		gint b = getBondNumber(rp, ring[i], ring[(i+1)%ringSize]);
+		if(b>=0) v[b/64] ^= ((guint64)1)<<(b%64);
+	}
+}
+/**************************************************************************/
+/* reduce v by the rows of the space, return the first non zero bit of the remainder, -1 if v is in the space */
+static gint reduceByCycleSpace(CycleSpace* space, guint64* v)
+{
+	gint i, w;
+	for(i=0;i<space->rank;i++)
+	{
+		gint p = space->pivots[i];
+		if(v[p/64] & (((guint64)1)<<(p%64)))
+			for(w=0;w<space->nWords;w++) v[w] ^= space->rows[i][w];
+	}
+	for(w=0;w<space->nWords;w++)
+		if(v[w])
+		{
+			gint p = 0;
+			while(!(v[w] & (((guint64)1)<<p))) p++;
+			return 64*w+p;
+		}
+	return -1;
+}
+/**************************************************************************/
+static gboolean addToCycleSpace(CycleSpace* space, guint64* v)
+{
+	gint p = reduceByCycleSpace(space, v);
+	if(p<0) return FALSE;
+	space->rows[space->rank] = g_malloc(space->nWords*sizeof(guint64));
+	memcpy(space->rows[space->rank], v, space->nWords*sizeof(guint64));
+	space->pivots[space->rank] = p;
+	space->rank++;
+	return TRUE;
+}
+/**************************************************************************/
+/* Horton candidates of size ringSize, canonical and without duplicates */
+static RingsList* getHortonCandidates(RingsPerception* rp, gint ringSize, gint* depth, gint* parent, gint* branch, gint* queue)
+{
+	RingsList* rl = newRingsList();
+	gint nAlloc = 0;
+	gint half = ringSize/2;
+	gint* ring = g_malloc(ringSize*sizeof(gint));
+	gint v, i;
+
+	for(i=0;i<rp->nAtoms;i++) depth[i] = -1;
+	for(v=0;v<rp->nAtoms;v++)
+	{
+		gint head = 0, tail = 0;
+		gint k;
+		if(rp->first[v+1]-rp->first[v]<2) continue;
+		depth[v] = 0;
+		parent[v] = -1;
+		branch[v] = v;
+		queue[tail++] = v;
+		while(head<tail)
+		{
+			gint a = queue[head++];
+			if(depth[a]>=half) continue;
+			for(k=rp->first[a];k<rp->first[a+1];k++)
+			{
+				gint b = rp->neighbours[k];
+				if(depth[b]>=0) continue;
+				depth[b] = depth[a]+1;
+				parent[b] = a;
+				branch[b] = (a==v)?b:branch[a];
+				queue[tail++] = b;
+			}
+		}
+		/* cycle v...x-y...v with depth[x]+depth[y]+1 = ringSize */
+		for(i=0;i<tail;i++)
+		{
+			gint x = queue[i];
+			if(x==v) continue;
+			for(k=rp->first[x];k<rp->first[x+1];k++)
+			{
+				gint y = rp->neighbours[k];
+				gint a, n;
+				if(depth[y]<0 || depth[x]+depth[y]+1 != ringSize) continue;
+				if(depth[x]==depth[y] && x>y) continue;
+				if(depth[y]==depth[x]+1 && parent[y]==x) continue;
+				if(depth[y]<depth[x]) continue;
+				if(branch[x]==branch[y]) continue;
+				n = 0;
+				for(a=x;a!=-1;a=parent[a]) n++;
+				for(a=x;a!=-1;a=parent[a]) ring[--n] = a;
+				n = depth[x]+1;
+				for(a=y;a!=v;a=parent[a]) ring[n++] = a;
+				canonicalRing(ringSize, ring);
+				addRingToList(rl, &nAlloc, ringSize, ring);
+			}
+		}
+		for(i=0;i<tail;i++) depth[queue[i]] = -1;
+	}
+	g_free(ring);
+	sortRingsList(rl);
+	return rl;
+}
+/**************************************************************************/
+RingsList* getSSSR(RingsPerception* rp, gint ringSizeMax)
+{
+	RingsList* sssr;
+	CycleSpace* space;
+	gint mu;
+	gint ringSize;
+	gint* depth;
+	gint* parent;
+	gint* branch;
+	gint* queue;
+	guint64* v;
+	gint nAlloc = 0;
+
+	if(!rp) return NULL;
+	sssr = newRingsList();
+	mu = getRingsPerceptionCyclomaticNumber(rp);
+	if(mu<1) return sssr;
+	space = newCycleSpace(rp->nBonds, mu);
+	v = g_malloc(space->nWords*sizeof(guint64));
+	depth = g_malloc(rp->nAtoms*sizeof(gint));
+	parent = g_malloc(rp->nAtoms*sizeof(gint));
+	branch = g_malloc(rp->nAtoms*sizeof(gint));
+	queue = g_malloc(rp->nAtoms*sizeof(gint));
+	for(ringSize=3;ringSize<=MIN(rp->nAtoms,ringSizeMax) && space->rank<mu;ringSize++)
+	{
+		RingsList* candidates = getHortonCandidates(rp, ringSize, depth, parent, branch, queue);
+		gint n;
+		for(n=0;n<candidates->nRings && space->rank<mu;n++)
+		{
+			setRingVector(rp, ringSize, candidates->rings[n], v, space->nWords);
+			if(addToCycleSpace(space, v)) addRingToList(sssr, &nAlloc, ringSize, candidates->rings[n]);
+		}
+		freeRingsList(candidates);
+	}
+	g_free(depth);
+	g_free(parent);
+	g_free(branch);
+	g_free(queue);
+	g_free(v);
+	freeCycleSpace(space);
+	return sssr;
+}
+/**************************************************************************/
+RingsList* getRelevantRings(RingsPerception* rp, gint ringSizeMax)
+{
+	RingsList* sssr;
+	RingsList* chordless;
+	RingsList* relevant;
+	CycleSpace* space;
+	guint64* v;
+	gint nAlloc = 0;
+	gint n, m;
+
+	if(!rp) return NULL;
+	/* a relevant ring is tested against the smaller SSSR rings only, the truncated SSSR is enough */
+	sssr = getSSSR(rp, ringSizeMax);
+	if(sssr->nRings<1) return sssr;
+	chordless = getChordlessRings(rp, 3, sssr->ringsSize[sssr->nRings-1]);
+	relevant = newRingsList();
+	space = newCycleSpace(rp->nBonds, sssr->nRings);
+	v = g_malloc(space->nWords*sizeof(guint64));
+	/* the two lists are sorted by size : the space holds the SSSR rings smaller than the tested ring */
+	m = 0;
+	for(n=0;n<chordless->nRings;n++)
+	{
+		gint ringSize = chordless->ringsSize[n];
+		for(;m<sssr->nRings && sssr->ringsSize[m]<ringSize;m++)
+		{
+			setRingVector(rp, sssr->ringsSize[m], sssr->rings[m], v, space->nWords);
+			addToCycleSpace(space, v);
+		}
+		setRingVector(rp, ringSize, chordless->rings[n], v, space->nWords);
+		if(reduceByCycleSpace(space, v)>=0) addRingToList(relevant, &nAlloc, ringSize, chordless->rings[n]);
+	}
+	g_free(v);
+	freeCycleSpace(space);
+	freeRingsList(chordless);
+	freeRingsList(sssr);
+	return relevant;
+}
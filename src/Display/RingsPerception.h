@@ -0,0 +1,50 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#ifndef __GABEDIT_RINGSPERCEPTION_H__
+#define __GABEDIT_RINGSPERCEPTION_H__
+
+typedef struct _RingsPerception RingsPerception;
+
+/* rings[n] : the ringsSize[n] atoms of the ring n in cycle order.
+ * A ring is in canonical form : its smallest atom first and rings[n][1]<rings[n][ringsSize[n]-1].
+ * The rings are sorted by size then by their canonical atom lists. */
+typedef struct _RingsList
+{
+	gint nRings;
+	gint* ringsSize;
+	gint** rings;
+}RingsList;
+
+/* bondAtoms : 2*nBonds atom numbers, duplicated bonds and self bonds are ignored */
+RingsPerception* newRingsPerception(gint nAtoms, gint nBonds, gint* bondAtoms);
+void freeRingsPerception(RingsPerception* rp);
+/* number of independent rings : nBonds - nAtoms + number of connected components */
+gint getRingsPerceptionCyclomaticNumber(RingsPerception* rp);
+/* all the rings without chord with ringSizeMin <= size <= ringSizeMax */
+RingsList* getChordlessRings(RingsPerception* rp, gint ringSizeMin, gint ringSizeMax);
+/* rings of size <= ringSizeMax of the smallest set of smallest rings (a minimum cycle basis) */
+RingsList* getSSSR(RingsPerception* rp, gint ringSizeMax);
+/* rings of size <= ringSizeMax of the union of all the SSSR : the rings that are not a sum of smaller rings */
+RingsList* getRelevantRings(RingsPerception* rp, gint ringSizeMax);
+void freeRingsList(RingsList* rl);
+/* rotate and reverse the ring to its canonical form */
+void canonicalRing(gint ringSize, gint* ring);
+
+#endif /* __GABEDIT_RINGSPERCEPTION_H__ */
+
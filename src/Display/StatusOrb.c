@@ -58,6 +58,7 @@ void setTextInProgress(gchar* t)
 {
 
 	guint idStatus = 0;
+	if(!StatusProgress) return;
 	idStatus= gtk_statusbar_get_context_id(GTK_STATUSBAR(StatusProgress),"Testing");
 	gtk_statusbar_pop(GTK_STATUSBAR(StatusProgress),idStatus);
 	gtk_statusbar_push(GTK_STATUSBAR(StatusProgress),idStatus, t);
@@ -70,6 +71,7 @@ gint progress_orb_txt(gdouble scal,gchar* str,gboolean reset)
 	gdouble new_val;
 	guint idStatus = 0;
 
+	if(!ProgressBar) return TRUE;
 	gtk_widget_set_sensitive(button, FALSE); 
 	idStatus= gtk_statusbar_get_context_id(GTK_STATUSBAR(StatusProgress),"Testing");
 	gtk_statusbar_pop(GTK_STATUSBAR(StatusProgress),idStatus);
@@ -113,6 +115,8 @@ gint progress_orb(gdouble scal,GabEditTypeProgressOrb  type,gboolean reset)
 	gchar *t = NULL;
 	guint idStatus = 0;
 
+	/* no progress bar in the batch mode */
+	if(!ProgressBar) return TRUE;
 	if(reset)
 	{
 		gtk_widget_show(ProgressBar);
@@ -259,7 +263,7 @@ void set_status_label_info(gchar* type,gchar* txt)
 
 	for(i=0;i<2;i++)
 		for(j=0;j<4;j++)
-		if(strcmp(type,tlabels[i][j])==0)
+		if(Status[i][j] && strcmp(type,tlabels[i][j])==0)
 		{
 			gchar*t = g_strdup_printf(" %s : %s ",tlabels[i][j],txt);
 			idStatus= gtk_statusbar_get_context_id(GTK_STATUSBAR(Status[i][j]),"Testing");
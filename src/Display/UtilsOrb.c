@@ -39,8 +39,10 @@ DEALINGS IN THE SOFTWARE.
 #include "../Display/PlanesMappedPov.h"
 #include "../Display/GridCube.h"
 #include "../Display/GridCP.h"
+#include "../Display/GridAO.h"
 #include "../Display/ColorMap.h"
 #include "../Display/LabelsGL.h"
+#include "../Utils/EigenSolver.h"
 
 /**********************************************/
 static gint getOptimalN(gint nG)
@@ -97,6 +99,71 @@ gdouble** FreeTable2(gdouble **T,gint N)
 	return NULL;
 }
 /**********************************************/
+/* S : overlap matrix n*n, packed lower triangle (S[i*(i+1)/2+j], j<=i)
+ * return S^-1/2 (n*n table) built from the nvec largest eigenvalues of S (all if nvec<1 or nvec>n),
+ * NULL if the diagonalisation fails */
+gdouble **CalculSm12(gdouble *S,gint n,gint nvec)
+{
+	gdouble* A;
+	gdouble* d;
+	gdouble* V;
+	gdouble** Sm12;
+	gint i;
+	gint j;
+
+	if(n<1) return NULL;
+	if(nvec<1 || nvec>n) nvec = n;
+	A = g_malloc(n*n*sizeof(gdouble));
+	d = g_malloc(n*sizeof(gdouble));
+	V = g_malloc(n*n*sizeof(gdouble));
+	for(i=0;i<n;i++)
+	for(j=0;j<=i;j++)
+	{
+		A[i*n+j] = S[i*(i+1)/2+j];
+		A[j*n+i] = A[i*n+j];
+	}
+	if(!eigenSymmetric(n, A, d, V))
+	{
+		g_free(A);
+		g_free(d);
+		g_free(V);
+		return NULL;
+	}
+	/* eigenvalues in ascending order, the n-nvec smallest are dropped */
+	for(j=0;j<n;j++)
+	{
+		if(j<n-nvec) d[j] = 0;
+		else
+		{
+			if(d[j]<1e-10) printf("Warning in CalculSm12 : vectors almost lineary dependent\n");
+			d[j] = 1.0/sqrt(fabs(d[j])+1e-20);
+		}
+	}
+	Sm12 = CreateTable2(n);
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(i,j)
+#endif
+	for(i=0;i<n;i++)
+	{
+		gint k;
+		gdouble* w = g_malloc(n*sizeof(gdouble));
+		for(k=0;k<n;k++) w[k] = V[i*n+k]*d[k];
+		for(j=0;j<=i;j++)
+		{
+			gdouble s = 0;
+			for(k=n-nvec;k<n;k++) s += w[k]*V[j*n+k];
+			Sm12[i][j] = s;
+		}
+		g_free(w);
+	}
+	for(i=0;i<n;i++)
+	for(j=0;j<i;j++) Sm12[j][i] = Sm12[i][j];
+	g_free(A);
+	g_free(d);
+	g_free(V);
+	return Sm12;
+}
+/**********************************************/
 gint GetTotalNelectrons()
 {
   gint i;
@@ -754,6 +821,7 @@ void free_data_all()
 {
         free_grid_all();
         free_iso_all();
+        free_grid_ao();
         free_orbitals();
         free_geometry();
 	set_label_title("",0,0);
@@ -1241,7 +1309,7 @@ void applyelfdens(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : one entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -1251,7 +1319,7 @@ void applyelfdens(GtkWidget *Win,gpointer data)
 		if(NumPointstmp[i] <=2)
 		{
 			GtkWidget* message = Message(_("Error : The number of points should be > 2. "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		
@@ -1262,7 +1330,7 @@ void applyelfdens(GtkWidget *Win,gpointer data)
 		if( limitstmp.MinMax[0][i]> limitstmp.MinMax[1][i])
 		{
 			GtkWidget* message = Message(_("Error :  The minimal value should be smaller than the maximal value "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 	}
@@ -1287,7 +1355,7 @@ void applyelfdens(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : one entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -1302,7 +1370,7 @@ void applyelfdens(GtkWidget *Win,gpointer data)
 		if(fabs(norm)<1e-8)
 		{
 			GtkWidget* message = Message(_("Error : the norm is equal to 0 "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		for(j=0;j<3;j++)
@@ -1442,7 +1510,7 @@ gint get_number_of_point(GtkWidget* Entry)
 	if(t && !this_is_a_integer(t))
 	{
 		GtkWidget* win = Message(_("Error : The number of points should be integer. "),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (win), TRUE);
+  		if(win) gtk_window_set_modal (GTK_WINDOW (win), TRUE);
 		g_free(t);
 		return -1;
 	}
@@ -1451,7 +1519,7 @@ gint get_number_of_point(GtkWidget* Entry)
 	if(N<=0)
 	{
 		GtkWidget* win = Message(_("Error : The number of points should be positive. "),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (win), TRUE);
+  		if(win) gtk_window_set_modal (GTK_WINDOW (win), TRUE);
 		return -1;
 	}
 	return N;
@@ -1471,14 +1539,14 @@ gboolean get_a_float(GtkWidget* Entry,gdouble* value, gchar* errorMessage)
 	else
 	{
 		GtkWidget* win = Message(errorMessage,_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (win), TRUE);
+  		if(win) gtk_window_set_modal (GTK_WINDOW (win), TRUE);
 		return FALSE;
 	}
 	if(t && !this_is_a_real(t))
 	{
 		GtkWidget* win = Message(errorMessage,_("Error"),TRUE);
 		g_free(t);
-  		gtk_window_set_modal (GTK_WINDOW (win), TRUE);
+  		if(win) gtk_window_set_modal (GTK_WINDOW (win), TRUE);
 		return FALSE;
 	}
 	if(t) g_free(t);
@@ -1507,8 +1575,8 @@ void initialise_global_orbitals_variables()
 	SurfShow = GABEDIT_SURFSHOW_POSNEG;
 	TypeTexture = GABEDIT_TYPETEXTURE_NONE;
 	Title = NULL;
-	ScreenWidthD = gdk_screen_width();
-	ScreenHeightD = gdk_screen_height();
+	ScreenWidthD = gdk_screen_get_default()?gdk_screen_width():1024;
+	ScreenHeightD = gdk_screen_get_default()?gdk_screen_height():768;
 	for(i=0;i<3;i++)
 		limits.MinMax[0][i] = -5;
 	for(i=0;i<3;i++)
@@ -1553,6 +1621,7 @@ void initialise_global_orbitals_variables()
 	SOverlaps = NULL;
 	solventRadius = 1.4;
 	alphaFED = 3.0; /* eV^-1 */
+	gridAOMaxMemory = 1024; /* MB */
 }
 /********************************************************************************/
 void close_window_orb(GtkWidget*win, gpointer data)
@@ -1688,7 +1757,7 @@ static void applygridsas(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : one entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -1698,7 +1767,7 @@ static void applygridsas(GtkWidget *Win,gpointer data)
 		if(NumPointstmp[i] <=2)
 		{
 			GtkWidget* message = Message(_("Error : The number of points should be > 2. "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		
@@ -1720,7 +1789,7 @@ static void applygridsas(GtkWidget *Win,gpointer data)
 		else
 		{
 			GtkWidget* message = Message(_("Error : The solvent radius should be a float "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		if(dump) g_free(dump);
@@ -1731,7 +1800,7 @@ static void applygridsas(GtkWidget *Win,gpointer data)
 		if( limitstmp.MinMax[0][i]> limitstmp.MinMax[1][i])
 		{
 			GtkWidget* message = Message(_("Error :  The minimal value should be smaller than the maximal value "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 	}
@@ -1756,7 +1825,7 @@ static void applygridsas(GtkWidget *Win,gpointer data)
 			else
 			{
 				GtkWidget* message = Message(_("Error : one entry is not a float "),_("Error"),TRUE);
-  				gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  				if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 				return;
 			}
 			if(dump) g_free(dump);
@@ -1771,7 +1840,7 @@ static void applygridsas(GtkWidget *Win,gpointer data)
 		if(fabs(norm)<1e-8)
 		{
 			GtkWidget* message = Message(_("Error : the norm is equal to 0 "),_("Error"),TRUE);
-  			gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  			if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 			return;
 		}
 		for(j=0;j<3;j++)
@@ -2347,9 +2416,9 @@ static void set_alphaFED(GtkWidget *button,gpointer data)
 	else
 	{
 		GtkWidget* message = Message(_("Error : alpha should be a real between 0 and 100 "),_("Error"),TRUE);
-  		gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
 		if(dump) g_free(dump);
-		gtk_window_set_transient_for(GTK_WINDOW(message),GTK_WINDOW(Win));
+		if(message) gtk_window_set_transient_for(GTK_WINDOW(message),GTK_WINDOW(Win));
 		return;
 	}
 }
@@ -2439,3 +2508,113 @@ GtkWidget* set_alphaFED_dialog ()
 	gtk_widget_show_all(fp);
 	return fp;
 }
+/*********************************************************************************************************************/
+static void set_grid_ao_memory(GtkWidget *button,gpointer data)
+{
+	GtkWidget* entry = (GtkWidget*)data;
+	G_CONST_RETURN gchar* temp;
+	gchar* dump = NULL;
+	GtkWidget* Win = g_object_get_data (G_OBJECT (button), "Win");
+
+	if(!GTK_IS_WIDGET(data)) return;
+
+       	temp	= gtk_entry_get_text(GTK_ENTRY(entry)); 
+	if(temp && strlen(temp)>0)
+	{
+		dump = g_strdup(temp);
+		delete_first_spaces(dump);
+		delete_last_spaces(dump);
+	}
+
+	if(dump && strlen(dump)>0 && this_is_a_real(dump) && atof(dump)>=0)
+	{
+		gridAOMaxMemory = atof(dump);
+		free_grid_ao();
+		if(dump) g_free(dump);
+		gtk_widget_destroy(Win);
+	}
+	else
+	{
+		GtkWidget* message = Message(_("Error : the memory should be a positive real"),_("Error"),TRUE);
+  		if(message) gtk_window_set_modal (GTK_WINDOW (message), TRUE);
+		if(dump) g_free(dump);
+		if(message) gtk_window_set_transient_for(GTK_WINDOW(message),GTK_WINDOW(Win));
+		return;
+	}
+}
+/*********************************************************************/
+GtkWidget* set_grid_ao_memory_dialog ()
+{
+	GtkWidget *fp;
+	GtkWidget *frame;
+	GtkWidget *vboxall;
+	GtkWidget *vboxframe;
+	GtkWidget *hbox;
+	GtkWidget *button;
+	GtkWidget *label;
+	GtkWidget* entry;
+	GtkWidget *hseparator;
+	gchar* tlabel=_("Maximal memory (MB) : ");
+	gchar* val = NULL;
+	gchar* info = _(
+		"The values of the basis functions on the grid are kept in memory,\n"
+		"so that the grid of another orbital is obtained by a simple sum.\n"
+		"Each function is stored only where it is not negligible.\n"
+		"If the cache needs more than this memory, the orbitals are computed\n"
+		"point by point as before. 0 disables the cache.\n");
+
+	fp = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+	gtk_window_set_modal(GTK_WINDOW(fp),TRUE);
+	gtk_window_set_title(GTK_WINDOW(fp),_("Memory for the basis functions on the grid"));
+	gtk_container_set_border_width (GTK_CONTAINER (fp), 5);
+
+	gtk_window_set_position(GTK_WINDOW(fp),GTK_WIN_POS_CENTER);
+	gtk_window_set_modal (GTK_WINDOW (fp), TRUE);
+
+	g_signal_connect(G_OBJECT(fp),"delete_event",(GCallback)gtk_widget_destroy,NULL);
+
+	vboxall = create_vbox(fp);
+	frame = gtk_frame_new (NULL);
+	gtk_container_set_border_width (GTK_CONTAINER (frame), 5);
+	gtk_container_add (GTK_CONTAINER (vboxall), frame);
+	gtk_widget_show (frame);
+
+	vboxframe = create_vbox(frame);
+
+	hbox = create_hbox(vboxframe);
+	label = gtk_label_new (info);
+	gtk_widget_show (label);
+	gtk_box_pack_start (GTK_BOX (hbox), label, TRUE, FALSE, 0);
+
+	hseparator = gtk_hseparator_new ();
+	gtk_box_pack_start (GTK_BOX (vboxframe), hseparator, TRUE, FALSE, 0);
+
+	hbox = create_hbox(vboxframe);
+	label = gtk_label_new (tlabel);
+	gtk_widget_show (label);
+	gtk_box_pack_start (GTK_BOX (hbox), label, TRUE, FALSE, 0);
+
+	entry = gtk_entry_new ();
+	gtk_widget_show (entry);
+	gtk_box_pack_start (GTK_BOX (hbox), entry, FALSE, TRUE, 0);
+	val = g_strdup_printf("%0.0f",gridAOMaxMemory);
+       	gtk_entry_set_text(GTK_ENTRY(entry),val);
+	if(val) g_free(val);
+
+	hbox = create_hbox(vboxall);
+
+	button = create_button(PrincipalWindow,_("OK"));
+	gtk_box_pack_start (GTK_BOX( hbox), button, TRUE, TRUE, 3);
+	g_signal_connect(G_OBJECT(button), "clicked",G_CALLBACK(set_grid_ao_memory),(gpointer)entry);
+	g_object_set_data (G_OBJECT (button), "Win", fp);
+	gtk_widget_show (button);
+
+	button = create_button(PrincipalWindow,_("Cancel"));
+	gtk_box_pack_start (GTK_BOX( hbox), button, TRUE, TRUE, 3);
+	g_signal_connect_swapped(G_OBJECT(button), "clicked",G_CALLBACK(gtk_widget_destroy),GTK_OBJECT(fp));
+
+	gtk_widget_show (button);
+   
+	gtk_widget_show_all(fp);
+	return fp;
+}
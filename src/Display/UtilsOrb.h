@@ -61,6 +61,7 @@ void set_scale_ball_stick_dlg();
 void createColorMapOptionsWindow(GtkWidget* win);
 void create_grid_ELF_Dens_analyze(gboolean ongrid);
 GtkWidget* set_alphaFED_dialog ();
+GtkWidget* set_grid_ao_memory_dialog ();
 void resetAllColorMapOrb();
 
 #endif /* __GABEDIT_UTILSORB_H__ */
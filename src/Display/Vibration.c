@@ -22,6 +22,7 @@ DEALINGS IN THE SOFTWARE.
 #include "GlobalOrb.h"
 #include "../Utils/AtomsProp.h"
 #include "../Utils/Utils.h"
+#include "../Utils/FChkFile.h"
 #include "../Utils/QL.h"
 #include "../Utils/Constants.h"
 #include "../Utils/UtilsInterface.h"
@@ -198,74 +199,15 @@ static void sortFrequencies(int nModes, double* frequencies, double** modes, dou
 	}
 }
 /********************************************************************************/
-static gboolean read_orca_hessian_file_hessian(FILE*fd)
+/* hessian in au, mass-weighted in place. dipoleDerivatives [3*nAtoms][3] in au, can be NULL */
+static void set_modes_from_hessian(gint nFreqs, gdouble** hessian, gdouble** dipoleDerivatives)
 {
-	gint nFreqs = 0;
- 	gchar t[BSIZE];
-	gint nblock, iblock;
-	gdouble** hessian = NULL;
 	gdouble* frequencies = NULL;
 	gdouble* effectiveMasses = NULL;
 	gdouble** modes = NULL;
-	gint jh;
-	gint nf;
 	gint i,j,k;
-	gdouble v[6];
-	gint ih[6];
 	gint c;
-	rewind(fd);
- 	while(!feof(fd))
-	{
-    		{ char* e = fgets(t,BSIZE,fd);}
- 		if (strstr( t,"$hessian") )
-		{
-    			fgets(t,BSIZE,fd);
-			/* printf("t=%s\n",t);*/
-			sscanf(t,"%d",&nFreqs);
-			break;
-		}
-	}
-	printf("nFreqs = %d\n",nFreqs);
-	if(nFreqs<1) return FALSE;
-	if(vibration.numberOfAtoms*3 != nFreqs)
-	{
-		fprintf(stderr,"Error : dimension of hessian matrix is not equal to 3*number of Atoms\n");
-		return FALSE;
-	}
-	hessian = g_malloc(nFreqs*sizeof(gdouble*));
-	for(j=0;j<nFreqs;j++) hessian[j] = g_malloc(nFreqs*sizeof(gdouble));
-	for(j=0;j<nFreqs;j++) for(i=0;i<nFreqs;i++) hessian[i][j] = 0.0;
 
-	nblock = nFreqs/6; 
-	if(nFreqs%6!=0) nblock++;
-	for(iblock = 0;iblock<nblock;iblock++)
-	{
-		if(!fgets(t,BSIZE,fd)) break;
-		/* printf("t=%s\n",t);*/
-		nf = sscanf(t,"%d %d %d %d %d %d", &ih[0],&ih[1],&ih[2], &ih[3],&ih[4],&ih[5]);
-		if(iblock==0 && nf != 6 && nf>0)
-		{
-			nblock = nFreqs/nf; 
-			if(nFreqs%nf!=0) nblock++;
-		}
-		for(j=0;j<nFreqs && !feof(fd);j++)
-		{
-			if(!fgets(t,BSIZE,fd)) break;
-			/* printf("t=%s\n",t);*/
-			nf = sscanf(t,"%d %lf %lf %lf %lf %lf %lf",
-					&jh,
-					&v[0],&v[1],&v[2],
-					&v[3],&v[4],&v[5]
-					);
-			nf--;
-			if(jh<nFreqs && jh>-1)
-			for(k=0;k<nf;k++)
-			{
-		
-				if(ih[k]<nFreqs && ih[k]>-1) hessian[jh][ih[k]]  = v[k]; 
-			}
-		}
-	}
         for(i=0;i<vibration.numberOfAtoms;i++) for(c=0;c<3;c++) 
 	for(j=0;j<vibration.numberOfAtoms;j++) for(k=0;k<3;k++) 
 		hessian[3*i+c][3*j+k] /= sqrt(GeomOrb[i].Prop.masse*GeomOrb[j].Prop.masse)*AMU_TO_AU;
@@ -327,12 +269,93 @@ static gboolean read_orca_hessian_file_hessian(FILE*fd)
 		}
 	}
 	vibration.numberOfFrequencies = nFreqs;
-	/* free tables */
-	if(hessian) for(j=0;j<nFreqs;j++) if(hessian[j]) g_free(hessian[j]);
-	if(hessian) g_free(hessian);
+	/* IR intensities in km/mol from the derivatives of the dipole along the normal coordinates */
+	if(dipoleDerivatives)
+	for(i=0;i<nFreqs;i++)
+	{
+		gdouble dmu[3] = {0,0,0};
+		gdouble ir = 0;
+		for(j=0;j<vibration.numberOfAtoms;j++)
+		for(c=0;c<3;c++)
+		for(k=0;k<3;k++)
+			dmu[k] += dipoleDerivatives[3*j+c][k]*vibration.modes[i].vectors[c][j];
+		for(k=0;k<3;k++) ir += dmu[k]*dmu[k];
+		vibration.modes[i].IRIntensity = 974.8801*ir/vibration.modes[i].effectiveMass;
+	}
 	if(modes) for(j=0;j<nFreqs;j++) if(modes[j]) g_free(modes[j]);
 	if(modes) g_free(modes);
 	if(frequencies) g_free(frequencies);
+	if(effectiveMasses) g_free(effectiveMasses);
+}
+/********************************************************************************/
+static gboolean read_orca_hessian_file_hessian(FILE*fd)
+{
+	gint nFreqs = 0;
+ 	gchar t[BSIZE];
+	gint nblock, iblock;
+	gdouble** hessian = NULL;
+	gint jh;
+	gint nf;
+	gint i,j,k;
+	gdouble v[6];
+	gint ih[6];
+	rewind(fd);
+ 	while(!feof(fd))
+	{
+    		{ char* e = fgets(t,BSIZE,fd);}
+ 		if (strstr( t,"$hessian") )
+		{
+    			fgets(t,BSIZE,fd);
+			/* printf("t=%s\n",t);*/
+			sscanf(t,"%d",&nFreqs);
+			break;
+		}
+	}
+	printf("nFreqs = %d\n",nFreqs);
+	if(nFreqs<1) return FALSE;
+	if(vibration.numberOfAtoms*3 != nFreqs)
+	{
+		fprintf(stderr,"Error : dimension of hessian matrix is not equal to 3*number of Atoms\n");
+		return FALSE;
+	}
+	hessian = g_malloc(nFreqs*sizeof(gdouble*));
+	for(j=0;j<nFreqs;j++) hessian[j] = g_malloc(nFreqs*sizeof(gdouble));
+	for(j=0;j<nFreqs;j++) for(i=0;i<nFreqs;i++) hessian[i][j] = 0.0;
+
+	nblock = nFreqs/6; 
+	if(nFreqs%6!=0) nblock++;
+	for(iblock = 0;iblock<nblock;iblock++)
+	{
+		if(!fgets(t,BSIZE,fd)) break;
+		/* printf("t=%s\n",t);*/
+		nf = sscanf(t,"%d %d %d %d %d %d", &ih[0],&ih[1],&ih[2], &ih[3],&ih[4],&ih[5]);
+		if(iblock==0 && nf != 6 && nf>0)
+		{
+			nblock = nFreqs/nf; 
+			if(nFreqs%nf!=0) nblock++;
+		}
+		for(j=0;j<nFreqs && !feof(fd);j++)
+		{
+			if(!fgets(t,BSIZE,fd)) break;
+			/* printf("t=%s\n",t);*/
+			nf = sscanf(t,"%d %lf %lf %lf %lf %lf %lf",
+					&jh,
+					&v[0],&v[1],&v[2],
+					&v[3],&v[4],&v[5]
+					);
+			nf--;
+			if(jh<nFreqs && jh>-1)
+			for(k=0;k<nf;k++)
+			{
+		
+				if(ih[k]<nFreqs && ih[k]>-1) hessian[jh][ih[k]]  = v[k]; 
+			}
+		}
+	}
+	set_modes_from_hessian(nFreqs, hessian, NULL);
+	/* free tables */
+	if(hessian) for(j=0;j<nFreqs;j++) if(hessian[j]) g_free(hessian[j]);
+	if(hessian) g_free(hessian);
 	return TRUE;
 }
 /********************************************************************************/
@@ -404,7 +427,7 @@ static gboolean read_orca_hessian_file_frequencies(gchar *FileName)
 
 		sprintf(buffer,_("Sorry, I can not read frequencies from '%s' file\n"),FileName);
   		w = Message(buffer,_("Error"),TRUE);
-		gtk_window_set_modal (GTK_WINDOW (w), TRUE);
+		if(w) gtk_window_set_modal (GTK_WINDOW (w), TRUE);
 		rafreshList();
 		return FALSE;
 	}
@@ -3841,7 +3864,7 @@ static gboolean read_dalton_geom(FILE* file, gchar *FileName)
  		if(!OK && (numgeom == 1) )
 		{
   			GtkWidget* w = Message(_("Sorry\nI can not read geometry from this file"),_("Error"),TRUE);
-			gtk_window_set_modal (GTK_WINDOW (w), TRUE);
+			if(w) gtk_window_set_modal (GTK_WINDOW (w), TRUE);
  			g_free(t);
  			for(i=0;i<5;i++) g_free(AtomCoord[i]);
 			set_status_label_info(_("File name"),_("Nothing"));
@@ -4276,7 +4299,7 @@ static gboolean read_gamess_geom(FILE* file, gchar *FileName)
  		if(!OK && (numgeom == 1) )
 		{
   			GtkWidget* w = Message(_("Sorry\nI can not read geometry from this file"),_("Error"),TRUE);
-			gtk_window_set_modal (GTK_WINDOW (w), TRUE);
+			if(w) gtk_window_set_modal (GTK_WINDOW (w), TRUE);
  			g_free(t);
  			for(i=0;i<5;i++) g_free(AtomCoord[i]);
 			set_status_label_info(_("File name"),_("Nothing"));
@@ -4683,7 +4706,7 @@ static gboolean read_gaussian_file_frequencies(gchar *FileName)
 		gchar buffer[BSIZE];
 		sprintf(buffer,_("Sorry, I can not read frequencies from '%s' file\n"),FileName);
   		w = Message(buffer,_("Error"),TRUE);
-		gtk_window_set_modal (GTK_WINDOW (w), TRUE);
+		if(w) gtk_window_set_modal (GTK_WINDOW (w), TRUE);
 		return FALSE;
 	}
 
@@ -4692,7 +4715,7 @@ static gboolean read_gaussian_file_frequencies(gchar *FileName)
 /********************************************************************************/
 static gboolean read_fchk_gaussian_file_frequencies(gchar *fileName)
 {
- 	FILE *file;
+ 	FChkFile *file;
 	gint nf;
 	gdouble* vibE2 = NULL;
 	gdouble* vibNM = NULL;
@@ -4703,37 +4726,35 @@ static gboolean read_fchk_gaussian_file_frequencies(gchar *fileName)
 	gint i,j,k;
 	gint n;
 
- 	file = FOpen(fileName, "rb");
+ 	file = new_fchk_gaussian_file(fileName);
 	if(!file) return FALSE;
-	nf = get_one_int_from_fchk_gaussian_file(file,"Number of Normal Modes ");
+	nf = get_one_int_from_fchk(file,"Number of Normal Modes ");
 	if(nf<1)
 	{
 		Message(_("Sorry\nNo normal modes in this file : Use the Freq(SaveNM) option in your input file"),_("Error"),TRUE);
-		fclose(file);
+		free_fchk_gaussian_file(file);
 		return FALSE;
 	}
-	rewind(file);
-	vibE2 = get_array_real_from_fchk_gaussian_file(file, "Vib-E2 ", &n);
+	vibE2 = get_array_real_from_fchk(file, "Vib-E2 ", &n);
 	/* nf frequencies, nf Red. masses , nf Frc consts, nf IR Inten  , nf Raman Activ, nf Depolar (P), nf Depolar (U) */
 	if(!vibE2 || n < 5*nf)
 	{
 		Message(_("Sorry\nI can not the frequencies from this file"),_("Error"),TRUE);
 		if(vibE2) g_free(vibE2);
-		fclose(file);
+		free_fchk_gaussian_file(file);
 		return FALSE;
 	}
-	rewind(file);
-	vibNM = get_array_real_from_fchk_gaussian_file(file, "Vib-Modes ", &n);
+	vibNM = get_array_real_from_fchk(file, "Vib-Modes ", &n);
 	if(!vibNM || n != nf*nCenters*3)
 	{
 		Message(_("Sorry\nI can not the normal modes from this file"),_("Error"),TRUE);
 		printf("n = %d nf*Ncent*3 = %d\n",n, nf*nCenters*3);
 		if(vibE2) g_free(vibE2);
 		if(vibNM) g_free(vibNM);
-		fclose(file);
+		free_fchk_gaussian_file(file);
 		return FALSE;
 	}
-	fclose(file);
+	free_fchk_gaussian_file(file);
 	idxMass = nf;
 	idxIR = 3*nf;
 	idxRaman = 4*nf;
@@ -5346,7 +5367,7 @@ static gboolean read_qchem_file_frequencies(gchar *FileName)
 		gchar buffer[BSIZE];
 		sprintf(buffer,_("Sorry, I can not read frequencies from '%s' file\n"),FileName);
   		w = Message(buffer,_("Error"),TRUE);
-		gtk_window_set_modal (GTK_WINDOW (w), TRUE);
+		if(w) gtk_window_set_modal (GTK_WINDOW (w), TRUE);
 		return FALSE;
 	}
 
@@ -5499,7 +5520,7 @@ static gboolean read_nwchem_file_frequencies(gchar *FileName)
 		gchar buffer[BSIZE];
 		sprintf(buffer,_("Sorry, I can not read frequencies from '%s' file\n"),FileName);
   		w = Message(buffer,_("Error"),TRUE);
-		gtk_window_set_modal (GTK_WINDOW (w), TRUE);
+		if(w) gtk_window_set_modal (GTK_WINDOW (w), TRUE);
 		return FALSE;
 	}
 
@@ -5649,7 +5670,7 @@ static gboolean read_psicode_file_frequencies(gchar *FileName)
 		gchar buffer[BSIZE];
 		sprintf(buffer,_("Sorry, I can not read frequencies from '%s' file\n"),FileName);
   		w = Message(buffer,_("Error"),TRUE);
-		gtk_window_set_modal (GTK_WINDOW (w), TRUE);
+		if(w) gtk_window_set_modal (GTK_WINDOW (w), TRUE);
 		return FALSE;
 	}
 
@@ -5837,7 +5858,7 @@ static gboolean read_orca_file_frequencies(gchar *FileName)
 
 		sprintf(buffer,_("Sorry, I can not read frequencies from '%s' file\n"),FileName);
   		w = Message(buffer,_("Error"),TRUE);
-		gtk_window_set_modal (GTK_WINDOW (w), TRUE);
+		if(w) gtk_window_set_modal (GTK_WINDOW (w), TRUE);
 		rafreshList();
 		return FALSE;
 	}
@@ -5853,7 +5874,7 @@ static gboolean read_orca_file_frequencies(gchar *FileName)
 				)
 				);
   		w = Message(buffer,_("Warning"),TRUE);
-		gtk_window_set_modal (GTK_WINDOW (w), TRUE);
+		if(w) gtk_window_set_modal (GTK_WINDOW (w), TRUE);
 	}
 	/* in orca output file, the mode are already normalized  as gaussian*/
 	/* normalize_modes();*/
@@ -6210,13 +6231,20 @@ static void filmSelected(GtkWidget *widget)
 /********************************************************************************/
 static void showMessageEnd()
 {
+	/* the last images are written by the export threads */
+	gchar* exportError = wait_images_export();
 	gchar* format =get_format_image_from_option();
 	gchar* message = messageAnimatedImage(format);
 	gchar* t = g_strdup_printf(_("\nA seriess of gab*.%s files was created in \"%s\" directeory.\n\n\n%s") , format, get_last_directory(),message);
 	GtkWidget* winDlg = Message(t,_("Info"),TRUE);
 	g_free(message);
-	gtk_window_set_modal (GTK_WINDOW (winDlg), TRUE);
+	if(winDlg) gtk_window_set_modal (GTK_WINDOW (winDlg), TRUE);
 	g_free(t);
+	if (exportError)
+	{
+		Message(exportError, _("Error"), TRUE);
+		g_free(exportError);
+	}
 }
 /********************************************************************************/
 static void unActivateFilm()
@@ -6507,7 +6535,7 @@ static gboolean createImageFile()
 		createFilm = FALSE;
 		numFileFilm = 0;
     		m = Message(message,_("Error"),TRUE);
-		gtk_window_set_modal (GTK_WINDOW (m), TRUE);
+		if(m) gtk_window_set_modal (GTK_WINDOW (m), TRUE);
 	}
 	g_free(t);
 	return TRUE;
@@ -6628,7 +6656,7 @@ static void help_supported_format()
 		)
 		 );
 	win = Message(temp," Info ",FALSE);
-	gtk_window_set_modal (GTK_WINDOW (win), TRUE);
+	if(win) gtk_window_set_modal (GTK_WINDOW (win), TRUE);
 }
 /***************************************************************************/
 static void help_animated_file()
@@ -6656,7 +6684,7 @@ static void help_animated_file()
 		)
 		 );
 	win = Message(temp," Info ",FALSE);
-	gtk_window_set_modal (GTK_WINDOW (win), TRUE);
+	if(win) gtk_window_set_modal (GTK_WINDOW (win), TRUE);
 	g_free(temp);
 }
 /*********************************************************************************************************************/
@@ -6916,6 +6944,96 @@ static GtkUIManager *create_menu(GtkWidget* box)
 	return manager;
 }
 /********************************************************************************/
+static gboolean is_linear_vibration_geometry()
+{
+	gint i,c;
+	gdouble u[3];
+	gdouble v[3];
+	gdouble w[3];
+	if(vibration.numberOfAtoms<3) return TRUE;
+	for(c=0;c<3;c++) u[c] = vibration.geometry[1].coordinates[c]-vibration.geometry[0].coordinates[c];
+	for(i=2;i<vibration.numberOfAtoms;i++)
+	{
+		for(c=0;c<3;c++) v[c] = vibration.geometry[i].coordinates[c]-vibration.geometry[0].coordinates[c];
+		w[0] = u[1]*v[2]-u[2]*v[1];
+		w[1] = u[2]*v[0]-u[0]*v[2];
+		w[2] = u[0]*v[1]-u[1]*v[0];
+		if(w[0]*w[0]+w[1]*w[1]+w[2]*w[2]>1e-6) return FALSE;
+	}
+	return TRUE;
+}
+/********************************************************************************/
+/* the translations and rotations are the modes with the smallest |frequency| */
+static void remove_translation_rotation_modes()
+{
+	gint nTR = 6;
+	gint n;
+	gint i,k,c;
+	if(vibration.numberOfAtoms<2) nTR = 3;
+	else if(is_linear_vibration_geometry()) nTR = 5;
+	if(vibration.numberOfFrequencies<=nTR) return;
+	for(n=0;n<nTR;n++)
+	{
+		k = 0;
+		for(i=1;i<vibration.numberOfFrequencies;i++)
+			if(fabs(vibration.modes[i].frequence)<fabs(vibration.modes[k].frequence)) k = i;
+		if(vibration.modes[k].symmetry) g_free(vibration.modes[k].symmetry);
+		for(c=0;c<3;c++) if(vibration.modes[k].vectors[c]) g_free(vibration.modes[k].vectors[c]);
+		for(i=k;i<vibration.numberOfFrequencies-1;i++) vibration.modes[i] = vibration.modes[i+1];
+		vibration.numberOfFrequencies--;
+	}
+}
+/********************************************************************************/
+/* coordinates [3*nAtoms] in Bohr, hessian [3*nAtoms][3*nAtoms] in au (destroyed), 
+ * dipoleDerivatives [3*nAtoms][3] in au, can be NULL.
+ * The display window must exist.
+ */
+gboolean set_vibration_from_hessian(gint nAtoms, gchar** symbols, gdouble* coordinates, gdouble** hessian, gdouble** dipoleDerivatives)
+{
+	gint j,k,c;
+
+	if(nAtoms<1 || !symbols || !coordinates || !hessian) return FALSE;
+	stop_vibration(NULL, NULL);
+	init_dipole();
+	free_vibration();
+	vibration.numberOfAtoms = nAtoms;
+	vibration.geometry = g_malloc(nAtoms*sizeof(VibrationAtom));
+	for(j=0;j<nAtoms;j++)
+	{
+		vibration.geometry[j].symbol = g_strdup(symbols[j]);
+		for(c=0;c<3;c++) vibration.geometry[j].coordinates[c] = coordinates[3*j+c];
+		vibration.geometry[j].partialCharge = 0.0;
+		vibration.geometry[j].variable = TRUE;
+		vibration.geometry[j].nuclearCharge = get_atomic_number_from_symbol(symbols[j]);
+	}
+	vibration.modes = g_malloc(nAtoms*3*sizeof(VibrationMode));
+	for(k=0;k<nAtoms*3;k++)
+	{
+		vibration.modes[k].symmetry = g_strdup("UNK");
+		vibration.modes[k].IRIntensity = 0;
+		vibration.modes[k].RamanIntensity = 0;
+		vibration.modes[k].frequence = 0;
+		for(c=0;c<3;c++)
+		{
+			vibration.modes[k].vectors[c]= g_malloc(nAtoms*sizeof(gdouble));
+			for(j=0;j<nAtoms;j++) vibration.modes[k].vectors[c][j] = 0;
+		}
+	}
+	vibration.numberOfFrequencies = nAtoms*3;
+	reset_geom_vibration();
+	RebuildGeomD = TRUE;
+	buildBondsOrb();
+	reset_grid_limits();
+
+	set_modes_from_hessian(nAtoms*3, hessian, dipoleDerivatives);
+	remove_translation_rotation_modes();
+
+	glarea_rafresh(GLArea);
+	if(!WinDlg) vibrationDlg();
+	else rafreshList();
+	return TRUE;
+}
+/********************************************************************************/
 void vibrationDlg()
 {
 	GtkWidget *Win;
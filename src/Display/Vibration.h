@@ -60,6 +60,7 @@ extern Vibration vibration;
 extern gint rowSelected;
 void init_vibration();
 void vibrationDlg();
+gboolean set_vibration_from_hessian(gint nAtoms, gchar** symbols, gdouble* coordinates, gdouble** hessian, gdouble** dipoleDerivatives);
 
 #endif /* __GABEDIT_VIBRATION_H__ */
 
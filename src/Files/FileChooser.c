@@ -36,7 +36,7 @@ GtkWidget* file_chooser(gpointer data,gchar* title,GabEditTypeFile type,GabEditT
   gchar* patternsfiles[] = {	"*",
 			    	"*.inp","*.com","*.mop","*.nw","*.psi",
 	  			"*.log","*.out","*.fchk", "*.aux","*.wfx", "*.gab","*.ici","*.xyz","*.mol2","*.mol","*.tnk","*.pdb","*.hin","*.zmt","*.gzmt",
-	  		    	"*.hf","*.gcube","*.cube","*.CUBE","*.grid","*.M2Msi","*.t41","*.dx","*.trj","*.irc","*.txt","*.xml","*.cif","*",
+	  		    	"*.hf","*.gcube","*.cube","*.CUBE","*.grid","*.M2Msi","*.t41","*.dx","*.ggrid","*.trj","*.irc","*.txt","*.xml","*.cif","*",
 			    	NULL};
   GCallback *func = (GCallback *)data;
   gchar* temp = NULL;
@@ -306,6 +306,10 @@ GtkWidget* file_chooser(gpointer data,gchar* title,GabEditTypeFile type,GabEditT
 					    gabedit_file_chooser_set_filter(GABEDIT_FILE_CHOOSER(gabeditFileChooser),"*.dx");
 					    temp = g_strdup_printf("%s.dx",fileopen.projectname);
 				      	    break;
+	   case GABEDIT_TYPEFILE_GRIDBINARY : 
+					    gabedit_file_chooser_set_filter(GABEDIT_FILE_CHOOSER(gabeditFileChooser),"*.ggrid");
+					    temp = g_strdup_printf("%s.ggrid",fileopen.projectname);
+				      	    break;
 	   case GABEDIT_TYPEFILE_TRJ : 
 					    gabedit_file_chooser_set_filter(GABEDIT_FILE_CHOOSER(gabeditFileChooser),"*.trj");
 					    temp = g_strdup_printf("%s.trj",fileopen.projectname);
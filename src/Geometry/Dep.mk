@@ -40,7 +40,8 @@ GeomXYZ.o: GeomXYZ.c ../../Config.h ../Common/Global.h \
  ../Geometry/GeomXYZ.h ../Geometry/ResultsAnalise.h \
  ../Geometry/OpenBabel.h ../Geometry/SelectionDlg.h \
  ../MolecularMechanics/PDBTemplate.h \
- ../MolecularMechanics/CalculTypesAmber.h
+ ../MolecularMechanics/CalculTypesAmber.h \
+ ../Utils/FChkFile.h
 GeomZmatrix.o: GeomZmatrix.c ../../Config.h ../Common/Global.h \
  ../Common/../Files/GabeditFileChooser.h \
  ../Common/../Common/GabeditType.h ../Utils/Constants.h ../Common/Help.h \
@@ -89,7 +90,9 @@ ResultsAnalise.o: ResultsAnalise.c ../../Config.h ../Common/Global.h \
  ../Common/../Files/GabeditFileChooser.h \
  ../Common/../Common/GabeditType.h ../Utils/UtilsInterface.h \
  ../Utils/Utils.h ../Utils/Constants.h ../Geometry/ResultsAnalise.h \
- ../Geometry/EnergiesCurves.h ../Common/Run.h ../Display/ViewOrb.h
+ ../Geometry/EnergiesCurves.h ../Common/Run.h ../Display/ViewOrb.h \
+ ../Utils/VASPXmlFile.h \
+ ../Utils/LogIndex.h
 GeomSymmetry.o: GeomSymmetry.c ../../Config.h ../Common/Global.h \
  ../Common/../Files/GabeditFileChooser.h \
  ../Common/../Common/GabeditType.h ../Utils/UtilsInterface.h \
@@ -32,6 +32,7 @@ DEALINGS IN THE SOFTWARE.
 #include "../Common/Help.h"
 #include "../Utils/UtilsInterface.h"
 #include "../Utils/Utils.h"
+#include "../Utils/FChkFile.h"
 #include "../Geometry/GeomGlobal.h"
 #include "../Utils/AtomsProp.h"
 #include "../Utils/UtilsVASP.h"
@@ -8386,7 +8387,7 @@ void read_first_gaussian_file(GabeditFileChooser *SelecFile, gint response_id)
 void read_fchk_gaussian_file(GabeditFileChooser *SelecFile , gint response_id)
 {
 	gchar *fileName;
-	FILE *file;
+	FChkFile *file;
 	gint i,j;
 	gint *z = NULL;
 	gdouble* coords = NULL;
@@ -8402,44 +8403,44 @@ void read_fchk_gaussian_file(GabeditFileChooser *SelecFile , gint response_id)
 		MessageGeom(_("Sorry\n No file selected"),_("Error"),TRUE);
     		return ;
 	}
-	file = FOpen(fileName, "rb");
+	file = new_fchk_gaussian_file(fileName);
 	if(file ==NULL)
 	{
   		MessageGeom(_("Sorry\nI can not open this file"),_("Error"),TRUE);
   		return;
 	}
 
-	i = get_one_int_from_fchk_gaussian_file(file,"Multiplicity ");
+	i = get_one_int_from_fchk(file,"Multiplicity ");
 	if(i<1)
 	{
   		MessageGeom(_("Sorry\nI can not the multiplicity from this file"),_("Error"),TRUE);
+		free_fchk_gaussian_file(file);
 		return;
 	}
-	rewind(file);
-	j = get_one_int_from_fchk_gaussian_file(file,"Number of atoms ");
+	j = get_one_int_from_fchk(file,"Number of atoms ");
 	if(j<1)
 	{
   		MessageGeom(_("Sorry\nI can not the number of atoms from this file"),_("Error"),TRUE);
+		free_fchk_gaussian_file(file);
 		return;
 	}
 
 	SpinMultiplicities[0] = i;
-	rewind(file);
-	z = get_array_int_from_fchk_gaussian_file(file, "Atomic numbers ", &n);
+	z = get_array_int_from_fchk(file, "Atomic numbers ", &n);
 	if(n!=j)
 	{
   		MessageGeom(_("Sorry\nI can not read the atomic numbers from this file"),_("Error"),TRUE);
+		free_fchk_gaussian_file(file);
 		return;
 	}
-	rewind(file);
-	coords = get_array_real_from_fchk_gaussian_file(file, "Current cartesian coordinates  ", &n);
+	coords = get_array_real_from_fchk(file, "Current cartesian coordinates  ", &n);
 	if(n!=3*j)
 	{
   		MessageGeom(_("Sorry\nI can not read the current cartesian coordinates from this file"),_("Error"),TRUE);
+		free_fchk_gaussian_file(file);
 		return;
 	}
-	rewind(file);
-	TotalCharges[0] = get_one_int_from_fchk_gaussian_file(file,"Charge ");
+	TotalCharges[0] = get_one_int_from_fchk(file,"Charge ");
 	NcentersXYZ = j;
 
     	GeomXYZ=g_malloc(NcentersXYZ*sizeof(GeomXYZAtomDef));
@@ -8471,8 +8472,7 @@ void read_fchk_gaussian_file(GabeditFileChooser *SelecFile , gint response_id)
 	if(coords) g_free(coords);
 	z = NULL;
 	coords = NULL;
-	rewind(file);
-	charges = get_array_real_from_fchk_gaussian_file(file, "NPA Charges ", &n);
+	charges = get_array_real_from_fchk(file, "NPA Charges ", &n);
 	if(n==NcentersXYZ && charges)
 	{
 		for(j=0;j<NcentersXYZ;j++)
@@ -8481,8 +8481,7 @@ void read_fchk_gaussian_file(GabeditFileChooser *SelecFile , gint response_id)
 	}
 	else
 	{
-		rewind(file);
-		charges = get_array_real_from_fchk_gaussian_file(file, "ESP Charges  ", &n);
+		charges = get_array_real_from_fchk(file, "ESP Charges  ", &n);
 		if(n==NcentersXYZ && charges) 
 		{
 			for(j=0;j<NcentersXYZ;j++)
@@ -8490,8 +8489,7 @@ void read_fchk_gaussian_file(GabeditFileChooser *SelecFile , gint response_id)
 		}
 		else
 		{
-			rewind(file);
-			charges = get_array_real_from_fchk_gaussian_file(file, "Mulliken Charges  ", &n);
+			charges = get_array_real_from_fchk(file, "Mulliken Charges  ", &n);
 			if(n==NcentersXYZ && charges) 
 			{
 				for(j=0;j<NcentersXYZ;j++)
@@ -8500,8 +8498,7 @@ void read_fchk_gaussian_file(GabeditFileChooser *SelecFile , gint response_id)
 			if(charges) g_free(charges);
 		}
 	}
-	rewind(file);
-	dipole = get_array_real_from_fchk_gaussian_file(file, "Dipole Moment  ", &n);
+	dipole = get_array_real_from_fchk(file, "Dipole Moment  ", &n);
 	init_dipole();
 	if(n==3)
 	{
@@ -8510,7 +8507,7 @@ void read_fchk_gaussian_file(GabeditFileChooser *SelecFile , gint response_id)
 
 	}
 	if(dipole) g_free(dipole);
- 	fclose(file);
+ 	free_fchk_gaussian_file(file);
  	calculMMTypes(FALSE);
 	if(GeomIsOpen) append_list();
 	if(GeomDrawingArea != NULL) rafresh_drawing();
@@ -881,6 +881,11 @@ static void activate_action (GtkAction *action)
 		MolecularMechanicsMinimizeDlg();
 		messageAmberTypesDefine();
 	}
+	else if(!strcmp(name, "MolecularMechanicsFrequencies"))
+	{
+		MolecularMechanicsFrequenciesDlg();
+		messageAmberTypesDefine();
+	}
 	else if(!strcmp(name, "MolecularMechanicsDynamics"))
 	{
 		MolecularMechanicsDynamicsDlg();
@@ -895,6 +900,10 @@ static void activate_action (GtkAction *action)
 	{
 		semiEmpiricalMolecularDynamicsDlg();
 	}
+	else if(!strcmp(name, "SemiEmpiricalFrequencies"))
+	{
+		semiEmpiricalFrequenciesDlg();
+	}
 	else if(!strcmp(name, "SemiEmpiricalMDConfo"))
 	{
 		semiEmpiricalMolecularDynamicsConfoDlg();
@@ -1325,6 +1334,7 @@ static GtkActionEntry gtkActionEntries[] =
 	{"MolecularMechanics", NULL, N_("_Amber potential")},
 	{"MolecularMechanicsEnergy", NULL, N_("_Energy"), NULL, "compute the energy using the MM method", G_CALLBACK (activate_action) },
 	{"MolecularMechanicsOptimization", NULL, N_("_Optimization"), NULL, "optimize the geometry using the MM method", G_CALLBACK (activate_action) },
+	{"MolecularMechanicsFrequencies", NULL, N_("_Frequencies (finite differences)"), NULL, "compute the harmonic and anharmonic frequencies using the MM method", G_CALLBACK (activate_action) },
 	{"MolecularMechanicsDynamics", NULL, N_("Molecular _Dynamics"), NULL, "Molecular dynamics using the MM method", G_CALLBACK (activate_action) },
 	{"MolecularMechanicsDynamicsConfo", NULL, N_("Molecular _Dynamics Conformational search"), NULL, "Molecular dynamics conformational search using the MM method", G_CALLBACK (activate_action) },
 
@@ -1364,6 +1374,7 @@ static GtkActionEntry gtkActionEntries[] =
 	{"SemiEmpiricalEnergyGeneric", NULL, N_("Generic _Energy"), NULL, "compute the energy using your own program", G_CALLBACK (activate_action) },
 	{"SemiEmpiricalOptimizationGeneric", NULL, N_("Generic _Optimization"), NULL, "optimize the geometry using your own program", G_CALLBACK (activate_action) },
 
+	{"SemiEmpiricalFrequencies", NULL, N_("_Frequencies (finite differences)"), NULL, "compute the harmonic and anharmonic frequencies using a semi-empirical method", G_CALLBACK (activate_action) },
 	{"SemiEmpiricalMD", NULL, N_("Molecular _Dynamics"), NULL, "Molecular dynamics using a semi-empirical method", G_CALLBACK (activate_action) },
 	{"SemiEmpiricalMDConfo", NULL, N_("Molecular _Dynamics Conformational search"), NULL, "Molecular dynamics conformational search using a semi-empirical  method", G_CALLBACK (activate_action) },
 
@@ -1820,6 +1831,7 @@ static const gchar *uiMenuInfo =
 "    <menu name=\"MolecularMechanics\" action=\"MolecularMechanics\">\n"
 "      <menuitem name=\"MolecularMechanicsEnergy\" action=\"MolecularMechanicsEnergy\" />\n"
 "      <menuitem name=\"MolecularMechanicsOptimization\" action=\"MolecularMechanicsOptimization\" />\n"
+"      <menuitem name=\"MolecularMechanicsFrequencies\" action=\"MolecularMechanicsFrequencies\" />\n"
 "      <menuitem name=\"MolecularMechanicsDynamics\" action=\"MolecularMechanicsDynamics\" />\n"
 "      <menuitem name=\"MolecularMechanicsDynamicsConfo\" action=\"MolecularMechanicsDynamicsConfo\" />\n"
 "    </menu>\n"
@@ -1848,6 +1860,8 @@ static const gchar *uiMenuInfo =
 "      <menuitem name=\"SemiEmpiricalEnergyGeneric\" action=\"SemiEmpiricalEnergyGeneric\" />\n"
 "      <menuitem name=\"SemiEmpiricalOptimizationGeneric\" action=\"SemiEmpiricalOptimizationGeneric\" />\n"
 
+"      <separator name=\"sepSemiEmpiricalFrequencies\" />\n"
+"      <menuitem name=\"SemiEmpiricalFrequencies\" action=\"SemiEmpiricalFrequencies\" />\n"
 "      <separator name=\"sepSemiEmpiricalMD\" />\n"
 "      <menuitem name=\"SemiEmpiricalMD\" action=\"SemiEmpiricalMD\" />\n"
 "      <menuitem name=\"SemiEmpiricalMDConfo\" action=\"SemiEmpiricalMDConfo\" />\n"
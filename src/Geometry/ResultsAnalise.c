@@ -27,6 +27,8 @@ DEALINGS IN THE SOFTWARE.
 #include "../Geometry/EnergiesCurves.h"
 #include "../Common/Run.h"
 #include "../Display/ViewOrb.h"
+#include "../Utils/VASPXmlFile.h"
+#include "../Utils/LogIndex.h"
 
 /*********************************************************************/
 DataGeomConv free_geom_conv(DataGeomConv GeomConv)
@@ -1351,9 +1353,12 @@ void find_energy_gauss_standard_output(gchar* NomFichier)
 	gchar *temp =  g_malloc(50*sizeof(gchar));	
 	guint taille=BSIZE;
 	gchar *t;
-	FILE *fd;
+	LogIndex* index = NULL;
+	gsize pos = 0;
+	gint h;
         gint Ncalculs = 0;
   	static DataGeomConv* GeomConv =NULL;
+	static const gchar* patterns[] = {"Normal termination of Gaussian", "#", "SCF DONE", "ENERGY=", "CONVERGED?", NULL};
 
         
         Ncalculs++;
@@ -1367,8 +1372,8 @@ void find_energy_gauss_standard_output(gchar* NomFichier)
   	GeomConv[Ncalculs-1] = init_geom_gauss_conv(NomFichier);
 
 	t=g_malloc(taille);
- 	fd = FOpen(NomFichier, "rb"); 
-        if(!fd)
+	index = new_log_index(NomFichier, patterns, TRUE);
+        if(!index)
 	{
 		t = g_strdup_printf(_(" Error : I can not open file %s\n"),NomFichier);
 		Message(t,_("Error"),TRUE);
@@ -1377,9 +1382,12 @@ void find_energy_gauss_standard_output(gchar* NomFichier)
 		return;
 	}
         
-	 while(!feof(fd))
+	/* only the lines containing one of the patterns are read */
+	for(h=0;h<index->nLines;h++)
 	{
-    		 { gchar* e = fgets(t,taille,fd);}
+		if(index->lines[h]<pos) continue;
+		pos = index->lines[h];
+		get_line_from_log_index(index, &pos, t, taille);
                  if( strlen(t)>2 && strstr(t,"Normal termination of Gaussian") )
 		 {
          		Ncalculs++;
@@ -1438,13 +1446,13 @@ void find_energy_gauss_standard_output(gchar* NomFichier)
 		 {
 			for(i=1;(gint)i<GeomConv[Ncalculs-1].Ntype;i++)
 			{
-    		 		{ gchar* e = fgets(t,taille,fd);}
+				get_line_from_log_index(index, &pos, t, taille);
                  		sscanf(t,"%s %s %s", temp,temp,GeomConv[Ncalculs-1].Data[i][GeomConv[Ncalculs-1].Npoint-1]);
 			}
 		 }
 	}
 
-    fclose(fd);
+    free_log_index(index);
    
     if( Ncalculs>0 && GeomConv[Ncalculs-1].Npoint == 0)
     {
@@ -1537,15 +1545,18 @@ void find_energy_orca_output(gchar* NomFichier)
 	gchar *temp =  g_malloc(50*sizeof(gchar));	
 	guint taille=BSIZE;
 	gchar *t;
-	FILE *fd;
+	LogIndex* index = NULL;
+	gsize pos = 0;
+	gint h;
         gint Ncalculs = 0;
   	static DataGeomConv* GeomConv =NULL;
 	gboolean Ok = FALSE;
+	static const gchar* patterns[] = {"ORCA OPTIMIZATION COORDINATE SETUP", "GEOMETRY OPTIMIZATION CYCLE", "FINAL SINGLE POINT ENERGY", "RMS gradient", NULL};
 
         
 	t=g_malloc(taille*sizeof(gchar));
- 	fd = FOpen(NomFichier, "rb"); 
-        if(!fd)
+	index = new_log_index(NomFichier, patterns, FALSE);
+        if(!index)
 	{
 		t = g_strdup_printf(_(" Error : I can not open file %s\n"),NomFichier);
 		Message(t,_("Error"),TRUE);
@@ -1553,9 +1564,11 @@ void find_energy_orca_output(gchar* NomFichier)
 		return;
 	}
         
-	 while(!feof(fd))
+	for(h=0;h<index->nLines;h++)
 	{
-    		 { gchar* e = fgets(t,taille,fd);}
+		if(index->lines[h]<pos) continue;
+		pos = index->lines[h];
+		get_line_from_log_index(index, &pos, t, taille);
                  if(strstr(t,"ORCA OPTIMIZATION COORDINATE SETUP") )
 		 {
          		Ncalculs++;
@@ -1588,42 +1601,24 @@ void find_energy_orca_output(gchar* NomFichier)
                  	GeomConv[Ncalculs-1].Data[i][GeomConv[Ncalculs-1].Npoint-1][0] = '\0';
                   }
 
-		  Ok = TRUE;
-                 while(!feof(fd) && Ok )
-		 {
-		 	if(!fgets(t,taille,fd))
-			{
-				Ok = FALSE;
-				break;
-			}
-			else
-			{
-				if(strstr(t,"FINAL SINGLE POINT ENERGY"))
-				{
-					Ok = TRUE;
-					break;
-				}
-
-			}
-		 }
+		 Ok = find_pattern_in_log_index(index, 2, &pos);
 		 if(!Ok) break;
+		 get_line_from_log_index(index, &pos, t, taille);
                  sscanf(t,"%s %s %s %s %s",temp,temp,temp,temp,GeomConv[Ncalculs-1].Data[0][GeomConv[Ncalculs-1].Npoint-1]);
 		 uppercase(t);
 		 GeomConv[Ncalculs-1].TypeCalcul = g_strdup(" ");
-                 do
-                 {
-		 	if(!fgets(t,taille,fd))break;
-                 }while(strstr(t,"RMS gradient")==NULL && !feof(fd) ) ;
-                 if(strstr(t,"RMS gradient")!=NULL)
+                 if(find_pattern_in_log_index(index, 3, &pos))
 		 {
+		 	get_line_from_log_index(index, &pos, t, taille);
                  	sscanf(t,"%s %s %s %s", temp,temp,temp,GeomConv[Ncalculs-1].Data[1][GeomConv[Ncalculs-1].Npoint-1]);
-		 	if(!fgets(t,taille,fd))break;
+		 	if(!get_line_from_log_index(index, &pos, t, taille))break;
                  	sscanf(t,"%s %s %s %s", temp,temp,temp,GeomConv[Ncalculs-1].Data[2][GeomConv[Ncalculs-1].Npoint-1]);
 		 }
+		 else pos = index->length;
 		}
 	}
 
-    fclose(fd);
+    free_log_index(index);
    
     if(!Ok && GeomConv && GeomConv[Ncalculs-1].Npoint>0) GeomConv[Ncalculs-1].Npoint--;
     if( Ncalculs>0 && GeomConv[Ncalculs-1].Npoint == 0)
@@ -1817,134 +1812,41 @@ DataGeomConv init_geom_vasp_xml_conv(gchar* namefile)
 /*********************************************************************/
 void find_energy_vasp_xml(gchar* NomFichier)
 {
-	gchar *pdest;
 	guint  i=0;
-	guint  j=0;
-	guint  k=0;
-	gchar* tag = "<structure>";
 	gchar *t;
-	FILE *fd;
         gint Ncalculs = 0;
   	static DataGeomConv* GeomConv =NULL;
-	gboolean Ok = FALSE;
-	gint nf = 0;
-	gdouble x,y,z;
-	gdouble X,Y,Z;
-	gdouble energy;
-	gchar* pos;
+	VASPXmlFile* vasp = NULL;
 
-        
-	t=g_malloc(BSIZE*sizeof(gchar));
- 	fd = FOpen(NomFichier, "rb"); 
-        if(!fd)
+	vasp = new_vasp_xml_file(NomFichier, FALSE);
+        if(!vasp)
 	{
 		t = g_strdup_printf(_(" Error : I can not open file %s\n"),NomFichier);
 		Message(t,_("Error"),TRUE);
 		if(t) g_free(t);
 		return;
 	}
-	 while(!feof(fd))
-	{
-    		 { gchar* e = fgets(t,BSIZE,fd);}
-                 if(strstr(t,tag) )
-		 {
-         		Ncalculs++;
-                        if(Ncalculs == 1) GeomConv =  g_malloc(sizeof(DataGeomConv) );
-			else GeomConv =  g_realloc(GeomConv, Ncalculs*sizeof(DataGeomConv) );
-  			GeomConv[Ncalculs-1] = init_geom_vasp_xml_conv(NomFichier);
-			break;
-		 }
-	}
-	rewind(fd);
-        
-	 while(!feof(fd))
-	{
-    		{ gchar* e = fgets(t,BSIZE,fd);}
-    		pdest = strstr( t,tag);
-   		if( pdest != NULL  && Ncalculs>0)
-		{
-			Ok = TRUE;
-		  	GeomConv[Ncalculs-1].Npoint++;
-		  	if(GeomConv[Ncalculs-1].Npoint == 1 )
-		  	{
-				GeomConv[Ncalculs-1].NumGeom =  g_malloc(GeomConv[Ncalculs-1].Npoint*sizeof(gint));	
-				for(i=0;(gint)i<GeomConv[Ncalculs-1].Ntype;i++) GeomConv[Ncalculs-1].Data[i] =  g_malloc(GeomConv[Ncalculs-1].Npoint*sizeof(gchar*));	
-		  	}
-		  	else
-		  	{
-				GeomConv[Ncalculs-1].NumGeom =  g_realloc(GeomConv[Ncalculs-1].NumGeom,GeomConv[Ncalculs-1].Npoint*sizeof(gint));	
-				for(i=0;(gint)i<GeomConv[Ncalculs-1].Ntype;i++) GeomConv[Ncalculs-1].Data[i] =  g_realloc(GeomConv[Ncalculs-1].Data[i],GeomConv[Ncalculs-1].Npoint*sizeof(gchar*));
-		  	}
-		  	for(i=0;(gint)i<GeomConv[Ncalculs-1].Ntype;i++)
-                  	{
-		 		GeomConv[Ncalculs-1].Data[i][GeomConv[Ncalculs-1].Npoint-1] = g_malloc(50*sizeof(gchar)); 
-                 		GeomConv[Ncalculs-1].Data[i][GeomConv[Ncalculs-1].Npoint-1][0] = '\0';
-                  	}
-                 	while(!feof(fd))
-		 	{
-		 		if(!fgets(t,BSIZE,fd)) { Ok = FALSE; break; }
-                 		if(strstr(t,"varray name") && strstr(t,"forces")) break;
-			}
-			if(!Ok) break;
-			nf = 0;
-			X = Y = Z = 0;
-                 	while(!feof(fd))
-		 	{
-		 		if(!fgets(t,BSIZE,fd)) { Ok = FALSE; break; }
-                 		if(strstr(t,"varray")) break;
-				pos = strstr(t,">");
-				if(!pos) break;
-				if(3!=sscanf(pos+1,"%lf %lf %lf",&x,&y,&z)) { Ok = FALSE; break;}
-				X += x*x; Y += y*y; Z += z*z;
-				nf++;
-			}
-			if(!Ok) break;
-			if(nf<1) { Ok = FALSE; break;}
-			X = sqrt(X/nf);
-			Y = sqrt(Y/nf);
-			Z = sqrt(Z/nf);
-
-                 	while(!feof(fd))
-		 	{
-		 		if(!fgets(t,BSIZE,fd)) { Ok = FALSE; break; }
-                 		if(strstr(t,"/energy")) { Ok = FALSE; break;}
-                 		if(strstr(t,"e_fr_energy")) break;
-			}
-			if(!Ok) break;
-                	if(!strstr(t,"e_fr_energy")) { Ok = FALSE; break;}
-			pos = strstr(t,">");
-			if(!pos) { Ok = FALSE; break;}
-			if(1!=sscanf(pos+1,"%lf",&energy)) { Ok = FALSE; break;}
-			/* printf("energy = %f X = %f Y = %f Z = %f\n",energy,X,Y,Z);*/
-			GeomConv[Ncalculs-1].Data[0][GeomConv[Ncalculs-1].Npoint-1] = g_strdup_printf("%0.8f",energy);
-			GeomConv[Ncalculs-1].Data[1][GeomConv[Ncalculs-1].Npoint-1] = g_strdup_printf("%0.6f",X);
-			GeomConv[Ncalculs-1].Data[2][GeomConv[Ncalculs-1].Npoint-1] = g_strdup_printf("%0.6f",Y);
-			GeomConv[Ncalculs-1].Data[3][GeomConv[Ncalculs-1].Npoint-1] = g_strdup_printf("%0.6f",Z);
-		}
-	}
-	fclose(fd);
-   
-	if(!Ok && GeomConv && GeomConv[Ncalculs-1].Npoint>0) GeomConv[Ncalculs-1].Npoint--;
-	if( Ncalculs>0 && GeomConv[Ncalculs-1].Npoint == 0)
+	GeomConv =  NULL;
+	if(vasp->nEnergies>0)
 	{
-		GeomConv[Ncalculs-1] =  free_geom_conv(GeomConv[Ncalculs-1]);
-		Ncalculs--;
-		if(Ncalculs>0) GeomConv =  g_realloc(GeomConv, Ncalculs*sizeof(DataGeomConv) );
-		else
+		gint j;
+		Ncalculs = 1;
+		GeomConv =  g_malloc(sizeof(DataGeomConv) );
+  		GeomConv[0] = init_geom_vasp_xml_conv(NomFichier);
+		GeomConv[0].Npoint = vasp->nEnergies;
+		GeomConv[0].NumGeom =  g_malloc(GeomConv[0].Npoint*sizeof(gint));	
+		for(i=0;(gint)i<GeomConv[0].Ntype;i++) GeomConv[0].Data[i] =  g_malloc(GeomConv[0].Npoint*sizeof(gchar*));	
+		for(j=0;j<GeomConv[0].Npoint;j++)
 		{
-			g_free(GeomConv);
-			GeomConv =  NULL;
+			GeomConv[0].Data[0][j] = g_strdup_printf("%0.8f",vasp->energies[j]);
+			GeomConv[0].Data[1][j] = g_strdup_printf("%0.6f",vasp->forcesRMS[3*j]);
+			GeomConv[0].Data[2][j] = g_strdup_printf("%0.6f",vasp->forcesRMS[3*j+1]);
+			GeomConv[0].Data[3][j] = g_strdup_printf("%0.6f",vasp->forcesRMS[3*j+2]);
+			GeomConv[0].NumGeom[j] = j+1;
 		}
 	}
-	k = 0;
-	for(i=0;(gint)i<Ncalculs;i++)
-   	for(j=0;(gint)j<GeomConv[i].Npoint;j++)
-	{
-		k++;
-		GeomConv[i].NumGeom[j] = k;
-	}
+	free_vasp_xml_file(vasp);
 	create_energies_curves(GeomConv, Ncalculs);
-	g_free(t);
 }
 /*************************************************************************************/
 static DataGeomConv init_geom_molden_gabedit_conv(gchar *fileName, GabEditTypeFile type)
@@ -1979,15 +1881,18 @@ void find_energy_molpro_log(gchar* NomFichier)
 	gchar *temp =  g_malloc(50*sizeof(gchar));	
 	guint taille=BSIZE;
 	gchar *t;
-	FILE *fd;
+	LogIndex* index = NULL;
+	gsize pos = 0;
+	gint h;
         gint Ncalculs = 0;
   	static DataGeomConv* GeomConv =NULL;
 	gboolean Ok;
+	static const gchar* patterns[] = {"GEOMETRY OPTIMIZATION STEP  1", "Optimization point", "Convergence:", NULL};
 
         
 	t=g_malloc(taille);
- 	fd = FOpen(NomFichier, "rb"); 
-        if(!fd)
+	index = new_log_index(NomFichier, patterns, FALSE);
+        if(!index)
 	{
 		t = g_strdup_printf(_(" Error : I can not open file %s\n"),NomFichier);
 		Message(t,_("Error"),TRUE);
@@ -1996,9 +1901,11 @@ void find_energy_molpro_log(gchar* NomFichier)
 		return;
 	}
         
-	 while(!feof(fd))
+	for(h=0;h<index->nLines;h++)
 	{
-    		 { gchar* e = fgets(t,taille,fd);}
+		if(index->lines[h]<pos) continue;
+		pos = index->lines[h];
+		get_line_from_log_index(index, &pos, t, taille);
                  if( strlen(t)>2 && strstr(t,"GEOMETRY OPTIMIZATION STEP  1") )
 		 {
          		Ncalculs++;
@@ -2041,23 +1948,14 @@ void find_energy_molpro_log(gchar* NomFichier)
                  	GeomConv[Ncalculs-1].Data[i][GeomConv[Ncalculs-1].Npoint-1][0] = '\0';
                  }
 
-		 Ok = TRUE;
-                 while(!feof(fd) && Ok )
+		 Ok = FALSE;
+		 while(get_line_from_log_index(index, &pos, t, taille))
 		 {
-		 	if(!fgets(t,taille,fd))
+			if(strstr(t,"(") && strstr(t,")"))
 			{
-				Ok = FALSE;
+				Ok = TRUE;
 				break;
 			}
-			else
-			{
-				if(strstr(t,"(") && strstr(t,")"))
-				{
-					Ok = TRUE;
-					break;
-				}
-
-			}
 		 }
 		 if(!Ok) break;
                  sscanf(t,"%s %s %s %s %s",temp,temp,temp,temp,GeomConv[Ncalculs-1].Data[0][GeomConv[Ncalculs-1].Npoint-1]);
@@ -2072,17 +1970,17 @@ void find_energy_molpro_log(gchar* NomFichier)
 				GeomConv[Ncalculs-1].TypeCalcul[i] = ' ';
 		 }
 
-                 do
+                 if(find_pattern_in_log_index(index, 2, &pos))
                  {
-    		 { gchar* e = fgets(t,taille,fd);}
-                 }while(strstr(t,"Convergence:")==NULL && !feof(fd) ) ;
-                 if(strstr(t,"Convergence:")!=NULL)
+			get_line_from_log_index(index, &pos, t, taille);
                  	sscanf(t,"%s %s %s %s %s ", temp,temp,temp,temp,GeomConv[Ncalculs-1].Data[1][GeomConv[Ncalculs-1].Npoint-1]);
+                 }
+                 else pos = index->length;
 		}
 			
 	}
 
-    fclose(fd);
+    free_log_index(index);
    
     if( Ncalculs>0 && GeomConv[Ncalculs-1].Npoint == 0)
     {
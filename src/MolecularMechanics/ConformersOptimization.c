@@ -0,0 +1,298 @@
+/* ConformersOptimization.c */
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#include "../../Config.h"
+#include <stdlib.h>
+#include <math.h>
+#ifdef ENABLE_OMP
+#include <omp.h>
+#endif
+
+#include "../Common/Global.h"
+#include "../Utils/AtomsProp.h"
+#include "../Utils/Jacobi.h"
+#include "../Geometry/Fragments.h"
+#include "../Geometry/DrawGeom.h"
+#include "Atom.h"
+#include "Molecule.h"
+#include "ForceField.h"
+#include "ConjugateGradient.h"
+#include "SteepestDescent.h"
+#include "QuasiNewton.h"
+#include "ConformersOptimization.h"
+
+/* Each selected conformer is an independent ForceField copy, they are minimized concurrently.
+ * Only the master thread talks to GTK, the workers report through numberOfDone.
+ */
+typedef struct _ConformerEntry
+{
+	gdouble energy;
+	ForceField* geometry;
+}ConformerEntry;
+/**********************************************************************/
+void	initConformersOptimization(ConformersOptimization* confoOptimization)
+{
+	confoOptimization->optimizer = CONFOCONJUGATE;
+
+	confoOptimization->conjugateGradientOptions.gradientNorm = 1e-3;
+	confoOptimization->conjugateGradientOptions.maxIterations = 100;
+	confoOptimization->conjugateGradientOptions.updateFrequency = 1;
+	confoOptimization->conjugateGradientOptions.maxLines = 25;
+	confoOptimization->conjugateGradientOptions.initialStep = 0.001;
+	confoOptimization->conjugateGradientOptions.method = 1;
+
+	confoOptimization->quasiNewton.forceField = NULL;
+	confoOptimization->quasiNewton.updateFrequency = 1;
+	confoOptimization->quasiNewton.maxIterations = 100;
+	confoOptimization->quasiNewton.maxLines = 25;
+	confoOptimization->quasiNewton.epsilon = 1e-3;
+	confoOptimization->quasiNewton.tolerence = 1e-16;
+
+	confoOptimization->numberOfThreads = 0;
+	confoOptimization->numberOfDone = 0;
+}
+/**********************************************************************/
+static gdouble optimizeOneConformer(ConformersOptimization* confoOptimization, ForceField* forceField)
+{
+	if(confoOptimization->optimizer == CONFOCONJUGATE)
+	{
+		ConjugateGradient conjugateGradient;
+		runConjugateGradient(&conjugateGradient, forceField, confoOptimization->conjugateGradientOptions);
+		freeConjugateGradient(&conjugateGradient);
+	}
+	else if(confoOptimization->optimizer == CONFOQUASINEWTON)
+	{
+		QuasiNewton quasiNewton = confoOptimization->quasiNewton;
+		quasiNewton.forceField = forceField;
+		runQuasiNewton(&quasiNewton);
+		freeQuasiNewton(&quasiNewton);
+	}
+	else
+	{
+		SteepestDescent steepestDescent;
+		ConjugateGradientOptions* options = &confoOptimization->conjugateGradientOptions;
+		runSteepestDescent(&steepestDescent, forceField,
+			options->updateFrequency, options->maxIterations,
+			options->gradientNorm, options->maxLines);
+		freeSteepestDescent(&steepestDescent);
+	}
+	return forceField->klass->calculateEnergyTmp(forceField, &forceField->molecule);
+}
+/**********************************************************************/
+static void showConformersProgress(ConformersOptimization* confoOptimization, gint numberOfGeometries)
+{
+	gchar* str = g_strdup_printf(_("Minimization of geometries : %d/%d done"),
+			confoOptimization->numberOfDone, numberOfGeometries);
+	set_text_to_draw(str);
+	drawGeom();
+	while( gtk_events_pending() ) gtk_main_iteration();
+	g_free(str);
+}
+/**********************************************************************/
+void	runConformersOptimization(ConformersOptimization* confoOptimization, gint numberOfGeometries, ForceField** geometries, gdouble* energies)
+{
+	gint i;
+#ifdef ENABLE_OMP
+	gint nThreads = confoOptimization->numberOfThreads;
+	if(nThreads<1) nThreads = omp_get_max_threads();
+	if(nThreads>numberOfGeometries) nThreads = numberOfGeometries;
+	if(nThreads<1) nThreads = 1;
+#endif
+
+	if(!geometries || !energies || numberOfGeometries<1) return;
+	for(i=0;i<numberOfGeometries;i++) energies[i] = 1e30;
+	confoOptimization->numberOfDone = 0;
+	showConformersProgress(confoOptimization, numberOfGeometries);
+
+#ifdef ENABLE_OMP
+#pragma omp parallel for schedule(dynamic,1) num_threads(nThreads)
+#endif
+	for(i=0;i<numberOfGeometries;i++)
+	{
+		if(StopCalcul) continue;
+		if(!geometries[i]) continue;
+		energies[i] = optimizeOneConformer(confoOptimization, geometries[i]);
+#ifdef ENABLE_OMP
+#pragma omp atomic
+#endif
+		confoOptimization->numberOfDone++;
+#ifdef ENABLE_OMP
+#ifndef G_OS_WIN32
+		/* the GUI is updated only by the master (calling) thread */
+		if(omp_get_thread_num()==0) showConformersProgress(confoOptimization, numberOfGeometries);
+#endif
+#else
+		showConformersProgress(confoOptimization, numberOfGeometries);
+#endif
+	}
+	set_text_to_draw(" ");
+}
+/**********************************************************************/
+static gint compare2conformers(const void* av, const void* bv)
+{
+	const ConformerEntry* a = (const ConformerEntry*)av;
+	const ConformerEntry* b = (const ConformerEntry*)bv;
+	if(a->energy<b->energy) return -1;
+	if(a->energy>b->energy) return 1;
+	return 0;
+}
+/**********************************************************************/
+void	sortConformers(gint numberOfGeometries, ForceField** geometries, gdouble* energies)
+{
+	gint i;
+	ConformerEntry* entries = NULL;
+	if(!geometries || !energies || numberOfGeometries<2) return;
+	entries = g_malloc(numberOfGeometries*sizeof(ConformerEntry));
+	for(i=0;i<numberOfGeometries;i++)
+	{
+		entries[i].energy = energies[i];
+		entries[i].geometry = geometries[i];
+	}
+	qsort(entries,numberOfGeometries,sizeof(ConformerEntry),compare2conformers);
+	for(i=0;i<numberOfGeometries;i++)
+	{
+		energies[i] = entries[i].energy;
+		geometries[i] = entries[i].geometry;
+	}
+	g_free(entries);
+}
+/**********************************************************************/
+/* RMSD after optimal superposition, quaternion method (largest eigenvalue of the 4x4 key matrix) */
+gdouble	getConformersRMSD(ForceField* forceFieldA, ForceField* forceFieldB)
+{
+	Molecule* a = &forceFieldA->molecule;
+	Molecule* b = &forceFieldB->molecule;
+	gint n = a->nAtoms;
+	gint i,k,l;
+	gdouble cA[3] = {0,0,0};
+	gdouble cB[3] = {0,0,0};
+	gdouble R[3][3];
+	gdouble GA = 0, GB = 0;
+	gdouble K[10];
+	gdouble d[4];
+	gdouble vv[4][4];
+	gdouble* v[4] = {vv[0],vv[1],vv[2],vv[3]};
+	gint nrot = 0;
+	gdouble msd;
+
+	if(n<1 || n!=b->nAtoms) return -1;
+	for(i=0;i<n;i++)
+	for(k=0;k<3;k++)
+	{
+		cA[k] += a->atoms[i].coordinates[k];
+		cB[k] += b->atoms[i].coordinates[k];
+	}
+	for(k=0;k<3;k++) { cA[k] /= n; cB[k] /= n; }
+	for(k=0;k<3;k++) for(l=0;l<3;l++) R[k][l] = 0;
+	for(i=0;i<n;i++)
+	{
+		gdouble xa[3];
+		gdouble xb[3];
+		for(k=0;k<3;k++)
+		{
+			xa[k] = a->atoms[i].coordinates[k]-cA[k];
+			xb[k] = b->atoms[i].coordinates[k]-cB[k];
+			GA += xa[k]*xa[k];
+			GB += xb[k]*xb[k];
+		}
+		for(k=0;k<3;k++) for(l=0;l<3;l++) R[k][l] += xa[k]*xb[l];
+	}
+	/* upper triangle of the key matrix, row by row, as expected by jacobi */
+	K[0] = R[0][0]+R[1][1]+R[2][2];
+	K[1] = R[1][2]-R[2][1];
+	K[2] = R[2][0]-R[0][2];
+	K[3] = R[0][1]-R[1][0];
+	K[4] = R[0][0]-R[1][1]-R[2][2];
+	K[5] = R[0][1]+R[1][0];
+	K[6] = R[2][0]+R[0][2];
+	K[7] = -R[0][0]+R[1][1]-R[2][2];
+	K[8] = R[1][2]+R[2][1];
+	K[9] = -R[0][0]-R[1][1]+R[2][2];
+	jacobi(K, 4, d, v, &nrot);
+	msd = (GA+GB-2*d[3])/n;
+	if(msd<0) msd = 0;
+	return sqrt(msd);
+}
+/**********************************************************************/
+/* geometries must be sorted by energies (sortConformers) :
+ * for a given conformer, only the following ones closer than tolEnergy are compared.
+ */
+void	removeIdenticalConformers(gint* nG, ForceField*** geoms, gdouble** eners, gdouble tolEnergy, gdouble tolRMSD)
+{
+	gint i;
+	gint j;
+	gint numberOfGeometries = *nG;
+	ForceField** geometries = *geoms;
+	gdouble* energies = *eners;
+	gboolean* removeds = NULL;
+	gint newN = 0;
+
+	if(numberOfGeometries<2) return;
+	if(tolEnergy<=0 && tolRMSD<=0) return;
+	if(!geometries || !energies) return;
+
+	removeds = g_malloc(numberOfGeometries*sizeof(gboolean));
+	for(i=0;i<numberOfGeometries;i++) removeds[i] = (geometries[i]==NULL);
+
+	for(i=0;i<numberOfGeometries-1;i++)
+	{
+		if(removeds[i]) continue;
+		for(j=i+1;j<numberOfGeometries;j++)
+		{
+			if(tolEnergy>0 && energies[j]-energies[i]>=tolEnergy) break;
+			if(removeds[j]) continue;
+			if(tolRMSD>0)
+			{
+				gdouble rmsd = getConformersRMSD(geometries[i], geometries[j]);
+				if(rmsd<0 || rmsd>=tolRMSD) continue;
+			}
+			/* j is a duplicate of a lower conformer */
+			removeds[j] = TRUE;
+		}
+	}
+	for(i=0;i<numberOfGeometries;i++)
+	{
+		if(removeds[i])
+		{
+			if(geometries[i])
+			{
+				freeForceField(geometries[i]);
+				g_free(geometries[i]);
+			}
+			continue;
+		}
+		geometries[newN] = geometries[i];
+		energies[newN] = energies[i];
+		newN++;
+	}
+	g_free(removeds);
+	if(newN==numberOfGeometries) return;
+	if(newN==0)
+	{
+		g_free(geometries);
+		g_free(energies);
+		*geoms = NULL;
+		*eners = NULL;
+		*nG = 0;
+		return;
+	}
+	*nG = newN;
+	*eners = g_realloc(energies,newN*sizeof(gdouble));
+	*geoms = g_realloc(geometries,newN*sizeof(ForceField*));
+}
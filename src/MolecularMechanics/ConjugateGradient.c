@@ -31,6 +31,9 @@ DEALINGS IN THE SOFTWARE.
 
 
 static gdouble maxarg1,maxarg2;
+#ifdef ENABLE_OMP
+#pragma omp threadprivate(maxarg1,maxarg2)
+#endif
 #define FMAX(a,b) (maxarg1=(a),maxarg2=(b),(maxarg1) > (maxarg2) ?\
         (maxarg1) : (maxarg2))
 
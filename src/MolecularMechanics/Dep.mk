@@ -55,7 +55,8 @@ MolecularMechanicsDlg.o: MolecularMechanicsDlg.c ../../Config.h \
  ../MolecularMechanics/ConjugateGradient.h \
  ../MolecularMechanics/SteepestDescent.h \
  ../MolecularMechanics/QuasiNewton.h \
- ../MolecularMechanics/MolecularDynamics.h
+ ../MolecularMechanics/MolecularDynamics.h \
+ FiniteDifferences.h
 CreateMolecularMechanicsFile.o: CreateMolecularMechanicsFile.c \
  ../../Config.h ../Common/Global.h \
  ../Common/../Files/GabeditFileChooser.h \
@@ -121,3 +122,17 @@ MolecularDynamics.o: MolecularDynamics.c ../../Config.h \
  ../Geometry/Fragments.h ../Geometry/DrawGeom.h \
  ../Geometry/DrawGeomCairo.h ../Geometry/Fragments.h ../Utils/Utils.h \
  Atom.h Molecule.h ForceField.h MolecularDynamics.h
+ConformersOptimization.o: ConformersOptimization.c ../../Config.h \
+ ../Common/Global.h ../Common/../Files/GabeditFileChooser.h \
+ ../Common/../Common/GabeditType.h ../Utils/AtomsProp.h ../Utils/Jacobi.h \
+ ../Geometry/Fragments.h ../Geometry/DrawGeom.h \
+ ../Geometry/DrawGeomCairo.h ../Geometry/Fragments.h Atom.h Molecule.h \
+ ForceField.h ConjugateGradient.h SteepestDescent.h QuasiNewton.h \
+ ConformersOptimization.h
+FiniteDifferences.o: FiniteDifferences.c ../../Config.h ../Common/Global.h \
+ ../Common/../Files/GabeditFileChooser.h \
+ ../Common/../Common/GabeditType.h ../Utils/AtomsProp.h \
+ ../Utils/Constants.h ../Geometry/Fragments.h ../Geometry/DrawGeom.h \
+ ../Geometry/DrawGeomCairo.h ../Display/ViewOrb.h ../Display/Vibration.h \
+ ../QFF/Gabedit2MRQFF.h Atom.h Molecule.h ForceField.h \
+ FiniteDifferences.h
@@ -0,0 +1,558 @@
+/* FiniteDifferences.c */
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#include "../../Config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#ifdef ENABLE_OMP
+#include <omp.h>
+#endif
+
+#include "../Common/Global.h"
+#include "../Utils/AtomsProp.h"
+#include "../Utils/Constants.h"
+#include "../Geometry/Fragments.h"
+#include "../Geometry/DrawGeom.h"
+#include "../Display/ViewOrb.h"
+#include "../Display/Vibration.h"
+#include "../QFF/Gabedit2MRQFF.h"
+#include "Atom.h"
+#include "Molecule.h"
+#include "ForceField.h"
+#include "FiniteDifferences.h"
+
+/* Hessian from central differences of the gradients (6N gradients) and 2MR-QFF from the energies 
+ * along the normal modes. The displaced geometries are independent, they are evaluated concurrently,
+ * one copy of the model per thread. Only the master thread talks to GTK.
+ */
+typedef struct _QFFPoint
+{
+	gint i;
+	gint j;
+	gdouble ci;
+	gdouble cj;
+}QFFPoint;
+/**********************************************************************/
+void	initFiniteDifferencesOptions(FiniteDifferencesOptions* options)
+{
+	options->step = 0.005;
+	options->qff = FALSE;
+	options->qffDiagonal = FALSE;
+	options->qffStep = 0.4;
+	options->numberOfThreads = 0;
+}
+/**********************************************************************/
+FiniteDifferences newFiniteDifferences(gint nAtoms, gpointer model, FiniteDifferencesCopyModel copyModel, FiniteDifferencesFreeModel freeModel, FiniteDifferencesComputeModel computeModel, FiniteDifferencesOptions options)
+{
+	FiniteDifferences fd;
+	gint i;
+
+	fd.nAtoms = nAtoms;
+	fd.symbols = NULL;
+	fd.coordinates = NULL;
+	if(nAtoms>0)
+	{
+		fd.symbols = g_malloc(nAtoms*sizeof(gchar*));
+		for(i=0;i<nAtoms;i++) fd.symbols[i] = NULL;
+		fd.coordinates = g_malloc0(3*nAtoms*sizeof(gdouble));
+	}
+	fd.model = model;
+	fd.copyModel = copyModel;
+	fd.freeModel = freeModel;
+	fd.computeModel = computeModel;
+	fd.parallel = TRUE;
+	fd.options = options;
+	fd.numberOfPoints = 0;
+	fd.numberOfDone = 0;
+	fd.hessian = NULL;
+	fd.dipoleDerivatives = NULL;
+	return fd;
+}
+/**********************************************************************/
+static gpointer copyForceFieldModel(gpointer model)
+{
+	ForceField* forceField = g_malloc(sizeof(ForceField));
+	*forceField = copyForceField((ForceField*)model);
+	return forceField;
+}
+/**********************************************************************/
+static void freeForceFieldModel(gpointer model)
+{
+	freeForceField((ForceField*)model);
+	g_free(model);
+}
+/**********************************************************************/
+/* the dipole of the MM charges */
+static void computeForceFieldModel(gpointer model, gdouble* coordinates, gdouble* energy, gdouble* gradient, gdouble* dipole)
+{
+	ForceField* forceField = (ForceField*)model;
+	Molecule* m = &forceField->molecule;
+	gint i,k;
+
+	for(i=0;i<m->nAtoms;i++)
+		for(k=0;k<3;k++) m->atoms[i].coordinates[k] = coordinates[3*i+k];
+	if(gradient)
+	{
+		forceField->klass->calculateGradient(forceField);
+		for(i=0;i<m->nAtoms;i++)
+			for(k=0;k<3;k++) gradient[3*i+k] = m->gradient[k][i];
+	}
+	if(energy) *energy = forceField->klass->calculateEnergyTmp(forceField, m);
+	if(dipole)
+	{
+		for(k=0;k<3;k++) dipole[k] = 0;
+		for(i=0;i<m->nAtoms;i++)
+			for(k=0;k<3;k++) dipole[k] += m->atoms[i].charge*m->atoms[i].coordinates[k];
+		for(k=0;k<3;k++) dipole[k] *= ANG_TO_BOHR;
+	}
+}
+/**********************************************************************/
+FiniteDifferences newFiniteDifferencesForceField(ForceField* forceField, FiniteDifferencesOptions options)
+{
+	Molecule* m = &forceField->molecule;
+	FiniteDifferences fd = newFiniteDifferences(m->nAtoms, forceField, 
+			copyForceFieldModel, freeForceFieldModel, computeForceFieldModel, options);
+	gint i,k;
+
+	for(i=0;i<m->nAtoms;i++)
+	{
+		fd.symbols[i] = g_strdup(m->atoms[i].prop.symbol);
+		for(k=0;k<3;k++) fd.coordinates[3*i+k] = m->atoms[i].coordinates[k];
+	}
+	return fd;
+}
+/**********************************************************************/
+static void showFiniteDifferencesProgress(FiniteDifferences* fd, gchar* title)
+{
+	gchar* str = g_strdup_printf(_("%s : %d/%d geometries done"), title, fd->numberOfDone, fd->numberOfPoints);
+	set_text_to_draw(str);
+	drawGeom();
+	while( gtk_events_pending() ) gtk_main_iteration();
+	g_free(str);
+}
+/**********************************************************************/
+static gint getNumberOfThreads(FiniteDifferences* fd, gint numberOfTasks)
+{
+	gint nThreads = 1;
+#ifdef ENABLE_OMP
+	if(fd->parallel)
+	{
+		nThreads = fd->options.numberOfThreads;
+		if(nThreads<1) nThreads = omp_get_max_threads();
+		if(nThreads>numberOfTasks) nThreads = numberOfTasks;
+		if(nThreads<1) nThreads = 1;
+	}
+#endif
+	return nThreads;
+}
+/**********************************************************************/
+static gpointer* newModels(FiniteDifferences* fd, gint nThreads)
+{
+	gpointer* models = g_malloc(nThreads*sizeof(gpointer));
+	gint t;
+	for(t=0;t<nThreads;t++) models[t] = fd->copyModel(fd->model);
+	return models;
+}
+/**********************************************************************/
+static void freeModels(FiniteDifferences* fd, gpointer* models, gint nThreads)
+{
+	gint t;
+	for(t=0;t<nThreads;t++) fd->freeModel(models[t]);
+	g_free(models);
+}
+/**********************************************************************/
+static void freeMatrix(gdouble*** M, gint n)
+{
+	gint i;
+	if(!*M) return;
+	for(i=0;i<n;i++) g_free((*M)[i]);
+	g_free(*M);
+	*M = NULL;
+}
+/**********************************************************************/
+static gdouble** newMatrix(gint n, gint m)
+{
+	gdouble** M = g_malloc(n*sizeof(gdouble*));
+	gint i;
+	for(i=0;i<n;i++) M[i] = g_malloc0(m*sizeof(gdouble));
+	return M;
+}
+/**********************************************************************/
+gboolean computeFiniteDifferencesHessian(FiniteDifferences* fd)
+{
+	gint n3 = 3*fd->nAtoms;
+	gdouble h = fd->options.step;
+	/* kcal/mol/Ang^2 => Hartree/Bohr^2, au/Ang => au/Bohr */
+	gdouble fH = BOHR_TO_ANG*BOHR_TO_ANG/AUTOKCAL/(2*h);
+	gdouble fD = BOHR_TO_ANG/(2*h);
+	gint nThreads;
+	gpointer* models;
+	gint i,k;
+
+	if(n3<1 || h<=0) return FALSE;
+	freeMatrix(&fd->hessian, n3);
+	freeMatrix(&fd->dipoleDerivatives, n3);
+	fd->hessian = newMatrix(n3, n3);
+	fd->dipoleDerivatives = newMatrix(n3, 3);
+
+	nThreads = getNumberOfThreads(fd, n3);
+	models = newModels(fd, nThreads);
+	fd->numberOfPoints = 2*n3;
+	fd->numberOfDone = 0;
+	showFiniteDifferencesProgress(fd, _("Hessian"));
+
+#ifdef ENABLE_OMP
+#pragma omp parallel for schedule(dynamic,1) num_threads(nThreads) private(i)
+#endif
+	for(k=0;k<n3;k++)
+	{
+		gint t = 0;
+		gdouble* x;
+		gdouble* gp;
+		gdouble* gm;
+		gdouble dp[3];
+		gdouble dm[3];
+		if(StopCalcul) continue;
+#ifdef ENABLE_OMP
+		t = omp_get_thread_num();
+#endif
+		x = g_malloc(n3*sizeof(gdouble));
+		gp = g_malloc(n3*sizeof(gdouble));
+		gm = g_malloc(n3*sizeof(gdouble));
+		memcpy(x, fd->coordinates, n3*sizeof(gdouble));
+		x[k] += h;
+		fd->computeModel(models[t], x, NULL, gp, dp);
+		x[k] -= 2*h;
+		fd->computeModel(models[t], x, NULL, gm, dm);
+		for(i=0;i<n3;i++) fd->hessian[k][i] = (gp[i]-gm[i])*fH;
+		for(i=0;i<3;i++) fd->dipoleDerivatives[k][i] = (dp[i]-dm[i])*fD;
+		g_free(x);
+		g_free(gp);
+		g_free(gm);
+#ifdef ENABLE_OMP
+#pragma omp atomic
+#endif
+		fd->numberOfDone += 2;
+#ifdef ENABLE_OMP
+#ifndef G_OS_WIN32
+		if(omp_get_thread_num()==0)
+		showFiniteDifferencesProgress(fd, _("Hessian"));
+#endif
+#else
+		showFiniteDifferencesProgress(fd, _("Hessian"));
+#endif
+	}
+	freeModels(fd, models, nThreads);
+	if(StopCalcul) return FALSE;
+	for(k=0;k<n3;k++)
+	for(i=0;i<k;i++)
+	{
+		fd->hessian[k][i] = (fd->hessian[k][i]+fd->hessian[i][k])/2;
+		fd->hessian[i][k] = fd->hessian[k][i];
+	}
+	return TRUE;
+}
+/**********************************************************************/
+/* Same order as the Gaussian inputs of the 2MR-QFF made by the vibration window */
+static gint setQFFPoints(gint nModes, gboolean diagonal, QFFPoint* points)
+{
+	static gdouble c1[] = {3,2,1,-1,-2,-3};
+	static gdouble c2i[] = {1,1,-1,-1};
+	static gdouble c2j[] = {1,-1,1,-1};
+	gint n = 0;
+	gint i,j,k;
+
+	if(points) { points[n].i = points[n].j = -1; points[n].ci = points[n].cj = 0; }
+	n++;
+	for(i=0;i<nModes;i++)
+	for(k=0;k<6;k++)
+	{
+		if(points) { points[n].i = i; points[n].j = -1; points[n].ci = c1[k]; points[n].cj = 0; }
+		n++;
+	}
+	if(diagonal) return n;
+	for(j=0;j<nModes;j++)
+	{
+		for(i=0;i<j;i++)
+		for(k=0;k<4;k++)
+		{
+			if(points) { points[n].i = j; points[n].j = i; points[n].ci = c2i[k]; points[n].cj = c2j[k]; }
+			n++;
+		}
+		for(i=0;i<nModes;i++)
+		{
+			if(i==j) continue;
+			for(k=0;k<4;k++)
+			{
+				if(points) { points[n].i = j; points[n].j = i; points[n].ci = c2i[k]; points[n].cj = 3*c2j[k]; }
+				n++;
+			}
+		}
+	}
+	return n;
+}
+/**********************************************************************/
+gint	getNumberOfFiniteDifferencesQFFPoints(gint nModes, gboolean diagonal)
+{
+	return setQFFPoints(nModes, diagonal, NULL);
+}
+/**********************************************************************/
+/* modes [nModes][3*nAtoms] and deltas [nModes] in Bohr. 
+ * energies [nPoints] in Hartree, dipoles [3*nPoints] in au (can be NULL), in the order of the 2MR-QFF file
+ */
+gboolean computeFiniteDifferencesQFF(FiniteDifferences* fd, gint nModes, gdouble** modes, gdouble* deltas, gdouble* energies, gdouble* dipoles)
+{
+	gint n3 = 3*fd->nAtoms;
+	gint nPoints;
+	QFFPoint* points;
+	gint nThreads;
+	gpointer* models;
+	gint p;
+
+	if(nModes<1 || n3<1 || !modes || !deltas || !energies) return FALSE;
+	nPoints = setQFFPoints(nModes, fd->options.qffDiagonal, NULL);
+	points = g_malloc(nPoints*sizeof(QFFPoint));
+	setQFFPoints(nModes, fd->options.qffDiagonal, points);
+
+	nThreads = getNumberOfThreads(fd, nPoints);
+	models = newModels(fd, nThreads);
+	fd->numberOfPoints = nPoints;
+	fd->numberOfDone = 0;
+	showFiniteDifferencesProgress(fd, _("2MR-QFF"));
+
+#ifdef ENABLE_OMP
+#pragma omp parallel for schedule(dynamic,1) num_threads(nThreads)
+#endif
+	for(p=0;p<nPoints;p++)
+	{
+		gint t = 0;
+		gint k;
+		gdouble* x;
+		gdouble energy = 0;
+		gdouble dipole[3];
+		if(StopCalcul) continue;
+#ifdef ENABLE_OMP
+		t = omp_get_thread_num();
+#endif
+		x = g_malloc(n3*sizeof(gdouble));
+		memcpy(x, fd->coordinates, n3*sizeof(gdouble));
+		if(points[p].i>-1)
+		for(k=0;k<n3;k++) x[k] += points[p].ci*deltas[points[p].i]*modes[points[p].i][k]*BOHR_TO_ANG;
+		if(points[p].j>-1)
+		for(k=0;k<n3;k++) x[k] += points[p].cj*deltas[points[p].j]*modes[points[p].j][k]*BOHR_TO_ANG;
+		fd->computeModel(models[t], x, &energy, NULL, dipole);
+		energies[p] = energy/AUTOKCAL;
+		if(dipoles) for(k=0;k<3;k++) dipoles[3*p+k] = dipole[k];
+		g_free(x);
+#ifdef ENABLE_OMP
+#pragma omp atomic
+#endif
+		fd->numberOfDone++;
+#ifdef ENABLE_OMP
+#ifndef G_OS_WIN32
+		if(omp_get_thread_num()==0)
+		showFiniteDifferencesProgress(fd, _("2MR-QFF"));
+#endif
+#else
+		showFiniteDifferencesProgress(fd, _("2MR-QFF"));
+#endif
+	}
+	freeModels(fd, models, nThreads);
+	g_free(points);
+	return !StopCalcul;
+}
+/**********************************************************************/
+/* 2MR-QFF along the real modes of the vibration window, dimensionless reduced steps */
+static void runFiniteDifferencesQFF(FiniteDifferences* fd)
+{
+	gint nf = 0;
+	gint m,j,c;
+	gdouble* frequencies = g_malloc(vibration.numberOfFrequencies*sizeof(gdouble));
+	gdouble* masses = g_malloc(vibration.numberOfFrequencies*sizeof(gdouble));
+	gdouble* deltas = g_malloc(vibration.numberOfFrequencies*sizeof(gdouble));
+	gdouble** modes = g_malloc(vibration.numberOfFrequencies*sizeof(gdouble*));
+	gdouble conv = fd->options.qffStep*sqrt(AU_TO_CM1/AMU_TO_AU);
+	gint nPoints;
+	gdouble* energies;
+	gdouble* dipoles;
+
+	for(m=0;m<vibration.numberOfFrequencies;m++)
+	{
+		if(vibration.modes[m].frequence<=0) continue;
+		frequencies[nf] = vibration.modes[m].frequence;
+		masses[nf] = vibration.modes[m].effectiveMass;
+		deltas[nf] = conv/sqrt(frequencies[nf]*masses[nf]);
+		modes[nf] = g_malloc(3*fd->nAtoms*sizeof(gdouble));
+		for(j=0;j<fd->nAtoms;j++)
+			for(c=0;c<3;c++) modes[nf][3*j+c] = vibration.modes[m].vectors[c][j];
+		nf++;
+	}
+	nPoints = getNumberOfFiniteDifferencesQFFPoints(nf, fd->options.qffDiagonal);
+	energies = g_malloc(nPoints*sizeof(gdouble));
+	dipoles = g_malloc(3*nPoints*sizeof(gdouble));
+	if(nf>0 && computeFiniteDifferencesQFF(fd, nf, modes, deltas, energies, dipoles))
+		compute_2mrqff_from_data(nf, frequencies, masses, deltas, nPoints, energies, dipoles);
+
+	for(m=0;m<nf;m++) g_free(modes[m]);
+	g_free(modes);
+	g_free(frequencies);
+	g_free(masses);
+	g_free(deltas);
+	g_free(energies);
+	g_free(dipoles);
+}
+/**********************************************************************/
+gboolean runFiniteDifferencesFrequencies(FiniteDifferences* fd)
+{
+	gint n3 = 3*fd->nAtoms;
+	gdouble* coordinates;
+	gdouble** hessian;
+	gint i,k;
+
+	if(!computeFiniteDifferencesHessian(fd))
+	{
+		set_text_to_draw(" ");
+		return FALSE;
+	}
+	/* the vibration window works in Bohr and mass-weights its copy of the Hessian */
+	coordinates = g_malloc(n3*sizeof(gdouble));
+	for(k=0;k<n3;k++) coordinates[k] = fd->coordinates[k]*ANG_TO_BOHR;
+	hessian = newMatrix(n3, n3);
+	for(k=0;k<n3;k++) for(i=0;i<n3;i++) hessian[k][i] = fd->hessian[k][i];
+
+	view_orb(Fenetre,0,NULL);
+	set_vibration_from_hessian(fd->nAtoms, fd->symbols, coordinates, hessian, fd->dipoleDerivatives);
+	freeMatrix(&hessian, n3);
+	g_free(coordinates);
+
+	if(fd->options.qff) runFiniteDifferencesQFF(fd);
+	set_text_to_draw(" ");
+	drawGeom();
+	return !StopCalcul;
+}
+/**********************************************************************/
+static GtkWidget* addFiniteDifferencesEntry(GtkWidget* table, gint i, gchar* label, gchar* value)
+{
+	GtkWidget* entry = gtk_entry_new();
+	GtkWidget* w = gtk_label_new(label);
+	gtk_table_attach(GTK_TABLE(table),w,0,1,i,i+1,
+                  (GtkAttachOptions)(GTK_FILL|GTK_SHRINK),
+                  (GtkAttachOptions)(GTK_FILL|GTK_SHRINK),
+                  1,1);
+	gtk_entry_set_text(GTK_ENTRY(entry),value);
+	gtk_widget_set_size_request(GTK_WIDGET(entry),100,-1);
+	gtk_table_attach(GTK_TABLE(table),entry,1,2,i,i+1,
+                  (GtkAttachOptions)(GTK_FILL|GTK_EXPAND),
+                  (GtkAttachOptions)(GTK_FILL|GTK_SHRINK),
+                  1,1);
+	return entry;
+}
+/**********************************************************************/
+static GtkWidget* addFiniteDifferencesCheck(GtkWidget* table, gint i, gchar* label, gboolean active)
+{
+	GtkWidget* button = gtk_check_button_new_with_label(label);
+	gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(button), active);
+	gtk_table_attach(GTK_TABLE(table),button,0,2,i,i+1,
+                  (GtkAttachOptions)(GTK_FILL|GTK_SHRINK),
+                  (GtkAttachOptions)(GTK_FILL|GTK_SHRINK),
+                  1,1);
+	return button;
+}
+/**********************************************************************/
+void	addFiniteDifferencesOptionsDlg(GtkWidget *NoteBook, GtkWidget *win)
+{
+	GtkWidget *frame;
+	GtkWidget *LabelOnglet;
+	GtkWidget *LabelMenu;
+	GtkWidget *vbox;
+	GtkWidget *table;
+	GtkWidget *entry;
+	GtkWidget *button;
+	FiniteDifferencesOptions options;
+	gchar* t;
+
+	initFiniteDifferencesOptions(&options);
+	frame = gtk_frame_new(NULL);
+	gtk_container_set_border_width(GTK_CONTAINER(frame), 5);
+
+	LabelOnglet = gtk_label_new(_("Frequencies"));
+	LabelMenu = gtk_label_new(_("Frequencies"));
+	gtk_notebook_append_page_menu(GTK_NOTEBOOK(NoteBook), frame,LabelOnglet, LabelMenu);
+
+	vbox = gtk_vbox_new (FALSE, 0);
+	gtk_container_add (GTK_CONTAINER (frame), vbox);
+	table = gtk_table_new(5,2,FALSE);
+	gtk_box_pack_start (GTK_BOX (vbox), table, TRUE, TRUE, 0);
+
+	t = g_strdup_printf("%0.4f",options.step);
+	entry = addFiniteDifferencesEntry(table, 0, _("Cartesian step (Ang)"), t);
+	g_free(t);
+	g_object_set_data(G_OBJECT (win), "EntryFDStep",entry);
+
+	button = addFiniteDifferencesCheck(table, 1, _("Anharmonic 2MR-QFF constants along the normal modes"), options.qff);
+	g_object_set_data(G_OBJECT (win), "ButtonFDQFF",button);
+
+	button = addFiniteDifferencesCheck(table, 2, _("1MR only (diagonal cubic and quartic constants)"), options.qffDiagonal);
+	g_object_set_data(G_OBJECT (win), "ButtonFDQFFDiagonal",button);
+
+	t = g_strdup_printf("%0.2f",options.qffStep);
+	entry = addFiniteDifferencesEntry(table, 3, _("QFF step (dimensionless reduced coordinates)"), t);
+	g_free(t);
+	g_object_set_data(G_OBJECT (win), "EntryFDQFFStep",entry);
+
+	t = g_strdup_printf("%d",options.numberOfThreads);
+	entry = addFiniteDifferencesEntry(table, 4, _("Number of threads (0 : all)"), t);
+	g_free(t);
+	g_object_set_data(G_OBJECT (win), "EntryFDThreads",entry);
+	gtk_widget_show_all(frame);
+}
+/**********************************************************************/
+void	getFiniteDifferencesOptionsFromDlg(GtkWidget *win, FiniteDifferencesOptions* options)
+{
+	GtkWidget* entryStep = g_object_get_data(G_OBJECT (win), "EntryFDStep");
+	GtkWidget* buttonQFF = g_object_get_data(G_OBJECT (win), "ButtonFDQFF");
+	GtkWidget* buttonDiagonal = g_object_get_data(G_OBJECT (win), "ButtonFDQFFDiagonal");
+	GtkWidget* entryQFFStep = g_object_get_data(G_OBJECT (win), "EntryFDQFFStep");
+	GtkWidget* entryThreads = g_object_get_data(G_OBJECT (win), "EntryFDThreads");
+
+	initFiniteDifferencesOptions(options);
+	if(entryStep) options->step = fabs(atof(gtk_entry_get_text(GTK_ENTRY(entryStep))));
+	if(buttonQFF) options->qff = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonQFF));
+	if(buttonDiagonal) options->qffDiagonal = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonDiagonal));
+	if(entryQFFStep) options->qffStep = fabs(atof(gtk_entry_get_text(GTK_ENTRY(entryQFFStep))));
+	if(entryThreads) options->numberOfThreads = atoi(gtk_entry_get_text(GTK_ENTRY(entryThreads)));
+	if(options->step<=0) options->step = 0.005;
+	if(options->qffStep<=0) options->qffStep = 0.4;
+}
+/**********************************************************************/
+void	freeFiniteDifferences(FiniteDifferences* fd)
+{
+	gint i;
+	gint n3 = 3*fd->nAtoms;
+
+	if(fd->symbols) for(i=0;i<fd->nAtoms;i++) if(fd->symbols[i]) g_free(fd->symbols[i]);
+	if(fd->symbols) g_free(fd->symbols);
+	if(fd->coordinates) g_free(fd->coordinates);
+	freeMatrix(&fd->hessian, n3);
+	freeMatrix(&fd->dipoleDerivatives, n3);
+	fd->symbols = NULL;
+	fd->coordinates = NULL;
+	fd->nAtoms = 0;
+}
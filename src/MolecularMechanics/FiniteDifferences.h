@@ -0,0 +1,70 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#ifndef __GABEDIT_FINITEDIFFERENCES_H__
+#define __GABEDIT_FINITEDIFFERENCES_H__
+
+typedef struct _FiniteDifferences  FiniteDifferences;
+typedef struct _FiniteDifferencesOptions  FiniteDifferencesOptions;
+
+/* A model is evaluated at coordinates in Ang : energy in kcal/mol, gradient [3*nAtoms] in kcal/mol/Ang and dipole in au.
+ * gradient and dipole can be NULL. Each thread works on its own copy of the model.
+ */
+typedef gpointer (*FiniteDifferencesCopyModel)(gpointer model);
+typedef void (*FiniteDifferencesFreeModel)(gpointer model);
+typedef void (*FiniteDifferencesComputeModel)(gpointer model, gdouble* coordinates, gdouble* energy, gdouble* gradient, gdouble* dipole);
+
+struct _FiniteDifferencesOptions
+{
+	gdouble step; /* Ang, cartesian step for the Hessian */
+	gboolean qff; /* 2MR-QFF along the normal modes */
+	gboolean qffDiagonal; /* 1MR only : diagonal cubic and quartic constants */
+	gdouble qffStep; /* dimensionless reduced coordinates */
+	gint numberOfThreads; /* <=0 : all available processors */
+};
+
+struct _FiniteDifferences
+{
+	gint nAtoms;
+	gchar** symbols;
+	gdouble* coordinates; /* [3*nAtoms] Ang */
+	gpointer model;
+	FiniteDifferencesCopyModel copyModel;
+	FiniteDifferencesFreeModel freeModel;
+	FiniteDifferencesComputeModel computeModel;
+	gboolean parallel; /* FALSE if the copies share the files of an external program */
+	FiniteDifferencesOptions options;
+	gint numberOfPoints;
+	gint numberOfDone;
+	gdouble** hessian; /* [3*nAtoms][3*nAtoms] Hartree/Bohr^2 */
+	gdouble** dipoleDerivatives; /* [3*nAtoms][3] au */
+};
+
+void	initFiniteDifferencesOptions(FiniteDifferencesOptions* options);
+FiniteDifferences newFiniteDifferences(gint nAtoms, gpointer model, FiniteDifferencesCopyModel copyModel, FiniteDifferencesFreeModel freeModel, FiniteDifferencesComputeModel computeModel, FiniteDifferencesOptions options);
+FiniteDifferences newFiniteDifferencesForceField(ForceField* forceField, FiniteDifferencesOptions options);
+gboolean computeFiniteDifferencesHessian(FiniteDifferences* fd);
+gint	getNumberOfFiniteDifferencesQFFPoints(gint nModes, gboolean diagonal);
+gboolean computeFiniteDifferencesQFF(FiniteDifferences* fd, gint nModes, gdouble** modes, gdouble* deltas, gdouble* energies, gdouble* dipoles);
+gboolean runFiniteDifferencesFrequencies(FiniteDifferences* fd);
+void	freeFiniteDifferences(FiniteDifferences* fd);
+void	addFiniteDifferencesOptionsDlg(GtkWidget *NoteBook, GtkWidget *win);
+void	getFiniteDifferencesOptionsFromDlg(GtkWidget *win, FiniteDifferencesOptions* options);
+
+#endif /* __GABEDIT_FINITEDIFFERENCES_H__ */
+
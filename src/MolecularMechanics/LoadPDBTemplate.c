@@ -96,9 +96,8 @@ void setResiduesList(PDBTemplate* pdbTemplate, FILE* file)
 	}
 }
 /**********************************************************************/
-void setOneResidue(PDBTemplate* pdbTemplate, FILE* file,gint residueNumber)
+static void setOneResidue(PDBResidueTemplate* residueTemplate, FILE* file)
 {
-	gchar title[BSIZE];
 	gchar pdbType[BSIZE];
 	gchar mmType[BSIZE];
 	gchar charge[BSIZE];
@@ -106,32 +105,13 @@ void setOneResidue(PDBTemplate* pdbTemplate, FILE* file,gint residueNumber)
 	gint len = BSIZE;
 	gint n = 0;
 	PDBTypeTemplate *typeTemplates = NULL;
-	gboolean Ok = FALSE;
 
-	sprintf(title,"Begin %s Residue",pdbTemplate->residueTemplates[residueNumber].residueName);
-	fseek(file, 0L, SEEK_SET);
-	while(!feof(file))
-	{
-		if(fgets(dump,len,file))
-		{
-			if(strstr(dump,title))
-			{
-				Ok = TRUE;
-				break;
-			}
-		}
-	}
-	if(!Ok)
-		return;
 	n = 0;
 	typeTemplates = g_malloc(sizeof(PDBTypeTemplate));
 	while(!feof(file))
 	{
-		if(fgets(dump,len,file))
-		{
-			if(strstr(dump,"End"))
-				break;
-		}
+		if(!fgets(dump,len,file)) break;
+		if(strstr(dump,"End")) break;
 		sscanf(dump,"%s %s %s",pdbType, mmType, charge);
 		/*printf("pdbType = %s mmType = %s charge = %s\n",pdbType, mmType, charge);*/
 		typeTemplates[n].pdbType = g_strdup(pdbType);
@@ -144,26 +124,60 @@ void setOneResidue(PDBTemplate* pdbTemplate, FILE* file,gint residueNumber)
 	if(n==0)
 	{
 		g_free(typeTemplates);
-		pdbTemplate->residueTemplates[residueNumber].numberOfTypes = 0;
-		pdbTemplate->residueTemplates[residueNumber].typeTemplates = NULL;
+		residueTemplate->numberOfTypes = 0;
+		residueTemplate->typeTemplates = NULL;
 		return;
 	}
 	typeTemplates = g_realloc(typeTemplates,n*sizeof(PDBTypeTemplate));
 
-	pdbTemplate->residueTemplates[residueNumber].numberOfTypes = n;
-	pdbTemplate->residueTemplates[residueNumber].typeTemplates = typeTemplates;
+	residueTemplate->numberOfTypes = n;
+	residueTemplate->typeTemplates = typeTemplates;
 }
 /**********************************************************************/
+/* One pass over the file to find the "Begin XXX Residue" titles,
+ * rather than a rewind and a search from the beginning for each residue of the list.
+ */
 void setAllResidues(PDBTemplate* pdbTemplate, FILE* file)
 {
 	gint i;
 	gint n = pdbTemplate->numberOfResidues;
+	gchar dump[BSIZE];
+	gchar begin[BSIZE];
+	gchar name[BSIZE];
+	gchar residue[BSIZE];
+	gint len = BSIZE;
+	GHashTable* titles = NULL;
+	glong* positions = NULL;
+	gint nTitles = 0;
+
 	/* printf("numberOfResidues = %d\n",pdbTemplate->numberOfResidues);*/
+	if(n<1) return;
+	titles = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	positions = g_malloc(sizeof(glong));
+	fseek(file, 0L, SEEK_SET);
+	while(!feof(file))
+	{
+		if(!fgets(dump,len,file)) break;
+		if(!strstr(dump,"Begin") || !strstr(dump,"Residue")) continue;
+		if(sscanf(dump,"%s %s %s",begin, name, residue)!=3) continue;
+		if(strcmp(begin,"Begin") || strcmp(residue,"Residue")) continue;
+		/* the first title of a residue, as the search from the beginning of the file */
+		if(g_hash_table_lookup(titles, name)) continue;
+		positions = g_realloc(positions,(nTitles+1)*sizeof(glong));
+		positions[nTitles] = ftell(file);
+		nTitles++;
+		g_hash_table_insert(titles, g_strdup(name), GINT_TO_POINTER(nTitles));
+	}
 	for(i=0;i<n;i++)
 	{
+		gint k = GPOINTER_TO_INT(g_hash_table_lookup(titles, pdbTemplate->residueTemplates[i].residueName))-1;
 		/* printf("i = %d\n",i);*/
-		setOneResidue(pdbTemplate,file,i);
+		if(k<0) continue;
+		fseek(file, positions[k], SEEK_SET);
+		setOneResidue(&pdbTemplate->residueTemplates[i],file);
 	}
+	g_hash_table_destroy(titles);
+	g_free(positions);
 }
 /**********************************************************************/
 gboolean readPDBTemplate(PDBTemplate* pdbTemplate,gchar* filename)
@@ -22,6 +22,10 @@ DEALINGS IN THE SOFTWARE.
 #include <math.h>
 #ifdef ENABLE_OMP
 #include <omp.h>
+/* atomic rather than critical : several force fields may be evaluated at once (conformers) */
+#define ADDGRADIENT(g,v) _Pragma("omp atomic") g += (v)
+#else
+#define ADDGRADIENT(g,v) g += (v)
 #endif
 
 #include "../Common/Global.h"
@@ -141,21 +145,134 @@ static void freeAmberParameters(AmberParameters* amberParameters)
 	amberParameters->hydrogenBondedTerms = NULL;
 }
 /**********************************************************************/
-static gint getNumberType(AmberParameters* amberParameters, gchar* type)
+/* Parameters compiled for the setting of a model : 
+ * type names interned to their numbers and terms hashed by their type tuples.
+ * A term is found in O(1) rather than by a scan of the tables.
+ * When a tuple is given several times, the first term is kept, as the scans did.
+ */
+typedef struct _AmberParametersIndex
 {
+	GHashTable* types;
+	GHashTable* stretch;
+	GHashTable* bend;
+	GHashTable* dihedral;
+	GHashTable* improper;
+	GHashTable* nonBonded;
+	GHashTable* hydrogenBonded;
+	GHashTable* pairWise;
+}AmberParametersIndex;
+/**********************************************************************/
+static guint hashAmberParametersKey(gconstpointer v)
+{
+	const gint* n = (const gint*)v;
+	guint h = 17;
+	gint k;
+	for(k=0;k<4;k++) h = h*31 + (guint)n[k];
+	return h;
+}
+/**********************************************************************/
+static gboolean equalAmberParametersKey(gconstpointer v1, gconstpointer v2)
+{
+	const gint* n1 = (const gint*)v1;
+	const gint* n2 = (const gint*)v2;
+	return n1[0]==n2[0] && n1[1]==n2[1] && n1[2]==n2[2] && n1[3]==n2[3];
+}
+/**********************************************************************/
+static GHashTable* newAmberParametersTable()
+{
+	return g_hash_table_new_full(hashAmberParametersKey, equalAmberParametersKey, g_free, NULL);
+}
+/**********************************************************************/
+static void addAmberParametersKey(GHashTable* table, gint n0, gint n1, gint n2, gint n3, gint i)
+{
+	gint* key = g_malloc(4*sizeof(gint));
+	key[0] = n0; key[1] = n1; key[2] = n2; key[3] = n3;
+	if(g_hash_table_lookup(table, key)) g_free(key);
+	else g_hash_table_insert(table, key, GINT_TO_POINTER(i+1));
+}
+/**********************************************************************/
+static gint findAmberParametersKey(GHashTable* table, gint n0, gint n1, gint n2, gint n3)
+{
+	gint key[4];
+	key[0] = n0; key[1] = n1; key[2] = n2; key[3] = n3;
+	return GPOINTER_TO_INT(g_hash_table_lookup(table, key))-1;
+}
+/**********************************************************************/
+static AmberParametersIndex newAmberParametersIndex(AmberParameters* amberParameters)
+{
+	AmberParametersIndex index;
 	gint i;
-	gint nTypes = amberParameters->numberOfTypes;
-	AmberAtomTypes* types = amberParameters->atomTypes;
-	gint len = strlen(type);
 
-	if(strcmp(type,"X")==0)
-		return -1;
-	for(i=0;i<nTypes;i++)
+	index.types = g_hash_table_new(g_str_hash, g_str_equal);
+	for(i=0;i<amberParameters->numberOfTypes;i++)
 	{
-		if(len == (gint)strlen(types[i].name) && strstr(types[i].name,type))
-			return types[i].number;
+		AmberAtomTypes* t = &amberParameters->atomTypes[i];
+		if(!g_hash_table_lookup_extended(index.types, t->name, NULL, NULL))
+			g_hash_table_insert(index.types, t->name, GINT_TO_POINTER(t->number));
+	}
 
+	index.stretch = newAmberParametersTable();
+	for(i=0;i<amberParameters->numberOfStretchTerms;i++)
+	{
+		gint* n = amberParameters->bondStretchTerms[i].numbers;
+		addAmberParametersKey(index.stretch, n[0], n[1], 0, 0, i);
+	}
+	index.bend = newAmberParametersTable();
+	for(i=0;i<amberParameters->numberOfBendTerms;i++)
+	{
+		gint* n = amberParameters->angleBendTerms[i].numbers;
+		addAmberParametersKey(index.bend, n[0], n[1], n[2], 0, i);
+	}
+	index.dihedral = newAmberParametersTable();
+	for(i=0;i<amberParameters->numberOfDihedralTerms;i++)
+	{
+		gint* n = amberParameters->dihedralAngleTerms[i].numbers;
+		addAmberParametersKey(index.dihedral, n[0], n[1], n[2], n[3], i);
+	}
+	index.improper = newAmberParametersTable();
+	for(i=0;i<amberParameters->numberOfImproperTorsionTerms;i++)
+	{
+		gint* n = amberParameters->improperTorsionTerms[i].numbers;
+		addAmberParametersKey(index.improper, n[0], n[1], n[2], n[3], i);
 	}
+	index.nonBonded = newAmberParametersTable();
+	for(i=0;i<amberParameters->numberOfNonBonded;i++)
+		addAmberParametersKey(index.nonBonded, amberParameters->nonBondedTerms[i].number, 0, 0, 0, i);
+	index.hydrogenBonded = newAmberParametersTable();
+	for(i=0;i<amberParameters->numberOfHydrogenBonded;i++)
+	{
+		gint* n = amberParameters->hydrogenBondedTerms[i].numbers;
+		addAmberParametersKey(index.hydrogenBonded, n[0], n[1], 0, 0, i);
+	}
+	index.pairWise = newAmberParametersTable();
+	for(i=0;i<amberParameters->numberOfPairWise;i++)
+	{
+		gint* n = amberParameters->pairWiseTerms[i].numbers;
+		addAmberParametersKey(index.pairWise, n[0], n[1], 0, 0, i);
+	}
+	return index;
+}
+/**********************************************************************/
+static void freeAmberParametersIndex(AmberParametersIndex* index)
+{
+	g_hash_table_destroy(index->types);
+	g_hash_table_destroy(index->stretch);
+	g_hash_table_destroy(index->bend);
+	g_hash_table_destroy(index->dihedral);
+	g_hash_table_destroy(index->improper);
+	g_hash_table_destroy(index->nonBonded);
+	g_hash_table_destroy(index->hydrogenBonded);
+	g_hash_table_destroy(index->pairWise);
+}
+/**********************************************************************/
+static gint getNumberType(AmberParametersIndex* index, gchar* type)
+{
+	gpointer number;
+
+	if(strcmp(type,"X")==0)
+		return -1;
+	if(g_hash_table_lookup_extended(index->types, type, NULL, &number))
+		return GPOINTER_TO_INT(number);
 	return -2;
 }
 /**********************************************************************/
@@ -218,7 +335,7 @@ static gboolean isIonic(gchar* mmType)
 	return FALSE;
 }
 /**********************************************************************/
-static gboolean getStretchParameters(	AmberParameters* amberParameters,
+static gboolean getStretchParameters(	AmberParameters* amberParameters, AmberParametersIndex* index,
 								gint a1Type, gint a2Type, 
 								gdouble* forceConstant,gdouble* equilibriumDistance)
 {
@@ -234,22 +351,14 @@ static gboolean getStretchParameters(	AmberParameters* amberParameters,
 		a2Type = t;
 	}
 
-	for(i=0;i<amberParameters->numberOfStretchTerms;i++)
-	{
-		if(
-			a1Type == amberParameters->bondStretchTerms[i].numbers[0]  &&
-			a2Type == amberParameters->bondStretchTerms[i].numbers[1] 
-		)
-		{
-			forceConstant[0]       = amberParameters->bondStretchTerms[i].forceConstant;
-			equilibriumDistance[0] = amberParameters->bondStretchTerms[i].equilibriumDistance;
-			return TRUE;
-		}
-	}
-	return FALSE;
+	i = findAmberParametersKey(index->stretch, a1Type, a2Type, 0, 0);
+	if(i<0) return FALSE;
+	forceConstant[0]       = amberParameters->bondStretchTerms[i].forceConstant;
+	equilibriumDistance[0] = amberParameters->bondStretchTerms[i].equilibriumDistance;
+	return TRUE;
 }
 /**********************************************************************/
-static gboolean getBendParameters(AmberParameters* amberParameters,gint a1Type, gint a2Type, gint a3Type,
+static gboolean getBendParameters(AmberParameters* amberParameters, AmberParametersIndex* index, gint a1Type, gint a2Type, gint a3Type,
 	       	gdouble* forceConstant, gdouble* equilibriumAngle)
 {
 	gint i;
@@ -264,23 +373,14 @@ static gboolean getBendParameters(AmberParameters* amberParameters,gint a1Type,
 		a3Type = t;
 	}
 
-	for(i=0;i<amberParameters->numberOfBendTerms;i++)
-	{
-		if(
-			a1Type == amberParameters->angleBendTerms[i].numbers[0]  &&
-			a2Type == amberParameters->angleBendTerms[i].numbers[1]  &&
-			a3Type == amberParameters->angleBendTerms[i].numbers[2] 
-		)
-		{
-			forceConstant[0]       = amberParameters->angleBendTerms[i].forceConstant;
-			equilibriumAngle[0]    = amberParameters->angleBendTerms[i].equilibriumAngle;
-			return TRUE;
-		}
-	}
-	return FALSE;
+	i = findAmberParametersKey(index->bend, a1Type, a2Type, a3Type, 0);
+	if(i<0) return FALSE;
+	forceConstant[0]       = amberParameters->angleBendTerms[i].forceConstant;
+	equilibriumAngle[0]    = amberParameters->angleBendTerms[i].equilibriumAngle;
+	return TRUE;
 }
 /**********************************************************************/
-static gboolean getHydrogenBondedParameters(AmberParameters* amberParameters, gint a1Type, gint a2Type, gdouble c[], gdouble d[] )
+static gboolean getHydrogenBondedParameters(AmberParameters* amberParameters, AmberParametersIndex* index, gint a1Type, gint a2Type, gdouble c[], gdouble d[] )
 {
 	gint i;
 	AmberAtomTypes* types = amberParameters->atomTypes;
@@ -296,51 +396,36 @@ static gboolean getHydrogenBondedParameters(AmberParameters* amberParameters, gi
 		a2Type = t;
 	}
 
-	for(i=0;i<amberParameters->numberOfHydrogenBonded;i++)
-	{
-		if(
-			a1Type == amberParameters->hydrogenBondedTerms[i].numbers[0] &&
-			a2Type == amberParameters->hydrogenBondedTerms[i].numbers[1]
-		  )
-		{
-			c[0]    = amberParameters->hydrogenBondedTerms[i].c;
-			d[0]    = amberParameters->hydrogenBondedTerms[i].d;
-			return TRUE;
-		}
-	}
-	return FALSE;
+	i = findAmberParametersKey(index->hydrogenBonded, a1Type, a2Type, 0, 0);
+	if(i<0) return FALSE;
+	c[0]    = amberParameters->hydrogenBondedTerms[i].c;
+	d[0]    = amberParameters->hydrogenBondedTerms[i].d;
+	return TRUE;
 }
 /**********************************************************************/
-static gboolean getNonBondedParameters(AmberParameters* amberParameters, gint atomType, gdouble* r, gdouble* epsilon )
+static gboolean getNonBondedParameters(AmberParameters* amberParameters, AmberParametersIndex* index, gint atomType, gdouble* r, gdouble* epsilon )
 {
 
 	gint i;
 	r[0] = 1.0;
 	epsilon[0] = 0.0;
 	
-	for(i=0;i<amberParameters->numberOfNonBonded;i++)
-	{
-		if(
-			atomType == amberParameters->nonBondedTerms[i].number
-		  )
-		{
-			r[0]       = amberParameters->nonBondedTerms[i].r;
-			epsilon[0]    = amberParameters->nonBondedTerms[i].epsilon;
-			/*printf("r = %f eps = %f\n",r[0],epsilon[0]);*/
-			return TRUE;
-		}
-	}
-
-	return FALSE;
+	i = findAmberParametersKey(index->nonBonded, atomType, 0, 0, 0);
+	if(i<0) return FALSE;
+	r[0]       = amberParameters->nonBondedTerms[i].r;
+	epsilon[0]    = amberParameters->nonBondedTerms[i].epsilon;
+	/*printf("r = %f eps = %f\n",r[0],epsilon[0]);*/
+	return TRUE;
 }
 /**********************************************************************/
-static gboolean getPairWiseParameters(AmberParameters* amberParameters,
+static gboolean getPairWiseParameters(AmberParameters* amberParameters, AmberParametersIndex* index,
 	       	gint a1Type, gint a2Type,
 		gdouble* a, gdouble* beta,
 	       	gdouble* c6, gdouble* c8, gdouble* c10, gdouble* b)
 {
 
 	gint i;
+	gint j;
 
 	a[0]    = 0.0;
 	beta[0] = 1.0;
@@ -348,34 +433,22 @@ static gboolean getPairWiseParameters(AmberParameters* amberParameters,
 	c8[0]   = 0.0;
 	c10[0]   = 0.0;
 	b[0]    = 1.0;
-	for(i=0;i<amberParameters->numberOfPairWise;i++)
-	{
-		if(
-			(
-			a1Type == amberParameters->pairWiseTerms[i].numbers[0] &&
-			a2Type == amberParameters->pairWiseTerms[i].numbers[1] 
-			) ||
-			(
-			a1Type == amberParameters->pairWiseTerms[i].numbers[1] &&
-			a2Type == amberParameters->pairWiseTerms[i].numbers[0]
-			)
-
-		  )
-		{
-			a[0]    = amberParameters->pairWiseTerms[i].a;
-			beta[0]    = amberParameters->pairWiseTerms[i].beta;
-			c6[0]    = amberParameters->pairWiseTerms[i].c6;
-			c8[0]    = amberParameters->pairWiseTerms[i].c8;
-			c10[0]    = amberParameters->pairWiseTerms[i].c10;
-			b[0]    = amberParameters->pairWiseTerms[i].b;
-			return TRUE;
-		}
-	}
-
-	return FALSE;
+	/* a1-a2 or a2-a1 : the first term of the table */
+	i = findAmberParametersKey(index->pairWise, a1Type, a2Type, 0, 0);
+	j = findAmberParametersKey(index->pairWise, a2Type, a1Type, 0, 0);
+	if(i<0 || (j>=0 && j<i)) i = j;
+	if(i<0) return FALSE;
+
+	a[0]    = amberParameters->pairWiseTerms[i].a;
+	beta[0]    = amberParameters->pairWiseTerms[i].beta;
+	c6[0]    = amberParameters->pairWiseTerms[i].c6;
+	c8[0]    = amberParameters->pairWiseTerms[i].c8;
+	c10[0]    = amberParameters->pairWiseTerms[i].c10;
+	b[0]    = amberParameters->pairWiseTerms[i].b;
+	return TRUE;
 }
 /**********************************************************************/
-static gboolean getImproperTorsionParameters( AmberParameters* amberParameters,
+static gboolean getImproperTorsionParameters( AmberParameters* amberParameters, AmberParametersIndex* index,
 		gint a1Type, gint a2Type, gint a3Type, gint a4Type,
 	       	gdouble* forceConstant, gdouble* equilibriumAngle, gdouble* terms
 		)
@@ -399,140 +472,49 @@ static gboolean getImproperTorsionParameters( AmberParameters* amberParameters,
 	}
 
 
-	for(i=0;i<amberParameters->numberOfImproperTorsionTerms;i++)
-	{
-		if(
-			a1Type == amberParameters->improperTorsionTerms[i].numbers[0] &&
-			a2Type == amberParameters->improperTorsionTerms[i].numbers[1] &&
-			a3Type == amberParameters->improperTorsionTerms[i].numbers[2] &&
-			a4Type == amberParameters->improperTorsionTerms[i].numbers[3]
-		  )
-		{
-			forceConstant[0]    = amberParameters->improperTorsionTerms[i].barrier;
-			equilibriumAngle[0]    = amberParameters->improperTorsionTerms[i].phase;
-			terms[0]     = amberParameters->improperTorsionTerms[i].n;
-			return TRUE;
-		}
-	}
-
-	return FALSE;
+	i = findAmberParametersKey(index->improper, a1Type, a2Type, a3Type, a4Type);
+	if(i<0) return FALSE;
+	forceConstant[0]    = amberParameters->improperTorsionTerms[i].barrier;
+	equilibriumAngle[0]    = amberParameters->improperTorsionTerms[i].phase;
+	terms[0]     = amberParameters->improperTorsionTerms[i].n;
+	return TRUE;
 }
 /**********************************************************************/
-static gint getNumberDihedralParameters( AmberParameters* amberParameters,
+static gint getNumberDihedralParameters( AmberParameters* amberParameters, AmberParametersIndex* index,
 		gint a1Type, gint a2Type, gint a3Type, gint a4Type,
 		gint *n)
 {
 	gint i;
-	gint a1Typet;
-	gint a2Typet;
-	gint a3Typet;
-	gint a4Typet;
-	gboolean btype;
-	gboolean Ok;
-	gint types[4];
 	gint k;
+	gint mask;
+	gint best = -1;
+	gint types[2][4];
+	gint t[4];
+	gint d;
 
 	*n = 0;
 
-	a1Typet = a4Type;
-	a2Typet = a3Type;
-	a3Typet = a2Type;
-	a4Typet = a1Type;
-
-	/* Je cherche d'abord sans les -1 */
-	for(i=0;i<amberParameters->numberOfDihedralTerms;i++)
-	{
-
-		types[0] = a1Type;
-		types[1] = a2Type;
-		types[2] = a3Type;
-		types[3] = a4Type;
+	types[0][0] = a1Type;
+	types[0][1] = a2Type;
+	types[0][2] = a3Type;
+	types[0][3] = a4Type;
+	for(k=0;k<4;k++) types[1][k] = types[0][3-k];
 
-		Ok = TRUE;
-		for(k=0;k<4;k++)
-		{
-			btype = (types[k] == amberParameters->dihedralAngleTerms[i].numbers[k]);
-			if(!btype)
-			{
-				Ok = FALSE;
-				break;
-			}
-		}
-		if(!Ok)
-		{
-			types[0] = a1Typet;
-			types[1] = a2Typet;
-			types[2] = a3Typet;
-			types[3] = a4Typet;
-			Ok = TRUE;
-			for(k=0;k<4;k++)
-			{
-				btype = (types[k] == amberParameters->dihedralAngleTerms[i].numbers[k]);
-				if(!btype)
-				{
-					Ok = FALSE;
-					break;
-				}
-			}
-		}
-
-			 
-		if(Ok)
-		{
-			*n =i;
-			return amberParameters->dihedralAngleTerms[i].nSomme;
-		}
-	}
-	/* Je cherche d'abord avec les -1 */
-	for(i=0;i<amberParameters->numberOfDihedralTerms;i++)
+	/* mask = 0 : a1-a2-a3-a4 or a4-a3-a2-a1 without the -1, the first term of the table.
+	 * Then with the -1 : the bits of mask give the wildcard positions */
+	for(mask=0;mask<16;mask++)
 	{
-
-		types[0] = a1Type;
-		types[1] = a2Type;
-		types[2] = a3Type;
-		types[3] = a4Type;
-
-		Ok = TRUE;
-		for(k=0;k<4;k++)
+		for(d=0;d<2;d++)
 		{
-			btype = 
-			(amberParameters->dihedralAngleTerms[i].numbers[k] == -1) || 
-			(types[k] == amberParameters->dihedralAngleTerms[i].numbers[k]);
-			if(!btype)
-			{
-				Ok = FALSE;
-				break;
-			}
-		}
-		if(!Ok)
-		{
-			types[0] = a1Typet;
-			types[1] = a2Typet;
-			types[2] = a3Typet;
-			types[3] = a4Typet;
-			Ok = TRUE;
-			for(k=0;k<4;k++)
-			{
-				btype = 
-				(amberParameters->dihedralAngleTerms[i].numbers[k] == -1) || 
-				(types[k] == amberParameters->dihedralAngleTerms[i].numbers[k]);
-				if(!btype)
-				{
-					Ok = FALSE;
-					break;
-				}
-			}
-		}
-
-			 
-		if(Ok)
-		{
-			*n =i;
-			return amberParameters->dihedralAngleTerms[i].nSomme;
+			for(k=0;k<4;k++) t[k] = ((mask>>k)&1)?-1:types[d][k];
+			i = findAmberParametersKey(index->dihedral, t[0], t[1], t[2], t[3]);
+			if(i>=0 && (best<0 || i<best)) best = i;
 		}
+		if(mask==0 && best>=0) break;
 	}
-
-	return 0;
+	if(best<0) return 0;
+	*n = best;
+	return amberParameters->dihedralAngleTerms[best].nSomme;
 }
 
 /**********************************************************************/
@@ -696,7 +678,7 @@ static void setRattleConstraintsParameters(ForceField* forceField)
 	*/
 }
 /**********************************************************************/
-static void setStretchParameters(AmberParameters* amberParameters,ForceField* forceField,gint* atomTypes)
+static void setStretchParameters(AmberParameters* amberParameters, AmberParametersIndex* index, ForceField* forceField,gint* atomTypes)
 {
 	gint i;
 	gint a1,a2;
@@ -723,7 +705,7 @@ static void setStretchParameters(AmberParameters* amberParameters,ForceField* fo
 		a1Type = atomTypes[a1];
 		a2Type = atomTypes[a2];
 		
-		if ( ! ( getStretchParameters(amberParameters, a1Type, a2Type,&forceConstant,&equilibriumDistance ) ) )
+		if ( ! ( getStretchParameters(amberParameters, index, a1Type, a2Type,&forceConstant,&equilibriumDistance ) ) )
 		{
 			gchar l1 = m->atoms[a1].mmType[0];
 			gchar l2 = m->atoms[a2].mmType[0];
@@ -775,7 +757,7 @@ static void setStretchParameters(AmberParameters* amberParameters,ForceField* fo
        		forceField->bondStretchTerms[i] = bondStretchTerms[i]; 
 }
 /**********************************************************************/
-static void setBendParameters(AmberParameters* amberParameters,ForceField* forceField,gint* atomTypes)
+static void setBendParameters(AmberParameters* amberParameters, AmberParametersIndex* index, ForceField* forceField,gint* atomTypes)
 {
 	gint i;
 	gint a1,a2,a3;
@@ -804,7 +786,7 @@ static void setBendParameters(AmberParameters* amberParameters,ForceField* force
 		a2Type = atomTypes[a2];
 		a3Type = atomTypes[a3];
 
-		if ( ! ( getBendParameters(amberParameters, a1Type, a2Type, a3Type,&forceConstant,&equilibriumAngle ) ) )
+		if ( ! ( getBendParameters(amberParameters, index, a1Type, a2Type, a3Type,&forceConstant,&equilibriumAngle ) ) )
 		{
 			gchar l1 = m->atoms[a1].mmType[0];
 			gchar l2 = m->atoms[a2].mmType[0];
@@ -844,7 +826,7 @@ static void setBendParameters(AmberParameters* amberParameters,ForceField* force
 
 }
 /**********************************************************************/
-static void setDihedralParameters(AmberParameters* amberParameters,ForceField* forceField,gint* atomTypes)
+static void setDihedralParameters(AmberParameters* amberParameters, AmberParametersIndex* index, ForceField* forceField,gint* atomTypes)
 {
 	gint i;
 	gint j;
@@ -881,7 +863,7 @@ static void setDihedralParameters(AmberParameters* amberParameters,ForceField* f
 		a3Type = atomTypes[a3];
 		a4Type = atomTypes[a4];
 
-		dim = getNumberDihedralParameters(amberParameters, a1Type, a2Type, a3Type, a4Type,&k);
+		dim = getNumberDihedralParameters(amberParameters, index, a1Type, a2Type, a3Type, a4Type,&k);
 		if(dim>0)
 		{
 			for(j=0;j<dim;j++)
@@ -918,7 +900,7 @@ static void setDihedralParameters(AmberParameters* amberParameters,ForceField* f
        		forceField->dihedralAngleTerms[i] = dihedralAngleTerms[i]; 
 }
 /**********************************************************************/
-static void setImproperTorionParameters(AmberParameters* amberParameters, ForceField* forceField,gint* atomTypes)
+static void setImproperTorionParameters(AmberParameters* amberParameters, AmberParametersIndex* index, ForceField* forceField,gint* atomTypes)
 {
 	gint i;
 	gint a1,a2,a3,a4;
@@ -953,7 +935,7 @@ static void setImproperTorionParameters(AmberParameters* amberParameters, ForceF
 		a3Type = atomTypes[a3];
 		a4Type = atomTypes[a4];
 
-		getImproperTorsionParameters(amberParameters, a1Type, a2Type, a3Type,a4Type, 
+		getImproperTorsionParameters(amberParameters, index, a1Type, a2Type, a3Type,a4Type, 
 				&forceConstant, &equilibriumAngle, &terms );
 
 		improperTorsionTerms[0][i] = a1;
@@ -970,7 +952,7 @@ static void setImproperTorionParameters(AmberParameters* amberParameters, ForceF
 
 }
 /**********************************************************************/
-static void setHydrogenBondedParameters(AmberParameters* amberParameters,ForceField* forceField,gint* atomTypes)
+static void setHydrogenBondedParameters(AmberParameters* amberParameters, AmberParametersIndex* index, ForceField* forceField,gint* atomTypes)
 {
 	gint numberOfHydrogenBonded = 0;
 	gint i;
@@ -998,7 +980,7 @@ static void setHydrogenBondedParameters(AmberParameters* amberParameters,ForceFi
 
 		if ( canHydrogenBond( amberParameters, a1Type, a2Type ) )
 		{ 
-			getHydrogenBondedParameters(amberParameters, a1Type, a2Type, &C, &D );
+			getHydrogenBondedParameters(amberParameters, index, a1Type, a2Type, &C, &D );
 			hydrogenBondedTerms[0][numberOfHydrogenBonded] = a1;
 			hydrogenBondedTerms[1][numberOfHydrogenBonded] = a2;
 			hydrogenBondedTerms[2][numberOfHydrogenBonded] = C;
@@ -1026,7 +1008,7 @@ static void setHydrogenBondedParameters(AmberParameters* amberParameters,ForceFi
 
 }
 /**********************************************************************/
-static void setNonBondedParameters(AmberParameters* amberParameters, ForceField* forceField,gint* atomTypes)
+static void setNonBondedParameters(AmberParameters* amberParameters, AmberParametersIndex* index, ForceField* forceField,gint* atomTypes)
 {
 	gint numberOfNonBonded = 0;
 	gint i;
@@ -1068,14 +1050,14 @@ static void setNonBondedParameters(AmberParameters* amberParameters, ForceField*
 
 		if ( !useHydrogenBonded || !canHydrogenBond(amberParameters, a1Type, a2Type ) )
 		{ 
-			if ( ! ( getNonBondedParameters(amberParameters, a1Type, &equilibriumDistance, &epsilon ) ) )
+			if ( ! ( getNonBondedParameters(amberParameters, index, a1Type, &equilibriumDistance, &epsilon ) ) )
 				printf(_("**** couldn't find non bonded parameters for %s \n"),m->atoms[a1].mmType);
 		
 			epsilonProduct = sqrt(fabs(epsilon));
 			ri = equilibriumDistance;
 			/*printf("r1 = %f eps1 = %f\n",equilibriumDistance,epsilon);*/
 
-			getNonBondedParameters(amberParameters, a2Type, &equilibriumDistance, &epsilon );
+			getNonBondedParameters(amberParameters, index, a2Type, &equilibriumDistance, &epsilon );
 			/*printf("r2 = %f eps2 = %f\n",equilibriumDistance,epsilon);*/
 			epsilonProduct *= sqrt(fabs(epsilon));
 			rj = equilibriumDistance;
@@ -1116,7 +1098,7 @@ static void setNonBondedParameters(AmberParameters* amberParameters, ForceField*
 		epsilonProduct = 0;
 		ri = 0;
 		rj = 0;
-	        if ( getNonBondedParameters(amberParameters, a1Type, &equilibriumDistance, &epsilon ) )
+	        if ( getNonBondedParameters(amberParameters, index, a1Type, &equilibriumDistance, &epsilon ) )
 		{
 	        	epsilonProduct = sqrt(fabs(epsilon));
 	        	ri = equilibriumDistance;
@@ -1127,7 +1109,7 @@ static void setNonBondedParameters(AmberParameters* amberParameters, ForceField*
 			epsilonProduct = 0;
 		}
 
-	        if ( getNonBondedParameters( amberParameters, a4Type, &equilibriumDistance, &epsilon ) )
+	        if ( getNonBondedParameters( amberParameters, index, a4Type, &equilibriumDistance, &epsilon ) )
 		{
 	        	epsilonProduct *= sqrt(fabs(epsilon));
 	        	rj = equilibriumDistance;
@@ -1171,7 +1153,7 @@ static void setNonBondedParameters(AmberParameters* amberParameters, ForceField*
        		forceField->nonBondedTerms[i] = nonBondedTerms[i]; 
 }
 /**********************************************************************/
-static void setPairWiseParameters(AmberParameters* amberParameters, ForceField* forceField,gint* atomTypes)
+static void setPairWiseParameters(AmberParameters* amberParameters, AmberParametersIndex* index, ForceField* forceField,gint* atomTypes)
 {
 	gint numberOfPairWise = 0;
 	gint i;
@@ -1204,7 +1186,7 @@ static void setPairWiseParameters(AmberParameters* amberParameters, ForceField*
 		a1Type = atomTypes[a1];
 		a2Type = atomTypes[a2];
 
-		if ( ! ( getPairWiseParameters(amberParameters, a1Type,a2Type,&a, &beta,&c6,&c8, &c10,&b) ) )
+		if ( ! ( getPairWiseParameters(amberParameters, index, a1Type,a2Type,&a, &beta,&c6,&c8, &c10,&b) ) )
 				printf( _("**** couldn't find pair wise parameters for %s-%s\n"),
 					m->atoms[a1].mmType, m->atoms[a2].mmType);
 		
@@ -1235,7 +1217,7 @@ static void setPairWiseParameters(AmberParameters* amberParameters, ForceField*
        		forceField->pairWiseTerms[i] = pairWiseTerms[i]; 
 }
 /**********************************************************************/
-static void setAtomTypes(AmberParameters* amberParameters,ForceField* forceField,gint* atomTypes)
+static void setAtomTypes(AmberParameters* amberParameters, AmberParametersIndex* index, ForceField* forceField,gint* atomTypes)
 {
 	Molecule* m = &forceField->molecule;
 	gint nAtoms = m->nAtoms;
@@ -1243,7 +1225,7 @@ static void setAtomTypes(AmberParameters* amberParameters,ForceField* forceField
 	for(i=0;i<nAtoms;i++)
 	{ 
 		/* printf("Atom %s=",m->atoms[i].mmType); */
-		atomTypes[i] = getNumberType(amberParameters, m->atoms[i].mmType);
+		atomTypes[i] = getNumberType(index, m->atoms[i].mmType);
 		/*
 		{
 			gint j;
@@ -1271,6 +1253,7 @@ static void setAmberParameters(ForceField* forceField)
 	Molecule* m = &forceField->molecule;
 	gint* atomTypes = g_malloc(m->nAtoms*sizeof(gint));
 	AmberParameters amberParameters;
+	AmberParametersIndex index;
 
 
 
@@ -1301,42 +1284,35 @@ static void setAmberParameters(ForceField* forceField)
 
 	}
 
-	setAtomTypes(&amberParameters,forceField,atomTypes);
+	/* the tables can be edited between two models : the index is compiled for each setting */
+	index = newAmberParametersIndex(&amberParameters);
+	setAtomTypes(&amberParameters,&index,forceField,atomTypes);
     	while( gtk_events_pending() )
         	gtk_main_iteration();
-	if(StopCalcul)
-	{
-		return;
-	}
 
     	while( gtk_events_pending() ) gtk_main_iteration();
-	if(forceField->options.bondStretch) setStretchParameters(&amberParameters,forceField,atomTypes);
-	if(StopCalcul) return;
+	if(!StopCalcul && forceField->options.bondStretch) setStretchParameters(&amberParameters,&index,forceField,atomTypes);
     	while( gtk_events_pending() ) gtk_main_iteration();
 
-	if(forceField->options.angleBend) setBendParameters(&amberParameters,forceField,atomTypes);
-	if(StopCalcul) return;
+	if(!StopCalcul && forceField->options.angleBend) setBendParameters(&amberParameters,&index,forceField,atomTypes);
     	while( gtk_events_pending() ) gtk_main_iteration();
 
-	if(forceField->options.dihedralAngle) setDihedralParameters(&amberParameters, forceField,atomTypes);
-	if(StopCalcul) return;
+	if(!StopCalcul && forceField->options.dihedralAngle) setDihedralParameters(&amberParameters,&index,forceField,atomTypes);
     	while( gtk_events_pending() ) gtk_main_iteration();
 
-	if(forceField->options.improperTorsion) setImproperTorionParameters(&amberParameters,forceField,atomTypes);
-	if(StopCalcul) return;
+	if(!StopCalcul && forceField->options.improperTorsion) setImproperTorionParameters(&amberParameters,&index,forceField,atomTypes);
     	while( gtk_events_pending() ) gtk_main_iteration();
 
-	if(forceField->options.hydrogenBonded) setHydrogenBondedParameters(&amberParameters,forceField,atomTypes);
-	if(StopCalcul) return;
+	if(!StopCalcul && forceField->options.hydrogenBonded) setHydrogenBondedParameters(&amberParameters,&index,forceField,atomTypes);
     	while( gtk_events_pending() ) gtk_main_iteration();
 	
-	if(forceField->options.nonBonded) setNonBondedParameters(&amberParameters,forceField,atomTypes);
-	if(StopCalcul) return;
+	if(!StopCalcul && forceField->options.nonBonded) setNonBondedParameters(&amberParameters,&index,forceField,atomTypes);
     	while( gtk_events_pending() ) gtk_main_iteration();
 
-	if(forceField->options.rattleConstraints!=NOCONSTRAINTS) setRattleConstraintsParameters(forceField);
-	if(StopCalcul) return;
+	if(!StopCalcul && forceField->options.rattleConstraints!=NOCONSTRAINTS) setRattleConstraintsParameters(forceField);
     	while( gtk_events_pending() ) gtk_main_iteration();
+	freeAmberParametersIndex(&index);
+	g_free(atomTypes);
 	
 
 	/*
@@ -1349,6 +1325,7 @@ static void setAllPairWiseParameters(ForceField* forceField)
 	Molecule* m = &forceField->molecule;
 	gint* atomTypes = g_malloc(m->nAtoms*sizeof(gint));
 	AmberParameters amberParameters;
+	AmberParametersIndex index;
 
 
 
@@ -1380,26 +1357,20 @@ static void setAllPairWiseParameters(ForceField* forceField)
 	}
 	
 
-	setAtomTypes(&amberParameters,forceField,atomTypes);
+	index = newAmberParametersIndex(&amberParameters);
+	setAtomTypes(&amberParameters,&index,forceField,atomTypes);
 	
-    	while( gtk_events_pending() )
-        	gtk_main_iteration();
-	if(StopCalcul)
-	{
-		return;
-	}
-
     	while( gtk_events_pending() )
         	gtk_main_iteration();
 
 		
-	setPairWiseParameters(&amberParameters,forceField,atomTypes);
-	if(StopCalcul) return;
+	if(!StopCalcul) setPairWiseParameters(&amberParameters,&index,forceField,atomTypes);
 	while( gtk_events_pending() ) gtk_main_iteration();
 
-	if(forceField->options.rattleConstraints!=NOCONSTRAINTS) setRattleConstraintsParameters(forceField);
-	if(StopCalcul) return;
+	if(!StopCalcul && forceField->options.rattleConstraints!=NOCONSTRAINTS) setRattleConstraintsParameters(forceField);
     	while( gtk_events_pending() ) gtk_main_iteration();
+	freeAmberParametersIndex(&index);
+	g_free(atomTypes);
 
 	/*
 	freeAmberParameters(&amberParameters);
@@ -1446,18 +1417,13 @@ static void calculateGradientBondAmber(ForceField* forceField)
 		forceix = term * rijx;
 		forceiy = term * rijy;
 		forceiz = term * rijz;
-#ifdef ENABLE_OMP
-#pragma omp critical
-#endif
-		{
-		m->gradient[0][ai] -= forceix;
-		m->gradient[1][ai] -= forceiy;
-		m->gradient[2][ai] -= forceiz;
+		ADDGRADIENT(m->gradient[0][ai], -forceix);
+		ADDGRADIENT(m->gradient[1][ai], -forceiy);
+		ADDGRADIENT(m->gradient[2][ai], -forceiz);
 		
-		m->gradient[0][aj] += forceix;
-		m->gradient[1][aj] += forceiy;
-		m->gradient[2][aj] += forceiz;
-		}
+		ADDGRADIENT(m->gradient[0][aj], forceix);
+		ADDGRADIENT(m->gradient[1][aj], forceiy);
+		ADDGRADIENT(m->gradient[2][aj], forceiz);
 	} 
 }
 /**********************************************************************/
@@ -1582,22 +1548,17 @@ static void calculateGradientBendAmber(ForceField* forceField)
 			forceky = term * term2ky;
 			forcekz = term * term2kz;
 			
-#ifdef ENABLE_OMP
-#pragma omp critical
-#endif
-			{
-			m->gradient[0][ai] -= forceix;
-			m->gradient[1][ai] -= forceiy;
-			m->gradient[2][ai] -= forceiz;
+			ADDGRADIENT(m->gradient[0][ai], -forceix);
+			ADDGRADIENT(m->gradient[1][ai], -forceiy);
+			ADDGRADIENT(m->gradient[2][ai], -forceiz);
 			
-			m->gradient[0][aj] -= forcejx;
-			m->gradient[1][aj] -= forcejy;
-			m->gradient[2][aj] -= forcejz;
+			ADDGRADIENT(m->gradient[0][aj], -forcejx);
+			ADDGRADIENT(m->gradient[1][aj], -forcejy);
+			ADDGRADIENT(m->gradient[2][aj], -forcejz);
 			
-			m->gradient[0][ak] -= forcekx;
-			m->gradient[1][ak] -= forceky;
-			m->gradient[2][ak] -= forcekz;
-			}
+			ADDGRADIENT(m->gradient[0][ak], -forcekx);
+			ADDGRADIENT(m->gradient[1][ak], -forceky);
+			ADDGRADIENT(m->gradient[2][ak], -forcekz);
 		}
 	} 
 }
@@ -1761,26 +1722,21 @@ static void calculateGradientDihedralAmber(ForceField* forceField)
 		forcely = rkjx*dedzu - rkjz*dedxu;
 		forcelz = rkjy*dedxu - rkjx*dedyu;
 
-#ifdef ENABLE_OMP
-#pragma omp critical
-#endif
-		{
-		m->gradient[0][ai] += forceix;
-		m->gradient[1][ai] += forceiy;
-		m->gradient[2][ai] += forceiz;
+		ADDGRADIENT(m->gradient[0][ai], forceix);
+		ADDGRADIENT(m->gradient[1][ai], forceiy);
+		ADDGRADIENT(m->gradient[2][ai], forceiz);
 
-		m->gradient[0][aj] += forcejx;
-		m->gradient[1][aj] += forcejy;
-		m->gradient[2][aj] += forcejz;
+		ADDGRADIENT(m->gradient[0][aj], forcejx);
+		ADDGRADIENT(m->gradient[1][aj], forcejy);
+		ADDGRADIENT(m->gradient[2][aj], forcejz);
 
-		m->gradient[0][ak] += forcekx;
-		m->gradient[1][ak] += forceky;
-		m->gradient[2][ak] += forcekz;
+		ADDGRADIENT(m->gradient[0][ak], forcekx);
+		ADDGRADIENT(m->gradient[1][ak], forceky);
+		ADDGRADIENT(m->gradient[2][ak], forcekz);
 
-		m->gradient[0][al] += forcelx;
-		m->gradient[1][al] += forcely;
-		m->gradient[2][al] += forcelz;
-		}
+		ADDGRADIENT(m->gradient[0][al], forcelx);
+		ADDGRADIENT(m->gradient[1][al], forcely);
+		ADDGRADIENT(m->gradient[2][al], forcelz);
 	}
 }
 /**********************************************************************/
@@ -1868,17 +1824,12 @@ static void calculateGradientNonBondedAmber(ForceField* forceField)
 		forcejx = - forceix;
 		forcejy = - forceiy;
 		forcejz = - forceiz;
-#ifdef ENABLE_OMP
-#pragma omp critical
-#endif
-		{
-		m->gradient[0][ai] -= forceix;
-		m->gradient[1][ai] -= forceiy;
-		m->gradient[2][ai] -= forceiz;
-		m->gradient[0][aj] -= forcejx;
-		m->gradient[1][aj] -= forcejy;
-		m->gradient[2][aj] -= forcejz;
-		}
+		ADDGRADIENT(m->gradient[0][ai], -forceix);
+		ADDGRADIENT(m->gradient[1][ai], -forceiy);
+		ADDGRADIENT(m->gradient[2][ai], -forceiz);
+		ADDGRADIENT(m->gradient[0][aj], -forcejx);
+		ADDGRADIENT(m->gradient[1][aj], -forcejy);
+		ADDGRADIENT(m->gradient[2][aj], -forcejz);
 	}  
 }
 /*********************************************************************/
@@ -1941,17 +1892,12 @@ static void calculateGradientHydrogenBondedAmber(ForceField* forceField)
 		forcejx = - forceix;
 		forcejy = - forceiy;
 		forcejz = - forceiz;
-#ifdef ENABLE_OMP
-#pragma omp critical
-#endif
-		{
-		m->gradient[0][ai] -= forceix;
-		m->gradient[1][ai] -= forceiy;
-		m->gradient[2][ai] -= forceiz;
-		m->gradient[0][aj] -= forcejx;
-		m->gradient[1][aj] -= forcejy;
-		m->gradient[2][aj] -= forcejz;
-		}
+		ADDGRADIENT(m->gradient[0][ai], -forceix);
+		ADDGRADIENT(m->gradient[1][ai], -forceiy);
+		ADDGRADIENT(m->gradient[2][ai], -forceiz);
+		ADDGRADIENT(m->gradient[0][aj], -forcejx);
+		ADDGRADIENT(m->gradient[1][aj], -forcejy);
+		ADDGRADIENT(m->gradient[2][aj], -forcejz);
 	}
 }
 /**********************************************************************/
@@ -43,6 +43,8 @@ DEALINGS IN THE SOFTWARE.
 #include "../MolecularMechanics/SteepestDescent.h"
 #include "../MolecularMechanics/QuasiNewton.h"
 #include "../MolecularMechanics/MolecularDynamics.h"
+#include "../MolecularMechanics/ConformersOptimization.h"
+#include "../MolecularMechanics/FiniteDifferences.h"
 
 typedef enum
 {
@@ -877,185 +879,6 @@ static gboolean runFireFlyFiles(gint numberOfGeometries, ForceField** geometries
 
 }
 /*****************************************************************************/
-static gboolean testEqualDistances(gdouble* distancesI, gdouble* distancesJ, gint n, gdouble tol)
-{
-	gint k;
-	if(!distancesI) return FALSE;
-	if(!distancesJ) return FALSE;
-	if(n<1) return FALSE;
-	for (  k = 0; k < n; k++ )
-		if(fabs(distancesI[k]-distancesJ[k])>tol) return FALSE;
-	return TRUE;
-}
-/*****************************************************************************/
-static gdouble* getDistancesBetweenAtoms(ForceField* forceField)
-{
-	gdouble* distances = NULL;
-	gint i;
-	gint j;
-	gint n;
-	gint k;
-	if(forceField->molecule.nAtoms<1) return distances;
-	n = forceField->molecule.nAtoms*(forceField->molecule.nAtoms-1)/2;
-	distances = g_malloc(n*sizeof(gdouble));
-	n = 0;
-	for (  i = 0; i < forceField->molecule.nAtoms-1; i++ )
-	for (  j = i+1; j < forceField->molecule.nAtoms; j++ )
-	{
-		gdouble x = forceField->molecule.atoms[i].coordinates[0]-forceField->molecule.atoms[j].coordinates[0];
-		gdouble y = forceField->molecule.atoms[i].coordinates[1]-forceField->molecule.atoms[j].coordinates[1];
-		gdouble z = forceField->molecule.atoms[i].coordinates[2]-forceField->molecule.atoms[j].coordinates[2];
-		distances[n++] = x*x + y*y + z*z;
-	}
-	for(i=0;i<n-1;i++)
-	{
-		k = i;
-		for(j=i+1;j<n;j++)
-			if(distances[j]<distances[k]) k= j;
-		if(k!=i)
-		{
-			gdouble d = distances[i];
-			distances[i] = distances[k];
-			distances[k] = d;
-		}
-	}
-	return distances;
-}
-/*****************************************************************************/
-static void removedsToEnd(gint numberOfGeometries, ForceField** geometries, gdouble* energies, gboolean* removeds)
-{
-	if(geometries && energies && removeds)
-	{
-		gint i;
-		gint j;
-		gint k;
-		for(i=0;i<numberOfGeometries-1;i++)
-		{
-			if(!removeds[i]) continue;
-			k = i;
-			for(j=i+1;j<numberOfGeometries;j++)
-				if(!removeds[j]) { k= j; break;}
-			if(k!=i)
-			{
-				gdouble energy = energies[i];
-				gboolean r = removeds[i];
-				ForceField* g = geometries[i];
-
-				energies[i] = energies[k];
-				energies[k] = energy;
-				geometries[i] = geometries[k];
-				geometries[k] = g;
-				removeds[i] = removeds[k];
-				removeds[k] = r;
-			}
-		}
-	}
-}
-/*****************************************************************************/
-static void computeRemoveds(gint numberOfGeometries, ForceField** geometries, gdouble* energies, gboolean *removeds, 
-		gdouble tolEnergy, gdouble tolDistance)
-{
-	gint i;
-	gint j;
-	gdouble* distancesI = NULL;
-	gdouble* distancesJ = NULL;
-	if(tolDistance<=0 && tolEnergy<=0) return;
-	if(!geometries || !energies) return;
-	if(numberOfGeometries<1) return;
-	for(i=0;i<numberOfGeometries-1;i++)
-	{
-		gint n;
-		if(removeds[i]) continue;
-		if(tolDistance>0) distancesI =  getDistancesBetweenAtoms(geometries[i]);
-		n = geometries[i]->molecule.nAtoms*(geometries[i]->molecule.nAtoms-1)/2;
-		for(j=i+1;j<numberOfGeometries;j++)
-		{
-			if(removeds[j]) continue;
-			if(tolEnergy>0 && fabs(energies[j]-energies[i])<tolEnergy && geometries[i]->molecule.nAtoms==geometries[j]->molecule.nAtoms)
-			{
-				if(tolDistance>0) 
-				{
-					distancesJ =  getDistancesBetweenAtoms(geometries[j]);
-					if(testEqualDistances(distancesI, distancesJ, n, tolDistance))
-						removeds[j] = TRUE;
-					if(distancesJ) g_free(distancesJ);
-					distancesJ = NULL;
-				}
-				else
-					removeds[j] = TRUE;
-			}
-			if(tolEnergy<0 && tolDistance>0 && geometries[i]->molecule.nAtoms==geometries[j]->molecule.nAtoms)
-			{
-				distancesJ =  getDistancesBetweenAtoms(geometries[j]);
-				if(testEqualDistances(distancesI, distancesJ, n, tolDistance))
-					removeds[j] = TRUE;
-				if(distancesJ) g_free(distancesJ);
-				distancesJ = NULL;
-			}
-		}
-		if(distancesI) g_free(distancesI);
-		distancesI = NULL;
-	}
-
-}
-/*****************************************************************************/
-static void removeIdenticalGeometries(gint* nG, ForceField*** geoms, gdouble** eners, gdouble tolEnergy, gdouble tolDistance)
-{
-	gint i;
-	gint numberOfGeometries =*nG;
-	ForceField** geometries = *geoms; 
-	gdouble* energies = *eners;
-	gboolean* removeds = NULL;
-	gint newN = 0;
-	if(numberOfGeometries<1) return;
-	removeds = g_malloc(numberOfGeometries*sizeof(gboolean));
-	for(i=0;i<numberOfGeometries;i++) removeds[i] = FALSE;
-	computeRemoveds(numberOfGeometries, geometries, energies, removeds, tolEnergy, tolDistance);
-	removedsToEnd(numberOfGeometries, geometries, energies, removeds);
-
-	for(i=0;i<numberOfGeometries;i++) 
-	{
-		if(removeds[i]) 
-		{
-			if(geometries[i]) freeForceField(geometries[i]);
-		}
-		else newN++;
-	}
-	if(newN==0) newN = 1;
-	if(newN==numberOfGeometries) return;
-	*nG = newN;
-	*eners = g_realloc(*eners,newN*sizeof(gdouble));
-	*geoms = g_realloc(*geoms,newN*sizeof(ForceField**));
-
-	g_free(removeds);
-}
-/*****************************************************************************/
-static void sortGeometries(gint numberOfGeometries, ForceField** geometries, gdouble* energies)
-{
-	if(geometries && energies)
-	{
-		gint i;
-		gint j;
-		gint k;
-		for(i=0;i<numberOfGeometries-1;i++)
-		{
-			k = i;
-			for(j=i+1;j<numberOfGeometries;j++)
-				if(energies[j]<energies[k]) k= j;
-			if(k!=i)
-			{
-				gdouble energy = energies[i];
-				ForceField* g = geometries[i];
-
-				energies[i] = energies[k];
-				energies[k] = energy;
-				geometries[i] = geometries[k];
-				geometries[k] = g;
-			}
-		}
-	}
-}
-/*****************************************************************************/
 static void createPostProcessingFiles(gint numberOfGeometries, ForceField** geometries,gdouble* energies,gchar* fileNameGeom, gchar* mopacKeywords, gchar* gaussianKeywords, gchar* fireflyKeywords, gchar* message)
 {
 	if(!StopCalcul && mopacKeywords)
@@ -1119,17 +942,15 @@ static void amberMolecularDynamicsConfo(GtkWidget* Win, gpointer data)
 	gboolean useConjugateGradient;
 	gboolean useQuasiNewton;
 	ConjugateGradientOptions conjugateGradientOptions;
-	SteepestDescent steepestDescent;
-	ConjugateGradient conjugateGradient;
 	gint i;
 	gchar message[BSIZE]="Created files :\n";
 	gdouble tolEnergy = -1;
 	gdouble tolDistance = -1;
 
 	if(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonTolerance[TOLE])))
-		tolEnergy = atoi(gtk_entry_get_text(GTK_ENTRY(entryTolerance[TOLE])));
+		tolEnergy = atof(gtk_entry_get_text(GTK_ENTRY(entryTolerance[TOLE])));
 	if(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonTolerance[TOLD])))
-		tolDistance = atoi(gtk_entry_get_text(GTK_ENTRY(entryTolerance[TOLD])));
+		tolDistance = atof(gtk_entry_get_text(GTK_ENTRY(entryTolerance[TOLD])));
 
 	forceFieldOptions.type = AMBER;
 	forceFieldOptions.bondStretch = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonMMOptions[MMBOND]));
@@ -1341,81 +1162,23 @@ static void amberMolecularDynamicsConfo(GtkWidget* Win, gpointer data)
 		energies = g_malloc(numberOfGeometries*sizeof(gdouble));
 
 	if(!StopCalcul && geometries && optMM)
-	for(i=0;i<numberOfGeometries;i++)
 	{
-		gchar* str = NULL;
-		energies[i] = 1e30;
-		if(!geometries[i]) continue;
-		if(str) g_free(str);
-		str = g_strdup_printf("Minimization of geometry number %d ", i+1);
-		set_text_to_draw(str);
-		drawGeom();
-    		while( gtk_events_pending() ) gtk_main_iteration();
-		Waiting(1);
-		if(str) g_free(str);
-
-
+		ConformersOptimization confoOptimization;
+		initConformersOptimization(&confoOptimization);
+		confoOptimization.conjugateGradientOptions = conjugateGradientOptions;
+		confoOptimization.quasiNewton = quasiNewton;
+		if(useConjugateGradient) confoOptimization.optimizer = CONFOCONJUGATE;
+		else if(useQuasiNewton) confoOptimization.optimizer = CONFOQUASINEWTON;
+		else confoOptimization.optimizer = CONFOSTEEPEST;
+		set_sensitive_stop_button( TRUE);
+		runConformersOptimization(&confoOptimization, numberOfGeometries, geometries, energies);
 		if(StopCalcul)
 		{
 			set_text_to_draw(" ");
 			set_statubar_operation_str(_("Calculation canceled"));
 			drawGeom();
-			set_sensitive_stop_button( FALSE);
-			break;
 		}
-		if(useConjugateGradient)
-		{
-			set_sensitive_stop_button( TRUE);
-			runConjugateGradient(&conjugateGradient, geometries[i], conjugateGradientOptions); 
-			if(StopCalcul)
-			{
-				set_text_to_draw(" ");
-				set_statubar_operation_str(_("Calculation canceled"));
-				drawGeom();
-			}
-			set_sensitive_stop_button( FALSE);
-			energies[i] = conjugateGradient.forceField->klass->calculateEnergyTmp
-				(conjugateGradient.forceField, &conjugateGradient.forceField->molecule );
-			freeConjugateGradient(&conjugateGradient);
-		}
-		else if(useQuasiNewton)
-		{
-			QuasiNewton tmpQuasiNewton = quasiNewton;
-			set_sensitive_stop_button( TRUE);
-			tmpQuasiNewton.forceField = geometries[i];
-                	runQuasiNewton(&tmpQuasiNewton);
-			if(StopCalcul)
-			{
-				set_text_to_draw(" ");
-				set_statubar_operation_str(_("Calculation canceled"));
-				drawGeom();
-			}
-			set_sensitive_stop_button( FALSE);
-			energies[i] = tmpQuasiNewton.forceField->klass->calculateEnergyTmp
-				(tmpQuasiNewton.forceField, &tmpQuasiNewton.forceField->molecule );
-			freeQuasiNewton(&tmpQuasiNewton);
-
-		}
-		else
-		{
-			set_sensitive_stop_button( TRUE);
-			runSteepestDescent(&steepestDescent, geometries[i],
-			       	conjugateGradientOptions.updateFrequency,
-			       conjugateGradientOptions.maxIterations,
-			       conjugateGradientOptions.gradientNorm,
-			       conjugateGradientOptions.maxLines);
-			if(StopCalcul)
-			{
-				set_text_to_draw(" ");
-				set_statubar_operation_str(_("Calculation canceled"));
-				drawGeom();
-			}
-			set_sensitive_stop_button( FALSE);
-			energies[i] = steepestDescent.forceField->klass->calculateEnergyTmp
-				(steepestDescent.forceField, &steepestDescent.forceField->molecule );
-			freeSteepestDescent(&steepestDescent);
-		}
-		set_text_to_draw(" ");
+		set_sensitive_stop_button( FALSE);
 	}
 	else if(!StopCalcul)
 	{
@@ -1440,8 +1203,8 @@ static void amberMolecularDynamicsConfo(GtkWidget* Win, gpointer data)
 	/*  sort by energies */
 	if(!StopCalcul) 
 	{
-		sortGeometries(numberOfGeometries, geometries, energies);
-		removeIdenticalGeometries(&numberOfGeometries, &geometries, &energies,tolEnergy,tolDistance);
+		sortConformers(numberOfGeometries, geometries, energies);
+		removeIdenticalConformers(&numberOfGeometries, &geometries, &energies,tolEnergy,tolDistance);
 	}
 	/* printf("fileNameGeom = %s\n",fileNameGeom);*/
 	if(!StopCalcul && saveConfoGeometries(numberOfGeometries, geometries, energies, fileNameGeom))
@@ -1459,8 +1222,8 @@ static void amberMolecularDynamicsConfo(GtkWidget* Win, gpointer data)
 		if(runMopacFiles(numberOfGeometries, geometries, energies, fileNamePrefix, "PM6 XYZ") && !StopCalcul)
 		{
 			gchar* fileNameGeomMop = g_strdup_printf("%sMop.gab",fileNamePrefix);
-			sortGeometries(numberOfGeometries, geometries, energies);
-			removeIdenticalGeometries(&numberOfGeometries, &geometries, &energies,tolEnergy,tolDistance);
+			sortConformers(numberOfGeometries, geometries, energies);
+			removeIdenticalConformers(&numberOfGeometries, &geometries, &energies,tolEnergy,tolDistance);
 			if(saveConfoGeometries(numberOfGeometries, geometries, energies, fileNameGeomMop))
 			{
 				createPostProcessingFiles(numberOfGeometries, geometries,energies,fileNameGeomMop, mopacKeywords, gaussianKeywords, fireflyKeywords, message);
@@ -1481,8 +1244,8 @@ static void amberMolecularDynamicsConfo(GtkWidget* Win, gpointer data)
 		if(runMopacFiles(numberOfGeometries, geometries, energies, fileNamePrefix, "AM1 XYZ") && !StopCalcul)
 		{
 			gchar* fileNameGeomMop = g_strdup_printf("%sMop.gab",fileNamePrefix);
-			sortGeometries(numberOfGeometries, geometries, energies);
-			removeIdenticalGeometries(&numberOfGeometries, &geometries, &energies,tolEnergy,tolDistance);
+			sortConformers(numberOfGeometries, geometries, energies);
+			removeIdenticalConformers(&numberOfGeometries, &geometries, &energies,tolEnergy,tolDistance);
 			if(saveConfoGeometries(numberOfGeometries, geometries, energies, fileNameGeomMop))
 			{
 				createPostProcessingFiles(numberOfGeometries, geometries,energies,fileNameGeomMop, mopacKeywords, gaussianKeywords, fireflyKeywords, message);
@@ -1503,8 +1266,8 @@ static void amberMolecularDynamicsConfo(GtkWidget* Win, gpointer data)
 		if(runFireFlyFiles(numberOfGeometries, geometries, energies, fileNamePrefix, "RUNTYP=Optimize GBASIS=AM1") && !StopCalcul)
 		{
 			gchar* fileNameGeomFireFly = g_strdup_printf("%sFireFly.gab",fileNamePrefix);
-			sortGeometries(numberOfGeometries, geometries, energies);
-			removeIdenticalGeometries(&numberOfGeometries, &geometries, &energies,tolEnergy,tolDistance);
+			sortConformers(numberOfGeometries, geometries, energies);
+			removeIdenticalConformers(&numberOfGeometries, &geometries, &energies,tolEnergy,tolDistance);
 			if(saveConfoGeometries(numberOfGeometries, geometries, energies, fileNameGeomFireFly))
 			{
 				createPostProcessingFiles(numberOfGeometries, geometries,energies,fileNameGeomFireFly, mopacKeywords, gaussianKeywords, fireflyKeywords, message);
@@ -2507,7 +2270,7 @@ static void createPostProcessingFrame(GtkWidget *box)
 /*----------------------------------------------------------------------------------*/
 	i++;
 	j = 0;
-	buttonTolerance[TOLD] = gtk_check_button_new_with_label("Distance tolerance(Angstrom)"); 
+	buttonTolerance[TOLD] = gtk_check_button_new_with_label("RMSD tolerance(Angstrom)"); 
 	gtk_table_attach(GTK_TABLE(table),buttonTolerance[TOLD],
 			j,j+1,i,i+1,
                   (GtkAttachOptions)(GTK_FILL|GTK_SHRINK) ,
@@ -3518,6 +3281,66 @@ void amberEnergyCalculation(GtkWidget* Win, gpointer data)
 	g_free(str);
 }
 /***********************************************************************/
+static void amberFrequencies(GtkWidget* Win, gpointer data)
+{
+	ForceField forceField;
+	ForceFieldOptions forceFieldOptions;
+	FiniteDifferencesOptions fdOptions;
+	FiniteDifferences fd;
+
+	forceFieldOptions.type = AMBER;
+	forceFieldOptions.bondStretch = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonMMOptions[MMBOND]));
+	forceFieldOptions.angleBend = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonMMOptions[MMBEND]));
+	forceFieldOptions.dihedralAngle = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonMMOptions[MMTORSION]));
+	forceFieldOptions.improperTorsion = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonMMOptions[MMIMPROPER]));
+	forceFieldOptions.nonBonded = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonMMOptions[MMNONBOND]));
+	forceFieldOptions.hydrogenBonded = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonMMOptions[MMHBOND]));
+	forceFieldOptions.coulomb = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonMMOptions[MMCOULOMB]));
+	forceFieldOptions.vanderWals = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonMMOptions[PWVANDERWALS]));
+	forceFieldOptions.rattleConstraints = NOCONSTRAINTS;
+
+	if(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonTypesOptions[AMBER])) )
+		forceFieldOptions.type = AMBER;
+	else
+	if(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonTypesOptions[PAIRWISE])) )
+	{
+		forceFieldOptions.coulomb = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonMMOptions[PWCOULOMB]));
+		forceFieldOptions.type = PAIRWISE;
+	}
+	getFiniteDifferencesOptionsFromDlg(Win, &fdOptions);
+
+	gtk_widget_destroy(Win);
+    	while( gtk_events_pending() )
+        	gtk_main_iteration();
+
+	set_sensitive_stop_button( TRUE);
+	StopCalcul = FALSE;
+	if(forceFieldOptions.type==AMBER)
+		forceField = createAmberModel(geometry0,Natoms,forceFieldOptions);
+	else
+	if(forceFieldOptions.type==PAIRWISE)
+		forceField = createPairWiseModel(geometry0,Natoms,forceFieldOptions);
+
+	if(StopCalcul)
+	{
+		set_text_to_draw(" ");
+		set_statubar_operation_str(_("Calculation canceled"));
+		drawGeom();
+		set_sensitive_stop_button( FALSE);
+		return;
+	}
+	fd = newFiniteDifferencesForceField(&forceField, fdOptions);
+	if(runFiniteDifferencesFrequencies(&fd))
+		set_statubar_operation_str(_("Frequencies computed by finite differences of the MM gradients"));
+	else
+		set_statubar_operation_str(_("Calculation canceled"));
+	freeFiniteDifferences(&fd);
+	set_text_to_draw(" ");
+	drawGeom();
+	set_sensitive_stop_button( FALSE);
+	freeForceField(&forceField);
+}
+/***********************************************************************/
 void sensitive_conjugate_gradient_buttons(GtkWidget *button, gpointer data)
 {
 	gboolean useConjugateGradient;
@@ -4009,6 +3832,49 @@ void MolecularMechanicsMinimizeDlg()
   
 
 
+	gtk_widget_show_all(Win);
+  
+}
+/***********************************************************************/
+void MolecularMechanicsFrequenciesDlg()
+{
+	GtkWidget *button;
+	GtkWidget *Win;
+	GtkWidget *NoteBook;
+	GtkWidget *parentWindow = GeomDlg;
+
+	StopCalcul = TRUE;
+
+	Win= gtk_dialog_new ();
+	gtk_window_set_position(GTK_WINDOW(Win),GTK_WIN_POS_CENTER);
+	gtk_window_set_transient_for(GTK_WINDOW(Win),GTK_WINDOW(parentWindow));
+	gtk_window_set_title(&GTK_DIALOG(Win)->window,"Molecular Mechanics Frequencies");
+    	gtk_window_set_modal (GTK_WINDOW (Win), TRUE);
+
+	g_signal_connect(G_OBJECT(Win),"delete_event",(GCallback)DestroyWinMMDlg,NULL);
+ 
+	NoteBook = gtk_notebook_new();
+	gtk_box_pack_start(GTK_BOX (gtk_dialog_get_content_area(GTK_DIALOG(Win))), NoteBook,TRUE, TRUE, 0);
+
+	addFiniteDifferencesOptionsDlg(NoteBook, Win);
+	AddMMOptionsDlg(NoteBook);
+  
+
+	gtk_widget_realize(Win);
+
+	button = create_button(Win,"Cancel");
+	GTK_WIDGET_SET_FLAGS(button, GTK_CAN_DEFAULT);
+	gtk_box_pack_start (GTK_BOX( gtk_dialog_get_action_area(GTK_DIALOG(Win))), button, TRUE, TRUE, 0);
+	g_signal_connect_swapped(GTK_OBJECT(button), "clicked", G_CALLBACK(DestroyWinMMDlg),GTK_OBJECT(Win));
+	gtk_widget_show (button);
+
+	button = create_button(Win,"Ok");
+	GTK_WIDGET_SET_FLAGS(button, GTK_CAN_DEFAULT);
+	gtk_box_pack_start (GTK_BOX( gtk_dialog_get_action_area(GTK_DIALOG(Win))), button, TRUE, TRUE, 0);
+	g_signal_connect_swapped(GTK_OBJECT(button), "clicked", (GCallback)amberFrequencies,GTK_OBJECT(Win));
+	gtk_widget_show (button);
+
+
 	gtk_widget_show_all(Win);
   
 }
@@ -22,6 +22,7 @@ DEALINGS IN THE SOFTWARE.
 
 void MolecularMechanicsEnergyDlg();
 void MolecularMechanicsMinimizeDlg();
+void MolecularMechanicsFrequenciesDlg();
 void MolecularMechanicsDynamicsDlg();
 void MolecularMechanicsDynamicsConfoDlg();
 
@@ -19,6 +19,9 @@ DEALINGS IN THE SOFTWARE.
 #include "../../Config.h"
 #include <stdlib.h>
 #include <math.h>
+#ifdef ENABLE_OMP
+#include <omp.h>
+#endif
 
 #include "../Common/Global.h"
 #include "../Utils/AtomsProp.h"
@@ -30,8 +33,6 @@ DEALINGS IN THE SOFTWARE.
 void rafresh_window_geom();
 void create_GeomXYZ_from_draw_grometry();
 
-static gboolean** bondedMatrix = NULL;
-
 #define BOHR_TO_ANG  0.52917726
 
 /**********************************************************************/
@@ -120,50 +121,62 @@ void freeMolecule(Molecule* molecule)
 		}
 }
 /*****************************************************************************/
-void createBondedMatrix(Molecule* molecule)
+/* Bonded graph in compressed rows : the neighbours of atom a are neighbours[first[a]..first[a+1]-1],
+ * in increasing order, and bonds[] gives the index of the corresponding 2 connection.
+ */
+typedef struct _BondedGraph
 {
-	gint nAtoms = molecule->nAtoms;
-	gint i;
-	gint j;
-
-	if(nAtoms<1)
-		return;
-
-	bondedMatrix = g_malloc(nAtoms*sizeof(gboolean*));
-	for(i=0;i<nAtoms;i++)
-		bondedMatrix[i] = g_malloc(nAtoms*sizeof(gboolean));
-
-	for(i=0;i<nAtoms;i++)
-	{
-		for(j=0;j<nAtoms;j++)
-			bondedMatrix[i][j] = FALSE;
-
-		bondedMatrix[i][i] = TRUE;
-	}
-
-}
+	gint nAtoms;
+	gint* first;
+	gint* neighbours;
+	gint* bonds;
+}BondedGraph;
 /*****************************************************************************/
-void freeBondedMatrix(Molecule* molecule)
+static BondedGraph newBondedGraph(Molecule* molecule)
 {
+	BondedGraph graph;
 	gint nAtoms = molecule->nAtoms;
+	gint nBonds = molecule->numberOf2Connections;
+	gint* pos;
 	gint i;
+	gint k;
 
-	if(bondedMatrix == NULL)
-	       return;
-	for(i=0;i<nAtoms;i++)
-		if(bondedMatrix[i] != NULL)
-		       	g_free(bondedMatrix[i]);
-
-	g_free(bondedMatrix);
-	bondedMatrix = NULL;
+	graph.nAtoms = nAtoms;
+	graph.first = g_malloc((nAtoms+1)*sizeof(gint));
+	graph.neighbours = g_malloc((2*nBonds+1)*sizeof(gint));
+	graph.bonds = g_malloc((2*nBonds+1)*sizeof(gint));
+	for(i=0;i<=nAtoms;i++) graph.first[i] = 0;
+	for(k=0;k<nBonds;k++)
+	{
+		graph.first[molecule->connected2[0][k]+1]++;
+		graph.first[molecule->connected2[1][k]+1]++;
+	}
+	for(i=0;i<nAtoms;i++) graph.first[i+1] += graph.first[i];
 
+	/* the 2 connections are sorted by (i,j), i<j : the rows are filled in increasing order */
+	pos = g_malloc((nAtoms+1)*sizeof(gint));
+	for(i=0;i<=nAtoms;i++) pos[i] = graph.first[i];
+	for(k=0;k<nBonds;k++)
+	{
+		gint a1 = molecule->connected2[0][k];
+		gint a2 = molecule->connected2[1][k];
+		graph.neighbours[pos[a1]] = a2;
+		graph.bonds[pos[a1]++] = k;
+		graph.neighbours[pos[a2]] = a1;
+		graph.bonds[pos[a2]++] = k;
+	}
+	g_free(pos);
+	return graph;
 }
 /*****************************************************************************/
-void updatebondedMatrix(gint a1, gint a2)
+static void freeBondedGraph(BondedGraph* graph)
 {
-	bondedMatrix[a1][a2] = TRUE;
-	bondedMatrix[a2][a1] = TRUE;
-
+	if(graph->first) g_free(graph->first);
+	if(graph->neighbours) g_free(graph->neighbours);
+	if(graph->bonds) g_free(graph->bonds);
+	graph->first = NULL;
+	graph->neighbours = NULL;
+	graph->bonds = NULL;
 }
 /*****************************************************************************/
 gboolean isConnected2(Molecule* molecule,gint i,gint j)
@@ -197,11 +210,11 @@ void set2Connections(Molecule* molecule)
 	gint i;
 	gint j;
 	gint k=0;
+	gint nMax = molecule->nAtoms+1;
 
-	k = molecule->nAtoms;
-	k = k*(k-1)/2;
+	/* the number of bonds is linear in the number of atoms : the lists grow when needed */
 	for(i=0;i<2;i++)
-		molecule->connected2[i] = g_malloc(k*sizeof(gint));
+		molecule->connected2[i] = g_malloc(nMax*sizeof(gint));
 
 	k=0;
 	for(i=0;i<molecule->nAtoms-1;i++)
@@ -209,11 +222,15 @@ void set2Connections(Molecule* molecule)
 	{
 		if(isConnected2(molecule,i,j))
 		{
+			if(k>=nMax)
+			{
+				nMax *= 2;
+				molecule->connected2[0] = g_realloc(molecule->connected2[0],nMax*sizeof(gint));
+				molecule->connected2[1] = g_realloc(molecule->connected2[1],nMax*sizeof(gint));
+			}
 			molecule->connected2[0][k]= i;
 			molecule->connected2[1][k]= j;
 
-			updatebondedMatrix(i,j);
-
 			k++;
 
 		}
@@ -251,72 +268,61 @@ static void permut(gint* a,gint *b)
 	*b = c;
 }
 /*****************************************************************************/
-gboolean  isConnected3(Molecule* molecule,gint n,gint i,gint j, gint k)
-{
-	gint c;
-	gint a1,a2,a3;
-	for(c=0;c<n;c++)
-	{
-		a1 =  molecule->connected3[0][c];
-		a2 =  molecule->connected3[1][c];
-		a3 =  molecule->connected3[2][c];
-		if(a1==i && a2 == j && a3 == k)
-			return TRUE;
-	}
-	return FALSE;
-
-}
-/*****************************************************************************/
-gboolean  connect3(Molecule* molecule,gint n,gint i,gint j, gint k)
+static void connect3(Molecule* molecule,gint n,gint i,gint j, gint k)
 {
 	if(i>k)permut(&i,&k);
-	if(!isConnected3(molecule,n,i,j,k))
-	{
-		molecule->connected3[0][n]= i;
-		molecule->connected3[1][n]= j;
-		molecule->connected3[2][n]= k;
-
-		updatebondedMatrix(i,j);
-		updatebondedMatrix(i,k);
-		updatebondedMatrix(j,k);
-
-		return TRUE;
-	}
-	return FALSE;
-
+	molecule->connected3[0][n]= i;
+	molecule->connected3[1][n]= j;
+	molecule->connected3[2][n]= k;
 }
 /*****************************************************************************/
-void set3Connections(Molecule* molecule)
+static void set3Connections(Molecule* molecule, BondedGraph* graph)
 {
 	gint i;
 	gint j;
 	gint k=0;
 	gint l=0;
 	gint n=0;
+	gint pi, pj;
+	gint* first = graph->first;
+	gint* neighbours = graph->neighbours;
+	gint* bonds = graph->bonds;
 
-	k = molecule->numberOf2Connections*molecule->nAtoms;
+	/* exact number of angles : deg*(deg-1)/2 for each central atom */
+	k = 0;
+	for(i=0;i<molecule->nAtoms;i++)
+	{
+		gint deg = first[i+1]-first[i];
+		k += deg*(deg-1)/2;
+	}
 	for(i=0;i<3;i++)
-		molecule->connected3[i] = g_malloc(k*sizeof(gint));
+		molecule->connected3[i] = g_malloc((k+1)*sizeof(gint));
 
+	/* For the bond i-j, the neighbours l of i and j in increasing order, as the old scan over all atoms.
+	 * The angle l-i-j is also given by the bond i-l : it is set by the first of the two bonds.
+	 */
 	n=0;
 	for(k=0;k<molecule->numberOf2Connections;k++)
 	{
 		i = molecule->connected2[0][k];
 		j = molecule->connected2[1][k];
-		for(l=0;l<molecule->nAtoms;l++)
+		pi = first[i];
+		pj = first[j];
+		while(pi<first[i+1] || pj<first[j+1])
 		{
-			if(l!=i && l!=j)
+			if(pj>=first[j+1] || (pi<first[i+1] && neighbours[pi]<=neighbours[pj]))
 			{
-				if( isConnected2(molecule,i,l))
-					if( connect3(molecule,n,l,i,j))
-						n++;
-
-				if( isConnected2(molecule,j,l))
-					if( connect3(molecule,n,i,j,l))
-						n++;
+				l = neighbours[pi];
+				if(l!=j && k<bonds[pi]) connect3(molecule,n++,l,i,j);
+				pi++;
+			}
+			else
+			{
+				l = neighbours[pj];
+				if(l!=i && k<bonds[pj]) connect3(molecule,n++,i,j,l);
+				pj++;
 			}
 		}
-
 	}
 	molecule->numberOf3Connections = n;
 	if(n==0)
@@ -345,52 +351,43 @@ void set3Connections(Molecule* molecule)
 
 }
 /*****************************************************************************/
-gboolean  isConnected4(Molecule* molecule,gint n,gint i,gint j, gint k,gint l)
+static guint hashConnection4(gconstpointer v)
 {
-	gint c;
-	gint a1,a2,a3,a4;
-	for(c=0;c<n;c++)
-	{
-		a1 =  molecule->connected4[0][c];
-		a2 =  molecule->connected4[1][c];
-		a3 =  molecule->connected4[2][c];
-		a4 =  molecule->connected4[3][c];
-
-		if(a1==i && a2 == j && a3 == k && a4 == l)
-			return TRUE;
-	}
-	return FALSE;
-
+	const gint* a = (const gint*)v;
+	return (((guint)a[0]*31u + (guint)a[1])*31u + (guint)a[2])*31u + (guint)a[3];
+}
+/*****************************************************************************/
+static gboolean equalConnection4(gconstpointer v1, gconstpointer v2)
+{
+	const gint* a = (const gint*)v1;
+	const gint* b = (const gint*)v2;
+	return a[0]==b[0] && a[1]==b[1] && a[2]==b[2] && a[3]==b[3];
 }
 /*****************************************************************************/
-gboolean  connect4(Molecule* molecule,gint n,gint i,gint j, gint k,gint l)
+static gboolean  connect4(Molecule* molecule,GHashTable* done, gint n,gint i,gint j, gint k,gint l)
 {
+	gint* key;
 	if(i>l)
 	{
 		permut(&i,&l);
 		permut(&j,&k);
 	}
-	if(!isConnected4(molecule,n,i,j,k,l))
+	key = g_malloc(4*sizeof(gint));
+	key[0] = i; key[1] = j; key[2] = k; key[3] = l;
+	if(g_hash_table_lookup(done, key))
 	{
-		molecule->connected4[0][n]= i;
-		molecule->connected4[1][n]= j;
-		molecule->connected4[2][n]= k;
-		molecule->connected4[3][n]= l;
-
-		updatebondedMatrix(i,j);
-		updatebondedMatrix(i,k);
-		updatebondedMatrix(i,l);
-		updatebondedMatrix(j,k);
-		updatebondedMatrix(j,l);
-		updatebondedMatrix(k,l);
-
-		return TRUE;
+		g_free(key);
+		return FALSE;
 	}
-	return FALSE;
-
+	g_hash_table_insert(done, key, GINT_TO_POINTER(1));
+	molecule->connected4[0][n]= i;
+	molecule->connected4[1][n]= j;
+	molecule->connected4[2][n]= k;
+	molecule->connected4[3][n]= l;
+	return TRUE;
 }
 /*****************************************************************************/
-void set4Connections(Molecule* molecule)
+static void set4Connections(Molecule* molecule, BondedGraph* graph)
 {
 	gint i;
 	gint j;
@@ -398,32 +395,51 @@ void set4Connections(Molecule* molecule)
 	gint m=0;
 	gint l=0;
 	gint n=0;
+	gint pi, pm;
+	gint* first = graph->first;
+	gint* neighbours = graph->neighbours;
+	GHashTable* done = g_hash_table_new_full(hashConnection4, equalConnection4, g_free, NULL);
 
-	k = molecule->numberOf3Connections*molecule->nAtoms;
+	/* at most (deg(j)-1)*(deg(k)-1) torsions around each bond j-k */
+	k = 0;
+	for(i=0;i<molecule->numberOf2Connections;i++)
+	{
+		gint d1 = first[molecule->connected2[0][i]+1]-first[molecule->connected2[0][i]]-1;
+		gint d2 = first[molecule->connected2[1][i]+1]-first[molecule->connected2[1][i]]-1;
+		k += d1*d2;
+	}
 	for(i=0;i<4;i++)
-		molecule->connected4[i] = g_malloc(k*sizeof(gint));
+		molecule->connected4[i] = g_malloc((k+1)*sizeof(gint));
 
+	/* For the angle i-j-m, the neighbours l of i and m in increasing order, as the old scan over all atoms */
 	n=0;
 	for(k=0;k<molecule->numberOf3Connections;k++)
 	{
 		i = molecule->connected3[0][k];
 		j = molecule->connected3[1][k];
 		m = molecule->connected3[2][k];
-		for(l=0;l<molecule->nAtoms;l++)
+		pi = first[i];
+		pm = first[m];
+		while(pi<first[i+1] || pm<first[m+1])
 		{
-			/* a refaire voir Set3Co */
-			if(l!=i && l!=j && l!= m)
+			if(pm>=first[m+1] || (pi<first[i+1] && neighbours[pi]<=neighbours[pm]))
 			{
-				if( isConnected2(molecule,i,l))
-					if(connect4(molecule,n,l,i,j,m))
+				l = neighbours[pi++];
+				if(l!=j && l!=m)
+					if(connect4(molecule,done,n,l,i,j,m))
 						n++;
-				if( isConnected2(molecule,m,l))
-					if(connect4(molecule,n,i,j,m,l))
+			}
+			else
+			{
+				l = neighbours[pm++];
+				if(l!=i && l!=j)
+					if(connect4(molecule,done,n,i,j,m,l))
 						n++;
 			}
 		}
 
 	}
+	g_hash_table_destroy(done);
 	molecule->numberOf4Connections = n;
 	if(n==0)
 		for(i=0;i<4;i++)
@@ -450,6 +466,30 @@ void set4Connections(Molecule* molecule)
 	*/
 
 
+}
+/*****************************************************************************/
+static gint compareAtomNumbers(gconstpointer a, gconstpointer b)
+{
+	return *(const gint*)a - *(const gint*)b;
+}
+/*****************************************************************************/
+static void addExclusion(gint* first, gint* excluded, gint* pos, gint a1, gint a2)
+{
+	if(a1>a2) permut(&a1,&a2);
+	if(excluded) excluded[first[a1]+pos[a1]] = a2;
+	pos[a1]++;
+}
+/*****************************************************************************/
+static void addExclusions(Molecule* molecule, gint* first, gint* excluded, gint* pos)
+{
+	gint i;
+	/* the inner pairs of the angles and torsions are bonds or angles */
+	for(i=0;i<molecule->numberOf2Connections;i++)
+		addExclusion(first, excluded, pos, molecule->connected2[0][i], molecule->connected2[1][i]);
+	for(i=0;i<molecule->numberOf3Connections;i++)
+		addExclusion(first, excluded, pos, molecule->connected3[0][i], molecule->connected3[2][i]);
+	for(i=0;i<molecule->numberOf4Connections;i++)
+		addExclusion(first, excluded, pos, molecule->connected4[0][i], molecule->connected4[3][i]);
 }
 /*****************************************************************************/
 void setNonBondedConnections(Molecule* molecule)
@@ -457,38 +497,64 @@ void setNonBondedConnections(Molecule* molecule)
 	gint i;
 	gint j;
 	gint k;
+	gint p;
 	gint numberOfNonBonded =0;
 	gint numberOfAtoms = molecule->nAtoms;
 	gint *nonBonded[2];
-
-	k = numberOfAtoms;
-	k = k*(k-1)/2;
+	gint* first = NULL;
+	gint* excluded = NULL;
+	gint* pos = NULL;
+
+	/* excluded atoms (1-2, 1-3 and 1-4) : sorted list of the j>i for each atom i */
+	first = g_malloc((numberOfAtoms+1)*sizeof(gint));
+	pos = g_malloc((numberOfAtoms+1)*sizeof(gint));
+	for(i=0;i<=numberOfAtoms;i++) first[i] = pos[i] = 0;
+	addExclusions(molecule, first, NULL, pos);
+	for(i=0;i<numberOfAtoms;i++) first[i+1] = first[i] + pos[i];
+	excluded = g_malloc((first[numberOfAtoms]+1)*sizeof(gint));
+	for(i=0;i<=numberOfAtoms;i++) pos[i] = 0;
+	addExclusions(molecule, first, excluded, pos);
+	for(i=0;i<numberOfAtoms;i++)
+	{
+		gint n = 0;
+		qsort(excluded+first[i], pos[i], sizeof(gint), compareAtomNumbers);
+		for(k=0;k<pos[i];k++)
+			if(k==0 || excluded[first[i]+k] != excluded[first[i]+k-1])
+				excluded[first[i]+n++] = excluded[first[i]+k];
+		pos[i] = n;
+	}
+
+	k = 0;
+	for(i=0;i<numberOfAtoms;i++) k += numberOfAtoms-1-i-pos[i];
 	for(i=0;i<2;i++)
-		nonBonded[i] = g_malloc(k*sizeof(gint));
+		nonBonded[i] = g_malloc((k+1)*sizeof(gint));
 
 	/* list for all nonbonded connections */
 	numberOfNonBonded = 0;
 	for (  i = 0; i < numberOfAtoms; i++ )
+	{
+		p = first[i];
 		for (  j = i + 1; j < numberOfAtoms; j++ )
 		{
-			if ( !bondedMatrix[ i ][ j ] )
+			if ( p<first[i]+pos[i] && excluded[p]==j )
 			{
-				nonBonded[0][numberOfNonBonded] = i;
-				nonBonded[1][numberOfNonBonded] = j;
-				numberOfNonBonded++;
+				p++;
+				continue;
 			}
+			nonBonded[0][numberOfNonBonded] = i;
+			nonBonded[1][numberOfNonBonded] = j;
+			numberOfNonBonded++;
 		}
+	}
+	g_free(first);
+	g_free(pos);
+	g_free(excluded);
 	if(numberOfNonBonded==0)
 		for(i=0;i<2;i++)
 		{
 			g_free(nonBonded[i]);
 			nonBonded[i] = NULL;
 		}
-	else
-		for(i=0;i<2;i++)
-		{
-			nonBonded[i] = g_realloc(nonBonded[i],numberOfNonBonded*sizeof(gint));
-		}
 	molecule->numberOfNonBonded = numberOfNonBonded;
 	for(i=0;i<2;i++)
 		molecule->nonBonded[i] = nonBonded[i];
@@ -508,7 +574,7 @@ void setNonBondedConnections(Molecule* molecule)
 /*****************************************************************************/
 void setConnections(Molecule* molecule)
 {
-	createBondedMatrix(molecule);
+	BondedGraph graph;
 
 	/* printf("Set Connection\n");*/
 	set_text_to_draw(_("Establishing connectivity : 2 connections..."));
@@ -517,23 +583,31 @@ void setConnections(Molecule* molecule)
     	while( gtk_events_pending() )
         	gtk_main_iteration();
 	set2Connections(molecule);
+	graph = newBondedGraph(molecule);
 	set_text_to_draw(_("Establishing connectivity : 3 connections..."));
 	set_statubar_operation_str(_("Establishing connectivity : 3 connections..."));
 
 	drawGeom();
 	if(StopCalcul)
+	{
+		freeBondedGraph(&graph);
 		return;
+	}
     	while( gtk_events_pending() )
         	gtk_main_iteration();
-	set3Connections(molecule);
+	set3Connections(molecule, &graph);
 	set_text_to_draw(_("Establishing connectivity : 4 connections..."));
 	set_statubar_operation_str(_("Establishing connectivity : 4 connections..."));
 	drawGeom();
 	if(StopCalcul)
+	{
+		freeBondedGraph(&graph);
 		return;
+	}
     	while( gtk_events_pending() )
         	gtk_main_iteration();
-	set4Connections(molecule);
+	set4Connections(molecule, &graph);
+	freeBondedGraph(&graph);
 
 	set_text_to_draw(_("Establishing connectivity : non bonded ..."));
 	set_statubar_operation_str(_("Establishing connectivity : non bonded ..."));
@@ -543,8 +617,6 @@ void setConnections(Molecule* molecule)
     	while( gtk_events_pending() )
         	gtk_main_iteration();
 	setNonBondedConnections(molecule);
-
-	freeBondedMatrix(molecule);
 }
 /*****************************************************************************/
 Molecule createMolecule(GeomDef* geom,gint natoms,gboolean connections)
@@ -607,6 +679,10 @@ void redrawMolecule(Molecule* molecule,gchar* str)
 	gint j;
 	gdouble C[3] = {0.0,0.0,0.0};
 
+#ifdef ENABLE_OMP
+	/* conformers optimized in parallel must not touch the displayed geometry */
+	if(omp_in_parallel()) return;
+#endif
 	Free_One_Geom(geometry0,Natoms);
 	Free_One_Geom(geometry ,Natoms);
 	Natoms = 0;
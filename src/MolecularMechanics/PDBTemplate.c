@@ -30,6 +30,55 @@ DEALINGS IN THE SOFTWARE.
 #include "../MolecularMechanics/CreateDefaultPDBTpl.h"
 #include "../MolecularMechanics/SavePDBTemplate.h"
 static	PDBTemplate* staticPDBTemplate = NULL;
+/* residue name -> residue number+1 and, for each residue, pdb type -> type number+1 
+ * built at the first lookup, reset when the template is loaded, replaced or edited */
+static	GHashTable* staticResiduesIndex = NULL;
+static	GHashTable** staticTypesIndex = NULL;
+static	gint staticNumberOfIndexedResidues = 0;
+/************************************************************/
+void resetPDBTplIndex()
+{
+	gint i;
+	if(staticResiduesIndex) g_hash_table_destroy(staticResiduesIndex);
+	staticResiduesIndex = NULL;
+	for(i=0;i<staticNumberOfIndexedResidues;i++)
+		if(staticTypesIndex[i]) g_hash_table_destroy(staticTypesIndex[i]);
+	if(staticTypesIndex) g_free(staticTypesIndex);
+	staticTypesIndex = NULL;
+	staticNumberOfIndexedResidues = 0;
+}
+/************************************************************/
+static void buildPDBTplIndex()
+{
+	gint i;
+	gint j;
+	if(staticResiduesIndex || !staticPDBTemplate) return;
+
+	staticNumberOfIndexedResidues = staticPDBTemplate->numberOfResidues;
+	staticResiduesIndex = g_hash_table_new(g_str_hash, g_str_equal);
+	staticTypesIndex = g_malloc((staticNumberOfIndexedResidues+1)*sizeof(GHashTable*));
+	for(i=0;i<staticNumberOfIndexedResidues;i++)
+	{
+		PDBResidueTemplate* residue = &staticPDBTemplate->residueTemplates[i];
+		/* the first residue and the first type of a given name, as the old linear searches */
+		if(residue->residueName && !g_hash_table_lookup(staticResiduesIndex, residue->residueName))
+			g_hash_table_insert(staticResiduesIndex, residue->residueName, GINT_TO_POINTER(i+1));
+		staticTypesIndex[i] = g_hash_table_new(g_str_hash, g_str_equal);
+		for(j=0;j<residue->numberOfTypes;j++)
+		{
+			gchar* pdbType = residue->typeTemplates[j].pdbType;
+			if(pdbType && !g_hash_table_lookup(staticTypesIndex[i], pdbType))
+				g_hash_table_insert(staticTypesIndex[i], pdbType, GINT_TO_POINTER(j+1));
+		}
+	}
+}
+/************************************************************/
+static gint getTypePDBTplNumber(gint residueNumber, gchar* pdbType)
+{
+	buildPDBTplIndex();
+	if(residueNumber<0 || residueNumber>=staticNumberOfIndexedResidues) return -1;
+	return GPOINTER_TO_INT(g_hash_table_lookup(staticTypesIndex[residueNumber], pdbType))-1;
+}
 /************************************************************/
 PDBTemplate* freePDBTpl(PDBTemplate* pdbTemplate)
 {
@@ -94,6 +143,7 @@ PDBTemplate* LoadDefaultPDBTpl()
 /************************************************************/
 void LoadPDBTpl()
 {
+	resetPDBTplIndex();
 	if(staticPDBTemplate)
 		staticPDBTemplate = freePDBTpl(staticPDBTemplate);
 	staticPDBTemplate = LoadPersonalPDBTpl();
@@ -111,16 +161,10 @@ void LoadPDBTpl()
 /************************************************************/
 static gint getResiduePDBTplNumber(gchar* residueName)
 {
-	gint i;
 	if(!staticPDBTemplate)
 		return -1;
-
-	for(i=0;i<staticPDBTemplate->numberOfResidues;i++)
-	{
-		if(!strcmp(staticPDBTemplate->residueTemplates[i].residueName,residueName))
-			return i;
-	}
-	return -1;
+	buildPDBTplIndex();
+	return GPOINTER_TO_INT(g_hash_table_lookup(staticResiduesIndex, residueName))-1;
 }
 /************************************************************/
 static gchar* getmmType(gint residueNumber, gchar* pdbType,gdouble* charge)
@@ -129,17 +173,12 @@ static gchar* getmmType(gint residueNumber, gchar* pdbType,gdouble* charge)
 	PDBTypeTemplate* typeTemplates = 
 		staticPDBTemplate->residueTemplates[residueNumber].typeTemplates;
 	gint numberOfTypes = staticPDBTemplate->residueTemplates[residueNumber].numberOfTypes;
-	gchar* mmType = g_strdup("UNK");
-	for(j=0;j<numberOfTypes;j++)
-	{
-		if(!strcmp(pdbType,typeTemplates[j].pdbType))
-		{
-			g_free(mmType);
-			mmType = g_strdup(typeTemplates[j].mmType);
-			*charge = typeTemplates[j].charge;
-			return mmType;
-		}
-	}
+	gchar* mmType = NULL;
+
+	j = getTypePDBTplNumber(residueNumber, pdbType);
+	if(j<0 || j>=numberOfTypes) return g_strdup("UNK");
+	mmType = g_strdup(typeTemplates[j].mmType);
+	*charge = typeTemplates[j].charge;
 	return mmType;
 }
 /************************************************************/
@@ -184,20 +223,17 @@ static gint getHydrogens(gint residueNumber, gchar* pdbType, gchar** hAtoms)
 		staticPDBTemplate->residueTemplates[residueNumber].typeTemplates;
 	gint numberOfTypes = staticPDBTemplate->residueTemplates[residueNumber].numberOfTypes;
 	gint nH = 0;
-	for(j=0;j<numberOfTypes;j++)
+
+	j = getTypePDBTplNumber(residueNumber, pdbType);
+	if(j<0 || j>=numberOfTypes) return nH;
+	/* the hydrogens follow their heavy atom in the template */
+	for(k=j+1;k<numberOfTypes;k++)
 	{
-		if(!strcmp(pdbType,typeTemplates[j].pdbType))
-		{
-			for(k=j+1;k<numberOfTypes;k++)
-			{
-				if(!typeTemplates[k].pdbType) break;
-				if(typeTemplates[k].pdbType[0]!='H') break;
-				sprintf(hAtoms[nH],"%s",typeTemplates[k].pdbType);
-				nH++;
-				if(nH>10) break;
-			}
-			return nH;
-		}
+		if(!typeTemplates[k].pdbType) break;
+		if(typeTemplates[k].pdbType[0]!='H') break;
+		sprintf(hAtoms[nH],"%s",typeTemplates[k].pdbType);
+		nH++;
+		if(nH>10) break;
 	}
 	return nH;
 }
@@ -243,6 +279,7 @@ PDBTemplate* getPointerPDBTemplate()
 /************************************************************/
 void setPointerPDBTemplate(PDBTemplate* ptr)
 {
+	resetPDBTplIndex();
 	staticPDBTemplate = ptr;
 }
 /************************************************************/
@@ -33,6 +33,7 @@ gchar* getMMTypeFromPDBTpl(gchar* residueName,gchar* pdbType,gdouble* charge);
 gint getHydrogensFromPDBTpl(gchar* residueName,gchar* pdbType, gchar** hAtoms);
 PDBTemplate* getPointerPDBTemplate();
 void setPointerPDBTemplate(PDBTemplate* ptr);
+void resetPDBTplIndex();
 void savePersonalPDBTpl(GtkWidget* win);
 gchar** getListPDBTypes(gchar* residueName, gint* nlist);
 
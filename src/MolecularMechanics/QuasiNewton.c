@@ -31,7 +31,10 @@ DEALINGS IN THE SOFTWARE.
 #include "ForceField.h"
 #include "QuasiNewton.h"
 
-double maxarg1,maxarg2;
+static gdouble maxarg1,maxarg2;
+#ifdef ENABLE_OMP
+#pragma omp threadprivate(maxarg1,maxarg2)
+#endif
 #define FMIN(a,b) (maxarg1=(a),maxarg2=(b),(maxarg1) > (maxarg2) ?(maxarg2) : (maxarg1))
 #define FMAX(a,b) (maxarg1=(a),maxarg2=(b),(maxarg1) > (maxarg2) ?(maxarg1) : (maxarg2))
 
@@ -394,6 +397,9 @@ void mcsrch ( gint n , gdouble x[] , gdouble f , gdouble g[] ,
 	static gdouble stmin = 0, stmax = 0, width = 0, width1 = 0, xtrapf = 0;
 	static gint brackt[1];
 	static gint stage1 = FALSE;
+#ifdef ENABLE_OMP
+#pragma omp threadprivate(infoc,dg,dgm,dginit,dgtest,dgx,dgxm,dgy,dgym,finit,ftest1,fm,fx,fxm,fy,fym,p5,p66,stx,sty,stmin,stmax,width,width1,xtrapf,brackt,stage1)
+#endif
 
 	p5 = 0.5;
 	p66 = 0.66;
@@ -733,6 +739,9 @@ static gint lbfgs(
 	static gdouble* w = NULL;
 	static gint wlength = 0;
 	static gint cacheLength = 0;
+#ifdef ENABLE_OMP
+#pragma omp threadprivate(gtol,solution_cache,gnorm,stp1,ftol,stp,ys,yy,sq,yr,beta,xnorm,iter,nfun,point,ispt,iypt,maxfev,info,bound,npt,cp,i,nfev,inmc,iycn,iscn,finish,w,wlength,cacheLength)
+#endif
 
 
 	if ( w == NULL || wlength != n*(2*m+1)+2*m )
@@ -240,6 +240,7 @@ static void newResidue(GtkWidget* w)
 	pdbTemplate->residueTemplates = residueTemplates;
 	pdbTemplate->numberOfResidues = numberOfResidues;
 
+	resetPDBTplIndex();
 	freeDataTplTree();
 	rafreshTreeView();
 	setExpandeds(expandeds,selectedRow);
@@ -291,6 +292,7 @@ static void editType(GtkWidget* w)
 	typeTemplates[typeNumber].mmType = g_strdup(mmType);
 	typeTemplates[typeNumber].charge = atof(charge);
 
+	resetPDBTplIndex();
 	freeDataTplTree();
 	rafreshTreeView();
 	setExpandeds(expandeds,selectedRow);
@@ -379,6 +381,7 @@ static void newType(GtkWidget* w)
 	pdbTemplate->residueTemplates[residueNumber].typeTemplates = typeTemplates;
 	pdbTemplate->residueTemplates[residueNumber].numberOfTypes = numberOfTypes;
 
+	resetPDBTplIndex();
 	freeDataTplTree();
 	rafreshTreeView();
 	setExpandeds(expandeds,selectedRow);
@@ -576,6 +579,7 @@ static void deleteOneResidue(GtkWidget *win, gpointer d)
 		g_realloc(pdbTemplate->residueTemplates,
 			pdbTemplate->numberOfResidues*sizeof(PDBTypeTemplate));
 
+	resetPDBTplIndex();
 	freeDataTplTree();
 	rafreshTreeView();
 	setExpandeds(expandeds,selectedRow);
@@ -660,6 +664,7 @@ static void deleteOneType(GtkWidget *win,gpointer d)
 	
 
 	/*printf("End getExp\n");*/
+	resetPDBTplIndex();
 	freeDataTplTree();
 	rafreshTreeView();
 	setExpandeds(expandeds,selectedRow);
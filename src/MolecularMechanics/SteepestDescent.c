@@ -19,6 +19,9 @@ DEALINGS IN THE SOFTWARE.
 #include "../../Config.h"
 #include <stdlib.h>
 #include <math.h>
+#ifdef ENABLE_OMP
+#include <omp.h>
+#endif
 
 #include "../Common/Global.h"
 #include "../Utils/AtomsProp.h"
@@ -126,6 +129,9 @@ static void Minimize(SteepestDescent* steepestDescent)
 
 		for(ii=steepestDescent->maxLines;ii>=1;ii--)
 		{
+#ifdef ENABLE_OMP
+			if(!omp_in_parallel())
+#endif
     			while( gtk_events_pending() )
         			gtk_main_iteration();
 			if(StopCalcul)
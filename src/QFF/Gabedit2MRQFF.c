@@ -556,160 +556,156 @@ static gboolean readVectorReal(FILE* file, gchar* tag, gint n, gdouble* values)
 	return TRUE;
 }
 /************************************************************************************************************/
-static gboolean readEnergies(FILE* file, TWOMRQFF* qffConstants)
+/* all the reals following the tag, up to the first non numerical value */
+static gdouble* readAllReals(FILE* file, gchar* tag, gint* n)
 {
-	gint i = 0;
-	gint j = 0;
-	gint k = 0;
-	int nn=1;
-        gchar* TAG = NULL;
-        TAG = g_strdup("ENERGIES");
-        uppercase(TAG);
-        rewind(file);
+	gint nMax = 1024;
+	gdouble* values = NULL;
+	gchar* TAG = g_strdup(tag);
+	*n = 0;
+	uppercase(TAG);
+	rewind(file);
 	if(!goToStr(file, TAG)) 
 	{
 		fprintf(stderr,"I cannot find %s in our file\n",TAG);
-		if(TAG) g_free(TAG);
-		return FALSE;
+		g_free(TAG);
+		return NULL;
 	}
+	g_free(TAG);
+	values = g_malloc(nMax*sizeof(gdouble));
+	while(fscanf(file,"%lf",&values[*n])==1)
+	{
+		(*n)++;
+		if(*n>=nMax)
+		{
+			nMax *= 2;
+			values = g_realloc(values, nMax*sizeof(gdouble));
+		}
+	}
+	return values;
+}
+/************************************************************************************************************/
+/* energies in the order of the Gaussian inputs made by Gabedit : 
+ * V0, VI[i][0..5], then for each j : VIJ[j][i<j][0..3] and VI3J[j][i!=j][0..3] 
+ */
+static gboolean setEnergies(TWOMRQFF* qffConstants, gint n, gdouble* energies)
+{
+	gint i = 0;
+	gint j = 0;
+	gint k = 0;
+	gint p = 0;
+
 	qffConstants->numberOfEnergies = 0;
-	nn = fscanf(file,"%lf",&qffConstants->V0);
-	qffConstants->numberOfEnergies += nn;
-	for(i=0;i<qffConstants->numberOfFrequencies && nn==1;i++)
-	for(k=0;k<6 && nn==1;k++)
-        {
-		nn = fscanf(file,"%lf",&qffConstants->VI[i][k]);
-		qffConstants->numberOfEnergies += nn;
-                if(nn!=1) break;
-        }
-	if(i!=qffConstants->numberOfFrequencies || k!=6)
+	if(n<1+6*qffConstants->numberOfFrequencies)
 	{
 		fprintf(stderr,"I cannot read the 1MR energies\n");
 		return FALSE;
 	}
+	qffConstants->V0 = energies[p++];
+	for(i=0;i<qffConstants->numberOfFrequencies;i++)
+	for(k=0;k<6;k++)
+		qffConstants->VI[i][k] = energies[p++];
 
-        for(j=0;j<qffConstants->numberOfFrequencies && nn==1;j++)
+        for(j=0;j<qffConstants->numberOfFrequencies && p<n;j++)
         {
-                for(i=0;i<j && nn==1;i++)
+                for(i=0;i<j && p+4<=n;i++)
                 {
-			for(k=0;k<4 && nn==1;k++)
-        		{
-				nn = fscanf(file,"%lf",&qffConstants->VIJ[j][i][k]);
-				qffConstants->numberOfEnergies += nn;
-                		if(nn!=1) break;
-       	 		}
-			if(nn==1)
-			{
+			for(k=0;k<4;k++) qffConstants->VIJ[j][i][k] = energies[p++];
 			qffConstants->VIJ[i][j][0] = qffConstants->VIJ[j][i][0];
 			qffConstants->VIJ[i][j][1] = qffConstants->VIJ[j][i][2];
 			qffConstants->VIJ[i][j][2] = qffConstants->VIJ[j][i][1];
 			qffConstants->VIJ[i][j][3] = qffConstants->VIJ[j][i][3];
-			}
                 }
-                for(i=0;i<qffConstants->numberOfFrequencies && nn==1;i++)
+                for(i=0;i<qffConstants->numberOfFrequencies && p+4<=n;i++)
                 {
                         if(i==j) continue;
-			for(k=0;k<4 && nn==1;k++)
-        		{
-				nn = fscanf(file,"%lf",&qffConstants->VI3J[j][i][k]);
-				qffConstants->numberOfEnergies += nn;
-                		if(nn!=1) break;
-       	 		}
+			for(k=0;k<4;k++) qffConstants->VI3J[j][i][k] = energies[p++];
 		}
 	}
+	qffConstants->numberOfEnergies = p;
 	return TRUE;
 }
 /************************************************************************************************************/
-static gboolean readDipoles(FILE* file, TWOMRQFF* qffConstants)
+static gboolean readEnergies(FILE* file, TWOMRQFF* qffConstants)
+{
+	gint n = 0;
+	gdouble* energies = readAllReals(file, "ENERGIES", &n);
+	gboolean Ok;
+	if(!energies) return FALSE;
+	Ok = setEnergies(qffConstants, n, energies);
+	g_free(energies);
+	return Ok;
+}
+/************************************************************************************************************/
+/* dipoles [3*numberOfEnergies], same order as the energies */
+static gboolean setDipoles(TWOMRQFF* qffConstants, gint n, gdouble* dipoles)
 {
 	gint i = 0;
 	gint j = 0;
 	gint k = 0;
 	gint xyz = 0;
-	int nn=1;
-        gchar* TAG = NULL;
-        TAG = g_strdup("DIPOLES");
-        uppercase(TAG);
-        rewind(file);
-	if(!goToStr(file, TAG)) 
-	{
-		fprintf(stderr,"I cannot find %s in our file\n",TAG);
-		if(TAG) g_free(TAG);
-		return FALSE;
-	}
-	qffConstants->numberOfDipoles = 0;
-	for(xyz=0;xyz<3 && nn==1;xyz++)
-	{
-		nn = fscanf(file,"%lf",&qffConstants->dipole0[xyz]);
-		qffConstants->numberOfDipoles += nn;
-	}
+	gint p = 0;
 
-	if(nn!=1) 
+	qffConstants->numberOfDipoles = 0;
+	if(n<3)
 	{
 		fprintf(stderr,"Warning : I cannot read the dipole\n");
-		if(TAG) g_free(TAG);
 		return FALSE;
 	}
+	for(xyz=0;xyz<3;xyz++) qffConstants->dipole0[xyz] = dipoles[p++];
 
-	for(i=0;i<qffConstants->numberOfFrequencies && nn==1;i++)
-	for(k=0;k<6 && nn==1;k++)
-        {
-		for(xyz=0;xyz<3 && nn==1;xyz++)
-		{
-			nn = fscanf(file,"%lf",&qffConstants->dipolesI[i][k][xyz]);
-			qffConstants->numberOfDipoles += nn;
-		}
-        }
-	if(i!=qffConstants->numberOfFrequencies || k!=6 || xyz!=3)
+	if(n<3*(1+6*qffConstants->numberOfFrequencies))
 	{
 		fprintf(stderr,"Warning : I cannot read the 1MR dipoles\n");
-		if(TAG) g_free(TAG);
+		qffConstants->numberOfDipoles = 1;
 		return FALSE;
 	}
+	for(i=0;i<qffConstants->numberOfFrequencies;i++)
+	for(k=0;k<6;k++)
+	for(xyz=0;xyz<3;xyz++)
+		qffConstants->dipolesI[i][k][xyz] = dipoles[p++];
 
-        for(j=0;j<qffConstants->numberOfFrequencies && nn==1;j++)
+        for(j=0;j<qffConstants->numberOfFrequencies && p<n;j++)
         {
-                for(i=0;i<j && nn==1;i++)
+                for(i=0;i<j && p+12<=n;i++)
                 {
-			for(k=0;k<4 && nn==1;k++)
-        		{
-				for(xyz=0;xyz<3 && nn==1;xyz++)
-				{
-					nn = fscanf(file,"%lf",&qffConstants->dipolesIJ[j][i][k][xyz]);
-					qffConstants->numberOfDipoles += nn;
-                			if(nn!=1) break;
-				}
-       	 		}
-			if(nn==1)
+			for(k=0;k<4;k++)
+			for(xyz=0;xyz<3;xyz++)
+				qffConstants->dipolesIJ[j][i][k][xyz] = dipoles[p++];
+			for(xyz=0;xyz<3;xyz++)
 			{
-				for(xyz=0;xyz<3 && nn==1;xyz++)
-				{
-					qffConstants->dipolesIJ[i][j][0][xyz] = qffConstants->dipolesIJ[j][i][0][xyz];
-					qffConstants->dipolesIJ[i][j][1][xyz] = qffConstants->dipolesIJ[j][i][2][xyz];
-					qffConstants->dipolesIJ[i][j][2][xyz] = qffConstants->dipolesIJ[j][i][1][xyz];
-					qffConstants->dipolesIJ[i][j][3][xyz] = qffConstants->dipolesIJ[j][i][3][xyz];
-				}
+				qffConstants->dipolesIJ[i][j][0][xyz] = qffConstants->dipolesIJ[j][i][0][xyz];
+				qffConstants->dipolesIJ[i][j][1][xyz] = qffConstants->dipolesIJ[j][i][2][xyz];
+				qffConstants->dipolesIJ[i][j][2][xyz] = qffConstants->dipolesIJ[j][i][1][xyz];
+				qffConstants->dipolesIJ[i][j][3][xyz] = qffConstants->dipolesIJ[j][i][3][xyz];
 			}
                 }
-                for(i=0;i<qffConstants->numberOfFrequencies && nn==1;i++)
+                for(i=0;i<qffConstants->numberOfFrequencies && p+12<=n;i++)
                 {
                         if(i==j) continue;
-			for(k=0;k<4 && nn==1;k++)
-        		{
-				for(xyz=0;xyz<3 && nn==1;xyz++)
-				{
-					nn = fscanf(file,"%lf",&qffConstants->dipolesI3J[j][i][k][xyz]);
-					qffConstants->numberOfDipoles += nn;
-					qffConstants->dipolesI3J[i][j][k][xyz] = qffConstants->dipolesI3J[j][i][k][xyz];
-                			if(nn!=1) break;
-				}
-       	 		}
+			for(k=0;k<4;k++)
+			for(xyz=0;xyz<3;xyz++)
+			{
+				qffConstants->dipolesI3J[j][i][k][xyz] = dipoles[p++];
+				qffConstants->dipolesI3J[i][j][k][xyz] = qffConstants->dipolesI3J[j][i][k][xyz];
+			}
 		}
 	}
-	qffConstants->numberOfDipoles /= 3;
+	qffConstants->numberOfDipoles = p/3;
 	return TRUE;
 }
 /************************************************************************************************************/
+static gboolean readDipoles(FILE* file, TWOMRQFF* qffConstants)
+{
+	gint n = 0;
+	gdouble* dipoles = readAllReals(file, "DIPOLES", &n);
+	gboolean Ok;
+	if(!dipoles) return FALSE;
+	Ok = setDipoles(qffConstants, n, dipoles);
+	g_free(dipoles);
+	return Ok;
+}
+/************************************************************************************************************/
 static void computeGradients(TWOMRQFF* qffConstants)
 {
  	gint nf = qffConstants->numberOfFrequencies;
@@ -1098,6 +1094,19 @@ static void computeQuarticDerivativesDipoles(TWOMRQFF* qffConstants)
 	}
 }
 /************************************************************************************************************/
+static void computeTWOMRQFF(TWOMRQFF* qffConstants)
+{
+	computeGradients(qffConstants);
+	computeFrequencies(qffConstants);
+	computeCubicForces(qffConstants);
+	computeQuarticForces(qffConstants);
+	changeUnitInputFirstDerivativesDipoles(qffConstants);
+	computeFirstDerivativesDipoles(qffConstants);
+	computeSecondDerivativesDipoles(qffConstants);
+	computeCubicDerivativesDipoles(qffConstants);
+	computeQuarticDerivativesDipoles(qffConstants);
+}
+/************************************************************************************************************/
 static gboolean read_2mrqff_file(GabeditFileChooser *filesel, gint response_id)
 {
 	gint nf = 0;
@@ -1123,15 +1132,7 @@ static gboolean read_2mrqff_file(GabeditFileChooser *filesel, gint response_id)
 	if(Ok) Ok = readVectorReal(file, "Delta", qffConstants->numberOfFrequencies, qffConstants->delta);
 	if(Ok) Ok = readEnergies(file, qffConstants);
 	if(Ok) readDipoles(file, qffConstants);
-	if(Ok) computeGradients(qffConstants);
-	if(Ok) computeFrequencies(qffConstants);
-	if(Ok) computeCubicForces(qffConstants);
-	if(Ok) computeQuarticForces(qffConstants);
-	if(Ok) changeUnitInputFirstDerivativesDipoles(qffConstants);
-	if(Ok) computeFirstDerivativesDipoles(qffConstants);
-	if(Ok) computeSecondDerivativesDipoles(qffConstants);
-	if(Ok) computeCubicDerivativesDipoles(qffConstants);
-	if(Ok) computeQuarticDerivativesDipoles(qffConstants);
+	if(Ok) computeTWOMRQFF(qffConstants);
 	/*
 	if(Ok && DEBUGFLAG != 0 ) printTWOMRQFF(qffConstants);
 	*/
@@ -1151,3 +1152,32 @@ void read_2mrqff_file_dlg()
  	file_chooser_open(read_2mrqff_file, _("Read the  data from 2MR-QFF file"), GABEDIT_TYPEFILE_GABEDIT,GABEDIT_TYPEWIN_OTHER);
 	gtk_window_set_modal (GTK_WINDOW (filesel), TRUE);
 }
+/********************************************************************************/
+/* frequencies in cm-1, masses in amu, deltas in Bohr, energies in Hartree and dipoles [3*numberOfEnergies] in au (can be NULL),
+ * energies and dipoles in the order of the 2MR-QFF file
+ */
+void compute_2mrqff_from_data(gint nf, gdouble* frequencies, gdouble* masses, gdouble* deltas, gint numberOfEnergies, gdouble* energies, gdouble* dipoles)
+{
+	TWOMRQFF* qffConstants;
+	gint i;
+
+	if(nf<1 || !frequencies || !masses || !deltas || !energies) return;
+	qffConstants = (TWOMRQFF*) g_malloc(sizeof(TWOMRQFF));
+	initTWOMRQFF(qffConstants,nf);
+	for(i=0;i<nf;i++)
+	{
+		qffConstants->frequencies[i] = frequencies[i];
+		qffConstants->mass[i] = masses[i];
+		qffConstants->delta[i] = deltas[i];
+	}
+	if(!setEnergies(qffConstants, numberOfEnergies, energies))
+	{
+		freeTWOMRQFF(qffConstants);
+		g_free(qffConstants);
+		return;
+	}
+	if(dipoles) setDipoles(qffConstants, 3*numberOfEnergies, dipoles);
+	computeTWOMRQFF(qffConstants);
+	if(DEBUGFLAG != 0 ) printTWOMRQFF(qffConstants);
+	showTWOMRQFF(qffConstants);
+}
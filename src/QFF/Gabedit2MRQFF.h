@@ -20,6 +20,7 @@ DEALINGS IN THE SOFTWARE.
 #define __GABEDIT_GABEDITQFFGAUSSIAN_H___H__
 
 void read_2mrqff_file_dlg();
+void compute_2mrqff_from_data(gint nf, gdouble* frequencies, gdouble* masses, gdouble* deltas, gint numberOfEnergies, gdouble* energies, gdouble* dipoles);
 
 #endif /* __GABEDIT_GABEDITQFFGAUSSIAN_H___H__ */
 
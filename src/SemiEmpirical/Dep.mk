@@ -16,7 +16,7 @@ SemiEmpiricalModel.o: SemiEmpiricalModel.c ../../Config.h \
  ../Common/../Common/GabeditType.h ../Utils/AtomsProp.h ../Utils/Utils.h \
  ../Geometry/Fragments.h ../Geometry/DrawGeom.h \
  ../Geometry/DrawGeomCairo.h ../Geometry/Fragments.h AtomSE.h \
- MoleculeSE.h SemiEmpiricalModel.h
+ MoleculeSE.h SemiEmpiricalModel.h IPIDriver.h
 SemiEmpiricalMD.o: SemiEmpiricalMD.c ../../Config.h ../Common/Global.h \
  ../Common/../Files/GabeditFileChooser.h \
  ../Common/../Common/GabeditType.h ../Utils/AtomsProp.h \
@@ -29,7 +29,8 @@ SemiEmpirical.o: SemiEmpirical.c ../../Config.h ../Common/Global.h \
  ../Utils/Constants.h ../Geometry/Fragments.h ../Geometry/DrawGeom.h \
  ../Geometry/DrawGeomCairo.h ../Geometry/Fragments.h \
  ../SemiEmpirical/AtomSE.h ../SemiEmpirical/MoleculeSE.h \
- ../SemiEmpirical/SemiEmpiricalModel.h ../SemiEmpirical/SemiEmpirical.h
+ ../SemiEmpirical/SemiEmpiricalModel.h ../SemiEmpirical/SemiEmpirical.h \
+ ../SemiEmpirical/IPIDriver.h
 SemiEmpiricalDlg.o: SemiEmpiricalDlg.c ../../Config.h ../Common/Global.h \
  ../Common/../Files/GabeditFileChooser.h \
  ../Common/../Common/GabeditType.h ../Utils/UtilsInterface.h \
@@ -40,4 +41,19 @@ SemiEmpiricalDlg.o: SemiEmpiricalDlg.c ../../Config.h ../Common/Global.h \
  ../Geometry/GeomXYZ.h ../Utils/Utils.h ../Utils/AtomsProp.h \
  ../Files/FolderChooser.h ../Files/GabeditFolderChooser.h AtomSE.h \
  MoleculeSE.h SemiEmpiricalModel.h SemiEmpirical.h SemiEmpiricalMD.h \
- SemiEmpiricalDlg.h
+ SemiEmpiricalDlg.h ExternalJobs.h IPIDriver.h \
+ ../MolecularMechanics/Atom.h ../MolecularMechanics/Molecule.h \
+ ../MolecularMechanics/ForceField.h \
+ ../MolecularMechanics/FiniteDifferences.h
+ExternalJobs.o: ExternalJobs.c ../../Config.h ../Common/Global.h \
+ ../Common/../Files/GabeditFileChooser.h \
+ ../Common/../Common/GabeditType.h ../Utils/Utils.h \
+ ../Geometry/Fragments.h ../Geometry/DrawGeom.h \
+ ../Geometry/DrawGeomCairo.h ../Geometry/Fragments.h ExternalJobs.h
+IPIDriver.o: IPIDriver.c ../../Config.h ../Common/Global.h \
+ ../Common/../Files/GabeditFileChooser.h \
+ ../Common/../Common/GabeditType.h ../Utils/Constants.h \
+ ../Geometry/Fragments.h ../Geometry/DrawGeom.h \
+ ../Geometry/DrawGeomCairo.h ../Geometry/Fragments.h \
+ ../SemiEmpirical/AtomSE.h ../SemiEmpirical/MoleculeSE.h \
+ ../SemiEmpirical/IPIDriver.h
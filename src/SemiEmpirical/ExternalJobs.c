@@ -0,0 +1,328 @@
+/* ExternalJobs.c */
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#include "../../Config.h"
+#include <stdlib.h>
+#include <string.h>
+#ifndef G_OS_WIN32
+#include <unistd.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+#include "../Common/Global.h"
+#include "../Utils/Utils.h"
+#include "../Geometry/Fragments.h"
+#include "../Geometry/DrawGeom.h"
+#include "ExternalJobs.h"
+
+/* Local scheduler for external programs (Mopac, FireFly, ...).
+ * Each job runs its script in its own scratch directory, at most maxRunning jobs at once.
+ * The results are collected on the GTK thread, as soon as a job is finished.
+ * A job is resumed (not run again) if its directory contains a completed output computed
+ * from the same input file.
+ */
+#define JOBSTAMP "input.done"
+/*****************************************************************************/
+gint getDefaultNumberOfExternalJobs()
+{
+	gint n = (gint)g_get_num_processors();
+	if(n<1) n = 1;
+	return n;
+}
+/*****************************************************************************/
+ExternalJobsPool* newExternalJobsPool(gint numberOfJobs, gint maxRunning, const gchar* title, ExternalJobCollect collect, gpointer data)
+{
+	gint i;
+	ExternalJobsPool* pool = NULL;
+	if(numberOfJobs<1) return NULL;
+	pool = g_malloc(sizeof(ExternalJobsPool));
+	pool->numberOfJobs = numberOfJobs;
+	pool->jobs = g_malloc(numberOfJobs*sizeof(ExternalJob));
+	pool->maxRunning = maxRunning;
+	if(pool->maxRunning<1) pool->maxRunning = getDefaultNumberOfExternalJobs();
+	pool->collect = collect;
+	pool->data = data;
+	pool->title = g_strdup(title?title:"Jobs");
+	for(i=0;i<numberOfJobs;i++)
+	{
+		pool->jobs[i].index = i;
+		pool->jobs[i].workDir = NULL;
+		pool->jobs[i].fileNameSH = NULL;
+		pool->jobs[i].fileNameIn = NULL;
+		pool->jobs[i].fileNameOut = NULL;
+		pool->jobs[i].pid = -1;
+		pool->jobs[i].resumed = FALSE;
+		pool->jobs[i].status = JOBFAILED;
+	}
+	return pool;
+}
+/*****************************************************************************/
+void freeExternalJobsPool(ExternalJobsPool* pool)
+{
+	gint i;
+	if(!pool) return;
+	for(i=0;i<pool->numberOfJobs;i++)
+	{
+		if(pool->jobs[i].workDir) g_free(pool->jobs[i].workDir);
+		if(pool->jobs[i].fileNameSH) g_free(pool->jobs[i].fileNameSH);
+		if(pool->jobs[i].fileNameIn) g_free(pool->jobs[i].fileNameIn);
+		if(pool->jobs[i].fileNameOut) g_free(pool->jobs[i].fileNameOut);
+	}
+	g_free(pool->jobs);
+	if(pool->title) g_free(pool->title);
+	g_free(pool);
+}
+/*****************************************************************************/
+/* returns the scratch directory of job i (owned by the pool), the caller writes its input here */
+gchar* setExternalJob(ExternalJobsPool* pool, gint i, gint index, const gchar* fileNamePrefix)
+{
+	ExternalJob* job = NULL;
+	if(!pool || i<0 || i>=pool->numberOfJobs) return NULL;
+	job = &pool->jobs[i];
+	job->index = index;
+	if(job->workDir) g_free(job->workDir);
+	/* absolute path : the job runs in its own directory, its script must not depend on the current one */
+	if(g_path_is_absolute(fileNamePrefix)) job->workDir = g_strdup_printf("%sJob%d",fileNamePrefix, index+1);
+	else
+	{
+		gchar* currentDir = g_get_current_dir();
+		job->workDir = g_strdup_printf("%s%s%sJob%d",currentDir, G_DIR_SEPARATOR_S, fileNamePrefix, index+1);
+		g_free(currentDir);
+	}
+	if(g_mkdir_with_parents(job->workDir, 0755)!=0)
+	{
+		g_free(job->workDir);
+		job->workDir = NULL;
+		job->status = JOBFAILED;
+		return NULL;
+	}
+	job->status = JOBWAITING;
+	return job->workDir;
+}
+/*****************************************************************************/
+gboolean addExternalJobCommand(ExternalJobsPool* pool, gint i, const gchar* command, const gchar* fileNameIn, const gchar* fileNameOut)
+{
+	FILE* fileSH = NULL;
+	ExternalJob* job = NULL;
+	if(!pool || i<0 || i>=pool->numberOfJobs) return FALSE;
+	job = &pool->jobs[i];
+	if(!job->workDir) return FALSE;
+#ifndef G_OS_WIN32
+	job->fileNameSH = g_strdup_printf("%s%sjob.sh",job->workDir,G_DIR_SEPARATOR_S);
+#else
+	job->fileNameSH = g_strdup_printf("%s%sjob.bat",job->workDir,G_DIR_SEPARATOR_S);
+#endif
+	job->fileNameIn = g_strdup(fileNameIn);
+	job->fileNameOut = g_strdup(fileNameOut);
+ 	fileSH = FOpen(job->fileNameSH, "w");
+	if(!fileSH)
+	{
+		job->status = JOBFAILED;
+		return FALSE;
+	}
+#ifdef G_OS_WIN32
+	/* with system(), the script is not started in the directory of the job */
+	addUnitDisk(fileSH, job->workDir);
+	fprintf(fileSH,"cd \"%s\"\n",job->workDir);
+#endif
+	fprintf(fileSH,"%s\n",command);
+	fclose(fileSH);
+	return TRUE;
+}
+/*****************************************************************************/
+static gchar* getJobStampName(ExternalJob* job)
+{
+	return g_strdup_printf("%s%s%s",job->workDir,G_DIR_SEPARATOR_S,JOBSTAMP);
+}
+/*****************************************************************************/
+static gboolean isResumableJob(ExternalJob* job)
+{
+	gchar* stamp = NULL;
+	gchar* oldInput = NULL;
+	gchar* newInput = NULL;
+	gsize oldLength = 0;
+	gsize newLength = 0;
+	gboolean ok = FALSE;
+
+	if(!job->fileNameIn || !job->fileNameOut) return FALSE;
+	if(!g_file_test(job->fileNameOut, G_FILE_TEST_EXISTS)) return FALSE;
+	stamp = getJobStampName(job);
+	if(g_file_get_contents(stamp, &oldInput, &oldLength, NULL) &&
+	   g_file_get_contents(job->fileNameIn, &newInput, &newLength, NULL))
+		ok = (oldLength==newLength && !memcmp(oldInput, newInput, newLength));
+	if(oldInput) g_free(oldInput);
+	if(newInput) g_free(newInput);
+	g_free(stamp);
+	return ok;
+}
+/*****************************************************************************/
+static void stampJob(ExternalJob* job)
+{
+	gchar* stamp = NULL;
+	gchar* input = NULL;
+	gsize length = 0;
+	if(!job->fileNameIn) return;
+	if(!g_file_get_contents(job->fileNameIn, &input, &length, NULL)) return;
+	stamp = getJobStampName(job);
+	g_file_set_contents(stamp, input, length, NULL);
+	g_free(stamp);
+	g_free(input);
+}
+/*****************************************************************************/
+#ifndef G_OS_WIN32
+static void setGroupExternalJob(gpointer data G_GNUC_UNUSED)
+{
+	/* own process group : a cancel kills the script and the program it launched.
+	 * data is required by GSpawnChildSetupFunc, NULL here */
+	setpgid(0,0);
+}
+#endif
+/*****************************************************************************/
+static gboolean startExternalJob(ExternalJob* job)
+{
+#ifndef G_OS_WIN32
+	gchar* argv[3];
+	GPid pid;
+	GError* error = NULL;
+
+	if(job->fileNameOut) unlink(job->fileNameOut);
+	argv[0] = "/bin/sh";
+	argv[1] = job->fileNameSH;
+	argv[2] = NULL;
+	if(!g_spawn_async(job->workDir, argv, NULL, G_SPAWN_DO_NOT_REAP_CHILD, setGroupExternalJob, NULL, &pid, &error))
+	{
+		if(error)
+		{
+			printf("%s\n",error->message);
+			g_error_free(error);
+		}
+		return FALSE;
+	}
+	job->pid = (gint)pid;
+#else
+	gchar* buffer = g_strdup_printf("\"%s\"",job->fileNameSH);
+	{int ierr= system(buffer);}
+	g_free(buffer);
+	job->pid = -1;
+#endif
+	job->status = JOBRUNNING;
+	return TRUE;
+}
+/*****************************************************************************/
+static gboolean isFinishedExternalJob(ExternalJob* job)
+{
+#ifndef G_OS_WIN32
+	gint status;
+	if(job->pid<0) return TRUE;
+	if(waitpid((pid_t)job->pid, &status, WNOHANG)==0) return FALSE;
+	job->pid = -1;
+#endif
+	return TRUE;
+}
+/*****************************************************************************/
+static void cancelExternalJob(ExternalJob* job)
+{
+#ifndef G_OS_WIN32
+	gint status;
+	if(job->pid>0)
+	{
+		kill(-(pid_t)job->pid, SIGTERM);
+		waitpid((pid_t)job->pid, &status, 0);
+	}
+#endif
+	job->pid = -1;
+	job->status = JOBCANCELED;
+}
+/*****************************************************************************/
+static void showExternalJobsProgress(ExternalJobsPool* pool, gint nFinished, gint nRunning)
+{
+	gchar* str = g_strdup_printf(_("%s : %d/%d jobs finished, %d running... Please wait"),
+			pool->title, nFinished, pool->numberOfJobs, nRunning);
+	set_text_to_draw(str);
+	drawGeom();
+	g_free(str);
+}
+/*****************************************************************************/
+/* returns the number of jobs successfully collected */
+gint runExternalJobsPool(ExternalJobsPool* pool)
+{
+	gint i;
+	gint next = 0;
+	gint nRunning = 0;
+	gint nFinished = 0;
+	gint nOK = 0;
+
+	if(!pool) return 0;
+	for(i=0;i<pool->numberOfJobs;i++)
+	{
+		ExternalJob* job = &pool->jobs[i];
+		if(job->status != JOBWAITING) { nFinished++; continue; }
+		if(!isResumableJob(job)) continue;
+		if(pool->collect && pool->collect(job, pool->data))
+		{
+			job->status = JOBDONE;
+			job->resumed = TRUE;
+			nFinished++;
+			nOK++;
+		}
+	}
+	showExternalJobsProgress(pool, nFinished, nRunning);
+	while(TRUE)
+	{
+		gboolean changed = FALSE;
+		if(StopCalcul)
+		{
+			for(i=0;i<pool->numberOfJobs;i++)
+				if(pool->jobs[i].status == JOBRUNNING) cancelExternalJob(&pool->jobs[i]);
+			break;
+		}
+		while(nRunning<pool->maxRunning && next<pool->numberOfJobs)
+		{
+			ExternalJob* job = &pool->jobs[next++];
+			if(job->status != JOBWAITING) continue;
+			if(startExternalJob(job)) nRunning++;
+			else { job->status = JOBFAILED; nFinished++; }
+			changed = TRUE;
+		}
+		if(nRunning==0 && next>=pool->numberOfJobs) break;
+		for(i=0;i<pool->numberOfJobs;i++)
+		{
+			ExternalJob* job = &pool->jobs[i];
+			if(job->status != JOBRUNNING) continue;
+			if(!isFinishedExternalJob(job)) continue;
+			nRunning--;
+			nFinished++;
+			changed = TRUE;
+			if(pool->collect && pool->collect(job, pool->data))
+			{
+				job->status = JOBDONE;
+				stampJob(job);
+				nOK++;
+			}
+			else job->status = JOBFAILED;
+		}
+		if(changed) showExternalJobsProgress(pool, nFinished, nRunning);
+    		while( gtk_events_pending() ) gtk_main_iteration();
+		if(!changed) g_usleep(50000);
+	}
+	set_text_to_draw(" ");
+	return nOK;
+}
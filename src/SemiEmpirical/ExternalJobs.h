@@ -0,0 +1,65 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#ifndef __GABEDIT_EXTERNALJOBS_H__
+#define __GABEDIT_EXTERNALJOBS_H__
+
+typedef struct _ExternalJob  ExternalJob;
+typedef struct _ExternalJobsPool  ExternalJobsPool;
+
+typedef enum
+{
+	JOBWAITING = 0,
+	JOBRUNNING,
+	JOBDONE,
+	JOBFAILED,
+	JOBCANCELED
+} ExternalJobStatus;
+
+typedef gboolean (*ExternalJobCollect)(ExternalJob* job, gpointer data);
+
+struct _ExternalJob
+{
+	gint index;
+	gchar* workDir;
+	gchar* fileNameSH;
+	gchar* fileNameIn;
+	gchar* fileNameOut;
+	gint pid;
+	gboolean resumed;
+	ExternalJobStatus status;
+};
+struct _ExternalJobsPool
+{
+	gint numberOfJobs;
+	ExternalJob* jobs;
+	gint maxRunning;
+	ExternalJobCollect collect;
+	gpointer data;
+	gchar* title;
+};
+
+ExternalJobsPool* newExternalJobsPool(gint numberOfJobs, gint maxRunning, const gchar* title, ExternalJobCollect collect, gpointer data);
+gchar* setExternalJob(ExternalJobsPool* pool, gint i, gint index, const gchar* fileNamePrefix);
+gboolean addExternalJobCommand(ExternalJobsPool* pool, gint i, const gchar* command, const gchar* fileNameIn, const gchar* fileNameOut);
+gint runExternalJobsPool(ExternalJobsPool* pool);
+void freeExternalJobsPool(ExternalJobsPool* pool);
+gint getDefaultNumberOfExternalJobs();
+
+#endif /* __GABEDIT_EXTERNALJOBS_H__ */
+
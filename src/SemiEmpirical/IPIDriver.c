@@ -0,0 +1,400 @@
+/* IPIDriver.c */
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#include "../../Config.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#ifndef G_OS_WIN32
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#include "../Common/Global.h"
+#include "../Utils/Constants.h"
+#include "../Geometry/Fragments.h"
+#include "../Geometry/DrawGeom.h"
+#include "../SemiEmpirical/AtomSE.h"
+#include "../SemiEmpirical/MoleculeSE.h"
+#include "../SemiEmpirical/IPIDriver.h"
+
+/* i-PI protocol : messages are 12 characters padded with blanks, data in native binary, atomic units */
+#define IPIMSGLEN 12
+/* the engine must connect before IPITIMEOUT ms */
+#define IPITIMEOUT 120000
+/* cubic box (bohr) given to the engine, a molecule is not periodic */
+#define IPIBOX 200.0
+#ifndef G_OS_WIN32
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+struct _IPIDriver
+{
+	gint refCount;
+	gint nAtoms;
+	gint pid;
+	gint listenSocket;
+	gint socket;
+	gchar* socketDir;
+	gchar* socketName;
+	gboolean initialized;
+	gdouble* buffer;
+};
+/*****************************************************************************/
+gboolean isIPICommand(const gchar* command)
+{
+	if(!command) return FALSE;
+	return !strncmp(command, IPIPREFIX, strlen(IPIPREFIX));
+}
+/*****************************************************************************/
+const gchar* getIPIClientCommand(const gchar* command)
+{
+	if(!isIPICommand(command)) return command;
+	command += strlen(IPIPREFIX);
+	while(*command==' ') command++;
+	return command;
+}
+/*****************************************************************************/
+gboolean isValidIPIDriver(IPIDriver* driver)
+{
+	return driver && driver->socket>=0;
+}
+/*****************************************************************************/
+IPIDriver* refIPIDriver(IPIDriver* driver)
+{
+	if(driver) driver->refCount++;
+	return driver;
+}
+#ifndef G_OS_WIN32
+/*****************************************************************************/
+static gboolean writeIPI(IPIDriver* driver, const void* data, gsize size)
+{
+	const gchar* p = (const gchar*)data;
+	while(size>0)
+	{
+		ssize_t n = send(driver->socket, p, size, MSG_NOSIGNAL);
+		if(n<0 && errno==EINTR) continue;
+		if(n<=0) return FALSE;
+		p += n;
+		size -= n;
+	}
+	return TRUE;
+}
+/*****************************************************************************/
+/* a hung engine must not block Gabedit : wait by steps, a Stop or the end of the engine interrupts the wait */
+static gboolean waitIPI(IPIDriver* driver)
+{
+	while(TRUE)
+	{
+		struct pollfd pfd;
+		gint status;
+		gint n;
+		pfd.fd = driver->socket;
+		pfd.events = POLLIN;
+		n = poll(&pfd, 1, 100);
+		if(n>0) return TRUE;
+		if(n<0 && errno!=EINTR) return FALSE;
+    		while( gtk_events_pending() ) gtk_main_iteration();
+		if(StopCalcul) return FALSE;
+		if(driver->pid>0 && waitpid((pid_t)driver->pid, &status, WNOHANG)!=0)
+		{
+			driver->pid = -1;
+			return FALSE;
+		}
+	}
+	return FALSE;
+}
+/*****************************************************************************/
+static gboolean readIPI(IPIDriver* driver, void* data, gsize size)
+{
+	gchar* p = (gchar*)data;
+	while(size>0)
+	{
+		ssize_t n;
+		if(!waitIPI(driver)) return FALSE;
+		n = recv(driver->socket, p, size, 0);
+		if(n<0 && errno==EINTR) continue;
+		if(n<=0) return FALSE;
+		p += n;
+		size -= n;
+	}
+	return TRUE;
+}
+/*****************************************************************************/
+static gboolean writeIPIMessage(IPIDriver* driver, const gchar* message)
+{
+	gchar header[IPIMSGLEN];
+	gint len = strlen(message);
+	memset(header,' ',IPIMSGLEN);
+	memcpy(header, message, MIN(len,IPIMSGLEN));
+	return writeIPI(driver, header, IPIMSGLEN);
+}
+/*****************************************************************************/
+static gboolean readIPIMessage(IPIDriver* driver, gchar* message)
+{
+	gint i;
+	if(!readIPI(driver, message, IPIMSGLEN)) return FALSE;
+	message[IPIMSGLEN] = '\0';
+	for(i=IPIMSGLEN-1;i>=0 && message[i]==' ';i--) message[i] = '\0';
+	return TRUE;
+}
+/*****************************************************************************/
+static void closeIPIDriver(IPIDriver* driver)
+{
+	if(driver->socket>=0)
+	{
+		writeIPIMessage(driver, "EXIT");
+		close(driver->socket);
+		driver->socket = -1;
+	}
+	if(driver->listenSocket>=0)
+	{
+		close(driver->listenSocket);
+		driver->listenSocket = -1;
+	}
+	if(driver->socketName) unlink(driver->socketName);
+	if(driver->socketDir) rmdir(driver->socketDir);
+	if(driver->pid>0)
+	{
+		gint status;
+		gint i;
+		/* the engine has some time to exit cleanly */
+		for(i=0;i<20 && waitpid((pid_t)driver->pid, &status, WNOHANG)==0;i++) g_usleep(50000);
+		if(i==20)
+		{
+			kill(-(pid_t)driver->pid, SIGTERM);
+			waitpid((pid_t)driver->pid, &status, 0);
+		}
+		driver->pid = -1;
+	}
+}
+/*****************************************************************************/
+static void setGroupIPIDriver(gpointer data G_GNUC_UNUSED)
+{
+	/* own process group : the engine and its children are killed together. data : NULL */
+	setpgid(0,0);
+}
+/*****************************************************************************/
+static gboolean startIPIClient(IPIDriver* driver, const gchar* command, const gchar* workDir, const gchar* address)
+{
+	gchar* quotedAddress = g_shell_quote(address);
+	gchar* commandLine = g_strdup_printf("%s %s", getIPIClientCommand(command), quotedAddress);
+	gchar** argv = NULL;
+	GPid pid;
+	GError* error = NULL;
+	gboolean ok = FALSE;
+
+	if(g_shell_parse_argv(commandLine, NULL, &argv, &error))
+	{
+		g_setenv("GABEDIT_IPI_ADDRESS", address, TRUE);
+		ok = g_spawn_async(workDir, argv, NULL, G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD, 
+				setGroupIPIDriver, NULL, &pid, &error);
+		if(ok) driver->pid = (gint)pid;
+	}
+	if(error)
+	{
+		printf("%s\n",error->message);
+		g_error_free(error);
+	}
+	if(argv) g_strfreev(argv);
+	g_free(commandLine);
+	g_free(quotedAddress);
+	return ok;
+}
+/*****************************************************************************/
+static gboolean acceptIPIClient(IPIDriver* driver)
+{
+	gint t;
+	for(t=0;t<IPITIMEOUT;t+=100)
+	{
+		struct pollfd pfd;
+		gint status;
+		pfd.fd = driver->listenSocket;
+		pfd.events = POLLIN;
+		if(poll(&pfd, 1, 100)>0)
+		{
+			driver->socket = accept(driver->listenSocket, NULL, NULL);
+			return driver->socket>=0;
+		}
+    		while( gtk_events_pending() ) gtk_main_iteration();
+		if(StopCalcul) return FALSE;
+		if(waitpid((pid_t)driver->pid, &status, WNOHANG)!=0)
+		{
+			driver->pid = -1;
+			return FALSE;
+		}
+	}
+	return FALSE;
+}
+#endif
+/*****************************************************************************/
+void unrefIPIDriver(IPIDriver* driver)
+{
+	if(!driver) return;
+	driver->refCount--;
+	if(driver->refCount>0) return;
+#ifndef G_OS_WIN32
+	closeIPIDriver(driver);
+#endif
+	if(driver->socketName) g_free(driver->socketName);
+	if(driver->socketDir) g_free(driver->socketDir);
+	if(driver->buffer) g_free(driver->buffer);
+	g_free(driver);
+}
+/*****************************************************************************/
+/* if the engine cannot be started, the driver is not valid and the caller uses the input/output files */
+IPIDriver* newIPIDriver(const gchar* command, const gchar* workDir, gint nAtoms)
+{
+#ifdef G_OS_WIN32
+	return NULL;
+#else
+	IPIDriver* driver = NULL;
+	struct sockaddr_un serverAddress;
+
+	if(!isIPICommand(command) || nAtoms<1) return NULL;
+	driver = g_malloc(sizeof(IPIDriver));
+	driver->refCount = 1;
+	driver->nAtoms = nAtoms;
+	driver->pid = -1;
+	driver->socket = -1;
+	driver->initialized = FALSE;
+	driver->buffer = g_malloc(3*nAtoms*sizeof(gdouble));
+	driver->listenSocket = -1;
+	/* the socket is created in a private directory (mode 0700), its name cannot be taken by another user */
+	driver->socketDir = g_dir_make_tmp("gabeditIPI_XXXXXX", NULL);
+	driver->socketName = NULL;
+	if(driver->socketDir) driver->socketName = g_strdup_printf("%s%sipi",driver->socketDir,G_DIR_SEPARATOR_S);
+
+	memset(&serverAddress, 0, sizeof(serverAddress));
+	serverAddress.sun_family = AF_UNIX;
+	if(driver->socketName && strlen(driver->socketName)<sizeof(serverAddress.sun_path))
+	{
+		strncpy(serverAddress.sun_path, driver->socketName, sizeof(serverAddress.sun_path)-1);
+		driver->listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+	}
+	if(driver->listenSocket<0
+	|| bind(driver->listenSocket, (struct sockaddr*)&serverAddress, sizeof(serverAddress))<0
+	|| listen(driver->listenSocket, 1)<0
+	|| !startIPIClient(driver, command, workDir, driver->socketName)
+	|| !acceptIPIClient(driver))
+	{
+		printf("I cannot start the i-PI engine \"%s\", input/output files are used\n", getIPIClientCommand(command));
+		closeIPIDriver(driver);
+		return driver;
+	}
+	/* one client only */
+	close(driver->listenSocket);
+	driver->listenSocket = -1;
+	unlink(driver->socketName);
+	return driver;
+#endif
+}
+/*****************************************************************************/
+/* energy in kcal/mol, gradient in kcal/mol/Ang */
+gboolean computeIPIDriver(IPIDriver* driver, MoleculeSE* mol)
+{
+#ifdef G_OS_WIN32
+	return FALSE;
+#else
+	gchar message[IPIMSGLEN+1];
+	gdouble cell[9];
+	gdouble inverseCell[9];
+	gdouble virial[9];
+	gdouble energy;
+	gint32 nAtoms;
+	gint32 len;
+	gint i;
+	gint k;
+
+	if(!isValidIPIDriver(driver) || mol->nAtoms != driver->nAtoms) return FALSE;
+	for(k=0;k<9;k++) cell[k] = inverseCell[k] = 0.0;
+	for(k=0;k<3;k++) { cell[4*k] = IPIBOX; inverseCell[4*k] = 1.0/IPIBOX; }
+
+	while(TRUE)
+	{
+		if(!writeIPIMessage(driver, "STATUS") || !readIPIMessage(driver, message)) break;
+		if(!strcmp(message,"NEEDINIT"))
+		{
+			gint32 bead = 0;
+			gchar* init = g_strdup_printf("charge=%d multiplicity=%d", mol->totalCharge, mol->spinMultiplicity);
+			len = strlen(init);
+			if(!writeIPIMessage(driver, "INIT") || !writeIPI(driver, &bead, sizeof(gint32))
+			|| !writeIPI(driver, &len, sizeof(gint32)) || !writeIPI(driver, init, len))
+			{
+				g_free(init);
+				break;
+			}
+			g_free(init);
+			driver->initialized = TRUE;
+			continue;
+		}
+		if(!strcmp(message,"READY"))
+		{
+			for(i=0;i<mol->nAtoms;i++)
+			for(k=0;k<3;k++)
+				driver->buffer[3*i+k] = mol->atoms[i].coordinates[k]/BOHR_TO_ANG;
+			nAtoms = mol->nAtoms;
+			if(!writeIPIMessage(driver, "POSDATA") || !writeIPI(driver, cell, sizeof(cell))
+			|| !writeIPI(driver, inverseCell, sizeof(inverseCell)) || !writeIPI(driver, &nAtoms, sizeof(gint32))
+			|| !writeIPI(driver, driver->buffer, 3*nAtoms*sizeof(gdouble))) break;
+			continue;
+		}
+		if(!strcmp(message,"HAVEDATA"))
+		{
+			gchar* extra = NULL;
+			if(!writeIPIMessage(driver, "GETFORCE") || !readIPIMessage(driver, message)) break;
+			if(strcmp(message,"FORCEREADY")) break;
+			if(!readIPI(driver, &energy, sizeof(gdouble)) || !readIPI(driver, &nAtoms, sizeof(gint32))) break;
+			if(nAtoms != mol->nAtoms) break;
+			if(!readIPI(driver, driver->buffer, 3*nAtoms*sizeof(gdouble))) break;
+			if(!readIPI(driver, virial, sizeof(virial)) || !readIPI(driver, &len, sizeof(gint32)) || len<0) break;
+			extra = g_malloc(len+1);
+			if(!readIPI(driver, extra, len)) { g_free(extra); break; }
+			extra[len] = '\0';
+
+			mol->energy = energy*AUTOKCAL;
+			for(i=0;i<mol->nAtoms;i++)
+			for(k=0;k<3;k++)
+				mol->gradient[k][i] = -driver->buffer[3*i+k]*AUTOKCAL/BOHR_TO_ANG;
+			/* optional dipole (au) : {"dipole": [x, y, z]} */
+			{
+				gchar* d = strstr(extra,"dipole");
+				if(d) d = strchr(d,'[');
+				if(d && sscanf(d,"[%lf,%lf,%lf",&mol->dipole[0],&mol->dipole[1],&mol->dipole[2])==3)
+					for(k=0;k<3;k++) mol->dipole[k] *= AUTODEB;
+			}
+			g_free(extra);
+			return TRUE;
+		}
+		break;
+	}
+	/* stopped by the user, the engine died or does not follow the protocol */
+	if(!StopCalcul) printf("i-PI engine : communication failed, input/output files are used\n");
+	closeIPIDriver(driver);
+	return FALSE;
+#endif
+}
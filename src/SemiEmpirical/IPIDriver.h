@@ -0,0 +1,39 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#ifndef __GABEDIT_IPIDRIVER_H__
+#define __GABEDIT_IPIDRIVER_H__
+
+/* Persistent external engine speaking the i-PI socket protocol.
+ * A Generic command of the form "ipi:myProgram args" starts myProgram once; 
+ * the path of the unix socket, in a private temporary directory, is given as the last argument and in GABEDIT_IPI_ADDRESS.
+ */
+#define IPIPREFIX "ipi:"
+
+typedef struct _IPIDriver  IPIDriver;
+
+gboolean isIPICommand(const gchar* command);
+const gchar* getIPIClientCommand(const gchar* command);
+IPIDriver* newIPIDriver(const gchar* command, const gchar* workDir, gint nAtoms);
+IPIDriver* refIPIDriver(IPIDriver* driver);
+void unrefIPIDriver(IPIDriver* driver);
+gboolean isValidIPIDriver(IPIDriver* driver);
+gboolean computeIPIDriver(IPIDriver* driver, MoleculeSE* mol);
+
+#endif /* __GABEDIT_IPIDRIVER_H__ */
+
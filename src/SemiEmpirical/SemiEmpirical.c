@@ -34,6 +34,7 @@ DEALINGS IN THE SOFTWARE.
 #include "../SemiEmpirical/MoleculeSE.h"
 #include "../SemiEmpirical/SemiEmpiricalModel.h"
 #include "../SemiEmpirical/SemiEmpirical.h"
+#include "../SemiEmpirical/IPIDriver.h"
 
 static void calculateGradientMopac(SemiEmpiricalModel* seModel);
 static void calculateEnergyMopac(SemiEmpiricalModel* seModel);
@@ -206,7 +207,7 @@ static gboolean getGradientMopacAux(gchar* fileNameOut, SemiEmpiricalModel *seMo
 	return Ok;
 }
 /*****************************************************************************/
-static gboolean getGradientMopac(gchar* fileNameOut, SemiEmpiricalModel *seModel)
+gboolean getGradientMopac(gchar* fileNameOut, SemiEmpiricalModel *seModel)
 {
 	gboolean Ok = FALSE;
 	/* try to read gradients from mopac out file : more digits than those of aux */
@@ -400,7 +401,7 @@ static gboolean getEnergyFireFly(gchar* fileNameOut, gdouble* energy)
 	return OK;
 }
 /*****************************************************************************/
-static gboolean getGradientFireFly(gchar* fileNameOut, SemiEmpiricalModel *seModel)
+gboolean getGradientFireFly(gchar* fileNameOut, SemiEmpiricalModel *seModel)
 {
 	FILE* file = NULL;
 	gchar buffer[1024];
@@ -433,8 +434,8 @@ static gboolean getGradientFireFly(gchar* fileNameOut, SemiEmpiricalModel *seMod
 				}
 				for(j=0;j<3;j++) seModel->molecule.gradient[j][i] *= 627.50944796/BOHR_TO_ANG;
 			}
+			/* no break : after an optimization, the last gradient is that of the final geometry */
 			Ok = TRUE;
-			break;
 	 	}
 	 }
 	fclose(file);
@@ -974,7 +975,7 @@ char* runOneGeneric(SemiEmpiricalModel* seModel, char* keyWords)
 	char* fileNameSH = NULL;
 	char buffer[1024];
 	MoleculeSE* mol = &seModel->molecule;
-	char* NameCommandGeneric = seModel->method;
+	const char* NameCommandGeneric = getIPIClientCommand(seModel->method);
 	int rank = 0;
 	int type = 0;
 #ifdef ENABLE_MPI
@@ -1047,6 +1048,14 @@ static SemiEmpiricalModel newGenericModel(char* method, char* dirName, SemiEmpir
 	return seModel;
 }
 /**********************************************************************/
+/* persistent engine : started at the first call, input/output files are used if it fails */
+static gboolean computeGenericByDriver(SemiEmpiricalModel* seModel)
+{
+	if(!isIPICommand(seModel->method)) return FALSE;
+	if(!seModel->driver) seModel->driver = newIPIDriver(seModel->method, seModel->workDir, seModel->molecule.nAtoms);
+	return computeIPIDriver((IPIDriver*)seModel->driver, &seModel->molecule);
+}
+/**********************************************************************/
 static void calculateGradientGeneric(SemiEmpiricalModel* seModel)
 {
 	int i;
@@ -1057,6 +1066,7 @@ static void calculateGradientGeneric(SemiEmpiricalModel* seModel)
 	if(!seModel) return;
 	if(seModel->molecule.nAtoms<1) return;
 	if(!seModel->method) return;
+	if(computeGenericByDriver(seModel)) return;
 	keyWords = g_strdup_printf("%s ENGRAD ",seModel->method);
 	fileOut = runOneGeneric(seModel, keyWords);
 
@@ -1094,6 +1104,7 @@ static void calculateEnergyGeneric(SemiEmpiricalModel* seModel)
 	if(!seModel) return;
 	if(seModel->molecule.nAtoms<1) return;
 	if(!seModel->method) return;
+	if(computeGenericByDriver(seModel)) return;
 	keyWords = g_strdup_printf("%s ",seModel->method);
 	fileOut = runOneGeneric(seModel, keyWords);
 	if(fileOut)
@@ -23,6 +23,9 @@ SemiEmpiricalModel createMopacModel(GeomDef* geom,gint Natoms,gint charge, gint
 SemiEmpiricalModel createFireFlyModel(GeomDef* geom,gint Natoms, gint charge, gint spin, gchar* keywords, gchar* dirName, SemiEmpiricalModelConstraints constraints);
 SemiEmpiricalModel createOpenBabelModel (GeomDef* geom,gint Natoms,gint charge, gint spin, gchar* method, gchar* dirName, SemiEmpiricalModelConstraints constraints);
 SemiEmpiricalModel createGenericModel (GeomDef* geom,gint Natoms,gint charge, gint spin, gchar* method, gchar* dirName, SemiEmpiricalModelConstraints constraints);
+gboolean getGradientMopac(gchar* fileNameOut, SemiEmpiricalModel *seModel);
+gboolean getGradientFireFly(gchar* fileNameOut, SemiEmpiricalModel *seModel);
+gboolean getGradientGeneric(char* fileNameOut, SemiEmpiricalModel *seModel);
 
 #endif /* __GABEDIT_SEMIEMPIRICAL_H__ */
 
@@ -40,6 +40,12 @@ DEALINGS IN THE SOFTWARE.
 #include "SemiEmpirical.h"
 #include "SemiEmpiricalMD.h"
 #include "SemiEmpiricalDlg.h"
+#include "ExternalJobs.h"
+#include "IPIDriver.h"
+#include "../MolecularMechanics/Atom.h"
+#include "../MolecularMechanics/Molecule.h"
+#include "../MolecularMechanics/ForceField.h"
+#include "../MolecularMechanics/FiniteDifferences.h"
 
 typedef enum
 {
@@ -1948,13 +1954,13 @@ static gboolean runOneGeneric(MoleculeSE* mol, char* fileNamePrefix, char* keyWo
     		while( gtk_events_pending() ) gtk_main_iteration();
 	}
 #ifndef OS_WIN32
-	fprintf(fileSH,"%s %s %s",genericCommand,fileNameIn,fileNameOut);
+	fprintf(fileSH,"%s %s %s",getIPIClientCommand(genericCommand),fileNameIn,fileNameOut);
 	fclose(fileSH);
 	sprintf(buffer,"chmod u+x %s",fileNameSH);
 	system(buffer);
 	system(fileNameSH);
 #else
-	fprintf(fileSH,"\"%s\" \"%s\" \"%s\"",genericCommand,fileNameIn,fileNameOut);
+	fprintf(fileSH,"\"%s\" \"%s\" \"%s\"",getIPIClientCommand(genericCommand),fileNameIn,fileNameOut);
 	fclose(fileSH);
 	sprintf(buffer,"\"%s\"",fileNameSH);
 	system(buffer);
@@ -3407,45 +3413,15 @@ static gboolean saveConfoGeometries(gint numberOfGeometries, SemiEmpiricalModel*
 
 }
 /*****************************************************************************/
-static gboolean runOneOptMopac(SemiEmpiricalModel* geom, gdouble* energy, gchar* fileNamePrefix, gchar* keyWords)
+static gboolean writeOptMopacInput(SemiEmpiricalModel* geom, gchar* fileNameIn, gchar* keyWords)
 {
 	FILE* file = NULL;
-	FILE* fileSH = NULL;
 	gint j;
-	gchar* fileNameIn = NULL;
-	gchar* fileNameOut = NULL;
-	gchar* fileNameSH = NULL;
 	gchar multiplicityStr[100];
-	gchar buffer[1024];
-	*energy = 0;
-#ifdef G_OS_WIN32
-	gchar c='%';
-#endif
-
-	if(!geom) return FALSE;
-	if(geom->molecule.nAtoms<1) return FALSE;
-#ifndef G_OS_WIN32
-	fileNameSH = g_strdup_printf("%sMopacOne.sh",fileNamePrefix);
-#else
-	fileNameSH = g_strdup_printf("%sMopacOne.bat",fileNamePrefix);
-#endif
- 	fileSH = FOpen(fileNameSH, "w");
-	if(!fileSH) return FALSE;
-#ifdef G_OS_WIN32
-	fprintf(fileSH,"set PATH=%cPATH%c;\"%s\"\n",c,c,mopacDirectory);
-#endif
 
 	getMultiplicityName(spinMultiplicity, multiplicityStr);
-
-	fileNameIn = g_strdup_printf("%sOne.mop",fileNamePrefix);
  	file = FOpen(fileNameIn, "w");
-	if(!file) 
-	{
- 		if(fileNameIn) g_free(fileNameIn);
- 		if(fileNameOut) g_free(fileNameOut);
- 		if(fileNameSH) g_free(fileNameSH);
-		return FALSE;
-	}
+	if(!file) return FALSE;
 	fprintf(file,"* ===============================\n");
 	fprintf(file,"* Input file for Mopac\n");
 	fprintf(file,"* ===============================\n");
@@ -3469,260 +3445,179 @@ static gboolean runOneOptMopac(SemiEmpiricalModel* geom, gdouble* energy, gchar*
 			);
 	}
 	fclose(file);
-	{
-		gchar* str = NULL;
-		if(strstr(keyWords,"XYZ") && strstr(keyWords,"PM7")) str = g_strdup_printf("Minimization by PM7/Mopac ... Please wait");
-		else if(strstr(keyWords,"XYZ") && strstr(keyWords,"PM6-DH2")) str = g_strdup_printf("Minimization by PM6-DH2/Mopac ... Please wait");
-		else if(strstr(keyWords,"XYZ") && strstr(keyWords,"PM6-DH+")) str = g_strdup_printf("Minimization by PM6-DH+/Mopac ... Please wait");
-		else if(strstr(keyWords,"SPARKLE") && strstr(keyWords,"PM6")) str = g_strdup_printf("Minimization by Sparkle/PM6/Mopac ... Please wait");
-		else if(strstr(keyWords,"SPARKLE") && strstr(keyWords,"AM1")) str = g_strdup_printf("Minimization by Sparkle/AM1/Mopac ... Please wait");
-		else if(strstr(keyWords,"SPARKLE") && strstr(keyWords,"PM3")) str = g_strdup_printf("Minimization by Sparkle/PM3/Mopac ... Please wait");
-		else if(strstr(keyWords,"XYZ") && strstr(keyWords,"PM6")) str = g_strdup_printf("Minimization by PM6/Mopac ... Please wait");
-		else if(strstr(keyWords,"XYZ") && strstr(keyWords,"AM1")) str = g_strdup_printf("Minimization by AM1/Mopac ... Please wait");
-		else if(strstr(keyWords,"ESP") && strstr(keyWords,"PM6-DH2")) str = g_strdup_printf("ESP charges from PM6-DH2/Mopac ... Please wait");
-		else if(strstr(keyWords,"ESP") && strstr(keyWords,"PM6-DH+")) str = g_strdup_printf("ESP charges from PM6-DH+/Mopac ... Please wait");
-		else if(strstr(keyWords,"ESP") && strstr(keyWords,"PM6")) str = g_strdup_printf("ESP charges from PM6/Mopac ... Please wait");
-		else if(strstr(keyWords,"ESP") && strstr(keyWords,"PM7")) str = g_strdup_printf("ESP charges from PM7/Mopac ... Please wait");
-		else if(strstr(keyWords,"ESP") && strstr(keyWords,"AM1")) str = g_strdup_printf("ESP charges from AM1/Mopac ... Please wait");
-		else if(strstr(keyWords,"PM6-DH2")) str = g_strdup_printf("Computing of energy by PM6-DH2/Mopac .... Please wait");
-		else if(strstr(keyWords,"PM6-DH+")) str = g_strdup_printf("Computing of energy by PM6-DH+/Mopac .... Please wait");
-		else if(strstr(keyWords,"PM6")) str = g_strdup_printf("Computing of energy by PM6/Mopac .... Please wait");
-		else if(strstr(keyWords,"PM7")) str = g_strdup_printf("Computing of energy by PM7/Mopac .... Please wait");
-		else str = g_strdup_printf("Computing of energy by AM1/Mopac .... Please wait");
-		set_text_to_draw(str);
-		if(str) g_free(str);
-		drawGeom();
-    		while( gtk_events_pending() ) gtk_main_iteration();
-	}
-#ifndef G_OS_WIN32
-	fprintf(fileSH,"%s %s\n",NameCommandMopac,fileNameIn);
-	fclose(fileSH);
-	sprintf(buffer,"chmod u+x %s",fileNameSH);
-	{int ierr= system(buffer);}
-	{int ierr = system(fileNameSH);}
-#else
-	fprintf(fileSH,"\"%s\" \"%s\"\n",NameCommandMopac,fileNameIn);
-	fclose(fileSH);
-	sprintf(buffer,"\"%s\"",fileNameSH);
-	{int ierr= system(buffer);}
-#endif
+	return TRUE;
+}
+/*****************************************************************************/
+typedef gboolean (*WriteInputSE)(SemiEmpiricalModel* geom, gchar* fileNameIn, gchar* keyWords);
+typedef gboolean (*ReadEnergySE)(gchar* fileNameOut, gdouble* energy);
+typedef void (*ReadGeometrySE)(gchar* fileNameOut, SemiEmpiricalModel* geom);
+typedef struct _SemiEmpiricalJobsData
+{
+	SemiEmpiricalModel** geometries;
+	gdouble* energies;
+	ReadEnergySE readEnergy;
+	ReadGeometrySE readGeometry; /* geometry and gradient */
+}SemiEmpiricalJobsData;
+/*****************************************************************************/
+/* Mopac & FireFly : reading of the geometry uses the global geometry */
+static void readGeometryMopacJob(gchar* fileNameOut, SemiEmpiricalModel* geom)
+{
+	gint charge = geom->molecule.totalCharge;
+	gint spin = geom->molecule.spinMultiplicity;
 
-	fileNameOut = g_strdup_printf("%sOne.out",fileNamePrefix);
-	if(getEnergyMopac(fileNameOut,energy))
-	{
-		gchar* str = NULL;
+	read_geom_from_mopac_output_file(fileNameOut, -1);
+	freeMoleculeSE(&geom->molecule);
+	geom->molecule = createFromGeomXYZMoleculeSE(charge, spin, TRUE);
+	if(!getGradientMopac(fileNameOut, geom)) printf("I cannot read the gradient from %s file\n",fileNameOut);
+}
+/*****************************************************************************/
+static void readGeometryFireFlyJob(gchar* fileNameOut, SemiEmpiricalModel* geom)
+{
+	gint charge = geom->molecule.totalCharge;
+	gint spin = geom->molecule.spinMultiplicity;
 
-		read_geom_from_mopac_output_file(fileNameOut, -1);
-		str = g_strdup_printf("Energy by Mopac = %f", *energy);
-		set_text_to_draw(str);
-		drawGeom();
-    		while( gtk_events_pending() ) gtk_main_iteration();
-		Waiting(1);
-		if(str) g_free(str);
-	}
-	else
+	read_geom_from_gamess_output_file(fileNameOut, -1);
+	freeMoleculeSE(&geom->molecule);
+	geom->molecule = createFromGeomXYZMoleculeSE(charge, spin, TRUE);
+	if(!getGradientFireFly(fileNameOut, geom)) printf("I cannot read the gradient from %s file\n",fileNameOut);
+}
+/*****************************************************************************/
+static void readGeometryOpenBabelJob(gchar* fileNameOut, SemiEmpiricalModel* geom)
+{
+	readGeomMoleculeSEFromOpenBabelOutputFile(&geom->molecule, fileNameOut, -1);
+}
+/*****************************************************************************/
+static void readGeometryGenericJob(gchar* fileNameOut, SemiEmpiricalModel* geom)
+{
+	readGeometryFromGenericOutputFile(&geom->molecule, fileNameOut);
+	if(!getGradientGeneric(fileNameOut, geom)) printf("I cannot read the gradient from %s file\n",fileNameOut);
+}
+/*****************************************************************************/
+/* called on the GTK thread by the pool */
+static gboolean collectSemiEmpiricalJob(ExternalJob* job, gpointer data)
+{
+	SemiEmpiricalJobsData* jobsData = (SemiEmpiricalJobsData*)data;
+	SemiEmpiricalModel* geom = jobsData->geometries[job->index];
+
+	if(!jobsData->readEnergy(job->fileNameOut,&jobsData->energies[job->index]))
 	{
-		printf("I cannot read energy = from %s file\n",fileNameOut);
- 		if(fileNameIn) g_free(fileNameIn);
- 		if(fileNameOut) g_free(fileNameOut);
- 		if(fileNameSH) g_free(fileNameSH);
+		printf("I cannot read energy = from %s file\n",job->fileNameOut);
 		return FALSE;
 	}
-
- 	if(fileNameIn) g_free(fileNameIn);
- 	if(fileNameOut) g_free(fileNameOut);
- 	if(fileNameSH) g_free(fileNameSH);
+	jobsData->readGeometry(job->fileNameOut, geom);
+	geom->molecule.energy = jobsData->energies[job->index];
 	return TRUE;
 }
 /*****************************************************************************/
-static gboolean runMopacFiles(gint numberOfGeometries, SemiEmpiricalModel** geometries, gdouble* energies, gchar* fileNamePrefix, gchar* keyWords)
+static gboolean runSemiEmpiricalJobs(gint numberOfGeometries, SemiEmpiricalModel** geometries, gdouble* energies, gchar* fileNamePrefix, gchar* keyWords, 
+		gchar* title, gchar* fileNameIn, WriteInputSE writeInput, gchar* command, SemiEmpiricalJobsData* jobsData)
 {
 	gint i;
 	gint nG = 0;
 	gint nM = 0;
-	gchar* str = NULL;
+	ExternalJobsPool* pool = NULL;
+
+	for(i=0;i<numberOfGeometries;i++) if(geometries[i]) nG++;
+	if(nG==0) return TRUE;
+	jobsData->geometries = geometries;
+	jobsData->energies = energies;
+	pool = newExternalJobsPool(nG, getDefaultNumberOfExternalJobs(), title, collectSemiEmpiricalJob, jobsData);
+	nG = 0;
 	for(i=0;i<numberOfGeometries;i++)
 	{
+		gchar* workDir = NULL;
+		gchar* fileNameInJob = NULL;
+		gchar* fileNameOutJob = NULL;
 		if(!geometries[i]) continue;
-		nG++;
-		if(str) g_free(str);
-		str = g_strdup_printf("Minimization by Mopac of geometry n = %d... Please wait", i+1);
-		set_text_to_draw(str);
-		drawGeom();
-    		while( gtk_events_pending() ) gtk_main_iteration();
-		if(runOneOptMopac(geometries[i], &energies[i], fileNamePrefix, keyWords)) 
+		energies[i] = 0;
+		workDir = setExternalJob(pool, nG, i, fileNamePrefix);
+		if(workDir && geometries[i]->molecule.nAtoms>0)
 		{
-			freeMoleculeSE(&geometries[i]->molecule);
-			/*
-			geometries[i]->molecule = createMoleculeSE(geometry0,Natoms,
-			geometries[i]->molecule.totalCharge,
-			geometries[i]->molecule.spinMultiplicity);
-			*/
-			geometries[i]->molecule = createFromGeomXYZMoleculeSE(
-			geometries[i]->molecule.totalCharge,
-			geometries[i]->molecule.spinMultiplicity,TRUE);
-			nM++;
+			fileNameInJob = g_strdup_printf("%s%s%s",workDir,G_DIR_SEPARATOR_S,fileNameIn);
+			fileNameOutJob = g_strdup_printf("%s%sOne.out",workDir,G_DIR_SEPARATOR_S);
+			if(!writeInput(geometries[i], fileNameInJob, keyWords) 
+			|| !addExternalJobCommand(pool, nG, command, fileNameInJob, fileNameOutJob))
+				pool->jobs[nG].status = JOBFAILED;
+			g_free(fileNameInJob);
+			g_free(fileNameOutJob);
 		}
-		if(StopCalcul) break;
+		else pool->jobs[nG].status = JOBFAILED;
+		nG++;
 	}
-	if(str) g_free(str);
+	nM = runExternalJobsPool(pool);
+	freeExternalJobsPool(pool);
 	if(nM==nG) return TRUE;
 	return FALSE;
-
 }
 /*****************************************************************************/
-static gboolean runOneOptGeneric(SemiEmpiricalModel* geom, double* energy, char* fileNamePrefix, char* keyWords, char* genericCommand)
+static gboolean runMopacFiles(gint numberOfGeometries, SemiEmpiricalModel** geometries, gdouble* energies, gchar* fileNamePrefix, gchar* keyWords)
 {
-	FILE* file = NULL;
-	FILE* fileSH = NULL;
-	char* fileNameIn = NULL;
-	char* fileNameOut = NULL;
-	char* fileNameSH = NULL;
-	char buffer[1024];
-	int type = 0;
-	MoleculeSE* mol = &geom->molecule;
-	*energy = 0;
-#ifdef OS_WIN32
-	char c='%';
+	gboolean ok;
+	gchar* command = NULL;
+	SemiEmpiricalJobsData jobsData;
+#ifdef G_OS_WIN32
+	gchar c='%';
 #endif
 
-	if(!geom) return FALSE;
-	if(geom->molecule.nAtoms<1) return FALSE;
-#ifndef OS_WIN32
-	fileNameSH = g_strdup_printf("%sGeneOne.sh",fileNamePrefix);
+	jobsData.readEnergy = getEnergyMopac;
+	jobsData.readGeometry = readGeometryMopacJob;
+#ifndef G_OS_WIN32
+	command = g_strdup_printf("%s One.mop",NameCommandMopac);
 #else
-	fileNameSH = g_strdup_printf("%sGeneOne.bat",fileNamePrefix);
+	command = g_strdup_printf("set PATH=%cPATH%c;\"%s\"\n\"%s\" \"One.mop\"",c,c,mopacDirectory,NameCommandMopac);
 #endif
- 	fileSH = fopen(fileNameSH, "w");
-	if(!fileSH) return FALSE;
-
-	fileNameIn = g_strdup_printf("%sOne.inp",fileNamePrefix);
-	fileNameOut = g_strdup_printf("%sOne.out",fileNamePrefix);
+	ok = runSemiEmpiricalJobs(numberOfGeometries, geometries, energies, fileNamePrefix, keyWords, 
+			_("Mopac"), "One.mop", writeOptMopacInput, command, &jobsData);
+	g_free(command);
+	return ok;
+}
+/*****************************************************************************/
+static gboolean writeOptGenericInput(SemiEmpiricalModel* geom, gchar* fileNameIn, gchar* keyWords)
+{
+	FILE* file = NULL;
+	gint type = 0;
 
- 	file = fopen(fileNameIn, "w");
-	if(!file) 
-	{
- 		if(fileNameIn) free(fileNameIn);
- 		if(fileNameOut) free(fileNameOut);
- 		if(fileNameSH) free(fileNameSH);
-		return FALSE;
-	}
- 	file = fopen(fileNameIn, "w");
-	if(!file) 
-	{
- 		if(fileNameIn) free(fileNameIn);
- 		if(fileNameOut) free(fileNameOut);
- 		if(fileNameSH) free(fileNameSH);
-		return FALSE;
-	}
+ 	file = FOpen(fileNameIn, "w");
+	if(!file) return FALSE;
 	if(strstr(keyWords,"Opt")) type = 2;
 	if(strstr(keyWords,"ENGRAD")) type = 1;
 	fprintf(file,"%d\n",type);
-	addMoleculeSEToFile(mol,file);
+	addMoleculeSEToFile(&geom->molecule,file);
 	fclose(file);
-	{
-		char* str = NULL;
-		if(strstr(keyWords,"OPT")) str = g_strdup_printf("Minimization by Generic/%s ... Please wait",genericCommand);
-		else str = g_strdup_printf("Computing of energy by Generic/%s .... Please wait",genericCommand);
-		/*printf(str);*/
-		set_text_to_draw(str);
-		if(str) g_free(str);
-		drawGeom();
-    		while( gtk_events_pending() ) gtk_main_iteration();
-	}
-#ifndef OS_WIN32
-	fprintf(fileSH,"%s %s %s",genericCommand,fileNameIn,fileNameOut);
-	fclose(fileSH);
-	sprintf(buffer,"chmod u+x %s",fileNameSH);
-	system(buffer);
-	system(fileNameSH);
-#else
-	fprintf(fileSH,"\"%s\" \"%s\" \"%s\"",genericCommand,fileNameIn,fileNameOut);
-	fclose(fileSH);
-	sprintf(buffer,"\"%s\"",fileNameSH);
-	system(buffer);
-#endif
-	if(getEnergyGeneric(fileNameOut,energy))
-	{
-		printf("Energy by Generic = %f\n", *energy);
-		readGeometryFromGenericOutputFile(mol,fileNameOut);
-	}
-	else
-	{
- 		if(fileNameIn) free(fileNameIn);
- 		if(fileNameOut) free(fileNameOut);
- 		if(fileNameSH) free(fileNameSH);
-		return FALSE;
-	}
-
- 	if(fileNameIn) free(fileNameIn);
- 	if(fileNameOut) free(fileNameOut);
- 	if(fileNameSH) free(fileNameSH);
 	return TRUE;
 }
 /*****************************************************************************/
-static gboolean runGenericFiles(int numberOfGeometries, SemiEmpiricalModel** geometries, double* energies, char* fileNamePrefix, char* keyWords, char* genericCommand)
+static gboolean runGenericFiles(gint numberOfGeometries, SemiEmpiricalModel** geometries, gdouble* energies, gchar* fileNamePrefix, gchar* keyWords, gchar* genericCommand)
 {
-	int i;
-	int nG = 0;
-	int nM = 0;
-	char* str = NULL;
-	for(i=0;i<numberOfGeometries;i++)
-	{
-		if(!geometries[i]) continue;
-		nG++;
-		if(str) free(str);
-		printf("Minimization by Generic of geometry n = %d... Please wait\n", i+1);
-		if(runOneOptGeneric(geometries[i], &energies[i], fileNamePrefix, keyWords, genericCommand)) 
-		{
-			nM++;
-		}
-	}
-	if(str) free(str);
-	if(nM==nG) return TRUE;
-	return FALSE;
+	gboolean ok;
+	gchar* command = NULL;
+	gchar* title = NULL;
+	SemiEmpiricalJobsData jobsData;
 
+	jobsData.readEnergy = getEnergyGeneric;
+	jobsData.readGeometry = readGeometryGenericJob;
+#ifndef G_OS_WIN32
+	/* a i-PI engine ("ipi:program") is run here as a one-shot program using input/output files */
+	command = g_strdup_printf("%s One.inp One.out",getIPIClientCommand(genericCommand));
+#else
+	command = g_strdup_printf("\"%s\" \"One.inp\" \"One.out\"",getIPIClientCommand(genericCommand));
+#endif
+	title = g_strdup_printf("Generic/%s",genericCommand);
+	ok = runSemiEmpiricalJobs(numberOfGeometries, geometries, energies, fileNamePrefix, keyWords, 
+			title, "One.inp", writeOptGenericInput, command, &jobsData);
+	g_free(title);
+	g_free(command);
+	return ok;
 }
 /*****************************************************************************/
-static gboolean runOneOptFireFly(SemiEmpiricalModel* geom, gdouble* energy, gchar* fileNamePrefix, gchar* keyWords)
+static gboolean writeOptFireFlyInput(SemiEmpiricalModel* geom, gchar* fileNameIn, gchar* keyWords)
 {
 	FILE* file = NULL;
-	FILE* fileSH = NULL;
 	gint j;
-	gchar* fileNameIn = NULL;
-	gchar* fileNameOut = NULL;
-	gchar* fileNameSH = NULL;
-	gchar multiplicityStr[100];
 	gchar buffer[1024];
-	*energy = 0;
-#ifdef G_OS_WIN32
-	gchar c='%';
-#endif
-
-	if(!geom) return FALSE;
-	if(geom->molecule.nAtoms<1) return FALSE;
-#ifndef G_OS_WIN32
-	fileNameSH = g_strdup_printf("%sPCGOne.sh",fileNamePrefix);
-#else
-	fileNameSH = g_strdup_printf("%sPCGOne.bat",fileNamePrefix);
-#endif
- 	fileSH = FOpen(fileNameSH, "w");
-	if(!fileSH) return FALSE;
-#ifdef G_OS_WIN32
-	fprintf(fileSH,"set PATH=%cPATH%c;\"%s\"\n",c,c,fireflyDirectory);
-#endif
 
-	getMultiplicityName(spinMultiplicity, multiplicityStr);
-
-	fileNameIn = g_strdup_printf("%sOne.inp",fileNamePrefix);
  	file = FOpen(fileNameIn, "w");
-	if(!file) 
-	{
- 		if(fileNameIn) g_free(fileNameIn);
- 		if(fileNameOut) g_free(fileNameOut);
- 		if(fileNameSH) g_free(fileNameSH);
-		return FALSE;
-	}
+	if(!file) return FALSE;
 	fprintf(file,"! ======================================================\n");
 	fprintf(file,"!  Input file for FireFly\n"); 
 	fprintf(file,"! ======================================================\n");
@@ -3767,148 +3662,74 @@ static gboolean runOneOptFireFly(SemiEmpiricalModel* geom, gdouble* energy, gcha
 	}
 	fprintf(file," $END\n");
 	fclose(file);
-	fileNameOut = g_strdup_printf("%sOne.out",fileNamePrefix);
+	return TRUE;
+}
+/*****************************************************************************/
+static gboolean runFireFlyFiles(gint numberOfGeometries, SemiEmpiricalModel** geometries, gdouble* energies, gchar* fileNamePrefix, gchar* keyWords)
+{
+	gboolean ok;
+	gchar* command = NULL;
+	SemiEmpiricalJobsData jobsData;
+#ifdef G_OS_WIN32
+	gchar c='%';
+#endif
+
+	jobsData.readEnergy = getEnergyFireFly;
+	jobsData.readGeometry = readGeometryFireFlyJob;
+	/* each job runs in its own directory, the tmp directory of FireFly is local to the job */
 #ifndef G_OS_WIN32
 	if(!strcmp(NameCommandFireFly,"pcgamess") || !strcmp(NameCommandFireFly,"nohup pcgamess")||
 	!strcmp(NameCommandFireFly,"firefly") || !strcmp(NameCommandFireFly,"nohup firefly"))
-	{
-		fprintf(fileSH,"mkdir %stmp\n",fileNamePrefix);
-		fprintf(fileSH,"cd %stmp\n",fileNamePrefix);
-		fprintf(fileSH,"cp %s input\n",fileNameIn);
-		fprintf(fileSH,"%s -p -o %s\n",NameCommandFireFly,fileNameOut);
-		fprintf(fileSH,"cd ..\n");
-		fprintf(fileSH,"rm PUNCH\n");
-		fprintf(fileSH,"/bin/rm -r  %stmp\n",fileNamePrefix);
-	}
+		command = g_strdup_printf(
+		"mkdir tmp\ncd tmp\ncp ../One.inp input\n%s -p -o ../One.out\ncd ..\nrm PUNCH\n/bin/rm -r  tmp",
+		NameCommandFireFly);
 	else
-		fprintf(fileSH,"%s %s",NameCommandFireFly,fileNameIn);
+		command = g_strdup_printf("%s One.inp",NameCommandFireFly);
 #else
 	 if(!strcmp(NameCommandFireFly,"pcgamess") ||
 	 !strcmp(NameCommandFireFly,"firefly") )
-	{
-        	fprintf(fileSH,"mkdir \"%stmp\"\n",fileNamePrefix);
-		addUnitDisk(fileSH, fileNamePrefix);
-	 	fprintf(fileSH,"cd \"%stmp\"\n",fileNamePrefix);
-         	fprintf(fileSH,"copy \"%s\" input\n",fileNameIn);
-         	fprintf(fileSH,"%s -p -o \"%s\"\n",NameCommandFireFly,fileNameOut);
-	 	fprintf(fileSH,"cd ..\n");
-         	fprintf(fileSH,"del PUNCH\n");
-         	fprintf(fileSH,"del /Q  \"%stmp\"\n",fileNamePrefix);
-         	fprintf(fileSH,"rmdir  \"%stmp\"\n",fileNamePrefix);
-	}
+		command = g_strdup_printf(
+		"set PATH=%cPATH%c;\"%s\"\nmkdir tmp\ncd tmp\ncopy ..\\One.inp input\n%s -p -o ..\\One.out\ncd ..\ndel PUNCH\ndel /Q  tmp\nrmdir  tmp",
+		c,c,fireflyDirectory,NameCommandFireFly);
 	else
-		fprintf(fileSH,"%s %s",NameCommandFireFly,fileNameIn);
+		command = g_strdup_printf("set PATH=%cPATH%c;\"%s\"\n%s One.inp",c,c,fireflyDirectory,NameCommandFireFly);
 #endif
-	fclose(fileSH);
-	{
-		gchar* str = NULL;
-		if(strstr(keyWords,"OPTIMIZE")) str = g_strdup_printf("Minimization by AM1/FireFly ... Please wait");
-		else str = g_strdup_printf("Computing of energy by AM1/FireFly .... Please wait");
-		set_text_to_draw(str);
-		if(str) g_free(str);
-		drawGeom();
-    		while( gtk_events_pending() ) gtk_main_iteration();
-	}
-#ifndef G_OS_WIN32
-	sprintf(buffer,"chmod u+x %s",fileNameSH);
-	{int ierr= system(buffer);}
-	{int ierr = system(fileNameSH);}
-#else
-	sprintf(buffer,"\"%s\"",fileNameSH);
-	{int ierr= system(buffer);}
-#endif
-	if(getEnergyFireFly(fileNameOut,energy))
-	{
-		gchar* str = NULL;
-
-		read_geom_from_gamess_output_file(fileNameOut, -1);
-		str = g_strdup_printf("Energy by FireFly = %f", *energy);
-		set_text_to_draw(str);
-		drawGeom();
-    		while( gtk_events_pending() ) gtk_main_iteration();
-		Waiting(1);
-		if(str) g_free(str);
-	}
-	else
-	{
- 		if(fileNameIn) g_free(fileNameIn);
- 		if(fileNameOut) g_free(fileNameOut);
- 		if(fileNameSH) g_free(fileNameSH);
-		return FALSE;
-	}
-
- 	if(fileNameIn) g_free(fileNameIn);
- 	if(fileNameOut) g_free(fileNameOut);
- 	if(fileNameSH) g_free(fileNameSH);
-	return TRUE;
+	ok = runSemiEmpiricalJobs(numberOfGeometries, geometries, energies, fileNamePrefix, keyWords, 
+			_("FireFly"), "One.inp", writeOptFireFlyInput, command, &jobsData);
+	g_free(command);
+	return ok;
 }
-/*****************************************************************************/
-static gboolean runFireFlyFiles(gint numberOfGeometries, SemiEmpiricalModel** geometries, gdouble* energies, gchar* fileNamePrefix, gchar* keyWords)
+/*************************************************************************************************************************************************/
+static gboolean writeOptOpenBabelInput(SemiEmpiricalModel* geom, gchar* fileNameIn, gchar* keyWords)
 {
-	gint i;
-	gint nG = 0;
-	gint nM = 0;
-	gchar* str = NULL;
-	for(i=0;i<numberOfGeometries;i++)
-	{
-		if(!geometries[i]) continue;
-		nG++;
-		if(str) g_free(str);
-		str = g_strdup_printf("Minimization by FireFly of geometry n = %d... Please wait", i+1);
-		set_text_to_draw(str);
-		drawGeom();
-    		while( gtk_events_pending() ) gtk_main_iteration();
-		if(runOneOptFireFly(geometries[i], &energies[i], fileNamePrefix, keyWords)) 
-		{
-			freeMoleculeSE(&geometries[i]->molecule);
-			/*
-			geometries[i]->molecule = createMoleculeSE(geometry0,Natoms,
-			geometries[i]->molecule.totalCharge,
-			geometries[i]->molecule.spinMultiplicity);
-			*/
-			geometries[i]->molecule = createFromGeomXYZMoleculeSE(
-			geometries[i]->molecule.totalCharge,
-			geometries[i]->molecule.spinMultiplicity,TRUE);
-			nM++;
-		}
-		if(StopCalcul) break;
-	}
-	if(str) g_free(str);
-	if(nM==nG) return TRUE;
-	return FALSE;
-
+	return saveMoleculeSEHIN(&geom->molecule, fileNameIn);
 }
-/*************************************************************************************************************************************************/
+/*****************************************************************************/
+/* keyWords is the OpenBabel command line, without the file names */
 static gboolean runOpenBabelFiles(gint numberOfGeometries, SemiEmpiricalModel** geometries, gdouble* energies, gchar* fileNamePrefix, gchar* keyWords)
 {
-        int i;
-        int nG = 0;
-        int nM = 0;
-	gchar* str = NULL;
-        if(!geometries) return FALSE;
-        for(i=0;i<numberOfGeometries;i++)
-        {
-                if(!geometries[i]) continue;
-                nG++;
-		if(str) g_free(str);
-		str = g_strdup_printf("Minimization by OpenBabel of geometry n = %d... Please wait", i+1);
-		set_text_to_draw(str);
-		drawGeom();
-    		while( gtk_events_pending() ) gtk_main_iteration();
-		printf("str runOpenBabelFiles = %s\n",str);
-		//setConnectionsMoleculeSE(&geometries[i]->molecule);
-		//printf("End setConnectionsMoleculeSE\n");
-                if(runOneOpenBabel(&geometries[i]->molecule, fileNamePrefix, keyWords))
-                {
-                        energies[i] = geometries[i]->molecule.energy;
-                        nM++;
-                }
-		if(StopCalcul) break;
-        }
-	if(str) g_free(str);
-	if(nM==nG) return TRUE;
-	return FALSE;
+	gboolean ok;
+	gchar* command = NULL;
+	SemiEmpiricalJobsData jobsData;
 
+	if(!geometries) return FALSE;
+	jobsData.readEnergy = getEnergyOpenBabel;
+	jobsData.readGeometry = readGeometryOpenBabelJob;
+#ifndef G_OS_WIN32
+	command = g_strdup_printf("export PATH=$PATH:%s\nexport BABEL_DATADIR=%s\n%s One.hin > One.out 2>/dev/null",
+			openbabelDirectory, openbabelDirectory, keyWords);
+#else
+	if(strstr(openbabelDirectory,"\"")) 
+	command = g_strdup_printf("set PATH=%s;%cPATH%c\nset BABEL_DATADIR=%s\n%s One.hin > One.out",
+			openbabelDirectory,'%','%',openbabelDirectory, keyWords);
+	else
+	command = g_strdup_printf("set PATH=\"%s\";%cPATH%c\nset BABEL_DATADIR=%s\n%s One.hin > One.out",
+			openbabelDirectory,'%','%',openbabelDirectory, keyWords);
+#endif
+	ok = runSemiEmpiricalJobs(numberOfGeometries, geometries, energies, fileNamePrefix, keyWords, 
+			_("OpenBabel"), "One.hin", writeOptOpenBabelInput, command, &jobsData);
+	g_free(command);
+	return ok;
 }
 /*****************************************************************************/
 static gboolean testEqualDistances(gdouble* distancesI, gdouble* distancesJ, gint n, gdouble tol)
@@ -4588,7 +4409,7 @@ static void semiEmpiricalMDConfo(GtkWidget* Win, gpointer data)
 	if(optMopac && !StopCalcul)
 	{
 		gchar* fileNamePrefix = get_suffix_name_file(fileNameGeom);
-		gchar* keys=g_strdup_printf("%s XYZ",method);
+		gchar* keys=g_strdup_printf("%s XYZ GRADIENTS",method);
 		if(runMopacFiles(numberOfGeometries, geometries, energies, fileNamePrefix, keys))
 		{
 			sortGeometries(numberOfGeometries, geometries, energies);
@@ -4896,6 +4717,132 @@ static void semiEmpiricalMD(GtkWidget* Win, gpointer data)
 	g_free(dirName);
 }
 /********************************************************************************/
+static gpointer copySemiEmpiricalFDModel(gpointer model)
+{
+	SemiEmpiricalModel* copy = g_malloc(sizeof(SemiEmpiricalModel));
+	*copy = copySemiEmpiricalModel((SemiEmpiricalModel*)model);
+	return copy;
+}
+/********************************************************************************/
+static void freeSemiEmpiricalFDModel(gpointer model)
+{
+	freeSemiEmpiricalModel((SemiEmpiricalModel*)model);
+	g_free(model);
+}
+/********************************************************************************/
+static void computeSemiEmpiricalFDModel(gpointer model, gdouble* coordinates, gdouble* energy, gdouble* gradient, gdouble* dipole)
+{
+	SemiEmpiricalModel* seModel = (SemiEmpiricalModel*)model;
+	MoleculeSE* mol = &seModel->molecule;
+	gint i,k;
+
+	for(i=0;i<mol->nAtoms;i++)
+		for(k=0;k<3;k++) mol->atoms[i].coordinates[k] = coordinates[3*i+k];
+
+	if(gradient) seModel->klass->calculateGradient(seModel);
+	else seModel->klass->calculateEnergy(seModel);
+
+	*energy = mol->energy;
+	if(gradient)
+	for(i=0;i<mol->nAtoms;i++)
+		for(k=0;k<3;k++) gradient[3*i+k] = mol->gradient[k][i];
+	/* Debye => au */
+	if(dipole) for(k=0;k<3;k++) dipole[k] = mol->dipole[k]/AUTODEB;
+}
+/********************************************************************************/
+static void semiEmpiricalFrequencies(GtkWidget* Win, gpointer data)
+{
+	SemiEmpiricalModel seModel; 
+	FiniteDifferences fd;
+	FiniteDifferencesOptions options;
+	gchar* program = NULL;
+	gchar* method = NULL;
+	gchar* dirName = NULL;
+	gint totalCharge = 0;
+	gint spinMultiplicity = 1;
+	SemiEmpiricalModelConstraints constraints = NOCONSTRAINTS;
+	gint i,k;
+
+	totalCharge = atoi(gtk_entry_get_text(GTK_ENTRY(entryCharge)));
+	spinMultiplicity = atoi(gtk_entry_get_text(GTK_ENTRY(entrySpinMultiplicity)));
+	TotalCharges[0] = totalCharge;
+	SpinMultiplicities[0] = spinMultiplicity;
+	if(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonMopac))) 
+	{
+		program = g_strdup("Mopac");
+		method = g_strdup(gtk_entry_get_text(GTK_ENTRY(entryMopacMethod)));
+	}
+	else if(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonFireFly))) 
+	{
+		program = g_strdup("FireFly");
+		method = g_strdup(gtk_entry_get_text(GTK_ENTRY(entryFireFlyMethod)));
+	}
+	else if(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonOpenBabel))) 
+	{
+		program = g_strdup("OpenBabel");
+		method = g_strdup(gtk_entry_get_text(GTK_ENTRY(entryOpenBabelMethod)));
+	}
+	else if(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(buttonGeneric))) 
+	{
+		program = g_strdup("Generic");
+		method = g_strdup(gtk_entry_get_text(GTK_ENTRY(entryGenericMethod)));
+		if(genericProgName) g_free(genericProgName);
+		genericProgName = g_strdup(method);
+	}
+	if(!program)
+	{
+		gtk_widget_destroy(Win);
+		return;
+	}
+	getFiniteDifferencesOptionsFromDlg(Win, &options);
+	dirName = gtk_file_chooser_get_current_folder (GTK_FILE_CHOOSER(buttonDirSelector));
+
+	gtk_widget_destroy(Win);
+    	while( gtk_events_pending() ) gtk_main_iteration();
+
+	set_sensitive_stop_button( TRUE);
+	StopCalcul = FALSE;
+
+	if(!strcmp(program,"Mopac")) seModel = createMopacModel(geometry0,Natoms, totalCharge, spinMultiplicity,method,dirName, constraints);
+	else if(!strcmp(program,"FireFly")) seModel = createFireFlyModel(geometry0,Natoms, totalCharge, spinMultiplicity,method,dirName, constraints);
+	else if(!strcmp(program,"OpenBabel")) seModel = createOpenBabelModel(geometry0,Natoms, totalCharge, spinMultiplicity,method,dirName, constraints);
+	else if(!strcmp(program,"Generic")) seModel = createGenericModel(geometry0,Natoms, totalCharge, spinMultiplicity,method,dirName, constraints);
+
+	g_free(method);
+	g_free(program);
+
+	if(StopCalcul)
+	{
+		set_text_to_draw(" ");
+		set_statubar_operation_str(_("Calculation Canceled "));
+		drawGeom();
+		set_sensitive_stop_button( FALSE);
+		g_free(dirName);
+		return;
+	}
+
+	fd = newFiniteDifferences(seModel.molecule.nAtoms, &seModel, 
+			copySemiEmpiricalFDModel, freeSemiEmpiricalFDModel, computeSemiEmpiricalFDModel, options);
+	/* the copies share the input/output files of the external program */
+	fd.parallel = FALSE;
+	for(i=0;i<seModel.molecule.nAtoms;i++)
+	{
+		fd.symbols[i] = g_strdup(seModel.molecule.atoms[i].prop.symbol);
+		for(k=0;k<3;k++) fd.coordinates[3*i+k] = seModel.molecule.atoms[i].coordinates[k];
+	}
+	if(runFiniteDifferencesFrequencies(&fd))
+		set_statubar_operation_str(_("Frequencies computed by finite differences of the gradients"));
+	else
+		set_statubar_operation_str(_("Calculation Canceled "));
+	freeFiniteDifferences(&fd);
+
+	set_sensitive_stop_button(FALSE);
+	set_text_to_draw(" ");
+	drawGeom();
+	freeSemiEmpiricalModel(&seModel);
+	g_free(dirName);
+}
+/********************************************************************************/
 static void AddDynamicsOptionsDlg(GtkWidget *NoteBook, GtkWidget *win)
 {
 
@@ -6454,6 +6401,47 @@ void semiEmpiricalMolecularDynamicsDlg()
 
 	gtk_widget_show_all(Win);
   
+}
+/*****************************************************************************/
+void semiEmpiricalFrequenciesDlg()
+{
+	GtkWidget *button;
+	GtkWidget *Win;
+	GtkWidget *NoteBook;
+	GtkWidget *parentWindow = GeomDlg;
+
+	StopCalcul = TRUE;
+
+	Win= gtk_dialog_new ();
+	gtk_window_set_position(GTK_WINDOW(Win),GTK_WIN_POS_CENTER);
+	gtk_window_set_transient_for(GTK_WINDOW(Win),GTK_WINDOW(parentWindow));
+	gtk_window_set_title(&GTK_DIALOG(Win)->window,"Frequencies by finite differences");
+    	gtk_window_set_modal (GTK_WINDOW (Win), TRUE);
+
+	g_signal_connect(G_OBJECT(Win),"delete_event",(GCallback)gtk_widget_destroy,NULL);
+ 
+	NoteBook = gtk_notebook_new();
+	gtk_box_pack_start(GTK_BOX (gtk_dialog_get_content_area(GTK_DIALOG(Win))), NoteBook,TRUE, TRUE, 0);
+
+	addFiniteDifferencesOptionsDlg(NoteBook, Win);
+	AddModelOptionsDlg(NoteBook, Win);
+
+	gtk_widget_realize(Win);
+
+	button = create_button(Win,"Cancel");
+	GTK_WIDGET_SET_FLAGS(button, GTK_CAN_DEFAULT);
+	gtk_box_pack_start (GTK_BOX( gtk_dialog_get_action_area(GTK_DIALOG(Win))), button, TRUE, TRUE, 0);
+	g_signal_connect_swapped(GTK_OBJECT(button), "clicked", G_CALLBACK(gtk_widget_destroy),GTK_OBJECT(Win));
+	gtk_widget_show (button);
+
+	button = create_button(Win,"Ok");
+	GTK_WIDGET_SET_FLAGS(button, GTK_CAN_DEFAULT);
+	gtk_box_pack_start (GTK_BOX( gtk_dialog_get_action_area(GTK_DIALOG(Win))), button, TRUE, TRUE, 0);
+	g_signal_connect_swapped(GTK_OBJECT(button), "clicked", (GCallback)semiEmpiricalFrequencies,GTK_OBJECT(Win));
+	gtk_widget_show (button);
+
+	gtk_widget_show_all(Win);
+  
 }
 /***********************************************************************/
 void semiEmpiricalMolecularDynamicsConfoDlg()
@@ -34,6 +34,7 @@ void semiEmpiricalDlg(gchar* type);
 
 void semiEmpiricalMolecularDynamicsDlg();
 void semiEmpiricalMolecularDynamicsConfoDlg();
+void semiEmpiricalFrequenciesDlg();
 
 #endif /* __GABEDIT_SEMIEMPIRICALDLG_H__ */
 
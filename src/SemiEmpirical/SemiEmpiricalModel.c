@@ -28,6 +28,7 @@ DEALINGS IN THE SOFTWARE.
 #include "AtomSE.h"
 #include "MoleculeSE.h"
 #include "SemiEmpiricalModel.h"
+#include "IPIDriver.h"
 void create_GeomXYZ_from_draw_grometry();
 
 /**********************************************************************/
@@ -180,6 +181,7 @@ SemiEmpiricalModel newSemiEmpiricalModel(gchar* method, gchar* dirName, SemiEmpi
 	if(method) seModel.method = g_strdup(method);
 	if(dirName) seModel.workDir = g_strdup(dirName);
 	else seModel.workDir = g_strdup_printf("%s%stmp",gabedit_directory(),G_DIR_SEPARATOR_S);
+	seModel.driver = NULL;
 	return seModel;
 
 }
@@ -204,6 +206,11 @@ void freeSemiEmpiricalModel(SemiEmpiricalModel* seModel)
 		g_free(seModel->workDir);
 		seModel->workDir = NULL;
 	}
+	if(seModel->driver != NULL)
+	{
+		unrefIPIDriver((IPIDriver*)seModel->driver);
+		seModel->driver = NULL;
+	}
 }
 /*****************************************************************************/
 SemiEmpiricalModel copySemiEmpiricalModel(SemiEmpiricalModel* f)
@@ -215,6 +222,7 @@ SemiEmpiricalModel copySemiEmpiricalModel(SemiEmpiricalModel* f)
 	if(f->method) seModel.method = g_strdup(f->method);
 	seModel.workDir = NULL;
 	if(f->workDir) seModel.workDir = g_strdup(f->workDir);
+	seModel.driver = refIPIDriver((IPIDriver*)f->driver);
 
 	seModel.klass->calculateGradient = f->klass->calculateGradient;
 	seModel.klass->calculateEnergy = f->klass->calculateEnergy;
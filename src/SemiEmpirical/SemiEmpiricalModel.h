@@ -37,6 +37,7 @@ struct _SemiEmpiricalModel
 	SemiEmpiricalModelClass* klass;
 	gchar* method;
 	gchar* workDir;
+	gpointer driver; /* persistent engine (IPIDriver), shared by the copies */
 	SemiEmpiricalModelConstraints constraints;
 	gint numberOfRattleConstraintsTerms;
 	gdouble* rattleConstraintsTerms[RATTLEDIM];
@@ -557,80 +557,6 @@ static void buildFreqAndJ( gdouble operatingFrequency, gint nGroups,
 
 }
 /********************************************************************************/
-static void buildHamiltonianOneBlock(gint istart, gint size,
-	gint nBasis, gint nSpins,
-	gdouble* frequencies,
-	gdouble* ppmJCouplings,
-	gint* basis ,
-	gdouble* hamilt)
-{
-	gint i = 0;
-	gint j = 0 ;
-	gint k = 0 ;
-	gint l = 0 ;
-	gint ja, jb;
-	gint ii, ik, is;
-	gdouble dum;
-	gint dumja, dumjb;
-
-	/* diagonal elements of hamiltonian*/
-	ii=0 ;
-	for ( i=istart ; i<istart+size ; i++ )
-	{
-		dum=0.0 ;
-  		ik = -1 ;
-		for ( l=0 ; l<nSpins ; l++ )
-		{
-			ik++ ;
-			dum += frequencies[l]*basis[i+l*nBasis]/2 ;
-			for ( k=0 ; k<l ; k++ )
-			{
-		  		dum=dum+ppmJCouplings[ik]*basis[i+l*nBasis]*basis[i+k*nBasis]/4. ;
-				ik++;
-			}
-		}
-		ii=ii+i+1 -istart;
-		hamilt[ii-1]=dum ;
-		/* printf("hamilt[%d] = %f\n",ii-1, hamilt[ii-1]);*/
-	}
-	/* printf("End calculate diagonal elements of hamiltonian\n");*/
-
-/*	calculate off diagonal elements of hamiltonian*/
-	ii=-1 ;
-	for ( ja=istart+1 ; ja<istart+size ; ja++)
-	{
-		ii=ii+1 ;
-		for ( jb=istart ; jb<ja; jb++ )
-		{
-			ii=ii+1 ;
-			is=0 ; dumja=0 ; dumjb=0 ;
-			/* to delete ? */
-		   	for ( i=0; i<nSpins ; i++ )
-			{
-				is+=basis[ja+i*nBasis]*basis[jb+i*nBasis] ;
-        			dumja+=basis[ja+i*nBasis] ;
-        			dumjb+=basis[jb+i*nBasis] ;
-			}
-			if ( (dumja != dumjb) || (is != nSpins-4) )
-			{
-			   hamilt[ii]=0.0 ;
-			   /* printf("ii = %d hamilt[ii] = %f\n",ii, hamilt[ii]);*/
-			   continue ;
-			}
-		 	for ( i=0; i<nSpins-1 ; i++ )
-			{
-			    if ( basis[ja+i*nBasis] != basis[jb+i*nBasis] ) break ;
-			}
-			for ( j=i+1 ; j<nSpins ; j++ )
-			{
-			   if ( basis[ja+j*nBasis] != basis[jb+j*nBasis] ) break ;
-			}
-			hamilt[ii] = 0.5*ppmJCouplings[(j+1)*j/2+i] ;
-			/* printf("ii = %d hamilt[ii] = %f\n",ii, hamilt[ii]);*/
-		}
-	}
-}
-/********************************************************************************/
 /*
 static void diagonaliseJacobiOneBlock(gint size, gdouble* hamilt, gdouble* eValues, gdouble** eVectors)
 {
@@ -671,70 +597,284 @@ static void diagonaliseJacobiOneBlock(gint size, gdouble* hamilt, gdouble* eValu
 }
 */
 /********************************************************************************/
-static gint addTransitions(gint nBasis,gint nSpins, gint istartPrev, gint istart, gint sizePrev, gint size,
-					gint* basis,
+/* Composite particles : the n equivalent spins of a group are coupled to a total spin F = n/2-k 
+ * of multiplicity C(n,k)-C(n,k-1). H is block diagonal in (F1,..,FnGroups) and, for each set of F, in Mz.
+ * A state of a set of F is coded in a mixed radix basis by the digits d_g = F_g+m_g (0..2F_g).
+ * The Mz block of a state is the sum of its digits.
+ */
+typedef struct _NMRSpinSystem
+{
+	gint nGroups;
+	gint* twoF;
+	gint* radix;
+	gint nStates;
+	gint nBlocks;
+	gint* sizeBlock;
+	gint* startBlock;
+	gint* states; /* codes sorted by block */
+	gint* position; /* position of a code in its block */
+	gdouble weight;
+}NMRSpinSystem;
+/* max number of eigenvectors elements in memory during the parallel diagonalisation */
+#define NMRMAXMEMORY (1<<25)
+/********************************************************************************/
+static gdouble binomialNMR(gint n, gint k)
+{
+	gint i;
+	gdouble b = 1;
+	if(k<0 || k>n) return 0;
+	for(i=1;i<=k;i++) b = b*(n-k+i)/i;
+	return b;
+}
+/********************************************************************************/
+static gint getDigitNMR(NMRSpinSystem* s, gint code, gint g)
+{
+	return (code/s->radix[g])%(s->twoF[g]+1);
+}
+/********************************************************************************/
+static void initNMRSpinSystem(NMRSpinSystem* s, gint nGroups, gint* numberOfSpins, gint* k)
+{
+	gint g, c, b;
+
+	s->nGroups = nGroups;
+	s->twoF = malloc(nGroups*sizeof(gint));
+	s->radix = malloc(nGroups*sizeof(gint));
+	s->nStates = 1;
+	s->nBlocks = 1;
+	s->weight = 1;
+	for(g=0;g<nGroups;g++)
+	{
+		s->twoF[g] = numberOfSpins[g]-2*k[g];
+		s->radix[g] = s->nStates;
+		s->nStates *= s->twoF[g]+1;
+		s->nBlocks += s->twoF[g];
+		s->weight *= binomialNMR(numberOfSpins[g],k[g])-binomialNMR(numberOfSpins[g],k[g]-1);
+	}
+	s->sizeBlock = malloc(s->nBlocks*sizeof(gint));
+	s->startBlock = malloc(s->nBlocks*sizeof(gint));
+	s->states = malloc(s->nStates*sizeof(gint));
+	s->position = malloc(s->nStates*sizeof(gint));
+	for(b=0;b<s->nBlocks;b++) s->sizeBlock[b] = 0;
+	/* counting sort of the codes by block */
+	for(c=0;c<s->nStates;c++)
+	{
+		gint sum = 0;
+		for(g=0;g<nGroups;g++) sum += getDigitNMR(s, c, g);
+		s->position[c] = sum;
+		s->sizeBlock[sum]++;
+	}
+	s->startBlock[0] = 0;
+	for(b=1;b<s->nBlocks;b++) s->startBlock[b] = s->startBlock[b-1]+s->sizeBlock[b-1];
+	for(b=0;b<s->nBlocks;b++) s->sizeBlock[b] = 0;
+	for(c=0;c<s->nStates;c++)
+	{
+		b = s->position[c];
+		s->states[s->startBlock[b]+s->sizeBlock[b]] = c;
+		s->position[c] = s->sizeBlock[b]++;
+	}
+}
+/********************************************************************************/
+static void freeNMRSpinSystem(NMRSpinSystem* s)
+{
+	free(s->twoF);
+	free(s->radix);
+	free(s->sizeBlock);
+	free(s->startBlock);
+	free(s->states);
+	free(s->position);
+}
+/********************************************************************************/
+/* hamilt : inf packed matrix of the block b, frequencies and ppmJ are by group */
+static void buildHamiltonianCompositeBlock(NMRSpinSystem* s, gint b, gdouble* frequencies, gdouble** ppmJ, gdouble* hamilt)
+{
+	gint size = s->sizeBlock[b];
+	gint* states = s->states+s->startBlock[b];
+	gint nGroups = s->nGroups;
+	gint* d = malloc(nGroups*sizeof(gint));
+	gint* twoM = malloc(nGroups*sizeof(gint));
+	gint i, g, h;
+
+	for(i=0;i<size*(size+1)/2;i++) hamilt[i] = 0.0;
+	for(i=0;i<size;i++)
+	{
+		gint code = states[i];
+		gdouble dum = 0.0;
+		for(g=0;g<nGroups;g++)
+		{
+			d[g] = getDigitNMR(s, code, g);
+			twoM[g] = 2*d[g]-s->twoF[g];
+		}
+		for(g=0;g<nGroups;g++)
+		{
+			dum += frequencies[g]*twoM[g]/2;
+			for(h=0;h<g;h++) dum += ppmJ[g][h]*twoM[g]*twoM[h]/4.;
+		}
+		hamilt[i*(i+1)/2+i] = dum;
+		/* flip-flop terms J/2 (F+g F-h + F-g F+h) */
+		for(g=0;g<nGroups;g++)
+		{
+			gdouble up;
+			if(d[g]>=s->twoF[g]) continue;
+			up = (s->twoF[g]*(s->twoF[g]+2)-twoM[g]*(twoM[g]+2))/4.0;
+			for(h=0;h<nGroups;h++)
+			{
+				gint j;
+				gdouble down;
+				if(h==g || d[h]==0 || ppmJ[g][h]==0) continue;
+				j = s->position[code+s->radix[g]-s->radix[h]];
+				if(j>=i) continue;
+				down = (s->twoF[h]*(s->twoF[h]+2)-twoM[h]*(twoM[h]-2))/4.0;
+				hamilt[i*(i+1)/2+j] = 0.5*ppmJ[g][h]*sqrt(up*down);
+			}
+		}
+	}
+	free(d);
+	free(twoM);
+}
+/********************************************************************************/
+/* transitions between the blocks b-1 and b, intensity = weight*|<prev|F+|cur>|^2 */
+static gint addTransitionsCompositeBlock(NMRSpinSystem* s, gint b,
 					gdouble* eValuesPrev, gdouble* eValues, 
 					gdouble** eVectorsPrev, gdouble** eVectors,
-					gint ifreqSpec, gdouble* frequenciesSpectrum, gdouble* gintensities,
-					gdouble* transProb, gint* lfs, gint* mfs)
+					gdouble* frequenciesSpectrum, gdouble* gintensities)
 {
-	gint i = 0;
-	gint ja, jb;
-	gint ik;
+	gint sizePrev = s->sizeBlock[b-1];
+	gint size = s->sizeBlock[b];
+	gint* statesPrev = s->states+s->startBlock[b-1];
+	gdouble* W = malloc(sizePrev*size*sizeof(gdouble));
+	gdouble* vt = malloc(size*size*sizeof(gdouble));
+	gint l, m, g, ja, jb;
 	gint nfs = 0;
-	gint nDim = sizePrev*size;
-	gint l,m;
 
-	for ( i=0 ; i<nDim ; i++) transProb[i] = 0;
-	/* printf("Begin transition propability calculation\n");*/
-	nfs = 0;
-	for ( l=istartPrev ; l<istartPrev+sizePrev ; l++)
-		for ( m=istart ; m<istart+size; m++ )
+	/* W = (F+ Vprev)^t, sparse : F+ has at most nGroups elements by column */
+	for(l=0;l<sizePrev*size;l++) W[l] = 0.0;
+	for(l=0;l<sizePrev;l++)
+	{
+		gint code = statesPrev[l];
+		for(g=0;g<s->nGroups;g++)
 		{
-			gint is;
-	      		is = 0 ;
-           		for ( i=0; i<nSpins ; i++ )
-	       			is += basis[l+i*nBasis]*basis[m+i*nBasis] ;
-              		if ( is == nSpins-2 ) 
+			gint d = getDigitNMR(s, code, g);
+			gint twoM = 2*d-s->twoF[g];
+			gdouble coef;
+			if(d>=s->twoF[g]) continue;
+			coef = sqrt((s->twoF[g]*(s->twoF[g]+2)-twoM*(twoM+2))/4.0);
+			m = s->position[code+s->radix[g]];
+			for(ja=0;ja<sizePrev;ja++) W[ja*size+m] += coef*eVectorsPrev[l][ja];
+		}
+	}
+	for(m=0;m<size;m++)
+		for(jb=0;jb<size;jb++) vt[jb*size+m] = eVectors[m][jb];
+
+	for(ja=0;ja<sizePrev;ja++)
+	{
+		gdouble* w = W+ja*size;
+		for(jb=0;jb<size;jb++)
+		{
+			gdouble* v = vt+jb*size;
+			gdouble dum = 0.0;
+			for(m=0;m<size;m++) dum += w[m]*v[m];
+			dum = dum*dum;
+			if(dum>.0001)
 			{
-				lfs[nfs] = l-istartPrev;
-				mfs[nfs] = m-istart;
+				frequenciesSpectrum[nfs] = fabs(eValues[jb]-eValuesPrev[ja]);
+				gintensities[nfs] = dum*s->weight;
 				nfs++;
 			}
 		}
-	/* printf("End lfs/mfs calculation nfs %d\n",nfs);*/
+	}
+	free(W);
+	free(vt);
+	return nfs;
+}
+/********************************************************************************/
+/* blocks are diagonalised in parallel, by windows limited to NMRMAXMEMORY */
+static gint computeNMRSpinSystem(NMRSpinSystem* s, gdouble* frequencies, gdouble** ppmJ,
+		gint nFrequencies, gdouble** pFrequenciesSpectrum, gdouble** pGintensities)
+{
+	gint nBlocks = s->nBlocks;
+	gdouble** eValues = malloc(nBlocks*sizeof(gdouble*));
+	gdouble*** eVectors = malloc(nBlocks*sizeof(gdouble**));
+	gdouble** freqs = malloc(nBlocks*sizeof(gdouble*));
+	gdouble** ints = malloc(nBlocks*sizeof(gdouble*));
+	gint* nfs = malloc(nBlocks*sizeof(gint));
+	gint b0 = 0;
+	gint b, i;
+
+	for(b=0;b<nBlocks;b++) 
+	{
+		eValues[b] = NULL;
+		eVectors[b] = NULL;
+	}
+	while(b0<nBlocks)
+	{
+		gint b1 = b0;
+		gdouble mem = (gdouble)s->sizeBlock[b0]*s->sizeBlock[b0];
+		while(b1+1<nBlocks && mem+(gdouble)s->sizeBlock[b1+1]*s->sizeBlock[b1+1]<=NMRMAXMEMORY)
+		{
+			b1++;
+			mem += (gdouble)s->sizeBlock[b1]*s->sizeBlock[b1];
+		}
 #ifdef ENABLE_OMP
-#pragma omp parallel for private(ja,jb,ik)  
+#pragma omp parallel for private(b,i) schedule(dynamic,1)
 #endif
-	for ( ja=0 ; ja<sizePrev ; ja++)
-		for ( jb=0 ; jb<size; jb++ )
+		for(b=b0;b<=b1;b++)
 		{
-			gdouble dum=0.0;
-			for ( ik=0 ; ik<nfs ; ik++)
-         			dum +=   eVectorsPrev[lfs[ik]][ja]*eVectors[mfs[ik]][jb];
-	  		transProb[ja*size+jb]=dum*dum ;
-   		}
-	
-	/* printf("End transProb calculations\n");*/
-	/* transition frequencies*/
-	ik = ifreqSpec;
-	/* printf("Begin gintensities calculations\n");*/
+			gint size = s->sizeBlock[b];
+			gdouble* hamilt = malloc(size*(size+1)/2*sizeof(gdouble));
+			eValues[b] = malloc(size*sizeof(gdouble));
+			eVectors[b] = malloc(size*sizeof(gdouble*));
+			for(i=0;i<size;i++) eVectors[b][i] = malloc(size*sizeof(gdouble));
+			buildHamiltonianCompositeBlock(s, b, frequencies, ppmJ, hamilt);
+			eigen(hamilt, size, eValues[b], eVectors[b]);
+			free(hamilt);
+		}
 #ifdef ENABLE_OMP
-#pragma omp parallel for private(ja,jb)  
+#pragma omp parallel for private(b) schedule(dynamic,1)
 #endif
-	for ( ja=0 ; ja<sizePrev ; ja++)
-		for ( jb=0 ; jb<size; jb++ )
+		for(b=MAX(b0,1);b<=b1;b++)
 		{
-			gint ii = jb+ja*size;
-			if ( transProb[ii] > .0001 )
+			gint n = s->sizeBlock[b-1]*s->sizeBlock[b];
+			freqs[b] = malloc(n*sizeof(gdouble));
+			ints[b] = malloc(n*sizeof(gdouble));
+			nfs[b] = addTransitionsCompositeBlock(s, b, eValues[b-1], eValues[b], eVectors[b-1], eVectors[b], freqs[b], ints[b]);
+		}
+		for(b=MAX(b0,1);b<=b1;b++)
+		{
+			if(nfs[b]>0)
 			{
-				frequenciesSpectrum[ik] = fabs(eValues[jb]-eValuesPrev[ja]);
-				gintensities[ik] = transProb[ii];
-				ik++;
+				*pFrequenciesSpectrum = realloc(*pFrequenciesSpectrum,(nFrequencies+nfs[b])*sizeof(gdouble));
+				*pGintensities = realloc(*pGintensities,(nFrequencies+nfs[b])*sizeof(gdouble));
+				for(i=0;i<nfs[b];i++)
+				{
+					(*pFrequenciesSpectrum)[nFrequencies+i] = freqs[b][i];
+					(*pGintensities)[nFrequencies+i] = ints[b][i];
+				}
+				nFrequencies += nfs[b];
 			}
+			free(freqs[b]);
+			free(ints[b]);
 		}
-	/* printf("End gintensities calculations\n");*/
-	return ik;
+		/* the last block of the window is needed by the next one */
+		for(b=MAX(b0-1,0);b<b1;b++)
+		{
+			for(i=0;i<s->sizeBlock[b];i++) free(eVectors[b][i]);
+			free(eVectors[b]);
+			free(eValues[b]);
+			eVectors[b] = NULL;
+			eValues[b] = NULL;
+		}
+		b0 = b1+1;
+	}
+	b = nBlocks-1;
+	for(i=0;i<s->sizeBlock[b];i++) free(eVectors[b][i]);
+	free(eVectors[b]);
+	free(eValues[b]);
+	free(eValues);
+	free(eVectors);
+	free(freqs);
+	free(ints);
+	free(nfs);
+	return nFrequencies;
 }
 /********************************************************************************/
 static gint getSizeMax(gint nSpins, gint* binomialCoef)
@@ -842,30 +982,13 @@ void computeNMRSpectrumByBlock(
 		gdouble** JCouplings, gint *n, gdouble**X, gdouble** Y)
 {
 	gint nSpins = 0 ;
-	gint i = 0;
-	gint nBasis = 0;
-	gint nDim = 0;
 	gint nCoup = 0;
-
-	gdouble* frequencies  = NULL;
+	gint g, h;
+	gint* k = NULL;
+	gdouble** ppmJ = NULL;
 	gdouble* frequenciesSpectrum  = NULL;
 	gdouble* gintensities  = NULL;
-	gdouble* ppmJCouplings  = NULL;
-	gint* basis  = NULL;
-	gdouble* transProb  = NULL;
-	gdouble* hamilt  = NULL;
-	gdouble** eVectors  = NULL;
-	gdouble* eValues  = NULL;
-	gdouble** eVectorsPrev  = NULL;
-	gdouble* eValuesPrev  = NULL;
-	gint* lfs  = NULL;
-	gint* mfs  = NULL;
 	gint nFrequencies = 0;
-	gint* start = NULL;
-	gint* binomialCoef = NULL;
-	gint sizeMax;
-	gint sizeTrans;
-	gint ifreqSpec = 0;
 
 	*n = 0;
 	*X = NULL;
@@ -883,124 +1006,34 @@ void computeNMRSpectrumByBlock(
 		return;
 	}
 	if(nCoup<1) return;
-	frequencies = malloc(nSpins*sizeof(gdouble));
-	ppmJCouplings = malloc(nCoup*sizeof(gdouble));
-	/* frequency array and coupling matrix*/
-	buildFreqAndJ(operatingFrequency,  nGroups, numberOfSpins, chemichalShifts, JCouplings, 
-		nCoup, frequencies, ppmJCouplings);
-	/* printf("End build FreqJ\n");*/
-	/* basis set */
-	nBasis = 1<<nSpins;
-	/* printf("nBasis =%d\n",nBasis);*/
-	basis = malloc(nBasis*nSpins*sizeof(gint));
-	start = malloc((nSpins+1)*sizeof(gint));
-	binomialCoef = malloc((nSpins+1)*sizeof(gint));
-	initTables(nSpins, binomialCoef, basis, start);
-	sizeMax = getSizeMax(nSpins, binomialCoef);
-	sizeTrans = getSizeTrans(nSpins, binomialCoef);
-	/* printf("nBasis  = %d sizeTrans = %d\n",nBasis,sizeTrans);*/
-	/* printf("End initTables\n");*/
-
-	nDim = sizeMax*(sizeMax+1)/2;
-	hamilt = malloc(nDim*sizeof(gdouble));
-	transProb = malloc(sizeMax*sizeMax*sizeof(gdouble));
-	/* printf("End transProb alloc\n");*/
-	eValues = malloc(sizeMax*sizeof(gdouble));
-	eVectors  = malloc(sizeMax*sizeof(gdouble*));
-	if(eVectors) for(i=0;i<sizeMax;i++) eVectors[i] = malloc(sizeMax*sizeof(gdouble));
-	eValuesPrev = malloc(sizeMax*sizeof(gdouble));
-	eVectorsPrev  = malloc(sizeMax*sizeof(gdouble*));
-	if(eVectorsPrev) for(i=0;i<sizeMax;i++) eVectorsPrev[i] = malloc(sizeMax*sizeof(gdouble));
-
-	/* printf("Begin alloc freq and gint\n");*/
-	frequenciesSpectrum  = malloc(sizeTrans*sizeof(gdouble));
-	gintensities  = malloc(sizeTrans*sizeof(gdouble));
-	if(!gintensities)
+	/* couplings by group, in ppm */
+	ppmJ = malloc(nGroups*sizeof(gdouble*));
+	for(g=0;g<nGroups;g++)
 	{
-		gchar tmp[BSIZE];
-		sprintf(tmp,_("Sorry\n Not enough memory : nBasis  = %d sizeTrans = %d\n"), nBasis,sizeTrans);
-    		Message(tmp,_("Warning"),TRUE);
-		return;
+		ppmJ[g] = malloc(nGroups*sizeof(gdouble));
+		for(h=0;h<nGroups;h++)
+			if(h==g) ppmJ[g][h] = 0;
+			else ppmJ[g][h] = JCouplings[MAX(g,h)][MIN(g,h)]/operatingFrequency;
 	}
-	lfs  = malloc(sizeMax*sizeMax*sizeof(gint));
-	mfs  = malloc(sizeMax*sizeMax*sizeof(gint));
-	ifreqSpec = 0;
-	for(i=0;i<=nSpins;i++)
+	/* k[g] : total spin of the group g = numberOfSpins[g]/2-k[g] */
+	k = malloc(nGroups*sizeof(gint));
+	for(g=0;g<nGroups;g++) k[g] = 0;
+	do
 	{
-		gint istart = start[i];
-		gint size = binomialCoef[i];
-		gdouble* e;
-		gdouble** v;
-		buildHamiltonianOneBlock(istart, size, nBasis, nSpins, frequencies, ppmJCouplings, basis , hamilt);
-		/* prgintMatInf(0, size, hamilt, "H");*/
-		/*diagonaliseJacobiOneBlock(size, hamilt, eValues, eVectors);*/
-
-		/* printf("Diag size = %d\n",size);*/
-		eigen(hamilt, size, eValues, eVectors);
-		if(i!=0)
+		NMRSpinSystem s;
+		initNMRSpinSystem(&s, nGroups, numberOfSpins, k);
+		nFrequencies = computeNMRSpinSystem(&s, chemichalShifts, ppmJ, nFrequencies, &frequenciesSpectrum, &gintensities);
+		freeNMRSpinSystem(&s);
+		for(g=0;g<nGroups;g++)
 		{
-			/* printf("Begin transition calculations\n");*/
-			ifreqSpec = addTransitions(nBasis,nSpins,start[i-1], istart, binomialCoef[i-1], size,
-					basis,
-					eValuesPrev, eValues, 
-					eVectorsPrev, eVectors,
-					ifreqSpec, frequenciesSpectrum, gintensities,transProb,lfs,mfs);
+			if(2*(k[g]+1)<=numberOfSpins[g]) { k[g]++; break; }
+			k[g] = 0;
 		}
-		/* swith prev and current eigenvalues and eigenvectors */
-		e = eValuesPrev;
-		eValuesPrev = eValues;
-		eValues = e;
-		v = eVectorsPrev;
-		eVectorsPrev = eVectors;
-		eVectors = v;
-	}
-	if(frequencies) free(frequencies);
-	if(ppmJCouplings) free(ppmJCouplings);
-	if(hamilt) free(hamilt);
-	if(lfs) free(lfs);
-	if(mfs) free(mfs);
-	/* prgint Hamiltonian */
-
-	if(eVectorsPrev) 
-	{
-		for(i=0;i<sizeMax;i++) if(eVectorsPrev[i]) free(eVectorsPrev[i]);
-		free(eVectorsPrev);
-	}
-	if(eVectors) 
-	{
-		for(i=0;i<sizeMax;i++) if(eVectors[i]) free(eVectors[i]);
-		free(eVectors);
-	}
-	if(eValues) free(eValues);
-	if(eValuesPrev) free(eValuesPrev);
-	if(transProb) free(transProb);
+	}while(g<nGroups);
 
-	nFrequencies = ifreqSpec;
-	if(nFrequencies>0)
-	{
-		/*
-		gint i;
-		for(i=0;i<nFrequencies;i++) 
-		{
-			printf("%f %f\n",frequenciesSpectrum[i],gintensities[i]);
-		}
-		*/
-		/*
-		nFrequencies =  removeIdenticalFrequencies(nFrequencies, frequenciesSpectrum, gintensities);
-		*/
-		if(nFrequencies<1)
-		{
-			if(frequenciesSpectrum) free(frequenciesSpectrum);
-			frequenciesSpectrum = NULL;
-			if(gintensities) free(gintensities);
-			gintensities = NULL;
-		}
-		else
-		{
-			frequenciesSpectrum = realloc(frequenciesSpectrum,nFrequencies*sizeof(gdouble));
-			gintensities = realloc(gintensities,nFrequencies*sizeof(gdouble));
-		}
-	}
+	for(g=0;g<nGroups;g++) free(ppmJ[g]);
+	free(ppmJ);
+	free(k);
 
 	*n = nFrequencies;
 	*X = frequenciesSpectrum;
@@ -53,7 +53,7 @@ ReducePolyHedralMolecule.o: ReducePolyHedralMolecule.c ../../Config.h \
  ../Symmetry/SymmetryOperators.h
 PrincipalAxis.o: PrincipalAxis.c ../../Config.h \
  ../Symmetry/MoleculeSymmetryType.h ../Symmetry/MoleculeSymmetry.h \
- ../Symmetry/SymmetryOperators.h
+ ../Symmetry/SymmetryOperators.h ../Utils/EigenSolver.h
 ReduceMolecule.o: ReduceMolecule.c ../../Config.h ../Utils/Constants.h \
  ../Symmetry/MoleculeSymmetryType.h ../Symmetry/MoleculeSymmetry.h \
  ../Symmetry/SymmetryOperators.h ../Symmetry/ReduceMolecule.h \
@@ -147,4 +147,5 @@ SymmetryGabedit.o: SymmetryGabedit.c ../../Config.h ../Common/Global.h \
  ../Symmetry/../Symmetry/../Symmetry/../Symmetry/SOperations.h \
  ../Symmetry/../Symmetry/../Symmetry/../Symmetry/SMolecule.h \
  ../Symmetry/../Symmetry/../Symmetry/../Symmetry/Elements.h \
- ../Symmetry/../Symmetry/../Symmetry/../Symmetry/HashMapSAtoms.h
+ ../Symmetry/../Symmetry/../Symmetry/../Symmetry/HashMapSAtoms.h \
+ ../Utils/EigenSolver.h
@@ -23,6 +23,7 @@ DEALINGS IN THE SOFTWARE.
 #include <math.h>
 #include "../Common/Global.h"
 #include "../Symmetry/SymmetryGabedit.h"
+#include "../Utils/EigenSolver.h"
 
 /************************************************************************************************************/
 static Elements getElements(Symmetry* symmetry);
@@ -221,108 +222,25 @@ static void findInversionCenter(Symmetry* symmetry)
 	addElement(symmetry, &inv);
 }
 /************************************************************************************************************/
-#define EPSILON 1.0E-12
-#define SQU(x,y,z) ((x)*(x) + (y)*(y) + (z)*(z))
-/* Jacobi diagonalisation of 3x3 symmetric matrix */
+/* diagonalisation of 3x3 symmetric matrix (closed form, EigenSolver.c) */
 /* matrix mat stored like   0 3 5    
                               1 4
                                 2   */
 static void jacobi(gdouble *mat, gdouble evec[3][3])
 {
-  
-	gdouble t,s,u;
-	gdouble a;
-	evec[0][1] = evec[0][2] = evec[1][0] = 0.0;  /* unity matrix */
-	evec[1][2] = evec[2][0] = evec[2][1] = 0.0;  /* unity matrix */
-	evec[0][0] = evec[1][1] = evec[2][2] = 1.0;
-
-	/* do jacobi sweep */
-	while(SQU(mat[3],mat[4],mat[5]) > EPSILON)
-	{
-		/* set mat[3] to zero */
-		if (mat[3]*mat[3] > EPSILON)
-		{
-			t = (mat[1]-mat[0])/(2.*mat[3]);
-	 		t = (t>0) ? 1./(t+sqrt(t*t+1.)) : -1./(-t+sqrt(t*t+1.));
-	 		s = t/(sqrt(t*t+1.));
-	  		u = s*t/(s+t);
-
-	  		mat[0] -= t*mat[3];
-	  		mat[1] += t*mat[3];
-	  		a = mat[5];
-	  		mat[5] -= s*(mat[4]+u*mat[5]);
-	  		mat[4] += s*(  a   -u*mat[4]);
-	  		mat[3] = 0.;
-	  
-	 		a = evec[0][0];
-	  		evec[0][0] -= s*(evec[0][1]+u*evec[0][0]);
-	  		evec[0][1] += s*(   a   -u*evec[0][1]);
-
-	  		a = evec[1][0];
-	  		evec[1][0] -= s*(evec[1][1]+u*evec[1][0]);
-	  		evec[1][1] += s*(   a   -u*evec[1][1]);
-
-	 		a = evec[2][0];
-	  		evec[2][0] -= s*(evec[2][1]+u*evec[2][0]);
-	  		evec[2][1] += s*(   a   -u*evec[2][1]);
-		}
-
-		/* set mat[5] to zero */
-		if (mat[5]*mat[5] > EPSILON)
-		{
-			t = (mat[2]-mat[0])/(2.*mat[5]);
-	  		t = (t>0) ? 1./(t+sqrt(t*t+1.)) : -1./(-t+sqrt(t*t+1.));
-	  		s = t/(sqrt(t*t+1.));
-	  		u = s*t/(s+t);
-
-	  		mat[0] -= t*mat[5];
-	  		mat[2] += t*mat[5];
-	  		a = mat[3];
-	  		mat[3] -= s*(mat[4]+u*mat[3]);
-	  		mat[4] += s*(  a   -u*mat[4]);
-	  		mat[5] = 0.;
-	  
-	  		a = evec[0][0];
-	  		evec[0][0] -= s*(evec[0][2]+u*evec[0][0]);
-	  		evec[0][2] += s*(   a   -u*evec[0][2]);
-
-	  		a = evec[1][0];
-	  		evec[1][0] -= s*(evec[1][2]+u*evec[1][0]);
-	  		evec[1][2] += s*(   a   -u*evec[1][2]);
-
-	  		a = evec[2][0];
-	  		evec[2][0] -= s*(evec[2][2]+u*evec[2][0]);
-	  		evec[2][2] += s*(   a   -u*evec[2][2]);
-		}
-
-		/* set mat[4] to zero */
-		if (mat[4]*mat[4] > EPSILON)
-		{
-	  		t = (mat[2]-mat[1])/(2.*mat[4]);
-	  		t = (t>0) ? 1./(t+sqrt(t*t+1.)) : -1./(-t+sqrt(t*t+1.));
-	  		s = t/(sqrt(t*t+1.));
-	  		u = s*t/(s+t);
-
-	  		mat[1] -= t*mat[4];
-	  		mat[2] += t*mat[4];
-	  		a = mat[3];
-	  		mat[3] -= s*(mat[5]+u*mat[3]);
-	  		mat[5] += s*(  a   -u*mat[5]);
-	  		mat[4] = 0.;
-
-	  		a = evec[0][1];
-	  		evec[0][1] -= s*(evec[0][2]+u*evec[0][1]);
-	  		evec[0][2] += s*(   a   -u*evec[0][2]);
-
-	  		a = evec[1][1];
-	  		evec[1][1] -= s*(evec[1][2]+u*evec[1][1]);
-	  		evec[1][2] += s*(   a   -u*evec[1][2]);
-
-	  		a = evec[2][1];
-	  		evec[2][1] -= s*(evec[2][2]+u*evec[2][1]);
-	  		evec[2][2] += s*(   a   -u*evec[2][2]);
-		}
-	}
+	gdouble A[3][3];
+	gdouble d[3];
+	A[0][0] = mat[0];
+	A[1][1] = mat[1];
+	A[2][2] = mat[2];
+	A[0][1] = A[1][0] = mat[3];
+	A[1][2] = A[2][1] = mat[4];
+	A[0][2] = A[2][0] = mat[5];
+	eigenSymmetric3(A, d, evec);
+	mat[0] = d[0];
+	mat[1] = d[1];
+	mat[2] = d[2];
+	mat[3] = mat[4] = mat[5] = 0.0;
 }
 /************************************************************************************************************/
 static void swap(gint i,gint j,gdouble* mat, gdouble vecs[3][3])
@@ -10,10 +10,23 @@ AtomsProp.o: AtomsProp.c ../../Config.h ../Common/Global.h \
  ../Common/Windows.h
 Jacobi.o: Jacobi.c ../../Config.h ../Common/Global.h \
  ../Common/../Files/GabeditFileChooser.h \
- ../Common/../Common/GabeditType.h
+ ../Common/../Common/GabeditType.h ../Utils/EigenSolver.h
 QL.o: QL.c ../../Config.h ../Common/Global.h \
  ../Common/../Files/GabeditFileChooser.h \
- ../Common/../Common/GabeditType.h
+ ../Common/../Common/GabeditType.h ../Utils/EigenSolver.h
+EigenSolver.o: EigenSolver.c ../../Config.h ../Common/Global.h \
+ ../Common/../Files/GabeditFileChooser.h \
+ ../Common/../Common/GabeditType.h ../Utils/EigenSolver.h
+FChkFile.o: FChkFile.c ../../Config.h ../Common/Global.h \
+ ../Common/../Files/GabeditFileChooser.h \
+ ../Common/../Common/GabeditType.h ../Utils/FChkFile.h
+VASPXmlFile.o: VASPXmlFile.c ../../Config.h ../Common/Global.h \
+ ../Common/../Files/GabeditFileChooser.h \
+ ../Common/../Common/GabeditType.h ../Utils/Constants.h ../Utils/Utils.h \
+ ../Utils/VASPXmlFile.h
+LogIndex.o: LogIndex.c ../../Config.h ../Common/Global.h \
+ ../Common/../Files/GabeditFileChooser.h \
+ ../Common/../Common/GabeditType.h ../Utils/LogIndex.h
 Transformation.o: Transformation.c ../../Config.h ../Common/Global.h \
  ../Common/../Files/GabeditFileChooser.h \
  ../Common/../Common/GabeditType.h Vector3d.h Transformation.h Utils.h
@@ -109,4 +122,5 @@ UtilsVASP.o: UtilsVASP.c ../../Config.h ../Common/Global.h \
  ../Common/../Files/GabeditFileChooser.h \
  ../Common/../Common/GabeditType.h ../Utils/Constants.h \
  ../Utils/UtilsInterface.h ../Utils/Utils.h ../Files/FileChooser.h \
- ../Common/Windows.h ../Utils/GabeditXYPlot.h ../Display/Vibration.h
+ ../Common/Windows.h ../Utils/GabeditXYPlot.h ../Display/Vibration.h \
+ ../Utils/VASPXmlFile.h
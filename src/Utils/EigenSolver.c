@@ -0,0 +1,675 @@
+/* EigenSolver.c */
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+/* Eigenvalues and eigenvectors of a real symmetric matrix :
+ *  blocked Householder reduction to a tridiagonal matrix (panels of NBPANEL columns, rank-2k updates),
+ *  divide and conquer on the tridiagonal matrix (Cuppen, eigenvectors by the Gu-Eisenstat formula),
+ *  back transformation by the Householder vectors.
+ *  The rank-2k updates, the matrix products of the merges and the back transformation are parallelised by OpenMP.
+ */
+#include "../../Config.h"
+#include "../Common/Global.h"
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <float.h>
+#ifdef ENABLE_OMP
+#include <omp.h>
+#endif
+#include "../Utils/EigenSolver.h"
+
+/* number of columns by panel in the tridiagonal reduction */
+#define NBPANEL 32
+/* size of the tridiagonal blocks diagonalised by QL in the divide and conquer */
+#define NMINDC 25
+
+typedef struct _EigenSortEntry
+{
+	gdouble value;
+	gint index;
+}EigenSortEntry;
+/********************************************************************************/
+static gint compareEigenSortEntry(const void* a, const void* b)
+{
+	gdouble va = ((EigenSortEntry*)a)->value;
+	gdouble vb = ((EigenSortEntry*)b)->value;
+	if(va<vb) return -1;
+	if(va>vb) return 1;
+	return 0;
+}
+/********************************************************************************/
+/* QL algorithm with implicit shifts for a tridiagonal matrix. 
+ * e[0..n-2] : off-diagonal, e[n-1] = 0 (modified). Q (n*n) is multiplied by the rotations */
+static gint tridiagonalQL(gint n, gdouble *d, gdouble *e, gdouble *Q)
+{
+	gint m, l, iter, i, k;
+	gdouble s, r, p, g, f, dd, c, b;
+
+	for (l = 0; l < n; l++)
+	{
+		iter = 0;
+		do
+		{
+			for (m = l; m < n - 1; m++)
+			{
+				dd = fabs(d[m]) + fabs(d[m + 1]);
+				if (fabs(e[m]) + dd == dd) break;
+			}
+			if (m != l)
+			{
+				if (iter++ == 60) return 0;
+				g = (d[l + 1] - d[l]) / (2.0 * e[l]);
+				r = sqrt((g*g) + 1.0);
+				g = d[m] - d[l] + e[l] / (g + (g<0?-fabs(r):fabs(r)));
+				s = c = 1.0;
+				p = 0.0;
+				for (i = m - 1; i >= l; i--)
+				{
+					f = s * e[i];
+					b = c * e[i];
+					if (fabs(f) >= fabs(g))
+					{
+						c = g / f;
+						r = sqrt((c*c) + 1.0);
+						e[i + 1] = f * r;
+						c *= (s = 1.0 / r);
+					} 
+					else
+					{
+						s = f / g;
+						r = sqrt((s*s) + 1.0);
+						e[i + 1] = g * r;
+						s *= (c = 1.0 / r);
+					}
+					g = d[i + 1] - p;
+					r = (d[i] - g) * s + 2.0 * c * b;
+					p = s * r;
+					d[i + 1] = g + p;
+					g = c * r - b;
+					for (k = 0; k < n; k++)
+					{
+						f = Q[k*n+i + 1];
+						Q[k*n+i + 1] = s * Q[k*n+i] + c * f;
+						Q[k*n+i] = c * Q[k*n+i] - s * f;
+					}
+				}
+				d[l] = d[l] - p;
+				e[l] = g;
+				e[m] = 0.0;
+			}
+		} while (m != l);
+	}
+	return 1;
+}
+/********************************************************************************/
+/* Blocked Householder reduction. A (full, row major) is overwritten : 
+ * the vector of H_k = I - tau[k] v v^t is stored in the column k, v[k+1] = 1, v[i] = A[i][k] for i>k+1.
+ * Inside a panel, A is not updated, the reflectors are kept in V and W : A - V W^t - W V^t */
+static void reductionToTridiagonalBlocked(gint n, gdouble* A, gdouble* d, gdouble* e, gdouble* tau)
+{
+	gint k0, i, p;
+	gdouble* V = malloc(n*NBPANEL*sizeof(gdouble));
+	gdouble* W = malloc(n*NBPANEL*sizeof(gdouble));
+	gdouble* y = malloc(n*sizeof(gdouble));
+	gdouble c1[NBPANEL];
+	gdouble c2[NBPANEL];
+
+	for(k0=0;k0<n-2;k0+=NBPANEL)
+	{
+		gint kb = MIN(NBPANEL, n-2-k0);
+		gint r0 = k0+kb;
+		gint jj;
+		for(jj=0;jj<kb;jj++)
+		{
+			gint k = k0+jj;
+			gdouble alpha, sigma, beta, dot;
+
+			/* update of the column k by the previous reflectors of the panel */
+			for(i=k;i<n;i++)
+			{
+				gdouble s = 0;
+				for(p=0;p<jj;p++) s += V[i*NBPANEL+p]*W[k*NBPANEL+p] + W[i*NBPANEL+p]*V[k*NBPANEL+p];
+				A[i*n+k] -= s;
+			}
+			d[k] = A[k*n+k];
+			alpha = A[(k+1)*n+k];
+			sigma = 0;
+			for(i=k+2;i<n;i++) sigma += A[i*n+k]*A[i*n+k];
+			for(i=0;i<=k;i++) V[i*NBPANEL+jj] = W[i*NBPANEL+jj] = 0;
+			if(sigma==0)
+			{
+				tau[k] = 0;
+				e[k] = alpha;
+				for(i=k+1;i<n;i++) V[i*NBPANEL+jj] = W[i*NBPANEL+jj] = 0;
+				continue;
+			}
+			beta = sqrt(alpha*alpha+sigma);
+			if(alpha>0) beta = -beta;
+			tau[k] = (beta-alpha)/beta;
+			e[k] = beta;
+			for(i=k+2;i<n;i++) A[i*n+k] /= alpha-beta;
+			A[(k+1)*n+k] = 1.0;
+			for(i=k+1;i<n;i++) V[i*NBPANEL+jj] = A[i*n+k];
+
+			/* y = tau (A - V W^t - W V^t) v */
+			for(p=0;p<jj;p++)
+			{
+				c1[p] = c2[p] = 0;
+				for(i=k+1;i<n;i++)
+				{
+					c1[p] += W[i*NBPANEL+p]*A[i*n+k];
+					c2[p] += V[i*NBPANEL+p]*A[i*n+k];
+				}
+			}
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(i,p) if(n-k>128)
+#endif
+			for(i=k+1;i<n;i++)
+			{
+				gint j;
+				gdouble s = 0;
+				gdouble* a = A+i*n;
+				for(j=k+1;j<n;j++) s += a[j]*V[j*NBPANEL+jj];
+				for(p=0;p<jj;p++) s -= V[i*NBPANEL+p]*c1[p] + W[i*NBPANEL+p]*c2[p];
+				y[i] = tau[k]*s;
+			}
+			dot = 0;
+			for(i=k+1;i<n;i++) dot += y[i]*A[i*n+k];
+			dot *= -0.5*tau[k];
+			for(i=k+1;i<n;i++) W[i*NBPANEL+jj] = y[i] + dot*A[i*n+k];
+		}
+		/* rank-2kb update of the trailing matrix */
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(i,p) schedule(dynamic,8)
+#endif
+		for(i=r0;i<n;i++)
+		{
+			gint j;
+			gdouble* vi = V+i*NBPANEL;
+			gdouble* wi = W+i*NBPANEL;
+			gdouble* a = A+i*n;
+			for(j=r0;j<n;j++)
+			{
+				gdouble* vj = V+j*NBPANEL;
+				gdouble* wj = W+j*NBPANEL;
+				gdouble s = 0;
+				for(p=0;p<kb;p++) s += vi[p]*wj[p] + wi[p]*vj[p];
+				a[j] -= s;
+			}
+		}
+	}
+	if(n>1)
+	{
+		d[n-2] = A[(n-2)*n+n-2];
+		e[n-2] = A[(n-1)*n+n-2];
+		tau[n-2] = 0;
+	}
+	d[n-1] = A[(n-1)*n+n-1];
+	e[n-1] = 0;
+	tau[n-1] = 0;
+	free(V);
+	free(W);
+	free(y);
+}
+/********************************************************************************/
+/* secular function f = 1 + rho sum z^2/(D-lambda), lambda = D[o]+t */
+static gdouble secularFunction(gint n, gdouble* D, gdouble* z, gdouble rho, gint o, gdouble t, gdouble* df)
+{
+	gint i;
+	gdouble f = 1;
+	*df = 0;
+	for(i=0;i<n;i++)
+	{
+		gdouble delta = (D[i]-D[o])-t;
+		gdouble q = z[i]/delta;
+		f += rho*z[i]*q;
+		*df += rho*q*q;
+	}
+	return f;
+}
+/********************************************************************************/
+/* root j of the secular equation, lambda = D[*o]+t, D sorted, distinct, z != 0 */
+static gdouble secularRoot(gint n, gdouble* D, gdouble* z, gdouble rho, gint j, gint* o)
+{
+	gdouble a, b, t, f, df;
+	gint iter;
+
+	if(j<n-1)
+	{
+		gdouble mid = (D[j+1]-D[j])/2;
+		f = secularFunction(n, D, z, rho, j, mid, &df);
+		if(f>=0) { *o = j; a = 0; b = mid; }
+		else { *o = j+1; a = -mid; b = 0; }
+	}
+	else
+	{
+		gint i;
+		gdouble s = 0;
+		for(i=0;i<n;i++) s += z[i]*z[i];
+		*o = n-1; a = 0; b = rho*s;
+	}
+	/* Newton iterations, bisection if Newton goes out of [a,b] */
+	t = (a+b)/2;
+	for(iter=0;iter<200;iter++)
+	{
+		gdouble tn;
+		f = secularFunction(n, D, z, rho, *o, t, &df);
+		if(f==0) break;
+		if(f<0) a = t;
+		else b = t;
+		tn = t-f/df;
+		if(tn<=a || tn>=b) tn = (a+b)/2;
+		if(fabs(tn-t)<=2*DBL_EPSILON*MAX(fabs(t),fabs(tn)) || b-a<=2*DBL_EPSILON*MAX(fabs(a),fabs(b))) { t = tn; break; }
+		t = tn;
+	}
+	return t;
+}
+/********************************************************************************/
+/* eigenvalues lambda, eigenvectors U (U[i*n+j]) of diag(D) + rho z z^t */
+static void rankOneEigen(gint n, gdouble* D, gdouble rho, gdouble* z, gdouble* lambda, gdouble* U)
+{
+	EigenSortEntry* entries = NULL;
+	gint* kept = NULL;
+	gint* origin = NULL;
+	gint* rotIndex = NULL;
+	gdouble* rotCS = NULL;
+	gdouble* dk = NULL;
+	gdouble* zk = NULL;
+	gdouble* tk = NULL;
+	gdouble nz2 = 0;
+	gdouble dmax = 0;
+	gdouble tol;
+	gint nk = 0;
+	gint nr = 0;
+	gint nc = 0;
+	gint i, j, r;
+
+	for(i=0;i<n*n;i++) U[i] = 0;
+	for(i=0;i<n;i++) nz2 += z[i]*z[i];
+	if(rho*nz2==0)
+	{
+		for(i=0;i<n;i++) { lambda[i] = D[i]; U[i*n+i] = 1; }
+		return;
+	}
+	for(i=0;i<n;i++) z[i] /= sqrt(nz2);
+	rho *= nz2;
+
+	entries = malloc(n*sizeof(EigenSortEntry));
+	kept = malloc(n*sizeof(gint));
+	rotIndex = malloc(2*n*sizeof(gint));
+	rotCS = malloc(2*n*sizeof(gdouble));
+	for(i=0;i<n;i++)
+	{
+		entries[i].value = D[i];
+		entries[i].index = i;
+		if(fabs(D[i])>dmax) dmax = fabs(D[i]);
+	}
+	qsort(entries, n, sizeof(EigenSortEntry), compareEigenSortEntry);
+	tol = 8*DBL_EPSILON*MAX(dmax,rho);
+
+	/* deflation : small z, or close D (Givens rotation) */
+	nc = n-1;
+	for(r=0;r<n;r++)
+	{
+		i = entries[r].index;
+		if(rho*fabs(z[i])<=tol)
+		{
+			lambda[nc] = D[i];
+			U[i*n+nc] = 1;
+			nc--;
+			continue;
+		}
+		if(nk>0)
+		{
+			gint p = kept[nk-1];
+			if(fabs(D[i]-D[p])<=tol)
+			{
+				gdouble rr = sqrt(z[p]*z[p]+z[i]*z[i]);
+				gdouble c = z[p]/rr;
+				gdouble s = z[i]/rr;
+				gdouble dp = c*c*D[p]+s*s*D[i];
+				gdouble di = s*s*D[p]+c*c*D[i];
+				D[p] = dp;
+				z[p] = rr;
+				z[i] = 0;
+				rotIndex[2*nr] = p;
+				rotIndex[2*nr+1] = i;
+				rotCS[2*nr] = c;
+				rotCS[2*nr+1] = s;
+				nr++;
+				lambda[nc] = di;
+				U[i*n+nc] = 1;
+				nc--;
+				continue;
+			}
+		}
+		kept[nk++] = i;
+	}
+
+	dk = malloc(nk*sizeof(gdouble));
+	zk = malloc(nk*sizeof(gdouble));
+	tk = malloc(nk*sizeof(gdouble));
+	origin = malloc(nk*sizeof(gint));
+	for(j=0;j<nk;j++)
+	{
+		dk[j] = D[kept[j]];
+		zk[j] = z[kept[j]];
+	}
+	for(j=0;j<nk;j++)
+	{
+		tk[j] = secularRoot(nk, dk, zk, rho, j, &origin[j]);
+		lambda[j] = dk[origin[j]]+tk[j];
+	}
+	/* Gu-Eisenstat : z recomputed from the eigenvalues, the eigenvectors are then orthogonal */
+	for(i=0;i<nk;i++)
+	{
+		gdouble w = (dk[i]-dk[origin[i]])-tk[i];
+		for(j=0;j<nk;j++)
+		{
+			if(j==i) continue;
+			w *= ((dk[i]-dk[origin[j]])-tk[j])/(dk[i]-dk[j]);
+		}
+		w = sqrt(fabs(w)/rho);
+		zk[i] = (zk[i]<0)?-w:w;
+	}
+	for(j=0;j<nk;j++)
+	{
+		gdouble norm = 0;
+		for(i=0;i<nk;i++)
+		{
+			gdouble u = zk[i]/((dk[i]-dk[origin[j]])-tk[j]);
+			U[kept[i]*n+j] = u;
+			norm += u*u;
+		}
+		norm = 1.0/sqrt(norm);
+		for(i=0;i<nk;i++) U[kept[i]*n+j] *= norm;
+	}
+	/* back to the basis before the rotations */
+	for(r=nr-1;r>=0;r--)
+	{
+		gint p = rotIndex[2*r];
+		gint q = rotIndex[2*r+1];
+		gdouble c = rotCS[2*r];
+		gdouble s = rotCS[2*r+1];
+		for(j=0;j<n;j++)
+		{
+			gdouble up = U[p*n+j];
+			gdouble uq = U[q*n+j];
+			U[p*n+j] = c*up-s*uq;
+			U[q*n+j] = s*up+c*uq;
+		}
+	}
+	free(entries);
+	free(kept);
+	free(rotIndex);
+	free(rotCS);
+	free(dk);
+	free(zk);
+	free(tk);
+	free(origin);
+}
+/********************************************************************************/
+/* divide and conquer, Q[i*n+j] : component i of the eigenvector j of the tridiagonal matrix (d,e) */
+static gint tridiagonalDC(gint n, gdouble* d, gdouble* e, gdouble* Q)
+{
+	gint m, n2, i;
+	gdouble rho, sign;
+	gdouble* Q1 = NULL;
+	gdouble* Q2 = NULL;
+	gdouble* z = NULL;
+	gdouble* D = NULL;
+	gdouble* U = NULL;
+	gint ok = 1;
+
+	if(n<=NMINDC)
+	{
+		gdouble* ew = malloc(n*sizeof(gdouble));
+		for(i=0;i<n*n;i++) Q[i] = 0;
+		for(i=0;i<n;i++) Q[i*n+i] = 1;
+		for(i=0;i<n-1;i++) ew[i] = e[i];
+		ew[n-1] = 0;
+		ok = tridiagonalQL(n, d, ew, Q);
+		free(ew);
+		return ok;
+	}
+	m = n/2;
+	n2 = n-m;
+	rho = fabs(e[m-1]);
+	sign = (e[m-1]<0)?-1:1;
+	d[m-1] -= rho;
+	d[m] -= rho;
+	Q1 = malloc(m*m*sizeof(gdouble));
+	Q2 = malloc(n2*n2*sizeof(gdouble));
+	ok = tridiagonalDC(m, d, e, Q1);
+	if(ok) ok = tridiagonalDC(n2, d+m, e+m, Q2);
+	if(!ok)
+	{
+		free(Q1);
+		free(Q2);
+		return 0;
+	}
+	z = malloc(n*sizeof(gdouble));
+	D = malloc(n*sizeof(gdouble));
+	U = malloc(n*n*sizeof(gdouble));
+	for(i=0;i<m;i++) z[i] = Q1[(m-1)*m+i];
+	for(i=0;i<n2;i++) z[m+i] = sign*Q2[i];
+	for(i=0;i<n;i++) D[i] = d[i];
+	rankOneEigen(n, D, rho, z, d, U);
+
+	/* Q = diag(Q1,Q2) U */
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(i) if(n>128)
+#endif
+	for(i=0;i<n;i++)
+	{
+		gint j, k;
+		gdouble* q = Q+i*n;
+		for(j=0;j<n;j++) q[j] = 0;
+		if(i<m)
+		{
+			for(k=0;k<m;k++)
+			{
+				gdouble a = Q1[i*m+k];
+				gdouble* u = U+k*n;
+				if(a!=0) for(j=0;j<n;j++) q[j] += a*u[j];
+			}
+		}
+		else
+		{
+			for(k=0;k<n2;k++)
+			{
+				gdouble a = Q2[(i-m)*n2+k];
+				gdouble* u = U+(m+k)*n;
+				if(a!=0) for(j=0;j<n;j++) q[j] += a*u[j];
+			}
+		}
+	}
+	free(Q1);
+	free(Q2);
+	free(z);
+	free(D);
+	free(U);
+	return 1;
+}
+/********************************************************************************/
+gint eigenSymmetric(gint n, gdouble* A, gdouble* d, gdouble* V)
+{
+	gdouble* a = NULL;
+	gdouble* e = NULL;
+	gdouble* tau = NULL;
+	gdouble* Z = NULL;
+	EigenSortEntry* entries = NULL;
+	gint i, j;
+	gint ok;
+
+	if(n<1) return 0;
+	if(n==1)
+	{
+		d[0] = A[0];
+		V[0] = 1;
+		return 1;
+	}
+	a = malloc(n*n*sizeof(gdouble));
+	e = malloc(n*sizeof(gdouble));
+	tau = malloc(n*sizeof(gdouble));
+	Z = malloc(n*n*sizeof(gdouble));
+	for(i=0;i<n*n;i++) a[i] = A[i];
+	reductionToTridiagonalBlocked(n, a, d, e, tau);
+	ok = tridiagonalDC(n, d, e, Z);
+	if(ok)
+	{
+		/* eigenvectors by column (contiguous), then back transformation V = H0 H1 ... Z */
+		gdouble* Zt = malloc(n*n*sizeof(gdouble));
+		gdouble* R = malloc(n*n*sizeof(gdouble));
+		for(i=0;i<n;i++)
+		for(j=0;j<n;j++)
+		{
+			Zt[j*n+i] = Z[i*n+j];
+			R[j*n+i] = a[i*n+j];
+		}
+#ifdef ENABLE_OMP
+#pragma omp parallel for private(j) if(n>64)
+#endif
+		for(j=0;j<n;j++)
+		{
+			gint k, l;
+			gdouble* z = Zt+j*n;
+			for(k=n-3;k>=0;k--)
+			{
+				gdouble* v = R+k*n;
+				gdouble s;
+				if(tau[k]==0) continue;
+				s = z[k+1];
+				for(l=k+2;l<n;l++) s += v[l]*z[l];
+				s *= tau[k];
+				z[k+1] -= s;
+				for(l=k+2;l<n;l++) z[l] -= s*v[l];
+			}
+		}
+		entries = malloc(n*sizeof(EigenSortEntry));
+		for(j=0;j<n;j++)
+		{
+			entries[j].value = d[j];
+			entries[j].index = j;
+		}
+		qsort(entries, n, sizeof(EigenSortEntry), compareEigenSortEntry);
+		for(j=0;j<n;j++)
+		{
+			gdouble* z = Zt+entries[j].index*n;
+			d[j] = entries[j].value;
+			for(i=0;i<n;i++) V[i*n+j] = z[i];
+		}
+		free(entries);
+		free(Zt);
+		free(R);
+	}
+	free(a);
+	free(e);
+	free(tau);
+	free(Z);
+	return ok;
+}
+/********************************************************************************/
+static void normalizeVector3(gdouble* v)
+{
+	gdouble norm = sqrt(v[0]*v[0]+v[1]*v[1]+v[2]*v[2]);
+	if(norm>0) { v[0] /= norm; v[1] /= norm; v[2] /= norm; }
+}
+/********************************************************************************/
+/* eigenvector of a well separated eigenvalue : largest cross product of two rows of A - lambda I */
+static void eigenVector3(gdouble A[3][3], gdouble lambda, gdouble* v)
+{
+	gdouble r[3][3];
+	gdouble c[3][3];
+	gdouble best = -1;
+	gint i, k;
+	for(i=0;i<3;i++) for(k=0;k<3;k++) r[i][k] = A[i][k]-((i==k)?lambda:0);
+	for(i=0;i<3;i++)
+	{
+		gdouble* a = r[i];
+		gdouble* b = r[(i+1)%3];
+		gdouble n2;
+		c[i][0] = a[1]*b[2]-a[2]*b[1];
+		c[i][1] = a[2]*b[0]-a[0]*b[2];
+		c[i][2] = a[0]*b[1]-a[1]*b[0];
+		n2 = c[i][0]*c[i][0]+c[i][1]*c[i][1]+c[i][2]*c[i][2];
+		if(n2>best)
+		{
+			best = n2;
+			for(k=0;k<3;k++) v[k] = c[i][k];
+		}
+	}
+	normalizeVector3(v);
+}
+/********************************************************************************/
+/* trigonometric solution of the characteristic polynomial. Close eigenvalues : general solver */
+gint eigenSymmetric3(gdouble A[3][3], gdouble d[3], gdouble V[3][3])
+{
+	gdouble p1 = A[0][1]*A[0][1]+A[0][2]*A[0][2]+A[1][2]*A[1][2];
+	gdouble q = (A[0][0]+A[1][1]+A[2][2])/3;
+	gdouble p2, p, r, phi;
+	gdouble B[3][3];
+	gdouble v0[3], v2[3];
+	gint i, j;
+
+	if(p1==0)
+	{
+		EigenSortEntry entries[3];
+		for(i=0;i<3;i++) { entries[i].value = A[i][i]; entries[i].index = i; }
+		qsort(entries, 3, sizeof(EigenSortEntry), compareEigenSortEntry);
+		for(j=0;j<3;j++)
+		{
+			d[j] = entries[j].value;
+			for(i=0;i<3;i++) V[i][j] = (i==entries[j].index)?1:0;
+		}
+		return 1;
+	}
+	p2 = (A[0][0]-q)*(A[0][0]-q)+(A[1][1]-q)*(A[1][1]-q)+(A[2][2]-q)*(A[2][2]-q)+2*p1;
+	p = sqrt(p2/6);
+	for(i=0;i<3;i++) for(j=0;j<3;j++) B[i][j] = (A[i][j]-((i==j)?q:0))/p;
+	r = ( B[0][0]*(B[1][1]*B[2][2]-B[1][2]*B[2][1])
+	     -B[0][1]*(B[1][0]*B[2][2]-B[1][2]*B[2][0])
+	     +B[0][2]*(B[1][0]*B[2][1]-B[1][1]*B[2][0]))/2;
+	if(r<=-1) phi = M_PI/3;
+	else if(r>=1) phi = 0;
+	else phi = acos(r)/3;
+	d[2] = q+2*p*cos(phi);
+	d[0] = q+2*p*cos(phi+2*M_PI/3);
+	d[1] = 3*q-d[0]-d[2];
+
+	if(d[1]-d[0]<1e-4*p || d[2]-d[1]<1e-4*p)
+	{
+		gdouble a[9];
+		gdouble v[9];
+		for(i=0;i<3;i++) for(j=0;j<3;j++) a[i*3+j] = A[i][j];
+		if(!eigenSymmetric(3, a, d, v)) return 0;
+		for(i=0;i<3;i++) for(j=0;j<3;j++) V[i][j] = v[i*3+j];
+		return 1;
+	}
+	eigenVector3(A, d[0], v0);
+	eigenVector3(A, d[2], v2);
+	for(i=0;i<3;i++)
+	{
+		V[i][0] = v0[i];
+		V[i][2] = v2[i];
+	}
+	V[0][1] = v2[1]*v0[2]-v2[2]*v0[1];
+	V[1][1] = v2[2]*v0[0]-v2[0]*v0[2];
+	V[2][1] = v2[0]*v0[1]-v2[1]*v0[0];
+	return 1;
+}
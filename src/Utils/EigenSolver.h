@@ -0,0 +1,30 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#ifndef __GABEDIT_EIGENSOLVER_H__
+#define __GABEDIT_EIGENSOLVER_H__
+
+/* A : full symmetric matrix n*n (row major), not modified.
+ * d : eigenvalues in ascending order, V[i*n+j] : component i of the eigenvector j.
+ * return 1 on success */
+gint eigenSymmetric(gint n, gdouble* A, gdouble* d, gdouble* V);
+/* closed form for a 3x3 matrix, V[i][j] : component i of the eigenvector j */
+gint eigenSymmetric3(gdouble A[3][3], gdouble d[3], gdouble V[3][3]);
+
+#endif /* __GABEDIT_EIGENSOLVER_H__ */
+
@@ -0,0 +1,377 @@
+/* FChkFile.c */
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+/* Reader of Gaussian formatted checkpoint files.
+ * The file is mapped in memory and the offsets of all blocks are indexed in one pass,
+ * the numerical blocks are decoded by a fixed format parser, large blocks by chunks in parallel.
+ */
+#include "../../Config.h"
+#include "../Common/Global.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#ifdef ENABLE_OMP
+#include <omp.h>
+#endif
+#include "../Utils/Utils.h"
+#include "../Utils/FChkFile.h"
+
+/* size in bytes of the chunks decoded in parallel */
+#define FCHKCHUNKSIZE (1<<20)
+
+/****************************************************************************/
+static gint getNumberOfElementsByLine(gchar type)
+{
+	switch(type)
+	{
+		case 'I' : return 6;
+		case 'R' : return 5;
+		case 'C' : return 5;
+		case 'H' : return 9;
+		case 'L' : return 72;
+	}
+	return 1;
+}
+/****************************************************************************/
+static gsize nextLine(const gchar* data, gsize pos, gsize end)
+{
+	const gchar* eol;
+	if(pos>=end) return end;
+	eol = memchr(data+pos,'\n',end-pos);
+	if(!eol) return end;
+	return eol-data+1;
+}
+/****************************************************************************/
+static void addBlock(FChkFile* fchk, gint* nMax, const gchar* line, gsize ll)
+{
+	FChkBlock* block;
+	gchar* t;
+	if(fchk->nBlocks>=*nMax)
+	{
+		*nMax *= 2;
+		fchk->blocks = g_realloc(fchk->blocks, *nMax*sizeof(FChkBlock));
+	}
+	block = &fchk->blocks[fchk->nBlocks];
+	block->header = g_strndup(line, ll);
+	for(t=block->header;*t;t++) if(*t=='\r') *t = ' ';
+	block->name = g_strstrip(g_strndup(line, 40));
+	block->type = line[43];
+	block->nElements = -1;
+	block->begin = 0;
+	block->end = 0;
+	block->values = NULL;
+	if(ll>49 && line[47]=='N' && line[48]=='=') 
+	{
+		block->nElements = atoi(block->header+49);
+		if(block->nElements<0) block->nElements = 0;
+	}
+	fchk->nBlocks++;
+}
+/****************************************************************************/
+static void indexFChkFile(FChkFile* fchk)
+{
+	const gchar* data = fchk->data;
+	gsize length = fchk->length;
+	gsize pos = 0;
+	gint nLines = 0;
+	gint nMax = 128;
+	gint i;
+
+	fchk->nBlocks = 0;
+	fchk->blocks = g_malloc(nMax*sizeof(FChkBlock));
+	while(pos<length)
+	{
+		const gchar* line = data+pos;
+		gsize next = nextLine(data, pos, length);
+		gsize ll = next-pos;
+		FChkBlock* block;
+
+		while(ll>0 && (line[ll-1]=='\n' || line[ll-1]=='\r')) ll--;
+		nLines++;
+		/* the 2 first lines are the title and the type of calculation */
+		if(nLines<=2 || ll<44 || line[0]==' ' || line[42]!=' ' || !line[43] || !strchr("IRCHL",line[43]))
+		{
+			pos = next;
+			continue;
+		}
+		addBlock(fchk, &nMax, line, ll);
+		block = &fchk->blocks[fchk->nBlocks-1];
+		pos = next;
+		if(block->nElements<0) continue;
+		block->begin = pos;
+		nLines = (block->nElements+getNumberOfElementsByLine(block->type)-1)/getNumberOfElementsByLine(block->type);
+		for(i=0;i<nLines;i++) pos = nextLine(data, pos, length);
+		block->end = pos;
+		nLines = 2;
+	}
+	fchk->index = g_hash_table_new(g_str_hash, g_str_equal);
+	for(i=fchk->nBlocks-1;i>=0;i--) g_hash_table_insert(fchk->index, fchk->blocks[i].name, GINT_TO_POINTER(i+1));
+}
+/****************************************************************************/
+FChkFile* new_fchk_gaussian_file(const gchar* fileName)
+{
+	GMappedFile* map;
+	FChkFile* fchk;
+	if(!fileName) return NULL;
+	map = g_mapped_file_new(fileName, FALSE, NULL);
+	if(!map) return NULL;
+	fchk = g_malloc(sizeof(FChkFile));
+	fchk->map = map;
+	fchk->data = g_mapped_file_get_contents(map);
+	fchk->length = g_mapped_file_get_length(map);
+	if(!fchk->data) fchk->length = 0;
+	indexFChkFile(fchk);
+	return fchk;
+}
+/****************************************************************************/
+static void freeBlockValues(FChkBlock* block)
+{
+	if(!block->values) return;
+	if(block->type=='C' || block->type=='H')
+	{
+		gchar** strs = block->values;
+		gint i;
+		for(i=0;i<block->nElements;i++) if(strs[i]) g_free(strs[i]);
+	}
+	g_free(block->values);
+	block->values = NULL;
+}
+/****************************************************************************/
+void free_fchk_gaussian_file(FChkFile* fchk)
+{
+	gint i;
+	if(!fchk) return;
+	for(i=0;i<fchk->nBlocks;i++)
+	{
+		freeBlockValues(&fchk->blocks[i]);
+		g_free(fchk->blocks[i].name);
+		g_free(fchk->blocks[i].header);
+	}
+	if(fchk->blocks) g_free(fchk->blocks);
+	if(fchk->index) g_hash_table_destroy(fchk->index);
+	g_mapped_file_unref(fchk->map);
+	g_free(fchk);
+}
+/****************************************************************************/
+/* same rules as the old sequential readers : the block name can be a part of the header line */
+static FChkBlock* findBlock(FChkFile* fchk, const gchar* blockName)
+{
+	gchar* key;
+	gint i;
+	if(!fchk || !blockName) return NULL;
+	key = g_strstrip(g_strdup(blockName));
+	i = GPOINTER_TO_INT(g_hash_table_lookup(fchk->index, key));
+	g_free(key);
+	if(i>0) return &fchk->blocks[i-1];
+	for(i=0;i<fchk->nBlocks;i++) if(strstr(fchk->blocks[i].header, blockName)) return &fchk->blocks[i];
+	return NULL;
+}
+/****************************************************************************/
+gboolean has_block_in_fchk(FChkFile* fchk, const gchar* blockName)
+{
+	return findBlock(fchk, blockName)!=NULL;
+}
+/****************************************************************************/
+gint get_one_int_from_fchk(FChkFile* fchk, const gchar* blockName)
+{
+	FChkBlock* block = findBlock(fchk, blockName);
+	if(!block || block->nElements>=0 || strlen(block->header)<=44) return -1;
+	return atoi(block->header+44);
+}
+/****************************************************************************/
+gdouble get_one_real_from_fchk(FChkFile* fchk, const gchar* blockName)
+{
+	FChkBlock* block = findBlock(fchk, blockName);
+	if(!block || block->nElements>=0 || strlen(block->header)<=44) return -1;
+	return g_ascii_strtod(block->header+44, NULL);
+}
+/****************************************************************************/
+static gint fastStrtoi(const gchar** pp, const gchar* e)
+{
+	const gchar* p = *pp;
+	gboolean negative = FALSE;
+	gint v = 0;
+	if(p<e && (*p=='-' || *p=='+')) negative = (*p++=='-');
+	for(;p<e && *p>='0' && *p<='9';p++) v = v*10+(*p-'0');
+	while(p<e && !isspace((guchar)*p)) p++;
+	*pp = p;
+	return negative?-v:v;
+}
+/****************************************************************************/
+/* decode the elements iBegin..iEnd-1 of a numerical block from the bytes p..e */
+static gboolean decodeNumbers(const gchar* p, const gchar* e, gboolean real, gpointer values, gint iBegin, gint iEnd)
+{
+	gint i;
+	gdouble* reals = values;
+	gint* ints = values;
+	for(i=iBegin;i<iEnd;i++)
+	{
+		while(p<e && isspace((guchar)*p)) p++;
+		if(p>=e) break;
+		if(real) reals[i] = fast_strtod_range(&p, e);
+		else ints[i] = fastStrtoi(&p, e);
+	}
+	return i==iEnd;
+}
+/****************************************************************************/
+static gpointer decodeNumericalBlock(FChkFile* fchk, FChkBlock* block)
+{
+	gboolean real = block->type=='R';
+	gint n = block->nElements;
+	gpointer values;
+	gint nChunks = 1;
+	gsize* bounds;
+	gint* offsets;
+	gint k;
+	gboolean ok = TRUE;
+
+	if(n<1) return NULL;
+	values = g_malloc(n*(real?sizeof(gdouble):sizeof(gint)));
+#ifdef ENABLE_OMP
+	if(!omp_in_parallel() && omp_get_max_threads()>1 && block->end-block->begin>2*FCHKCHUNKSIZE)
+		nChunks = MIN(4*omp_get_max_threads(), (gint)((block->end-block->begin)/FCHKCHUNKSIZE));
+#endif
+	if(nChunks<2)
+	{
+		if(decodeNumbers(fchk->data+block->begin, fchk->data+block->end, real, values, 0, n)) return values;
+		g_free(values);
+		return NULL;
+	}
+	/* chunks begin at a new line, the number of elements of each chunk gives its first index */
+	bounds = g_malloc((nChunks+1)*sizeof(gsize));
+	offsets = g_malloc((nChunks+1)*sizeof(gint));
+	bounds[0] = block->begin;
+	bounds[nChunks] = block->end;
+	for(k=1;k<nChunks;k++)
+	{
+		bounds[k] = nextLine(fchk->data, block->begin+(block->end-block->begin)/nChunks*k, block->end);
+		if(bounds[k]<bounds[k-1]) bounds[k] = bounds[k-1];
+	}
+#ifdef ENABLE_OMP
+#pragma omp parallel for schedule(static)
+#endif
+	for(k=0;k<nChunks;k++) offsets[k+1] = count_tokens_range(fchk->data+bounds[k], fchk->data+bounds[k+1]);
+	offsets[0] = 0;
+	for(k=0;k<nChunks;k++) offsets[k+1] += offsets[k];
+	if(offsets[nChunks]<n) ok = FALSE;
+	if(ok)
+	{
+#ifdef ENABLE_OMP
+#pragma omp parallel for schedule(dynamic) reduction(&&:ok)
+#endif
+		for(k=0;k<nChunks;k++)
+		if(offsets[k]<n)
+			ok = decodeNumbers(fchk->data+bounds[k], fchk->data+bounds[k+1], real, values, offsets[k], MIN(n,offsets[k+1])) && ok;
+	}
+	g_free(bounds);
+	g_free(offsets);
+	if(ok) return values;
+	g_free(values);
+	return NULL;
+}
+/****************************************************************************/
+/* same tokens as fscanf("%12s") for C blocks and fscanf("%8s") for H blocks */
+static gpointer decodeStringBlock(FChkFile* fchk, FChkBlock* block)
+{
+	gint n = block->nElements;
+	gint width = (block->type=='C')?12:8;
+	const gchar* p = fchk->data+block->begin;
+	const gchar* e = fchk->data+block->end;
+	gchar** strs;
+	gint i;
+
+	if(n<1) return NULL;
+	strs = g_malloc(n*sizeof(gchar*));
+	for(i=0;i<n;i++) strs[i] = NULL;
+	for(i=0;i<n;i++)
+	{
+		const gchar* s;
+		while(p<e && isspace((guchar)*p)) p++;
+		if(p>=e) break;
+		for(s=p;p<e && p-s<width && !isspace((guchar)*p);p++);
+		strs[i] = g_strndup(s, p-s);
+	}
+	if(i==n) return strs;
+	for(i=0;i<n;i++) if(strs[i]) g_free(strs[i]);
+	g_free(strs);
+	return NULL;
+}
+/****************************************************************************/
+static gpointer decodeBlock(FChkFile* fchk, FChkBlock* block)
+{
+	if(block->nElements<1) return NULL;
+	if(block->type=='I' || block->type=='R') return decodeNumericalBlock(fchk, block);
+	if(block->type=='C' || block->type=='H') return decodeStringBlock(fchk, block);
+	return NULL;
+}
+/****************************************************************************/
+static gpointer takeBlockValues(FChkFile* fchk, const gchar* blockName, const gchar* types, gint* nElements)
+{
+	FChkBlock* block = findBlock(fchk, blockName);
+	gpointer values;
+	*nElements = 0;
+	if(!block || block->nElements<1 || !strchr(types, block->type)) return NULL;
+	values = block->values;
+	block->values = NULL;
+	if(!values) values = decodeBlock(fchk, block);
+	if(values) *nElements = block->nElements;
+	return values;
+}
+/****************************************************************************/
+gint* get_array_int_from_fchk(FChkFile* fchk, const gchar* blockName, gint* nElements)
+{
+	return takeBlockValues(fchk, blockName, "I", nElements);
+}
+/****************************************************************************/
+gdouble* get_array_real_from_fchk(FChkFile* fchk, const gchar* blockName, gint* nElements)
+{
+	return takeBlockValues(fchk, blockName, "R", nElements);
+}
+/****************************************************************************/
+gchar** get_array_string_from_fchk(FChkFile* fchk, const gchar* blockName, gint* nElements)
+{
+	return takeBlockValues(fchk, blockName, "CH", nElements);
+}
+/****************************************************************************/
+void load_arrays_from_fchk(FChkFile* fchk, gint nBlocks, gchar** blockNames)
+{
+	FChkBlock** blocks;
+	gint nSmall = 0;
+	gint i;
+
+	if(!fchk || nBlocks<1 || !blockNames) return;
+	blocks = g_malloc(nBlocks*sizeof(FChkBlock*));
+	/* the large blocks are decoded one after the other, each one by chunks in parallel */
+	for(i=0;i<nBlocks;i++)
+	{
+		FChkBlock* block = findBlock(fchk, blockNames[i]);
+		gint j;
+		if(!block || block->values || block->nElements<1) continue;
+		for(j=0;j<nSmall;j++) if(blocks[j]==block) break;
+		if(j<nSmall) continue;
+		if(block->end-block->begin>2*FCHKCHUNKSIZE) block->values = decodeBlock(fchk, block);
+		else blocks[nSmall++] = block;
+	}
+	/* the others blocks are decoded in parallel, one by thread */
+#ifdef ENABLE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for(i=0;i<nSmall;i++) 
+		if(!blocks[i]->values) blocks[i]->values = decodeBlock(fchk, blocks[i]);
+	g_free(blocks);
+}
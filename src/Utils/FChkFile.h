@@ -0,0 +1,59 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#ifndef __GABEDIT_FCHKFILE_H__
+#define __GABEDIT_FCHKFILE_H__
+
+typedef struct _FChkBlock  FChkBlock;
+typedef struct _FChkFile  FChkFile;
+
+struct _FChkBlock
+{
+	gchar* name;
+	gchar* header;
+	gchar type;
+	gint nElements; /* -1 for a scalar */
+	gsize begin;
+	gsize end;
+	gpointer values; /* decoded by load_arrays_from_fchk, taken by get_array_*_from_fchk */
+};
+struct _FChkFile
+{
+	GMappedFile* map;
+	const gchar* data;
+	gsize length;
+	gint nBlocks;
+	FChkBlock* blocks;
+	GHashTable* index;
+};
+
+/* map the file and index all its blocks in one pass, NULL if the file can not be read */
+FChkFile* new_fchk_gaussian_file(const gchar* fileName);
+void free_fchk_gaussian_file(FChkFile* fchk);
+gboolean has_block_in_fchk(FChkFile* fchk, const gchar* blockName);
+gint get_one_int_from_fchk(FChkFile* fchk, const gchar* blockName);
+gdouble get_one_real_from_fchk(FChkFile* fchk, const gchar* blockName);
+/* arrays are allocated by g_malloc, the caller must free them */
+gint* get_array_int_from_fchk(FChkFile* fchk, const gchar* blockName, gint* nElements);
+gdouble* get_array_real_from_fchk(FChkFile* fchk, const gchar* blockName, gint* nElements);
+gchar** get_array_string_from_fchk(FChkFile* fchk, const gchar* blockName, gint* nElements);
+/* decode several arrays in parallel, the next get_array_*_from_fchk calls return them without parsing */
+void load_arrays_from_fchk(FChkFile* fchk, gint nBlocks, gchar** blockNames);
+
+#endif /* __GABEDIT_FCHKFILE_H__ */
+
@@ -17,140 +17,52 @@ CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFT
 DEALINGS IN THE SOFTWARE.
 ************************************************************************************************************/
 
-
 #include "../../Config.h"
 #include "../Common/Global.h"
 #include <math.h>
-#define ROTATE(a,i,j,k,l) g=a[i][j];h=a[k][l];a[i][j]=g-s*(h+g*tau);\
-	a[k][l]=h+s*(g-h*tau);
-#define EPS 1e-10
+#include <stdlib.h>
+#include "../Utils/EigenSolver.h"
 
+/* M : sup symmetric matrix. The eigenvalues are sorted in ascending order.
+ * The Jacobi rotations are replaced by eigenSymmetric (EigenSolver.c), nrot is set to 0. 
+ * return 0 on success (as the old Jacobi) */
 gint jacobi(gdouble *M, gint n, gdouble d[], gdouble **v, gint *nrot)
 {
-	gint j,iq,ip,i;
-	gdouble tresh,theta,tau,t,sm,s,h,g,c,*b,*z;
-        gdouble **a;
-        gint k,ki,imin;
-
-	a=g_malloc(n*sizeof(gdouble*));
-        for(i=0;i<n;i++)
-           a[i]=g_malloc(n*sizeof(gdouble));
-        iq = -1;
-        for(i=0;i<n;i++)
-         for(j=i;j<n;j++)
-         {
-          iq++;
-          a[i][j] = M[iq];
-         }
-        for(i=0;i<n;i++)
-         for(j=0;j<i;j++)
-          a[i][j] = a[j][i];
+	gdouble* A = NULL;
+	gint i,j,iq;
+	gint success = 0;
 
-	b=g_malloc(n*sizeof(gdouble));
-	z=g_malloc(n*sizeof(gdouble));
-	for (ip=0;ip<n;ip++) {
-		for (iq=0;iq<n;iq++) v[ip][iq]=0.0;
-		v[ip][ip]=1.0;
+	*nrot = 0;
+	if(n<1) return 1;
+	if(n==3)
+	{
+		gdouble A3[3][3];
+		gdouble V3[3][3];
+		iq = -1;
+		for(i=0;i<3;i++)
+		for(j=i;j<3;j++)
+		{
+			iq++;
+			A3[i][j] = A3[j][i] = M[iq];
+		}
+		success = eigenSymmetric3(A3, d, V3);
+		if(success) for(i=0;i<3;i++) for(j=0;j<3;j++) v[i][j] = V3[i][j];
+		return !success;
 	}
-	for (ip=0;ip<n;ip++) {
-		b[ip]=d[ip]=a[ip][ip];
-		z[ip]=0.0;
+	A = g_malloc(n*n*sizeof(gdouble));
+	iq = -1;
+	for(i=0;i<n;i++)
+	for(j=i;j<n;j++)
+	{
+		iq++;
+		A[i*n+j] = A[j*n+i] = M[iq];
 	}
-	*nrot=0;
-	for (i=0;i<50;i++) {
-		sm=0.0;
-		for (ip=0;ip<n-1;ip++) {
-			for (iq=ip+1;iq<n;iq++)
-				sm += fabs(a[ip][iq]);
-		}
-		if (fabs(sm)<=EPS) {
-			g_free(z);
-			g_free(b);
-		        for(i=0;i<n;i++)
-           			g_free(a[i]);
-			g_free(a);
-
-                        for(k=0;k<n-1;k++)
-                        {
-			  imin = k;
-                          for(ki=k+1;ki<n;ki++)
-				if(d[ki]<d[imin])
-				   imin = ki;
-                          if(imin != k)
-			  {
-			    sm = d[k];
-                            d[k] = d[imin];
-			    d[imin] = sm;
-
-                            for(ki=0;ki<n;ki++)
-                            {
-				sm = v[ki][k];
-				v[ki][k] = v[ki][imin];
-				v[ki][imin] = sm ;
-                            }
-
-			  }
-                        }
-
-			return 0;
-		}
-		if (i < 4)
-			tresh=0.2*sm/(n*n);
-		else
-			tresh=0.0;
-		for (ip=0;ip<n-1;ip++) {
-			for (iq=ip+1;iq<n;iq++) {
-				g=100.0*fabs(a[ip][iq]);
-				if (i > 4 && (gdouble)(fabs(d[ip])+g) == (gdouble)fabs(d[ip])
-					&& (gdouble)(fabs(d[iq])+g) == (gdouble)fabs(d[iq]))
-					a[ip][iq]=0.0;
-				else if (fabs(a[ip][iq]) > tresh) {
-					h=d[iq]-d[ip];
-					if ((gdouble)(fabs(h)+g) == (gdouble)fabs(h))
-						t=(a[ip][iq])/h;
-					else {
-						theta=0.5*h/(a[ip][iq]);
-						t=1.0/(fabs(theta)+sqrt(1.0+theta*theta));
-						if (theta < 0.0) t = -t;
-					}
-					c=1.0/sqrt(1+t*t);
-					s=t*c;
-					tau=s/(1.0+c);
-					h=t*a[ip][iq];
-					z[ip] -= h;
-					z[iq] += h;
-					d[ip] -= h;
-					d[iq] += h;
-					a[ip][iq]=0.0;
-					for (j=0;j<=ip-1;j++) {
-						ROTATE(a,j,ip,j,iq)
-					}
-					for (j=ip+1;j<=iq-1;j++) {
-						ROTATE(a,ip,j,j,iq)
-					}
-					for (j=iq+1;j<n;j++) {
-						ROTATE(a,ip,j,iq,j)
-					}
-					for (j=0;j<n;j++) {
-						ROTATE(v,j,ip,j,iq)
-					}
-					++(*nrot);
-				}
-			}
-		}
-		for (ip=0;ip<n;ip++) {
-			b[ip] += z[ip];
-			d[ip]=b[ip];
-			z[ip]=0.0;
-		}
+	{
+		gdouble* V = g_malloc(n*n*sizeof(gdouble));
+		success = eigenSymmetric(n, A, d, V);
+		if(success) for(i=0;i<n;i++) for(j=0;j<n;j++) v[i][j] = V[i*n+j];
+		g_free(V);
 	}
-	/*	Debug("Too many iterations in routine jacobi\n");*/
-        g_free(z);
-        g_free(b);
-        for(i=0;i<n;i++)
-        	g_free(a[i]);
-	g_free(a);
-        return 1;
+	g_free(A);
+	return !success;
 }
-#undef ROTATE
-#undef EPS
@@ -0,0 +1,286 @@
+/* LogIndex.c */
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+/* Index of the lines of a log file containing a set of patterns.
+ * The file is mapped in memory and all patterns are searched in one pass with an Aho-Corasick automaton,
+ * the file is scanned by chunks in parallel. The parsers then read the lines from the recorded offsets.
+ */
+#include "../../Config.h"
+#include "../Common/Global.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#ifdef ENABLE_OMP
+#include <omp.h>
+#endif
+#include "../Utils/LogIndex.h"
+
+/* size in bytes of the chunks scanned in parallel */
+#define LOGINDEXCHUNKSIZE (1<<24)
+
+typedef struct _LogAutomaton
+{
+	gint nStates;
+	gint* next; /* nStates*256 transitions */
+	guint64* out; /* patterns ending at each state */
+	guchar fold[256];
+	gboolean start[256]; /* bytes leaving the initial state, or new line */
+}LogAutomaton;
+
+typedef struct _LogHit
+{
+	gsize line;
+	guint64 mask;
+}LogHit;
+
+/****************************************************************************/
+static LogAutomaton* newLogAutomaton(const gchar** patterns, gint nPatterns, gboolean ignoreCase)
+{
+	LogAutomaton* automaton = g_malloc(sizeof(LogAutomaton));
+	gint nMax = 1;
+	gint* queue;
+	gint* fail;
+	gint head = 0, tail = 0;
+	gint i, c;
+
+	for(i=0;i<nPatterns;i++) nMax += strlen(patterns[i]);
+	for(c=0;c<256;c++) automaton->fold[c] = ignoreCase?tolower(c):c;
+	automaton->next = g_malloc(nMax*256*sizeof(gint));
+	automaton->out = g_malloc0(nMax*sizeof(guint64));
+	for(c=0;c<256;c++) automaton->next[c] = -1;
+	automaton->nStates = 1;
+
+	/* trie */
+	for(i=0;i<nPatterns;i++)
+	{
+		const guchar* p = (const guchar*)patterns[i];
+		gint state = 0;
+		for(;*p;p++)
+		{
+			gint* t = &automaton->next[state*256+automaton->fold[*p]];
+			if(*t<0)
+			{
+				*t = automaton->nStates++;
+				for(c=0;c<256;c++) automaton->next[*t*256+c] = -1;
+			}
+			state = *t;
+		}
+		automaton->out[state] |= ((guint64)1)<<i;
+	}
+	/* failure links, folded in the transitions so that the scan is a plain DFA */
+	queue = g_malloc(automaton->nStates*sizeof(gint));
+	fail = g_malloc0(automaton->nStates*sizeof(gint));
+	for(c=0;c<256;c++)
+	{
+		gint s = automaton->next[c];
+		if(s<0) automaton->next[c] = 0;
+		else queue[tail++] = s;
+	}
+	while(head<tail)
+	{
+		gint r = queue[head++];
+		for(c=0;c<256;c++)
+		{
+			gint s = automaton->next[r*256+c];
+			if(s<0) automaton->next[r*256+c] = automaton->next[fail[r]*256+c];
+			else
+			{
+				fail[s] = automaton->next[fail[r]*256+c];
+				automaton->out[s] |= automaton->out[fail[s]];
+				queue[tail++] = s;
+			}
+		}
+	}
+	g_free(fail);
+	for(c=0;c<256;c++) automaton->start[c] = (c=='\n' || automaton->next[automaton->fold[c]]!=0);
+	g_free(queue);
+	return automaton;
+}
+/****************************************************************************/
+static void freeLogAutomaton(LogAutomaton* automaton)
+{
+	if(!automaton) return;
+	g_free(automaton->next);
+	g_free(automaton->out);
+	g_free(automaton);
+}
+/****************************************************************************/
+static GArray* scanLogChunk(LogAutomaton* automaton, const gchar* data, gsize begin, gsize end)
+{
+	GArray* hits = g_array_new(FALSE, FALSE, sizeof(LogHit));
+	const gint* next = automaton->next;
+	const guint64* out = automaton->out;
+	const guchar* fold = automaton->fold;
+	const gboolean* start = automaton->start;
+	LogHit hit = {0, 0};
+	gsize lineStart = begin;
+	gint state = 0;
+	gsize i;
+
+	for(i=begin;i<end;i++)
+	{
+		guchar c;
+		/* most bytes do not begin a pattern, skip them without the automaton */
+		if(state==0) while(i<end && !start[(guchar)data[i]]) i++;
+		if(i>=end) break;
+		c = (guchar)data[i];
+		if(c=='\n')
+		{
+			state = 0;
+			lineStart = i+1;
+			continue;
+		}
+		state = next[state*256+fold[c]];
+		if(!out[state]) continue;
+		if(hit.mask && hit.line==lineStart) hit.mask |= out[state];
+		else
+		{
+			if(hit.mask) g_array_append_val(hits, hit);
+			hit.line = lineStart;
+			hit.mask = out[state];
+		}
+	}
+	if(hit.mask) g_array_append_val(hits, hit);
+	return hits;
+}
+/****************************************************************************/
+static gsize nextLineBegin(const gchar* data, gsize pos, gsize length)
+{
+	const gchar* p;
+	if(pos>=length) return length;
+	p = memchr(data+pos, '\n', length-pos);
+	return p?(gsize)(p-data)+1:length;
+}
+/****************************************************************************/
+static void indexLogFile(LogIndex* index, const gchar** patterns, gboolean ignoreCase)
+{
+	LogAutomaton* automaton = newLogAutomaton(patterns, index->nPatterns, ignoreCase);
+	gint nChunks = index->length/LOGINDEXCHUNKSIZE+1;
+	gsize* begins = g_malloc((nChunks+1)*sizeof(gsize));
+	GArray** hits = g_malloc(nChunks*sizeof(GArray*));
+	gint i, j, k;
+
+	/* the chunks begin at the beginning of a line, the patterns never contain a new line */
+	begins[0] = 0;
+	for(i=1;i<nChunks;i++) begins[i] = nextLineBegin(index->data, MAX(begins[i-1],(gsize)i*LOGINDEXCHUNKSIZE), index->length);
+	begins[nChunks] = index->length;
+#ifdef ENABLE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for(i=0;i<nChunks;i++) hits[i] = scanLogChunk(automaton, index->data, begins[i], begins[i+1]);
+
+	index->nLines = 0;
+	for(i=0;i<nChunks;i++) index->nLines += hits[i]->len;
+	index->lines = g_malloc(MAX(1,index->nLines)*sizeof(gsize));
+	index->masks = g_malloc(MAX(1,index->nLines)*sizeof(guint64));
+	index->nPatternLines = g_malloc0(index->nPatterns*sizeof(gint));
+	for(i=0,k=0;i<nChunks;i++)
+	{
+		for(j=0;j<hits[i]->len;j++,k++)
+		{
+			LogHit* hit = &g_array_index(hits[i], LogHit, j);
+			index->lines[k] = hit->line;
+			index->masks[k] = hit->mask;
+		}
+		g_array_free(hits[i], TRUE);
+	}
+	index->patternLines = g_malloc(index->nPatterns*sizeof(gsize*));
+	for(j=0;j<index->nPatterns;j++)
+	{
+		for(k=0;k<index->nLines;k++) if(index->masks[k]&(((guint64)1)<<j)) index->nPatternLines[j]++;
+		index->patternLines[j] = g_malloc(MAX(1,index->nPatternLines[j])*sizeof(gsize));
+		for(k=0,i=0;k<index->nLines;k++) if(index->masks[k]&(((guint64)1)<<j)) index->patternLines[j][i++] = index->lines[k];
+	}
+	g_free(hits);
+	g_free(begins);
+	freeLogAutomaton(automaton);
+}
+/****************************************************************************/
+LogIndex* new_log_index(const gchar* fileName, const gchar** patterns, gboolean ignoreCase)
+{
+	GMappedFile* map;
+	LogIndex* index;
+	gint n = 0;
+	if(!fileName || !patterns) return NULL;
+	while(patterns[n]) n++;
+	if(n<1 || n>LOGINDEXMAXPATTERNS) return NULL;
+	map = g_mapped_file_new(fileName, FALSE, NULL);
+	if(!map) return NULL;
+	index = g_malloc(sizeof(LogIndex));
+	index->map = map;
+	index->data = g_mapped_file_get_contents(map);
+	index->length = g_mapped_file_get_length(map);
+	if(!index->data) index->length = 0;
+	index->nPatterns = n;
+	indexLogFile(index, patterns, ignoreCase);
+	return index;
+}
+/****************************************************************************/
+void free_log_index(LogIndex* index)
+{
+	gint i;
+	if(!index) return;
+	for(i=0;i<index->nPatterns;i++) g_free(index->patternLines[i]);
+	g_free(index->patternLines);
+	g_free(index->nPatternLines);
+	g_free(index->lines);
+	g_free(index->masks);
+	if(index->map) g_mapped_file_unref(index->map);
+	g_free(index);
+}
+/****************************************************************************/
+gboolean get_line_from_log_index(LogIndex* index, gsize* pos, gchar* t, gint size)
+{
+	gsize next;
+	gsize n;
+	t[0] = '\0';
+	if(!index || *pos>=index->length) return FALSE;
+	next = nextLineBegin(index->data, *pos, index->length);
+	n = next-*pos;
+	/* a line longer than the buffer is truncated, its end is skipped */
+	if(n>(gsize)size-1) n = size-1;
+	memcpy(t, index->data+*pos, n);
+	t[n] = '\0';
+	*pos = next;
+	return TRUE;
+}
+/****************************************************************************/
+gboolean log_index_line_has_pattern(LogIndex* index, gint iLine, gint iPattern)
+{
+	if(!index || iLine<0 || iLine>=index->nLines || iPattern<0 || iPattern>=index->nPatterns) return FALSE;
+	return (index->masks[iLine]&(((guint64)1)<<iPattern)) != 0;
+}
+/****************************************************************************/
+gboolean find_pattern_in_log_index(LogIndex* index, gint iPattern, gsize* pos)
+{
+	gsize* lines;
+	gint i = 0, j;
+	if(!index || iPattern<0 || iPattern>=index->nPatterns) return FALSE;
+	lines = index->patternLines[iPattern];
+	j = index->nPatternLines[iPattern];
+	/* first line at or after *pos */
+	while(i<j)
+	{
+		gint m = (i+j)/2;
+		if(lines[m]<*pos) i = m+1;
+		else j = m;
+	}
+	if(i>=index->nPatternLines[iPattern]) return FALSE;
+	*pos = lines[i];
+	return TRUE;
+}
@@ -0,0 +1,49 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#ifndef __GABEDIT_LOGINDEX_H__
+#define __GABEDIT_LOGINDEX_H__
+
+#define LOGINDEXMAXPATTERNS 64
+
+typedef struct _LogIndex  LogIndex;
+
+struct _LogIndex
+{
+	GMappedFile* map;
+	const gchar* data;
+	gsize length;
+	gint nPatterns;
+	gint nLines;
+	gsize* lines; /* offsets of the lines containing at least one pattern, in file order */
+	guint64* masks; /* bit i set if the line contains the pattern i */
+	gint* nPatternLines;
+	gsize** patternLines; /* offsets of the lines containing the pattern i */
+};
+
+/* map the file and find all lines containing one of the patterns (NULL terminated list) in one pass, NULL if the file can not be read */
+LogIndex* new_log_index(const gchar* fileName, const gchar** patterns, gboolean ignoreCase);
+void free_log_index(LogIndex* index);
+/* copy the line beginning at *pos in t as fgets does, *pos is moved to the next line, FALSE at the end of the file */
+gboolean get_line_from_log_index(LogIndex* index, gsize* pos, gchar* t, gint size);
+gboolean log_index_line_has_pattern(LogIndex* index, gint iLine, gint iPattern);
+/* move *pos to the first line at or after *pos containing the pattern iPattern, FALSE if there is none */
+gboolean find_pattern_in_log_index(LogIndex* index, gint iPattern, gsize* pos);
+
+#endif /* __GABEDIT_LOGINDEX_H__ */
+
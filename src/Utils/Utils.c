@@ -245,6 +245,19 @@ gdouble get_multipole_rank()
   return multipole_rank;
 }
 /********************************************************************************/
+/* opening angle of the treecode used for the MEP of point charges, 0 : direct sum */
+gdouble get_treecode_theta()
+{
+  return treecode_theta;
+}
+/********************************************************************************/
+void set_treecode_theta(gdouble theta)
+{
+	treecode_theta = theta;
+	if(treecode_theta<0) treecode_theta = 0;
+	if(treecode_theta>1) treecode_theta = 1;
+}
+/********************************************************************************/
 gboolean this_is_a_backspace(gchar *st)
 {
         gint i;
@@ -1458,6 +1471,7 @@ void create_opengl_file()
 		fprintf(fd,"%lf %lf %lf\n",colorMapColors[2][0], colorMapColors[2][1],colorMapColors[2][2]);
 		fprintf(fd,"%d\n",getShowOneSurface());
 		fprintf(fd,"%lf\n",get_alpha_opacity());
+		fprintf(fd,"%lf\n",get_treecode_theta());
 		fclose(fd);
 	}
 	g_free(openglfile);
@@ -1564,6 +1578,11 @@ void read_opengl_file()
 			gdouble alpha;
 			if(sscanf(t,"%lf",&alpha)==1) set_alpha_opacity(alpha);
 		}
+ 		if(fgets(t,taille,fd))
+		{
+			gdouble theta;
+			if(sscanf(t,"%lf",&theta)==1) set_treecode_theta(theta);
+		}
 
 		fclose(fd);
 	}
@@ -2416,8 +2435,9 @@ void initialise_global_variables()
   iprogram = PROG_IS_OTHER;
   Units = 1;
   NSA[0] = NSA[1] = NSA[2] = NSA[3] = -1;
-  ScreenWidth = gdk_screen_width();
-  ScreenHeight = gdk_screen_height();
+  /* no screen in the batch (headless) mode */
+  ScreenWidth = gdk_screen_get_default()?gdk_screen_width():1024;
+  ScreenHeight = gdk_screen_get_default()?gdk_screen_height():768;
   GeomConvIsOpen = FALSE;
   recenthosts.nhosts = 0;
   recenthosts.hosts = NULL;
@@ -2619,6 +2639,7 @@ void initialise_global_variables()
   initAxesGeom();
 #endif
   multipole_rank = 3;
+  treecode_theta = 0.5;
   alpha_opacity = 0.5;
 }
 /*************************************************************************************/
@@ -5892,3 +5913,68 @@ gchar *readFile(gchar *filename)
     }
     return fcontent;
 }
+/****************************************************************************/
+static gdouble powersOf10[] = {1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22};
+/****************************************************************************/
+static gdouble slow_strtod_range(const gchar** pp, const gchar* e)
+{
+	gchar t[64];
+	gint n = 0;
+	const gchar* p = *pp;
+	while(p<e && !isspace((guchar)*p))
+	{
+		if(n<63) t[n++] = (*p=='D' || *p=='d')?'E':*p;
+		p++;
+	}
+	t[n] = '\0';
+	*pp = p;
+	return g_ascii_strtod(t, NULL);
+}
+/****************************************************************************/
+/* exact for the fixed formats of fchk and cube files : the mantissa is an integer < 2^53 and the power of 10 is exactly representable */
+gdouble fast_strtod_range(const gchar** pp, const gchar* e)
+{
+	const gchar* p = *pp;
+	gboolean negative = FALSE;
+	gboolean negativeExp = FALSE;
+	guint64 m = 0;
+	gint nDigits = 0;
+	gint nMantissa = 0;
+	gint e10 = 0;
+	gint ex = 0;
+	gdouble v;
+
+	if(p<e && (*p=='-' || *p=='+')) negative = (*p++=='-');
+	for(;p<e && *p>='0' && *p<='9';p++, nMantissa++)
+		if(m || *p!='0') { m = m*10+(*p-'0'); nDigits++; }
+	if(p<e && *p=='.')
+	for(p++;p<e && *p>='0' && *p<='9';p++, nMantissa++)
+	{
+		if(m || *p!='0') { m = m*10+(*p-'0'); nDigits++; }
+		e10--;
+	}
+	if(nMantissa==0 || nDigits>15) return slow_strtod_range(pp, e);
+	if(p<e && (*p=='E' || *p=='e' || *p=='D' || *p=='d')) p++;
+	if(p<e && (*p=='-' || *p=='+')) negativeExp = (*p++=='-');
+	for(;p<e && *p>='0' && *p<='9' && ex<10000;p++) ex = ex*10+(*p-'0');
+	if(p<e && !isspace((guchar)*p)) return slow_strtod_range(pp, e);
+	e10 += negativeExp?-ex:ex;
+	if(e10<-22 || e10>22) return slow_strtod_range(pp, e);
+	*pp = p;
+	v = (gdouble)m;
+	if(e10<0) v /= powersOf10[-e10];
+	else v *= powersOf10[e10];
+	return negative?-v:v;
+}
+/****************************************************************************/
+gint count_tokens_range(const gchar* p, const gchar* e)
+{
+	gint n = 0;
+	gboolean inToken = FALSE;
+	for(;p<e;p++)
+	{
+		if(isspace((guchar)*p)) inToken = FALSE;
+		else if(!inToken) { inToken = TRUE; n++; }
+	}
+	return n;
+}
@@ -169,6 +169,8 @@ void getvScaleBond(gdouble r, gdouble Center1[], gdouble Center2[], gdouble vSca
 void getPositionsRadiusBond3(gdouble r, gdouble Orig[], gdouble Center1[], gdouble Center2[], gdouble C11[], gdouble C12[],  gdouble C21[],  gdouble C22[], gdouble C31[],  gdouble C32[], gdouble radius[], gint type);
 void getPositionsRadiusBond2(gdouble r, gdouble Orig[], gdouble Center1[], gdouble Center2[], gdouble C11[], gdouble C12[],  gdouble C21[],  gdouble C22[], gdouble radius[], gint type);
 gdouble get_multipole_rank();
+gdouble get_treecode_theta();
+void set_treecode_theta(gdouble theta);
 void getCoefsGradient(gint nBoundary, gdouble xh, gdouble yh, gdouble zh, gdouble* fcx, gdouble* fcy, gdouble* fcz);
 void getCoefsLaplacian(gint nBoundary, gdouble xh, gdouble yh, gdouble zh, gdouble* fcx, gdouble* fcy, gdouble* fcz, gdouble* cc);
 void swapDouble(gdouble* a, gdouble* b);
@@ -227,6 +229,9 @@ gdouble* get_one_block_real_from_wfx_file(FILE* file, gchar* blockName,  gint* n
 gboolean get_one_int_from_wfx_file(FILE* file, gchar* blockName, gint* n);
 gdouble* get_one_orbital_from_wfx_file(FILE* file, gint* n, gint*numOrb);
 gchar *readFile(gchar *filename);
+/* parse the number at *pp (no leading spaces) and move *pp after it, the text ends at end (not null terminated) */
+gdouble fast_strtod_range(const gchar** pp, const gchar* end);
+gint count_tokens_range(const gchar* p, const gchar* end);
 
 #endif /* __GABEDIT_UTILS_H__ */
 
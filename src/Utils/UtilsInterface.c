@@ -604,6 +604,12 @@ GtkWidget* Message(char *message,char *titre,gboolean center)
     GtkWidget *Label, *Bouton;
     GtkWidget *frame, *vboxframe;
 
+    /* batch mode, no display */
+    if(!gdk_display_get_default())
+    {
+	g_printerr("%s : %s\n",titre,message);
+	return NULL;
+    }
 
     DialogueMessage = gtk_dialog_new();
     gtk_widget_realize(GTK_WIDGET(DialogueMessage));
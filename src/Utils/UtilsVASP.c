@@ -33,307 +33,9 @@ DEALINGS IN THE SOFTWARE.
 #include "../Common/Windows.h"
 #include "../Utils/GabeditXYPlot.h"
 #include "../Display/Vibration.h"
+#include "../Utils/VASPXmlFile.h"
 
-typedef struct _AtomType
-{ 
-	gint nAtoms; 
-	char symbol[10]; 
-}AtomType;
-
-static gint read_dos_all_vasp_xml_file(FILE* fd, GList** pX, GList** pI);
-static gdouble read_efermi(FILE* fd);
-static GtkWidget* dos_vasp_win_new(gchar* title, GList* X, GList* listOfAtomTypes, GList* listOfOrbTypes, gchar* fileName);
-/********************************************************************************/
-static void g_list_free_all (GList * list, GDestroyNotify free_func)
-{
-    g_list_foreach (list, (GFunc) free_func, NULL);
-    g_list_free (list);
-} 
-/********************************************************************************/
-static GList* read_orb_types_vasp_xml_file(FILE* fd)
-{
- 	gchar t[BSIZE];
- 	gchar tmp1[BSIZE];
-	gint i;
-	GList* listOfOrbTypes = NULL;
-	gchar** allstrs = NULL;
-        if(!goToStr(fd,"partial")) return listOfOrbTypes;
-  	while(!feof(fd))
-  	{
-    		if(!fgets(t,BSIZE,fd)) break;
-		if(strstr(t,"field")) break;// energy
-	}
-	if(!strstr(t,"field")) return listOfOrbTypes;
-
-  	while(!feof(fd))
-  	{
-    		if(!fgets(t,BSIZE,fd)) break;
-				//printf("t=%s\n",t);
-		if(!strstr(t,"field")) break;
-		for(i=0;i<strlen(t);i++)
-		{
-			if(t[i]=='<') t[i]=' ';
-			if(t[i]=='>') t[i]=' ';
-			if(t[i]=='/') t[i]=' ';
-		}
-		allstrs =gab_split (t);
-                if(allstrs && allstrs[1])
-                {
-			gchar* data = g_strdup(allstrs[1]);
-				//printf("data=%s\n",data);
-			listOfOrbTypes = g_list_append(listOfOrbTypes, (gpointer) data);
-		}
-                g_strfreev(allstrs);
-                allstrs = NULL;
-	}
-	return listOfOrbTypes;
-}
-/****************************************************************************************/
-static GList* read_atom_types_vasp_xml_file(FILE* fd)
-{
- 	gchar t[BSIZE];
-	gint i,j;
-	AtomType a;
-	GList * listOfAtomTypes = NULL;
-        if(!goToStr(fd,"atomtypes"))
-        {
-                fprintf(stderr,"I cannot atom types from the VASP xml file\nCheck your file\n");
-                return listOfAtomTypes;
-        }
-
-  	while(!feof(fd))
-  	{
-    		if(!fgets(t,BSIZE,fd)) break;
-		if(strstr(t,"</set>")) { break; }
-		//printf("t=%s\n",t);
-		if(strstr(t,"<rc>"))
-		{
-			for(i=0;i<strlen(t);i++)
-			{
-				if(t[i]=='<')
-				for(j=i;j<strlen(t);j++) if(t[j]=='>') {t[j]=' '; break;} else t[j]=' ';
-			}
-			if(2==sscanf(t,"%d %s", &a.nAtoms , a.symbol))
-			{
-				//printf("nAtoms = %d symbo l= %s\n",a.nAtoms, a.symbol);
-				AtomType* data;
-				data = g_malloc(sizeof(AtomType));
-				*data = a;
-				listOfAtomTypes=g_list_append(listOfAtomTypes, (gpointer) data);
-			}
-			else
-			{
-				break;
-			}
-		}
-	}
-	//printf("n=%d\n",n);
-	return listOfAtomTypes;
-}
-/****************************************************************************************/
-static gint read_pdos_one_center_vasp_xml_file(FILE* fd, GList** pList, gint ion, gint spin, gint typesOrbs[], gint nTypesOrbs)
-{
- 	gchar t[BSIZE];
- 	gchar tag1[BSIZE];
- 	gchar tag2[BSIZE];
-	gchar** allreals = NULL;
-        GList* list = NULL;
-	gint n = 0;
-	gint i;
-	gint k;
-	if(!*pList) return -1;
-        list = g_list_first(*pList);
-	
-	sprintf(tag1,"ion %d",ion);
-	sprintf(tag2,"spin %d",spin);
-  	while(!feof(fd))
-  	{
-        	if(goToStr(fd,tag1))
-		{
-    			if(!fgets(t,BSIZE,fd)) return -1;
-			if(strstr(t,tag2))  break;
-		}
-		if(strstr(t,"</partial>")) return -1;
-	}
-  	while(!feof(fd))
-  	{
-    		if(!fgets(t,BSIZE,fd)) break;
-		if(strstr(t,"</set>")) { break; }
-		//printf("t=%s\n",t);
-		if(strstr(t,"<r>"))
-		{
-			for(i=0;i<strlen(t);i++)
-			{
-				if(t[i]=='<') t[i] = ' ';
-				if(t[i]=='>') t[i] = ' ';
-				if(t[i]=='/') t[i] = ' ';
-				if(t[i]=='r') t[i] = ' ';
-			}
- 			allreals =gab_split (t);
-			k = 0;
-			while(allreals && allreals[k] && k<nTypesOrbs)
-			{
-				if(k>0 && typesOrbs[k-1]) 
-				{
-					*(gdouble*)list->data += atof(allreals[k]);
-				}
-				k++;
-			}
-			n++;
-			g_strfreev(allreals);
-			allreals = NULL;
-			list = list->next;
-			if(!list) break;
-		}
-	}
-	return n;
-}
-/********************************************************************************/
-static gint progress(GtkWidget* progressBar, gdouble scal, gboolean reset)
-{
-
-	gdouble new_val;
-	if(reset)
-	{
-		gtk_widget_show(progressBar);
-		new_val = 0;
-    		gtk_progress_bar_set_fraction (GTK_PROGRESS_BAR (progressBar), new_val);
-		while( gtk_events_pending() ) gtk_main_iteration();
-		return TRUE;
-	}
-	else
-	if(scal>0)
-	{
-    		new_val = gtk_progress_bar_get_fraction( GTK_PROGRESS_BAR(progressBar) ) + scal;
-		if (new_val > 1) new_val = 1;
-	}
-	else
-	{
-    		new_val = gtk_progress_bar_get_fraction( GTK_PROGRESS_BAR(progressBar) ) - scal;
-		if (new_val > 1) new_val = 1;
-		if (new_val <0 ) new_val = 0;
-	}
-
-	while( gtk_events_pending() ) gtk_main_iteration();
-    	gtk_progress_bar_set_fraction (GTK_PROGRESS_BAR (progressBar), new_val);
-    	while( gtk_events_pending() ) gtk_main_iteration();
-    	return TRUE;
-}
-/********************************************************************************/
-static GList* read_pdos_vasp_xml_file(GtkWidget* window, gchar* fileName, G_CONST_RETURN gchar* symbol, gint spin, gint typesOrbs[], gint nTypesOrbs)
-{
-	GList* X = NULL;
-	GList* cAtom;
-	GList* cI;
-	GList* I = NULL;
-	/* gdouble efermi;*/
-	AtomType* data = NULL;
-	GList* listOfAtomTypes = NULL;
-	gint iBegin = 0;
-	gint iEnd = 0;
-	gint nAtoms = 0;
-	GtkWidget* cancelButton = g_object_get_data (G_OBJECT (window), "CancelButton");
-	GtkWidget*  progressBar = g_object_get_data (G_OBJECT (window), "ProgressBar");
-	gint i;
- 	FILE* fd = FOpen(fileName, "rb");
-	read_dos_all_vasp_xml_file(fd, &X, &I);
-	/* efermi = read_efermi(fd);*/
-
-	rewind(fd);
-	listOfAtomTypes = read_atom_types_vasp_xml_file(fd);
-
-        for(cAtom = g_list_first(listOfAtomTypes); cAtom != NULL; cAtom = cAtom->next) 
-	{
-		data = (AtomType*)cAtom->data;
-		 nAtoms += data->nAtoms;
-	}
-
-	cAtom = g_list_first(listOfAtomTypes);
-        for(; cAtom != NULL; cAtom = cAtom->next) 
-	{
-			
-		data = (AtomType*)cAtom->data;
-		if(!strcmp(data->symbol,symbol))break;
-		iBegin += data->nAtoms;
-	}
-	if(cAtom) iEnd = iBegin+data->nAtoms-1;
-	else
-	{
-		// symbol contain iBegin and iEnd
-		gint i,j;
-		gchar* s = strdup(symbol);
-		//printf("symbol %s\n",symbol);
-		for(i=0;i<strlen(s);i++) if(s[i]=='-') s[i] = ' ';
-		//printf("s %s\n",s);
-		if(sscanf(s,"%d %d", &i, &j)==2) 
-		{
-			iBegin = i-1;
-			iEnd = j-1;
-			if(iEnd<iBegin) { iBegin=j-1; iEnd=i-1;}
-		}
-		else if(sscanf(s,"%d", &i)==1) 
-		{
-			iBegin = iEnd = i-1;
-		}
-		g_free(s);
-	}
-	//printf("iBegin=%d iEnd= %d nAtoms = %d\n",iBegin+1,iEnd+1,nAtoms);
-	if(iBegin<0 || iEnd<0 || iBegin>nAtoms-1 || iEnd > nAtoms-1 || !goToStr(fd,"<partial>"))
-	{
-		g_list_free_all(X, g_free);
-		g_list_free_all(I, g_free);
-		g_list_free_all(listOfAtomTypes, g_free);
-		return NULL;
-	}
-
-	cI = g_list_first(I);
-        for(; cI != NULL; cI = cI->next)  *(gdouble*)cI->data = 0;
-
-	progress(progressBar, 0 , TRUE);
-	if(spin>=1 && spin<=2) 
-	{
-		gdouble scal = 1.0/(iEnd-iBegin+1);
-		for(i=iBegin;i<=iEnd;i++)
-		{
-			progress(progressBar, scal , FALSE);
-			while( gtk_events_pending() ) gtk_main_iteration();
-			if(!gtk_widget_is_sensitive(cancelButton)) break;
-		 	read_pdos_one_center_vasp_xml_file(fd, &I, i+1, spin, typesOrbs, nTypesOrbs);
-		}
-	}
-	else
-	{
-		spin = 1;
-		gdouble scal = 1.0/(iEnd-iBegin+1);
-		for(i=iBegin;i<=iEnd;i++)
-		{
-			progress(progressBar, scal , FALSE);
-			while( gtk_events_pending() ) gtk_main_iteration();
-			if(!gtk_widget_is_sensitive(cancelButton)) break;
-		 	read_pdos_one_center_vasp_xml_file(fd, &I, i+1, spin, typesOrbs, nTypesOrbs);
-		}
-		if(goToStr(fd,"spin 2"))
-		{
-			rewind(fd);
-			goToStr(fd,"<partial>");
-			spin = 2;
-			progress(progressBar, 0 , TRUE);
-			gdouble scal = 1.0/(iEnd-iBegin+1);
-			for(i=iBegin;i<=iEnd;i++)
-			{
-				progress(progressBar, scal , FALSE);
-				while( gtk_events_pending() ) gtk_main_iteration();
-				if(!gtk_widget_is_sensitive(cancelButton)) break;
-		 		read_pdos_one_center_vasp_xml_file(fd, &I, i+1, spin, typesOrbs, nTypesOrbs);
-			}
-		}
-	}
-	g_list_free_all(X, g_free);
-	fclose(fd);
-	progress(progressBar, 0 , TRUE);
-	return I;
-}
-
+static GtkWidget* dos_vasp_win_new(gchar* title, gdouble* X, VASPXmlFile* vasp);
 /********************************************************************************/
 static GdkColor get_fore_color(GabeditXYPlot *xyplot)
 {
@@ -348,20 +50,10 @@ static GdkColor get_fore_color(GabeditXYPlot *xyplot)
         return color;
 }
 /********************************************************************************/
-static void add_new_data_bands(GabeditXYPlot* xyplot, GList* X, GList** lists, gint iEnergy, gchar* color)
+static void add_new_data_bands(GabeditXYPlot* xyplot, gint numberOfPoints, gdouble* X, gdouble* bands, gint nBands, gint iEnergy, gchar* color)
 {
-	gint numberOfPoints = 0;
-	if(X)
-	{
-		GList* current = NULL;
-		current = g_list_first(X);
-		for(; current != NULL; current = current->next) numberOfPoints++;
-	}
-	//printf("number of X points = %d\n",numberOfPoints);
-		
 	if(numberOfPoints>0)
 	{
-		GList* cx = g_list_first(X);
 		gint loop;
 		XYPlotData *data = g_malloc(sizeof(XYPlotData));
 		GdkColor c = get_fore_color(GABEDIT_XYPLOT(xyplot));
@@ -379,19 +71,10 @@ static void add_new_data_bands(GabeditXYPlot* xyplot, GList* X, GList** lists, g
 		data->x = g_malloc(numberOfPoints*sizeof(gdouble)); 
 		data->y = g_malloc(numberOfPoints*sizeof(gdouble)); 
 
-		loop = 0;
-		for(; cx != NULL; cx = cx->next) 
+		for(loop=0;loop<numberOfPoints;loop++)
 		{
-			GList* cy = g_list_first(lists[loop]);
-			gint j;
-			for(j=0; j<iEnergy && cy;j++) cy = cy->next ;
-
-			if(cy)
-			{
-				data->x[loop] = *(gdouble*)(cx->data);
-				data->y[loop] = *(gdouble*)(cy->data);
-			}
-			loop++;
+			data->x[loop] = X[loop];
+			data->y[loop] = bands[loop*nBands+iEnergy];
 		}
 
 		sprintf(data->point_str,"+");
@@ -422,21 +105,10 @@ static void add_new_data_bands(GabeditXYPlot* xyplot, GList* X, GList** lists, g
 	}
 }
 /********************************************************************************/
-static void add_new_data_dos(GabeditXYPlot* xyplot, GList* X, GList* I, gchar* color)
+static void add_new_data_dos(GabeditXYPlot* xyplot, gint numberOfPoints, gdouble* X, gdouble* I, gchar* color)
 {
-	gint numberOfPoints = 0;
-	if(X)
-	{
-		GList* current = NULL;
-		current = g_list_first(X);
-		for(; current != NULL; current = current->next) numberOfPoints++;
-	}
-	//printf("number of X points = %d\n",numberOfPoints);
-		
 	if(numberOfPoints>0)
 	{
-		GList* cx = g_list_first(X);
-		GList* cy = g_list_first(I);
 		gint loop;
 		XYPlotData *data = g_malloc(sizeof(XYPlotData));
 		GdkColor c = get_fore_color(GABEDIT_XYPLOT(xyplot));
@@ -453,14 +125,10 @@ static void add_new_data_dos(GabeditXYPlot* xyplot, GList* X, GList* I, gchar* c
 		data->size=numberOfPoints;
 		data->x = g_malloc(numberOfPoints*sizeof(gdouble)); 
 		data->y = g_malloc(numberOfPoints*sizeof(gdouble)); 
-		for(loop=0;loop<numberOfPoints;loop++) data->x[loop]= data->y[loop] = 0.0;
-
-		loop = 0;
-		for(; cx != NULL && cy != NULL; cx = cx->next, cy = cy->next) 
+		for(loop=0;loop<numberOfPoints;loop++)
 		{
-			data->x[loop] = *(gdouble*)(cx->data);
-			data->y[loop] = *(gdouble*)(cy->data);
-			loop++;
+			data->x[loop] = X[loop];
+			data->y[loop] = I[loop];
 		}
 
 		sprintf(data->point_str,"+");
@@ -491,38 +159,27 @@ static void add_new_data_dos(GabeditXYPlot* xyplot, GList* X, GList* I, gchar* c
 	}
 }
 /********************************************************************************/
-static void add_hline(GtkWidget* xyplot, GList* X)
+static void add_hline(GtkWidget* xyplot, gint n)
 {
-	gint n = 0;
 	gdouble x[2]={1,n};	
 	gdouble y[2]={0,0};	
-	GList* current = NULL;
-	current = g_list_first(X);
-	for(; current != NULL; current = current->next) n++;
-	x[1] =  n;
 	gabedit_xyplot_add_new_data(xyplot,2, x,  y);
 	gabedit_xyplot_set_last_data_line_width (GABEDIT_XYPLOT(xyplot), 3);
 	gabedit_xyplot_add_object_text (GABEDIT_XYPLOT(xyplot), 0, 0,0, "Fermi level");
 }
 /********************************************************************************/
-static void add_vline(GtkWidget* xyplot, GList* Y)
+static void add_vline(GtkWidget* xyplot, gint n, gdouble* Y)
 {
-	gint n = 0;
+	gint i;
 	gdouble x[2]={0,0};	
-	gdouble y[2]={0,n};	
-	GList* current = NULL;
-	current = g_list_first(Y);
-	for(; current != NULL; current = current->next) 
-	{
-		gdouble v = *(gdouble*)(current->data);
-		if(v>y[1]) y[1] = v;
-	}
+	gdouble y[2]={0,0};	
+	for(i=0;i<n;i++) if(Y[i]>y[1]) y[1] = Y[i];
 	gabedit_xyplot_add_new_data(xyplot,2, x,  y);
 	gabedit_xyplot_set_last_data_line_width (GABEDIT_XYPLOT(xyplot), 3);
 	gabedit_xyplot_add_object_text (GABEDIT_XYPLOT(xyplot), 0, 0,0, "Fermi level");
 }
 /********************************************************************************/
-static void createUtilsBandsVASPWin(gchar* title, GList* X, GList** lists, gint nEnergies, gchar* xlabel, gchar* ylabel, gint hmajor)
+static void createUtilsBandsVASPWin(gchar* title, gint nKPoints, gdouble* X, gdouble* bands, gint nEnergies, gchar* xlabel, gchar* ylabel, gint hmajor)
 {
 	gint i;
 	GtkWidget* window = gabedit_xyplot_new_window(title, NULL);
@@ -532,196 +189,58 @@ static void createUtilsBandsVASPWin(gchar* title, GList* X, GList** lists, gint
 	if(!xyplot || !G_IS_OBJECT(xyplot)) return;
 	for(i=0;i<nEnergies;i++)
 	{
-		if(X && lists) add_new_data_bands(xyplot, X,  lists,i, "red");
+		if(X && bands) add_new_data_bands(xyplot, nKPoints, X, bands, nEnergies, i, "red");
 	}
 	if(xlabel) gabedit_xyplot_set_x_label (GABEDIT_XYPLOT(xyplot), xlabel);
 	if(ylabel) gabedit_xyplot_set_y_label (GABEDIT_XYPLOT(xyplot), ylabel);
 	if(hmajor>=0) gabedit_xyplot_set_ticks_hmajor (GABEDIT_XYPLOT(xyplot), hmajor);
-	add_hline(GTK_WIDGET(xyplot),X);
+	add_hline(GTK_WIDGET(xyplot),nKPoints);
 }
 /********************************************************************************/
-static  GtkWidget* createUtilsDOSVASPWin(gchar* title, GList* X, GList** lists, gint nLists, gchar* xlabel, gchar* ylabel, gint hmajor)
+static  GtkWidget* createUtilsDOSVASPWin(gchar* title, gint n, gdouble* X, gdouble* I, gchar* xlabel, gchar* ylabel, gint hmajor)
 {
-	gint i;
 	GtkWidget* window = gabedit_xyplot_new_window(title, NULL);
 	GabeditXYPlot *xyplot = g_object_get_data(G_OBJECT (window), "XYPLOT");
 	set_icone(window);
 
 	if(!xyplot || !G_IS_OBJECT(xyplot)) return NULL;
-//	printf("nLists = %d\n", nLists);
-	for(i=0;i<nLists;i++)
-	{
-		if(X && lists) add_new_data_dos(xyplot, X,  lists[i], "red");
-	}
+	if(X && I) add_new_data_dos(xyplot, n, X, I, "red");
 	if(xlabel) gabedit_xyplot_set_x_label (GABEDIT_XYPLOT(xyplot), xlabel);
 	if(ylabel) gabedit_xyplot_set_y_label (GABEDIT_XYPLOT(xyplot), ylabel);
 	if(hmajor>=0) gabedit_xyplot_set_ticks_hmajor (GABEDIT_XYPLOT(xyplot), hmajor);
-	add_vline(GTK_WIDGET(xyplot),lists[0]);
+	if(I) add_vline(GTK_WIDGET(xyplot), n, I);
 	return window;
 }
 /********************************************************************************/
-static gdouble read_efermi(FILE* fd)
-{
- 	gchar t[BSIZE];
-	gdouble  efermi = 0;
-	rewind(fd);
-  	while(!feof(fd))
-  	{
-    		if(!fgets(t,BSIZE,fd)) break;
-		if(strstr(t,"efermi"))
-		{
-        		sscanf(strstr(t,">")+strlen(">"),"%lf",&efermi);
-			break;
-		}
-	}
-	return efermi;
-	
-}
-/********************************************************************************/
-static void shift_values(GList* X, gdouble eshift)
-{
-	GList* current = NULL;
-	if(!X)return;
-	current = g_list_first(X);
-	for(; current != NULL; current = current->next)  *(gdouble*)(current->data) += eshift;
-}
-/********************************************************************************/
-static void shift_energies(GList* X, GList** lists, gdouble eshift)
-{
-	gint n = 0;
-	gint i;
-	if(X)
-	{
-		GList* current = NULL;
-		current = g_list_first(X);
-		for(; current != NULL; current = current->next) n++;
-	}
-	if(n<1) return;
-	for(i=0;i<n;i++)
-	{
-		GList* cy = g_list_first(lists[i]);
-		for(; cy != NULL; cy = cy->next) *(gdouble*)(cy->data) += eshift;
-	}
-}
-/********************************************************************************/
-static gint read_number_of_kpoints(FILE* fd)
-{
- 	gchar t[BSIZE];
-	gint numberOfKPoints = 0;
-        if(!goToStr(fd, "kpointlist"))
-        {
-                fprintf(stderr,"I cannot read the number of kpoints\nCheck your xml file\n");
-                return 0;
-        }
-  	while(!feof(fd))
-  	{
-    		if(!fgets(t,BSIZE,fd)) break;
-		if(strstr(t,"/varray")) break;
-		numberOfKPoints++;
-	}
-	return numberOfKPoints;
-}
-/********************************************************************************/
-static gint read_energies_for_one_kpoint_vasp_xml_file(FILE* fd, gint numk, GList** lists)
-{
- 	gchar t[BSIZE];
- 	gchar tag[BSIZE];
-	gdouble e, occ;
-	gint nEnergies = 0;
-	sprintf(tag,"kpoint %d",numk+1);
-        if(!goToStr(fd, tag))
-        {
-                fprintf(stderr,"I cannot read energies for %s from the VASP xml file\nCheck your file\n",tag);
-                return nEnergies;
-        }
-
-  	while(!feof(fd))
-  	{
-    		if(!fgets(t,BSIZE,fd)) break;
-		if(strstr(t,"</set>")) { break; }
-		if(strstr(t,"<r>"))
-		{
-//			printf("%s\n",(strstr(t,"<r>")+strlen("<r>")));
-			if(2==sscanf(strstr(t,"<r>")+strlen("<r>"),"%lf %lf",
-			&e, &occ))
-			{
-				gdouble* data;
-				data = g_malloc(sizeof(gdouble));
-				*data = e;
-				lists[numk]=g_list_append(lists[numk], (gpointer) data);
-				/*
-				data = g_malloc(sizeof(gdouble));
-				*data = occ;
-				listsOcc[numk]=g_list_append(listsOcc[numk], (gpointer) data);
-				*/
-				nEnergies++;
-			}
-			else
-			{
-				nEnergies = 0;
-				break;
-			}
-		}
-	}
-	return nEnergies;
-}
-/********************************************************************************/
 static gboolean read_bands_vasp_xml_file(GabeditFileChooser *SelecFile, gint response_id)
 {
 	gchar *fileName;
- 	FILE *fd;
-	gint numberOfKPoints = 0;
-	GList* X = NULL;
-	GList** lists = NULL;
-	gint nEnergies = 0;
-	gint n;
-	gint j;
+	VASPXmlFile* vasp = NULL;
+	gdouble* X = NULL;
+	gdouble* bands = NULL;
 	gint i;
-	gdouble efermi;
 
 	if(response_id != GTK_RESPONSE_OK) return FALSE;
  	fileName = gabedit_file_chooser_get_current_file(SelecFile);
 
- 	fd = FOpen(fileName, "rb");
-	numberOfKPoints = read_number_of_kpoints(fd);
-	//printf("numberOfKPoints=%d\n",numberOfKPoints);
-	if(numberOfKPoints<1) { fclose(fd); return FALSE;}
-
-	lists = g_malloc(numberOfKPoints*sizeof(GList*));
-	for(i=0;i<numberOfKPoints;i++) lists[i] = NULL;
-
-	for(i=0;i<numberOfKPoints;i++) 
-	{
-		n = read_energies_for_one_kpoint_vasp_xml_file(fd, i, lists);
-		//printf("nEnergies=%d\n",n);
-		if(i==0) nEnergies = n;
-		else
-		{
-			if(n!=nEnergies)
-			{
-                		fprintf(stderr,"I cannot read energies for kpoint number %d\nCheck your vasp xml file\n", i+1);
-				if(fd) fclose(fd);
-				for(j=0;j<numberOfKPoints;j++) g_list_free_all(lists[j], g_free);
-				g_list_free_all(X, g_free);
-                		return FALSE;
-			}
-		}
-	}
-	for(i=0;i<numberOfKPoints;i++) 
-	{
-		gdouble* data = g_malloc(sizeof(gdouble));
-		*data = i+1;
-		X = g_list_append(X, (gpointer) data);
+	vasp = new_vasp_xml_file(fileName, FALSE);
+	if(!vasp || vasp->nKPoints<1 || vasp->nBands<1) 
+	{ 
+               	fprintf(stderr,"I cannot read the bands from the VASP xml file\nCheck your file\n");
+		free_vasp_xml_file(vasp);
+		return FALSE;
 	}
-	efermi = read_efermi(fd);
-	shift_energies(X, lists, -efermi);
-	fclose(fd);
 
-	if(X) createUtilsBandsVASPWin("Bands", X, lists, nEnergies,"Bands", "E-E<sub>f</sub>(eV)",0);
+	X = g_malloc(vasp->nKPoints*sizeof(gdouble));
+	for(i=0;i<vasp->nKPoints;i++) X[i] = i+1;
+	bands = g_malloc(vasp->nKPoints*vasp->nBands*sizeof(gdouble));
+	for(i=0;i<vasp->nKPoints*vasp->nBands;i++) bands[i] = vasp->bands[i]-vasp->efermi;
 
+	createUtilsBandsVASPWin("Bands", vasp->nKPoints, X, bands, vasp->nBands,"Bands", "E-E<sub>f</sub>(eV)",0);
 
-	for(j=0;j<numberOfKPoints;j++) g_list_free_all(lists[j], g_free);
-	g_list_free_all(X, g_free);
+	g_free(X);
+	g_free(bands);
+	free_vasp_xml_file(vasp);
 	return TRUE;
 
 }
@@ -737,102 +256,46 @@ void read_bands_vasp_xml_file_dlg()
 	gtk_window_set_modal (GTK_WINDOW (filesel), TRUE);
 }
 /********************************************************************************/
-static gint read_dos_all_vasp_xml_file(FILE* fd, GList** pX, GList** pI)
-{
- 	gchar t[BSIZE];
-	gdouble e, i;
-	gint n = 0;
-        if(!goToStr(fd,"<dos>"))
-        {
-                fprintf(stderr,"I cannot read dos from the VASP xml file\nCheck your file\n");
-                return 0;
-        }
-
-/*
-        if(!goToStr(fd,"<set>"))
-        {
-                fprintf(stderr,"I cannot read dos from the VASP xml file\nCheck your file\n");
-                return 0;
-        }
-*/
-  	while(!feof(fd))
-  	{
-    		if(!fgets(t,BSIZE,fd)) break;
-		if(strstr(t,"</set>")) { break; }
-		//printf("t=%s\n",t);
-		if(strstr(t,"<r>"))
-		{
-			//printf("%s\n",(strstr(t,"<r>")+strlen("<r>")));
-			if(2==sscanf(strstr(t,"<r>")+strlen("<r>"),"%lf %lf", &e, &i))
-			{
-				gdouble* data;
-				data = g_malloc(sizeof(gdouble));
-				*data = e;
-				*pX=g_list_append(*pX, (gpointer) data);
-				data = g_malloc(sizeof(gdouble));
-				*data = i;
-				*pI=g_list_append(*pI, (gpointer) data);
-				n++;
-			}
-			else
-			{
-				n = 0;
-				break;
-			}
-		}
-	}
-	//printf("n=%d\n",n);
-	return n;
-}
-/********************************************************************************/
 static gboolean read_dos_vasp_xml_file(GabeditFileChooser *SelecFile, gint response_id)
 {
 	gchar *fileName;
- 	FILE *fd;
-	GList* X = NULL;
-	GList* I = NULL;
-	gint j;
+	VASPXmlFile* vasp = NULL;
+	gdouble* X = NULL;
 	gint i;
 	GtkWidget* window = NULL;
-	gdouble efermi;
 	GabeditXYPlot *xyplot = NULL;
 	gchar* xlabel = "E-E<sub>f</sub>(eV)";
 	gchar* ylabel = "Intensity";
-	GList * listOfAtomTypes = NULL;
-	GList * listOfOrbTypes = NULL;
 
 	if(response_id != GTK_RESPONSE_OK) return FALSE;
  	fileName = gabedit_file_chooser_get_current_file(SelecFile);
 
- 	fd = FOpen(fileName, "rb");
-	read_dos_all_vasp_xml_file(fd, &X, &I);
-	efermi = read_efermi(fd);
-	shift_values(X, -efermi);
-
-	rewind(fd);
-	listOfAtomTypes = read_atom_types_vasp_xml_file(fd);
-	rewind(fd);
-	listOfOrbTypes  = read_orb_types_vasp_xml_file(fd);
-	fclose(fd);
-	if(listOfAtomTypes && listOfOrbTypes )
+	vasp = new_vasp_xml_file(fileName, TRUE);
+	if(!vasp || vasp->nDos<1)
+	{
+                fprintf(stderr,"I cannot read dos from the VASP xml file\nCheck your file\n");
+		free_vasp_xml_file(vasp);
+		return FALSE;
+	}
+	X = g_malloc(vasp->nDos*sizeof(gdouble));
+	for(i=0;i<vasp->nDos;i++) X[i] = vasp->dosEnergies[i]-vasp->efermi;
+
+	if(vasp->nTypes>0 && vasp->nOrbs>0)
 	{
-		 window = dos_vasp_win_new("DOS",X, listOfAtomTypes, listOfOrbTypes, fileName);
+		/* X and vasp are freed with the window */
+		window = dos_vasp_win_new("DOS", X, vasp);
 		xyplot = g_object_get_data(G_OBJECT (window), "XYPLOT");
-        	if(xyplot && X && I) add_new_data_dos(xyplot, X,  I, "red");
+        	if(xyplot) add_new_data_dos(xyplot, vasp->nDos, X, vasp->dosTotal, "red");
         	if(xlabel) gabedit_xyplot_set_x_label (GABEDIT_XYPLOT(xyplot), xlabel);
         	if(ylabel) gabedit_xyplot_set_y_label (GABEDIT_XYPLOT(xyplot), ylabel);
-        	add_vline(GTK_WIDGET(xyplot),I);
-		//g_list_free_all(X, g_free);  // not here
+        	add_vline(GTK_WIDGET(xyplot), vasp->nDos, vasp->dosTotal);
 	}
 	else 
 	{
-		window = createUtilsDOSVASPWin("DOS", X, &I, 1,xlabel, ylabel, -1);
-		g_list_free_all(X, g_free);
+		window = createUtilsDOSVASPWin("DOS", vasp->nDos, X, vasp->dosTotal, xlabel, ylabel, -1);
+		g_free(X);
+		free_vasp_xml_file(vasp);
 	}
-
-	g_list_free_all(I, g_free);
-	g_list_free_all(listOfAtomTypes, g_free);
-	g_list_free_all(listOfOrbTypes, g_free);
 	return TRUE;
 
 }
@@ -851,11 +314,11 @@ void read_dos_vasp_xml_file_dlg()
 static void destroy_dos_vasp_in(GtkWidget *window, gpointer data)
 {
 	gint* pnOrbs= g_object_get_data(G_OBJECT (window), "NOrbs");
-	GList* X = g_object_get_data(G_OBJECT (window), "XList");
-	gchar* fileName = g_object_get_data(G_OBJECT (window), "FileName");
+	gdouble* X = g_object_get_data(G_OBJECT (window), "XValues");
+	VASPXmlFile* vasp = g_object_get_data(G_OBJECT (window), "VASPXmlFile");
 	if(pnOrbs) g_free(pnOrbs);
-	if(fileName) g_free(fileName);
-	if(X) g_list_free_all(X, g_free); 
+	if(X) g_free(X);
+	if(vasp) free_vasp_xml_file(vasp);
 	gtk_widget_destroy(window);
 }
 /****************************************************************************************/
@@ -884,92 +347,74 @@ static gboolean xyplot_motion_notify_event(GtkWidget *xyplot, GdkEventMotion *ev
         return TRUE;
 }
 /****************************************************************************************/
+static gboolean get_atoms_range(VASPXmlFile* vasp, G_CONST_RETURN gchar* symbol, gint* pBegin, gint* pEnd)
+{
+	gint iBegin = 0;
+	gint iEnd = -1;
+	gint i,j;
+	gchar* s;
+	for(i=0;i<vasp->nTypes;i++)
+	{
+		if(!strcmp(vasp->typeSymbols[i],symbol))
+		{
+			*pBegin = iBegin;
+			*pEnd = iBegin+vasp->typeNAtoms[i]-1;
+			return TRUE;
+		}
+		iBegin += vasp->typeNAtoms[i];
+	}
+	/* symbol contain iBegin and iEnd */
+	iBegin = -1;
+	s = g_strdup(symbol);
+	for(i=0;i<strlen(s);i++) if(s[i]=='-') s[i] = ' ';
+	if(sscanf(s,"%d %d", &i, &j)==2) 
+	{
+		iBegin = i-1;
+		iEnd = j-1;
+		if(iEnd<iBegin) { iBegin=j-1; iEnd=i-1;}
+	}
+	else if(sscanf(s,"%d", &i)==1) 
+	{
+		iBegin = iEnd = i-1;
+	}
+	g_free(s);
+	*pBegin = iBegin;
+	*pEnd = iEnd;
+	return iBegin>=0 && iEnd>=0 && iBegin<=vasp->nAtoms-1 && iEnd<=vasp->nAtoms-1;
+}
+/****************************************************************************************/
 static void  apply_pdos(GtkWidget *window, gpointer data)
 {
 	GtkWidget** toggle_orbs=NULL;
 	GtkWidget* entry_atom=NULL;
 	gint* pnOrbs = NULL;
-	gchar* fileName = NULL;
+	VASPXmlFile* vasp = NULL;
 	gint nOrbs = 0;
-	GtkWidget* applyButton = g_object_get_data (G_OBJECT (window), "ApplyButton");
 	toggle_orbs = g_object_get_data(G_OBJECT (window), "ToggleOrbs");
 	pnOrbs= g_object_get_data(G_OBJECT (window), "NOrbs");
-	fileName = g_object_get_data(G_OBJECT (window), "FileName");
+	vasp = g_object_get_data(G_OBJECT (window), "VASPXmlFile");
 	entry_atom= g_object_get_data(G_OBJECT (window), "EntryAtom");
 	if(pnOrbs) nOrbs = *pnOrbs;
-	//printf("nOrbs=%d\n",nOrbs);
-	//printf("fileName=%s\n",fileName);
-	gtk_widget_set_sensitive(applyButton, FALSE); 
-	while( gtk_events_pending() ) gtk_main_iteration();
-	if(fileName && entry_atom && nOrbs>0)
+	if(vasp && entry_atom && nOrbs>0)
 	{
 		gint i;
-		GList* IpDOS = NULL;//
-		GtkWidget* cancelButton = g_object_get_data (G_OBJECT (window), "CancelButton");
+		gint iBegin, iEnd;
+		gdouble* IpDOS = NULL;
   		G_CONST_RETURN gchar* atom = gtk_entry_get_text(GTK_ENTRY(entry_atom));
 		gint* typesOrbs = g_malloc(nOrbs*sizeof(gint));
 		GabeditXYPlot *xyplot = g_object_get_data(G_OBJECT (window), "XYPLOT");
-		GList* X = g_object_get_data(G_OBJECT (window), "XList");
+		gdouble* X = g_object_get_data(G_OBJECT (window), "XValues");
 		for(i=0;i<nOrbs;i++) typesOrbs[i] = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(toggle_orbs[i]))?1:0;
 
-		gtk_widget_set_sensitive(cancelButton, TRUE); 
-		while( gtk_events_pending() ) gtk_main_iteration();
-		IpDOS = read_pdos_vasp_xml_file(window, fileName, atom, 1, typesOrbs, nOrbs);
-		if(X && IpDOS) add_new_data_dos(xyplot, X, IpDOS, "blue");
-		if(IpDOS) g_list_free_all(IpDOS, g_free); 
-		gtk_widget_set_sensitive(cancelButton, FALSE); 
-		while( gtk_events_pending() ) gtk_main_iteration();
+		if(get_atoms_range(vasp, atom, &iBegin, &iEnd))
+			IpDOS = get_pdos_from_vasp_xml_file(vasp, iBegin, iEnd, typesOrbs);
+		if(X && IpDOS) add_new_data_dos(xyplot, vasp->nDos, X, IpDOS, "blue");
+		if(IpDOS) g_free(IpDOS); 
+		g_free(typesOrbs);
 	}
-	gtk_widget_set_sensitive(applyButton, TRUE); 
 }
 /****************************************************************************************/
-static void  cancel_calcul(GtkWidget *window, gpointer data)
-{
-	GtkWidget* cancelButton = g_object_get_data (G_OBJECT (window), "CancelButton");
-	gtk_widget_set_sensitive(cancelButton, FALSE); 
-	while( gtk_events_pending() ) gtk_main_iteration();
-}
-/***********************************************************/
-static GtkWidget *add_progress_bar(GtkWidget *box)
-{
-	GtkWidget *pbar;
-	GtkWidget *table;
-	GtkWidget *StatusProgress;
-	GtkWidget *button;
-
-	table = gtk_table_new(1,4,FALSE);
-	
-	gtk_box_pack_start (GTK_BOX(box), table, FALSE, TRUE, 2);
-	gtk_widget_show (table);
-
-	StatusProgress = gtk_statusbar_new();
-	gtk_widget_show(StatusProgress);
-	gtk_table_attach(GTK_TABLE(table),StatusProgress,0,2,0,1,
-			(GtkAttachOptions)(GTK_FILL | GTK_EXPAND),
-			(GtkAttachOptions)(GTK_FILL | GTK_EXPAND),
-			1,1);
-    	pbar = gtk_progress_bar_new ();
-    	gtk_widget_show(pbar);
-
-	gtk_table_attach(GTK_TABLE(table),pbar,2,3,0,1,
-			(GtkAttachOptions)(GTK_FILL | GTK_SHRINK),
-			(GtkAttachOptions)(GTK_FILL | GTK_SHRINK),
-			1,1);
-
-  	button = gtk_button_new_with_label(_("Cancel"));
-	gtk_table_attach(GTK_TABLE(table),button,3,4,0,1,
-			(GtkAttachOptions)(GTK_FILL | GTK_SHRINK),
-			(GtkAttachOptions)(GTK_FILL | GTK_SHRINK),
-			1,1);
-  	gtk_widget_show_all (button);
-	gtk_widget_set_sensitive(button, FALSE); 
-	g_object_set_data (G_OBJECT (pbar), "StatusProgress",StatusProgress);
-	g_object_set_data (G_OBJECT (pbar), "CancelButton",button);
-
-	return pbar;
-}
-/****************************************************************************************/
-static GtkWidget* dos_vasp_win_new(gchar* title,GList* X, GList* listOfAtomTypes, GList* listOfOrbTypes, gchar* fileName)
+static GtkWidget* dos_vasp_win_new(gchar* title, gdouble* X, VASPXmlFile* vasp)
 {
 	GtkWidget* window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
 	GtkWidget* applyButton = NULL;
@@ -978,15 +423,11 @@ static GtkWidget* dos_vasp_win_new(gchar* title,GList* X, GList* listOfAtomTypes
 	GtkWidget* frame_xyplot = NULL;
 	GtkWidget* xyplot = NULL;
 	GtkWidget* tmp_label = NULL;
-	GtkWidget* vbox = NULL;
-	GList* cAtom = NULL;
-	GList* cOrb = NULL;
 	gint i;
 	gint nOrbs = 0;
 	gchar** listAtoms = NULL;
 	gint nAtoms = 2;
 	gint* pnOrbs = NULL;
-	gchar* fName = NULL;
 
 	GtkWidget* entry_atom = NULL;
 
@@ -997,17 +438,12 @@ static GtkWidget* dos_vasp_win_new(gchar* title,GList* X, GList* listOfAtomTypes
 	GtkWidget* hbox = NULL;
 	GtkWidget* hbox_data = NULL;
 	GtkWidget* first_hbox = NULL;
-	GtkWidget* progressBar = NULL;
-	GtkWidget* cancelButton = NULL;
 
 	gchar tmp[100];
 
-	nOrbs = 0;
-        for(cOrb = g_list_first(listOfOrbTypes); cOrb != NULL; cOrb = cOrb->next) nOrbs++;
-//	printf("nOrbs= %d\n",nOrbs);
+	nOrbs = vasp->nOrbs;
 	if(nOrbs<1) return NULL;
 	pnOrbs = g_malloc(sizeof(gint));
-	fName = g_strdup(fileName);
 
 	*pnOrbs = nOrbs;
 	toggle_orbs=g_malloc(nOrbs*sizeof(GtkWidget*));
@@ -1033,7 +469,7 @@ static GtkWidget* dos_vasp_win_new(gchar* title,GList* X, GList* listOfAtomTypes
 	frame_add_pdos=gtk_frame_new(_("Add PDOS"));
 	gtk_table_attach(GTK_TABLE(table1), frame_add_pdos, 0, 1, 1, 2, GTK_FILL, GTK_FILL, 0, 1);
 
-	table2=gtk_table_new(1, 3, FALSE);
+	table2=gtk_table_new(1, 2, FALSE);
 	gtk_container_add(GTK_CONTAINER(frame_add_pdos), table2);
 	//gtk_widget_show(table2);
 
@@ -1045,9 +481,7 @@ static GtkWidget* dos_vasp_win_new(gchar* title,GList* X, GList* listOfAtomTypes
 	gtk_widget_show(hbox_data);
 
 	
-	nAtoms = 0;
-	cAtom = g_list_first(listOfAtomTypes);
-        for(; cAtom != NULL; cAtom = cAtom->next) nAtoms++;
+	nAtoms = vasp->nTypes;
 
 	if(nAtoms<1) 
 	{
@@ -1057,18 +491,9 @@ static GtkWidget* dos_vasp_win_new(gchar* title,GList* X, GList* listOfAtomTypes
 	}
 	else
 	{
-		gint nAllAtoms = 0;
-		cAtom = g_list_first(listOfAtomTypes);
 		listAtoms = g_malloc((nAtoms+2)*sizeof(gchar*));
-		i = 0;
-        	for(; cAtom != NULL; cAtom = cAtom->next) 
-		{
-			AtomType* data = (AtomType*)cAtom->data;
-			listAtoms[i] = g_strdup(data->symbol);
-			nAllAtoms+= data->nAtoms;
-			i++;
-		}
-		listAtoms[i] = g_strdup_printf("%d-%d",1,nAllAtoms);
+        	for(i=0;i<vasp->nTypes;i++) listAtoms[i] = g_strdup(vasp->typeSymbols[i]);
+		listAtoms[i] = g_strdup_printf("%d-%d",1,vasp->nAtoms);
 		i++;
 		listAtoms[i] = g_strdup_printf("%d",1);
 	}
@@ -1076,10 +501,9 @@ static GtkWidget* dos_vasp_win_new(gchar* title,GList* X, GList* listOfAtomTypes
         gtk_editable_set_editable((GtkEditable*) entry_atom,TRUE);
 	gtk_widget_show(entry_atom);
 
-        for(i=0,cOrb = g_list_first(listOfOrbTypes); cOrb != NULL; cOrb = cOrb->next,i++) 
+        for(i=0;i<nOrbs;i++) 
 	{
-		gchar* data = (gchar*)cOrb->data;
-		toggle_orbs[i] = gtk_check_button_new_with_label(_(data));
+		toggle_orbs[i] = gtk_check_button_new_with_label(_(vasp->orbNames[i]));
 		gtk_box_pack_start(GTK_BOX(hbox_data), toggle_orbs[i], FALSE, FALSE, 1);
 		gtk_widget_show(toggle_orbs[i]);
 	}
@@ -1096,11 +520,6 @@ static GtkWidget* dos_vasp_win_new(gchar* title,GList* X, GList* listOfAtomTypes
 	gtk_widget_grab_default(applyButton);
 	gtk_widget_show_all (applyButton);
 
-	vbox = gtk_vbox_new(FALSE,2);
-	gtk_table_attach(GTK_TABLE(table2), vbox, 2, 3, 0, 1, GTK_FILL, GTK_FILL, 1, 1);
-	gtk_widget_show(vbox);
-
-	progressBar = add_progress_bar(vbox);
 	gtk_widget_show_all(frame_add_pdos);
 
 	statusbar=gtk_statusbar_new();
@@ -1119,32 +538,24 @@ static GtkWidget* dos_vasp_win_new(gchar* title,GList* X, GList* listOfAtomTypes
 	 //gtk_window_set_default_size (GTK_WINDOW(window),2*gdk_screen_width()/3,2*gdk_screen_height()/3);
 	gtk_widget_show (window);
 
-        for(i=0,cOrb = g_list_first(listOfOrbTypes); cOrb != NULL; cOrb = cOrb->next,i++) 
+        for(i=0;i<nOrbs;i++) 
 		gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(toggle_orbs[i]), FALSE);
 
-	cancelButton =g_object_get_data (G_OBJECT(progressBar), "CancelButton");
 	g_object_set_data(G_OBJECT (xyplot), "EntryAtom", entry_atom);
 	g_object_set_data(G_OBJECT (xyplot), "HBoxData", first_hbox);
-	g_object_set_data(G_OBJECT (xyplot), "VBox", vbox);
 	g_object_set_data(G_OBJECT (xyplot), "Window", window);
 	g_object_set_data(G_OBJECT (xyplot), "NOrbs", pnOrbs);
-	g_object_set_data(G_OBJECT (xyplot), "FileName", fName);
-	g_object_set_data(G_OBJECT (xyplot), "XList", X);
+	g_object_set_data(G_OBJECT (xyplot), "VASPXmlFile", vasp);
+	g_object_set_data(G_OBJECT (xyplot), "XValues", X);
 
 	g_object_set_data(G_OBJECT (window), "EntryAtom", entry_atom);
 	g_object_set_data(G_OBJECT (window), "HBoxData", first_hbox);
-	g_object_set_data(G_OBJECT (window), "VBox", vbox);
 	g_object_set_data(G_OBJECT (window), "ToggleOrbs", toggle_orbs);
 	g_object_set_data(G_OBJECT (window), "NOrbs", pnOrbs);
-	g_object_set_data(G_OBJECT (window), "FileName", fName);
-	g_object_set_data(G_OBJECT (window), "XList", X);
-	g_object_set_data (G_OBJECT (window), "ProgressBar",progressBar);
-	g_object_set_data (G_OBJECT (window), "StatusProgress", g_object_get_data (G_OBJECT (progressBar), "StatusProgress"));
-	g_object_set_data (G_OBJECT (window), "CancelButton",cancelButton);
+	g_object_set_data(G_OBJECT (window), "VASPXmlFile", vasp);
+	g_object_set_data(G_OBJECT (window), "XValues", X);
 	g_object_set_data (G_OBJECT (window), "ApplyButton",applyButton);
 
-	g_signal_connect_swapped(G_OBJECT(cancelButton), "clicked", (GCallback)cancel_calcul,window);  
-
 	gabedit_xyplot_set_font (GABEDIT_XYPLOT(xyplot), "sans 12");
 	gtk_window_set_transient_for(GTK_WINDOW(window),GTK_WINDOW(Fenetre));
 
@@ -1159,53 +570,32 @@ static GtkWidget* dos_vasp_win_new(gchar* title,GList* X, GList* listOfAtomTypes
 /********************************************************************************/
 gint read_geometry_vasp_xml_file(gchar* fileName, gint numgeom, gchar** atomSymbols[], gdouble* positions[])
 {
-	GList* cAtom;
-	AtomType* data = NULL;
-	GList* listOfAtomTypes = NULL;
+	VASPXmlFile* vasp = NULL;
 	gint nAtoms = 0;
 	gint i,j,k;
-	gint nG = 0;
 	gdouble TV[3][3];
 	gint nTV = 0;
 	gchar** symbols = NULL;
-        gint* ntypes = NULL;
         gdouble* X = NULL;
         gdouble* Y = NULL;
         gdouble* Z = NULL;
  	gchar t[BSIZE];
 	gboolean direct = TRUE;
-	long int geomposok = 0;
+ 	FILE* file = NULL;
 
-
- 	FILE* file = FOpen(fileName, "rb");
-	rewind(file);
-	listOfAtomTypes = read_atom_types_vasp_xml_file(file);
-
-	nAtoms = 0;
-        for(cAtom = g_list_first(listOfAtomTypes); cAtom != NULL; cAtom = cAtom->next) 
-	{
-		data = (AtomType*)cAtom->data;
-		 nAtoms += data->nAtoms;
-	}
+	vasp = new_vasp_xml_file(fileName, FALSE);
+	if(!vasp) return 0;
+	nAtoms = vasp->nAtoms;
 	/* printf("nAtoms = %d\n",nAtoms);*/
-	if(nAtoms<1) { g_list_free_all(listOfAtomTypes, g_free); return 0;}
+	if(nAtoms<1 || vasp->nStructures<1) { free_vasp_xml_file(vasp); return 0;}
+	if(numgeom>vasp->nStructures) { free_vasp_xml_file(vasp); return 0;}
+	if(numgeom<=0) numgeom = vasp->nStructures;
 
-	rewind(file);
-	nG = 0;
-  	while(!feof(file))
-  	{
-    		if(!fgets(t,BSIZE,file)) break;
-		if(strstr(t,"<structure>"))
-		{
-			nG++;
-                	geomposok = ftell(file);
-			if(nG==numgeom) break; 
-		}
-	}
-	/* printf("nG = %d numgeom = %d\n",nG, numgeom);*/
-	if(numgeom>0 && nG != numgeom){ g_list_free_all(listOfAtomTypes, g_free); return 0;}
-	if(numgeom<=0) fseek(file, geomposok, SEEK_SET);
+ 	file = FOpen(fileName, "rb");
+	if(!file) { free_vasp_xml_file(vasp); return 0;}
+	seek_vasp_xml_file(file, vasp->structureOffsets[numgeom-1]);
 
+	t[0] = '\0';
   	while(!feof(file))
   	{
     		if(!fgets(t,BSIZE,file)) break;
@@ -1213,7 +603,7 @@ gint read_geometry_vasp_xml_file(gchar* fileName, gint numgeom, gchar** atomSymb
 		if(strstr(t,"</structure>")) break;
 	}
 	/* printf("t = %s\n",t);*/
-	if(!strstr(t,"basis")) { g_list_free_all(listOfAtomTypes, g_free); return 0;}
+	if(!strstr(t,"basis")) { free_vasp_xml_file(vasp); fclose(file); return 0;}
 	nTV = 0;
 	for(i=0;i<3;i++)
         {
@@ -1225,14 +615,14 @@ gint read_geometry_vasp_xml_file(gchar* fileName, gint numgeom, gchar** atomSymb
 		nTV++;
 	}
 	/* printf("t = %s\n",t);*/
-	if(nTV<3) { g_list_free_all(listOfAtomTypes, g_free); return 0;}
+	if(nTV<3) { free_vasp_xml_file(vasp); fclose(file); return 0;}
   	while(!feof(file))
   	{
     		if(!fgets(t,BSIZE,file)) break;
 		if(strstr(t,"varray name=") && strstr(t,"positions")) break;
 		if(strstr(t,"</structure>")) break;
 	}
-	if(!strstr(t,"position")) { g_list_free_all(listOfAtomTypes, g_free); return 0;}
+	if(!strstr(t,"position")) { free_vasp_xml_file(vasp); fclose(file); return 0;}
 
 	nAtoms += 3;
 	X = g_malloc(nAtoms*sizeof(gdouble));
@@ -1241,14 +631,13 @@ gint read_geometry_vasp_xml_file(gchar* fileName, gint numgeom, gchar** atomSymb
         symbols = g_malloc(nAtoms*sizeof(gchar*));
         for(i=0;i<nAtoms;i++) symbols[i] = NULL;
         k = 0;
-        for(cAtom = g_list_first(listOfAtomTypes); cAtom != NULL; cAtom = cAtom->next) 
+        for(j=0;j<vasp->nTypes;j++) 
 	{
 		gboolean ok = TRUE;
 		gchar* pos = NULL;
-		data = (AtomType*)cAtom->data;
-                for(i=0;i<data->nAtoms;i++)
+                for(i=0;i<vasp->typeNAtoms[j];i++)
                 {
-                        symbols[k] = g_strdup(data->symbol);
+                        symbols[k] = g_strdup(vasp->typeSymbols[j]);
                         symbols[k][0]=toupper(symbols[k][0]);
                         if (strlen(symbols[k])==2) symbols[k][1]=tolower(symbols[k][1]);
                         if (strlen(symbols[k])==3) symbols[k][2]=tolower(symbols[k][2]);
@@ -1261,9 +650,10 @@ gint read_geometry_vasp_xml_file(gchar* fileName, gint numgeom, gchar** atomSymb
                 }
 		if(!ok) break;
 	}
+	fclose(file);
+	free_vasp_xml_file(vasp);
 	if(k!=nAtoms-3)
 	{
-		g_list_free_all(listOfAtomTypes, g_free);
 		g_free(X);
 		g_free(Y);
 		g_free(Z);
@@ -1306,7 +696,5 @@ gint read_geometry_vasp_xml_file(gchar* fileName, gint numgeom, gchar** atomSymb
 	positions[1] = Y;
 	positions[2] = Z;
 
-	g_list_free_all(listOfAtomTypes, g_free);
-	fclose(file);
 	return nAtoms;
 }
@@ -0,0 +1,499 @@
+/* VASPXmlFile.c */
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+/* Reader of VASP vasprun.xml files.
+ * The file is read once, the section offsets are recorded and the energies, structures, DOS, partial DOS and bands
+ * are decoded into contiguous arrays. The result is saved in a binary sidecar file used as long as the xml file is unchanged.
+ */
+/* 64 bits file positions (fseeko/ftello) */
+#define _LARGEFILE_SOURCE
+#define _FILE_OFFSET_BITS 64
+#include "../../Config.h"
+#include "../Common/Global.h"
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <ctype.h>
+#include <glib/gstdio.h>
+#include "../Utils/Constants.h"
+#include "../Utils/Utils.h"
+#include "../Utils/VASPXmlFile.h"
+
+#define VASPXMLMAGIC "GABVASPX"
+#define VASPXMLVERSION 1
+
+typedef enum
+{
+	VASPXML_NONE = 0,
+	VASPXML_ATOMTYPES,
+	VASPXML_KPOINTLIST,
+	VASPXML_EIGENVALUES,
+	VASPXML_TOTALDOS,
+	VASPXML_PARTIALDOS,
+	VASPXML_FORCES
+} VASPXmlSection;
+
+/****************************************************************************/
+/* ftell/fseek use a long, 32 bits on Windows */
+gint64 tell_vasp_xml_file(FILE* file)
+{
+#ifdef G_OS_WIN32
+	return _ftelli64(file);
+#else
+	return (gint64)ftello(file);
+#endif
+}
+/****************************************************************************/
+gint seek_vasp_xml_file(FILE* file, gint64 offset)
+{
+#ifdef G_OS_WIN32
+	return _fseeki64(file, offset, SEEK_SET);
+#else
+	return fseeko(file, offset, SEEK_SET);
+#endif
+}
+/****************************************************************************/
+static VASPXmlFile* newEmptyVASPXmlFile()
+{
+	VASPXmlFile* vasp = g_malloc0(sizeof(VASPXmlFile));
+	return vasp;
+}
+/****************************************************************************/
+void free_vasp_xml_file(VASPXmlFile* vasp)
+{
+	if(!vasp) return;
+	if(vasp->typeSymbols) g_strfreev(vasp->typeSymbols);
+	if(vasp->orbNames) g_strfreev(vasp->orbNames);
+	g_free(vasp->typeNAtoms);
+	g_free(vasp->dosEnergies);
+	g_free(vasp->dosTotal);
+	g_free(vasp->pdos);
+	g_free(vasp->bands);
+	g_free(vasp->structureOffsets);
+	g_free(vasp->energies);
+	g_free(vasp->forcesRMS);
+	g_free(vasp);
+}
+/****************************************************************************/
+static void stripTags(gchar* t)
+{
+	gboolean inTag = FALSE;
+	gchar* p;
+	for(p=t;*p;p++)
+	{
+		if(*p=='<') inTag = TRUE;
+		if(inTag) 
+		{
+			if(*p=='>') inTag = FALSE;
+			*p = ' ';
+		}
+	}
+}
+/****************************************************************************/
+static gint getComment(const gchar* t, const gchar* name)
+{
+	gchar tag[50];
+	gchar* pos;
+	sprintf(tag,"comment=\"%s ",name);
+	pos = strstr(t,tag);
+	if(!pos) return -1;
+	return atoi(pos+strlen(tag));
+}
+/****************************************************************************/
+static gchar* getValuesPosition(gchar* t, const gchar* tag)
+{
+	gchar* pos = strstr(t,tag);
+	if(!pos) return NULL;
+	return pos+strlen(tag);
+}
+/****************************************************************************/
+static void indexVASPXmlFile(VASPXmlFile* vasp, FILE* file)
+{
+ 	gchar t[BSIZE];
+	VASPXmlSection section = VASPXML_NONE;
+	GArray* typeNAtoms = g_array_new(FALSE, FALSE, sizeof(gint));
+	GPtrArray* typeSymbols = g_ptr_array_new();
+	GPtrArray* orbNames = g_ptr_array_new();
+	GArray* dosEnergies = g_array_new(FALSE, FALSE, sizeof(gdouble));
+	GArray* dosTotal = g_array_new(FALSE, FALSE, sizeof(gdouble));
+	GArray* bands = g_array_new(FALSE, FALSE, sizeof(gdouble));
+	GArray* offsets = g_array_new(FALSE, FALSE, sizeof(gint64));
+	GArray* energies = g_array_new(FALSE, FALSE, sizeof(gdouble));
+	GArray* forces = g_array_new(FALSE, FALSE, sizeof(gdouble));
+	gboolean atomTypesDone = FALSE;
+	gboolean kpointsDone = FALSE;
+	gboolean efermiDone = FALSE;
+	gboolean totalDosDone = FALSE;
+	gboolean partialDosDone = FALSE;
+	gboolean bandsOk = TRUE;
+	gboolean energiesOk = TRUE;
+	gboolean waitForces = FALSE;
+	gboolean waitEnergy = FALSE;
+	gboolean energyField = FALSE;
+	gint nKPoints = 0;
+	gint iKPoint = 0;
+	gint nBandsKPoint = 0;
+	gint spin = 1;
+	gint ion = 0;
+	gint iDos = 0;
+	gint nf = 0;
+	gdouble F[3] = {0,0,0};
+	gint i;
+
+	while(fgets(t,BSIZE,file))
+	{
+		switch(section)
+		{
+			case VASPXML_ATOMTYPES :
+				if(strstr(t,"</set>")) section = VASPXML_NONE;
+				else if(strstr(t,"<rc>"))
+				{
+					gint n;
+					gchar symbol[BSIZE];
+					stripTags(t);
+					if(2==sscanf(t,"%d %s", &n, symbol))
+					{
+						g_array_append_val(typeNAtoms, n);
+						g_ptr_array_add(typeSymbols, g_strdup(symbol));
+						vasp->nAtoms += n;
+					}
+					else section = VASPXML_NONE;
+				}
+				continue;
+			case VASPXML_KPOINTLIST :
+				if(strstr(t,"/varray")) section = VASPXML_NONE;
+				else nKPoints++;
+				continue;
+			case VASPXML_EIGENVALUES :
+				if(strstr(t,"</set>"))
+				{
+					if(iKPoint==0) vasp->nBands = nBandsKPoint;
+					else if(nBandsKPoint != vasp->nBands) 
+					{
+                				fprintf(stderr,"I cannot read energies for kpoint number %d\nCheck your vasp xml file\n", iKPoint+1);
+						bandsOk = FALSE;
+					}
+					iKPoint++;
+					section = VASPXML_NONE;
+				}
+				else 
+				{
+					gchar* pos = getValuesPosition(t,"<r>");
+					if(pos)
+					{
+						gdouble e = atof(pos);
+						g_array_append_val(bands, e);
+						nBandsKPoint++;
+					}
+				}
+				continue;
+			case VASPXML_TOTALDOS :
+				if(strstr(t,"</total>")) { section = VASPXML_NONE; totalDosDone = TRUE; }
+				else if(getComment(t,"spin")>0) spin = getComment(t,"spin");
+				else if(spin==1)
+				{
+					gchar* pos = getValuesPosition(t,"<r>");
+					if(pos)
+					{
+						gchar* end;
+						gdouble e = strtod(pos, &end);
+						gdouble d = strtod(end, NULL);
+						g_array_append_val(dosEnergies, e);
+						g_array_append_val(dosTotal, d);
+					}
+				}
+				continue;
+			case VASPXML_PARTIALDOS :
+				if(strstr(t,"</partial>")) { section = VASPXML_NONE; partialDosDone = TRUE; }
+				else if(strstr(t,"<field"))
+				{
+					/* the first field is the energy */
+					if(!energyField) energyField = TRUE;
+					else
+					{
+						stripTags(t);
+						g_ptr_array_add(orbNames, g_strdup(g_strstrip(t)));
+					}
+				}
+				else if(getComment(t,"ion")>0) { ion = getComment(t,"ion"); iDos = 0; }
+				else if(getComment(t,"spin")>0) { spin = getComment(t,"spin"); iDos = 0; }
+				else if(spin==1 && ion>0 && ion<=vasp->nAtoms)
+				{
+					gchar* pos = getValuesPosition(t,"<r>");
+					if(pos && iDos<vasp->nDos)
+					{
+						gfloat* values;
+						if(!vasp->pdos)
+						{
+							vasp->nOrbs = orbNames->len;
+							if(vasp->nOrbs<1) { section = VASPXML_NONE; partialDosDone = TRUE; continue; }
+							vasp->pdos = g_malloc0((gsize)vasp->nAtoms*vasp->nDos*vasp->nOrbs*sizeof(gfloat));
+						}
+						values = vasp->pdos+((gsize)(ion-1)*vasp->nDos+iDos)*vasp->nOrbs;
+						strtod(pos, &pos);
+						for(i=0;i<vasp->nOrbs;i++) values[i] = strtod(pos, &pos);
+						iDos++;
+					}
+				}
+				continue;
+			case VASPXML_FORCES :
+				if(strstr(t,"varray"))
+				{
+					section = VASPXML_NONE;
+					if(nf<1) { energiesOk = FALSE; continue; }
+					for(i=0;i<3;i++) 
+					{
+						gdouble f = sqrt(F[i]/nf);
+						g_array_append_val(forces, f);
+					}
+					waitEnergy = TRUE;
+				}
+				else
+				{
+					gdouble x[3];
+					gchar* pos = strstr(t,">");
+					if(!pos || 3!=sscanf(pos+1,"%lf %lf %lf",&x[0],&x[1],&x[2])) { section = VASPXML_NONE; energiesOk = FALSE; continue; }
+					for(i=0;i<3;i++) F[i] += x[i]*x[i];
+					nf++;
+				}
+				continue;
+			default : break;
+		}
+		if(!atomTypesDone && strstr(t,"atomtypes")) { atomTypesDone = TRUE; section = VASPXML_ATOMTYPES; }
+		else if(!kpointsDone && strstr(t,"kpointlist")) { kpointsDone = TRUE; section = VASPXML_KPOINTLIST; }
+		else if(kpointsDone && bandsOk && iKPoint<nKPoints && getComment(t,"kpoint")==iKPoint+1) { nBandsKPoint = 0; section = VASPXML_EIGENVALUES; }
+		else if(strstr(t,"<structure>"))
+		{
+			gint64 offset = tell_vasp_xml_file(file);
+			g_array_append_val(offsets, offset);
+			/* a structure without forces or energy ends the list of energies */
+			if(waitForces || waitEnergy) energiesOk = FALSE;
+			waitForces = energiesOk;
+		}
+		else if(waitForces && strstr(t,"varray name") && strstr(t,"forces")) 
+		{ 
+			waitForces = FALSE;
+			nf = 0;
+			F[0] = F[1] = F[2] = 0;
+			section = VASPXML_FORCES;
+		}
+		else if(waitEnergy && strstr(t,"e_fr_energy"))
+		{
+			gchar* pos = strstr(t,">");
+			gdouble e;
+			waitEnergy = FALSE;
+			if(!pos || 1!=sscanf(pos+1,"%lf",&e)) energiesOk = FALSE;
+			else g_array_append_val(energies, e);
+		}
+		else if(waitEnergy && strstr(t,"/energy")) { waitEnergy = FALSE; energiesOk = FALSE; }
+		else if(!efermiDone && strstr(t,"efermi"))
+		{
+			gchar* pos = strstr(t,">");
+			efermiDone = TRUE;
+			if(pos) vasp->efermi = atof(pos+1);
+		}
+		else if(!totalDosDone && strstr(t,"<total>")) { spin = 1; section = VASPXML_TOTALDOS; }
+		else if(totalDosDone && !partialDosDone && strstr(t,"<partial>")) 
+		{
+			vasp->nDos = dosEnergies->len;
+			spin = 1;
+			ion = 0;
+			section = VASPXML_PARTIALDOS;
+		}
+	}
+
+	vasp->nTypes = typeNAtoms->len;
+	vasp->typeNAtoms = (gint*)g_array_free(typeNAtoms, FALSE);
+	g_ptr_array_add(typeSymbols, NULL);
+	vasp->typeSymbols = (gchar**)g_ptr_array_free(typeSymbols, FALSE);
+	if(!vasp->pdos) vasp->nOrbs = 0;
+	g_ptr_array_add(orbNames, NULL);
+	vasp->orbNames = (gchar**)g_ptr_array_free(orbNames, FALSE);
+	vasp->nDos = dosEnergies->len;
+	vasp->dosEnergies = (gdouble*)g_array_free(dosEnergies, FALSE);
+	vasp->dosTotal = (gdouble*)g_array_free(dosTotal, FALSE);
+	vasp->nKPoints = (bandsOk && iKPoint==nKPoints)?nKPoints:0;
+	if(vasp->nKPoints<1) vasp->nBands = 0;
+	vasp->bands = (gdouble*)g_array_free(bands, FALSE);
+	vasp->nStructures = offsets->len;
+	vasp->structureOffsets = (gint64*)g_array_free(offsets, FALSE);
+	vasp->nEnergies = energies->len;
+	vasp->energies = (gdouble*)g_array_free(energies, FALSE);
+	vasp->forcesRMS = (gdouble*)g_array_free(forces, FALSE);
+}
+/****************************************************************************/
+static gchar* getSidecarFileName(const gchar* fileName)
+{
+	return g_strdup_printf("%s.gabidx",fileName);
+}
+/****************************************************************************/
+static gboolean writeStrings(FILE* file, gchar** strs, gint n)
+{
+	gint i;
+	for(i=0;i<n;i++)
+	{
+		gint len = strlen(strs[i]);
+		if(fwrite(&len, sizeof(gint), 1, file)!=1) return FALSE;
+		if(len>0 && fwrite(strs[i], 1, len, file)!=(gsize)len) return FALSE;
+	}
+	return TRUE;
+}
+/****************************************************************************/
+static gchar** readStrings(FILE* file, gint n)
+{
+	gint i;
+	gchar** strs = g_malloc0((n+1)*sizeof(gchar*));
+	for(i=0;i<n;i++)
+	{
+		gint len = 0;
+		if(fread(&len, sizeof(gint), 1, file)!=1 || len<0 || len>BSIZE) break;
+		strs[i] = g_malloc0(len+1);
+		if(len>0 && fread(strs[i], 1, len, file)!=(gsize)len) break;
+	}
+	if(i<n) { g_strfreev(strs); return NULL; }
+	return strs;
+}
+/****************************************************************************/
+static gboolean writeArray(FILE* file, gconstpointer data, gsize size, gsize n)
+{
+	if(n==0) return TRUE;
+	return fwrite(data, size, n, file)==n;
+}
+/****************************************************************************/
+static gpointer readArray(FILE* file, gsize size, gsize n, gboolean* ok)
+{
+	gpointer data;
+	if(!*ok) return NULL;
+	data = g_malloc(size*(n>0?n:1));
+	if(n>0 && fread(data, size, n, file)!=n) *ok = FALSE;
+	return data;
+}
+/****************************************************************************/
+static void saveSidecarFile(VASPXmlFile* vasp, const gchar* fileName, GStatBuf* st)
+{
+	gchar* sidecar = getSidecarFileName(fileName);
+	FILE* file = FOpen(sidecar, "wb");
+	gint header[9];
+	gint64 stamp[2];
+	gboolean ok;
+	if(!file) { g_free(sidecar); return; }
+	stamp[0] = st->st_size;
+	stamp[1] = st->st_mtime;
+	header[0] = VASPXMLVERSION;
+	header[1] = vasp->nTypes;
+	header[2] = vasp->nAtoms;
+	header[3] = vasp->nOrbs;
+	header[4] = vasp->nDos;
+	header[5] = vasp->nKPoints;
+	header[6] = vasp->nBands;
+	header[7] = vasp->nStructures;
+	header[8] = vasp->nEnergies;
+	ok = writeArray(file, VASPXMLMAGIC, 1, strlen(VASPXMLMAGIC));
+	ok = ok && writeArray(file, stamp, sizeof(gint64), 2);
+	ok = ok && writeArray(file, header, sizeof(gint), 9);
+	ok = ok && writeArray(file, &vasp->efermi, sizeof(gdouble), 1);
+	ok = ok && writeArray(file, vasp->typeNAtoms, sizeof(gint), vasp->nTypes);
+	ok = ok && writeStrings(file, vasp->typeSymbols, vasp->nTypes);
+	ok = ok && writeStrings(file, vasp->orbNames, vasp->nOrbs);
+	ok = ok && writeArray(file, vasp->dosEnergies, sizeof(gdouble), vasp->nDos);
+	ok = ok && writeArray(file, vasp->dosTotal, sizeof(gdouble), vasp->nDos);
+	ok = ok && writeArray(file, vasp->bands, sizeof(gdouble), (gsize)vasp->nKPoints*vasp->nBands);
+	ok = ok && writeArray(file, vasp->structureOffsets, sizeof(gint64), vasp->nStructures);
+	ok = ok && writeArray(file, vasp->energies, sizeof(gdouble), vasp->nEnergies);
+	ok = ok && writeArray(file, vasp->forcesRMS, sizeof(gdouble), 3*vasp->nEnergies);
+	/* the partial dos is the last block, it is not read when it is not requested */
+	if(vasp->nOrbs>0) ok = ok && writeArray(file, vasp->pdos, sizeof(gfloat), (gsize)vasp->nAtoms*vasp->nDos*vasp->nOrbs);
+	fclose(file);
+	if(!ok) g_unlink(sidecar);
+	g_free(sidecar);
+}
+/****************************************************************************/
+static VASPXmlFile* loadSidecarFile(const gchar* fileName, GStatBuf* st, gboolean withPDOS)
+{
+	gchar* sidecar = getSidecarFileName(fileName);
+	FILE* file = FOpen(sidecar, "rb");
+	gchar magic[sizeof(VASPXMLMAGIC)];
+	gint header[9];
+	gint64 stamp[2];
+	gboolean ok;
+	VASPXmlFile* vasp = NULL;
+	g_free(sidecar);
+	if(!file) return NULL;
+	ok = fread(magic, 1, strlen(VASPXMLMAGIC), file)==strlen(VASPXMLMAGIC) && !strncmp(magic, VASPXMLMAGIC, strlen(VASPXMLMAGIC));
+	ok = ok && fread(stamp, sizeof(gint64), 2, file)==2 && stamp[0]==st->st_size && stamp[1]==st->st_mtime;
+	ok = ok && fread(header, sizeof(gint), 9, file)==9 && header[0]==VASPXMLVERSION;
+	if(!ok) { fclose(file); return NULL; }
+	vasp = newEmptyVASPXmlFile();
+	vasp->nTypes = header[1];
+	vasp->nAtoms = header[2];
+	vasp->nOrbs = header[3];
+	vasp->nDos = header[4];
+	vasp->nKPoints = header[5];
+	vasp->nBands = header[6];
+	vasp->nStructures = header[7];
+	vasp->nEnergies = header[8];
+	ok = fread(&vasp->efermi, sizeof(gdouble), 1, file)==1;
+	vasp->typeNAtoms = readArray(file, sizeof(gint), vasp->nTypes, &ok);
+	if(ok) ok = (vasp->typeSymbols = readStrings(file, vasp->nTypes)) != NULL;
+	if(ok) ok = (vasp->orbNames = readStrings(file, vasp->nOrbs)) != NULL;
+	vasp->dosEnergies = readArray(file, sizeof(gdouble), vasp->nDos, &ok);
+	vasp->dosTotal = readArray(file, sizeof(gdouble), vasp->nDos, &ok);
+	vasp->bands = readArray(file, sizeof(gdouble), (gsize)vasp->nKPoints*vasp->nBands, &ok);
+	vasp->structureOffsets = readArray(file, sizeof(gint64), vasp->nStructures, &ok);
+	vasp->energies = readArray(file, sizeof(gdouble), vasp->nEnergies, &ok);
+	vasp->forcesRMS = readArray(file, sizeof(gdouble), 3*vasp->nEnergies, &ok);
+	if(withPDOS && vasp->nOrbs>0) vasp->pdos = readArray(file, sizeof(gfloat), (gsize)vasp->nAtoms*vasp->nDos*vasp->nOrbs, &ok);
+	fclose(file);
+	if(!ok) { free_vasp_xml_file(vasp); return NULL; }
+	return vasp;
+}
+/****************************************************************************/
+VASPXmlFile* new_vasp_xml_file(const gchar* fileName, gboolean withPDOS)
+{
+	VASPXmlFile* vasp;
+	GStatBuf st;
+	FILE* file;
+	if(!fileName || g_stat(fileName, &st)!=0) return NULL;
+	vasp = loadSidecarFile(fileName, &st, withPDOS);
+	if(vasp) return vasp;
+
+	file = FOpen(fileName, "rb");
+	if(!file) return NULL;
+	vasp = newEmptyVASPXmlFile();
+	indexVASPXmlFile(vasp, file);
+	fclose(file);
+	saveSidecarFile(vasp, fileName, &st);
+	if(!withPDOS && vasp->pdos) { g_free(vasp->pdos); vasp->pdos = NULL; }
+	return vasp;
+}
+/****************************************************************************/
+gdouble* get_pdos_from_vasp_xml_file(VASPXmlFile* vasp, gint iBegin, gint iEnd, gint* typesOrbs)
+{
+	gdouble* I;
+	gint i,j,k;
+	if(!vasp || !vasp->pdos || vasp->nDos<1) return NULL;
+	if(iBegin<0 || iEnd>vasp->nAtoms-1 || iBegin>iEnd) return NULL;
+	I = g_malloc0(vasp->nDos*sizeof(gdouble));
+	for(i=iBegin;i<=iEnd;i++)
+	{
+		gfloat* values = vasp->pdos+(gsize)i*vasp->nDos*vasp->nOrbs;
+		for(j=0;j<vasp->nDos;j++, values += vasp->nOrbs)
+		for(k=0;k<vasp->nOrbs;k++) if(typesOrbs[k]) I[j] += values[k];
+	}
+	return I;
+}
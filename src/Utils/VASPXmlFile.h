@@ -0,0 +1,57 @@
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+************************************************************************************************************/
+
+#ifndef __GABEDIT_VASPXMLFILE_H__
+#define __GABEDIT_VASPXMLFILE_H__
+
+typedef struct _VASPXmlFile  VASPXmlFile;
+
+struct _VASPXmlFile
+{
+	gint nTypes;
+	gchar** typeSymbols;
+	gint* typeNAtoms;
+	gint nAtoms;
+	gint nOrbs;
+	gchar** orbNames;
+	gdouble efermi;
+	gint nDos;
+	gdouble* dosEnergies; /* nDos, spin 1 */
+	gdouble* dosTotal; /* nDos, spin 1 */
+	gfloat* pdos; /* [ion][point][orb], spin 1, NULL if not loaded */
+	gint nKPoints;
+	gint nBands;
+	gdouble* bands; /* [kpoint][band], spin 1 */
+	gint nStructures;
+	gint64* structureOffsets; /* file position after each <structure> tag */
+	gint nEnergies;
+	gdouble* energies; /* e_fr_energy of the first nEnergies structures */
+	gdouble* forcesRMS; /* [structure][xyz] */
+};
+
+/* index the file in one pass, or load the index from its sidecar file (fileName.gabidx) when it is up to date */
+VASPXmlFile* new_vasp_xml_file(const gchar* fileName, gboolean withPDOS);
+void free_vasp_xml_file(VASPXmlFile* vasp);
+/* sum of the selected orbitals of the ions iBegin..iEnd (0-based), allocated by g_malloc, nDos values */
+gdouble* get_pdos_from_vasp_xml_file(VASPXmlFile* vasp, gint iBegin, gint iEnd, gint* typesOrbs);
+/* 64 bits positions in the xml file, for the structureOffsets */
+gint64 tell_vasp_xml_file(FILE* file);
+gint seek_vasp_xml_file(FILE* file, gint64 offset);
+
+#endif /* __GABEDIT_VASPXMLFILE_H__ */
+
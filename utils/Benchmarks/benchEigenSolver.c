@@ -0,0 +1,438 @@
+/* benchEigenSolver.c */
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+/* Timings and residuals of eigenSymmetric (src/Utils/EigenSolver.c) versus the Jacobi and tred2/QL
+ * routines it replaced, on random symmetric matrices.
+ * usage : benchEigenSolver [nMax]   sizes 50, 100, 200, ... nMax (default 800)
+ */
+#include "../../Config.h"
+#include "../../src/Common/Global.h"
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "../../src/Utils/EigenSolver.h"
+
+/********************************************************************************/
+/* the old Jacobi.c */
+#define ROTATE(a,i,j,k,l) g=a[i][j];h=a[k][l];a[i][j]=g-s*(h+g*tau);\
+	a[k][l]=h+s*(g-h*tau);
+#define EPS 1e-10
+
+static gint jacobiReference(gdouble *M, gint n, gdouble d[], gdouble **v, gint *nrot)
+{
+	gint j,iq,ip,i;
+	gdouble tresh,theta,tau,t,sm,s,h,g,c,*b,*z;
+        gdouble **a;
+        gint k,ki,imin;
+
+	a=g_malloc(n*sizeof(gdouble*));
+        for(i=0;i<n;i++)
+           a[i]=g_malloc(n*sizeof(gdouble));
+        iq = -1;
+        for(i=0;i<n;i++)
+         for(j=i;j<n;j++)
+         {
+          iq++;
+          a[i][j] = M[iq];
+         }
+        for(i=0;i<n;i++)
+         for(j=0;j<i;j++)
+          a[i][j] = a[j][i];
+
+	b=g_malloc(n*sizeof(gdouble));
+	z=g_malloc(n*sizeof(gdouble));
+	for (ip=0;ip<n;ip++) {
+		for (iq=0;iq<n;iq++) v[ip][iq]=0.0;
+		v[ip][ip]=1.0;
+	}
+	for (ip=0;ip<n;ip++) {
+		b[ip]=d[ip]=a[ip][ip];
+		z[ip]=0.0;
+	}
+	*nrot=0;
+	for (i=0;i<50;i++) {
+		sm=0.0;
+		for (ip=0;ip<n-1;ip++) {
+			for (iq=ip+1;iq<n;iq++)
+				sm += fabs(a[ip][iq]);
+		}
+		if (fabs(sm)<=EPS) {
+			g_free(z);
+			g_free(b);
+		        for(i=0;i<n;i++)
+           			g_free(a[i]);
+			g_free(a);
+
+                        for(k=0;k<n-1;k++)
+                        {
+			  imin = k;
+                          for(ki=k+1;ki<n;ki++)
+				if(d[ki]<d[imin])
+				   imin = ki;
+                          if(imin != k)
+			  {
+			    sm = d[k];
+                            d[k] = d[imin];
+			    d[imin] = sm;
+
+                            for(ki=0;ki<n;ki++)
+                            {
+				sm = v[ki][k];
+				v[ki][k] = v[ki][imin];
+				v[ki][imin] = sm ;
+                            }
+
+			  }
+                        }
+
+			return 0;
+		}
+		if (i < 4)
+			tresh=0.2*sm/(n*n);
+		else
+			tresh=0.0;
+		for (ip=0;ip<n-1;ip++) {
+			for (iq=ip+1;iq<n;iq++) {
+				g=100.0*fabs(a[ip][iq]);
+				if (i > 4 && (gdouble)(fabs(d[ip])+g) == (gdouble)fabs(d[ip])
+					&& (gdouble)(fabs(d[iq])+g) == (gdouble)fabs(d[iq]))
+					a[ip][iq]=0.0;
+				else if (fabs(a[ip][iq]) > tresh) {
+					h=d[iq]-d[ip];
+					if ((gdouble)(fabs(h)+g) == (gdouble)fabs(h))
+						t=(a[ip][iq])/h;
+					else {
+						theta=0.5*h/(a[ip][iq]);
+						t=1.0/(fabs(theta)+sqrt(1.0+theta*theta));
+						if (theta < 0.0) t = -t;
+					}
+					c=1.0/sqrt(1+t*t);
+					s=t*c;
+					tau=s/(1.0+c);
+					h=t*a[ip][iq];
+					z[ip] -= h;
+					z[iq] += h;
+					d[ip] -= h;
+					d[iq] += h;
+					a[ip][iq]=0.0;
+					for (j=0;j<=ip-1;j++) {
+						ROTATE(a,j,ip,j,iq)
+					}
+					for (j=ip+1;j<=iq-1;j++) {
+						ROTATE(a,ip,j,j,iq)
+					}
+					for (j=iq+1;j<n;j++) {
+						ROTATE(a,ip,j,iq,j)
+					}
+					for (j=0;j<n;j++) {
+						ROTATE(v,j,ip,j,iq)
+					}
+					++(*nrot);
+				}
+			}
+		}
+		for (ip=0;ip<n;ip++) {
+			b[ip] += z[ip];
+			d[ip]=b[ip];
+			z[ip]=0.0;
+		}
+	}
+	/*	Debug("Too many iterations in routine jacobi\n");*/
+        g_free(z);
+        g_free(b);
+        for(i=0;i<n;i++)
+        	g_free(a[i]);
+	g_free(a);
+        return 1;
+}
+#undef ROTATE
+#undef EPS
+/********************************************************************************/
+/* the old QL.c : tred2 and QL */
+static void reductionToTridiagonal(gdouble **A, gint n, gdouble *D, gdouble *E);
+static gint diagonalisationOfATridiagonalMatrix(gdouble *D, gdouble *E, gint n, gdouble **V);
+/********************************************************************************/
+static gint eigenQLReference(gint n, gdouble **M, gdouble *EVals, gdouble** V)
+{
+	gdouble** A;
+	gdouble* E;
+	gint success = 0;
+	gint i;
+	gint j;
+
+	if(n<1) return 0;
+	A = malloc(n*sizeof(gdouble*));
+	for(i=0;i<n;i++) A[i]=malloc(n*sizeof(gdouble));
+
+	for(i=0;i<n;i++)
+	for(j=0;j<=i;j++)
+	{
+		A[i][j] = M[i][j];
+	}
+	for(i=0;i<n;i++)
+  	for(j=i+1;j<n;j++)
+    		A[i][j] = A[j][i];
+
+	E=malloc(n*sizeof(gdouble));
+	reductionToTridiagonal(A, n, EVals, E);
+	/*
+	for(i=0;i<n;i++) prgintf("EVals[%d]=%f\n",i,EVals[i]);
+	*/
+	success = diagonalisationOfATridiagonalMatrix(EVals, E, n, A);
+	for(i=0;i<n;i++)
+	for(j=0;j<n;j++)
+		V[i][j] = A[i][j];
+
+	free(E);
+	for(i=0;i<n;i++) free(A[i]);
+	free(A);
+
+	return success;
+}
+/* procedure to reduce a real symmetric matrix to the tridiagonal form that is suitable for input to 
+ * diagonalisationOfATridiagonalMatrix.*/
+/********************************************************************************/
+static void reductionToTridiagonal(gdouble **A, gint n, gdouble *D, gdouble *E)
+{
+	gint	l, k, j, i;
+	gdouble  scale, hh, h, g, f;
+ 
+	for (i = n-1; i >= 1; i--)
+	{
+	    l = i - 1;
+	    h = scale = 0.0;
+	    if (l > 0)
+	    {
+		   for (k = 0; k <= l; k++) scale += fabs(A[i][k]);
+		   if (scale == 0.0) E[i] = A[i][l];
+		   else
+		   {
+			  for (k = 0; k <= l; k++)
+			  {
+				 A[i][k] /= scale;
+				 h += A[i][k] * A[i][k];
+			  }
+			  f = A[i][l];
+			  g = f > 0 ? -sqrt(h) : sqrt(h);
+			  E[i] = scale * g;
+			  h -= f * g;
+			  A[i][l] = f - g;
+			  f = 0.0;
+			  for (j = 0; j <= l; j++)
+			  {
+				 A[j][i] = A[i][j] / h;
+				 g = 0.0;
+				 for (k = 0; k <= j; k++) g += A[j][k] * A[i][k];
+				 for (k = j + 1; k <= l; k++) g += A[k][j] * A[i][k];
+				 E[j] = g / h;
+				 f += E[j] * A[i][j];
+			  }
+			  hh = f / (h + h);
+			  for (j = 0; j <= l; j++)
+			  {
+				 f = A[i][j];
+				 E[j] = g = E[j] - hh * f;
+				 for (k = 0; k <= j; k++) A[j][k] -= (f * E[k] + g * A[i][k]);
+			  }
+		   }
+	    } else E[i] = A[i][l];
+	    D[i] = h;
+	}
+	D[0] = 0.0;
+	E[0] = 0.0;
+	for (i = 0; i < n; i++)
+	{
+	    l = i - 1;
+	    if (D[i])
+	    {
+		   for (j = 0; j <= l; j++)
+		   {
+			  g = 0.0;
+			  for (k = 0; k <= l; k++) g += A[i][k] * A[k][j];
+			  for (k = 0; k <= l; k++) A[k][j] -= g * A[k][i];
+		   }
+	    }
+	    D[i] = A[i][i];
+	    A[i][i] = 1.0;
+	    for (j = 0; j <= l; j++) A[j][i] = A[i][j] = 0.0;
+	}
+}
+#undef SIGN
+#define SIGN(A,B) ((B)<0 ? -fabs(A) : fabs(A))
+/* QL algorithm to determine 
+ * the eigenvalues and eigenvectors of a real, symmetric, tridiagonal matrix.*/
+/********************************************************************************/
+static gint diagonalisationOfATridiagonalMatrix(gdouble *D, gdouble *E, gint n, gdouble **V)
+{
+	gint	m, l, iter, i, k;
+	gdouble  s, r, p, g, f, dd, c, b;
+ 
+	for (i = 1; i < n; i++) E[i - 1] = E[i];
+	E[n-1] = 0.0;
+	for (l = 0; l < n; l++)
+	{
+	    iter = 0;
+	    do
+	    {
+		   for (m = l; m < n - 1; m++)
+		   {
+			  dd = fabs(D[m]) + fabs(D[m + 1]);
+			  if (fabs(E[m]) + dd == dd) break;
+		   }
+		   if (m != l)
+		   {
+			  if (iter++ == 30) return 0;
+			  g = (D[l + 1] - D[l]) / (2.0 * E[l]);
+			  r = sqrt((g*g) + 1.0);
+			  g = D[m] - D[l] + E[l] / (g + SIGN(r, g));
+			  s = c = 1.0;
+			  p = 0.0;
+			  for (i = m - 1; i >= l; i--)
+			  {
+				 f = s * E[i];
+				 b = c * E[i];
+				 if (fabs(f) >= fabs(g))
+				 {
+					c = g / f;
+					r = sqrt((c*c) + 1.0);
+					E[i + 1] = f * r;
+					c *= (s = 1.0 / r);
+				 } else
+				 {
+					s = f / g;
+					r = sqrt((s*s) + 1.0);
+					E[i + 1] = g * r;
+					s *= (c = 1.0 / r);
+				 }
+				 g = D[i + 1] - p;
+				 r = (D[i] - g) * s + 2.0 * c * b;
+				 p = s * r;
+				 D[i + 1] = g + p;
+				 g = c * r - b;
+				 for (k = 0; k < n; k++)
+				 {
+					f = V[k][i + 1];
+					V[k][i + 1] = s * V[k][i] + c * f;
+					V[k][i] = c * V[k][i] - s * f;
+				 }
+			  }
+			  D[l] = D[l] - p;
+			  E[l] = g;
+			  E[m] = 0.0;
+		   }
+	    } while (m != l);
+	}
+ 
+	return 1;
+}
+/********************************************************************************/
+/* V[i*n+j] : component i of the eigenvector j. errA = max|AV-VD|, errO = max|VtV-I| */
+static void getResiduals(gint n, gdouble* A, gdouble* d, gdouble* V, gdouble* errA, gdouble* errO)
+{
+	gint i, j, k;
+	*errA = 0;
+	*errO = 0;
+	for(i=0;i<n;i++)
+	for(j=0;j<n;j++)
+	{
+		gdouble s = -d[j]*V[i*n+j];
+		gdouble o = (i==j)?-1:0;
+		for(k=0;k<n;k++)
+		{
+			s += A[i*n+k]*V[k*n+j];
+			o += V[k*n+i]*V[k*n+j];
+		}
+		*errA = MAX(*errA,fabs(s));
+		*errO = MAX(*errO,fabs(o));
+	}
+}
+/********************************************************************************/
+static void printResult(gchar* method, gint n, gdouble time, gdouble timeRef, gdouble* A, gdouble* d, gdouble* V)
+{
+	gdouble errA, errO;
+	getResiduals(n, A, d, V, &errA, &errO);
+	printf("%-14s %5d %10.4f %8.2f %e %e\n", method, n, time, time/MAX(timeRef,1e-9), errA, errO);
+}
+/********************************************************************************/
+int main(int argc, char* argv[])
+{
+	gint nMax = 800;
+	gint n;
+
+	if(argc>1) nMax = atoi(argv[1]);
+	srand(1);
+	printf("# method            n    time(s) speed-up   max|AV-VD|   max|VtV-I|\n");
+	printf("# speed-up : time of the method / time of eigenSymmetric\n");
+	for(n=50;n<=nMax;n*=2)
+	{
+		gdouble* A = g_malloc(n*n*sizeof(gdouble));
+		gdouble* M = g_malloc(n*(n+1)/2*sizeof(gdouble));
+		gdouble* V = g_malloc(n*n*sizeof(gdouble));
+		gdouble* d = g_malloc(n*sizeof(gdouble));
+		gdouble** M2 = g_malloc(n*sizeof(gdouble*));
+		gdouble** V2 = g_malloc(n*sizeof(gdouble*));
+		GTimer* timer = g_timer_new();
+		gdouble timeRef;
+		gint nrot;
+		gint i, j, ij;
+
+		for(i=0;i<n;i++)
+		{
+			M2[i] = g_malloc(n*sizeof(gdouble));
+			V2[i] = g_malloc(n*sizeof(gdouble));
+		}
+		for(i=0;i<n;i++)
+		for(j=0;j<=i;j++)
+			A[i*n+j] = A[j*n+i] = M2[i][j] = M2[j][i] = rand()/(gdouble)RAND_MAX-0.5;
+		/* packed upper part for jacobi */
+		ij = 0;
+		for(i=0;i<n;i++)
+		for(j=i;j<n;j++) M[ij++] = A[i*n+j];
+
+		g_timer_start(timer);
+		eigenSymmetric(n, A, d, V);
+		g_timer_stop(timer);
+		timeRef = g_timer_elapsed(timer, NULL);
+		printResult("eigenSymmetric", n, timeRef, timeRef, A, d, V);
+
+		g_timer_start(timer);
+		eigenQLReference(n, M2, d, V2);
+		g_timer_stop(timer);
+		for(i=0;i<n;i++) for(j=0;j<n;j++) V[i*n+j] = V2[i][j];
+		printResult("tred2/QL", n, g_timer_elapsed(timer, NULL), timeRef, A, d, V);
+
+		g_timer_start(timer);
+		jacobiReference(M, n, d, V2, &nrot);
+		g_timer_stop(timer);
+		for(i=0;i<n;i++) for(j=0;j<n;j++) V[i*n+j] = V2[i][j];
+		printResult("jacobi", n, g_timer_elapsed(timer, NULL), timeRef, A, d, V);
+
+		for(i=0;i<n;i++)
+		{
+			g_free(M2[i]);
+			g_free(V2[i]);
+		}
+		g_free(M2);
+		g_free(V2);
+		g_free(A);
+		g_free(M);
+		g_free(V);
+		g_free(d);
+		g_timer_destroy(timer);
+	}
+	return 0;
+}
@@ -0,0 +1,171 @@
+/* benchMEPTreeCode.c */
+/**********************************************************************************************************
+Copyright (c) 2002-2021 Abdul-Rahman Allouche. All rights reserved
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the Gabedit), to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or substantial portions
+  of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+/* Electrostatic potential of random point charges on a grid : the treecode of src/Display/MEPTreeCode.c
+ * versus the direct sum (theta = 0), same charges and same grid.
+ * usage : benchMEPTreeCode [nCharges [N]]   N^3 grid (default 2000 charges, N = 60)
+ */
+#include "../../Config.h"
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "../../src/Display/GlobalOrb.h"
+#include "../../src/Display/StatusOrb.h"
+#include "../../src/Display/MEPTreeCode.h"
+
+/* the treecode is linked without the interface */
+gboolean CancelCalcul = FALSE;
+gint progress_orb(gdouble scal, GabEditTypeProgressOrb type, gboolean reset)
+{
+	return 0;
+}
+/**************************************************************************/
+/* N^3 points in [-L,L]^3 */
+static Grid* newBenchGrid(gint N, gdouble L)
+{
+	Grid* grid = g_malloc(sizeof(Grid));
+	gint i, j, k;
+
+	for(i=0;i<3;i++)
+	{
+		grid->N[i] = N;
+		grid->limits.MinMax[0][i] = -L;
+		grid->limits.MinMax[1][i] = L;
+	}
+	grid->mapped = FALSE;
+	grid->point = g_malloc(N*sizeof(Point5**));
+	for(i=0;i<N;i++)
+	{
+		grid->point[i] = g_malloc(N*sizeof(Point5*));
+		for(j=0;j<N;j++)
+		{
+			grid->point[i][j] = g_malloc(N*sizeof(Point5));
+			for(k=0;k<N;k++)
+			{
+				grid->point[i][j][k].C[0] = -L+2*L*i/(N-1);
+				grid->point[i][j][k].C[1] = -L+2*L*j/(N-1);
+				grid->point[i][j][k].C[2] = -L+2*L*k/(N-1);
+				grid->point[i][j][k].C[3] = 0;
+			}
+		}
+	}
+	return grid;
+}
+/**************************************************************************/
+static void freeBenchGrid(Grid* grid)
+{
+	gint i, j;
+	for(i=0;i<grid->N[0];i++)
+	{
+		for(j=0;j<grid->N[1];j++) g_free(grid->point[i][j]);
+		g_free(grid->point[i]);
+	}
+	g_free(grid->point);
+	g_free(grid);
+}
+/**************************************************************************/
+static void resetBenchGrid(Grid* grid)
+{
+	gint i, j, k;
+	for(i=0;i<grid->N[0];i++)
+	for(j=0;j<grid->N[1];j++)
+	for(k=0;k<grid->N[2];k++)
+		grid->point[i][j][k].C[3] = 0;
+}
+/**************************************************************************/
+/* time of newMEPTreeCode + addMEPTreeCodeToGrid */
+static gdouble computeBenchGrid(Grid* grid, gint nSources, gdouble* xyz, gdouble* q, gdouble theta, GTimer* timer)
+{
+	MEPTreeCode* tree;
+	resetBenchGrid(grid);
+	g_timer_start(timer);
+	tree = newMEPTreeCode(nSources, xyz, q, theta);
+	addMEPTreeCodeToGrid(tree, grid);
+	g_timer_stop(timer);
+	freeMEPTreeCode(tree);
+	return g_timer_elapsed(timer, NULL);
+}
+/**************************************************************************/
+/* random charges in a box of 30 bohr, potential on a grid 10 bohr larger */
+int main(int argc, char* argv[])
+{
+	gint nSources = 2000;
+	gint N = 60;
+	gdouble thetas[] = {0.3, 0.5, 0.7, 0.9};
+	gint nThetas = sizeof(thetas)/sizeof(gdouble);
+	gdouble* xyz;
+	gdouble* q;
+	gdouble* exact;
+	Grid* grid;
+	GTimer* timer = g_timer_new();
+	gdouble timeDirect;
+	gint nPoints;
+	gint i, j, k, t, c;
+
+	if(argc>1) nSources = atoi(argv[1]);
+	if(argc>2) N = atoi(argv[2]);
+	if(nSources<1 || N<2)
+	{
+		printf("usage : %s [nCharges [N]]\n", argv[0]);
+		return 1;
+	}
+	nPoints = N*N*N;
+	srand(1);
+	xyz = g_malloc(3*nSources*sizeof(gdouble));
+	q = g_malloc(nSources*sizeof(gdouble));
+	for(i=0;i<nSources;i++)
+	{
+		for(c=0;c<3;c++) xyz[3*i+c] = 30*(rand()/(gdouble)RAND_MAX-0.5);
+		q[i] = rand()/(gdouble)RAND_MAX-0.5;
+	}
+	grid = newBenchGrid(N, 20.0);
+
+	timeDirect = computeBenchGrid(grid, nSources, xyz, q, 0.0, timer);
+	exact = g_malloc(nPoints*sizeof(gdouble));
+	for(i=0;i<N;i++)
+	for(j=0;j<N;j++)
+	for(k=0;k<N;k++)
+		exact[(i*N+j)*N+k] = grid->point[i][j][k].C[3];
+
+	printf("# %d charges, %d^3 grid, direct sum : %f s\n", nSources, N, timeDirect);
+	printf("# theta  time(s)  speed-up  max|error|  rms error  max|V|\n");
+	for(t=0;t<nThetas;t++)
+	{
+		gdouble errMax = 0;
+		gdouble err2 = 0;
+		gdouble vMax = 0;
+		gdouble time = computeBenchGrid(grid, nSources, xyz, q, thetas[t], timer);
+
+		for(i=0;i<N;i++)
+		for(j=0;j<N;j++)
+		for(k=0;k<N;k++)
+		{
+			gdouble e = exact[(i*N+j)*N+k];
+			gdouble d = fabs(grid->point[i][j][k].C[3]-e);
+			errMax = MAX(errMax,d);
+			err2 += d*d;
+			vMax = MAX(vMax,fabs(e));
+		}
+		printf("%0.2f %f %0.1f %e %e %e\n", thetas[t], time, timeDirect/MAX(time,1e-9), errMax, sqrt(err2/nPoints), vMax);
+	}
+	g_timer_destroy(timer);
+	freeBenchGrid(grid);
+	g_free(exact);
+	g_free(xyz);
+	g_free(q);
+	return 0;
+}